@@ -0,0 +1,276 @@
+// ================== CONTROLLO LUMINOSITA' BACKLIGHT ==================
+// Unico punto che scrive il PWM della backlight dopo il setup. Le sorgenti sono ingressi
+// dello stesso controller:
+//  - sensore luce del radar locale (backlightFeedLight(BL_SRC_LOCAL, ...) dal loop)
+//  - luce ambiente del radar remoto (handler HTTP in 15_WEBSERVER_RADAR.ino)
+//  - orari giorno/notte e presenza (valutati in backlightUpdate())
+//
+// Catena per le sorgenti di luce:
+//  1. filtro (EMA o mediana, BL_FILTER_MODE) sul sensore locale, che oscilla di qualche
+//     unita' a ogni frame; il radar remoto invia gia' un valore elaborato e salta il filtro
+//  2. isteresi: il valore usato cambia solo se il filtrato esce da una banda di
+//     +/- BL_LIGHT_HYST attorno all'ultimo valore accettato
+//  3. curva percettiva: luce 0-255 -> duty radarBrightnessMin..Max con gamma BL_GAMMA
+//     (a meta' luce corrisponde circa meta' luminosita' percepita, non meta' duty)
+//  4. rampa temporale verso il nuovo duty, eseguita dal fade hardware LEDC
+//
+// Rampa: il driver LEDC (IDF 4.4) blocca un nuovo fade finche' quello in corso non e'
+// finito, quindi la rampa viene spezzata in segmenti hardware di BL_SEGMENT_MS: un
+// cambio di obiettivo (es. risveglio durante una rampa lenta) parte entro un segmento.
+// Gli handler HTTP non toccano il PWM: aggiornano gli ingressi e chiedono un
+// ricalcolo con backlightRequestUpdate(), eseguito dal loop. Gli ingressi (blInput)
+// sono scritti dal loop e dal task async del web server: blInputMux li protegge.
+
+#include <driver/ledc.h>
+
+// ===== Parametri =====
+#define BL_FILTER_EMA        0
+#define BL_FILTER_MEDIAN     1
+#define BL_FILTER_MODE       BL_FILTER_EMA
+#define BL_EMA_SHIFT         2        // alpha = 1/4 (a 10 frame/s: costante ~0.4s)
+#define BL_MEDIAN_LEN        5
+#define BL_LIGHT_HYST        8        // Banda di isteresi sulla luce (0-255)
+#define BL_GAMMA             2.2f
+#define BL_SEGMENT_MS        180      // Durata di un segmento di fade hardware (< periodo loop 200ms)
+#define BL_RAMP_LIGHT_MS     1500     // Variazione di luce ambiente
+#define BL_RAMP_OFF_MS       1000     // Spegnimento per assenza
+#define BL_UPDATE_MS         200      // Periodo ricalcolo obiettivo dal loop
+
+#define BL_LEDC_MODE         LEDC_LOW_SPEED_MODE
+#define BL_LEDC_CHANNEL      ((ledc_channel_t)(PWM_CHANNEL % 8))
+
+// ===== Stato =====
+struct BacklightLightInput {
+  uint16_t ema;                       // EMA in 8.8
+  uint8_t  median[BL_MEDIAN_LEN];
+  uint8_t  medianPos;
+  uint8_t  medianCount;
+  uint8_t  filtered;                  // Uscita del filtro
+  uint8_t  held;                      // Valore accettato dopo l'isteresi
+  bool     seeded;
+  uint32_t samples;
+  uint32_t accepted;                  // Cambi che hanno superato la banda
+};
+static BacklightLightInput blInput[2];  // BL_SRC_LOCAL, BL_SRC_REMOTE
+static portMUX_TYPE blInputMux = portMUX_INITIALIZER_UNLOCKED;
+
+static uint8_t  blGammaLut[256];
+static bool     blFadeReady = false;
+static uint8_t  blOut = 0;            // Duty alla fine del segmento in corso
+static uint8_t  blTarget = 0;
+static float    blRate = 0;           // Duty per ms della rampa in corso (0 = salto)
+static uint32_t blSegEndMs = 0;
+static uint32_t blLastUpdate = 0;
+static uint32_t blSegments = 0;
+static uint32_t blRetargets = 0;
+static volatile uint16_t blRequestRampMs = 0;
+static volatile bool blRequest = false;
+
+// Da chiamare subito dopo ledcSetup()/ledcAttachPin() (setup_display)
+void backlightBegin() {
+  for (int i = 0; i < 256; i++) {
+    blGammaLut[i] = (uint8_t)(powf(i / 255.0f, BL_GAMMA) * 255.0f + 0.5f);
+  }
+  blFadeReady = ledc_fade_func_install(0) == ESP_OK;
+  Serial.printf("[BACKLIGHT] Controller pronto (fade hardware %s, filtro %s)\n",
+                blFadeReady ? "SI" : "NO", BL_FILTER_MODE == BL_FILTER_EMA ? "EMA" : "mediana");
+}
+
+// ===== Ingressi luce =====
+static uint8_t blMedian(const uint8_t *vals, uint8_t n) {
+  uint8_t tmp[BL_MEDIAN_LEN];
+  memcpy(tmp, vals, n);
+  for (uint8_t i = 1; i < n; i++) {
+    uint8_t v = tmp[i];
+    int8_t j = i - 1;
+    while (j >= 0 && tmp[j] > v) { tmp[j + 1] = tmp[j]; j--; }
+    tmp[j + 1] = v;
+  }
+  return tmp[n / 2];
+}
+
+void backlightFeedLight(uint8_t src, uint8_t raw) {
+  if (src > BL_SRC_REMOTE) return;
+  BacklightLightInput &in = blInput[src];
+  portENTER_CRITICAL(&blInputMux);
+  in.samples++;
+
+  if (src == BL_SRC_REMOTE) {
+    in.filtered = raw;
+  } else if (BL_FILTER_MODE == BL_FILTER_MEDIAN) {
+    in.median[in.medianPos] = raw;
+    in.medianPos = (in.medianPos + 1) % BL_MEDIAN_LEN;
+    if (in.medianCount < BL_MEDIAN_LEN) in.medianCount++;
+    in.filtered = blMedian(in.median, in.medianCount);
+  } else {
+    if (!in.seeded) in.ema = raw << 8;
+    else in.ema += ((int32_t)(raw << 8) - (int32_t)in.ema) >> BL_EMA_SHIFT;
+    in.filtered = (in.ema + 128) >> 8;
+  }
+
+  if (!in.seeded || abs((int)in.filtered - (int)in.held) > BL_LIGHT_HYST) {
+    in.held = in.filtered;
+    in.seeded = true;
+    in.accepted++;
+  }
+  portEXIT_CRITICAL(&blInputMux);
+}
+
+uint8_t backlightLight(uint8_t src) {
+  if (src > BL_SRC_REMOTE) return 0;
+  portENTER_CRITICAL(&blInputMux);
+  uint8_t held = blInput[src].held;
+  portEXIT_CRITICAL(&blInputMux);
+  return held;
+}
+
+// Luce 0-255 -> duty nel range configurato, su curva percettiva
+uint8_t backlightMapLight(uint8_t light) {
+  int span = (int)radarBrightnessMax - (int)radarBrightnessMin;
+  return radarBrightnessMin + (span * blGammaLut[light] + 127) / 255;
+}
+
+// ===== Uscita =====
+static void blWriteSegment(uint8_t duty, uint32_t ms) {
+  if (!blFadeReady) {
+    ledcWrite(PWM_CHANNEL, duty);
+    return;
+  }
+  if (ms == 0) ledc_set_duty_and_update(BL_LEDC_MODE, BL_LEDC_CHANNEL, duty, 0);
+  else ledc_set_fade_time_and_start(BL_LEDC_MODE, BL_LEDC_CHANNEL, duty, ms, LEDC_FADE_NO_WAIT);
+  blSegments++;
+}
+
+// Avvia il prossimo segmento di rampa se il precedente e' finito
+static void blStep() {
+  uint32_t now = millis();
+  if (blOut == blTarget || (int32_t)(now - blSegEndMs) < 0) return;
+
+  uint8_t next = blTarget;
+  uint32_t segMs = 0;
+  if (blRate > 0) {
+    int step = max(1, (int)(blRate * BL_SEGMENT_MS + 0.5f));
+    int diff = (int)blTarget - (int)blOut;
+    if (abs(diff) > step) next = blOut + (diff > 0 ? step : -step);
+    segMs = BL_SEGMENT_MS;
+  }
+  blWriteSegment(next, segMs);
+  blOut = next;
+  blSegEndMs = now + segMs;
+}
+
+// Imposta l'obiettivo con una rampa di rampMs (0 = immediato)
+void backlightSet(uint8_t duty, uint16_t rampMs) {
+  lastAppliedBrightness = duty;
+  if (duty == blTarget) return;
+  if (blOut != blTarget) blRetargets++;
+  blTarget = duty;
+  blRate = rampMs ? (float)abs((int)duty - (int)blOut) / rampMs : 0;
+  blStep();
+}
+
+// Fade bloccante (cambio skin: lo schermo deve essere spento prima di ridisegnare)
+void backlightFadeWait(uint8_t duty, uint16_t rampMs) {
+  backlightSet(duty, rampMs);
+  uint32_t start = millis();
+  while (blOut != blTarget || (int32_t)(millis() - blSegEndMs) < 0) {
+    if (millis() - start > (uint32_t)rampMs + 1000) break;
+    delay(10);
+    blStep();
+  }
+}
+
+// Richiede un ricalcolo dell'obiettivo al prossimo giro di loop (anche da altri task)
+void backlightRequestUpdate(uint16_t rampMs) {
+  portENTER_CRITICAL(&blInputMux);
+  blRequestRampMs = rampMs;
+  blRequest = true;
+  portEXIT_CRITICAL(&blInputMux);
+  frameGovKick();
+}
+
+// ===== Obiettivo (dal loop) =====
+// PRIORITÀ: 3=REMOTO, 2=LOCALE, 1=MANUALE
+void backlightUpdate() {
+  blStep();
+  // Rampa in corso: il loop deve tornare qui alla fine del segmento hardware
+  if (blOut != blTarget) frameGovServiceAt(blSegEndMs);
+
+  uint32_t now = millis();
+  if (!blRequest && now - blLastUpdate < BL_UPDATE_MS) return;
+  portENTER_CRITICAL(&blInputMux);
+  bool requested = blRequest;
+  uint16_t ramp = requested ? blRequestRampMs : BL_RAMP_LIGHT_MS;
+  blRequest = false;
+  portEXIT_CRITICAL(&blInputMux);
+  blLastUpdate = now;
+
+#ifdef EFFECT_DUAL_DISPLAY
+  if (isDualSlave()) {
+    // Slave: luminosita' gestita dal master via SyncPacket
+    // MA se il radar server comanda display OFF, rispetta il comando
+    uint8_t master = lastAppliedBrightness;
+    if (radarServerEnabled && !radarRemotePresence) backlightSet(0, BL_RAMP_OFF_MS);
+    else backlightSet(master, ramp);
+    lastAppliedBrightness = master;   // Conserva il valore del master per il prossimo giro
+    return;
+  }
+#endif
+
+  bool remoteRadarActive = useRemoteRadar();
+  bool localRadarActive = radarAvailable && radarBrightnessControl && !remoteRadarActive;
+  bool nightTime = checkIsNightTime(currentHour, currentMinute);
+  uint8_t schedule = nightTime ? brightnessNight : brightnessDay;
+
+  // Passaggio giorno/notte: rampa lenta se non richiesto altro
+  static bool lastNight = nightTime;
+  if (nightTime != lastNight && !requested) ramp = BL_RAMP_SCHEDULE_MS;
+  lastNight = nightTime;
+
+  // MODALITÀ 3: RADAR REMOTO (presenza e luce ricevute dagli handler HTTP)
+  if (remoteRadarActive) {
+    if (!radarRemotePresence) backlightSet(0, BL_RAMP_OFF_MS);
+    else if (radarBrightnessControl) backlightSet(backlightMapLight(backlightLight(BL_SRC_REMOTE)), ramp);
+    else backlightSet(schedule, ramp);
+  }
+  // RADAR REMOTO ABILITATO MA TIMEOUT - rispetta comunque lo stato presenza
+  else if (radarServerEnabled && !radarRemotePresence) {
+    backlightSet(0, BL_RAMP_OFF_MS);
+  }
+  // MODALITÀ 2: RADAR LOCALE
+  else if (localRadarActive) {
+    if (setupOptions.powerSaveEnabled && !presenceDetected) backlightSet(0, BL_RAMP_OFF_MS);
+    else backlightSet(backlightMapLight(backlightLight(BL_SRC_LOCAL)), ramp);
+  }
+  // MODALITÀ 1: MANUALE
+  else {
+    backlightSet(schedule, ramp);
+  }
+}
+
+// ===== Stato per /radar/status =====
+String getBacklightJson() {
+  String json = "{";
+  json += "\"hardwareFade\":" + String(blFadeReady ? "true" : "false") + ",";
+  json += "\"filter\":\"" + String(BL_FILTER_MODE == BL_FILTER_EMA ? "ema" : "median") + "\",";
+  json += "\"hysteresis\":" + String(BL_LIGHT_HYST) + ",";
+  json += "\"gamma\":" + String(BL_GAMMA, 1) + ",";
+  json += "\"target\":" + String(blTarget) + ",";
+  json += "\"output\":" + String(blOut) + ",";
+  json += "\"ramping\":" + String(blOut != blTarget ? "true" : "false") + ",";
+  json += "\"segments\":" + String(blSegments) + ",";
+  json += "\"retargets\":" + String(blRetargets);
+  const char *names[2] = { "local", "remote" };
+  for (uint8_t s = 0; s <= BL_SRC_REMOTE; s++) {
+    portENTER_CRITICAL(&blInputMux);
+    const BacklightLightInput in = blInput[s];   // Copia coerente
+    portEXIT_CRITICAL(&blInputMux);
+    json += ",\"" + String(names[s]) + "\":{";
+    json += "\"filtered\":" + String(in.filtered) + ",";
+    json += "\"held\":" + String(in.held) + ",";
+    json += "\"samples\":" + String(in.samples) + ",";
+    json += "\"accepted\":" + String(in.accepted) + "}";
+  }
+  json += "}";
+  return json;
+}
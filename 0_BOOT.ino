@@ -0,0 +1,297 @@
+// ================== BOOT SEQUENCER - PASSI DI AVVIO CON DIPENDENZE E TIMELINE ==================
+// Ogni passo di inizializzazione dichiara cosa gli serve (needs) e cosa rende
+// disponibile (provides) tramite i bit BOOT_DEP_*. I passi con core >= 0 girano in un
+// task dedicato su quel core e partono appena le dipendenze sono pronte; i passi con
+// core = BOOT_INLINE girano nel task di setup (unico proprietario di gfx: tutti i passi
+// che disegnano restano qui).
+//
+// I bit in bootEvents indicano "passo TERMINATO", non "riuscito": un sensore assente
+// non deve bloccare chi lo aspetta. L'esito resta nella timeline (campo ok).
+//
+// Orologio anticipato: appena il display e' pronto viene disegnata l'ora dall'RTC
+// interno (sopravvive ai riavvii software, impostato ad ogni sync NTP) oppure
+// dall'ultima ora nota salvata in NVS (dopo un'interruzione di corrente), senza
+// attendere WiFi/NTP. Con ora disponibile lo splash iniziale viene saltato e le
+// schermate informative di WiFi/SD restano solo sulla seriale (bootQuiet()).
+//
+// La timeline (inizio, fine, attesa dipendenze per ogni passo) viene stampata sulla
+// seriale a fine setup e resta disponibile in JSON su /boot.
+
+#include <freertos/event_groups.h>
+#include <Preferences.h>
+#include <sys/time.h>
+
+// BOOT_DEP_*, BOOT_INLINE e struct BootStep sono nel file principale (usati da setup()).
+
+// ===== Parametri =====
+#define BOOT_MAX_STEPS          24
+#define BOOT_TASK_STACK         8192
+#define BOOT_DEP_TIMEOUT_MS     30000   // Attesa massima delle dipendenze di un passo
+#define BOOT_CLOCK_SAVE_MS      (15UL * 60UL * 1000UL)  // Salvataggio ora in NVS (usura trascurabile)
+#define BOOT_EPOCH_MIN          1700000000UL            // Sotto questa soglia l'ora non e' valida
+
+struct BootRecord {
+  const char *name;
+  int8_t      core;
+  bool        ok;
+  bool        depTimeout; // Partito senza tutte le dipendenze (timeout)
+  uint32_t    startMs;    // Inizio esecuzione (dopo l'attesa dipendenze)
+  uint32_t    endMs;
+  uint32_t    waitMs;     // Tempo passato ad attendere le dipendenze
+};
+
+EventGroupHandle_t bootEvents = nullptr;
+BootRecord bootTimeline[BOOT_MAX_STEPS];
+uint8_t bootTimelineCount = 0;
+portMUX_TYPE bootMux = portMUX_INITIALIZER_UNLOCKED;
+uint16_t bootSpawnedBits = 0;     // Bit forniti da passi lanciati come task
+uint32_t bootFirstFrameMs = 0;    // Prima ora visibile sul display
+uint32_t bootDoneMs = 0;          // Fine setup()
+uint8_t  bootTasksLate = 0;       // Task non terminati entro BOOT_JOIN_TIMEOUT_MS
+
+// ===== Ora anticipata =====
+enum BootClockSource : uint8_t {
+  BOOT_CLOCK_NONE = 0,   // Nessuna ora disponibile: splash + attesa NTP come prima
+  BOOT_CLOCK_RTC  = 1,   // RTC interno ancora valido (riavvio software)
+  BOOT_CLOCK_LAST = 2    // Ultima ora salvata in NVS (interruzione di corrente: ora vecchia)
+};
+
+uint8_t  bootClockSource = BOOT_CLOCK_NONE;
+time_t   bootClockEpoch = 0;
+bool     bootEarlyClockShown = false;
+uint32_t bootClockLastSaveMs = 0;
+
+// ===== Attesa con polling =====
+// Sostituisce i delay() fissi: esce appena ready() e' vera, o al timeout.
+bool bootWaitUntil(bool (*ready)(), uint32_t timeoutMs, uint32_t pollMs) {
+  uint32_t start = millis();
+  while (!ready()) {
+    if (millis() - start >= timeoutMs) return false;
+    delay(pollMs);
+  }
+  return true;
+}
+
+// Le schermate informative (non gli errori) si possono saltare quando sul display
+// c'e' gia' l'orologio anticipato
+bool bootQuiet() {
+  return bootEarlyClockShown;
+}
+
+void bootSequencerBegin() {
+  if (!bootEvents) bootEvents = xEventGroupCreate();
+  bootTimelineCount = 0;
+  bootSpawnedBits = 0;
+}
+
+void bootSignal(uint16_t bits) {
+  if (bootEvents) xEventGroupSetBits(bootEvents, bits);
+}
+
+// Ritorna true se tutti i bit sono arrivati entro il timeout
+bool bootWait(uint16_t bits, uint32_t timeoutMs) {
+  if (!bits || !bootEvents) return true;
+  EventBits_t got = xEventGroupWaitBits(bootEvents, bits, pdFALSE, pdTRUE, pdMS_TO_TICKS(timeoutMs));
+  return (got & bits) == bits;
+}
+
+static BootRecord *bootRecordAlloc(const BootStep *step) {
+  BootRecord *rec = nullptr;
+  portENTER_CRITICAL(&bootMux);
+  if (bootTimelineCount < BOOT_MAX_STEPS) {
+    rec = &bootTimeline[bootTimelineCount++];
+  }
+  portEXIT_CRITICAL(&bootMux);
+  if (rec) {
+    rec->name = step->name;
+    rec->core = step->core;
+    rec->ok = false;
+    rec->depTimeout = false;
+    rec->startMs = rec->endMs = rec->waitMs = 0;
+  }
+  return rec;
+}
+
+static void bootExecute(const BootStep *step) {
+  BootRecord *rec = bootRecordAlloc(step);
+  uint32_t waitStart = millis();
+  bool depsOk = bootWait(step->needs, BOOT_DEP_TIMEOUT_MS);
+  uint32_t start = millis();
+  bool ok = step->fn();
+  uint32_t end = millis();
+  if (rec) {
+    rec->waitMs = start - waitStart;
+    rec->depTimeout = !depsOk;
+    rec->startMs = start;
+    rec->endMs = end;
+    rec->ok = ok;
+  }
+  if (!depsOk) {
+    Serial.printf("[BOOT] %s: dipendenze non pronte dopo %lums, eseguito comunque\n",
+                  step->name, (unsigned long)BOOT_DEP_TIMEOUT_MS);
+  }
+  bootSignal(step->provides);
+}
+
+static void bootStepTask(void *arg) {
+  bootExecute((const BootStep *)arg);
+  vTaskDelete(NULL);
+}
+
+// Esegue (o lancia) un passo. Lo step deve restare valido fino alla fine del passo:
+// usare sempre istanze static/const.
+void bootRun(const BootStep &step) {
+  if (step.core == BOOT_INLINE) {
+    bootExecute(&step);
+    return;
+  }
+  bootSpawnedBits |= step.provides;
+  BaseType_t rc = xTaskCreatePinnedToCore(bootStepTask, step.name, BOOT_TASK_STACK,
+                                          (void *)&step, 1, NULL, step.core);
+  if (rc != pdPASS) {
+    Serial.printf("[BOOT] %s: task non creato, eseguo inline\n", step.name);
+    bootSpawnedBits &= ~step.provides;
+    bootExecute(&step);
+  }
+}
+
+// Registra nella timeline un blocco eseguito direttamente in setup() (senza BootStep)
+void bootMark(const char *name, uint32_t startMs, bool ok) {
+  BootStep step = { name, 0, 0, BOOT_INLINE, nullptr };
+  BootRecord *rec = bootRecordAlloc(&step);
+  if (!rec) return;
+  rec->startMs = startMs;
+  rec->endMs = millis();
+  rec->ok = ok;
+}
+
+// ===== Ora dall'RTC interno o dall'ultimo valore salvato =====
+// Va chiamata dopo setup_eeprom() e prima di setup_display(): decide se saltare lo splash.
+void bootClockRestore() {
+  time_t now = time(nullptr);
+  if ((unsigned long)now >= BOOT_EPOCH_MIN) {
+    bootClockSource = BOOT_CLOCK_RTC;
+    bootClockEpoch = now;
+  } else {
+    Preferences prefs;
+    prefs.begin("boot", true);
+    uint32_t saved = prefs.getULong("epoch", 0);
+    prefs.end();
+    if (saved >= BOOT_EPOCH_MIN) {
+      bootClockSource = BOOT_CLOCK_LAST;
+      bootClockEpoch = (time_t)saved;
+      // RTC interno a 1970 dopo un'interruzione di corrente: lo riporta all'ultima ora nota
+      struct timeval tv = { bootClockEpoch, 0 };
+      settimeofday(&tv, nullptr);
+    }
+  }
+
+  if (bootClockSource == BOOT_CLOCK_NONE) {
+    Serial.println("[BOOT] Nessuna ora disponibile prima di NTP");
+    return;
+  }
+
+  // Stessa regola di setup_NTP(): la conversione in ora locale non richiede rete
+  myTZ.setPosix("CET-1CEST,M3.5.0,M10.5.0/3");
+  currentHour = myTZ.hour(bootClockEpoch, UTC_TIME);
+  currentMinute = myTZ.minute(bootClockEpoch, UTC_TIME);
+  currentSecond = myTZ.second(bootClockEpoch, UTC_TIME);
+  Serial.printf("[BOOT] Ora anticipata %02d:%02d da %s\n", currentHour, currentMinute,
+                bootClockSource == BOOT_CLOCK_RTC ? "RTC" : "ultima ora salvata");
+}
+
+bool bootSkipSplash() {
+  return bootClockSource != BOOT_CLOCK_NONE;
+}
+
+// Ora ripristinata all'avvio (RTC o NVS): i fallback "ora predefinita" non devono sovrascriverla
+bool bootClockAvailable() {
+  return bootClockSource != BOOT_CLOCK_NONE;
+}
+
+// Disegna l'orologio a parole con l'ora anticipata appena il display e' pronto
+void bootRenderEarlyClock() {
+  if (bootClockSource == BOOT_CLOCK_NONE) return;
+  uint8_t duty = checkIsNightTime(currentHour, currentMinute) ? brightnessNight : brightnessDay;
+  backlightSet(duty, 0);
+  updateFastMode();
+  bootEarlyClockShown = true;
+  bootFirstFrameMs = millis();
+  Serial.printf("[BOOT] Primo frame orologio a %lums\n", (unsigned long)bootFirstFrameMs);
+}
+
+// Salva l'ora UTC sincronizzata: RTC interno (per i riavvii software) + NVS (per
+// le interruzioni di corrente). Chiamata al sync NTP e periodicamente dal loop.
+void bootClockSave() {
+  if (timeStatus() != timeSet) return;
+  time_t utc = UTC.now();
+  struct timeval tv = { utc, 0 };
+  settimeofday(&tv, nullptr);
+
+  Preferences prefs;
+  prefs.begin("boot", false);
+  prefs.putULong("epoch", (uint32_t)utc);
+  prefs.end();
+  bootClockLastSaveMs = millis();
+}
+
+void bootClockLoop() {
+  if (!ntpSynced) return;
+  if (bootClockLastSaveMs != 0 && millis() - bootClockLastSaveMs < BOOT_CLOCK_SAVE_MS) return;
+  bootClockSave();
+}
+
+// ===== Fine setup: attende i task ancora attivi e stampa la timeline =====
+void bootFinish() {
+  uint16_t pending = bootSpawnedBits;
+  if (pending && !bootWait(pending, BOOT_JOIN_TIMEOUT_MS)) {
+    EventBits_t got = xEventGroupGetBits(bootEvents);
+    bootTasksLate = __builtin_popcount(pending & ~got);
+    Serial.printf("[BOOT] %d passi ancora in corso dopo %lums\n",
+                  bootTasksLate, (unsigned long)BOOT_JOIN_TIMEOUT_MS);
+  }
+  bootDoneMs = millis();
+  if (bootFirstFrameMs == 0) bootFirstFrameMs = bootDoneMs;
+
+  Serial.println("\n========== BOOT TIMELINE ==========");
+  Serial.println("  passo            core  attesa   inizio     fine    durata");
+  for (uint8_t i = 0; i < bootTimelineCount; i++) {
+    const BootRecord &r = bootTimeline[i];
+    Serial.printf("  %-16s %4s %6lums %6lums %6lums %6lums%s%s\n",
+                  r.name, r.core == BOOT_INLINE ? "set" : (r.core == 0 ? "0" : "1"),
+                  (unsigned long)r.waitMs, (unsigned long)r.startMs, (unsigned long)r.endMs,
+                  (unsigned long)(r.endMs - r.startMs),
+                  r.ok ? "" : "  KO", r.depTimeout ? "  (dip. timeout)" : "");
+  }
+  Serial.printf("  primo frame: %lums, setup completato: %lums\n",
+                (unsigned long)bootFirstFrameMs, (unsigned long)bootDoneMs);
+  Serial.println("===================================\n");
+}
+
+// ===== Timeline in JSON =====
+String getBootJson() {
+  const char *src = bootClockSource == BOOT_CLOCK_RTC ? "rtc" :
+                    (bootClockSource == BOOT_CLOCK_LAST ? "last" : "none");
+  String json = "{";
+  json += "\"resetReason\":" + String((int)esp_reset_reason()) + ",";
+  json += "\"clockSource\":\"" + String(src) + "\",";
+  json += "\"earlyClock\":" + String(bootEarlyClockShown ? "true" : "false") + ",";
+  json += "\"firstFrameMs\":" + String(bootFirstFrameMs) + ",";
+  json += "\"setupDoneMs\":" + String(bootDoneMs) + ",";
+  json += "\"lateTasks\":" + String(bootTasksLate) + ",";
+  json += "\"steps\":[";
+  for (uint8_t i = 0; i < bootTimelineCount; i++) {
+    const BootRecord &r = bootTimeline[i];
+    if (i > 0) json += ",";
+    json += "{\"name\":\"" + String(r.name) + "\",";
+    json += "\"core\":" + String((int)r.core) + ",";
+    json += "\"waitMs\":" + String(r.waitMs) + ",";
+    json += "\"startMs\":" + String(r.startMs) + ",";
+    json += "\"endMs\":" + String(r.endMs) + ",";
+    json += "\"durationMs\":" + String(r.endMs - r.startMs) + ",";
+    json += "\"ok\":" + String(r.ok ? "true" : "false") + ",";
+    json += "\"depTimeout\":" + String(r.depTimeout ? "true" : "false") + "}";
+  }
+  json += "]}";
+  return json;
+}
@@ -0,0 +1,254 @@
+// ================== FRAME GOVERNOR - RITMO DEL LOOP SU SCENE STATICHE ==================
+// Il loop non gira piu' a vuoto quando lo schermo e' fermo: ogni modalita' dichiara
+// quando le serve il prossimo frame e a fine loop frameGovIdle() sospende il task
+// (ulTaskNotifyTake) fino a quella scadenza. Nel frattempo i core eseguono il task
+// IDLE (istruzione WAITI, clock della CPU fermo fino al prossimo interrupt).
+//
+// Dichiarazioni della modalita' (chiamate nel frame corrente):
+//  - frameGovWakeAt(ms) / frameGovWakeIn(ms): prossimo ridisegno necessario
+//  - frameGovAnimate(): animazione in corso, frame successivo a cadenza piena
+//  - frameGovAnimateUntil(ms): animazione fino all'istante indicato
+// Una modalita' che non dichiara nulla mantiene il comportamento storico (loop continuo):
+// giochi, video e player non vanno rallentati.
+//
+// Servizi di sfondo (LED, retroilluminazione, orologio): frameGovServiceAt(ms) accorcia
+// l'attesa ma non la attiva da solo. In ogni caso l'attesa non supera FRAME_GOV_MAX_SLEEP_MS
+// (radar, OTA, Alexa e ESP-NOW restano serviti a 10Hz).
+//
+// Risveglio immediato: frameGovKick() da touch, richieste HTTP, eventi WiFi, audio, ESP-NOW.
+
+#include <esp_freertos_hooks.h>
+#if CONFIG_PM_ENABLE
+#include <esp_pm.h>
+#endif
+
+// ===== Parametri =====
+#define FRAME_GOV_MAX_SLEEP_MS   100    // Attesa massima anche su scena statica
+#define FRAME_GOV_FRAME_MS       16     // Cadenza durante le animazioni (~60fps)
+#define FRAME_GOV_MIN_SLEEP_MS   2      // Sotto questa soglia non conviene sospendere
+
+// Gestione energia automatica (DFS + light sleep in idle). Disattivata di default:
+// con il pannello RGB, il PWM LEDC della retroilluminazione e l'I2S la frequenza APB
+// deve restare fissa; abilitare solo con core compilato con CONFIG_PM_ENABLE e
+// verificare a banco che non ci siano artefatti.
+#ifndef FRAME_GOV_AUTO_PM
+#define FRAME_GOV_AUTO_PM        0
+#endif
+
+// ===== Stato =====
+static TaskHandle_t frameGovTask = NULL;
+static bool     frameGovModeSet = false;   // La modalita' ha dichiarato qualcosa in questo frame
+static uint32_t frameGovModeDue = 0;       // Scadenza dichiarata dalla modalita'
+static bool     frameGovServiceSet = false;
+static uint32_t frameGovServiceDue = 0;    // Scadenza piu' vicina dei servizi
+static uint32_t frameGovAnimUntil = 0;     // Fine animazione dichiarata (frameGovAnimateUntil)
+
+struct FrameGovStats {
+  uint32_t frames;          // Iterazioni del loop
+  uint32_t sleeps;          // Attese effettive
+  uint32_t kickWakes;       // Attese interrotte da un evento
+  uint32_t timeoutWakes;    // Attese arrivate a scadenza
+  uint32_t kicks;           // Eventi di risveglio ricevuti
+  uint32_t spinFrames;      // Frame senza dichiarazione (loop continuo)
+};
+static FrameGovStats frameGovStats = {};
+
+// Finestra di misura (1s)
+static uint32_t frameGovWinStart = 0;
+static uint32_t frameGovWinFrames = 0;
+static uint64_t frameGovWinSleepUs = 0;
+static float    frameGovLoopHz = 0;
+static float    frameGovLoopIdlePct = 0;
+
+// Idle per core: l'idle hook viene chiamato almeno una volta in ogni tick in cui il
+// core resta inattivo; contando i tick distinti si stima la % di tempo in IDLE
+static volatile uint32_t frameGovIdleTicks[portNUM_PROCESSORS] = {0};
+static volatile TickType_t frameGovIdleLastTick[portNUM_PROCESSORS] = {0};
+static uint32_t frameGovIdleTicksPrev[portNUM_PROCESSORS] = {0};
+static TickType_t frameGovIdleWinTick = 0;
+static float    frameGovCpuIdlePct[portNUM_PROCESSORS] = {0};
+
+static bool frameGovIdleHook0() {
+  TickType_t t = xTaskGetTickCount();
+  if (t != frameGovIdleLastTick[0]) {
+    frameGovIdleLastTick[0] = t;
+    frameGovIdleTicks[0]++;
+  }
+  return true;   // WAITI fino al prossimo interrupt
+}
+
+#if portNUM_PROCESSORS > 1
+static bool frameGovIdleHook1() {
+  TickType_t t = xTaskGetTickCount();
+  if (t != frameGovIdleLastTick[1]) {
+    frameGovIdleLastTick[1] = t;
+    frameGovIdleTicks[1]++;
+  }
+  return true;
+}
+#endif
+
+// ===== Risveglio dalle richieste HTTP =====
+// Registrato per primo: vede ogni richiesta, sveglia il loop e lascia gestire agli altri handler.
+// Entrambe le firme: canHandle() e' const nelle versioni 3.x di ESPAsyncWebServer
+class FrameGovWakeHandler : public AsyncWebHandler {
+public:
+  bool canHandle(AsyncWebServerRequest *request) {
+    frameGovKick();
+    return false;
+  }
+  bool canHandle(AsyncWebServerRequest *request) const {
+    frameGovKick();
+    return false;
+  }
+};
+
+// ===== Inizializzazione (dal task del loop: setup() gira nello stesso task) =====
+void frameGovBegin() {
+  frameGovTask = xTaskGetCurrentTaskHandle();
+  frameGovWinStart = millis();
+  frameGovIdleWinTick = xTaskGetTickCount();
+
+  esp_register_freertos_idle_hook_for_cpu(frameGovIdleHook0, 0);
+#if portNUM_PROCESSORS > 1
+  esp_register_freertos_idle_hook_for_cpu(frameGovIdleHook1, 1);
+#endif
+
+  // Qualsiasi evento WiFi (connessione, IP, disconnessione) sveglia il loop
+  WiFi.onEvent([](WiFiEvent_t event, WiFiEventInfo_t info) { frameGovKick(); });
+
+#if FRAME_GOV_AUTO_PM && CONFIG_PM_ENABLE
+  esp_pm_config_esp32s3_t pm = {};
+  pm.max_freq_mhz = 240;
+  pm.min_freq_mhz = 80;
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+  pm.light_sleep_enable = true;
+#endif
+  esp_err_t err = esp_pm_configure(&pm);
+  Serial.printf("[GOV] Gestione energia automatica: %s\n", err == ESP_OK ? "attiva" : esp_err_to_name(err));
+#endif
+
+  Serial.printf("[GOV] Frame governor attivo: attesa max %dms, cadenza animazioni %dms\n",
+                FRAME_GOV_MAX_SLEEP_MS, FRAME_GOV_FRAME_MS);
+}
+
+void frameGovAttachWebServer(AsyncWebServer* server) {
+  server->addHandler(new FrameGovWakeHandler());
+}
+
+// ===== Dichiarazioni della modalita' =====
+void frameGovWakeAt(uint32_t atMs) {
+  if (!frameGovModeSet || (int32_t)(atMs - frameGovModeDue) < 0) frameGovModeDue = atMs;
+  frameGovModeSet = true;
+}
+
+void frameGovWakeIn(uint32_t delayMs) {
+  frameGovWakeAt(millis() + delayMs);
+}
+
+void frameGovAnimate() {
+  frameGovWakeIn(FRAME_GOV_FRAME_MS);
+}
+
+void frameGovAnimateUntil(uint32_t untilMs) {
+  if ((int32_t)(untilMs - frameGovAnimUntil) > 0) frameGovAnimUntil = untilMs;
+  frameGovAnimate();
+}
+
+// ===== Dichiarazioni dei servizi =====
+void frameGovServiceAt(uint32_t atMs) {
+  if (!frameGovServiceSet || (int32_t)(atMs - frameGovServiceDue) < 0) frameGovServiceDue = atMs;
+  frameGovServiceSet = true;
+}
+
+// ===== Risveglio da altri task =====
+void frameGovKick() {
+  if (frameGovTask == NULL) return;
+  frameGovStats.kicks++;
+  xTaskNotifyGive(frameGovTask);
+}
+
+// ===== Statistiche (finestra 1s) =====
+static void frameGovUpdateStats(uint32_t now) {
+  uint32_t elapsed = now - frameGovWinStart;
+  if (elapsed < 1000) return;
+  frameGovLoopHz = frameGovWinFrames * 1000.0f / elapsed;
+  frameGovLoopIdlePct = frameGovWinSleepUs / (elapsed * 10.0f);
+  if (frameGovLoopIdlePct > 100) frameGovLoopIdlePct = 100;
+
+  TickType_t nowTick = xTaskGetTickCount();
+  TickType_t ticks = nowTick - frameGovIdleWinTick;
+  for (int c = 0; c < portNUM_PROCESSORS; c++) {
+    uint32_t idle = frameGovIdleTicks[c];
+    float pct = ticks ? (idle - frameGovIdleTicksPrev[c]) * 100.0f / ticks : 0;
+    frameGovCpuIdlePct[c] = pct > 100 ? 100 : pct;
+    frameGovIdleTicksPrev[c] = idle;
+  }
+  frameGovIdleWinTick = nowTick;
+
+  frameGovWinStart = now;
+  frameGovWinFrames = 0;
+  frameGovWinSleepUs = 0;
+}
+
+// ===== Fine frame: attesa fino alla prossima scadenza o a un evento =====
+void frameGovIdle() {
+  uint32_t now = millis();
+  frameGovStats.frames++;
+  frameGovWinFrames++;
+
+  bool animating = (int32_t)(frameGovAnimUntil - now) > 0;
+  bool modeSet = frameGovModeSet;
+  uint32_t due = frameGovModeDue;
+  if (frameGovServiceSet && (int32_t)(frameGovServiceDue - due) < 0) due = frameGovServiceDue;
+
+  // Reset dichiarazioni per il frame successivo
+  frameGovModeSet = false;
+  frameGovServiceSet = false;
+
+  int32_t waitMs = (int32_t)(due - now);
+  if (animating && waitMs > FRAME_GOV_FRAME_MS) waitMs = FRAME_GOV_FRAME_MS;
+  if (waitMs > FRAME_GOV_MAX_SLEEP_MS) waitMs = FRAME_GOV_MAX_SLEEP_MS;
+
+  if (!modeSet || frameGovTask == NULL || waitMs < FRAME_GOV_MIN_SLEEP_MS) {
+    if (!modeSet) frameGovStats.spinFrames++;
+    frameGovUpdateStats(now);
+    yield();
+    return;
+  }
+
+  int64_t t0 = esp_timer_get_time();
+  frameGovStats.sleeps++;
+  if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(waitMs)) > 0) frameGovStats.kickWakes++;
+  else frameGovStats.timeoutWakes++;
+  frameGovWinSleepUs += esp_timer_get_time() - t0;
+
+  frameGovUpdateStats(millis());
+}
+
+// ===== Stato in JSON per /governor/status =====
+String getFrameGovJson() {
+  String json = "{";
+  json += "\"loopHz\":" + String(frameGovLoopHz, 1) + ",";
+  json += "\"loopIdlePercent\":" + String(frameGovLoopIdlePct, 1) + ",";
+  json += "\"cpuIdlePercent\":[";
+  for (int c = 0; c < portNUM_PROCESSORS; c++) {
+    if (c) json += ",";
+    json += String(frameGovCpuIdlePct[c], 1);
+  }
+  json += "],";
+  json += "\"frames\":" + String(frameGovStats.frames) + ",";
+  json += "\"spinFrames\":" + String(frameGovStats.spinFrames) + ",";
+  json += "\"sleeps\":" + String(frameGovStats.sleeps) + ",";
+  json += "\"kickWakes\":" + String(frameGovStats.kickWakes) + ",";
+  json += "\"timeoutWakes\":" + String(frameGovStats.timeoutWakes) + ",";
+  json += "\"kicks\":" + String(frameGovStats.kicks) + ",";
+  json += "\"maxSleepMs\":" + String(FRAME_GOV_MAX_SLEEP_MS) + ",";
+#if FRAME_GOV_AUTO_PM && CONFIG_PM_ENABLE
+  json += "\"autoPm\":true";
+#else
+  json += "\"autoPm\":false";
+#endif
+  json += "}";
+  return json;
+}
@@ -0,0 +1,244 @@
+// ================== HAND RASTER - LANCETTE ANTIALIAS IN VIRGOLA FISSA ==================
+// Rasterizzatore a scanline per le lancette degli orologi (analogico e con skin).
+// Ogni lancetta e' composta da tratti: un segmento orientato con semi-spessore, terminazioni
+// tonde (capsula) o piatte (rettangolo). Per ogni riga si calcola l'intervallo di pixel
+// toccati dal tratto e su quello si avanza in modo incrementale con due coordinate in
+// virgola fissa Q16 (u lungo la lancetta, v in perpendicolare). La copertura del pixel
+// deriva dalla distanza dal bordo (mezzo pixel di sfumatura per lato) e viene miscelata
+// sul frame buffer RGB565: niente buchi tra le linee di riempimento e bordi senza gradini.
+//
+// Seno/coseno da tabella Q15 (256 passi per giro con interpolazione lineare): nessuna
+// chiamata a sin()/cos() per frame.
+//
+// Clip opzionale (handRasterSetClip): il ridisegno parziale dell'orologio analogico
+// ridisegna solo il rettangolo sporco; la miscelazione fuori dal clip non deve avvenire
+// perche' quei pixel contengono gia' la lancetta del frame precedente.
+
+// ===== Tabella seno Q15 (257 valori: l'ultimo chiude il giro per l'interpolazione) =====
+static const int16_t handSinTable[257] = {
+       0,    804,   1608,   2410,   3212,   4011,   4808,   5602,   6393,   7179,   7962,   8739,
+    9512,  10278,  11039,  11793,  12539,  13279,  14010,  14732,  15446,  16151,  16846,  17530,
+   18204,  18868,  19519,  20159,  20787,  21403,  22005,  22594,  23170,  23731,  24279,  24811,
+   25329,  25832,  26319,  26790,  27245,  27683,  28105,  28510,  28898,  29268,  29621,  29956,
+   30273,  30571,  30852,  31113,  31356,  31580,  31785,  31971,  32137,  32285,  32412,  32521,
+   32609,  32678,  32728,  32757,  32767,  32757,  32728,  32678,  32609,  32521,  32412,  32285,
+   32137,  31971,  31785,  31580,  31356,  31113,  30852,  30571,  30273,  29956,  29621,  29268,
+   28898,  28510,  28105,  27683,  27245,  26790,  26319,  25832,  25329,  24811,  24279,  23731,
+   23170,  22594,  22005,  21403,  20787,  20159,  19519,  18868,  18204,  17530,  16846,  16151,
+   15446,  14732,  14010,  13279,  12539,  11793,  11039,  10278,   9512,   8739,   7962,   7179,
+    6393,   5602,   4808,   4011,   3212,   2410,   1608,    804,      0,   -804,  -1608,  -2410,
+   -3212,  -4011,  -4808,  -5602,  -6393,  -7179,  -7962,  -8739,  -9512, -10278, -11039, -11793,
+  -12539, -13279, -14010, -14732, -15446, -16151, -16846, -17530, -18204, -18868, -19519, -20159,
+  -20787, -21403, -22005, -22594, -23170, -23731, -24279, -24811, -25329, -25832, -26319, -26790,
+  -27245, -27683, -28105, -28510, -28898, -29268, -29621, -29956, -30273, -30571, -30852, -31113,
+  -31356, -31580, -31785, -31971, -32137, -32285, -32412, -32521, -32609, -32678, -32728, -32757,
+  -32767, -32757, -32728, -32678, -32609, -32521, -32412, -32285, -32137, -31971, -31785, -31580,
+  -31356, -31113, -30852, -30571, -30273, -29956, -29621, -29268, -28898, -28510, -28105, -27683,
+  -27245, -26790, -26319, -25832, -25329, -24811, -24279, -23731, -23170, -22594, -22005, -21403,
+  -20787, -20159, -19519, -18868, -18204, -17530, -16846, -16151, -15446, -14732, -14010, -13279,
+  -12539, -11793, -11039, -10278,  -9512,  -8739,  -7962,  -7179,  -6393,  -5602,  -4808,  -4011,
+   -3212,  -2410,  -1608,   -804,      0,
+};
+
+#define HAND_Q16        65536
+#define HAND_PX(n)      ((int32_t)(n) * HAND_Q16)
+
+// ===== Clip corrente (coordinate incluse) =====
+static int16_t handClipX0 = 0, handClipY0 = 0, handClipX1 = 32767, handClipY1 = 32767;
+
+void handRasterSetClip(int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  handClipX0 = x0; handClipY0 = y0; handClipX1 = x1; handClipY1 = y1;
+}
+
+void handRasterClearClip() {
+  handClipX0 = 0; handClipY0 = 0; handClipX1 = 32767; handClipY1 = 32767;
+}
+
+// Seno in Q15 di un angolo in gradi (0-360, anche fuori range)
+static int32_t handSinQ15(float degrees) {
+  // Fase a 16 bit: 8 bit di indice tabella + 8 bit di interpolazione
+  uint32_t phase = (uint32_t)(int32_t)(degrees * (65536.0f / 360.0f)) & 0xFFFF;
+  uint32_t idx = phase >> 8;
+  int32_t frac = phase & 0xFF;
+  int32_t a = handSinTable[idx];
+  int32_t b = handSinTable[idx + 1];
+  return a + (((b - a) * frac) >> 8);
+}
+
+// Miscela RGB565 con alpha 0..32 (canali espansi su 32 bit, G nei bit alti)
+static inline uint16_t rgb565Blend(uint16_t fg, uint16_t bg, uint32_t alpha) {
+  uint32_t f = (fg | ((uint32_t)fg << 16)) & 0x07E0F81F;
+  uint32_t b = (bg | ((uint32_t)bg << 16)) & 0x07E0F81F;
+  uint32_t m = ((((f - b) * alpha) >> 5) + b) & 0x07E0F81F;
+  return (uint16_t)(m | (m >> 16));
+}
+
+// Radice quadrata intera (per le terminazioni tonde)
+static uint32_t handISqrt(uint32_t n) {
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > n) bit >>= 2;
+  while (bit) {
+    if (n >= root + bit) {
+      n -= root + bit;
+      root = (root >> 1) + bit;
+    } else {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+static inline int32_t handFloorDiv(int32_t a, int32_t b) {
+  int32_t q = a / b;
+  if ((a % b != 0) && ((a < 0) != (b < 0))) q--;
+  return q;
+}
+
+static inline int32_t handCeilDiv(int32_t a, int32_t b) {
+  return -handFloorDiv(-a, b);
+}
+
+// Restringe [dx0, dx1] ai dx per cui lo <= base + dx * step <= hi. Ritorna false se vuoto.
+static bool handSpanLimit(int32_t base, int32_t step, int32_t lo, int32_t hi, int32_t* dx0, int32_t* dx1) {
+  if (step == 0) return base >= lo && base <= hi;
+  int32_t a = lo - base;
+  int32_t b = hi - base;
+  if (step < 0) {
+    int32_t t = -a; a = -b; b = t;
+    step = -step;
+  }
+  int32_t lo2 = handCeilDiv(a, step);
+  int32_t hi2 = handFloorDiv(b, step);
+  if (lo2 > *dx0) *dx0 = lo2;
+  if (hi2 < *dx1) *dx1 = hi2;
+  return *dx0 <= *dx1;
+}
+
+// Rettangolo (pixel inclusi) toccato da un tratto da u0 a u1 lungo dir, semi-spessore halfW (Q16)
+static void handStrokeBounds(int cx, int cy, int32_t dirX, int32_t dirY, int32_t u0, int32_t u1, int32_t halfW,
+                             int16_t* x0, int16_t* y0, int16_t* x1, int16_t* y1) {
+  // Estremi del segmento in Q16 (dir in Q15)
+  int32_t ax = (int32_t)(((int64_t)dirX * u0) >> 15);
+  int32_t ay = (int32_t)(((int64_t)dirY * u0) >> 15);
+  int32_t bx = (int32_t)(((int64_t)dirX * u1) >> 15);
+  int32_t by = (int32_t)(((int64_t)dirY * u1) >> 15);
+  int32_t r = halfW + HAND_PX(1);
+  *x0 = cx + ((min(ax, bx) - r) >> 16) - 1;
+  *x1 = cx + ((max(ax, bx) + r) >> 16) + 1;
+  *y0 = cy + ((min(ay, by) - r) >> 16) - 1;
+  *y1 = cy + ((max(ay, by) + r) >> 16) + 1;
+}
+
+// Tratto antialias sul frame buffer (fbW x fbH, stride fbW).
+// u0..u1: estensione lungo la lancetta (Q16); halfW: semi-spessore (Q16);
+// round: terminazioni tonde centrate in u0 e u1 (capsula), altrimenti taglio netto.
+static void handRasterStroke(uint16_t* fb, int16_t fbW, int16_t fbH, int cx, int cy,
+                             int32_t dirX, int32_t dirY, int32_t u0, int32_t u1,
+                             int32_t halfW, bool round, uint16_t color) {
+  int16_t bx0, by0, bx1, by1;
+  handStrokeBounds(cx, cy, dirX, dirY, u0, u1, halfW, &bx0, &by0, &bx1, &by1);
+  if (bx0 < handClipX0) bx0 = handClipX0;
+  if (by0 < handClipY0) by0 = handClipY0;
+  if (bx1 > handClipX1) bx1 = handClipX1;
+  if (by1 > handClipY1) by1 = handClipY1;
+  if (bx0 < 0) bx0 = 0;
+  if (by0 < 0) by0 = 0;
+  if (bx1 > fbW - 1) bx1 = fbW - 1;
+  if (by1 > fbH - 1) by1 = fbH - 1;
+  if (bx0 > bx1 || by0 > by1) return;
+
+  // Passo per pixel in Q16 (dir Q15 * 2): u = dx*dirX + dy*dirY, v = -dx*dirY + dy*dirX
+  const int32_t ux = dirX * 2, uy = dirY * 2;
+  const int32_t vx = -dirY * 2, vy = dirX * 2;
+  const int32_t r = halfW + HAND_PX(1);   // Oltre questa distanza la copertura e' nulla
+
+  for (int16_t y = by0; y <= by1; y++) {
+    int32_t dy = y - cy;
+    int32_t uRow = dy * uy;
+    int32_t vRow = dy * vy;
+
+    // Intervallo della riga: fascia |v| <= r e u nell'estensione del tratto
+    int32_t dx0 = bx0 - cx, dx1 = bx1 - cx;
+    if (!handSpanLimit(vRow, vx, -r, r, &dx0, &dx1)) continue;
+    if (!handSpanLimit(uRow, ux, u0 - r, u1 + r, &dx0, &dx1)) continue;
+
+    int32_t u = uRow + dx0 * ux;
+    int32_t v = vRow + dx0 * vx;
+    uint16_t* p = &fb[y * fbW + cx + dx0];
+
+    for (int32_t dx = dx0; dx <= dx1; dx++, u += ux, v += vx, p++) {
+      int32_t av = v < 0 ? -v : v;
+      int32_t d;   // Distanza dal bordo in Q16 (negativa = dentro)
+      if (round && (u < u0 || u > u1)) {
+        // Terminazione tonda: distanza dal centro della semicirconferenza (Q8 per la radice)
+        int32_t du = (u < u0 ? u0 - u : u - u1) >> 8;
+        int32_t dv = av >> 8;
+        d = ((int32_t)handISqrt((uint32_t)(du * du + dv * dv)) << 8) - halfW;
+      } else {
+        d = av - halfW;
+        if (!round) {
+          if (u0 - u > d) d = u0 - u;
+          if (u - u1 > d) d = u - u1;
+        }
+      }
+
+      // Copertura: 0.5 - distanza (in pixel), su 0..256, poi alpha 0..32
+      int32_t cov = 128 - (d >> 8);
+      if (cov <= 0) continue;
+      if (cov >= 256) {
+        *p = color;
+      } else {
+        *p = rgb565Blend(color, *p, (uint32_t)(cov + 4) >> 3);
+      }
+    }
+  }
+}
+
+// Colore del contorno: bianco su lancette scure, nero su lancette chiare (come la preview web)
+static uint16_t clockHandOutlineColor(uint16_t color) {
+  uint8_t r = ((color >> 11) & 0x1F) << 3;
+  uint8_t g = ((color >> 5) & 0x3F) << 2;
+  uint8_t b = (color & 0x1F) << 3;
+  return ((r + g + b) / 3 < 128) ? WHITE : BLACK;
+}
+
+// Rettangolo (pixel inclusi) che contiene una lancetta disegnata da drawClockHandAA()
+void clockHandBounds(int centerX, int centerY, float angle, int length, int thickness, uint8_t style,
+                     int16_t* x0, int16_t* y0, int16_t* x1, int16_t* y1) {
+  int32_t dirX = handSinQ15(angle);
+  int32_t dirY = -handSinQ15(angle + 90.0f);
+  int32_t halfWOut = thickness * (HAND_Q16 / 2) + HAND_PX(2);
+  int32_t pinOut = HAND_PX(thickness + 4);
+  int32_t tip = HAND_PX(length) + (style == 1 ? halfWOut : 0);
+
+  handStrokeBounds(centerX, centerY, dirX, dirY, 0, tip, max(halfWOut, pinOut), x0, y0, x1, y1);
+}
+
+// Disegna una lancetta antialias (contorno, corpo, perno) sul frame buffer.
+// Stessa geometria di drawClockHandOffscreenStyled(): style 0=round, 1=square, 2=butt
+void drawClockHandAA(uint16_t* fb, int16_t fbW, int16_t fbH, int centerX, int centerY,
+                     float angle, int length, uint16_t color, int thickness, uint8_t style) {
+  if (fb == nullptr) return;
+
+  // 0° = ore 12, senso orario: direzione (sin, -cos) con y verso il basso
+  int32_t dirX = handSinQ15(angle);
+  int32_t dirY = -handSinQ15(angle + 90.0f);
+
+  uint16_t outlineColor = clockHandOutlineColor(color);
+  bool round = (style == 0);
+  int32_t len = HAND_PX(length);
+  int32_t halfW = thickness * (HAND_Q16 / 2);
+  int32_t halfWOut = halfW + HAND_PX(2);
+
+  // Contorno, poi corpo (square: estensione oltre la punta pari al semi-spessore)
+  handRasterStroke(fb, fbW, fbH, centerX, centerY, dirX, dirY, 0,
+                   len + (style == 1 ? halfWOut : 0), halfWOut, round, outlineColor);
+  handRasterStroke(fb, fbW, fbH, centerX, centerY, dirX, dirY, 0,
+                   len + (style == 1 ? halfW : 0), halfW, round, color);
+
+  // Perno centrale
+  handRasterStroke(fb, fbW, fbH, centerX, centerY, dirX, dirY, 0, 0, HAND_PX(thickness + 4), true, outlineColor);
+  handRasterStroke(fb, fbW, fbH, centerX, centerY, dirX, dirY, 0, 0, HAND_PX(thickness + 2), true, color);
+}
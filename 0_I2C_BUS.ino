@@ -0,0 +1,263 @@
+// ================== ARBITRO BUS I2C ==================
+// Touch GT911, magnetometro QMC5883P, BME280 e slave audio ESP32C3 condividono
+// lo stesso bus Wire (SDA=19, SCL=45). Dopo i2cBusBegin() il bus e' di proprieta'
+// di un solo task: gli altri task gli consegnano una transazione con i2cBusRun()
+// e restano in attesa del risultato.
+//
+// Coda a priorita': ogni dispositivo ha UNO slot (i chiamanti dello stesso
+// dispositivo si serializzano sul suo mutex) e un bit nella notifica del task.
+// Il task serve sempre il bit piu' basso pendente, quindi il touch (bit 0) passa
+// davanti a tutto e i sensori ambientali (bit 3) per ultimi. La priorita' vale
+// a granularita' di transazione: una transazione iniziata non viene interrotta.
+//
+// Polling pianificato: il BME280 lavora in forced mode. Il task avvia una misura
+// ogni I2C_BME_POLL_MS, rilascia il bus durante la conversione e torna a leggere
+// i registri quando il dato e' pronto. Il risultato viene pubblicato in una cache
+// letta da readBME280Temperature() senza toccare il bus.
+
+// ===== Parametri =====
+#define I2C_BUS_TASK_CORE      1        // Stesso core del task touch: nessun trasferimento tra core
+#define I2C_BUS_TASK_PRIO      3        // Sopra il task touch (2) e il loop (1)
+#define I2C_BUS_TASK_STACK     4096
+#define I2C_BUS_STALL_MS       1000     // Attesa oltre la quale una transazione conta come stallo
+#define I2C_BME_POLL_MS        5000     // Periodo misura BME280 in forced mode
+#define I2C_BME_CONV_MS        100      // Conversione T x2 + P x16 + H x16 (max ~81 ms da datasheet)
+#define I2C_BME_REG_CTRL_MEAS  0xF4
+#define I2C_BME_CTRL_FORCED    ((2 << 5) | (5 << 2) | 1)  // osrs_t x2, osrs_p x16, mode forced
+
+static const char *i2cDevNames[I2C_DEV_COUNT] = { "touch", "audio", "mag", "bme280" };
+
+// ===== Statistiche per dispositivo =====
+struct I2cDevStats {
+  uint32_t jobs;          // Transazioni eseguite
+  uint32_t errors;        // Transazioni fallite (fn ha ritornato false)
+  uint32_t stalls;        // Attese oltre I2C_BUS_STALL_MS
+  uint32_t waitUsLast;    // Tempo in coda (consegna -> inizio)
+  uint32_t waitUsMax;
+  uint32_t waitUsAvg;     // Media mobile esponenziale (1/8)
+  uint32_t execUsLast;    // Tempo sul bus
+  uint32_t execUsMax;
+  uint32_t execUsAvg;
+};
+I2cDevStats i2cDevStats[I2C_DEV_COUNT];
+
+// ===== Slot transazioni =====
+struct I2cJob {
+  bool   (*fn)(void *arg);
+  void    *arg;
+  uint32_t submitUs;
+  bool     result;
+};
+static I2cJob i2cJobs[I2C_DEV_COUNT];
+static SemaphoreHandle_t i2cDevLock[I2C_DEV_COUNT];
+static SemaphoreHandle_t i2cDevDone[I2C_DEV_COUNT];
+static TaskHandle_t i2cBusTaskHandle = nullptr;
+
+// ===== Cache BME280 =====
+struct I2cBmeCache {
+  float    temperature;   // °C grezzi (senza offset di calibrazione)
+  float    humidity;      // % grezza
+  float    pressure;      // hPa
+  uint32_t sampleMs;      // millis() dell'ultima lettura valida
+  uint32_t samples;
+  bool     valid;
+};
+static I2cBmeCache i2cBmeCache;
+static portMUX_TYPE i2cBmeMux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t i2cBmeAddress = 0;
+
+static void i2cUpdateAvg(uint32_t &avg, uint32_t v) {
+  if (avg == 0) avg = v;
+  else avg += ((int32_t)v - (int32_t)avg) / 8;
+}
+
+// Esegue fn sul bus e aggiorna le statistiche. Solo dal task del bus (o prima del suo avvio).
+static bool i2cExecute(uint8_t dev, bool (*fn)(void *), void *arg, uint32_t submitUs) {
+  uint32_t t0 = micros();
+  bool ok = fn(arg);
+  uint32_t t1 = micros();
+
+  I2cDevStats &s = i2cDevStats[dev];
+  s.jobs++;
+  if (!ok) s.errors++;
+  s.waitUsLast = t0 - submitUs;
+  if (s.waitUsLast > s.waitUsMax) s.waitUsMax = s.waitUsLast;
+  i2cUpdateAvg(s.waitUsAvg, s.waitUsLast);
+  s.execUsLast = t1 - t0;
+  if (s.execUsLast > s.execUsMax) s.execUsMax = s.execUsLast;
+  i2cUpdateAvg(s.execUsAvg, s.execUsLast);
+  return ok;
+}
+
+// ===== API =====
+// Esegue fn(arg) sul bus con la priorita' del dispositivo e ne ritorna l'esito.
+// Bloccante: arg puo' puntare allo stack del chiamante. Prima di i2cBusBegin()
+// (setup a task singolo) e dentro il task del bus la transazione e' eseguita subito.
+bool i2cBusRun(uint8_t dev, bool (*fn)(void *), void *arg) {
+  if (dev >= I2C_DEV_COUNT) return false;
+  if (i2cBusTaskHandle == nullptr || xTaskGetCurrentTaskHandle() == i2cBusTaskHandle) {
+    return i2cExecute(dev, fn, arg, micros());
+  }
+
+  xSemaphoreTake(i2cDevLock[dev], portMAX_DELAY);
+  I2cJob &job = i2cJobs[dev];
+  job.fn = fn;
+  job.arg = arg;
+  job.submitUs = micros();
+  job.result = false;
+  xTaskNotify(i2cBusTaskHandle, 1UL << dev, eSetBits);
+  while (xSemaphoreTake(i2cDevDone[dev], pdMS_TO_TICKS(I2C_BUS_STALL_MS)) != pdTRUE) {
+    i2cDevStats[dev].stalls++;
+  }
+  bool ok = job.result;
+  xSemaphoreGive(i2cDevLock[dev]);
+  return ok;
+}
+
+// Verifica la presenza di un dispositivo (indirizzo con ACK).
+bool i2cBusProbe(uint8_t dev, uint8_t address) {
+  return i2cBusRun(dev, [](void *a) {
+    Wire.beginTransmission(*(uint8_t *)a);
+    return Wire.endTransmission() == 0;
+  }, &address);
+}
+
+// ===== BME280 forced mode =====
+// Da chiamare dopo bme.begin() + setSampling(MODE_FORCED, ...) (setup_bme280)
+void i2cBmeAttach(uint8_t address) {
+  i2cBmeAddress = address;
+}
+
+static bool i2cBmeTrigger(void *) {
+  Wire.beginTransmission(i2cBmeAddress);
+  Wire.write(I2C_BME_REG_CTRL_MEAS);
+  Wire.write(I2C_BME_CTRL_FORCED);
+  return Wire.endTransmission() == 0;
+}
+
+static bool i2cBmeReadRegs(void *) {
+  float t = bme.readTemperature();
+  float h = bme.readHumidity();
+  float p = bme.readPressure() / 100.0F;
+  if (isnan(t) || isnan(h) || isnan(p)) return false;
+
+  portENTER_CRITICAL(&i2cBmeMux);
+  i2cBmeCache.temperature = t;
+  i2cBmeCache.humidity = h;
+  i2cBmeCache.pressure = p;
+  i2cBmeCache.sampleMs = millis();
+  i2cBmeCache.samples++;
+  i2cBmeCache.valid = true;
+  portEXIT_CRITICAL(&i2cBmeMux);
+  return true;
+}
+
+// Misura completa sincrona (setup): avvia, attende la conversione fuori dal bus, legge.
+bool i2cBmeSampleNow() {
+  if (i2cBmeAddress == 0) return false;
+  if (!i2cBusRun(I2C_DEV_BME280, i2cBmeTrigger, nullptr)) return false;
+  delay(I2C_BME_CONV_MS);
+  return i2cBusRun(I2C_DEV_BME280, i2cBmeReadRegs, nullptr);
+}
+
+// Ultima lettura pubblicata (valori grezzi, senza offset). false se non ancora disponibile.
+bool i2cBmeGet(float &temperature, float &humidity, float &pressure) {
+  portENTER_CRITICAL(&i2cBmeMux);
+  I2cBmeCache c = i2cBmeCache;
+  portEXIT_CRITICAL(&i2cBmeMux);
+  if (!c.valid) return false;
+  temperature = c.temperature;
+  humidity = c.humidity;
+  pressure = c.pressure;
+  return true;
+}
+
+// ===== Task del bus =====
+static void i2cBusTask(void *) {
+  uint32_t pending = 0;
+  bool     bmeConverting = false;
+  uint32_t bmeDueMs = millis() + I2C_BME_POLL_MS;
+
+  for (;;) {
+    // Nessuna transazione pendente: dormi fino alla prossima notifica o al prossimo poll
+    TickType_t wait = portMAX_DELAY;
+    if (pending == 0 && bme280Available && i2cBmeAddress != 0) {
+      int32_t dt = (int32_t)(bmeDueMs - millis());
+      wait = dt > 0 ? pdMS_TO_TICKS(dt) : 0;
+    }
+    uint32_t bits = 0;
+    xTaskNotifyWait(0, ULONG_MAX, &bits, pending ? 0 : wait);
+    pending |= bits;
+
+    if (pending) {
+      // Bit piu' basso = priorita' piu' alta. Una transazione per giro: tra una e
+      // l'altra la notifica viene riletta, cosi' un tocco appena arrivato passa avanti.
+      uint8_t dev = __builtin_ctz(pending);
+      pending &= ~(1UL << dev);
+      I2cJob &job = i2cJobs[dev];
+      job.result = i2cExecute(dev, job.fn, job.arg, job.submitUs);
+      xSemaphoreGive(i2cDevDone[dev]);
+      continue;
+    }
+
+    // Poll pianificato BME280 (solo con bus libero)
+    if (!bme280Available || i2cBmeAddress == 0) continue;
+    if ((int32_t)(millis() - bmeDueMs) < 0) continue;
+    if (!bmeConverting) {
+      bmeConverting = i2cExecute(I2C_DEV_BME280, i2cBmeTrigger, nullptr, micros());
+      bmeDueMs = millis() + (bmeConverting ? I2C_BME_CONV_MS : I2C_BME_POLL_MS);
+    } else {
+      i2cExecute(I2C_DEV_BME280, i2cBmeReadRegs, nullptr, micros());
+      bmeConverting = false;
+      bmeDueMs = millis() + I2C_BME_POLL_MS - I2C_BME_CONV_MS;
+    }
+  }
+}
+
+// Da chiamare dopo Wire.begin() e ts.begin() (setup_touch), prima di avviare altri task I2C
+void i2cBusBegin() {
+  if (i2cBusTaskHandle) return;
+  for (uint8_t i = 0; i < I2C_DEV_COUNT; i++) {
+    i2cDevLock[i] = xSemaphoreCreateMutex();
+    i2cDevDone[i] = xSemaphoreCreateBinary();
+  }
+  xTaskCreatePinnedToCore(i2cBusTask, "i2cBus", I2C_BUS_TASK_STACK, nullptr,
+                          I2C_BUS_TASK_PRIO, &i2cBusTaskHandle, I2C_BUS_TASK_CORE);
+  Serial.printf("[I2C] Arbitro bus avviato (core %d, prio %d)\n", I2C_BUS_TASK_CORE, I2C_BUS_TASK_PRIO);
+}
+
+// ===== Stato per interfaccia web =====
+String getI2cBusJson() {
+  String json = "{\"running\":" + String(i2cBusTaskHandle ? "true" : "false");
+  json += ",\"devices\":[";
+  for (uint8_t i = 0; i < I2C_DEV_COUNT; i++) {
+    const I2cDevStats &s = i2cDevStats[i];
+    if (i) json += ",";
+    json += "{\"name\":\"" + String(i2cDevNames[i]) + "\"";
+    json += ",\"priority\":" + String(i);
+    json += ",\"jobs\":" + String(s.jobs);
+    json += ",\"errors\":" + String(s.errors);
+    json += ",\"stalls\":" + String(s.stalls);
+    json += ",\"waitUsLast\":" + String(s.waitUsLast);
+    json += ",\"waitUsAvg\":" + String(s.waitUsAvg);
+    json += ",\"waitUsMax\":" + String(s.waitUsMax);
+    json += ",\"execUsLast\":" + String(s.execUsLast);
+    json += ",\"execUsAvg\":" + String(s.execUsAvg);
+    json += ",\"execUsMax\":" + String(s.execUsMax);
+    json += "}";
+  }
+  json += "]";
+
+  portENTER_CRITICAL(&i2cBmeMux);
+  I2cBmeCache c = i2cBmeCache;
+  portEXIT_CRITICAL(&i2cBmeMux);
+  json += ",\"bme280\":{\"valid\":" + String(c.valid ? "true" : "false");
+  json += ",\"samples\":" + String(c.samples);
+  json += ",\"pollMs\":" + String(I2C_BME_POLL_MS);
+  json += ",\"ageMs\":" + String(c.valid ? millis() - c.sampleMs : 0);
+  json += ",\"temperature\":" + String(c.temperature, 2);
+  json += ",\"humidity\":" + String(c.humidity, 1);
+  json += ",\"pressure\":" + String(c.pressure, 1);
+  json += "}}";
+  return json;
+}
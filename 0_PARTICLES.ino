@@ -0,0 +1,464 @@
+// ================== PARTICLES - MOTORE PARTICELLE IN VIRGOLA FISSA ==================
+// Motore condiviso dagli effetti a particelle (Capodanno, Flux Capacitor, Natale).
+//
+// Storage a strutture di array (ParticleSystem, particle_types.h): posizioni e velocità Q8
+// in array separati, percorsi in sequenza dall'integratore e dal renderer. Le particelle vive
+// restano compatte in [0, count): l'eliminazione sposta l'ultima nello slot liberato.
+// Ogni sistema ha il suo emettitore e il suo integratore (callback); senza integratore
+// si usa quello standard (moto + gravità + vita).
+//
+// Il renderer scrive direttamente nel frame buffer del ParticleCanvas e registra il
+// rettangolo toccato da ogni sprite. All'inizio del frame successivo si ripristinano solo
+// quei rettangoli dallo strato di sfondo in cache; se l'area registrata supera un terzo
+// dello schermo conviene la copia intera (un solo memcpy). Al display vanno solo i
+// rettangoli ripristinati, disegnati o aggiornati nel frame. Il write-back della cache
+// di ogni chiamata copre tutto l'intervallo di indirizzi, passo delle righe compreso:
+// un rettangolo stretto va quindi riga per riga (ogni riga è contigua nel frame buffer),
+// uno largo a righe intere. Il rettangolo ripristinato e quello ridisegnato dello stesso
+// sprite si uniscono quando costa meno; se il totale supera la banda di righe modificata
+// si trasferisce la banda.
+//
+// Niente sin()/cos()/random() per frame: direzioni dalla tabella Q15 di 0_HAND_RASTER
+// (solo all'emissione) e generatore xorshift32.
+
+#define PARTICLE_RESTORE_FULL_DIV  3     // Copia intera oltre 1/3 dello schermo da ripristinare
+#define PARTICLE_BLIT_CALL_PX      64    // Costo stimato di una chiamata al display, in pixel scritti
+
+// ===== Generatore casuale veloce (xorshift32) =====
+static uint32_t particleRngState = 0x2545F491;
+
+void particleSeed(uint32_t seed) {
+  particleRngState = seed ? seed : 0x2545F491;
+}
+
+static inline uint32_t particleRand() {
+  uint32_t s = particleRngState;
+  s ^= s << 13;
+  s ^= s >> 17;
+  s ^= s << 5;
+  particleRngState = s;
+  return s;
+}
+
+// Intero casuale in [lo, hi] (moltiplicazione invece del modulo)
+static inline int32_t particleRandRange(int32_t lo, int32_t hi) {
+  return lo + (int32_t)(((uint64_t)particleRand() * (uint32_t)(hi - lo + 1)) >> 32);
+}
+
+// Vettore unitario Q15 per un angolo in gradi (0=destra, senso orario come lo schermo)
+void particleDirQ15(float degrees, int32_t* dx, int32_t* dy) {
+  *dx = handSinQ15(degrees + 90.0f);
+  *dy = handSinQ15(degrees);
+}
+
+// ================== SISTEMA ==================
+
+// Alloca lo storage SoA in un unico blocco (PSRAM, interna come ripiego)
+bool particleSystemAlloc(ParticleSystem* ps, uint16_t capacity) {
+  if (ps->block != nullptr) free(ps->block);
+  memset(ps, 0, sizeof(ParticleSystem));
+
+  size_t n = capacity;
+  size_t bytes = n * (4 * sizeof(int32_t) + 3 * sizeof(uint16_t) + sizeof(uint8_t));
+  uint8_t* block = (uint8_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (block == nullptr) block = (uint8_t*)malloc(bytes);
+  if (block == nullptr) {
+    Serial.printf("[PARTICLES] ERRORE: memoria insufficiente per %u particelle\n", capacity);
+    return false;
+  }
+
+  ps->block = block;
+  ps->x      = (int32_t*)block;
+  ps->y      = ps->x + n;
+  ps->vx     = ps->y + n;
+  ps->vy     = ps->vx + n;
+  ps->life   = (uint16_t*)(ps->vy + n);
+  ps->aux    = ps->life + n;
+  ps->color  = ps->aux + n;
+  ps->sprite = (uint8_t*)(ps->color + n);
+  ps->capacity = capacity;
+  ps->keyHi = 0xFFFF;
+  return true;
+}
+
+void particleSystemFree(ParticleSystem* ps) {
+  if (ps->block != nullptr) free(ps->block);
+  memset(ps, 0, sizeof(ParticleSystem));
+}
+
+// Aggiunge una particella; ritorna l'indice o -1 se il sistema è pieno
+int particleSpawn(ParticleSystem* ps, int32_t x, int32_t y, int32_t vx, int32_t vy,
+                  uint16_t life, uint16_t color, uint8_t sprite) {
+  if (ps->count >= ps->capacity) return -1;
+  uint16_t i = ps->count++;
+  ps->x[i] = x;
+  ps->y[i] = y;
+  ps->vx[i] = vx;
+  ps->vy[i] = vy;
+  ps->life[i] = life;
+  ps->aux[i] = life;
+  ps->color[i] = color;
+  ps->sprite[i] = sprite;
+  return i;
+}
+
+// Elimina la particella i spostando l'ultima al suo posto
+void particleKill(ParticleSystem* ps, uint16_t i) {
+  if (i >= ps->count) return;
+  uint16_t last = --ps->count;
+  if (i == last) return;
+  ps->x[i] = ps->x[last];
+  ps->y[i] = ps->y[last];
+  ps->vx[i] = ps->vx[last];
+  ps->vy[i] = ps->vy[last];
+  ps->life[i] = ps->life[last];
+  ps->aux[i] = ps->aux[last];
+  ps->color[i] = ps->color[last];
+  ps->sprite[i] = ps->sprite[last];
+}
+
+// Integratore standard: moto rettilineo + gravità, eliminazione a fine vita
+void particleIntegrateDefault(ParticleSystem* ps) {
+  const int32_t g = ps->gravity;
+  uint16_t i = 0;
+  while (i < ps->count) {
+    if (ps->life[i] <= 1) {
+      particleKill(ps, i);  // Nello slot i ora c'e' l'ultima: va ancora integrata
+      continue;
+    }
+    ps->life[i]--;
+    ps->x[i] += ps->vx[i];
+    ps->y[i] += ps->vy[i];
+    ps->vy[i] += g;
+    i++;
+  }
+}
+
+// Un passo di simulazione: emettitore, poi integratore del sistema
+void particleStep(ParticleSystem* ps, uint32_t now) {
+  if (ps->emit != nullptr) ps->emit(ps, now);
+  if (ps->integrate != nullptr) ps->integrate(ps);
+  else particleIntegrateDefault(ps);
+}
+
+// ================== CANVAS ==================
+
+bool particleCanvasBegin(ParticleCanvas* c, uint16_t* fb, const uint16_t* layer,
+                         int16_t w, int16_t h, uint16_t rectCap) {
+  if (c->rects == nullptr || c->rectCap != rectCap) {
+    // Un blocco: rettangoli da ripristinare, poi quelli da trasferire (ripristino + disegno + aggiornamenti)
+    uint32_t blitCap = 2 * (uint32_t)rectCap + 64;
+    size_t bytes = (rectCap + blitCap) * 4 * sizeof(int16_t);
+    if (c->rects != nullptr) free(c->rects);
+    c->rects = (int16_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (c->rects == nullptr) c->rects = (int16_t*)malloc(bytes);
+    c->rectCap = (c->rects != nullptr) ? rectCap : 0;
+    c->blits = (c->rects != nullptr) ? c->rects + rectCap * 4 : nullptr;
+    c->blitCap = (c->rects != nullptr) ? (uint16_t)min(blitCap, (uint32_t)0xFFFF) : 0;
+  }
+  c->fb = fb;
+  c->layer = layer;
+  c->w = w;
+  c->h = h;
+  c->rectCount = 0;
+  c->rectArea = 0;
+  c->fullRestore = true;  // Primo frame: frame buffer da ricostruire per intero
+  c->dirtyY0 = h;
+  c->dirtyY1 = -1;
+  c->blitCount = 0;
+  c->blitRestored = 0;
+  c->blitCost = 0;
+  c->blitBand = false;
+  return c->rects != nullptr;
+}
+
+void particleCanvasEnd(ParticleCanvas* c) {
+  if (c->rects != nullptr) free(c->rects);
+  memset(c, 0, sizeof(ParticleCanvas));
+}
+
+// Il frame buffer non corrisponde più allo strato (altri modi lo hanno usato, nuovo sfondo)
+void particleCanvasInvalidate(ParticleCanvas* c) {
+  c->fullRestore = true;
+}
+
+// Costo al display di un rettangolo w x h: una chiamata per riga o una a righe intere
+static inline uint32_t particleBlitCost(const ParticleCanvas* c, int16_t w, int16_t h) {
+  uint32_t rows = (uint32_t)h * (PARTICLE_BLIT_CALL_PX + w);
+  uint32_t full = PARTICLE_BLIT_CALL_PX + (uint32_t)h * c->w;
+  return rows < full ? rows : full;
+}
+
+// Zona da trasferire al display: banda di righe e, finché c'e' posto, il rettangolo
+static inline void particleDirty(ParticleCanvas* c, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  if (y0 < c->dirtyY0) c->dirtyY0 = y0;
+  if (y1 > c->dirtyY1) c->dirtyY1 = y1;
+  if (c->blitBand) return;
+  if (c->blitCount >= c->blitCap) {
+    c->blitBand = true;
+    return;
+  }
+  int16_t* r = c->blits + c->blitCount * 4;
+  r[0] = x0; r[1] = y0; r[2] = x1; r[3] = y1;
+  c->blitCount++;
+  c->blitCost += particleBlitCost(c, x1 - x0 + 1, y1 - y0 + 1);
+}
+
+// Sprite i del frame: di solito è lo stesso del rettangolo i ripristinato (stesso ordine di
+// disegno), che si allarga a comprenderlo quando una chiamata sola costa meno di due
+static inline bool particleDirtyMerge(ParticleCanvas* c, uint16_t i, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  if (c->blitBand || i >= c->blitRestored) return false;
+  int16_t* r = c->blits + i * 4;
+  int16_t ux0 = min(r[0], x0), uy0 = min(r[1], y0), ux1 = max(r[2], x1), uy1 = max(r[3], y1);
+  uint32_t was = particleBlitCost(c, r[2] - r[0] + 1, r[3] - r[1] + 1);
+  uint32_t merged = particleBlitCost(c, ux1 - ux0 + 1, uy1 - uy0 + 1);
+  if (merged > was + particleBlitCost(c, x1 - x0 + 1, y1 - y0 + 1)) return false;
+  r[0] = ux0; r[1] = uy0; r[2] = ux1; r[3] = uy1;
+  c->blitCost += merged - was;
+  if (y0 < c->dirtyY0) c->dirtyY0 = y0;
+  if (y1 > c->dirtyY1) c->dirtyY1 = y1;
+  return true;
+}
+
+// Copia un rettangolo (già ritagliato) dallo strato al frame buffer
+static void particleCopyRect(ParticleCanvas* c, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  int16_t n = x1 - x0 + 1;
+  uint32_t p = (uint32_t)y0 * c->w + x0;
+  for (int16_t y = y0; y <= y1; y++, p += c->w) {
+    if (n <= 8) {
+      // Sprite piccoli: copia diretta, più veloce della chiamata a memcpy
+      for (int16_t k = 0; k < n; k++) c->fb[p + k] = (c->layer != nullptr) ? c->layer[p + k] : 0;
+    } else if (c->layer != nullptr) {
+      memcpy(c->fb + p, c->layer + p, n * sizeof(uint16_t));
+    } else {
+      memset(c->fb + p, 0, n * sizeof(uint16_t));
+    }
+  }
+}
+
+// Inizio frame: rimette lo sfondo dove il frame precedente ha disegnato
+void particleCanvasRestore(ParticleCanvas* c) {
+  uint32_t fullArea = (uint32_t)c->w * c->h;
+  if (c->fullRestore || c->rectArea > fullArea / PARTICLE_RESTORE_FULL_DIV) {
+    if (c->layer != nullptr) memcpy(c->fb, c->layer, fullArea * sizeof(uint16_t));
+    else memset(c->fb, 0, fullArea * sizeof(uint16_t));
+    particleDirty(c, 0, 0, c->w - 1, c->h - 1);
+    c->blitBand = true;
+    c->fullRestore = false;
+  } else {
+    const int16_t* r = c->rects;
+    for (uint16_t i = 0; i < c->rectCount; i++, r += 4) {
+      particleCopyRect(c, r[0], r[1], r[2], r[3]);
+      particleDirty(c, r[0], r[1], r[2], r[3]);
+    }
+    c->blitRestored = c->blitCount;
+  }
+  c->rectCount = 0;
+  c->rectArea = 0;
+}
+
+// Registra un rettangolo disegnato (coordinate incluse) per il ripristino al frame successivo
+void particleCanvasMark(ParticleCanvas* c, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 >= c->w) x1 = c->w - 1;
+  if (y1 >= c->h) y1 = c->h - 1;
+  if (x0 > x1 || y0 > y1) return;
+
+  if (!particleDirtyMerge(c, c->rectCount, x0, y0, x1, y1)) particleDirty(c, x0, y0, x1, y1);
+  if (c->fullRestore) return;  // Copia intera già decisa
+  if (c->rectCount >= c->rectCap) {
+    c->fullRestore = true;
+    return;
+  }
+  int16_t* r = c->rects + c->rectCount * 4;
+  r[0] = x0; r[1] = y0; r[2] = x1; r[3] = y1;
+  c->rectCount++;
+  c->rectArea += (uint32_t)(x1 - x0 + 1) * (y1 - y0 + 1);
+}
+
+// Lo strato è cambiato in un rettangolo (luci, orario...): riporta quei pixel nel frame buffer.
+// Va chiamata dopo particleCanvasRestore e prima del disegno delle particelle.
+void particleCanvasRefresh(ParticleCanvas* c, int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  if (x0 < 0) x0 = 0;
+  if (y0 < 0) y0 = 0;
+  if (x1 >= c->w) x1 = c->w - 1;
+  if (y1 >= c->h) y1 = c->h - 1;
+  if (x0 > x1 || y0 > y1) return;
+  particleCopyRect(c, x0, y0, x1, y1);
+  particleDirty(c, x0, y0, x1, y1);
+}
+
+// Un rettangolo al display, direttamente dal frame buffer: riga per riga se stretto,
+// altrimenti le sue righe a tutta larghezza (contigue in memoria)
+static void particleBlitRect(ParticleCanvas* c, int16_t ox, int16_t oy,
+                             int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+  int16_t w = x1 - x0 + 1, h = y1 - y0 + 1;
+  const uint16_t* src = c->fb + (uint32_t)y0 * c->w;
+  if ((uint32_t)h * (PARTICLE_BLIT_CALL_PX + w) >= PARTICLE_BLIT_CALL_PX + (uint32_t)h * c->w) {
+    gfx->draw16bitRGBBitmap(ox, oy + y0, (uint16_t*)src, c->w, h);
+    return;
+  }
+  for (int16_t y = y0; y <= y1; y++, src += c->w) gfx->draw16bitRGBBitmap(ox + x0, oy + y, (uint16_t*)src + x0, w, 1);
+}
+
+// Trasferisce al display la zona modificata: i rettangoli del frame, o la banda di righe
+// a tutta larghezza quando i rettangoli costerebbero di più
+void particleCanvasBlit(ParticleCanvas* c) {
+  if (c->dirtyY1 >= c->dirtyY0) {
+    int16_t ox = (gfx->width() - c->w) / 2;
+    int16_t oy = (gfx->height() - c->h) / 2;
+    uint32_t band = PARTICLE_BLIT_CALL_PX + (uint32_t)(c->dirtyY1 - c->dirtyY0 + 1) * c->w;
+    if (c->blitBand || c->blitCost >= band) {
+      gfx->draw16bitRGBBitmap(ox, oy + c->dirtyY0, c->fb + (uint32_t)c->dirtyY0 * c->w,
+                              c->w, c->dirtyY1 - c->dirtyY0 + 1);
+    } else {
+      const int16_t* r = c->blits;
+      for (uint16_t i = 0; i < c->blitCount; i++, r += 4) particleBlitRect(c, ox, oy, r[0], r[1], r[2], r[3]);
+    }
+  }
+  c->dirtyY0 = c->h;
+  c->dirtyY1 = -1;
+  c->blitCount = 0;
+  c->blitRestored = 0;
+  c->blitCost = 0;
+  c->blitBand = false;
+}
+
+// Pixel singolo per i renderer personalizzati (il chiamante registra il rettangolo)
+static inline void particlePlot(ParticleCanvas* c, int16_t x, int16_t y, uint16_t color) {
+  if ((uint16_t)x < (uint16_t)c->w && (uint16_t)y < (uint16_t)c->h) {
+    c->fb[(uint32_t)y * c->w + x] = color;
+  }
+}
+
+// ================== RENDERER ==================
+
+// Pixel di uno sprite all'indice p del frame buffer (già dentro il canvas):
+// chiave colore sullo strato, sfumatura verso lo sfondo
+static inline void particlePutAt(ParticleCanvas* c, const ParticleSystem* ps, bool keyed,
+                                 uint32_t p, uint16_t color, uint32_t alpha) {
+  if (keyed) {
+    uint16_t bg = c->layer[p];
+    if (bg < ps->keyLo || bg > ps->keyHi) return;
+  }
+  if (alpha < 32) color = rgb565Blend(color, c->layer != nullptr ? c->layer[p] : 0, alpha);
+  c->fb[p] = color;
+}
+
+// Pixel di uno sprite con ritaglio (sprite a cavallo del bordo)
+static inline void particlePut(ParticleCanvas* c, const ParticleSystem* ps, bool keyed,
+                               int16_t x, int16_t y, uint16_t color, uint32_t alpha) {
+  if ((uint16_t)x >= (uint16_t)c->w || (uint16_t)y >= (uint16_t)c->h) return;
+  particlePutAt(c, ps, keyed, (uint32_t)y * c->w + x, color, alpha);
+}
+
+// Sprite a distanza >= m dal bordo: i pixel si indirizzano senza ritaglio
+static inline bool particleInside(const ParticleCanvas* c, int16_t x, int16_t y, int16_t m) {
+  return x >= m && y >= m && x < c->w - m && y < c->h - m;
+}
+
+// Disegna tutte le particelle del sistema nel canvas
+void particleRender(ParticleSystem* ps, ParticleCanvas* c) {
+  const bool keyed = (ps->flags & PART_FLAG_KEYED) && c->layer != nullptr;
+  const bool fade = (ps->flags & PART_FLAG_FADE) != 0;
+
+  for (uint16_t i = 0; i < ps->count; i++) {
+    int16_t px = PART_INT(ps->x[i]);
+    int16_t py = PART_INT(ps->y[i]);
+    uint16_t color = ps->color[i];
+    uint32_t alpha = 32;
+    if (fade && ps->aux[i] > 0) {
+      alpha = ((uint32_t)ps->life[i] * 32 + ps->aux[i] - 1) / ps->aux[i];
+      if (alpha > 32) alpha = 32;
+    }
+
+    switch (ps->sprite[i]) {
+      case PART_SPRITE_DOT:
+        if ((uint16_t)px >= (uint16_t)c->w || (uint16_t)py >= (uint16_t)c->h) break;
+        particleCanvasMark(c, px, py, px, py);
+        particlePutAt(c, ps, keyed, (uint32_t)py * c->w + px, color, alpha);
+        break;
+
+      case PART_SPRITE_SMALL:
+        if (px < -1 || py < -1 || px >= c->w || py >= c->h) break;
+        particleCanvasMark(c, px, py, px + 1, py + 1);
+        if (particleInside(c, px, py, 1)) {
+          uint32_t p = (uint32_t)py * c->w + px;
+          particlePutAt(c, ps, keyed, p, color, alpha);
+          particlePutAt(c, ps, keyed, p + 1, color, alpha);
+          particlePutAt(c, ps, keyed, p + c->w, color, alpha);
+          break;
+        }
+        particlePut(c, ps, keyed, px, py, color, alpha);
+        particlePut(c, ps, keyed, px + 1, py, color, alpha);
+        particlePut(c, ps, keyed, px, py + 1, color, alpha);
+        break;
+
+      case PART_SPRITE_PLUS:
+        if (px < -1 || py < -1 || px > c->w || py > c->h) break;
+        particleCanvasMark(c, px - 1, py - 1, px + 1, py + 1);
+        if (particleInside(c, px, py, 1)) {
+          uint32_t p = (uint32_t)py * c->w + px;
+          particlePutAt(c, ps, keyed, p, color, alpha);
+          particlePutAt(c, ps, keyed, p - 1, color, alpha);
+          particlePutAt(c, ps, keyed, p + 1, color, alpha);
+          particlePutAt(c, ps, keyed, p - c->w, color, alpha);
+          particlePutAt(c, ps, keyed, p + c->w, color, alpha);
+          break;
+        }
+        particlePut(c, ps, keyed, px, py, color, alpha);
+        particlePut(c, ps, keyed, px - 1, py, color, alpha);
+        particlePut(c, ps, keyed, px + 1, py, color, alpha);
+        particlePut(c, ps, keyed, px, py - 1, color, alpha);
+        particlePut(c, ps, keyed, px, py + 1, color, alpha);
+        break;
+
+      case PART_SPRITE_DISC:
+        if (px < -2 || py < -2 || px > c->w + 1 || py > c->h + 1) break;
+        particleCanvasMark(c, px - 2, py - 2, px + 2, py + 2);
+        if (particleInside(c, px, py, 2)) {
+          uint32_t p = (uint32_t)(py - 2) * c->w + px;
+          for (int8_t dy = -2; dy <= 2; dy++, p += c->w) {
+            int8_t span = (dy == -2 || dy == 2) ? 1 : 2;
+            for (int8_t dx = -span; dx <= span; dx++) particlePutAt(c, ps, keyed, p + dx, color, alpha);
+          }
+          break;
+        }
+        for (int8_t dy = -2; dy <= 2; dy++) {
+          int8_t span = (dy == -2 || dy == 2) ? 1 : 2;
+          for (int8_t dx = -span; dx <= span; dx++) {
+            particlePut(c, ps, keyed, px + dx, py + dy, color, alpha);
+          }
+        }
+        break;
+
+      case PART_SPRITE_STREAK:
+      default: {
+        // Dalla posizione di due frame fa alla testa, luminosità crescente (DDA in Q8)
+        int32_t tx = ps->x[i] - 2 * ps->vx[i];
+        int32_t ty = ps->y[i] - 2 * ps->vy[i];
+        int16_t qx = PART_INT(tx), qy = PART_INT(ty);
+        int16_t x0 = min(px, qx), x1 = max(px, qx);
+        int16_t y0 = min(py, qy), y1 = max(py, qy);
+        if (x1 < 0 || y1 < 0 || x0 >= c->w || y0 >= c->h) break;
+        particleCanvasMark(c, x0, y0, x1, y1);
+        int32_t steps = max(x1 - x0, y1 - y0);
+        if (steps > 16) steps = 16;
+        if (steps == 0) {
+          particlePut(c, ps, keyed, px, py, color, alpha);
+          break;
+        }
+        int32_t sx = (ps->x[i] - tx) / steps;
+        int32_t sy = (ps->y[i] - ty) / steps;
+        for (int32_t k = 0; k <= steps; k++) {
+          uint32_t a = alpha * (uint32_t)(k + 1) / (uint32_t)(steps + 1);
+          particlePut(c, ps, keyed, PART_INT(tx), PART_INT(ty), color, a);
+          tx += sx;
+          ty += sy;
+        }
+        break;
+      }
+    }
+  }
+}
@@ -0,0 +1,431 @@
+// ================== SETTINGS STORE - SCHEMA IMPOSTAZIONI E COMMIT DIFFERITI ==================
+// Sopra la EEPROM emulata (1KB) aggiunge:
+//  - una tabella schema (chiave, indirizzo, tipo, default, range, versione) da cui
+//    derivano sia i default del primo avvio (setup_eeprom / loadSavedSettings) sia la
+//    validazione in lettura: un valore fuori range torna al default della tabella
+//  - commit differiti: settingsCommit() marca la cache come sporca e il loop esegue
+//    UN solo EEPROM.commit() quando le scritture si fermano (pagina impostazioni che
+//    salva 10 campi di fila = 1 commit invece di 10, senza bloccare il render)
+//  - migrazione per revisione schema: le chiavi aggiunte in una revisione successiva
+//    ricevono il default senza azzerare le altre impostazioni. Le chiavi che prima
+//    avevano un blocco di default scritto a mano con marker di validita' (LED Ring,
+//    LED RGB, dual display) indicano quel marker come guardia: se il marker c'e' e il valore
+//    e' nel range il valore salvato resta, altrimenti si scrive il default
+//
+// Restano fuori dalla tabella i blocchi con marker propri non ancora migrati
+// (Flux Capacitor, sveglia radio, scrolltext, opzioni setup, calibrazione BME280)
+// e le credenziali WiFi, che vengono salvate subito con settingsFlush().
+//
+// Su ESP32 la libreria EEPROM salva l'intera immagine come blob NVS: NVS e' gia'
+// un log append-only con wear levelling e scritture atomiche (un commit interrotto
+// lascia la copia precedente), quindi non serve un journal aggiuntivo. Ogni commit
+// pero' riscrive tutti i EEPROM_SIZE byte: il costo da ridurre e' il numero di commit.
+//
+// settingsFlush() esegue il commit subito (chi deve sapere se e' riuscito, o prima
+// di un riavvio); un shutdown handler salva comunque le modifiche pendenti su ESP.restart().
+
+#include <esp_system.h>
+
+// ===== Parametri coalescenza =====
+#define SETTINGS_COMMIT_QUIET_MS     1500   // Commit dopo 1.5s senza nuove scritture
+#define SETTINGS_COMMIT_MAX_DELAY_MS 5000   // ...ma mai oltre 5s dalla prima modifica pendente
+#define SETTINGS_COMMIT_MIN_GAP_MS   2000   // Distanza minima tra due commit
+
+// ===== Revisione schema =====
+// Incrementare quando si aggiungono chiavi alla tabella (con version = nuova revisione)
+#define SETTINGS_SCHEMA_REV          3
+
+enum SettingType : uint8_t {
+  SET_U8  = 0,   // 1 byte
+  SET_U16 = 1,   // 2 byte big-endian (come le coordinate BTTF e i colori RGB565)
+  SET_STR = 2    // stringa a lunghezza fissa, terminata da 0
+};
+
+struct SettingDef {
+  const char *key;
+  uint16_t    addr;
+  uint8_t     type;
+  uint8_t     len;       // Byte occupati
+  int32_t     def;
+  int32_t     minVal;
+  int32_t     maxVal;
+  uint8_t     version;   // Revisione schema che ha introdotto la chiave
+  const char *defStr;    // Solo SET_STR
+  uint16_t    guardAddr; // Marker di validita' del gruppo (0 = nessuno), usato dalla migrazione
+  uint8_t     guardVal;
+};
+
+#define SETTING_U8(k, a, d, mn, mx)   { k, a, SET_U8,  1, d, mn, mx, 1, nullptr, 0, 0 }
+#define SETTING_U16(k, a, d, mn, mx)  { k, a, SET_U16, 2, d, mn, mx, 1, nullptr, 0, 0 }
+#define SETTING_STR(k, a, n, s)       { k, a, SET_STR, n, 0, 0, 0, 1, s, 0, 0 }
+// Chiave introdotta nella revisione 'rev', con marker di gruppo opzionale (ga = 0: nessuno).
+// Il marker stesso va in tabella DOPO le chiavi del gruppo, con range [gv..gv]
+#define SETTING_U8_REV(k, a, d, mn, mx, rev, ga, gv) { k, a, SET_U8, 1, d, mn, mx, rev, nullptr, ga, gv }
+
+// ===== Tabella schema =====
+// 0xFF e' il valore di una cella mai scritta: i range lo escludono dove serve
+const SettingDef settingsSchema[] = {
+  SETTING_U8 ("preset",            EEPROM_PRESET_ADDR,            0,   0, 13),
+  SETTING_U8 ("mode",              EEPROM_MODE_ADDR,              MODE_FAST, 0, NUM_MODES - 1),
+  SETTING_U8 ("wordE",             EEPROM_WORD_E_STATE_ADDR,      1,   0, 1),
+  SETTING_U8 ("colorR",            EEPROM_COLOR_R_ADDR,           255, 0, 255),
+  SETTING_U8 ("colorG",            EEPROM_COLOR_G_ADDR,           255, 0, 255),
+  SETTING_U8 ("colorB",            EEPROM_COLOR_B_ADDR,           255, 0, 255),
+  SETTING_U8 ("clockDate",         EEPROM_CLOCK_DATE_ADDR,        1,   0, 1),
+  SETTING_U8 ("dayStartHour",      EEPROM_DAY_START_HOUR_ADDR,    8,   0, 23),
+  SETTING_U8 ("dayStartMin",       EEPROM_DAY_START_MIN_ADDR,     0,   0, 59),
+  SETTING_U8 ("nightStartHour",    EEPROM_NIGHT_START_HOUR_ADDR,  22,  0, 23),
+  SETTING_U8 ("nightStartMin",     EEPROM_NIGHT_START_MIN_ADDR,   0,   0, 59),
+  SETTING_U8 ("hourlyAnnounce",    EEPROM_HOURLY_ANNOUNCE_ADDR,   1,   0, 1),
+  SETTING_U8 ("ttsAnnounce",       EEPROM_TTS_ANNOUNCE_ADDR,      0,   0, 1),
+  SETTING_U8 ("ttsVoiceFemale",    EEPROM_TTS_VOICE_FEMALE_ADDR,  1,   0, 1),
+  SETTING_U8 ("brightnessDay",     EEPROM_BRIGHTNESS_DAY_ADDR,    BRIGHTNESS_DAY_DEFAULT,   10, 254),
+  SETTING_U8 ("brightnessNight",   EEPROM_BRIGHTNESS_NIGHT_ADDR,  BRIGHTNESS_NIGHT_DEFAULT, 10, 254),
+  SETTING_U8 ("audioVolume",       EEPROM_AUDIO_VOLUME_ADDR,      80,  0, 100),
+  SETTING_U8 ("audioDayEnabled",   EEPROM_AUDIO_DAY_ENABLED_ADDR, 1,   0, 1),
+  SETTING_U8 ("audioNightEnabled", EEPROM_AUDIO_NIGHT_ENABLED_ADDR, 0, 0, 1),
+  SETTING_U8 ("volumeDay",         EEPROM_VOLUME_DAY_ADDR,        80,  0, 100),
+  SETTING_U8 ("volumeNight",       EEPROM_VOLUME_NIGHT_ADDR,      30,  0, 100),
+  SETTING_U8 ("randomMode",        EEPROM_RANDOM_MODE_ADDR,       0,   0, 1),
+  SETTING_U8 ("randomInterval",    EEPROM_RANDOM_INTERVAL_ADDR,   5,   1, 60),
+
+#ifdef EFFECT_ANALOG_CLOCK
+  SETTING_U16("clockHourColor",    EEPROM_CLOCK_HOUR_COLOR_ADDR,   BLACK, 0, 0xFFFF),
+  SETTING_U16("clockMinuteColor",  EEPROM_CLOCK_MINUTE_COLOR_ADDR, BLACK, 0, 0xFFFF),
+  SETTING_U16("clockSecondColor",  EEPROM_CLOCK_SECOND_COLOR_ADDR, RED,   0, 0xFFFF),
+  SETTING_U16("clockDateY",        EEPROM_CLOCK_DATE_Y_ADDR,       320,   0, 479),
+  SETTING_STR("clockSkin",         EEPROM_CLOCK_SKIN_NAME_ADDR,    32, "orologio.jpg"),
+  SETTING_U8_REV("clockSmoothSeconds", EEPROM_CLOCK_SMOOTH_SECONDS_ADDR, 0, 0, 1, 2, 0, 0),
+  SETTING_U8_REV("clockRainbow",       EEPROM_CLOCK_RAINBOW_ADDR,        0, 0, 1, 2, 0, 0),
+#endif
+
+#ifdef EFFECT_BTTF
+  // DESTINATION TIME: Oct 26, 1985 - 1:20 AM
+  SETTING_U8 ("bttfDestMonth",     EEPROM_BTTF_DEST_MONTH_ADDR,   10,   1, 12),
+  SETTING_U8 ("bttfDestDay",       EEPROM_BTTF_DEST_DAY_ADDR,     26,   1, 31),
+  SETTING_U16("bttfDestYear",      EEPROM_BTTF_DEST_YEAR_ADDR,    1985, 0, 9999),
+  SETTING_U8 ("bttfDestHour",      EEPROM_BTTF_DEST_HOUR_ADDR,    1,    0, 23),
+  SETTING_U8 ("bttfDestMinute",    EEPROM_BTTF_DEST_MINUTE_ADDR,  20,   0, 59),
+  SETTING_U8 ("bttfDestAmPm",      EEPROM_BTTF_DEST_AMPM_ADDR,    0,    0, 1),
+  // LAST TIME DEPARTED: Nov 5, 1955 - 6:00 AM
+  SETTING_U8 ("bttfLastMonth",     EEPROM_BTTF_LAST_MONTH_ADDR,   11,   1, 12),
+  SETTING_U8 ("bttfLastDay",       EEPROM_BTTF_LAST_DAY_ADDR,     5,    1, 31),
+  SETTING_U16("bttfLastYear",      EEPROM_BTTF_LAST_YEAR_ADDR,    1955, 0, 9999),
+  SETTING_U8 ("bttfLastHour",      EEPROM_BTTF_LAST_HOUR_ADDR,    6,    0, 23),
+  SETTING_U8 ("bttfLastMinute",    EEPROM_BTTF_LAST_MINUTE_ADDR,  0,    0, 59),
+  SETTING_U8 ("bttfLastAmPm",      EEPROM_BTTF_LAST_AMPM_ADDR,    0,    0, 1),
+  SETTING_U8 ("bttfMonthFont",     EEPROM_BTTF_MONTH_FONT_SIZE_ADDR,  2, 0, 5),
+  SETTING_U8 ("bttfNumberFont",    EEPROM_BTTF_NUMBER_FONT_SIZE_ADDR, 2, 0, 5),
+  // Coordinate per campo, ottimizzate per bttf.jpg (480x480). Y base 75 / 235 / 395
+  SETTING_U16("bttfP1MonthX", EEPROM_BTTF_P1_MONTH_X_ADDR, 30,  0, 479),
+  SETTING_U16("bttfP1MonthY", EEPROM_BTTF_P1_MONTH_Y_ADDR, 75,  0, 479),
+  SETTING_U16("bttfP1DayX",   EEPROM_BTTF_P1_DAY_X_ADDR,   122, 0, 479),
+  SETTING_U16("bttfP1DayY",   EEPROM_BTTF_P1_DAY_Y_ADDR,   75,  0, 479),
+  SETTING_U16("bttfP1YearX",  EEPROM_BTTF_P1_YEAR_X_ADDR,  198, 0, 479),
+  SETTING_U16("bttfP1YearY",  EEPROM_BTTF_P1_YEAR_Y_ADDR,  75,  0, 479),
+  SETTING_U16("bttfP1AmPmX",  EEPROM_BTTF_P1_AMPM_X_ADDR,  295, 0, 479),
+  SETTING_U16("bttfP1AmPmY",  EEPROM_BTTF_P1_AMPM_Y_ADDR,  57,  0, 479),  // LED leggermente piu' alto
+  SETTING_U16("bttfP1HourX",  EEPROM_BTTF_P1_HOUR_X_ADDR,  320, 0, 479),
+  SETTING_U16("bttfP1HourY",  EEPROM_BTTF_P1_HOUR_Y_ADDR,  75,  0, 479),
+  SETTING_U16("bttfP1MinX",   EEPROM_BTTF_P1_MIN_X_ADDR,   400, 0, 479),
+  SETTING_U16("bttfP1MinY",   EEPROM_BTTF_P1_MIN_Y_ADDR,   75,  0, 479),
+  SETTING_U16("bttfP2MonthX", EEPROM_BTTF_P2_MONTH_X_ADDR, 30,  0, 479),
+  SETTING_U16("bttfP2MonthY", EEPROM_BTTF_P2_MONTH_Y_ADDR, 235, 0, 479),
+  SETTING_U16("bttfP2DayX",   EEPROM_BTTF_P2_DAY_X_ADDR,   122, 0, 479),
+  SETTING_U16("bttfP2DayY",   EEPROM_BTTF_P2_DAY_Y_ADDR,   235, 0, 479),
+  SETTING_U16("bttfP2YearX",  EEPROM_BTTF_P2_YEAR_X_ADDR,  198, 0, 479),
+  SETTING_U16("bttfP2YearY",  EEPROM_BTTF_P2_YEAR_Y_ADDR,  235, 0, 479),
+  SETTING_U16("bttfP2AmPmX",  EEPROM_BTTF_P2_AMPM_X_ADDR,  295, 0, 479),
+  SETTING_U16("bttfP2AmPmY",  EEPROM_BTTF_P2_AMPM_Y_ADDR,  217, 0, 479),
+  SETTING_U16("bttfP2HourX",  EEPROM_BTTF_P2_HOUR_X_ADDR,  320, 0, 479),
+  SETTING_U16("bttfP2HourY",  EEPROM_BTTF_P2_HOUR_Y_ADDR,  235, 0, 479),
+  SETTING_U16("bttfP2MinX",   EEPROM_BTTF_P2_MIN_X_ADDR,   400, 0, 479),
+  SETTING_U16("bttfP2MinY",   EEPROM_BTTF_P2_MIN_Y_ADDR,   235, 0, 479),
+  SETTING_U16("bttfP3MonthX", EEPROM_BTTF_P3_MONTH_X_ADDR, 30,  0, 479),
+  SETTING_U16("bttfP3MonthY", EEPROM_BTTF_P3_MONTH_Y_ADDR, 395, 0, 479),
+  SETTING_U16("bttfP3DayX",   EEPROM_BTTF_P3_DAY_X_ADDR,   122, 0, 479),
+  SETTING_U16("bttfP3DayY",   EEPROM_BTTF_P3_DAY_Y_ADDR,   395, 0, 479),
+  SETTING_U16("bttfP3YearX",  EEPROM_BTTF_P3_YEAR_X_ADDR,  198, 0, 479),
+  SETTING_U16("bttfP3YearY",  EEPROM_BTTF_P3_YEAR_Y_ADDR,  395, 0, 479),
+  SETTING_U16("bttfP3AmPmX",  EEPROM_BTTF_P3_AMPM_X_ADDR,  295, 0, 479),
+  SETTING_U16("bttfP3AmPmY",  EEPROM_BTTF_P3_AMPM_Y_ADDR,  377, 0, 479),
+  SETTING_U16("bttfP3HourX",  EEPROM_BTTF_P3_HOUR_X_ADDR,  320, 0, 479),
+  SETTING_U16("bttfP3HourY",  EEPROM_BTTF_P3_HOUR_Y_ADDR,  395, 0, 479),
+  SETTING_U16("bttfP3MinX",   EEPROM_BTTF_P3_MIN_X_ADDR,   400, 0, 479),
+  SETTING_U16("bttfP3MinY",   EEPROM_BTTF_P3_MIN_Y_ADDR,   395, 0, 479),
+#endif
+
+#ifdef EFFECT_LED_RING
+  // Ore arancione, minuti blu, secondi ciano, display digitale verde-ciano
+#define LR(k, a, d, mn, mx) SETTING_U8_REV(k, a, d, mn, mx, 2, EEPROM_LEDRING_VALID_ADDR, EEPROM_LEDRING_VALID_MARKER)
+  LR("ledRingHoursR",          EEPROM_LEDRING_HOURS_R_ADDR,    255, 0, 255),
+  LR("ledRingHoursG",          EEPROM_LEDRING_HOURS_G_ADDR,    100, 0, 255),
+  LR("ledRingHoursB",          EEPROM_LEDRING_HOURS_B_ADDR,    0,   0, 255),
+  LR("ledRingMinutesR",        EEPROM_LEDRING_MINUTES_R_ADDR,  0,   0, 255),
+  LR("ledRingMinutesG",        EEPROM_LEDRING_MINUTES_G_ADDR,  150, 0, 255),
+  LR("ledRingMinutesB",        EEPROM_LEDRING_MINUTES_B_ADDR,  255, 0, 255),
+  LR("ledRingSecondsR",        EEPROM_LEDRING_SECONDS_R_ADDR,  0,   0, 255),
+  LR("ledRingSecondsG",        EEPROM_LEDRING_SECONDS_G_ADDR,  255, 0, 255),
+  LR("ledRingSecondsB",        EEPROM_LEDRING_SECONDS_B_ADDR,  255, 0, 255),
+  LR("ledRingDigitalR",        EEPROM_LEDRING_DIGITAL_R_ADDR,  0,   0, 255),
+  LR("ledRingDigitalG",        EEPROM_LEDRING_DIGITAL_G_ADDR,  255, 0, 255),
+  LR("ledRingDigitalB",        EEPROM_LEDRING_DIGITAL_B_ADDR,  200, 0, 255),
+  LR("ledRingHoursRainbow",    EEPROM_LEDRING_HOURS_RAINBOW,   0,   0, 1),
+  LR("ledRingMinutesRainbow",  EEPROM_LEDRING_MINUTES_RAINBOW, 0,   0, 1),
+  LR("ledRingSecondsRainbow",  EEPROM_LEDRING_SECONDS_RAINBOW, 0,   0, 1),
+  LR("ledRingValid",           EEPROM_LEDRING_VALID_ADDR,      EEPROM_LEDRING_VALID_MARKER, EEPROM_LEDRING_VALID_MARKER, EEPROM_LEDRING_VALID_MARKER),
+#undef LR
+#endif
+
+#ifdef EFFECT_LED_RGB
+  // Anello acceso a 80, colore del tema, pulsazione con l'audio, effetto fisso (LED_FX_SOLID)
+#define LRGB(k, a, d, mn, mx) SETTING_U8_REV(k, a, d, mn, mx, 3, EEPROM_LED_RGB_MARKER, EEPROM_LED_RGB_VALID)
+  LRGB("ledRgbEnabled",        EEPROM_LED_RGB_ENABLED,    1,   0, 1),
+  LRGB("ledRgbBrightness",     EEPROM_LED_RGB_BRIGHTNESS, 80,  0, 255),
+  LRGB("ledRgbOverride",       EEPROM_LED_RGB_OVERRIDE,   0,   0, 1),
+  LRGB("ledRgbR",              EEPROM_LED_RGB_R,          255, 0, 255),
+  LRGB("ledRgbG",              EEPROM_LED_RGB_G,          255, 0, 255),
+  LRGB("ledRgbB",              EEPROM_LED_RGB_B,          255, 0, 255),
+  LRGB("ledRgbAudioReactive",  EEPROM_LED_RGB_AUDIOREACT, 1,   0, 2),
+  LRGB("ledRgbEffect",         EEPROM_LED_RGB_EFFECT,     0,   0, 3),
+  LRGB("ledRgbValid",          EEPROM_LED_RGB_MARKER,     EEPROM_LED_RGB_VALID, EEPROM_LED_RGB_VALID, EEPROM_LED_RGB_VALID),
+#undef LRGB
+#endif
+
+#ifdef EFFECT_DUAL_DISPLAY
+  // Pannello singolo standalone. Il marker 0xDD resta fuori tabella: lo scrive solo
+  // saveDualDisplaySettings() insieme ai MAC dei peer
+#define DD(k, a, d, mn, mx) SETTING_U8_REV(k, a, d, mn, mx, 2, EEPROM_DUAL_MARKER, EEPROM_DUAL_MARKER_VALUE)
+  DD("dualEnabled",            EEPROM_DUAL_ENABLED,  0, 0, 1),
+  DD("dualPanelX",             EEPROM_DUAL_PANEL_X,  0, 0, 1),
+  DD("dualPanelY",             EEPROM_DUAL_PANEL_Y,  0, 0, 1),
+  DD("dualGridW",              EEPROM_DUAL_GRID_W,   1, 1, 2),
+  DD("dualGridH",              EEPROM_DUAL_GRID_H,   1, 1, 2),
+  DD("dualRole",               EEPROM_DUAL_ROLE,     0, 0, 2),
+#undef DD
+  // Maschera dei modi in multi-display: tutti abilitati
+#define DM(k, a, d, mn, mx) SETTING_U8_REV(k, a, d, mn, mx, 2, EEPROM_DUAL_MODES_MARKER_ADDR, EEPROM_DUAL_MODES_MARKER_VALUE)
+  DM("dualModesMask0",         EEPROM_DUAL_MODES_MASK_ADDR + 0, 255, 0, 255),
+  DM("dualModesMask1",         EEPROM_DUAL_MODES_MASK_ADDR + 1, 255, 0, 255),
+  DM("dualModesMask2",         EEPROM_DUAL_MODES_MASK_ADDR + 2, 255, 0, 255),
+  DM("dualModesMask3",         EEPROM_DUAL_MODES_MASK_ADDR + 3, 255, 0, 255),
+  DM("dualModesMask4",         EEPROM_DUAL_MODES_MASK_ADDR + 4, 255, 0, 255),
+  DM("dualModesValid",         EEPROM_DUAL_MODES_MARKER_ADDR,   EEPROM_DUAL_MODES_MARKER_VALUE, EEPROM_DUAL_MODES_MARKER_VALUE, EEPROM_DUAL_MODES_MARKER_VALUE),
+#undef DM
+#endif
+};
+#define SETTINGS_SCHEMA_COUNT (sizeof(settingsSchema) / sizeof(settingsSchema[0]))
+
+// ===== Forward declarations =====
+bool settingsCommit();
+bool settingsFlush();
+
+// ===== Statistiche (esposte in /settings/store) =====
+struct SettingsStoreStats {
+  uint32_t commitRequests;   // Chiamate a settingsCommit()/settingsFlush()
+  uint32_t commits;          // EEPROM.commit() realmente eseguiti
+  uint32_t commitFailures;
+  uint32_t flashBytes;       // Byte riscritti in flash (EEPROM_SIZE per commit)
+  uint32_t lastCommitUs;     // Durata ultimo commit
+  uint32_t maxCommitUs;
+  uint32_t defaultsRestored; // Valori fuori range riportati al default
+};
+SettingsStoreStats settingsStats = {0};
+
+volatile bool settingsDirty = false;          // Modifiche non ancora salvate in flash
+volatile unsigned long settingsFirstDirtyMs = 0;
+volatile unsigned long settingsLastDirtyMs = 0;
+unsigned long settingsLastCommitMs = 0;
+
+// ===== Ricerca voce per indirizzo =====
+const SettingDef* settingsFind(uint16_t addr) {
+  for (size_t i = 0; i < SETTINGS_SCHEMA_COUNT; i++) {
+    if (settingsSchema[i].addr == addr) return &settingsSchema[i];
+  }
+  return nullptr;
+}
+
+// ===== Lettura/scrittura tipizzata (solo cache RAM, nessun commit) =====
+int32_t settingsRead(const SettingDef &d) {
+  switch (d.type) {
+    case SET_U16: return ((uint16_t)EEPROM.read(d.addr) << 8) | EEPROM.read(d.addr + 1);
+    case SET_STR: return 0;
+    default:      return EEPROM.read(d.addr);
+  }
+}
+
+void settingsWrite(const SettingDef &d, int32_t value) {
+  switch (d.type) {
+    case SET_U16:
+      EEPROM.write(d.addr, (value >> 8) & 0xFF);
+      EEPROM.write(d.addr + 1, value & 0xFF);
+      break;
+    case SET_STR:
+      break;
+    default:
+      EEPROM.write(d.addr, value & 0xFF);
+      break;
+  }
+}
+
+static void settingsWriteDefault(const SettingDef &d) {
+  if (d.type == SET_STR) {
+    size_t n = strlen(d.defStr);
+    for (int i = 0; i < d.len; i++) EEPROM.write(d.addr + i, i < (int)n ? d.defStr[i] : 0);
+  } else {
+    settingsWrite(d, d.def);
+  }
+}
+
+// ===== Lettura validata =====
+// Ritorna il valore salvato se nel range della tabella, altrimenti scrive il
+// default (commit differito) e ritorna quello. Indirizzo fuori tabella: lettura grezza.
+int32_t settingsLoad(uint16_t addr) {
+  const SettingDef *d = settingsFind(addr);
+  if (!d) return EEPROM.read(addr);
+  int32_t v = settingsRead(*d);
+  if (d->type != SET_STR && (v < d->minVal || v > d->maxVal)) {
+    Serial.printf("[SETTINGS] %s=%ld fuori range [%ld..%ld], ripristino default %ld\n",
+                  d->key, (long)v, (long)d->minVal, (long)d->maxVal, (long)d->def);
+    settingsWrite(*d, d->def);
+    settingsStats.defaultsRestored++;
+    settingsCommit();
+    v = d->def;
+  }
+  return v;
+}
+
+// ===== Default dalla tabella =====
+// Scrive il default di tutte le chiavi introdotte DOPO la revisione 'fromRev'
+// (0 = tutte). In migrazione (fromRev > 0) una chiave nuova tiene il valore gia'
+// salvato dal vecchio codice se il marker del suo gruppo c'e' e il valore e' nel range.
+// Non esegue il commit.
+void settingsApplyDefaults(uint8_t fromRev) {
+  int n = 0, kept = 0;
+  for (size_t i = 0; i < SETTINGS_SCHEMA_COUNT; i++) {
+    const SettingDef &d = settingsSchema[i];
+    if (d.version <= fromRev) continue;
+    if (fromRev > 0 && d.type != SET_STR) {
+      int32_t v = settingsRead(d);
+      bool guarded = !d.guardAddr || EEPROM.read(d.guardAddr) == d.guardVal;
+      if (guarded && v >= d.minVal && v <= d.maxVal) {
+        kept++;
+        continue;
+      }
+    }
+    settingsWriteDefault(d);
+    n++;
+  }
+  EEPROM.write(EEPROM_SCHEMA_REV_ADDR, SETTINGS_SCHEMA_REV);
+  Serial.printf("[SETTINGS] Default applicati: %d chiavi, %d mantenute (da rev %d a rev %d)\n",
+                n, kept, fromRev, SETTINGS_SCHEMA_REV);
+}
+
+// ===== Migrazione schema =====
+// Chiamata da setup_eeprom() quando il layout e' gia' valido: aggiunge solo i default
+// delle chiavi nuove. Layout precedenti al registro (cella mai scritta) = revisione 1.
+void settingsMigrate() {
+  uint8_t rev = EEPROM.read(EEPROM_SCHEMA_REV_ADDR);
+  if (rev == 0 || rev == 0xFF) rev = 1;
+  if (rev < SETTINGS_SCHEMA_REV) {
+    settingsApplyDefaults(rev);
+    settingsCommit();
+  } else if (EEPROM.read(EEPROM_SCHEMA_REV_ADDR) != rev) {
+    EEPROM.write(EEPROM_SCHEMA_REV_ADDR, rev);
+    settingsCommit();
+  }
+}
+
+// ===== Commit =====
+// Richiesta di salvataggio: il commit vero avviene in settingsStoreLoop()
+bool settingsCommit() {
+  unsigned long now = millis();
+  settingsStats.commitRequests++;
+  if (!settingsDirty) settingsFirstDirtyMs = now;
+  settingsLastDirtyMs = now;
+  settingsDirty = true;
+  return true;
+}
+
+static bool settingsDoCommit() {
+  unsigned long t0 = micros();
+  settingsDirty = false;
+  bool ok = EEPROM.commit();
+  uint32_t us = micros() - t0;
+  settingsStats.commits++;
+  settingsStats.flashBytes += EEPROM_SIZE;
+  settingsStats.lastCommitUs = us;
+  if (us > settingsStats.maxCommitUs) settingsStats.maxCommitUs = us;
+  if (!ok) {
+    settingsStats.commitFailures++;
+    Serial.println("[SETTINGS] ERRORE: EEPROM.commit() fallito");
+  }
+  settingsLastCommitMs = millis();
+  return ok;
+}
+
+// Commit immediato (ritorna l'esito di EEPROM.commit())
+bool settingsFlush() {
+  settingsStats.commitRequests++;
+  return settingsDoCommit();
+}
+
+// Chiamata da esp_restart(): salva le modifiche ancora pendenti
+static void settingsShutdownHandler() {
+  if (settingsDirty) {
+    settingsDirty = false;
+    EEPROM.commit();
+  }
+}
+
+void settingsStoreBegin() {
+  esp_register_shutdown_handler(settingsShutdownHandler);
+}
+
+// ===== Da chiamare nel loop: esegue il commit differito =====
+void settingsStoreLoop() {
+  if (!settingsDirty) return;
+  unsigned long now = millis();
+  bool quiet   = now - settingsLastDirtyMs >= SETTINGS_COMMIT_QUIET_MS;
+  bool overdue = now - settingsFirstDirtyMs >= SETTINGS_COMMIT_MAX_DELAY_MS;
+  if (!(quiet || overdue)) return;
+  if (now - settingsLastCommitMs < SETTINGS_COMMIT_MIN_GAP_MS) return;
+  settingsDoCommit();
+}
+
+// ===== Stato in JSON (statistiche + valori della tabella) =====
+String getSettingsStoreJson() {
+  String json = "{";
+  json += "\"schemaRev\":" + String(SETTINGS_SCHEMA_REV) + ",";
+  json += "\"keys\":" + String((int)SETTINGS_SCHEMA_COUNT) + ",";
+  json += "\"commitRequests\":" + String(settingsStats.commitRequests) + ",";
+  json += "\"commits\":" + String(settingsStats.commits) + ",";
+  json += "\"coalesced\":" + String(settingsStats.commitRequests - settingsStats.commits) + ",";
+  json += "\"commitFailures\":" + String(settingsStats.commitFailures) + ",";
+  json += "\"flashBytes\":" + String(settingsStats.flashBytes) + ",";
+  json += "\"lastCommitUs\":" + String(settingsStats.lastCommitUs) + ",";
+  json += "\"maxCommitUs\":" + String(settingsStats.maxCommitUs) + ",";
+  json += "\"defaultsRestored\":" + String(settingsStats.defaultsRestored) + ",";
+  json += "\"pending\":" + String(settingsDirty ? "true" : "false") + ",";
+  json += "\"values\":{";
+  for (size_t i = 0; i < SETTINGS_SCHEMA_COUNT; i++) {
+    const SettingDef &d = settingsSchema[i];
+    if (i > 0) json += ",";
+    json += "\"" + String(d.key) + "\":";
+    if (d.type == SET_STR) {
+      char buf[64];
+      int n = min((int)d.len, (int)sizeof(buf) - 1);
+      for (int k = 0; k < n; k++) {
+        char c = EEPROM.read(d.addr + k);
+        buf[k] = (c >= 32 && c < 127 && c != '"' && c != '\\') ? c : 0;
+        if (!c) break;
+      }
+      buf[n] = 0;
+      json += "\"" + String(buf) + "\"";
+    } else {
+      json += String(settingsRead(d));
+    }
+  }
+  json += "}}";
+  return json;
+}
@@ -1,6 +1,7 @@
 // ================== IMPLEMENTAZIONE FUNZIONI DI SETUP ==================
 void setup_eeprom() {
   EEPROM.begin(EEPROM_SIZE); // Inizializza la libreria EEPROM con la dimensione definita.
+  settingsStoreBegin();      // Commit differiti + salvataggio pendenti su ESP.restart()
 
   // Verifica se il layout EEPROM è aggiornato (nuova versione per evitare conflitti indirizzi)
   bool needsReset = (EEPROM.read(0) != EEPROM_CONFIGURED_MARKER) ||
@@ -12,124 +13,13 @@ void setup_eeprom() {
     EEPROM.write(EEPROM_VERSION_ADDR, EEPROM_VERSION_VALUE);  // Marca la nuova versione
     // Prima configurazione: esegue solo se il marker non è presente.
     EEPROM.write(0, EEPROM_CONFIGURED_MARKER);     // Scrive un marker per indicare che la EEPROM è stata configurata.
-    EEPROM.write(EEPROM_PRESET_ADDR, 0);          // Imposta il preset predefinito a 0.
-    EEPROM.write(EEPROM_MODE_ADDR, MODE_FAST);     // Imposta la modalità di visualizzazione predefinita a FAST.
-    EEPROM.write(EEPROM_WORD_E_STATE_ADDR, 1);    // Imposta lo stato predefinito della parola "E" a visibile e fissa.
-    // Imposta i colori predefiniti a bianco (R=255, G=255, B=255).
-    EEPROM.write(EEPROM_COLOR_R_ADDR, 255);
-    EEPROM.write(EEPROM_COLOR_G_ADDR, 255);
-    EEPROM.write(EEPROM_COLOR_B_ADDR, 255);
-    // Imposta la data dell'orologio analogico come visibile per default.
-    EEPROM.write(EEPROM_CLOCK_DATE_ADDR, 1);
-
-    // Imposta orari giorno/notte di default
-    EEPROM.write(EEPROM_DAY_START_HOUR_ADDR, 8);   // Giorno inizia alle 8:00
-    EEPROM.write(EEPROM_NIGHT_START_HOUR_ADDR, 22); // Notte inizia alle 22:00
-
-    // Imposta luminosità e annuncio orario di default
-    EEPROM.write(EEPROM_HOURLY_ANNOUNCE_ADDR, 1);          // Annuncio orario abilitato
-    EEPROM.write(EEPROM_TTS_ANNOUNCE_ADDR, 0);             // Default: usa MP3 locali (0=MP3, 1=TTS)
-    EEPROM.write(EEPROM_TTS_VOICE_FEMALE_ADDR, 1);         // Default: voce femminile (1=femminile, 0=maschile)
-    EEPROM.write(EEPROM_BRIGHTNESS_DAY_ADDR, BRIGHTNESS_DAY_DEFAULT);    // Luminosità giorno 250
-    EEPROM.write(EEPROM_BRIGHTNESS_NIGHT_ADDR, BRIGHTNESS_NIGHT_DEFAULT); // Luminosità notte 90
+    // Default di tutte le impostazioni dalla tabella schema (0_SETTINGS_STORE.ino):
+    // preset, modo, colori, orari giorno/notte, audio, orologio analogico, BTTF...
+    settingsApplyDefaults(0);
 
-#ifdef EFFECT_ANALOG_CLOCK
-    // Inizializza colori default lancette (RGB565)
-    EEPROM.write(EEPROM_CLOCK_HOUR_COLOR_ADDR, BLACK >> 8);
-    EEPROM.write(EEPROM_CLOCK_HOUR_COLOR_ADDR + 1, BLACK & 0xFF);
-    EEPROM.write(EEPROM_CLOCK_MINUTE_COLOR_ADDR, BLACK >> 8);
-    EEPROM.write(EEPROM_CLOCK_MINUTE_COLOR_ADDR + 1, BLACK & 0xFF);
-    EEPROM.write(EEPROM_CLOCK_SECOND_COLOR_ADDR, RED >> 8);
-    EEPROM.write(EEPROM_CLOCK_SECOND_COLOR_ADDR + 1, RED & 0xFF);
-
-    // Inizializza posizione Y data default
-    EEPROM.write(EEPROM_CLOCK_DATE_Y_ADDR, 320 >> 8);
-    EEPROM.write(EEPROM_CLOCK_DATE_Y_ADDR + 1, 320 & 0xFF);
-
-    // Inizializza nome skin default
-    const char* defaultSkin = "orologio.jpg";
-    for (int i = 0; i < 32; i++) {
-      EEPROM.write(EEPROM_CLOCK_SKIN_NAME_ADDR + i, i < strlen(defaultSkin) ? defaultSkin[i] : 0);
-    }
-#endif
-
-#ifdef EFFECT_BTTF
-    // Inizializza date BTTF con valori iconici del film
-    // DESTINATION TIME: Oct 26, 1985 - 1:20 AM
-    EEPROM.write(EEPROM_BTTF_DEST_MONTH_ADDR, 10);
-    EEPROM.write(EEPROM_BTTF_DEST_DAY_ADDR, 26);
-    EEPROM.write(EEPROM_BTTF_DEST_YEAR_ADDR, 1985 >> 8);
-    EEPROM.write(EEPROM_BTTF_DEST_YEAR_ADDR + 1, 1985 & 0xFF);
-    EEPROM.write(EEPROM_BTTF_DEST_HOUR_ADDR, 1);
-    EEPROM.write(EEPROM_BTTF_DEST_MINUTE_ADDR, 20);
-    EEPROM.write(EEPROM_BTTF_DEST_AMPM_ADDR, 0); // 0 = AM
-
-    // LAST TIME DEPARTED: Nov 5, 1955 - 6:00 AM
-    EEPROM.write(EEPROM_BTTF_LAST_MONTH_ADDR, 11);
-    EEPROM.write(EEPROM_BTTF_LAST_DAY_ADDR, 5);
-    EEPROM.write(EEPROM_BTTF_LAST_YEAR_ADDR, 1955 >> 8);
-    EEPROM.write(EEPROM_BTTF_LAST_YEAR_ADDR + 1, 1955 & 0xFF);
-    EEPROM.write(EEPROM_BTTF_LAST_HOUR_ADDR, 6);
-    EEPROM.write(EEPROM_BTTF_LAST_MINUTE_ADDR, 0);
-    EEPROM.write(EEPROM_BTTF_LAST_AMPM_ADDR, 0); // 0 = AM
-
-    // Inizializza font sizes BTTF
-    EEPROM.write(EEPROM_BTTF_MONTH_FONT_SIZE_ADDR, 2);   // 2 = medium (default)
-    EEPROM.write(EEPROM_BTTF_NUMBER_FONT_SIZE_ADDR, 2);  // 2 = medium (default)
-
-    // Helper per scrivere int16
-    auto writeInt16 = [](uint16_t addr, int16_t value) {
-      EEPROM.write(addr, value >> 8);
-      EEPROM.write(addr + 1, value & 0xFF);
-    };
-
-    // Inizializza coordinate INDIVIDUALI per ogni campo di ogni pannello
-    // Valori ottimizzati per bttf.jpg (480x480px)
-
-    // PANEL 1 (DESTINATION TIME) - Y base: 75
-    writeInt16(EEPROM_BTTF_P1_MONTH_X_ADDR, 30);
-    writeInt16(EEPROM_BTTF_P1_MONTH_Y_ADDR, 75);
-    writeInt16(EEPROM_BTTF_P1_DAY_X_ADDR, 122);
-    writeInt16(EEPROM_BTTF_P1_DAY_Y_ADDR, 75);
-    writeInt16(EEPROM_BTTF_P1_YEAR_X_ADDR, 198);
-    writeInt16(EEPROM_BTTF_P1_YEAR_Y_ADDR, 75);
-    writeInt16(EEPROM_BTTF_P1_AMPM_X_ADDR, 295);
-    writeInt16(EEPROM_BTTF_P1_AMPM_Y_ADDR, 57);  // LED leggermente più alto
-    writeInt16(EEPROM_BTTF_P1_HOUR_X_ADDR, 320);
-    writeInt16(EEPROM_BTTF_P1_HOUR_Y_ADDR, 75);
-    writeInt16(EEPROM_BTTF_P1_MIN_X_ADDR, 400);
-    writeInt16(EEPROM_BTTF_P1_MIN_Y_ADDR, 75);
-
-    // PANEL 2 (PRESENT TIME) - Y base: 235
-    writeInt16(EEPROM_BTTF_P2_MONTH_X_ADDR, 30);
-    writeInt16(EEPROM_BTTF_P2_MONTH_Y_ADDR, 235);
-    writeInt16(EEPROM_BTTF_P2_DAY_X_ADDR, 122);
-    writeInt16(EEPROM_BTTF_P2_DAY_Y_ADDR, 235);
-    writeInt16(EEPROM_BTTF_P2_YEAR_X_ADDR, 198);
-    writeInt16(EEPROM_BTTF_P2_YEAR_Y_ADDR, 235);
-    writeInt16(EEPROM_BTTF_P2_AMPM_X_ADDR, 295);
-    writeInt16(EEPROM_BTTF_P2_AMPM_Y_ADDR, 217);  // LED leggermente più alto
-    writeInt16(EEPROM_BTTF_P2_HOUR_X_ADDR, 320);
-    writeInt16(EEPROM_BTTF_P2_HOUR_Y_ADDR, 235);
-    writeInt16(EEPROM_BTTF_P2_MIN_X_ADDR, 400);
-    writeInt16(EEPROM_BTTF_P2_MIN_Y_ADDR, 235);
-
-    // PANEL 3 (LAST TIME DEPARTED) - Y base: 395
-    writeInt16(EEPROM_BTTF_P3_MONTH_X_ADDR, 30);
-    writeInt16(EEPROM_BTTF_P3_MONTH_Y_ADDR, 395);
-    writeInt16(EEPROM_BTTF_P3_DAY_X_ADDR, 122);
-    writeInt16(EEPROM_BTTF_P3_DAY_Y_ADDR, 395);
-    writeInt16(EEPROM_BTTF_P3_YEAR_X_ADDR, 198);
-    writeInt16(EEPROM_BTTF_P3_YEAR_Y_ADDR, 395);
-    writeInt16(EEPROM_BTTF_P3_AMPM_X_ADDR, 295);
-    writeInt16(EEPROM_BTTF_P3_AMPM_Y_ADDR, 377);  // LED leggermente più alto
-    writeInt16(EEPROM_BTTF_P3_HOUR_X_ADDR, 320);
-    writeInt16(EEPROM_BTTF_P3_HOUR_Y_ADDR, 395);
-    writeInt16(EEPROM_BTTF_P3_MIN_X_ADDR, 400);
-    writeInt16(EEPROM_BTTF_P3_MIN_Y_ADDR, 395);
-#endif
-
-    EEPROM.commit(); // Scrive i dati dalla cache della EEPROM alla memoria fisica.
+    settingsFlush(); // Primo avvio: salva subito in flash
+  } else {
+    settingsMigrate(); // Layout valido: solo i default delle chiavi nuove
   }
 
   // Carica il preset salvato dalla EEPROM.
@@ -139,9 +29,8 @@ void setup_eeprom() {
   userMode = (DisplayMode)EEPROM.read(EEPROM_MODE_ADDR);
 
 
-  // Carica lo stato della parola "E" dalla EEPROM.
-  word_E_state = EEPROM.read(EEPROM_WORD_E_STATE_ADDR);
-  if (word_E_state > 1) word_E_state = 1;  // Imposta un valore di sicurezza a 1 se il valore letto è fuori range (0 o 1).
+  // Carica lo stato della parola "E" dalla EEPROM (fuori range -> default della tabella schema).
+  word_E_state = settingsLoad(EEPROM_WORD_E_STATE_ADDR);
 
   // Carica i valori dei colori salvati dalla EEPROM (vecchio metodo per compatibilità)
   userColor.r = EEPROM.read(EEPROM_COLOR_R_ADDR);
@@ -149,154 +38,44 @@ void setup_eeprom() {
   userColor.b = EEPROM.read(EEPROM_COLOR_B_ADDR);
   currentColor = userColor;  // Applica il colore caricato
 
-  // Carica orari giorno/notte dalla EEPROM
-  uint8_t loadedDayStart = EEPROM.read(EEPROM_DAY_START_HOUR_ADDR);
-  uint8_t loadedNightStart = EEPROM.read(EEPROM_NIGHT_START_HOUR_ADDR);
-  uint8_t loadedDayStartMin = EEPROM.read(EEPROM_DAY_START_MIN_ADDR);
-  uint8_t loadedNightStartMin = EEPROM.read(EEPROM_NIGHT_START_MIN_ADDR);
-  // Valida i valori (ore devono essere 0-23, minuti 0-59)
-  if (loadedDayStart < 24) {
-    dayStartHour = loadedDayStart;
-  } else {
-    dayStartHour = 8; // Default
-    EEPROM.write(EEPROM_DAY_START_HOUR_ADDR, 8);
-    EEPROM.commit();
-  }
-  if (loadedDayStartMin < 60) {
-    dayStartMinute = loadedDayStartMin;
-  } else {
-    dayStartMinute = 0; // Default
-    EEPROM.write(EEPROM_DAY_START_MIN_ADDR, 0);
-    EEPROM.commit();
-  }
-  if (loadedNightStart < 24) {
-    nightStartHour = loadedNightStart;
-  } else {
-    nightStartHour = 22; // Default
-    EEPROM.write(EEPROM_NIGHT_START_HOUR_ADDR, 22);
-    EEPROM.commit();
-  }
-  if (loadedNightStartMin < 60) {
-    nightStartMinute = loadedNightStartMin;
-  } else {
-    nightStartMinute = 0; // Default
-    EEPROM.write(EEPROM_NIGHT_START_MIN_ADDR, 0);
-    EEPROM.commit();
-  }
+  // Carica orari giorno/notte dalla EEPROM (ore 0-23, minuti 0-59)
+  dayStartHour     = settingsLoad(EEPROM_DAY_START_HOUR_ADDR);
+  dayStartMinute   = settingsLoad(EEPROM_DAY_START_MIN_ADDR);
+  nightStartHour   = settingsLoad(EEPROM_NIGHT_START_HOUR_ADDR);
+  nightStartMinute = settingsLoad(EEPROM_NIGHT_START_MIN_ADDR);
   Serial.printf("[SETUP] Orari giorno/notte: Giorno dalle %02d:%02d, Notte dalle %02d:%02d\n", dayStartHour, dayStartMinute, nightStartHour, nightStartMinute);
 
   // Carica luminosità giorno/notte e annuncio orario dalla EEPROM
-  uint8_t loadedBrightnessDay = EEPROM.read(EEPROM_BRIGHTNESS_DAY_ADDR);
-  uint8_t loadedBrightnessNight = EEPROM.read(EEPROM_BRIGHTNESS_NIGHT_ADDR);
-  uint8_t loadedHourlyAnnounce = EEPROM.read(EEPROM_HOURLY_ANNOUNCE_ADDR);
-
-  // Valida luminosità (valori 0xFF indicano EEPROM non inizializzata)
-  // IMPORTANTE: Valore minimo 10 per evitare schermo spento al boot
-  if (loadedBrightnessDay != 0xFF && loadedBrightnessDay >= 10) {
-    brightnessDay = loadedBrightnessDay;
-  } else {
-    brightnessDay = BRIGHTNESS_DAY_DEFAULT;
-    EEPROM.write(EEPROM_BRIGHTNESS_DAY_ADDR, brightnessDay);
-  }
-  if (loadedBrightnessNight != 0xFF && loadedBrightnessNight >= 10) {
-    brightnessNight = loadedBrightnessNight;
-  } else {
-    brightnessNight = BRIGHTNESS_NIGHT_DEFAULT;
-    EEPROM.write(EEPROM_BRIGHTNESS_NIGHT_ADDR, brightnessNight);
-  }
-  if (loadedHourlyAnnounce != 0xFF) {
-    hourlyAnnounceEnabled = (loadedHourlyAnnounce == 1);
-  } else {
-    hourlyAnnounceEnabled = true;
-    EEPROM.write(EEPROM_HOURLY_ANNOUNCE_ADDR, 1);
-  }
-
-  // Carica impostazione TTS/MP3 dalla EEPROM
-  uint8_t loadedTTSAnnounce = EEPROM.read(EEPROM_TTS_ANNOUNCE_ADDR);
-  if (loadedTTSAnnounce != 0xFF) {
-    useTTSAnnounce = (loadedTTSAnnounce == 1);
-  } else {
-    useTTSAnnounce = false;  // Default: usa MP3 locali
-    EEPROM.write(EEPROM_TTS_ANNOUNCE_ADDR, 0);
-  }
-
-  // Carica impostazione voce TTS dalla EEPROM
-  uint8_t loadedTTSVoice = EEPROM.read(EEPROM_TTS_VOICE_FEMALE_ADDR);
-  if (loadedTTSVoice != 0xFF) {
-    ttsVoiceFemale = (loadedTTSVoice == 1);
-  } else {
-    ttsVoiceFemale = true;  // Default: voce femminile
-    EEPROM.write(EEPROM_TTS_VOICE_FEMALE_ADDR, 1);
-  }
+  // IMPORTANTE: Valore minimo 10 (range in tabella) per evitare schermo spento al boot
+  brightnessDay         = settingsLoad(EEPROM_BRIGHTNESS_DAY_ADDR);
+  brightnessNight       = settingsLoad(EEPROM_BRIGHTNESS_NIGHT_ADDR);
+  hourlyAnnounceEnabled = settingsLoad(EEPROM_HOURLY_ANNOUNCE_ADDR) == 1;
+
+  // Carica impostazione TTS/MP3 e voce TTS dalla EEPROM
+  useTTSAnnounce = settingsLoad(EEPROM_TTS_ANNOUNCE_ADDR) == 1;
+  ttsVoiceFemale = settingsLoad(EEPROM_TTS_VOICE_FEMALE_ADDR) == 1;
   Serial.printf("[EEPROM] Modalità annuncio: %s, Voce: %s\n",
                 useTTSAnnounce ? "Google TTS" : "MP3 locali",
                 ttsVoiceFemale ? "Femminile" : "Maschile");
 
   // Carica volume audio dalla EEPROM
-  uint8_t loadedAudioVolume = EEPROM.read(EEPROM_AUDIO_VOLUME_ADDR);
-  if (loadedAudioVolume != 0xFF && loadedAudioVolume <= 100) {
-    audioVolume = loadedAudioVolume;
-  } else {
-    audioVolume = 80;  // Default 80%
-    EEPROM.write(EEPROM_AUDIO_VOLUME_ADDR, audioVolume);
-  }
+  audioVolume = settingsLoad(EEPROM_AUDIO_VOLUME_ADDR);
 
   // Carica impostazioni audio giorno/notte dalla EEPROM
-  uint8_t loadedAudioDayEnabled = EEPROM.read(EEPROM_AUDIO_DAY_ENABLED_ADDR);
-  uint8_t loadedAudioNightEnabled = EEPROM.read(EEPROM_AUDIO_NIGHT_ENABLED_ADDR);
-  uint8_t loadedVolumeDay = EEPROM.read(EEPROM_VOLUME_DAY_ADDR);
-  uint8_t loadedVolumeNight = EEPROM.read(EEPROM_VOLUME_NIGHT_ADDR);
-
-  if (loadedAudioDayEnabled != 0xFF) {
-    audioDayEnabled = (loadedAudioDayEnabled == 1);
-  } else {
-    audioDayEnabled = true;  // Default ON
-    EEPROM.write(EEPROM_AUDIO_DAY_ENABLED_ADDR, 1);
-  }
-
-  if (loadedAudioNightEnabled != 0xFF) {
-    audioNightEnabled = (loadedAudioNightEnabled == 1);
-  } else {
-    audioNightEnabled = false;  // Default OFF
-    EEPROM.write(EEPROM_AUDIO_NIGHT_ENABLED_ADDR, 0);
-  }
-
-  if (loadedVolumeDay != 0xFF && loadedVolumeDay <= 100) {
-    volumeDay = loadedVolumeDay;
-  } else {
-    volumeDay = 80;  // Default 80%
-    EEPROM.write(EEPROM_VOLUME_DAY_ADDR, volumeDay);
-  }
-
-  if (loadedVolumeNight != 0xFF && loadedVolumeNight <= 100) {
-    volumeNight = loadedVolumeNight;
-  } else {
-    volumeNight = 30;  // Default 30%
-    EEPROM.write(EEPROM_VOLUME_NIGHT_ADDR, volumeNight);
-  }
+  audioDayEnabled   = settingsLoad(EEPROM_AUDIO_DAY_ENABLED_ADDR) == 1;
+  audioNightEnabled = settingsLoad(EEPROM_AUDIO_NIGHT_ENABLED_ADDR) == 1;
+  volumeDay         = settingsLoad(EEPROM_VOLUME_DAY_ADDR);
+  volumeNight       = settingsLoad(EEPROM_VOLUME_NIGHT_ADDR);
 
   Serial.printf("[SETUP] Audio Giorno: %s (vol %d%%), Notte: %s (vol %d%%)\n",
                 audioDayEnabled ? "ON" : "OFF", volumeDay,
                 audioNightEnabled ? "ON" : "OFF", volumeNight);
 
   // Carica impostazioni cambio modalità random dalla EEPROM
-  uint8_t loadedRandomMode = EEPROM.read(EEPROM_RANDOM_MODE_ADDR);
-  uint8_t loadedRandomInterval = EEPROM.read(EEPROM_RANDOM_INTERVAL_ADDR);
-  if (loadedRandomMode != 0xFF) {
-    randomModeEnabled = (loadedRandomMode == 1);
-  } else {
-    randomModeEnabled = false;
-    EEPROM.write(EEPROM_RANDOM_MODE_ADDR, 0);
-  }
-  if (loadedRandomInterval != 0xFF && loadedRandomInterval >= 1 && loadedRandomInterval <= 60) {
-    randomModeInterval = loadedRandomInterval;
-  } else {
-    randomModeInterval = 5;  // Default 5 minuti
-    EEPROM.write(EEPROM_RANDOM_INTERVAL_ADDR, 5);
-  }
+  randomModeEnabled  = settingsLoad(EEPROM_RANDOM_MODE_ADDR) == 1;
+  randomModeInterval = settingsLoad(EEPROM_RANDOM_INTERVAL_ADDR);
   Serial.printf("[SETUP] Random mode: %s, intervallo: %d minuti\n", randomModeEnabled ? "ON" : "OFF", randomModeInterval);
 
-  EEPROM.commit();
   Serial.printf("[SETUP] Luminosità: Giorno=%d, Notte=%d | Annuncio orario: %s\n",
                 brightnessDay, brightnessNight, hourlyAnnounceEnabled ? "ON" : "OFF");
   Serial.printf("[SETUP] Volume audio: %d%%\n", audioVolume);
@@ -306,28 +85,10 @@ void setup_eeprom() {
   uint8_t dateState = EEPROM.read(EEPROM_CLOCK_DATE_ADDR);
   showClockDate = (dateState == 1); // 1 = visibile, 0 = nascosta
 
-  // Carica lo stato smooth seconds dalla EEPROM
-  uint8_t smoothState = EEPROM.read(EEPROM_CLOCK_SMOOTH_SECONDS_ADDR);
-  if (smoothState == 0xFF) {
-    // EEPROM non inizializzata, usa default (false)
-    clockSmoothSeconds = false;
-    EEPROM.write(EEPROM_CLOCK_SMOOTH_SECONDS_ADDR, 0);
-    EEPROM.commit();
-  } else {
-    clockSmoothSeconds = (smoothState == 1);
-  }
+  // Carica smooth seconds e rainbow hands (fuori range -> default della tabella schema: off)
+  clockSmoothSeconds = settingsLoad(EEPROM_CLOCK_SMOOTH_SECONDS_ADDR) == 1;
   Serial.printf("[SETUP] Smooth seconds: %s\n", clockSmoothSeconds ? "ABILITATO" : "DISABILITATO");
-
-  // Carica lo stato rainbow hands dalla EEPROM
-  uint8_t rainbowState = EEPROM.read(EEPROM_CLOCK_RAINBOW_ADDR);
-  if (rainbowState == 0xFF) {
-    // EEPROM non inizializzata, usa default (false)
-    clockHandsRainbow = false;
-    EEPROM.write(EEPROM_CLOCK_RAINBOW_ADDR, 0);
-    EEPROM.commit();
-  } else {
-    clockHandsRainbow = (rainbowState == 1);
-  }
+  clockHandsRainbow = settingsLoad(EEPROM_CLOCK_RAINBOW_ADDR) == 1;
   Serial.printf("[SETUP] Rainbow hands: %s\n", clockHandsRainbow ? "ABILITATO" : "DISABILITATO");
 
   // Carica nome skin attiva (32 bytes)
@@ -364,54 +125,27 @@ void setup_eeprom() {
 #endif
 
 #ifdef EFFECT_LED_RING
-  // Carica impostazioni LED Ring dalla EEPROM
-  uint8_t ledRingValid = EEPROM.read(EEPROM_LEDRING_VALID_ADDR);
-  if (ledRingValid == EEPROM_LEDRING_VALID_MARKER) {
-    // Carica colori ore
-    ledRingHoursR = EEPROM.read(EEPROM_LEDRING_HOURS_R_ADDR);
-    ledRingHoursG = EEPROM.read(EEPROM_LEDRING_HOURS_G_ADDR);
-    ledRingHoursB = EEPROM.read(EEPROM_LEDRING_HOURS_B_ADDR);
-    // Carica colori minuti
-    ledRingMinutesR = EEPROM.read(EEPROM_LEDRING_MINUTES_R_ADDR);
-    ledRingMinutesG = EEPROM.read(EEPROM_LEDRING_MINUTES_G_ADDR);
-    ledRingMinutesB = EEPROM.read(EEPROM_LEDRING_MINUTES_B_ADDR);
-    // Carica colori secondi
-    ledRingSecondsR = EEPROM.read(EEPROM_LEDRING_SECONDS_R_ADDR);
-    ledRingSecondsG = EEPROM.read(EEPROM_LEDRING_SECONDS_G_ADDR);
-    ledRingSecondsB = EEPROM.read(EEPROM_LEDRING_SECONDS_B_ADDR);
-    // Carica colori display digitale
-    ledRingDigitalR = EEPROM.read(EEPROM_LEDRING_DIGITAL_R_ADDR);
-    ledRingDigitalG = EEPROM.read(EEPROM_LEDRING_DIGITAL_G_ADDR);
-    ledRingDigitalB = EEPROM.read(EEPROM_LEDRING_DIGITAL_B_ADDR);
-    // Carica flag rainbow
-    ledRingHoursRainbow = (EEPROM.read(EEPROM_LEDRING_HOURS_RAINBOW) == 1);
-    ledRingMinutesRainbow = (EEPROM.read(EEPROM_LEDRING_MINUTES_RAINBOW) == 1);
-    ledRingSecondsRainbow = (EEPROM.read(EEPROM_LEDRING_SECONDS_RAINBOW) == 1);
-    Serial.printf("[SETUP] LED Ring config caricata: Ore RGB(%d,%d,%d) Rainbow=%d, Min RGB(%d,%d,%d) Rainbow=%d, Sec RGB(%d,%d,%d) Rainbow=%d\n",
-                  ledRingHoursR, ledRingHoursG, ledRingHoursB, ledRingHoursRainbow,
-                  ledRingMinutesR, ledRingMinutesG, ledRingMinutesB, ledRingMinutesRainbow,
-                  ledRingSecondsR, ledRingSecondsG, ledRingSecondsB, ledRingSecondsRainbow);
-  } else {
-    // Prima inizializzazione - salva valori default
-    Serial.println("[SETUP] LED Ring prima inizializzazione - salvo valori default");
-    EEPROM.write(EEPROM_LEDRING_HOURS_R_ADDR, ledRingHoursR);
-    EEPROM.write(EEPROM_LEDRING_HOURS_G_ADDR, ledRingHoursG);
-    EEPROM.write(EEPROM_LEDRING_HOURS_B_ADDR, ledRingHoursB);
-    EEPROM.write(EEPROM_LEDRING_MINUTES_R_ADDR, ledRingMinutesR);
-    EEPROM.write(EEPROM_LEDRING_MINUTES_G_ADDR, ledRingMinutesG);
-    EEPROM.write(EEPROM_LEDRING_MINUTES_B_ADDR, ledRingMinutesB);
-    EEPROM.write(EEPROM_LEDRING_SECONDS_R_ADDR, ledRingSecondsR);
-    EEPROM.write(EEPROM_LEDRING_SECONDS_G_ADDR, ledRingSecondsG);
-    EEPROM.write(EEPROM_LEDRING_SECONDS_B_ADDR, ledRingSecondsB);
-    EEPROM.write(EEPROM_LEDRING_DIGITAL_R_ADDR, ledRingDigitalR);
-    EEPROM.write(EEPROM_LEDRING_DIGITAL_G_ADDR, ledRingDigitalG);
-    EEPROM.write(EEPROM_LEDRING_DIGITAL_B_ADDR, ledRingDigitalB);
-    EEPROM.write(EEPROM_LEDRING_HOURS_RAINBOW, 0);
-    EEPROM.write(EEPROM_LEDRING_MINUTES_RAINBOW, 0);
-    EEPROM.write(EEPROM_LEDRING_SECONDS_RAINBOW, 0);
-    EEPROM.write(EEPROM_LEDRING_VALID_ADDR, EEPROM_LEDRING_VALID_MARKER);
-    EEPROM.commit();
-  }
+  // Carica impostazioni LED Ring dalla EEPROM: i default (primo avvio o marker assente)
+  // sono gia' scritti da settingsApplyDefaults()/settingsMigrate() dalla tabella schema
+  ledRingHoursR   = settingsLoad(EEPROM_LEDRING_HOURS_R_ADDR);
+  ledRingHoursG   = settingsLoad(EEPROM_LEDRING_HOURS_G_ADDR);
+  ledRingHoursB   = settingsLoad(EEPROM_LEDRING_HOURS_B_ADDR);
+  ledRingMinutesR = settingsLoad(EEPROM_LEDRING_MINUTES_R_ADDR);
+  ledRingMinutesG = settingsLoad(EEPROM_LEDRING_MINUTES_G_ADDR);
+  ledRingMinutesB = settingsLoad(EEPROM_LEDRING_MINUTES_B_ADDR);
+  ledRingSecondsR = settingsLoad(EEPROM_LEDRING_SECONDS_R_ADDR);
+  ledRingSecondsG = settingsLoad(EEPROM_LEDRING_SECONDS_G_ADDR);
+  ledRingSecondsB = settingsLoad(EEPROM_LEDRING_SECONDS_B_ADDR);
+  ledRingDigitalR = settingsLoad(EEPROM_LEDRING_DIGITAL_R_ADDR);
+  ledRingDigitalG = settingsLoad(EEPROM_LEDRING_DIGITAL_G_ADDR);
+  ledRingDigitalB = settingsLoad(EEPROM_LEDRING_DIGITAL_B_ADDR);
+  ledRingHoursRainbow   = settingsLoad(EEPROM_LEDRING_HOURS_RAINBOW) == 1;
+  ledRingMinutesRainbow = settingsLoad(EEPROM_LEDRING_MINUTES_RAINBOW) == 1;
+  ledRingSecondsRainbow = settingsLoad(EEPROM_LEDRING_SECONDS_RAINBOW) == 1;
+  Serial.printf("[SETUP] LED Ring config caricata: Ore RGB(%d,%d,%d) Rainbow=%d, Min RGB(%d,%d,%d) Rainbow=%d, Sec RGB(%d,%d,%d) Rainbow=%d\n",
+                ledRingHoursR, ledRingHoursG, ledRingHoursB, ledRingHoursRainbow,
+                ledRingMinutesR, ledRingMinutesG, ledRingMinutesB, ledRingMinutesRainbow,
+                ledRingSecondsR, ledRingSecondsG, ledRingSecondsB, ledRingSecondsRainbow);
 #endif
 
   loadSavedSettings(); // Chiama una funzione per caricare altre impostazioni salvate (se presenti).
@@ -423,6 +157,7 @@ void setup_display() {
   // Configurazione del pin di backlight con controllo PWM (Pulse Width Modulation).
   ledcSetup(PWM_CHANNEL, PWM_FREQ, PWM_RESOLUTION); // Imposta il canale PWM, la frequenza e la risoluzione.
   ledcAttachPin(GFX_BL, PWM_CHANNEL);              // Associa il pin della backlight al canale PWM.
+  backlightBegin();                                // Controller luminosita' + fade hardware (0_BACKLIGHT.ino).
 
   gfx->begin(6600000);
   //gfx->begin(1000000);
@@ -433,6 +168,14 @@ void setup_display() {
   // Deve essere chiamata PRIMA di mostrare qualsiasi contenuto
   tftCalInit();  // Inizializza calibrazione gamma display
 
+  // Con un'ora gia' disponibile (RTC o ultima ora salvata) lo splash viene saltato:
+  // la backlight si accende direttamente sul primo frame dell'orologio (bootRenderEarlyClock)
+  if (bootSkipSplash()) {
+    gfx->setFont(u8g2_font_crox5hb_tr);
+    Serial.println("[BOOT] Splash saltato, orologio anticipato");
+    return;
+  }
+
   // Mostra il LOGO all'avvio.
   uint16_t* buffer = (uint16_t*)malloc(480 * 480 * 2);  // Alloca memoria RAM temporanea per l'immagine (2 byte per pixel).
   memcpy_P(buffer, sh_logo_480x480, 480 * 480 * 2);     // Copia i dati del logo dalla memoria flash (PROGMEM) alla RAM.
@@ -464,7 +207,7 @@ void setup_display() {
   // Esegue un'animazione di introduzione finché updateIntro() restituisce vero.
   while (!updateIntro()) {
     if(duty <= 250){
-      ledcWrite(PWM_CHANNEL, duty); // Imposta il duty cycle della PWM per la backlight (aumento graduale).
+      backlightSet(duty, 0);        // Imposta il duty cycle della PWM per la backlight (aumento graduale).
       duty=duty+10;
     }
     delay(20);
@@ -475,7 +218,7 @@ void setup_display() {
   delay(100);
 
 
-  ledcWrite(PWM_CHANNEL, 250); // Imposta la backlight a un livello fisso (250).
+  backlightSet(250, 0);        // Imposta la backlight a un livello fisso (250).
   gfx->setFont(u8g2_font_crox5hb_tr); // Imposta un font diverso.
   delay(100);
 }
@@ -485,106 +228,132 @@ void backLightPwmFadeIn() {
   // Il livello massimo viene compensato dal valore di calibrazione display
   int maxDuty = 250 - abs(_tftAdj(0));  // _tftAdj(0)=0 when gamma LUT OK
   if (maxDuty < 30) maxDuty = 30;      // Minimum visible brightness
-  for (int duty = 0; duty <= maxDuty; duty++) {
-    ledcWrite(PWM_CHANNEL, duty); // Imposta il duty cycle della PWM.
-    delay(10);
-  }
+  backlightFadeWait(maxDuty, maxDuty * 10);  // Fade hardware LEDC, stessa durata (10ms per livello)
 }
 
 void backLightPwmFadeOut() {
   // Diminuisce gradualmente la luminosità della backlight usando la PWM.
-  for (int duty = 250 ; duty >= 0; duty--) {
-    ledcWrite(PWM_CHANNEL, duty); // Imposta il duty cycle della PWM.
-    delay(10);
-  }
+  backlightFadeWait(0, 2500);      // Fade hardware LEDC, stessa durata (10ms per livello)
 }
 
 void setup_touch() {
   Wire.begin(I2C_SDA_PIN, I2C_SCL_PIN); // Inizializza la comunicazione I2C.
   ts.begin();                         // Inizializza il controller del touch screen.
   ts.setRotation(TOUCH_ROTATION);     // Imposta la rotazione del touch screen in base alla configurazione.
+  i2cBusBegin();                      // Da qui il bus Wire e' del task arbitro (0_I2C_BUS.ino).
+  touchInputBegin();                  // Task di lettura GT911 + gesture (1_TOUCH_INPUT.ino).
 }
 
 
-void setup_wifi() {
+// Legge le credenziali WiFi dalla EEPROM. Ritorna true se c'e' un SSID valido.
+bool wifiLoadCredentials(char *ssid, char *pass) {
+  ssid[0] = 0;
+  pass[0] = 0;
+  // Legge un marker dalla EEPROM per verificare se le credenziali WiFi sono valide.
+  if (EEPROM.read(EEPROM_WIFI_VALID_ADDR) != EEPROM_WIFI_VALID_VALUE) return false;
+
+  for (int i = 0; i < 32; i++) {
+    ssid[i] = EEPROM.read(EEPROM_WIFI_SSID_ADDR + i);
+  }
+  ssid[32] = 0; // Assicura che la stringa SSID sia terminata correttamente.
+
+  for (int i = 0; i < 64; i++) {
+    pass[i] = EEPROM.read(EEPROM_WIFI_PASS_ADDR + i);
+  }
+  pass[64] = 0; // Assicura che la stringa della password sia terminata correttamente.
+
+  return strlen(ssid) > 0;
+}
+
+// Avvia la connessione con le credenziali salvate SENZA attenderla: l'associazione
+// procede mentre display, SD e sensori si inizializzano. setup_wifi() poi si limita
+// ad attendere il risultato (stesso timeout complessivo di prima).
+bool wifiEarlyStarted = false;
+uint32_t wifiEarlyStartMs = 0;
+
+void wifiBeginEarly() {
+  char ssid[33];
+  char pass[65];
+  if (!wifiLoadCredentials(ssid, pass)) return;
 
-  // Imposta la modalità WiFi su STATION (necessario per Espalexa)
   WiFi.mode(WIFI_STA);
   WiFi.setSleep(false); // Disabilita risparmio energetico WiFi per Espalexa
-  WiFi.disconnect();
-  delay(100);
+  WiFi.begin(ssid, pass);
+  wifiEarlyStarted = true;
+  wifiEarlyStartMs = millis();
+  Serial.printf("[WIFI] Connessione a \"%s\" avviata in background\n", ssid);
+}
 
-  displayWifiInit(); // Inizializza la visualizzazione per mostrare informazioni sul WiFi.
+static bool wifiIsConnected() { return WiFi.status() == WL_CONNECTED; }
+static bool wifiIsDisconnected() { return WiFi.status() != WL_CONNECTED; }
 
-  gfx->setTextColor(WHITE);
-  displayWordWifi(16, "CONFIGURAZIONE"); // Mostra "CONFIGURAZIONE".
-  displayWordWifi(32, "WIFI:");         // Mostra "WIFI:".
-  delay(250);
+void setup_wifi() {
+  // Con orologio anticipato sul display le schermate informative restano sulla seriale
+  bool quiet = bootQuiet();
+
+  if (!wifiEarlyStarted) {
+    // Imposta la modalità WiFi su STATION (necessario per Espalexa)
+    WiFi.mode(WIFI_STA);
+    WiFi.setSleep(false); // Disabilita risparmio energetico WiFi per Espalexa
+    WiFi.disconnect();
+    bootWaitUntil(wifiIsDisconnected, 500, 10);
+  }
+
+  if (!quiet) {
+    displayWifiInit(); // Inizializza la visualizzazione per mostrare informazioni sul WiFi.
+
+    gfx->setTextColor(WHITE);
+    displayWordWifi(16, "CONFIGURAZIONE"); // Mostra "CONFIGURAZIONE".
+    displayWordWifi(32, "WIFI:");         // Mostra "WIFI:".
+  }
 
   // Verifica se ci sono credenziali WiFi salvate nella EEPROM.
-  bool hasCredentials = false;
   char ssid[33] = {0};  // Buffer per memorizzare l'SSID (max 32 caratteri + terminatore null).
   char pass[65] = {0};  // Buffer per memorizzare la password (max 64 caratteri + terminatore null).
 
-  // Legge un marker dalla EEPROM per verificare se le credenziali WiFi sono valide.
-  if (EEPROM.read(EEPROM_WIFI_VALID_ADDR) == EEPROM_WIFI_VALID_VALUE) {
-    // Se il marker è valido, leggi l'SSID e la password dalla EEPROM.
-    for (int i = 0; i < 32; i++) {
-      ssid[i] = EEPROM.read(EEPROM_WIFI_SSID_ADDR + i);
-    }
-    ssid[32] = 0; // Assicura che la stringa SSID sia terminata correttamente.
-
-    for (int i = 0; i < 64; i++) {
-      pass[i] = EEPROM.read(EEPROM_WIFI_PASS_ADDR + i);
-    }
-    pass[64] = 0; // Assicura che la stringa della password sia terminata correttamente.
-
-    // Se l'SSID letto dalla EEPROM non è vuoto, prova a connettersi alla rete WiFi.
-    if (strlen(ssid) > 0) {
-      hasCredentials = true;
+  // Se l'SSID letto dalla EEPROM non è vuoto, prova a connettersi alla rete WiFi.
+  if (wifiLoadCredentials(ssid, pass)) {
+    if (!quiet) {
       gfx->setTextColor(GREEN);
       displayWordWifi(64, "CONNESSIONE A:"); // Mostra "CONNESSIONE A:".
       displayWordWifi(80, ssid);           // Mostra l'SSID.
-      delay(500);
-
-      // Tenta di connettersi alla rete WiFi con le credenziali salvate.
-      WiFi.begin(ssid, pass);
-
-      int retries = 0;
-
-      // Attende la connessione o un timeout (60 tentativi * 250ms = 15 secondi).
-      while (WiFi.status() != WL_CONNECTED && retries < 60) {
-        delay(250);
-        displayWifiDot(retries); // Mostra un punto animato durante il tentativo di connessione.
-        retries++;
-
-        // Se i tentativi superano un certo limite (30), riavvia il dispositivo.
-        if (retries >= 30) {
-          // Prima di riavviare, mostra un messaggio di errore.
-          displayWifiInit();
-          gfx->setTextColor(RED);
-          displayWordWifi(96, "NON CONNESSO!");   // Mostra "NON CONNESSO!".
-          displayWordWifi(128, "RIAVVIO IN CORSO"); // Mostra "RIAVVIO IN CORSO".
-          delay(2000);
-          ESP.restart();
-         }
-
-      }
-
-      // Se la connessione WiFi ha successo, mostra un messaggio e esce dalla funzione.
-      if (WiFi.status() == WL_CONNECTED) {
-        // Assicurati che la modalità sia STATION
-        WiFi.mode(WIFI_STA);
+    }
 
-        gfx->setTextColor(BLUE);
-        displayWordWifi(128, "CONNESSO!"); // Mostra "CONNESSO!".
-        displayWordWifi(144, "IP:");       // Mostra "IP:".
-        displayWordWifi(160, WiFi.localIP().toString()); // Mostra l'indirizzo IP.
+    // Tenta di connettersi alla rete WiFi con le credenziali salvate (se non già avviato).
+    uint32_t connectStart = wifiEarlyStarted ? wifiEarlyStartMs : millis();
+    if (!wifiEarlyStarted) WiFi.begin(ssid, pass);
+
+    // Attende la connessione: dopo 7.5 secondi dall'avvio della connessione riavvia il dispositivo.
+    uint8_t dots = 0;
+    while (!wifiIsConnected()) {
+      if (millis() - connectStart >= 7500) {
+        // Prima di riavviare, mostra un messaggio di errore.
+        displayWifiInit();
+        gfx->setTextColor(RED);
+        displayWordWifi(96, "NON CONNESSO!");   // Mostra "NON CONNESSO!".
+        displayWordWifi(128, "RIAVVIO IN CORSO"); // Mostra "RIAVVIO IN CORSO".
         delay(2000);
-        gfx->fillScreen(BLACK); // Pulisce lo schermo.
-        return;
+        ESP.restart();
       }
+      bootWaitUntil(wifiIsConnected, 250, 10);
+      if (!quiet && !wifiIsConnected()) displayWifiDot(dots++); // Punto animato durante il tentativo di connessione.
+    }
+
+    // Se la connessione WiFi ha successo, mostra un messaggio e esce dalla funzione.
+    // Assicurati che la modalità sia STATION
+    WiFi.mode(WIFI_STA);
+    Serial.printf("[WIFI] Connesso in %lums, IP %s\n", (unsigned long)(millis() - connectStart),
+                  WiFi.localIP().toString().c_str());
+
+    if (!quiet) {
+      gfx->setTextColor(BLUE);
+      displayWordWifi(128, "CONNESSO!"); // Mostra "CONNESSO!".
+      displayWordWifi(144, "IP:");       // Mostra "IP:".
+      displayWordWifi(160, WiFi.localIP().toString()); // Mostra l'indirizzo IP.
+      delay(2000);
+      gfx->fillScreen(BLACK); // Pulisce lo schermo.
     }
+    return;
   }
 
   // Se si arriva qui, non ci sono credenziali salvate o la connessione è fallita.
@@ -613,8 +382,9 @@ void setup_wifi() {
     // Imposta il flag di validità delle credenziali WiFi nella EEPROM.
     EEPROM.write(EEPROM_WIFI_VALID_ADDR, EEPROM_WIFI_VALID_VALUE);
 
-    // Scrive i dati dalla cache della EEPROM alla memoria fisica.
-    EEPROM.commit();
+    // Scrive subito i dati in flash: niente commit differito per le credenziali,
+    // un riavvio o un calo di tensione nei secondi successivi le perderebbe.
+    settingsFlush();
   });
 
   // Genera suffisso device ID dagli ultimi 3 byte del MAC address
@@ -667,8 +437,8 @@ void setup_wifi() {
   // Imposta il flag di validità delle credenziali WiFi.
   EEPROM.write(EEPROM_WIFI_VALID_ADDR, EEPROM_WIFI_VALID_VALUE);
 
-  // Scrive i dati nella EEPROM.
-  EEPROM.commit();
+  // Scrive subito i dati in flash (credenziali: nessun commit differito).
+  settingsFlush();
 
   displayWifiInit(); // Reinizializza la visualizzazione WiFi.
   gfx->setTextColor(WHITE);
@@ -802,7 +572,7 @@ void resetWiFiSettings() {
   }
 
   // Salva le modifiche nella EEPROM.
-  EEPROM.commit();
+  settingsFlush();
 
   delay(2000);
   gfx->fillScreen(GREEN);
@@ -830,14 +600,10 @@ void loadSavedSettings() {
     currentColor = Color(255, 255, 255);  // Bianco come colore predefinito.
     userColor = currentColor;
 
-    // Salva i valori predefiniti nella EEPROM.
+    // Salva i valori predefiniti nella EEPROM (stessa tabella schema di setup_eeprom).
     EEPROM.write(0, EEPROM_CONFIGURED_MARKER);
-    EEPROM.write(EEPROM_PRESET_ADDR, 0);  // Preset 0 (random).
-    EEPROM.write(EEPROM_MODE_ADDR, currentMode);
-    EEPROM.write(EEPROM_COLOR_R_ADDR, 255);
-    EEPROM.write(EEPROM_COLOR_G_ADDR, 255);
-    EEPROM.write(EEPROM_COLOR_B_ADDR, 255);
-    EEPROM.commit();
+    settingsApplyDefaults(0);
+    settingsFlush();
 
     Serial.printf("[SETUP] Inizializzato con Mode=%d, Preset=%d, Color=Bianco\n", currentMode, currentPreset);
     return;
@@ -856,16 +622,11 @@ void loadSavedSettings() {
     userMode = currentMode;
     // Salva il mode corretto in EEPROM per evitare questo problema al prossimo riavvio
     EEPROM.write(EEPROM_MODE_ADDR, currentMode);
-    EEPROM.commit();
+    settingsCommit();
   }
 
-  // Carica il preset salvato dalla EEPROM
-  uint8_t savedPreset = EEPROM.read(EEPROM_PRESET_ADDR);
-  if (savedPreset <= 13) {
-    currentPreset = savedPreset;
-  } else {
-    currentPreset = 0;  // Default
-  }
+  // Carica il preset salvato dalla EEPROM (0-13, altrimenti default)
+  currentPreset = settingsLoad(EEPROM_PRESET_ADDR);
 
   // ===== CARICA COLORE PER-MODO AL BOOT =====
   // Il sistema per-modo (EEPROM 710-775 + preset 780-801) ha priorità
@@ -1031,16 +792,22 @@ void clearDisplay() {
 
 void setup_sd() {
   // Inizializza SD Card con pin personalizzati
-  // IMPORTANTE: Chiamare DOPO setup_audio_wifi() per evitare conflitto PIN 41
+  // Con l'audio WiFi esterno (ESP32C3) chiamare DOPO setup_audio_wifi() per evitare conflitto PIN 41
   Serial.println("Inizializzazione SD Card...");
 
+  // Con orologio anticipato sul display i messaggi di esito positivo restano sulla seriale;
+  // gli errori vengono comunque mostrati e poi l'orologio viene ridisegnato.
+  bool quiet = bootQuiet();
+  bool screenUsed = !quiet;
+
   // Messaggio sul display durante il controllo
-  gfx->fillScreen(BLACK);
-  gfx->setTextColor(CYAN);
-  gfx->setFont(u8g2_font_helvB12_tr);
-  gfx->setCursor(80, 200);
-  gfx->println("CONTROLLO SD CARD...");
-  delay(500);
+  if (!quiet) {
+    gfx->fillScreen(BLACK);
+    gfx->setTextColor(CYAN);
+    gfx->setFont(u8g2_font_helvB12_tr);
+    gfx->setCursor(80, 200);
+    gfx->println("CONTROLLO SD CARD...");
+  }
 
   SPI.begin(SD_CLK_PIN, SD_MISO_PIN, SD_MOSI_PIN, SD_CS_PIN);
   if (!SD.begin(SD_CS_PIN, SPI)) {
@@ -1049,6 +816,7 @@ void setup_sd() {
     Serial.println("Verifica che la scheda SD sia inserita correttamente.");
 
     // Messaggio di ERRORE sul display
+    screenUsed = true;
     gfx->fillScreen(BLACK);
     gfx->setTextColor(RED);
     gfx->setFont(u8g2_font_helvB18_tr);
@@ -1069,6 +837,7 @@ void setup_sd() {
       Serial.println("Nessuna SD Card rilevata!");
 
       // Messaggio sul display: SD NON RILEVATA
+      screenUsed = true;
       gfx->fillScreen(BLACK);
       gfx->setTextColor(ORANGE);
       gfx->setFont(u8g2_font_helvB18_tr);
@@ -1111,31 +880,38 @@ void setup_sd() {
       Serial.println("[SD SETUP] SD Card presente - monitoraggio attivo");
 #endif
 
-      // Messaggio di SUCCESSO sul display
-      gfx->fillScreen(BLACK);
-      gfx->setTextColor(GREEN);
-      gfx->setFont(u8g2_font_helvB18_tr);
-      gfx->setCursor(60, 150);
-      gfx->println("SD CARD OK!");
-
-      gfx->setFont(u8g2_font_helvB12_tr);
-      gfx->setTextColor(WHITE);
-      gfx->setCursor(120, 200);
-      gfx->print("Tipo: ");
-      gfx->println(cardTypeStr);
-
-      gfx->setCursor(80, 230);
-      gfx->print("Dimensione: ");
-      gfx->print((uint32_t)cardSize);
-      gfx->println(" MB");
+#ifdef EFFECT_MP3_PLAYER
+      // Indice brani: caricamento a caldo + verifica incrementale in background
+      mp3LibraryBegin();
+#endif
 
-      uint64_t usedBytes = SD.usedBytes() / (1024 * 1024);
-      gfx->setCursor(80, 260);
-      gfx->print("Spazio usato: ");
-      gfx->print((uint32_t)usedBytes);
-      gfx->println(" MB");
+      // Messaggio di SUCCESSO sul display
+      if (!quiet) {
+        gfx->fillScreen(BLACK);
+        gfx->setTextColor(GREEN);
+        gfx->setFont(u8g2_font_helvB18_tr);
+        gfx->setCursor(60, 150);
+        gfx->println("SD CARD OK!");
+
+        gfx->setFont(u8g2_font_helvB12_tr);
+        gfx->setTextColor(WHITE);
+        gfx->setCursor(120, 200);
+        gfx->print("Tipo: ");
+        gfx->println(cardTypeStr);
+
+        gfx->setCursor(80, 230);
+        gfx->print("Dimensione: ");
+        gfx->print((uint32_t)cardSize);
+        gfx->println(" MB");
+
+        uint64_t usedBytes = SD.usedBytes() / (1024 * 1024);
+        gfx->setCursor(80, 260);
+        gfx->print("Spazio usato: ");
+        gfx->print((uint32_t)usedBytes);
+        gfx->println(" MB");
 
-      delay(2000);
+        delay(2000);
+      }
 
       // Lista i file nella root della SD card
       Serial.println("\n=== File nella root della SD Card ===");
@@ -1171,8 +947,12 @@ void setup_sd() {
   }
   #endif
 
-  // Pulisce lo schermo dopo i messaggi di setup SD
-  gfx->fillScreen(BLACK);
+  // Pulisce lo schermo dopo i messaggi di setup SD (o ridisegna l'orologio anticipato)
+  if (quiet) {
+    if (screenUsed) updateFastMode();
+  } else {
+    gfx->fillScreen(BLACK);
+  }
   Serial.println("[CLEANUP] Schermo pulito - Setup SD completato");
 }
 
@@ -1201,7 +981,9 @@ void setup_radar() {
   // ========== INIZIALIZZAZIONE RADAR (MyLD2410) ==========
   Serial.println("\nInizializzazione UART1...");
   radarSerial.begin(LD2410_BAUD_RATE, SERIAL_8N1, LD2410_RX_PIN, LD2410_TX_PIN);
-  delay(500);
+  // Il radar trasmette frame continui: appena arriva il primo byte la UART e' pronta
+  // (timeout 500ms, come l'attesa fissa precedente, se il radar non e' collegato)
+  bootWaitUntil([]() { return radarSerial.available() > 0; }, 500, 5);
 
   Serial.println("Connessione al radar...");
   if (radar.begin()) {
@@ -1311,6 +1093,9 @@ void setup_radar() {
     Serial.println("\nCambia modalità: Menu Setup → Radar Brightness");
     Serial.println("========================================\n");
 
+    // Da qui la UART1 e' del task radar (parser frame + riconnessione, core 0)
+    radarUartBegin();
+
   } else {
     Serial.println("\n>>> RADAR: NON TROVATO <<<");
     Serial.println("Il sistema funzionera' comunque senza radar.");
@@ -1359,25 +1144,33 @@ void setup_bme280() {
   try {
     Serial.println("Ricerca sensore BME280 su bus I2C...");
 
-    // Prova prima con indirizzo 0x76
-    if (bme.begin(0x76)) {
-      bme280Available = true;
-      Serial.println(">>> BME280 trovato all'indirizzo 0x76! <<<");
-    }
-    // Se fallisce, prova con indirizzo 0x77
-    else if (bme.begin(0x77)) {
+    // Prova prima con indirizzo 0x76, poi 0x77. Begin + configurazione in un'unica
+    // transazione dell'arbitro I2C (il touch gira gia' in parallelo).
+    // Forced mode: il sensore misura solo su richiesta del poll pianificato
+    // (I2C_BME_POLL_MS) e resta in sleep nel frattempo (meno autoriscaldamento).
+    uint8_t bmeAddress = 0;
+    i2cBusRun(I2C_DEV_BME280, [](void *a) {
+      uint8_t &addr = *(uint8_t *)a;
+      if (bme.begin(0x76)) addr = 0x76;
+      else if (bme.begin(0x77)) addr = 0x77;
+      else return false;
+      bme.setSampling(Adafruit_BME280::MODE_FORCED,     // Modalità operativa
+                      Adafruit_BME280::SAMPLING_X2,     // Temp. oversampling
+                      Adafruit_BME280::SAMPLING_X16,    // Pressure oversampling
+                      Adafruit_BME280::SAMPLING_X16,    // Humidity oversampling
+                      Adafruit_BME280::FILTER_OFF,      // Filtering (inutile a misure distanziate)
+                      Adafruit_BME280::STANDBY_MS_500); // Standby time (ignorato in forced mode)
+      return true;
+    }, &bmeAddress);
+
+    if (bmeAddress) {
       bme280Available = true;
-      Serial.println(">>> BME280 trovato all'indirizzo 0x77! <<<");
+      Serial.printf(">>> BME280 trovato all'indirizzo 0x%02X! <<<\n", bmeAddress);
     }
 
-    // Se trovato, configura il sensore
+    // Se trovato, registra il sensore per il poll pianificato
     if (bme280Available) {
-      bme.setSampling(Adafruit_BME280::MODE_NORMAL,     // Modalità operativa
-                      Adafruit_BME280::SAMPLING_X2,     // Temp. oversampling
-                      Adafruit_BME280::SAMPLING_X16,    // Pressure oversampling
-                      Adafruit_BME280::SAMPLING_X16,    // Humidity oversampling
-                      Adafruit_BME280::FILTER_X16,      // Filtering
-                      Adafruit_BME280::STANDBY_MS_500); // Standby time
+      i2cBmeAttach(bmeAddress);
 
       Serial.println("\nConfigurazione sensore BME280 completata!");
       Serial.println("Dati disponibili:");
@@ -1387,9 +1180,9 @@ void setup_bme280() {
 
       // Prima lettura test
       Serial.println("\nPrima lettura sensore:");
-      temperatureIndoor = bme.readTemperature();
-      humidityIndoor = bme.readHumidity();
-      pressureIndoor = bme.readPressure() / 100.0F;  // Converte Pa in hPa
+      if (!i2cBmeSampleNow() || !i2cBmeGet(temperatureIndoor, humidityIndoor, pressureIndoor)) {
+        Serial.println("  Lettura fallita, nuovo tentativo al prossimo poll");
+      }
 
       Serial.print("  Temperatura: ");
       Serial.print(temperatureIndoor, 1);
@@ -0,0 +1,388 @@
+// ================== SKIN CACHE - QUADRANTI DECODIFICATI E DISSOLVENZA TRA SKIN ==================
+// Le skin JPEG degli orologi (orologio analogico e orologio con skin) vengono decodificate
+// una volta sola: il risultato 480x480 RGB565 viene compresso (RLE a parole da 16 bit)
+// e tenuto in PSRAM con chiave nome file + data di modifica + dimensione.
+// Tornare a una skin gia' vista costa una decompressione (pochi ms) invece della
+// decodifica JPEG dalla SD (centinaia di ms). Un file sostituito sulla SD cambia chiave
+// e viene ridecodificato. Un hit non legge la SD se la chiave e' stata verificata da meno
+// di SKIN_CACHE_RECHECK_MS; upload ed eliminazione dal web invalidano subito la voce
+// (skinCacheInvalidate). Voci e statistiche sono protette da skinCacheMutex: la cache e'
+// usata dal loop e dal task di preparazione modi.
+//
+// Formato RLE: parola di controllo + dati
+//  - bit 15 = 1: ripetizione, (ctrl & 0x7FFF) pixel uguali al pixel che segue
+//  - bit 15 = 0: letterali, ctrl pixel copiati cosi' come sono
+//
+// Dissolvenza: skinFadeBegin() salva il frame a schermo, skinFadeApply() miscela ogni nuovo
+// frame con quello salvato in base al tempo trascorso. Un passo per frame, nessun delay():
+// il loop resta libero per touch, web e audio durante la transizione.
+
+// ===== Parametri =====
+#define SKIN_CACHE_MAX_ENTRIES    6
+#define SKIN_CACHE_MAX_BYTES      (2UL * 1024UL * 1024UL)  // Budget PSRAM per le skin compresse
+#define SKIN_CACHE_PSRAM_RESERVE  (1536UL * 1024UL)        // Sotto questa soglia non memorizza
+#define SKIN_CACHE_PIXELS         (480 * 480)
+#define SKIN_FADE_MS              450                      // Durata dissolvenza tra skin
+#define SKIN_CACHE_RECHECK_MS     30000                    // Validita' della data/dimensione lette dalla SD
+
+// ===== Stato =====
+struct SkinCacheEntry {
+  char path[40];
+  uint32_t mtime;
+  uint32_t size;
+  uint16_t* data;      // Stream RLE in PSRAM
+  uint32_t words;      // Lunghezza dello stream in parole da 16 bit
+  uint32_t lastUsed;
+  uint32_t checkedMs;  // Ultima verifica di mtime/size sulla SD
+};
+static SkinCacheEntry skinCache[SKIN_CACHE_MAX_ENTRIES] = {};
+static uint32_t skinCacheBytes = 0;
+static SemaphoreHandle_t skinCacheMutex = NULL;   // Usata anche dal task di preparazione modi
+
+struct SkinCacheStats {
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t stores;
+  uint32_t evictions;
+  uint32_t warmLastMs, warmSumMs;   // Decompressione da cache
+  uint32_t coldLastMs, coldSumMs;   // Decodifica JPEG dalla SD
+  uint32_t ratioPermille;           // Ultimo rapporto di compressione
+  uint32_t switchLastMs;            // Ultimo cambio skin (richiesta -> primo frame in dissolvenza)
+};
+static SkinCacheStats skinCacheStats = {};
+
+// Dissolvenza
+static uint16_t* skinFadeFrom = nullptr;   // Frame precedente (PSRAM, solo durante la transizione)
+static uint32_t skinFadeStartMs = 0;
+
+void skinCacheBegin() {
+  if (skinCacheMutex == NULL) skinCacheMutex = xSemaphoreCreateMutex();
+}
+
+// Data di modifica e dimensione del file: cambiano quando la skin viene sostituita
+static bool skinCacheStat(const char* path, uint32_t* mtime, uint32_t* size) {
+  File f = SD.open(path, FILE_READ);
+  if (!f) return false;
+  *mtime = (uint32_t)f.getLastWrite();
+  *size = f.size();
+  f.close();
+  return true;
+}
+
+static int skinCacheFind(const char* path) {
+  for (int i = 0; i < SKIN_CACHE_MAX_ENTRIES; i++) {
+    if (skinCache[i].data != nullptr && strcmp(skinCache[i].path, path) == 0) return i;
+  }
+  return -1;
+}
+
+static void skinCacheDrop(int i) {
+  if (skinCache[i].data != nullptr) {
+    free(skinCache[i].data);
+    skinCacheBytes -= skinCache[i].words * 2;
+  }
+  skinCache[i] = SkinCacheEntry();
+}
+
+// ===== Compressione RLE =====
+// Con out == nullptr calcola solo la lunghezza dello stream
+static uint32_t skinRleEncode(const uint16_t* src, uint32_t count, uint16_t* out) {
+  uint32_t o = 0;
+  uint32_t i = 0;
+  uint32_t litStart = 0;
+  uint32_t litLen = 0;
+
+  while (i < count) {
+    uint16_t px = src[i];
+    uint32_t run = 1;
+    while (i + run < count && src[i + run] == px && run < 0x7FFF) run++;
+
+    if (run >= 3) {
+      // Chiude i letterali accumulati, poi la ripetizione
+      if (litLen) {
+        if (out) {
+          out[o] = litLen;
+          memcpy(&out[o + 1], &src[litStart], litLen * 2);
+        }
+        o += 1 + litLen;
+        litLen = 0;
+      }
+      if (out) {
+        out[o] = 0x8000 | run;
+        out[o + 1] = px;
+      }
+      o += 2;
+      i += run;
+    } else {
+      if (litLen == 0) litStart = i;
+      litLen += run;
+      i += run;
+      if (litLen >= 0x7FF0) {
+        if (out) {
+          out[o] = litLen;
+          memcpy(&out[o + 1], &src[litStart], litLen * 2);
+        }
+        o += 1 + litLen;
+        litLen = 0;
+      }
+    }
+  }
+  if (litLen) {
+    if (out) {
+      out[o] = litLen;
+      memcpy(&out[o + 1], &src[litStart], litLen * 2);
+    }
+    o += 1 + litLen;
+  }
+  return o;
+}
+
+static bool skinRleDecode(const uint16_t* in, uint32_t words, uint16_t* dst, uint32_t count) {
+  uint32_t i = 0;
+  uint32_t o = 0;
+  while (i < words && o < count) {
+    uint16_t ctrl = in[i++];
+    uint32_t n = ctrl & 0x7FFF;
+    if (o + n > count) return false;
+    if (ctrl & 0x8000) {
+      uint16_t px = in[i++];
+      uint16_t* p = &dst[o];
+      // Riempimento a 32 bit per le ripetizioni lunghe (fondi uniformi del quadrante)
+      if (n >= 8) {
+        if ((uintptr_t)p & 2) { *p++ = px; n--; o++; }
+        uint32_t px2 = ((uint32_t)px << 16) | px;
+        uint32_t* p32 = (uint32_t*)p;
+        uint32_t pairs = n >> 1;
+        for (uint32_t k = 0; k < pairs; k++) p32[k] = px2;
+        p += pairs * 2;
+        o += pairs * 2;
+        n &= 1;
+      }
+      while (n--) { *p++ = px; o++; }
+    } else {
+      if (i + n > words) return false;
+      memcpy(&dst[o], &in[i], n * 2);
+      i += n;
+      o += n;
+    }
+  }
+  return o == count;
+}
+
+// ===== API cache =====
+// Decomprime la skin nel buffer se presente in cache. Ritorna false se va decodificata.
+// Con mutex preso: verifica la voce (recheck: con la data/dimensione appena lette) e la decomprime
+static bool skinCacheFetchLocked(const char* path, uint16_t* dst, bool recheck, bool statOk,
+                                 uint32_t mtime, uint32_t size) {
+  int i = skinCacheFind(path);
+  if (i < 0) return false;
+  SkinCacheEntry& e = skinCache[i];
+  if (recheck) {
+    if (!statOk || e.mtime != mtime || e.size != size) {
+      skinCacheDrop(i);   // File sostituito o rimosso
+      return false;
+    }
+    e.checkedMs = millis();
+  }
+  if (!skinRleDecode(e.data, e.words, dst, SKIN_CACHE_PIXELS)) {
+    skinCacheDrop(i);
+    return false;
+  }
+  e.lastUsed = millis();
+  return true;
+}
+
+bool skinCacheFetch(const char* path, uint16_t* dst) {
+  if (dst == nullptr || skinCacheMutex == NULL) return false;
+
+  uint32_t t0 = millis();
+  xSemaphoreTake(skinCacheMutex, portMAX_DELAY);
+  int i = skinCacheFind(path);
+  bool recheck = i >= 0 && t0 - skinCache[i].checkedMs >= SKIN_CACHE_RECHECK_MS;
+  xSemaphoreGive(skinCacheMutex);
+
+  // Lettura SD solo per una voce presente ma verificata da troppo tempo (fuori dal mutex)
+  uint32_t mtime = 0, size = 0;
+  bool statOk = recheck && skinCacheStat(path, &mtime, &size);
+
+  xSemaphoreTake(skinCacheMutex, portMAX_DELAY);
+  bool ok = i >= 0 && skinCacheFetchLocked(path, dst, recheck, statOk, mtime, size);
+  if (ok) {
+    skinCacheStats.hits++;
+    skinCacheStats.warmLastMs = millis() - t0;
+    skinCacheStats.warmSumMs += skinCacheStats.warmLastMs;
+  } else {
+    skinCacheStats.misses++;
+  }
+  uint32_t warmMs = skinCacheStats.warmLastMs;
+  xSemaphoreGive(skinCacheMutex);
+
+  if (ok) Serial.printf("[SKIN CACHE] %s da cache in %lu ms\n", path, (unsigned long)warmMs);
+  return ok;
+}
+
+// Skin caricata o eliminata dal web: la voce non vale piu'
+void skinCacheInvalidate(const char* path) {
+  if (skinCacheMutex == NULL) return;
+  xSemaphoreTake(skinCacheMutex, portMAX_DELAY);
+  int i = skinCacheFind(path);
+  if (i >= 0) skinCacheDrop(i);
+  xSemaphoreGive(skinCacheMutex);
+}
+
+// Comprime e memorizza una skin appena decodificata (decodeMs = tempo della decodifica JPEG)
+void skinCacheStore(const char* path, const uint16_t* pixels, uint32_t decodeMs) {
+  if (skinCacheMutex == NULL) return;
+  xSemaphoreTake(skinCacheMutex, portMAX_DELAY);
+  skinCacheStats.coldLastMs = decodeMs;
+  skinCacheStats.coldSumMs += decodeMs;
+  xSemaphoreGive(skinCacheMutex);
+  if (pixels == nullptr || strlen(path) >= sizeof(skinCache[0].path)) return;
+
+  uint32_t mtime, size;
+  if (!skinCacheStat(path, &mtime, &size)) return;
+
+  uint32_t words = skinRleEncode(pixels, SKIN_CACHE_PIXELS, nullptr);
+  uint32_t bytes = words * 2;
+  if (bytes > SKIN_CACHE_MAX_BYTES || ESP.getFreePsram() < bytes + SKIN_CACHE_PSRAM_RESERVE) {
+    Serial.printf("[SKIN CACHE] %s non memorizzata (%lu KB, PSRAM libera %u KB)\n",
+                  path, (unsigned long)(bytes / 1024), ESP.getFreePsram() / 1024);
+    return;
+  }
+
+  uint16_t* data = (uint16_t*)ps_malloc(bytes);
+  if (data == nullptr) return;
+  skinRleEncode(pixels, SKIN_CACHE_PIXELS, data);
+
+  xSemaphoreTake(skinCacheMutex, portMAX_DELAY);
+  // Stessa skin con chiave vecchia (file sostituito): la versione precedente non serve piu'
+  for (int i = 0; i < SKIN_CACHE_MAX_ENTRIES; i++) {
+    if (skinCache[i].data != nullptr && strcmp(skinCache[i].path, path) == 0) skinCacheDrop(i);
+  }
+  // Libera le skin usate meno di recente finche' c'e' spazio nel budget e uno slot libero
+  for (;;) {
+    int freeSlot = -1, lru = -1;
+    for (int i = 0; i < SKIN_CACHE_MAX_ENTRIES; i++) {
+      if (skinCache[i].data == nullptr) { if (freeSlot < 0) freeSlot = i; continue; }
+      if (lru < 0 || (int32_t)(skinCache[i].lastUsed - skinCache[lru].lastUsed) < 0) lru = i;
+    }
+    if (freeSlot >= 0 && skinCacheBytes + bytes <= SKIN_CACHE_MAX_BYTES) {
+      SkinCacheEntry& e = skinCache[freeSlot];
+      strncpy(e.path, path, sizeof(e.path) - 1);
+      e.mtime = mtime;
+      e.size = size;
+      e.data = data;
+      e.words = words;
+      e.lastUsed = millis();
+      e.checkedMs = e.lastUsed;
+      skinCacheBytes += bytes;
+      data = nullptr;
+      break;
+    }
+    if (lru < 0) break;
+    skinCacheDrop(lru);
+    skinCacheStats.evictions++;
+  }
+  if (data == nullptr) {
+    skinCacheStats.stores++;
+    skinCacheStats.ratioPermille = bytes * 1000UL / (SKIN_CACHE_PIXELS * 2);
+  }
+  uint32_t ratio = skinCacheStats.ratioPermille;
+  xSemaphoreGive(skinCacheMutex);
+
+  if (data != nullptr) {
+    free(data);
+    return;
+  }
+  Serial.printf("[SKIN CACHE] %s memorizzata: %lu KB (%lu%%), decodifica %lu ms\n", path,
+                (unsigned long)(bytes / 1024), (unsigned long)(ratio / 10),
+                (unsigned long)decodeMs);
+}
+
+// ===== Dissolvenza tra skin =====
+// Salva il frame attualmente a schermo: i prossimi frame vi verranno miscelati sopra
+bool skinFadeBegin(const uint16_t* currentFrame) {
+  if (currentFrame == nullptr) return false;
+  if (skinFadeFrom == nullptr) {
+    skinFadeFrom = (uint16_t*)ps_malloc(SKIN_CACHE_PIXELS * sizeof(uint16_t));
+    if (skinFadeFrom == nullptr) return false;   // Niente memoria: cambio netto
+  }
+  memcpy(skinFadeFrom, currentFrame, SKIN_CACHE_PIXELS * sizeof(uint16_t));
+  skinFadeStartMs = millis();
+  return true;
+}
+
+bool skinFadeActive() {
+  return skinFadeFrom != nullptr;
+}
+
+// Uscita dalla modalita' a dissolvenza in corso: libera il frame salvato
+void skinFadeCancel() {
+  if (skinFadeFrom != nullptr) {
+    free(skinFadeFrom);
+    skinFadeFrom = nullptr;
+  }
+}
+
+// Chiude la dissolvenza e registra il tempo del cambio skin (dalla richiesta al primo frame)
+void skinFadeNoteSwitch(uint32_t requestMs) {
+  if (skinCacheMutex == NULL) return;
+  xSemaphoreTake(skinCacheMutex, portMAX_DELAY);
+  skinCacheStats.switchLastMs = millis() - requestMs;
+  xSemaphoreGive(skinCacheMutex);
+}
+
+// Miscela il frame nuovo (in place) con quello salvato. Alla fine libera il buffer.
+void skinFadeApply(uint16_t* frame) {
+  if (skinFadeFrom == nullptr || frame == nullptr) return;
+
+  uint32_t elapsed = millis() - skinFadeStartMs;
+  if (elapsed >= SKIN_FADE_MS) {
+    free(skinFadeFrom);
+    skinFadeFrom = nullptr;
+    return;   // Ultimo frame: solo la skin nuova
+  }
+
+  // Alpha a 5 bit (rgb565Blend in 0_HAND_RASTER.ino)
+  uint32_t alpha = elapsed * 32 / SKIN_FADE_MS;
+  const uint16_t* from = skinFadeFrom;
+  for (uint32_t i = 0; i < SKIN_CACHE_PIXELS; i++) {
+    frame[i] = rgb565Blend(frame[i], from[i], alpha);
+  }
+  frameGovAnimate();
+}
+
+// ===== Stato in JSON per /skins/cache =====
+String getSkinCacheJson() {
+  String json = "{";
+  json += "\"entries\":[";
+  bool first = true;
+  SkinCacheStats st;
+  uint32_t usedBytes;
+  if (skinCacheMutex != NULL) xSemaphoreTake(skinCacheMutex, portMAX_DELAY);
+  for (int i = 0; i < SKIN_CACHE_MAX_ENTRIES; i++) {
+    const SkinCacheEntry& e = skinCache[i];
+    if (e.data == nullptr) continue;
+    if (!first) json += ",";
+    first = false;
+    json += "{\"file\":\"" + String(e.path) + "\",\"kb\":" + String(e.words * 2 / 1024) + "}";
+  }
+  st = skinCacheStats;   // Copia coerente delle statistiche
+  usedBytes = skinCacheBytes;
+  if (skinCacheMutex != NULL) xSemaphoreGive(skinCacheMutex);
+  json += "],";
+  json += "\"usedKB\":" + String(usedBytes / 1024) + ",";
+  json += "\"budgetKB\":" + String(SKIN_CACHE_MAX_BYTES / 1024) + ",";
+  json += "\"hits\":" + String(st.hits) + ",";
+  json += "\"misses\":" + String(st.misses) + ",";
+  json += "\"stores\":" + String(st.stores) + ",";
+  json += "\"evictions\":" + String(st.evictions) + ",";
+  json += "\"warmLastMs\":" + String(st.warmLastMs) + ",";
+  json += "\"warmAvgMs\":" + String(st.hits ? st.warmSumMs / st.hits : 0) + ",";
+  json += "\"coldLastMs\":" + String(st.coldLastMs) + ",";
+  json += "\"coldAvgMs\":" + String(st.stores ? st.coldSumMs / st.stores : 0) + ",";
+  json += "\"ratioPercent\":" + String(st.ratioPermille / 10.0f, 1) + ",";
+  json += "\"switchLastMs\":" + String(st.switchLastMs);
+  json += "}";
+  return json;
+}
@@ -47,12 +47,19 @@ extern uint8_t indoorSensorSource;
 #define FLAP_SEC_GAP        10      // Spazio tra palette secondi
 
 // Animazione
-#define FLIP_FRAMES     18      // Frame totali animazione flip (aumentato per più fluidità)
+#define FLIP_FRAMES     36      // Frame totali animazione flip (60 fps, frame presi dalla cache)
 #define FLIP_DURATION   600     // Durata flip in ms (come web: 0.3s top + 0.6s bottom max)
 
 // Timing animazione a 2 fasi (ispirato al flip clock web)
-#define FLIP_PHASE1_FRAMES  6   // Fase 1: metà superiore scende (0.3s)
-#define FLIP_PHASE2_FRAMES  12  // Fase 2: metà inferiore sale (0.6s)
+#define FLIP_PHASE1_FRAMES  12  // Fase 1: metà superiore scende (0.2s)
+#define FLIP_PHASE2_FRAMES  24  // Fase 2: metà inferiore sale (0.4s)
+
+// Cache frame animazione (righe uniche in PSRAM, vedi CACHE ANIMAZIONE PALETTE)
+#define FLIP_CACHE_BIG            0       // Palette HH:MM
+#define FLIP_CACHE_SEC            1       // Palette SS
+#define FLIP_CACHE_MAX_ROWS_BIG   2048    // Righe uniche massime (palette grandi, 98 px)
+#define FLIP_CACHE_MAX_ROWS_SEC   1024    // Righe uniche massime (secondi, 54 px)
+#define FLIP_BLIT_PIXELS          ((FLAP_WIDTH + 8) * (FLAP_HEIGHT + 8))  // Rettangolo massimo trasferito
 
 // Lampeggio separatori
 #define BLINK_INTERVAL  500     // Intervallo lampeggio separatori in ms
@@ -98,6 +105,21 @@ uint8_t lastMinOnes = 99;
 uint8_t lastSecTens = 99;
 uint8_t lastSecOnes = 99;
 
+// Cache frame animazione: per dimensione palette, righe RGB565 uniche + indice riga per frame
+struct FlipFrameCache {
+  int16_t w, h;              // Rettangolo palette + ombra esterna
+  int16_t margin;            // Ombra esterna (posizione della palette nel rettangolo)
+  uint16_t* rows;            // Righe uniche (PSRAM)
+  uint16_t rowCount;
+  uint16_t* index;           // [cifra][frame][riga] -> riga unica
+};
+static FlipFrameCache flipCache[2] = {};
+static volatile bool flipCacheReady = false;
+static volatile bool flipCacheBuilding = false;    // Costruzione in corso (task di preparazione o init)
+static portMUX_TYPE flipCacheMux = portMUX_INITIALIZER_UNLOCKED;
+static uint16_t* flipBlitBuffer = nullptr;         // Rettangolo contiguo per draw16bitRGBBitmap
+static bool flipFullBlitPending = false;           // Prossimo update trasferisce tutti i 480x480
+
 // Stato lampeggio separatori
 unsigned long lastBlinkTime = 0;
 bool separatorsVisible = true;
@@ -147,13 +169,22 @@ int lastDisplayedCodeTomorrow = -1;
 // NOTA: initFlipClock() e updateFlipClock() sono dichiarati nel file principale
 void drawFlipClock();
 void drawFlap(Flap &flap, bool drawStatic);
-void drawFlapBorders(Flap &flap);  // Disegna SOLO bordi (per init secondi)
+void drawFlapBorders(Arduino_GFX* targetGfx, Flap &flap);  // Disegna SOLO bordi (per init secondi)
 void drawFlapContent(Flap &flap);  // Disegna SOLO contenuto numeri (per update secondi)
-void drawFlipAnimation(Flap &flap);
-void drawFlipAnimationContent(Flap &flap);  // Animazione SOLO contenuto (per secondi)
+void drawFlipAnimation(Arduino_GFX* targetGfx, Flap &flap);
+void drawFlipAnimationContent(Arduino_GFX* targetGfx, Flap &flap);  // Animazione SOLO contenuto (per secondi)
 void drawDigit(int16_t x, int16_t y, uint8_t digit, int16_t w, int16_t h, bool inverted, bool isSecond);
-void drawDigitHalf(int16_t x, int16_t y, uint8_t digit, int16_t w, int16_t fullHeight, int16_t halfHeight, bool topHalf, bool isSecond);
+void drawDigitHalf(Arduino_GFX* targetGfx, int16_t x, int16_t y, uint8_t digit, int16_t w, int16_t fullHeight, int16_t halfHeight, bool topHalf, bool isSecond);
 void startFlip(uint8_t flapIndex, uint8_t newDigit);
+
+// Cache frame animazione e trasferimento parziale
+bool buildFlipFrameCache();
+bool prepareFlipClockAssets();
+void releaseFlipClockAssets();
+void flipBlitRect(int16_t x, int16_t y, int16_t w, int16_t h);
+void flipBlitFlap(uint8_t flapIndex);
+void flipClockRequestFullBlit();  // Schermo sporcato da fuori (es. VU meter cancellato)
+static bool flipCacheDrawFrame(uint8_t flapIndex);
 void drawSeparator();  // Un solo separatore (HH:MM)
 void redrawSeparatorOnly();  // Ridisegna SOLO il separatore (per lampeggio)
 void playFlipSound(uint8_t numClacks, uint8_t flapIndex);
@@ -166,7 +197,7 @@ void drawDigitalFrame();  // Disegna SOLO la cornice (una volta all'init)
 void drawDate(uint8_t dayOfWeek, uint8_t day, uint8_t month, uint16_t year, bool redrawAll);
 
 // Temperatura e meteo combinati su una riga
-void drawAllWeatherInfo(bool redrawAll);
+bool drawAllWeatherInfo(bool redrawAll);  // true se la riga è stata ridisegnata
 
 // Funzioni di easing (ispirate al flip clock web)
 float easingTopFlip(float t);    // Per metà superiore: cubic-bezier(0.37, 0.01, 0.94, 0.35)
@@ -198,6 +229,17 @@ void initFlipClock() {
     Serial.println("[FLIP CLOCK] OffscreenGFX creato");
   }
 
+  // Buffer per trasferire al display solo i rettangoli cambiati
+  if (flipBlitBuffer == nullptr) {
+    flipBlitBuffer = (uint16_t*)heap_caps_malloc(FLIP_BLIT_PIXELS * sizeof(uint16_t), MALLOC_CAP_SPIRAM);
+  }
+
+  // Frame dell'animazione: di norma gia' pronti dal task di preparazione (2_MODE_LIFECYCLE).
+  // Se la costruzione e' ancora in corso sull'altro core si anima dal vivo finche' non finisce.
+  if (!flipCacheReady && !flipCacheBuilding) {
+    buildFlipFrameCache();
+  }
+
   // Sfondo iniziale nel buffer
   for (int i = 0; i < 480 * 480; i++) {
     flipClockFrameBuffer[i] = COLOR_BG_FLIP;
@@ -325,6 +367,9 @@ void initFlipClock() {
   // Temperatura interna + meteo esterno + previsioni (tutto su una riga)
   drawAllWeatherInfo(true);  // redrawAll=true per init
 
+  // Display digitale, data e meteo sono stati disegnati dopo il trasferimento di drawFlipClock()
+  flipFullBlitPending = true;
+
   flipClockInitialized = true;
   Serial.println("Flip Clock inizializzato (con display digitale LCD/LED + data + meteo)");
 }
@@ -375,9 +420,14 @@ void updateFlipClock() {
     lastSecOnes = secOnes;
   }
 
+  // Elementi che cambiano raramente: trasferimento dell'intero buffer a fine update
+  bool fullBlit = flipFullBlitPending;
+  flipFullBlitPending = false;
+
   // Aggiorna display digitale (solo se cambia ora o minuto)
   if (hour != lastDigitalHour || minute != lastDigitalMinute) {
     drawDigitalDisplay(hour, minute, false);  // redrawAll=false per update
+    fullBlit = true;
   }
 
   // Aggiorna data (solo se cambia)
@@ -394,10 +444,11 @@ void updateFlipClock() {
   // Ridisegna solo se la data è cambiata
   if (day != lastDay || month != lastMonth || year != lastYear || dayOfWeek != lastDayOfWeek) {
     drawDate(dayOfWeek, day, month, year, false);  // redrawAll=false per update
+    fullBlit = true;
   }
 
   // Aggiorna tutte le temperature e meteo (solo se cambiano)
-  drawAllWeatherInfo(false);  // redrawAll=false per update
+  if (drawAllWeatherInfo(false)) fullBlit = true;  // redrawAll=false per update
 
   // Gestione lampeggio separatori (ridisegna SOLO i separatori)
   unsigned long currentTime = millis();
@@ -411,10 +462,17 @@ void updateFlipClock() {
       redrawSeparatorOnly();  // Separatore flip clock
       drawDigitalDisplay(hour, minute, false);  // Aggiorna separatore digitale
       lastSeparatorState = separatorsVisible;
+
+      // Trasferisce solo i due punti e il box del display digitale
+      int16_t sepX = flaps[1].x + FLAP_WIDTH + FLAP_GAP + 5;
+      int16_t sepY = flaps[0].y + FLAP_HEIGHT / 2;
+      flipBlitRect(sepX - 9, sepY - 29, 19, 59);
+      flipBlitRect(0, DIGITAL_Y - 8, 480, DIGITAL_HEIGHT + 16);
     }
   }
 
   // Aggiorna animazioni flip - ridisegna SOLO le palette che cambiano
+  Arduino_GFX* targetGfx = (flipClockOffscreenGfx != nullptr) ? (Arduino_GFX*)flipClockOffscreenGfx : (Arduino_GFX*)gfx;
   for (int i = 0; i < 6; i++) {
     if (flaps[i].isFlipping) {
       unsigned long elapsed = millis() - flaps[i].flipStartTime;
@@ -427,6 +485,7 @@ void updateFlipClock() {
 
         // Ridisegna SOLO questa palette (stato finale)
         drawFlap(flaps[i], true);
+        flipBlitFlap(i);
       } else {
         // Calcola frame corrente
         uint8_t newFrame = (elapsed * FLIP_FRAMES) / FLIP_DURATION;
@@ -435,17 +494,247 @@ void updateFlipClock() {
         if (newFrame != flaps[i].flipFrame) {
           flaps[i].flipFrame = newFrame;
 
-          // Ridisegna SOLO questa palette in animazione
-          drawFlipAnimation(flaps[i]);
+          // Frame precalcolato se la cache è pronta, altrimenti disegno dal vivo
+          if (!flipCacheDrawFrame(i)) {
+            drawFlipAnimation(targetGfx, flaps[i]);
+          }
+          flipBlitFlap(i);
         }
       }
     }
   }
 
   // ===== TRASFERIMENTO BUFFER AL DISPLAY =====
-  if (flipClockFrameBuffer != nullptr && flipClockOffscreenGfx != nullptr) {
+  if (fullBlit && flipClockFrameBuffer != nullptr && flipClockOffscreenGfx != nullptr) {
     gfx->draw16bitRGBBitmap((gfx->width()-480)/2, (gfx->height()-480)/2, flipClockFrameBuffer, 480, 480);
   }
+
+  // Frame governor: cadenza piena solo durante i flip, altrimenti fino al prossimo lampeggio separatori
+  bool anyFlipping = false;
+  for (int i = 0; i < 6; i++) {
+    if (flaps[i].isFlipping) anyFlipping = true;
+  }
+  if (anyFlipping) frameGovAnimate();
+  else frameGovWakeAt(lastBlinkTime + BLINK_INTERVAL);
+}
+
+// ================== CACHE ANIMAZIONE PALETTE ==================
+// Un frame del flip dipende solo da dimensione della palette, cifra mostrata e indice del
+// frame: la fase 1 mostra la cifra vecchia, la fase 2 la nuova. Tutti i frame (10 cifre x
+// FLIP_FRAMES, palette grandi e secondi) vengono disegnati una volta con drawFlipAnimation()
+// in un buffer di lavoro e salvati in PSRAM come righe uniche + indice di riga per frame:
+// sfondo, bordi e coperture si ripetono in quasi tutte le righe, cosi' l'intera animazione
+// occupa qualche centinaio di KB invece dei ~13 MB dei frame interi. Ogni transizione
+// (anche 5->0, 2->0, 3->0) e' coperta. In animazione un frame costa h memcpy di riga.
+
+// Disegna tutti i frame di una dimensione di palette e ne deduplica le righe
+static bool flipCacheBuildSize(uint8_t sizeIdx) {
+  bool isSecond = (sizeIdx == FLIP_CACHE_SEC);
+  FlipFrameCache& c = flipCache[sizeIdx];
+  c.margin = isSecond ? 2 : 4;  // Stessa ombra esterna di drawFlapBorders()
+  c.w = (isSecond ? FLAP_SEC_WIDTH : FLAP_WIDTH) + c.margin * 2;
+  c.h = (isSecond ? FLAP_SEC_HEIGHT : FLAP_HEIGHT) + c.margin * 2;
+  c.rowCount = 0;
+
+  uint16_t maxRows = isSecond ? FLIP_CACHE_MAX_ROWS_SEC : FLIP_CACHE_MAX_ROWS_BIG;
+  uint16_t hashSize = 1;
+  while (hashSize < maxRows * 2) hashSize <<= 1;
+  uint32_t pixels = (uint32_t)c.w * c.h;
+
+  uint16_t* work = (uint16_t*)heap_caps_malloc(pixels * 2, MALLOC_CAP_SPIRAM);
+  uint16_t* base = (uint16_t*)heap_caps_malloc(pixels * 2, MALLOC_CAP_SPIRAM);
+  uint16_t* hash = (uint16_t*)heap_caps_calloc(hashSize, sizeof(uint16_t), MALLOC_CAP_SPIRAM);  // 0 = vuoto, altrimenti riga+1
+  c.rows = (uint16_t*)heap_caps_malloc((uint32_t)maxRows * c.w * 2, MALLOC_CAP_SPIRAM);
+  c.index = (uint16_t*)heap_caps_malloc(10UL * FLIP_FRAMES * c.h * 2, MALLOC_CAP_SPIRAM);
+  OffscreenGFX* workGfx = (work != nullptr) ? new OffscreenGFX(work, c.w, c.h) : nullptr;
+  bool ok = work && base && hash && c.rows && c.index && workGfx;
+
+  if (ok) {
+    // Palette statica nel buffer di lavoro: fuori dagli angoli arrotondati resta lo sfondo
+    Flap flap = {};
+    flap.x = c.margin;
+    flap.y = c.margin;
+    flap.isSecond = isSecond;
+    flap.isFlipping = true;
+    for (uint32_t i = 0; i < pixels; i++) work[i] = COLOR_BG_FLIP;
+    drawFlapBorders(workGfx, flap);
+    if (isSecond) {
+      // Contenuto vuoto come drawFlapContent(): i frame dei secondi toccano solo l'interno
+      workGfx->fillRect(flap.x + 3, flap.y + 3, FLAP_SEC_WIDTH - 6, FLAP_SEC_HEIGHT - 6, COLOR_FLAP_BG);
+    }
+    memcpy(base, work, pixels * 2);
+
+    uint16_t* idx = c.index;
+    for (uint8_t digit = 0; digit < 10 && ok; digit++) {
+      for (uint8_t frame = 0; frame < FLIP_FRAMES && ok; frame++) {
+        // Ogni frame parte dalla palette statica: nessun residuo dei frame precedenti
+        memcpy(work, base, pixels * 2);
+        flap.currentDigit = digit;
+        flap.targetDigit = digit;
+        flap.flipFrame = frame;
+        drawFlipAnimation(workGfx, flap);
+
+        for (int16_t r = 0; r < c.h; r++) {
+          const uint16_t* line = work + r * c.w;
+          uint32_t hv = 2166136261UL;  // FNV-1a
+          for (int16_t k = 0; k < c.w; k++) hv = (hv ^ line[k]) * 16777619UL;
+
+          uint16_t slot = hv & (hashSize - 1);
+          for (;;) {
+            uint16_t e = hash[slot];
+            if (e == 0) {
+              if (c.rowCount >= maxRows) { ok = false; break; }
+              memcpy(c.rows + (uint32_t)c.rowCount * c.w, line, c.w * 2);
+              hash[slot] = ++c.rowCount;
+              *idx++ = c.rowCount - 1;
+              break;
+            }
+            if (memcmp(c.rows + (uint32_t)(e - 1) * c.w, line, c.w * 2) == 0) {
+              *idx++ = e - 1;
+              break;
+            }
+            slot = (slot + 1) & (hashSize - 1);
+          }
+          if (!ok) break;
+        }
+      }
+    }
+  }
+
+  if (workGfx != nullptr) delete workGfx;
+  if (work != nullptr) free(work);
+  if (base != nullptr) free(base);
+  if (hash != nullptr) free(hash);
+
+  if (!ok) {
+    if (c.rows != nullptr) free(c.rows);
+    if (c.index != nullptr) free(c.index);
+    c.rows = nullptr;
+    c.index = nullptr;
+    c.rowCount = 0;
+    return false;
+  }
+
+  // Restituisce la parte non usata del pool di righe
+  uint16_t* shrunk = (uint16_t*)heap_caps_realloc(c.rows, (uint32_t)c.rowCount * c.w * 2, MALLOC_CAP_SPIRAM);
+  if (shrunk != nullptr) c.rows = shrunk;
+  return true;
+}
+
+static void flipCacheFree() {
+  for (uint8_t s = 0; s < 2; s++) {
+    if (flipCache[s].rows != nullptr) free(flipCache[s].rows);
+    if (flipCache[s].index != nullptr) free(flipCache[s].index);
+    flipCache[s].rows = nullptr;
+    flipCache[s].index = nullptr;
+    flipCache[s].rowCount = 0;
+  }
+}
+
+// Costruisce la cache di entrambe le dimensioni (task di preparazione o initFlipClock)
+bool buildFlipFrameCache() {
+  taskENTER_CRITICAL(&flipCacheMux);
+  bool busy = flipCacheReady || flipCacheBuilding;
+  if (!busy) flipCacheBuilding = true;
+  taskEXIT_CRITICAL(&flipCacheMux);
+  if (busy) return flipCacheReady;
+
+  uint32_t t0 = millis();
+  bool ok = flipCacheBuildSize(FLIP_CACHE_BIG) && flipCacheBuildSize(FLIP_CACHE_SEC);
+  if (ok) {
+    uint32_t bytes = 0;
+    for (uint8_t s = 0; s < 2; s++) {
+      bytes += (uint32_t)flipCache[s].rowCount * flipCache[s].w * 2 + 10UL * FLIP_FRAMES * flipCache[s].h * 2;
+    }
+    Serial.printf("[FLIP CACHE] %d frame in %lu ms: %u+%u righe uniche, %lu KB PSRAM\n",
+                  2 * 10 * FLIP_FRAMES, (unsigned long)(millis() - t0),
+                  flipCache[FLIP_CACHE_BIG].rowCount, flipCache[FLIP_CACHE_SEC].rowCount,
+                  (unsigned long)(bytes / 1024));
+  } else {
+    flipCacheFree();
+    Serial.println("[FLIP CACHE] PSRAM insufficiente: animazione disegnata dal vivo");
+  }
+
+  flipCacheReady = ok;
+  flipCacheBuilding = false;
+  return ok;
+}
+
+// Preparazione in background (task di 2_MODE_LIFECYCLE)
+bool prepareFlipClockAssets() {
+  return buildFlipFrameCache();
+}
+
+// Rilascio su PSRAM scarsa: la cache verra' ricostruita al prossimo ingresso
+void releaseFlipClockAssets() {
+  if (flipCacheBuilding) return;
+  flipCacheReady = false;
+  flipCacheFree();
+}
+
+// Copia il frame corrente della palette dalla cache nel frame buffer (false = cache non pronta)
+static bool flipCacheDrawFrame(uint8_t flapIndex) {
+  if (!flipCacheReady || flipClockFrameBuffer == nullptr) return false;
+
+  const Flap& flap = flaps[flapIndex];
+  const FlipFrameCache& c = flipCache[flap.isSecond ? FLIP_CACHE_SEC : FLIP_CACHE_BIG];
+  uint8_t frame = flap.flipFrame < FLIP_FRAMES ? flap.flipFrame : FLIP_FRAMES - 1;
+  uint8_t digit = (frame < FLIP_PHASE1_FRAMES) ? flap.currentDigit : flap.targetDigit;
+  const uint16_t* idx = c.index + ((uint32_t)digit * FLIP_FRAMES + frame) * c.h;
+
+  uint16_t* dst = flipClockFrameBuffer + (flap.y - c.margin) * 480 + (flap.x - c.margin);
+  for (int16_t r = 0; r < c.h; r++) {
+    memcpy(dst, c.rows + (uint32_t)idx[r] * c.w, c.w * 2);
+    dst += 480;
+  }
+  return true;
+}
+
+// ================== TRASFERIMENTO PARZIALE AL DISPLAY ==================
+// Trasferisce un rettangolo del frame buffer: le righe intere sono gia' contigue,
+// gli altri rettangoli vengono impacchettati in flipBlitBuffer
+void flipBlitRect(int16_t x, int16_t y, int16_t w, int16_t h) {
+  if (flipClockFrameBuffer == nullptr || flipClockOffscreenGfx == nullptr) return;
+  int16_t ox = (gfx->width() - 480) / 2;
+  int16_t oy = (gfx->height() - 480) / 2;
+
+  if (x < 0) { w += x; x = 0; }
+  if (y < 0) { h += y; y = 0; }
+  if (x + w > 480) w = 480 - x;
+  if (y + h > 480) h = 480 - y;
+  if (w <= 0 || h <= 0) return;
+
+  if (w == 480) {
+    gfx->draw16bitRGBBitmap(ox, oy + y, flipClockFrameBuffer + y * 480, 480, h);
+    return;
+  }
+  if (flipBlitBuffer == nullptr || (int32_t)w * h > FLIP_BLIT_PIXELS) {
+    // Nessun buffer di appoggio: banda di righe intere
+    gfx->draw16bitRGBBitmap(ox, oy + y, flipClockFrameBuffer + y * 480, 480, h);
+    return;
+  }
+
+  const uint16_t* src = flipClockFrameBuffer + y * 480 + x;
+  uint16_t* dst = flipBlitBuffer;
+  for (int16_t r = 0; r < h; r++) {
+    memcpy(dst, src, w * 2);
+    src += 480;
+    dst += w;
+  }
+  gfx->draw16bitRGBBitmap(ox + x, oy + y, flipBlitBuffer, w, h);
+}
+
+void flipClockRequestFullBlit() {
+  flipFullBlitPending = true;
+}
+
+// Rettangolo di una palette inclusa l'ombra esterna
+void flipBlitFlap(uint8_t flapIndex) {
+  const Flap& flap = flaps[flapIndex];
+  int16_t margin = flap.isSecond ? 2 : 4;
+  int16_t w = flap.isSecond ? FLAP_SEC_WIDTH : FLAP_WIDTH;
+  int16_t h = flap.isSecond ? FLAP_SEC_HEIGHT : FLAP_HEIGHT;
+  flipBlitRect(flap.x - margin, flap.y - margin, w + margin * 2, h + margin * 2);
 }
 
 // ================== DISEGNA FLIP CLOCK (solo per inizializzazione) ==================
@@ -466,16 +755,16 @@ void drawFlipClock() {
 
 // ================== DISEGNA SINGOLA PALETTE STATICA ==================
 void drawFlap(Flap &flap, bool drawStatic) {
+  // Fallback a gfx diretto se double buffer non disponibile
+  Arduino_GFX* targetGfx = (flipClockOffscreenGfx != nullptr) ? (Arduino_GFX*)flipClockOffscreenGfx : (Arduino_GFX*)gfx;
+
   // Disegna bordi + contenuto
-  drawFlapBorders(flap);
+  drawFlapBorders(targetGfx, flap);
   drawFlapContent(flap);
 }
 
 // ================== DISEGNA SOLO BORDI PALETTE ==================
-void drawFlapBorders(Flap &flap) {
-  // Fallback a gfx diretto se double buffer non disponibile
-  Arduino_GFX* targetGfx = (flipClockOffscreenGfx != nullptr) ? (Arduino_GFX*)flipClockOffscreenGfx : (Arduino_GFX*)gfx;
-
+void drawFlapBorders(Arduino_GFX* targetGfx, Flap &flap) {
   int16_t x = flap.x;
   int16_t y = flap.y;
 
@@ -530,10 +819,7 @@ void drawFlapContent(Flap &flap) {
 }
 
 // ================== ANIMAZIONE FLIP SOLO CONTENUTO (per secondi - senza ridisegnare bordi) ==================
-void drawFlipAnimationContent(Flap &flap) {
-  // Fallback a gfx diretto se double buffer non disponibile
-  Arduino_GFX* targetGfx = (flipClockOffscreenGfx != nullptr) ? (Arduino_GFX*)flipClockOffscreenGfx : (Arduino_GFX*)gfx;
-
+void drawFlipAnimationContent(Arduino_GFX* targetGfx, Flap &flap) {
   // Questa funzione è ottimizzata per i secondi:
   // - NON ridisegna mai i bordi/ombre/linee divisorie
   // - Manipola SOLO l'area contenuto interno
@@ -558,7 +844,7 @@ void drawFlipAnimationContent(Flap &flap) {
 
     // Metà inferiore SEMPRE visibile (numero vecchio)
     targetGfx->fillRect(x + margin, y + halfHeight + margin, w - margin*2, halfHeight - margin*2, COLOR_FLAP_BG);
-    drawDigitHalf(x, y + halfHeight, flap.currentDigit, w, h, halfHeight, false, flap.isSecond);
+    drawDigitHalf(targetGfx, x, y + halfHeight, flap.currentDigit, w, h, halfHeight, false, flap.isSecond);
 
     // Metà superiore con "rotazione" simulata
     int16_t scaledHeight = halfHeight * (1.0 - progress);
@@ -566,7 +852,7 @@ void drawFlipAnimationContent(Flap &flap) {
     if (scaledHeight > 2) {
       // Disegna metà superiore che si chiude dall'alto
       targetGfx->fillRect(x + margin, y + margin, w - margin*2, halfHeight - margin, COLOR_FLAP_BG);
-      drawDigitHalf(x, y, flap.currentDigit, w, h, halfHeight, true, flap.isSecond);
+      drawDigitHalf(targetGfx, x, y, flap.currentDigit, w, h, halfHeight, true, flap.isSecond);
 
       // Copri la parte che "ruota via"
       int16_t coverHeight = halfHeight - scaledHeight - margin;
@@ -585,7 +871,7 @@ void drawFlipAnimationContent(Flap &flap) {
 
     // Metà superiore SEMPRE visibile (numero NUOVO)
     targetGfx->fillRect(x + margin, y + margin, w - margin*2, halfHeight - margin, COLOR_FLAP_BG);
-    drawDigitHalf(x, y, flap.targetDigit, w, h, halfHeight, true, flap.isSecond);
+    drawDigitHalf(targetGfx, x, y, flap.targetDigit, w, h, halfHeight, true, flap.isSecond);
 
     // Metà inferiore con "rotazione" simulata
     int16_t scaledHeight = halfHeight * progress;
@@ -593,7 +879,7 @@ void drawFlipAnimationContent(Flap &flap) {
     if (scaledHeight < halfHeight - 2) {
       // Disegna metà inferiore
       targetGfx->fillRect(x + margin, y + halfHeight + margin, w - margin*2, halfHeight - margin*2, COLOR_FLAP_BG);
-      drawDigitHalf(x, y + halfHeight, flap.targetDigit, w, h, halfHeight, false, flap.isSecond);
+      drawDigitHalf(targetGfx, x, y + halfHeight, flap.targetDigit, w, h, halfHeight, false, flap.isSecond);
 
       // Copri la parte che non è ancora "ruotata"
       int16_t coverHeight = halfHeight - scaledHeight - margin*2;
@@ -603,7 +889,7 @@ void drawFlipAnimationContent(Flap &flap) {
     } else {
       // Animazione completata - mostra numero nuovo completo
       targetGfx->fillRect(x + margin, y + halfHeight + margin, w - margin*2, halfHeight - margin*2, COLOR_FLAP_BG);
-      drawDigitHalf(x, y + halfHeight, flap.targetDigit, w, h, halfHeight, false, flap.isSecond);
+      drawDigitHalf(targetGfx, x, y + halfHeight, flap.targetDigit, w, h, halfHeight, false, flap.isSecond);
     }
   }
 
@@ -611,16 +897,14 @@ void drawFlipAnimationContent(Flap &flap) {
 }
 
 // ================== ANIMAZIONE FLIP (2 FASI) ==================
-void drawFlipAnimation(Flap &flap) {
+// Disegna su targetGfx: frame buffer (senza cache) o buffer di lavoro della cache
+void drawFlipAnimation(Arduino_GFX* targetGfx, Flap &flap) {
   // Per i secondi: usa versione ottimizzata senza bordi
   if (flap.isSecond) {
-    drawFlipAnimationContent(flap);
+    drawFlipAnimationContent(targetGfx, flap);
     return;
   }
 
-  // Fallback a gfx diretto se double buffer non disponibile
-  Arduino_GFX* targetGfx = (flipClockOffscreenGfx != nullptr) ? (Arduino_GFX*)flipClockOffscreenGfx : (Arduino_GFX*)gfx;
-
   // Per HH:MM: disegna tutto (bordi + animazione)
   int16_t x = flap.x;
   int16_t y = flap.y;
@@ -643,7 +927,7 @@ void drawFlipAnimation(Flap &flap) {
     float progress = easingTopFlip(rawProgress);
 
     // Metà inferiore SEMPRE visibile (numero vecchio)
-    drawDigitHalf(x, y + halfHeight, flap.currentDigit, w, h, halfHeight, false, flap.isSecond);
+    drawDigitHalf(targetGfx, x, y + halfHeight, flap.currentDigit, w, h, halfHeight, false, flap.isSecond);
 
     // Metà superiore con "rotazione" simulata (scala verticale)
     int16_t scaledHeight = halfHeight * (1.0 - progress);
@@ -652,7 +936,7 @@ void drawFlipAnimation(Flap &flap) {
       // Disegna metà superiore che si chiude dall'alto
       // Clip region per mostrare solo metà superiore
       targetGfx->fillRect(x, y, w, halfHeight, COLOR_FLAP_BG);
-      drawDigitHalf(x, y, flap.currentDigit, w, h, halfHeight, true, flap.isSecond);
+      drawDigitHalf(targetGfx, x, y, flap.currentDigit, w, h, halfHeight, true, flap.isSecond);
 
       // Copri la parte che "ruota via" con sfondo che scende
       int16_t coverHeight = halfHeight - scaledHeight;
@@ -673,7 +957,7 @@ void drawFlipAnimation(Flap &flap) {
     float progress = easingBottomFlip(rawProgress);
 
     // Metà superiore SEMPRE visibile (numero NUOVO)
-    drawDigitHalf(x, y, flap.targetDigit, w, h, halfHeight, true, flap.isSecond);
+    drawDigitHalf(targetGfx, x, y, flap.targetDigit, w, h, halfHeight, true, flap.isSecond);
 
     // Metà inferiore con "rotazione" simulata (scala verticale dal basso)
     int16_t scaledHeight = halfHeight * progress;
@@ -681,7 +965,7 @@ void drawFlipAnimation(Flap &flap) {
     if (scaledHeight < halfHeight - 2) {
       // Disegna metà inferiore
       targetGfx->fillRect(x, y + halfHeight, w, halfHeight, COLOR_FLAP_BG);
-      drawDigitHalf(x, y + halfHeight, flap.targetDigit, w, h, halfHeight, false, flap.isSecond);
+      drawDigitHalf(targetGfx, x, y + halfHeight, flap.targetDigit, w, h, halfHeight, false, flap.isSecond);
 
       // Copri la parte che non è ancora "ruotata"
       int16_t coverHeight = halfHeight - scaledHeight;
@@ -693,7 +977,7 @@ void drawFlipAnimation(Flap &flap) {
       }
     } else {
       // Animazione completata - mostra numero nuovo completo
-      drawDigitHalf(x, y + halfHeight, flap.targetDigit, w, h, halfHeight, false, flap.isSecond);
+      drawDigitHalf(targetGfx, x, y + halfHeight, flap.targetDigit, w, h, halfHeight, false, flap.isSecond);
     }
   }
 
@@ -744,10 +1028,7 @@ void drawDigit(int16_t x, int16_t y, uint8_t digit, int16_t w, int16_t h, bool i
 }
 
 // ================== DISEGNA METÀ CIFRA ==================
-void drawDigitHalf(int16_t x, int16_t y, uint8_t digit, int16_t w, int16_t fullHeight, int16_t halfHeight, bool topHalf, bool isSecond) {
-  // Fallback a gfx diretto se double buffer non disponibile
-  Arduino_GFX* targetGfx = (flipClockOffscreenGfx != nullptr) ? (Arduino_GFX*)flipClockOffscreenGfx : (Arduino_GFX*)gfx;
-
+void drawDigitHalf(Arduino_GFX* targetGfx, int16_t x, int16_t y, uint8_t digit, int16_t w, int16_t fullHeight, int16_t halfHeight, bool topHalf, bool isSecond) {
   // Questa funzione disegna solo metà della cifra (superiore o inferiore)
   // usando una tecnica di clipping manuale
 
@@ -1095,7 +1376,7 @@ float easingBottomFlip(float t) {
 }
 
 // ================== TUTTE LE TEMPERATURE E METEO SU UNA RIGA ==================
-void drawAllWeatherInfo(bool redrawAll) {
+bool drawAllWeatherInfo(bool redrawAll) {
   // Fallback a gfx diretto se double buffer non disponibile
   Arduino_GFX* targetGfx = (flipClockOffscreenGfx != nullptr) ? (Arduino_GFX*)flipClockOffscreenGfx : (Arduino_GFX*)gfx;
 
@@ -1122,7 +1403,7 @@ void drawAllWeatherInfo(bool redrawAll) {
                      weatherCodeTomorrow != lastDisplayedCodeTomorrow;
 
   if (!needsRedraw) {
-    return;  // Nessun cambiamento
+    return false;  // Nessun cambiamento
   }
 
   // Font più grande per riempire la riga
@@ -1262,6 +1543,7 @@ void drawAllWeatherInfo(bool redrawAll) {
   lastDisplayedWeatherCode = weatherCode;
   lastDisplayedTempTomorrow = tempMinRounded;
   lastDisplayedCodeTomorrow = weatherCodeTomorrow;
+  return true;
 }
 
 #endif // EFFECT_FLIP_CLOCK
@@ -99,6 +99,7 @@ static bool lastColonState = true;
 
 // Buffer sfondo
 uint16_t *bttfBackgroundBuffer = nullptr;
+bool bttfBackgroundLoaded = false;  // bttf.jpg gia' decodificato nel buffer (resta valido tra un ingresso e l'altro)
 
 // ================== FUNZIONI ==================
 
@@ -168,7 +169,9 @@ int bttfJpegDrawCallback(JPEGDRAW *pDraw) {
   return 1;
 }
 
-bool loadBTTFBackgroundToBuffer() {
+// Decodifica bttf.jpg nel buffer di sfondo con il decoder indicato.
+// Usata sia dal loop (decoder globale) sia dal task di preparazione (decoder dedicato).
+bool decodeBTTFBackground(JPEGDEC *decoder) {
   String filepath = "/bttf.jpg";
 
   Serial.printf("[BTTF] Caricamento sfondo: '%s'\n", filepath.c_str());
@@ -209,11 +212,11 @@ bool loadBTTFBackgroundToBuffer() {
   jpegFile.read(jpegBuffer, fileSize);
   jpegFile.close();
 
-  int result = jpeg.openRAM(jpegBuffer, fileSize, bttfJpegDrawCallback);
+  int result = decoder->openRAM(jpegBuffer, fileSize, bttfJpegDrawCallback);
   if (result == 1) {
-    jpeg.setPixelType(RGB565_LITTLE_ENDIAN);
-    jpeg.decode(0, 0, 0);
-    jpeg.close();
+    decoder->setPixelType(RGB565_LITTLE_ENDIAN);
+    decoder->decode(0, 0, 0);
+    decoder->close();
     Serial.println("[BTTF] Sfondo caricato!");
   }
 
@@ -221,6 +224,25 @@ bool loadBTTFBackgroundToBuffer() {
   return (result == 1);
 }
 
+bool loadBTTFBackgroundToBuffer() {
+  return decodeBTTFBackground(&jpeg);
+}
+
+// Preparazione in background (task di 2_MODE_LIFECYCLE): sfondo pronto prima dell'ingresso
+bool prepareBTTFAssets(JPEGDEC *decoder) {
+  if (!bttfBackgroundLoaded) bttfBackgroundLoaded = decodeBTTFBackground(decoder);
+  return bttfBackgroundLoaded;
+}
+
+// Rilascio su PSRAM scarsa: lo sfondo verra' ridecodificato al prossimo ingresso
+void releaseBTTFAssets() {
+  bttfBackgroundLoaded = false;
+  if (bttfBackgroundBuffer != nullptr) {
+    free(bttfBackgroundBuffer);
+    bttfBackgroundBuffer = nullptr;
+  }
+}
+
 extern bool loadBTTFConfigFromSD();
 
 void initBTTF() {
@@ -252,7 +274,12 @@ void initBTTF() {
   }
 
   loadBTTFConfigFromSD();
-  loadBTTFBackgroundToBuffer();
+  modeLifecycleClaim(MODE_BTTF);   // Attende un'eventuale preparazione in background dello sfondo
+  if (!bttfBackgroundLoaded) {
+    bttfBackgroundLoaded = loadBTTFBackgroundToBuffer();
+  } else {
+    Serial.println("[BTTF] Sfondo gia' in PSRAM");
+  }
 
   lastDisplayedHour = 255;
   lastDisplayedMinute = 255;
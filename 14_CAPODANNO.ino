@@ -18,12 +18,19 @@ extern uint16_t capodannoLastYear;
 // 🔧 PER TEST: Usa 30 secondi per test veloci (commentare la riga sopra e decommentare questa)
 //#define CAPODANNO_DURATION 30000      // Durata TEST: 30 secondi (30000 ms)
 
-#define MAX_FIREWORKS 15                // Numero massimo di fuochi d'artificio attivi contemporaneamente
+#define MAX_FIREWORKS 15                // Numero massimo di esplosioni attive contemporaneamente
+#define FIREWORK_SPARKS_MIN 48          // Scintille per esplosione (motore particelle: 0_PARTICLES.ino)
+#define FIREWORK_SPARKS_MAX 96
+#define CAPODANNO_MAX_SPARKS (MAX_FIREWORKS * FIREWORK_SPARKS_MAX)
+#define CAPODANNO_GRAVITY 8             // Caduta delle scintille (Q8 pixel/frame², ~0.03 px)
 
 // ================== DATI LOCALI ==================
-// NOTA: La struct Firework è definita in oraQuadraNano_V1_3.ino
-// Array di fuochi d'artificio
-Firework fireworks[MAX_FIREWORKS];
+// Frame buffer + strato statico (nero con la scritta) in PSRAM solo per i 2 minuti dell'effetto:
+// le scintille vengono cancellate ripristinando dallo strato i soli pixel toccati.
+uint16_t *capodannoFrame = nullptr;
+uint16_t *capodannoLayer = nullptr;
+ParticleSystem capodannoSparks;
+ParticleCanvas capodannoCanvas;
 
 // Colori vivaci per i fuochi d'artificio (RGB565)
 const uint16_t fireworkColors[] = {
@@ -41,6 +48,34 @@ const uint16_t fireworkColors[] = {
 
 // ================== FUNZIONI CAPODANNO ==================
 
+// Libera buffer e particelle a fine effetto
+void releaseCapodannoBuffers() {
+  particleSystemFree(&capodannoSparks);
+  particleCanvasEnd(&capodannoCanvas);
+  if (capodannoFrame != nullptr) { free(capodannoFrame); capodannoFrame = nullptr; }
+  if (capodannoLayer != nullptr) { free(capodannoLayer); capodannoLayer = nullptr; }
+}
+
+// Alloca frame buffer, strato statico e sistema di scintille
+bool allocCapodannoBuffers() {
+  size_t bytes = 480 * 480 * sizeof(uint16_t);
+  capodannoFrame = (uint16_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  capodannoLayer = (uint16_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (capodannoFrame == nullptr || capodannoLayer == nullptr ||
+      !particleSystemAlloc(&capodannoSparks, CAPODANNO_MAX_SPARKS) ||
+      !particleCanvasBegin(&capodannoCanvas, capodannoFrame, capodannoLayer, 480, 480, CAPODANNO_MAX_SPARKS)) {
+    releaseCapodannoBuffers();
+    return false;
+  }
+  capodannoSparks.gravity = CAPODANNO_GRAVITY;
+  capodannoSparks.emit = capodannoEmit;
+  // Le scintille sfumano con la vita e passano dietro la scritta (visibili solo sul nero)
+  capodannoSparks.flags = PART_FLAG_FADE | PART_FLAG_KEYED;
+  capodannoSparks.keyLo = 0x0000;
+  capodannoSparks.keyHi = 0x0000;
+  return true;
+}
+
 // Inizializza l'effetto Capodanno
 void initCapodanno() {
   Serial.println("[CAPODANNO] 🎆 BUON ANNO! Attivazione effetto speciale...");
@@ -49,142 +84,112 @@ void initCapodanno() {
   capodannoStartTime = millis();
   savedMode = currentMode;  // Salva la modalità corrente
 
-  // Inizializza tutti i fuochi come inattivi
-  for (int i = 0; i < MAX_FIREWORKS; i++) {
-    fireworks[i].active = false;
-  }
-
-  // Pulisce lo schermo con sfondo nero
-  gfx->fillScreen(0x0000);
-
-  Serial.printf("[CAPODANNO] Modalità salvata: %d - Durata: %d secondi\n", savedMode, CAPODANNO_DURATION / 1000);
-}
-
-// Crea un nuovo fuoco d'artificio in posizione casuale
-void createFirework() {
-  // Trova uno slot libero
-  for (int i = 0; i < MAX_FIREWORKS; i++) {
-    if (!fireworks[i].active) {
-      fireworks[i].x = random(60, 420);          // Posizione X casuale (margine dai bordi)
-      fireworks[i].y = random(60, 420);          // Posizione Y casuale
-      fireworks[i].radius = 0;
-      fireworks[i].maxRadius = random(40, 100);  // Raggio massimo casuale
-      fireworks[i].speed = random(15, 35) / 10.0; // Velocità casuale (1.5 - 3.5 pixel/frame)
-      fireworks[i].color = fireworkColors[random(10)]; // Colore casuale
-      fireworks[i].active = true;
-      fireworks[i].startTime = millis();
-      fireworks[i].sparkles = random(8, 16);     // Numero di scintille casuali
-      break;
-    }
-  }
-}
-
-// Disegna un singolo fuoco d'artificio
-void drawFirework(Firework &fw) {
-  if (!fw.active) return;
-
-  // Calcola alpha (trasparenza simulata) in base al progresso
-  float progress = fw.radius / fw.maxRadius;
-
-  // Colore che sfuma verso il nero mentre si espande
-  uint16_t currentColor = fw.color;
-  if (progress > 0.7) {
-    // Fade out negli ultimi 30% dell'espansione
-    float fade = 1.0 - ((progress - 0.7) / 0.3);
-    // Scurisce il colore
-    uint8_t r = ((fw.color >> 11) & 0x1F) * fade;
-    uint8_t g = ((fw.color >> 5) & 0x3F) * fade;
-    uint8_t b = (fw.color & 0x1F) * fade;
-    currentColor = (r << 11) | (g << 5) | b;
-  }
-
-  // Disegna scintille radiali
-  for (int i = 0; i < fw.sparkles; i++) {
-    float angle = (2.0 * PI * i) / fw.sparkles;
-    int16_t x1 = fw.x + cos(angle) * fw.radius;
-    int16_t y1 = fw.y + sin(angle) * fw.radius;
-
-    // Disegna linea dalla posizione precedente
-    float prevRadius = fw.radius - fw.speed;
-    if (prevRadius < 0) prevRadius = 0;
-    int16_t x0 = fw.x + cos(angle) * prevRadius;
-    int16_t y0 = fw.y + sin(angle) * prevRadius;
-
-    gfx->drawLine(x0, y0, x1, y1, currentColor);
+  particleSeed(esp_random());
 
-    // Aggiungi puntino luminoso alla fine
-    gfx->fillCircle(x1, y1, 2, currentColor);
+  if (allocCapodannoBuffers()) {
+    // Strato statico: sfondo nero + scritta, il primo frame lo copia per intero
+    memset(capodannoLayer, 0, 480 * 480 * sizeof(uint16_t));
+    OffscreenGFX layerGfx(capodannoLayer, 480, 480);
+    drawBuonAnno(&layerGfx);
+  } else {
+    // PSRAM insufficiente: solo la scritta, senza fuochi
+    Serial.println("[CAPODANNO] ERRORE: PSRAM insufficiente, effetto senza fuochi");
+    gfx->fillScreen(0x0000);
+    drawBuonAnno(gfx);
   }
 
-  // Disegna cerchio esterno
-  gfx->drawCircle(fw.x, fw.y, (int16_t)fw.radius, currentColor);
+  Serial.printf("[CAPODANNO] Modalità salvata: %d - Durata: %d secondi\n", savedMode, CAPODANNO_DURATION / 1000);
 }
 
-// Aggiorna tutti i fuochi d'artificio
-void updateFireworks() {
-  for (int i = 0; i < MAX_FIREWORKS; i++) {
-    if (fireworks[i].active) {
-      // Espandi il raggio
-      fireworks[i].radius += fireworks[i].speed;
-
-      // Disattiva se ha raggiunto il raggio massimo
-      if (fireworks[i].radius >= fireworks[i].maxRadius) {
-        fireworks[i].active = false;
-      }
+// Crea una nuova esplosione in posizione casuale: scintille radiali nel sistema di particelle
+void createFirework(ParticleSystem* ps) {
+  int16_t cx = particleRandRange(60, 420);                      // Posizione casuale (margine dai bordi)
+  int16_t cy = particleRandRange(60, 420);
+  int32_t maxRadius = particleRandRange(40, 100);                // Raggio massimo casuale
+  int32_t speed = particleRandRange(PART_ONE * 15 / 10, PART_ONE * 35 / 10);  // 1.5 - 3.5 pixel/frame (Q8)
+  uint16_t life = (uint16_t)(PART_PX(maxRadius) / speed);       // Frame per raggiungere il raggio massimo
+  uint16_t color = fireworkColors[particleRandRange(0, 9)];      // Colore casuale
+  int sparks = particleRandRange(FIREWORK_SPARKS_MIN, FIREWORK_SPARKS_MAX);
+  float step = 360.0f / sparks;
+
+  for (int i = 0; i < sparks; i++) {
+    int32_t dx, dy;
+    particleDirQ15(i * step, &dx, &dy);
+    // Velocità leggermente diversa per ogni scintilla: corona irregolare
+    int32_t v = speed * particleRandRange(85, 100) / 100;
+    uint8_t sprite = (i & 3) ? PART_SPRITE_STREAK : PART_SPRITE_PLUS;
+    if (particleSpawn(ps, PART_PX(cx), PART_PX(cy), (dx * v) >> 15, (dy * v) >> 15,
+                      life, color, sprite) < 0) {
+      break;  // Sistema pieno: l'esplosione resta parziale
     }
   }
 }
 
-// Disegna il testo "BUON ANNO" al centro
-void drawBuonAnno() {
+// Disegna il testo "BUON ANNO" al centro (sullo strato statico o direttamente a schermo)
+void drawBuonAnno(Arduino_GFX *target) {
   // Usa il font DS-Digital Bold per un effetto moderno
-  gfx->setFont(&DS_DIGIB20pt7b);
-  gfx->setTextColor(0xFFFF);  // Bianco
+  target->setFont(&DS_DIGIB20pt7b);
+  target->setTextColor(0xFFFF);  // Bianco
 
   // Calcola posizione centrata per "BUON"
   const char* buon = "BUON";
   int16_t x1, y1;
   uint16_t w, h;
-  gfx->getTextBounds(buon, 0, 0, &x1, &y1, &w, &h);
+  target->getTextBounds(buon, 0, 0, &x1, &y1, &w, &h);
   int16_t xBuon = (480 - w) / 2;
   int16_t yBuon = 200;
 
   // Disegna "BUON" con ombra
-  gfx->setTextColor(0x7BEF);  // Grigio per ombra
-  gfx->setCursor(xBuon + 2, yBuon + 2);
-  gfx->print(buon);
+  target->setTextColor(0x7BEF);  // Grigio per ombra
+  target->setCursor(xBuon + 2, yBuon + 2);
+  target->print(buon);
 
-  gfx->setTextColor(0xFFE0);  // Giallo brillante
-  gfx->setCursor(xBuon, yBuon);
-  gfx->print(buon);
+  target->setTextColor(0xFFE0);  // Giallo brillante
+  target->setCursor(xBuon, yBuon);
+  target->print(buon);
 
   // Calcola posizione centrata per "ANNO"
   const char* anno = "ANNO";
-  gfx->getTextBounds(anno, 0, 0, &x1, &y1, &w, &h);
+  target->getTextBounds(anno, 0, 0, &x1, &y1, &w, &h);
   int16_t xAnno = (480 - w) / 2;
   int16_t yAnno = 260;
 
   // Disegna "ANNO" con ombra
-  gfx->setTextColor(0x7BEF);  // Grigio per ombra
-  gfx->setCursor(xAnno + 2, yAnno + 2);
-  gfx->print(anno);
+  target->setTextColor(0x7BEF);  // Grigio per ombra
+  target->setCursor(xAnno + 2, yAnno + 2);
+  target->print(anno);
 
-  gfx->setTextColor(0xF81F);  // Magenta brillante
-  gfx->setCursor(xAnno, yAnno);
-  gfx->print(anno);
+  target->setTextColor(0xF81F);  // Magenta brillante
+  target->setCursor(xAnno, yAnno);
+  target->print(anno);
 
   // Anno corrente sotto in formato più piccolo
   char yearStr[10];
   sprintf(yearStr, "%d", myTZ.year());
 
-  gfx->setFont(&DS_DIGI20pt7b);
-  gfx->getTextBounds(yearStr, 0, 0, &x1, &y1, &w, &h);
+  target->setFont(&DS_DIGI20pt7b);
+  target->getTextBounds(yearStr, 0, 0, &x1, &y1, &w, &h);
   int16_t xYear = (480 - w) / 2;
   int16_t yYear = 320;
 
-  gfx->setTextColor(0x07FF);  // Cyan
-  gfx->setCursor(xYear, yYear);
-  gfx->print(yearStr);
+  target->setTextColor(0x07FF);  // Cyan
+  target->setCursor(xYear, yYear);
+  target->print(yearStr);
+}
+
+// Emettitore: crea nuovi fuochi d'artificio casualmente (più frequenti all'inizio)
+void capodannoEmit(ParticleSystem* ps, uint32_t now) {
+  // Usa percentuale invece di tempo fisso per adattarsi alla durata configurata
+  uint32_t elapsed = now - capodannoStartTime;
+  if (elapsed < CAPODANNO_DURATION / 4 * 3) {  // Primi 75% del tempo con fuochi frequenti
+    if (particleRandRange(0, 99) < 15) {        // 15% di probabilità ogni frame
+      createFirework(ps);
+    }
+  } else {                                      // Ultimi 25% del tempo con fuochi più rari
+    if (particleRandRange(0, 99) < 5) {         // 5% di probabilità
+      createFirework(ps);
+    }
+  }
 }
 
 // Loop principale dell'effetto Capodanno
@@ -204,6 +209,8 @@ void updateCapodanno() {
     capodannoTriggeredThisYear = false;
     Serial.println("[CAPODANNO] Flag reset - pronto per nuovo trigger");
 
+    releaseCapodannoBuffers();
+
     // Forza ridisegno completo dello schermo
     gfx->fillScreen(0x0000);
     forceDisplayUpdate();
@@ -212,36 +219,16 @@ void updateCapodanno() {
     return;
   }
 
-  // Pulisce lo schermo con dissolvenza (sfondo nero semi-trasparente)
-  // Invece di fillScreen, disegna un rettangolo semi-trasparente per effetto scia
-  for (int y = 0; y < 480; y += 10) {
-    for (int x = 0; x < 480; x += 10) {
-      gfx->drawPixel(x, y, 0x0000);
-    }
-  }
+  // Senza buffer la scritta è già a schermo e non ci sono fuochi
+  if (capodannoFrame == nullptr) return;
 
-  // Crea nuovi fuochi d'artificio casualmente (più frequenti all'inizio)
-  // Usa percentuale invece di tempo fisso per adattarsi alla durata configurata
-  float progress = (float)elapsed / CAPODANNO_DURATION;
-
-  if (progress < 0.75) {  // Primi 75% del tempo con fuochi frequenti
-    if (random(100) < 15) {  // 15% di probabilità ogni frame
-      createFirework();
-    }
-  } else {  // Ultimi 25% del tempo con fuochi più rari
-    if (random(100) < 5) {   // 5% di probabilità
-      createFirework();
-    }
-  }
-
-  // Aggiorna e disegna tutti i fuochi d'artificio
-  updateFireworks();
-  for (int i = 0; i < MAX_FIREWORKS; i++) {
-    drawFirework(fireworks[i]);
-  }
+  // Cancella le scintille del frame precedente ripristinando dallo strato statico
+  particleCanvasRestore(&capodannoCanvas);
 
-  // Disegna "BUON ANNO" sopra i fuochi
-  drawBuonAnno();
+  // Nuove esplosioni (emettitore), movimento e disegno delle scintille (la scritta è nello strato: resta sopra)
+  particleStep(&capodannoSparks, currentMillis);
+  particleRender(&capodannoSparks, &capodannoCanvas);
+  particleCanvasBlit(&capodannoCanvas);
 }
 
 // Controlla se è il momento di attivare l'effetto Capodanno
@@ -0,0 +1,329 @@
+// ================== RADAR LD2410 - TASK UART E PARSER FRAME ==================
+// Dopo setup_radar() (libreria MyLD2410 per configurazione ed enhanced mode) la UART1
+// passa al task radarUartTask sul core 0:
+//  - la callback onReceive della UART sveglia il task appena arrivano byte
+//  - un parser a stati consuma i byte uno alla volta (nessuna copia/scorrimento del
+//    buffer) e riconosce i frame dati F4F3F2F1 ... F8F7F6F5 (basic ed engineering)
+//    e i frame ACK FDFCFBFA ... 04030201 (scartati)
+//  - ogni frame valido aggiorna lo snapshot presenza/luce con i timestamp e lo storico
+//    energie per gate; il loop legge lo snapshot con radarGetSnapshot() senza toccare
+//    la UART
+//  - se non arrivano frame per RADAR_LINK_TIMEOUT_MS il collegamento e' perso e la
+//    riconnessione (radar.begin() + enhancedMode, bloccanti) avviene qui, non sul core
+//    del rendering
+//
+// Il protocollo LD2410 non ha CRC: gli errori contati sono di formato (lunghezza,
+// coda, marcatori 0xAA/0x55 del payload).
+
+// ===== Parametri =====
+#define RADAR_TASK_CORE         0
+#define RADAR_TASK_PRIORITY     2
+#define RADAR_TASK_STACK        4096
+#define RADAR_LINK_TIMEOUT_MS   3000     // Nessun frame valido: collegamento perso
+#define RADAR_RECONNECT_MS      10000    // Intervallo tentativi di riconnessione
+#define RADAR_FRAME_MAX         64       // Payload massimo (engineering = 35 byte)
+#define RADAR_HISTORY_LEN       20       // Frame di storico energie (~2s a 10 frame/s)
+
+// ===== Statistiche =====
+struct RadarUartStats {
+  uint32_t bytes;           // Byte ricevuti
+  uint32_t frames;          // Frame dati validi
+  uint32_t engFrames;       // di cui engineering
+  uint32_t ackFrames;       // Frame ACK (risposte comandi) scartati
+  uint32_t formatErrors;    // Lunghezza/coda/marcatori non validi
+  uint32_t skippedBytes;    // Byte scartati cercando l'intestazione
+  uint32_t reconnects;      // Riconnessioni riuscite
+  uint32_t reconnectFails;
+  uint32_t parseUsLast;     // Costo parsing dell'ultimo blocco di byte
+  uint32_t parseUsMax;
+  uint32_t parseUsTotal;    // Per la media per frame
+  uint16_t fps;             // Frame dati nell'ultimo secondo completo
+};
+RadarUartStats radarUartStats;
+
+// ===== Snapshot e storico (scritti dal task, letti sotto radarMux) =====
+static RadarSnapshot radarSnap;
+static uint8_t radarHistMoving[RADAR_HISTORY_LEN][RADAR_GATES];
+static uint8_t radarHistStill[RADAR_HISTORY_LEN][RADAR_GATES];
+static uint8_t radarHistPos = 0;
+static uint8_t radarHistCount = 0;
+static portMUX_TYPE radarMux = portMUX_INITIALIZER_UNLOCKED;
+static TaskHandle_t radarTaskHandle = nullptr;
+
+// ===== Parser a stati =====
+static const uint32_t RADAR_DATA_HEAD = 0xF4F3F2F1;   // Ultimi 4 byte letti, big-endian
+static const uint32_t RADAR_DATA_TAIL = 0xF8F7F6F5;
+static const uint32_t RADAR_ACK_HEAD  = 0xFDFCFBFA;
+static const uint32_t RADAR_ACK_TAIL  = 0x04030201;
+
+enum RadarParseState : uint8_t { RP_HEAD, RP_LEN, RP_BODY, RP_TAIL };
+
+struct RadarParser {
+  RadarParseState state;
+  bool     ack;                     // Frame in corso: ACK o dati
+  uint32_t shift;                   // Ultimi 4 byte (ricerca intestazione / verifica coda)
+  uint16_t len;
+  uint16_t pos;
+  uint32_t skipped;                 // Byte letti in RP_HEAD dall'ultimo frame
+  uint8_t  body[RADAR_FRAME_MAX];
+};
+static RadarParser radarParser;
+
+static inline uint16_t radarLe16(const uint8_t *p) {
+  return p[0] | (p[1] << 8);
+}
+
+// Decodifica il payload di un frame dati. false = formato non valido.
+static bool radarDecode(const uint8_t *b, uint16_t len, uint32_t nowMs) {
+  // type, 0xAA, stato, dist mov(2), en mov, dist ferma(2), en ferma, dist rilevamento(2) ... 0x55 0x00
+  if (len < 13 || b[1] != 0xAA || b[len - 2] != 0x55 || b[len - 1] != 0x00) return false;
+  bool eng = b[0] == 0x01;
+  if (!eng && b[0] != 0x02) return false;
+
+  RadarSnapshot s;
+  portENTER_CRITICAL(&radarMux);
+  s = radarSnap;
+  portEXIT_CRITICAL(&radarMux);
+
+  s.moving = b[2] & 0x01;
+  s.stationary = b[2] & 0x02;
+  s.movingDistCm = radarLe16(b + 3);
+  s.movingEnergy = b[5];
+  s.stationaryDistCm = radarLe16(b + 6);
+  s.stationaryEnergy = b[8];
+  s.detectDistCm = radarLe16(b + 9);
+  s.engineering = eng;
+
+  if (eng) {
+    // Gate massimi N/M, energie gate 0..N (movimento) e 0..M (fermo), luce, pin OUT
+    uint8_t nMov = b[11], nStill = b[12];
+    uint16_t movAt = 13, stillAt = movAt + nMov + 1, lightAt = stillAt + nStill + 1;
+    if (lightAt > len - 2 || nMov >= RADAR_GATES || nStill >= RADAR_GATES) return false;
+    for (uint8_t g = 0; g < RADAR_GATES; g++) {
+      s.gateMoving[g] = g <= nMov ? b[movAt + g] : 0;
+      s.gateStill[g] = g <= nStill ? b[stillAt + g] : 0;
+    }
+    if (lightAt < len - 2) s.light = b[lightAt];
+  }
+
+  s.frameMs = nowMs;
+  if (s.moving || s.stationary) s.presenceMs = nowMs;
+  s.link = true;
+
+  portENTER_CRITICAL(&radarMux);
+  radarSnap = s;
+  if (eng) {
+    memcpy(radarHistMoving[radarHistPos], s.gateMoving, RADAR_GATES);
+    memcpy(radarHistStill[radarHistPos], s.gateStill, RADAR_GATES);
+    radarHistPos = (radarHistPos + 1) % RADAR_HISTORY_LEN;
+    if (radarHistCount < RADAR_HISTORY_LEN) radarHistCount++;
+  }
+  portEXIT_CRITICAL(&radarMux);
+
+  if (eng) radarUartStats.engFrames++;
+  return true;
+}
+
+// Consuma un byte. Ritorna true quando chiude un frame dati valido.
+static bool radarParseByte(uint8_t c, uint32_t nowMs) {
+  RadarParser &p = radarParser;
+  p.shift = (p.shift << 8) | c;
+
+  switch (p.state) {
+    case RP_HEAD:
+      p.skipped++;
+      if (p.shift == RADAR_DATA_HEAD || p.shift == RADAR_ACK_HEAD) {
+        if (p.skipped > 4) radarUartStats.skippedBytes += p.skipped - 4;
+        p.skipped = 0;
+        p.ack = p.shift == RADAR_ACK_HEAD;
+        p.state = RP_LEN;
+        p.pos = 0;
+      }
+      return false;
+
+    case RP_LEN:
+      if (++p.pos < 2) return false;
+      p.len = (uint16_t)((p.shift & 0xFF) << 8) | ((p.shift >> 8) & 0xFF);   // Little-endian
+      if (p.len == 0 || p.len > RADAR_FRAME_MAX) {
+        radarUartStats.formatErrors++;
+        p.state = RP_HEAD;
+        return false;
+      }
+      p.pos = 0;
+      p.state = RP_BODY;
+      return false;
+
+    case RP_BODY:
+      p.body[p.pos++] = c;
+      if (p.pos == p.len) {
+        p.pos = 0;
+        p.state = RP_TAIL;
+      }
+      return false;
+
+    case RP_TAIL:
+      if (++p.pos < 4) return false;
+      p.state = RP_HEAD;
+      if (p.shift != (p.ack ? RADAR_ACK_TAIL : RADAR_DATA_TAIL)) {
+        radarUartStats.formatErrors++;
+        return false;
+      }
+      if (p.ack) {
+        radarUartStats.ackFrames++;
+        return false;
+      }
+      if (!radarDecode(p.body, p.len, nowMs)) {
+        radarUartStats.formatErrors++;
+        return false;
+      }
+      radarUartStats.frames++;
+      return true;
+  }
+  return false;
+}
+
+// ===== Task =====
+static void radarUartTask(void *) {
+  uint8_t  buf[128];
+  uint32_t lastReconnect = millis();
+  uint32_t fpsWindowMs = millis();
+  uint32_t fpsFrames = 0;
+
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RADAR_LINK_TIMEOUT_MS / 2));
+    uint32_t nowMs = millis();
+
+    int avail;
+    while ((avail = radarSerial.available()) > 0) {
+      size_t n = radarSerial.read(buf, min(avail, (int)sizeof(buf)));
+      uint32_t t0 = micros();
+      for (size_t i = 0; i < n; i++) {
+        if (radarParseByte(buf[i], nowMs)) fpsFrames++;
+      }
+      uint32_t dt = micros() - t0;
+      radarUartStats.bytes += n;
+      radarUartStats.parseUsLast = dt;
+      radarUartStats.parseUsTotal += dt;
+      if (dt > radarUartStats.parseUsMax) radarUartStats.parseUsMax = dt;
+    }
+
+    if (nowMs - fpsWindowMs >= 1000) {
+      radarUartStats.fps = fpsFrames * 1000 / (nowMs - fpsWindowMs);
+      fpsFrames = 0;
+      fpsWindowMs = nowMs;
+    }
+
+    // Collegamento: nessun frame valido da RADAR_LINK_TIMEOUT_MS
+    portENTER_CRITICAL(&radarMux);
+    bool wasLinked = radarSnap.link;
+    bool stale = nowMs - radarSnap.frameMs > RADAR_LINK_TIMEOUT_MS;
+    if (stale) radarSnap.link = false;
+    portEXIT_CRITICAL(&radarMux);
+    if (!stale) continue;
+    if (wasLinked) Serial.println("[RADAR] Nessun frame, collegamento perso");
+
+    // Riconnessione (bloccante, su questo task): la libreria usa la UART in esclusiva
+    if (nowMs - lastReconnect < RADAR_RECONNECT_MS) continue;
+    lastReconnect = nowMs;
+    if (radar.begin()) {
+      radar.enhancedMode(true);
+      radarUartStats.reconnects++;
+      radarParser.state = RP_HEAD;
+      Serial.println("[RADAR] Riconnesso OK");
+    } else {
+      radarUartStats.reconnectFails++;
+      // Stampa solo al primo fallimento, poi ogni 6 tentativi (~60 sec)
+      if (radarUartStats.reconnectFails == 1 || radarUartStats.reconnectFails % 6 == 0) {
+        Serial.printf("[RADAR] Non connesso (tentativo %lu)\n", (unsigned long)radarUartStats.reconnectFails);
+      }
+    }
+  }
+}
+
+// Da chiamare a fine setup_radar() con radar configurato (enhanced mode attivo)
+void radarUartBegin() {
+  if (radarTaskHandle) return;
+  uint32_t now = millis();
+  radarSnap.frameMs = now;      // Il link parte valido: il primo frame arriva entro ~100ms
+  radarSnap.presenceMs = now;
+  radarSnap.link = true;
+  radarSnap.light = radar.getLightLevel();
+  radarParser.state = RP_HEAD;
+
+  xTaskCreatePinnedToCore(radarUartTask, "radarUart", RADAR_TASK_STACK, nullptr,
+                          RADAR_TASK_PRIORITY, &radarTaskHandle, RADAR_TASK_CORE);
+  radarSerial.onReceive([]() {
+    if (radarTaskHandle) xTaskNotifyGive(radarTaskHandle);
+  });
+  Serial.printf("[RADAR] Task UART avviato (core %d)\n", RADAR_TASK_CORE);
+}
+
+// Copia lo snapshot corrente. false se il task non e' attivo.
+bool radarGetSnapshot(RadarSnapshot &snap) {
+  if (!radarTaskHandle) return false;
+  portENTER_CRITICAL(&radarMux);
+  snap = radarSnap;
+  portEXIT_CRITICAL(&radarMux);
+  return true;
+}
+
+// ===== Stato per /radar/status =====
+String getRadarUartJson() {
+  RadarSnapshot s;
+  uint16_t avgMov[RADAR_GATES] = {0}, avgStill[RADAR_GATES] = {0};
+  uint8_t peakMov[RADAR_GATES] = {0}, peakStill[RADAR_GATES] = {0};
+
+  portENTER_CRITICAL(&radarMux);
+  s = radarSnap;
+  uint8_t count = radarHistCount;
+  for (uint8_t i = 0; i < count; i++) {
+    for (uint8_t g = 0; g < RADAR_GATES; g++) {
+      avgMov[g] += radarHistMoving[i][g];
+      avgStill[g] += radarHistStill[i][g];
+      if (radarHistMoving[i][g] > peakMov[g]) peakMov[g] = radarHistMoving[i][g];
+      if (radarHistStill[i][g] > peakStill[g]) peakStill[g] = radarHistStill[i][g];
+    }
+  }
+  portEXIT_CRITICAL(&radarMux);
+
+  const RadarUartStats &st = radarUartStats;
+  uint32_t now = millis();
+  String json = "{";
+  json += "\"running\":" + String(radarTaskHandle ? "true" : "false") + ",";
+  json += "\"link\":" + String(s.link ? "true" : "false") + ",";
+  json += "\"engineering\":" + String(s.engineering ? "true" : "false") + ",";
+  json += "\"moving\":" + String(s.moving ? "true" : "false") + ",";
+  json += "\"stationary\":" + String(s.stationary ? "true" : "false") + ",";
+  json += "\"movingDistCm\":" + String(s.movingDistCm) + ",";
+  json += "\"movingEnergy\":" + String(s.movingEnergy) + ",";
+  json += "\"stationaryDistCm\":" + String(s.stationaryDistCm) + ",";
+  json += "\"stationaryEnergy\":" + String(s.stationaryEnergy) + ",";
+  json += "\"detectDistCm\":" + String(s.detectDistCm) + ",";
+  json += "\"light\":" + String(s.light) + ",";
+  json += "\"frameAgeMs\":" + String(now - s.frameMs) + ",";
+  json += "\"presenceAgeMs\":" + String(now - s.presenceMs) + ",";
+  json += "\"fps\":" + String(st.fps) + ",";
+  json += "\"bytes\":" + String(st.bytes) + ",";
+  json += "\"frames\":" + String(st.frames) + ",";
+  json += "\"engFrames\":" + String(st.engFrames) + ",";
+  json += "\"ackFrames\":" + String(st.ackFrames) + ",";
+  json += "\"formatErrors\":" + String(st.formatErrors) + ",";
+  json += "\"skippedBytes\":" + String(st.skippedBytes) + ",";
+  json += "\"reconnects\":" + String(st.reconnects) + ",";
+  json += "\"reconnectFails\":" + String(st.reconnectFails) + ",";
+  json += "\"parseUsLast\":" + String(st.parseUsLast) + ",";
+  json += "\"parseUsMax\":" + String(st.parseUsMax) + ",";
+  json += "\"parseUsPerFrame\":" + String(st.frames ? (float)st.parseUsTotal / st.frames : 0.0f, 2) + ",";
+  json += "\"gates\":[";
+  for (uint8_t g = 0; g < RADAR_GATES; g++) {
+    if (g) json += ",";
+    json += "{\"m\":" + String(s.gateMoving[g]);
+    json += ",\"s\":" + String(s.gateStill[g]);
+    json += ",\"mAvg\":" + String(count ? avgMov[g] / count : 0);
+    json += ",\"mPeak\":" + String(peakMov[g]);
+    json += ",\"sAvg\":" + String(count ? avgStill[g] / count : 0);
+    json += ",\"sPeak\":" + String(peakStill[g]) + "}";
+  }
+  json += "]}";
+  return json;
+}
@@ -88,7 +88,7 @@ void saveRadarServerConfig() {
   // Scrivi marker di validità
   EEPROM.write(EEPROM_RADAR_SERVER_VALID, EEPROM_RADAR_SERVER_VALID_VALUE);
 
-  bool ok = EEPROM.commit();
+  bool ok = settingsFlush();
   Serial.printf("[RADAR REMOTE] EEPROM.commit() = %s\n", ok ? "OK" : "ERRORE");
 
   // Verifica lettura
@@ -183,15 +183,9 @@ bool registerOnRadarServer() {
         radarRemoteBrightness = constrain(briVal, 0, 255);
         Serial.printf("[RADAR REMOTE] Luminosita: %d\n", radarRemoteBrightness);
 
-        if (radarBrightnessControl && radarRemotePresence) {
-          uint8_t mappedBrightness = map(radarRemoteBrightness, 0, 255, radarBrightnessMin, radarBrightnessMax);
-          ledcWrite(PWM_CHANNEL, mappedBrightness);
-          lastAppliedBrightness = mappedBrightness;
-        } else if (!radarRemotePresence) {
-          // Nessuna presenza - forza display spento
-          ledcWrite(PWM_CHANNEL, 0);
-          lastAppliedBrightness = 0;
-        }
+        // Presenza e luce diventano ingressi del controller luminosità (0_BACKLIGHT.ino)
+        backlightFeedLight(BL_SRC_REMOTE, radarRemoteBrightness);
+        backlightRequestUpdate(BL_RAMP_WAKE_MS);
       }
     }
 
@@ -276,27 +270,10 @@ void handleRadarPresence(AsyncWebServerRequest *request) {
 
     Serial.printf("[RADAR REMOTE] Presenza: %s\n", newPresence ? "SI" : "NO");
 
-    // Applica effetto sul display
-    if (newPresence) {
-      // Presenza rilevata - riaccendi display
-      if (radarBrightnessControl) {
-        uint8_t wakeupBrightness = map(radarRemoteBrightness, 0, 255, radarBrightnessMin, radarBrightnessMax);
-        ledcWrite(PWM_CHANNEL, wakeupBrightness);
-        lastAppliedBrightness = wakeupBrightness;
-        Serial.printf("[RADAR REMOTE] Display ON - Lum: %d\n", wakeupBrightness);
-      } else {
-        // Usa luminosità manuale giorno/notte
-        uint8_t wakeupBrightness = checkIsNightTime(currentHour, currentMinute) ? brightnessNight : brightnessDay;
-        ledcWrite(PWM_CHANNEL, wakeupBrightness);
-        lastAppliedBrightness = wakeupBrightness;
-        Serial.printf("[RADAR REMOTE] Display ON - Lum manuale: %d\n", wakeupBrightness);
-      }
-    } else {
-      // Nessuna presenza - spegni display (radar server ha priorità)
-      ledcWrite(PWM_CHANNEL, 0);
-      lastAppliedBrightness = 0;
-      Serial.println("[RADAR REMOTE] Display OFF - Nessuna presenza");
-    }
+    // Applica effetto sul display: il loop ricalcola la luminosità (luce remota o
+    // giorno/notte con presenza, spento senza presenza - radar server ha priorità)
+    backlightRequestUpdate(BL_RAMP_WAKE_MS);
+    Serial.println(newPresence ? "[RADAR REMOTE] Display ON" : "[RADAR REMOTE] Display OFF - Nessuna presenza");
 
     request->send(200, "application/json", "{\"status\":\"ok\"}");
   } else {
@@ -314,14 +291,11 @@ void handleRadarBrightness(AsyncWebServerRequest *request) {
     radarServerConnected = true;
     lastRadarRemoteUpdate = millis();
 
-    // Applica luminosità SEMPRE se c'è presenza (più reattivo)
-    if (radarRemotePresence) {
-      // Mappa 0-255 -> radarBrightnessMin-radarBrightnessMax
-      uint8_t mappedBrightness = map(value, 0, 255, radarBrightnessMin, radarBrightnessMax);
-      ledcWrite(PWM_CHANNEL, mappedBrightness);
-      lastAppliedBrightness = mappedBrightness;
-      Serial.printf("[RADAR REMOTE] Luce RAW=%d -> PWM=%d\n", value, mappedBrightness);
-    }
+    // Luce remota come ingresso del controller: isteresi, curva percettiva e rampa
+    // (applicata dal loop solo se c'è presenza)
+    backlightFeedLight(BL_SRC_REMOTE, value);
+    backlightRequestUpdate(BL_RAMP_LIGHT_MS);
+    Serial.printf("[RADAR REMOTE] Luce RAW=%d -> PWM=%d\n", value, backlightMapLight(backlightLight(BL_SRC_REMOTE)));
 
     request->send(200, "application/json", "{\"status\":\"ok\"}");
   } else {
@@ -404,14 +378,17 @@ void handleRadarStatus(AsyncWebServerRequest *request) {
   json += "\"local\":{";
   json += "\"available\":" + String(radarAvailable ? "true" : "false") + ",";
   json += "\"presence\":" + String(presenceDetected ? "true" : "false") + ",";
-  json += "\"lightLevel\":" + String(lastRadarLightLevel);
+  json += "\"lightLevel\":" + String(lastRadarLightLevel) + ",";
+  // Task UART: snapshot, storico energie per gate, frame/s, errori di formato, costo parsing
+  json += "\"uart\":" + getRadarUartJson();
   json += "},";
   // Stato attivo
   json += "\"usingRemote\":" + String(usingRemote ? "true" : "false") + ",";
   json += "\"radarBrightnessControl\":" + String(radarBrightnessControl ? "true" : "false") + ",";
   json += "\"radarBrightnessMin\":" + String(radarBrightnessMin) + ",";
   json += "\"radarBrightnessMax\":" + String(radarBrightnessMax) + ",";
-  json += "\"currentBrightness\":" + String(lastAppliedBrightness);
+  json += "\"currentBrightness\":" + String(lastAppliedBrightness) + ",";
+  json += "\"backlight\":" + getBacklightJson();
   json += "}";
 
   request->send(200, "application/json", json);
@@ -652,9 +629,8 @@ void handleRadarOff(AsyncWebServerRequest *request) {
   radarServerConnected = true;
   lastRadarRemoteUpdate = millis();
 
-  // Spegni display
-  ledcWrite(PWM_CHANNEL, 0);
-  lastAppliedBrightness = 0;
+  // Spegni display (rampa gestita dal controller nel loop)
+  backlightRequestUpdate(BL_RAMP_WAKE_MS);
 
   Serial.println("[RADAR REMOTE] CMD OFF ricevuto - Display OFF");
   request->send(200, "application/json", "{\"status\":\"ok\",\"display\":\"off\"}");
@@ -666,17 +642,10 @@ void handleRadarOn(AsyncWebServerRequest *request) {
   radarServerConnected = true;
   lastRadarRemoteUpdate = millis();
 
-  // Riaccendi display
-  uint8_t wakeupBrightness;
-  if (radarBrightnessControl) {
-    wakeupBrightness = map(radarRemoteBrightness, 0, 255, radarBrightnessMin, radarBrightnessMax);
-  } else {
-    wakeupBrightness = checkIsNightTime(currentHour, currentMinute) ? brightnessNight : brightnessDay;
-  }
-  ledcWrite(PWM_CHANNEL, wakeupBrightness);
-  lastAppliedBrightness = wakeupBrightness;
+  // Riaccendi display (luce remota o giorno/notte, rampa breve dal loop)
+  backlightRequestUpdate(BL_RAMP_WAKE_MS);
 
-  Serial.printf("[RADAR REMOTE] CMD ON ricevuto - Display ON lum:%d\n", wakeupBrightness);
+  Serial.println("[RADAR REMOTE] CMD ON ricevuto - Display ON");
   request->send(200, "application/json", "{\"status\":\"ok\",\"display\":\"on\"}");
 }
 
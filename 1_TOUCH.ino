@@ -42,6 +42,76 @@ extern int  newsGetTappedArticle(int tapY);
 extern void newsOpenArticle(int index);
 #endif
 
+// ====================== EVENTI TOUCH (1_TOUCH_INPUT.ino) ======================
+// Gestore eventi per modalita': chi ne ha uno riceve il tocco solo come eventi e
+// checkButtons() non fa polling per lei.
+static TouchModeHandler touchModeHandlerFor(uint8_t mode) {
+  switch (mode) {
+#ifdef EFFECT_PONG
+    case MODE_PONG:     return handlePongTouchEvent;
+#endif
+#ifdef EFFECT_BREAKOUT
+    case MODE_BREAKOUT: return handleBreakoutTouchEvent;
+#endif
+#ifdef EFFECT_ARCADE
+    case MODE_ARCADE:   return handleArcadeTouchEvent;
+#endif
+#ifdef EFFECT_NEWS
+    case MODE_NEWS:     return handleNewsTouchEvent;
+#endif
+    default:            return nullptr;
+  }
+}
+
+// Pagine in primo piano (allarmi, setup, selettore, reset WiFi): gestite dal polling
+static bool touchOverlayActive() {
+  if (resetCountdownStarted || setupPageActive || modeSelectorActive) return true;
+#ifdef EFFECT_BTTF
+  if (bttfAlarmSetupActive || bttfAlarmRinging) return true;
+#endif
+#ifdef EFFECT_CALENDAR
+  if (calendarAlarmActive) return true;
+#endif
+  return false;
+}
+
+// Gesture di sistema, prima del gestore della modalita'. Ritorna true se l'evento e' consumato.
+static bool touchSystemGesture(const TouchEvent &ev) {
+#ifdef EFFECT_BTTF
+  // BTTF, centro (190-290): tap = annuncio ora, long press = pagina setup sveglie
+  if (currentMode == MODE_BTTF && ev.x >= 190 && ev.x <= 290 && ev.y >= 190 && ev.y <= 290) {
+    if (ev.type == TOUCH_EV_LONG_PRESS) {
+      Serial.println("[BTTF] Long press centro - apro pagina setup sveglie");
+      showBTTFAlarmSetup();
+      return true;
+    }
+    if (ev.type == TOUCH_EV_TAP) {
+      playTouchSound();
+      // NON cancelliamo il display - forceDisplayUpdate() gestisce il ridisegno
+      if (hourlyAnnounceEnabled) announceTimeFixed();
+      delay(1000);
+      forceDisplayUpdate();
+      return true;
+    }
+  }
+#endif
+#ifdef MENU_SCROLL
+  // Fascia alta (y<50): trascinamento di 100px verso il basso = pagina setup,
+  // tap nella meta' sinistra = cambio modo. Tutto il gesto appartiene al sistema.
+  if (ev.y - ev.dy < 50) {
+    if (ev.type == TOUCH_EV_DRAG_MOVE && ev.dy > 100) {
+      showSetupPage();
+      playTouchSound();
+    } else if (ev.type == TOUCH_EV_TAP && ev.x - ev.dx < 240) {
+      playTouchSound();
+      handleModeChange();
+    }
+    return ev.type != TOUCH_EV_RELEASE;   // Il rilascio arriva comunque alla modalita'
+  }
+#endif
+  return false;
+}
+
 void checkButtons() {
   TFT_SYNC_SLOW();  // Touch panel gamma refresh
   // Compensazione offset touch per drift gamma pannello
@@ -50,70 +120,95 @@ void checkButtons() {
   // Variabili statiche per mantenere lo stato tra le diverse chiamate a questa funzione.
   static bool waitingForRelease = false; // Flag che indica se stiamo aspettando che il tocco venga rilasciato.
   static uint32_t touchStartTime = 0;    // Memorizza il timestamp dell'inizio di un tocco prolungato (es. per il reset WiFi).
-  static int16_t scrollStartY = -1;     // Memorizza la coordinata Y iniziale di un potenziale scroll nella pagina di setup.
-  static int16_t scrollStartX = -1;     // Memorizza la coordinata X per distinguere tap da scroll.
-  static bool checkingSetupScroll = false; // Flag che indica se stiamo attualmente rilevando un gesto di scroll per aprire il setup.
-  static uint32_t lastCornerCheck = 0;   // Memorizza il timestamp dell'ultimo controllo degli angoli per il reset WiFi.
-  static uint8_t cornerTouchLostCounter = 0; // Contatore per tenere traccia di quanti controlli consecutivi degli angoli non hanno rilevato tutti e quattro.
   static uint8_t touchSampleCounter = 0;   // Contatore per gestire la frequenza di campionamento del touch durante l'antirimbalzo.
 
-  // ======= VARIABILI PER SWIPE SCROLL NEWS =======
-  #ifdef EFFECT_NEWS
-  static bool newsSwipeActive = false;
-  static int  newsSwipeStartY = 0;
-  static bool newsSwipeScrolled = false;
-  #endif
-
-  // ======= VARIABILI PER TRACKING CONTINUO PONG =======
-  #ifdef EFFECT_PONG
-  static bool pongTrackingActive = false;
-  #endif
-  // ======= VARIABILI PER TRACKING CONTINUO BREAKOUT =======
-  #ifdef EFFECT_BREAKOUT
-  static bool breakoutTrackingActive = false;
-  #endif
+  uint32_t currentMillis = millis();      // Ottiene il tempo attuale in millisecondi.
 
-  // ======= VARIABILI PER TRACKING CONTINUO ARCADE =======
-  #ifdef EFFECT_ARCADE
-  static bool arcadeTrackingActive = false;
-  #endif
+  // ====================== EVENTI GESTURE (1_TOUCH_INPUT.ino) ======================
+  // La coda viene svuotata ad ogni chiamata, prima di qualsiasi return.
+  // I 4 angoli per il reset WiFi arrivano come eventi: CORNERS_START avvia il countdown,
+  // CORNERS_LOST lo annulla, CORNERS_HOLD (5s) esegue il reset. Gli altri eventi passano
+  // prima dalle gesture di sistema (touchSystemGesture) e poi al gestore della modalita'
+  // (touchModeHandlerFor); con una pagina in primo piano restano al polling qui sotto.
+  TouchEvent touchEv;
+  while (touchPollEvent(touchEv)) {
+    switch (touchEv.type) {
+      case TOUCH_EV_CORNERS_START: {
+        bool cornersAllowed = !resetCountdownStarted && !setupPageActive && !modeSelectorActive;
+        #ifdef EFFECT_BTTF
+        cornersAllowed = cornersAllowed && !bttfAlarmSetupActive;
+        #endif
+        #ifdef EFFECT_CALENDAR
+        cornersAllowed = cornersAllowed && !calendarAlarmActive;
+        #endif
+        if (!cornersAllowed) break;
+
+        resetCountdownStarted = true;   // Avvia il countdown per il reset.
+        touchStartTime = currentMillis;  // Memorizza il tempo di inizio.
+
+        // Fornisce un feedback visivo iniziale all'utente.
+        gfx->fillScreen(YELLOW);
+        gfx->setTextColor(BLACK);
+        gfx->setCursor(80, 180);
+        gfx->println(F("RESET WIFI TRA"));
+        gfx->setCursor(210, 240);
+        gfx->println(F("5 SEC"));
+        gfx->setCursor(40, 300);
+        gfx->println(F("RILASCIA PER ANNULLARE"));
 
-  // ======= VARIABILI PER LONG PRESS BTTF ALARM SETUP =======
-  static bool bttfLongPressActive = false;      // True se stiamo monitorando un long press centrale in BTTF
-  static uint32_t bttfCenterTouchStart = 0;     // Timestamp inizio tocco centrale
-  static bool bttfLongPressTriggered = false;   // True se abbiamo già triggerato il long press
+        waitingForRelease = true; // Imposta il flag per aspettare il rilascio (anche se non necessario per l'avvio).
+        break;
+      }
 
-  uint32_t currentMillis = millis();      // Ottiene il tempo attuale in millisecondi.
+      case TOUCH_EV_CORNERS_LOST:
+        // Angoli rilasciati prima dei 5 secondi: annulla la sequenza di reset.
+        if (!resetCountdownStarted) break;
+        resetCountdownStarted = false;
 
+        gfx->fillScreen(BLACK);
+        gfx->setTextColor(RED);
+        gfx->setCursor(80, 240);
+        gfx->println(F("RESET WIFI ANNULLATO"));
+        delay(1000);
 
-  // ====================== GESTIONE RILASCIO TOUCH ======================
+        gfx->fillScreen(BLACK);
+        break;
 
-  // Reset long press BTTF se non toccato (con lettura fresh del touch)
-  #ifdef EFFECT_BTTF
-  if (bttfLongPressActive) {
-    ts.read();  // Lettura fresh per rilevare rilascio
-    if (!ts.isTouched) {
-      // Rilascio prima di 2 secondi in modalità BTTF = tocco breve = annuncia ora
-      if (!bttfLongPressTriggered && currentMode == MODE_BTTF && !bttfAlarmSetupActive) {
-        Serial.println("[BTTF] Rilascio prima di 2 sec - annuncio ora");
-        playTouchSound();
-        // NON cancelliamo il display - forceDisplayUpdate() gestisce il ridisegno
-        // Annuncia ora solo se annuncio orario abilitato
-        if (hourlyAnnounceEnabled) {
-          announceTimeFixed();
+      case TOUCH_EV_CORNERS_HOLD:
+        if (!resetCountdownStarted) break;
+        resetCountdownStarted = false;
+        // Esegui la funzione per resettare le impostazioni WiFi.
+        resetWiFiSettings();
+        break;
+
+      default: {
+        if (touchOverlayActive()) {
+          touchEventUnhandled();
+          break;
         }
-        delay(1000);
-        forceDisplayUpdate();
+        touchModeHandler = touchModeHandlerFor(currentMode);  // Il modo puo' cambiare tra due eventi
+        bool handled = touchSystemGesture(touchEv);
+        if (!handled && touchModeHandler) {
+          touchModeHandler(touchEv);
+          handled = true;
+        }
+        if (!handled) {
+          touchEventUnhandled();
+          break;
+        }
+        // Il resto del tocco non deve arrivare anche al polling (es. quadranti del modo successivo)
+        waitingForRelease = true;
+        break;
       }
-      bttfLongPressActive = false;
-      bttfLongPressTriggered = false;
     }
   }
-  #endif
+
+
+  // ====================== GESTIONE RILASCIO TOUCH ======================
 
   if(waitingForRelease){
-    ts.read(); // Legge lo stato attuale del touch screen.
-    if (!ts.isTouched) { // Se il touch screen NON è più toccato (rilascio).
+    touchRead(); // Legge lo stato attuale del touch screen.
+    if (!touchState.isTouched) { // Se il touch screen NON è più toccato (rilascio).
       waitingForRelease = false; // Resetta il flag di attesa del rilascio.
 
       if (colorCycle.isActive) {      // FINE CICLAGGIO COLORI???
@@ -132,7 +227,7 @@ void checkButtons() {
         saveModeColor((uint8_t)currentMode, currentColor.r, currentColor.g, currentColor.b);
         saveModePreset((uint8_t)currentMode, 13);  // 13 = Personalizzato
 
-        EEPROM.commit(); // Scrive i dati dalla cache della EEPROM alla memoria fisica.
+        settingsCommit(); // Salva in flash (commit differito, una sola scrittura per raffica di tocchi).
 
 
         // Emette un breve suono di conferma al rilascio del tocco.
@@ -149,131 +244,27 @@ void checkButtons() {
   static uint32_t lastTouchCheckTime = 0; // Memorizza l'ultimo timestamp in cui è stato controllato il touch.
   touchSampleCounter++; // Incrementa il contatore di campionamento del touch.
 
-  // Implementa un antirimbalzo riducendo la frequenza di polling del touch screen.
+  // Implementa un antirimbalzo riducendo la frequenza di gestione del touch.
   if (currentMillis - lastTouchCheckTime < 50) {
-    // Riduce la frequenza di polling ma non la salta completamente.
-    if (touchSampleCounter % 3 != 0) {  // Esegue una lettura periodica (ogni 3 campioni) anche durante l'antirimbalzo.
-      if (resetCountdownStarted && currentMillis - lastCornerCheck > 200) {
-        lastCornerCheck = currentMillis;
-        // Se è iniziato il countdown per il reset WiFi, continua a controllare gli angoli.
-        ts.read();
-      } else {
-        return; // Se non è in corso il reset WiFi, esce dalla funzione per evitare letture troppo frequenti.
-      }
+    // Riduce la frequenza ma non la salta completamente (ogni 3 campioni); durante il
+    // countdown del reset WiFi il display del countdown va aggiornato ad ogni chiamata.
+    if (touchSampleCounter % 3 != 0 && !resetCountdownStarted) {
+      return;
     }
   }
   lastTouchCheckTime = currentMillis; // Aggiorna il timestamp dell'ultimo controllo del touch.
 
   // ====================== LETTURA TOUCH ======================
-  uint8_t readAttempts = 0;   // Contatore per il numero di tentativi di lettura del touch.
-  bool touchDetected = false; // Flag per indicare se un tocco è stato rilevato.
-
-  // Tenta di leggere lo stato del touch screen fino a 3 volte se non viene rilevato un tocco.
-  while (readAttempts < 3 && !touchDetected) {
-    ts.read(); // Legge lo stato del touch screen.
-    if (ts.isTouched) {
-      touchDetected = true; // Imposta il flag se viene rilevato un tocco.
-    } else {
-      readAttempts++;     // Incrementa il contatore dei tentativi.
-      delay(10);          // Piccolo ritardo tra un tentativo e l'altro.
-    }
-  }
-
-  // ====================== SWIPE SCROLL NEWS ======================
-  #ifdef EFFECT_NEWS
-  // Reset swipe tracking quando il dito viene sollevato
-  if (newsSwipeActive && !touchDetected) {
-    // Se non ha scrollato, era un tap: apri articolo nel browser
-    if (!newsSwipeScrolled) {
-      int article = newsGetTappedArticle(newsSwipeStartY);
-      if (article >= 0) {
-        playTouchSound();
-        newsOpenArticle(article);
-      }
-    }
-    newsSwipeActive = false;
-    newsSwipeScrolled = false;
-  }
-  // Tracking continuo swipe: calcola delta Y e scrolla di 1 articolo
-  if (newsSwipeActive && touchDetected) {
-    int sy = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
-    int deltaY = newsSwipeStartY - sy;
-    if (deltaY >= 40) {
-      newsScrollDown();   // Dito sale = articoli successivi
-      newsSwipeStartY = sy;
-      newsSwipeScrolled = true;
-    } else if (deltaY <= -40) {
-      newsScrollUp();     // Dito scende = articoli precedenti
-      newsSwipeStartY = sy;
-      newsSwipeScrolled = true;
-    }
-    return;
-  }
-  #endif
-
-  // ====================== TRACKING CONTINUO PONG (racchetta segue dito) ======================
-  #ifdef EFFECT_PONG
-  // Reset tracking quando il dito viene sollevato
-  if (pongTrackingActive && !touchDetected) {
-    pongTrackingActive = false;
-  }
-  // Tracking continuo: aggiorna posizione racchetta ad ogni frame
-  if (pongTrackingActive && touchDetected && currentMode == MODE_PONG) {
-    int px = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-    int py = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
-    #ifdef EFFECT_DUAL_DISPLAY
-    if (isDualSlave()) {
-      forwardTouchToMaster(px, py, 0);
-    } else {
-      handlePongTouch(px, py);
-    }
-    #else
-    handlePongTouch(px, py);
-    #endif
-    return;
-  }
-  #endif
-
-  // ====================== TRACKING CONTINUO BREAKOUT (paddle segue dito) ======================
-  #ifdef EFFECT_BREAKOUT
-  if (breakoutTrackingActive && !touchDetected) {
-    breakoutTrackingActive = false;
-  }
-  if (breakoutTrackingActive && touchDetected && currentMode == MODE_BREAKOUT) {
-    int px = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-    int py = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
-    #ifdef EFFECT_DUAL_DISPLAY
-    if (isDualSlave()) {
-      forwardTouchToMaster(px, py, 0);
-    } else {
-      handleBreakoutTouch(px, py);
-    }
-    #else
-    handleBreakoutTouch(px, py);
-    #endif
-    return;
-  }
-  #endif
-
-  // ====================== TRACKING CONTINUO ARCADE (D-pad segue dito) ======================
-  #ifdef EFFECT_ARCADE
-  if (arcadeTrackingActive && !touchDetected) {
-    arcadeTrackingActive = false;
-    arcadeClearTouchInput();
-  }
-  if (arcadeTrackingActive && touchDetected && currentMode == MODE_ARCADE) {
-    int px = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-    int py = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
-    arcadeUpdateTouchInput(px, py);
-    return;
-  }
-  #endif
+  // Ultimo campione del task di input: nessuna transazione I2C qui. Il rilascio e' gia'
+  // confermato dal task (campioni vuoti consecutivi), quindi non servono piu' i 3 tentativi.
+  touchRead();
+  bool touchDetected = touchState.isTouched; // Flag per indicare se un tocco è stato rilevato.
 
   // ====================== STOP/SNOOZE ALLARME CALENDARIO ======================
   #ifdef EFFECT_CALENDAR
   if (touchDetected && calendarAlarmActive) {
-    int cx = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-    int cy = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
+    int cx = map(touchState.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
+    int cy = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
     // Pulsante STOP: x=20-230, y=370-450
     if (cx >= 20 && cx <= 230 && cy >= 370 && cy <= 450) {
       stopCalendarAlarm();
@@ -300,15 +291,15 @@ void checkButtons() {
   // Nella pagina setup: SX=precedente, CENTRO=modifica, DX=successivo
   // Per uscire: navigare fino a SALVA ESCI e toccare centro
   if (bttfAlarmSetupActive) {
-    if (ts.isTouched && !waitingForRelease) {
-      int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
-      int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
+    if (touchState.isTouched && !waitingForRelease) {
+      int x = map(touchState.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
+      int y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
 
       // Tutti i tocchi nella pagina setup passano a handleBTTFAlarmSetupTouch
       // che gestisce: SX (<160) = prev, CENTRO (160-320) = modifica, DX (>320) = next
       handleBTTFAlarmSetupTouch(x, y);
       waitingForRelease = true;
-    } else if (!ts.isTouched) {
+    } else if (!touchState.isTouched) {
       waitingForRelease = false;
     }
     return;  // Quando setup sveglie è attivo, ignora tutto il resto
@@ -316,106 +307,29 @@ void checkButtons() {
   #endif
 
   // ====================== GESTIONE RESET WIFI ======================
+  // Avvio, annullamento ed esecuzione arrivano dagli eventi CORNERS_* (inizio funzione):
+  // qui resta solo il countdown a video.
   if (resetCountdownStarted) { // Se è stata avviata la sequenza di reset del WiFi (pressione dei 4 angoli).
     // Calcola il tempo trascorso dall'inizio della pressione.
     uint32_t elapsedTime = currentMillis - touchStartTime;
 
-    // Variabili per tenere traccia se ogni angolo è ancora premuto.
-    bool tl = false, tr = false, bl = false, br = false;
-    bool anyCornerDetected = false; // Flag per indicare se è stato rilevato il tocco in almeno un angolo.
-
-    // Itera attraverso i punti di contatto rilevati.
-    for (int i = 0; i < ts.touches && i < 10; i++) {
-      // Mappa le coordinate del touch screen alle coordinate del display.
-      int x = map(ts.points[i].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
-      int y = map(ts.points[i].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
-
-      // Verifica se il punto di contatto rientra in una delle zone degli angoli (con una tolleranza).
-      if (x < 100 && y < 100) {
-        tl = true;
-        anyCornerDetected = true;
-      }
-      else if (x > 380 && y < 100) {
-        tr = true;
-        anyCornerDetected = true;
-      }
-      else if (x < 100 && y > 380) {
-        bl = true;
-        anyCornerDetected = true;
-      }
-      else if (x > 380 && y > 380) {
-        br = true;
-        anyCornerDetected = true;
-      }
-    }
-
-    bool allCornersPressed = (tl && tr && bl && br); // Vero se tutti e quattro gli angoli sono premuti.
-
-    // Se tutti gli angoli sono ancora premuti, resetta il contatore di perdita del tocco.
-    if (allCornersPressed) {
-      cornerTouchLostCounter = 0;
-
-      // Aggiorna la visualizzazione del countdown ogni secondo.
-      static int lastSecondDisplayed = -1;
-      int currentSecond = 5 - (elapsedTime / 1000); // Calcola i secondi rimanenti.
-
-      if (currentSecond != lastSecondDisplayed) {
-        gfx->fillScreen(YELLOW);
-        gfx->setTextColor(BLACK);
-        gfx->setCursor(80, 180);
-        gfx->println(F("RESET WIFI TRA"));
-        gfx->setCursor(210, 240);
-        gfx->print(currentSecond);
-        gfx->println(F(" SEC"));
-        gfx->setCursor(40, 300);
-        gfx->println(F("RILASCIA PER ANNULLARE"));
-
-        lastSecondDisplayed = currentSecond; // Aggiorna l'ultimo secondo visualizzato.
-      }
-    }
-    // Se non tutti gli angoli sono premuti, ma ne è rilevato almeno uno.
-    else if (anyCornerDetected) {
-      // Tolleranza: permette fino a 3 controlli consecutivi con angoli mancanti.
-      if (cornerTouchLostCounter < 3) {
-        cornerTouchLostCounter++;
-      } else {
-        // Troppi controlli con angoli mancanti, annulla la sequenza di reset.
-        resetCountdownStarted = false;
-        cornerTouchLostCounter = 0;
-
-        gfx->fillScreen(BLACK);
-        gfx->setTextColor(RED);
-        gfx->setCursor(80, 240);
-        gfx->println(F("RESET WIFI ANNULLATO"));
-        delay(1000);
-
-        gfx->fillScreen(BLACK);
-
-      }
-    }
-    // Se non viene rilevato alcun tocco in nessun angolo.
-    else {
-      // Annulla immediatamente la sequenza di reset.
-      resetCountdownStarted = false;
-      cornerTouchLostCounter = 0;
-
-      gfx->fillScreen(BLACK);
-      gfx->setTextColor(RED);
-      gfx->setCursor(80, 240);
-      gfx->println(F("RESET WIFI ANNULLATO"));
-      delay(1000);
-
-      gfx->fillScreen(BLACK);
+    // Aggiorna la visualizzazione del countdown ogni secondo.
+    static int lastSecondDisplayed = -1;
+    int currentSecond = 5 - (elapsedTime / 1000); // Calcola i secondi rimanenti.
+    if (currentSecond < 0) currentSecond = 0;
 
-    }
-
-    // Se sono trascorsi 5 secondi dall'inizio della pressione, esegui il reset indipendentemente dallo stato degli angoli.
-    if (elapsedTime >= 5000) {
-      resetCountdownStarted = false;
-      cornerTouchLostCounter = 0;
+    if (currentSecond != lastSecondDisplayed) {
+      gfx->fillScreen(YELLOW);
+      gfx->setTextColor(BLACK);
+      gfx->setCursor(80, 180);
+      gfx->println(F("RESET WIFI TRA"));
+      gfx->setCursor(210, 240);
+      gfx->print(currentSecond);
+      gfx->println(F(" SEC"));
+      gfx->setCursor(40, 300);
+      gfx->println(F("RILASCIA PER ANNULLARE"));
 
-      // Esegui la funzione per resettare le impostazioni WiFi.
-      resetWiFiSettings();
+      lastSecondDisplayed = currentSecond; // Aggiorna l'ultimo secondo visualizzato.
     }
 
     return; // Esce dalla funzione per concentrarsi sulla gestione del reset.
@@ -423,25 +337,25 @@ void checkButtons() {
 
   // ====================== GESTIONE MODE SELECTOR ======================
 //  if (modeSelectorActive) {
-//    ts.read();  // Lettura fresh per stato attuale
-//    if (ts.isTouched && !waitingForRelease) {
-//      int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-//      int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
+//    touchRead();  // Lettura fresh per stato attuale
+//    if (touchState.isTouched && !waitingForRelease) {
+//      int x = map(touchState.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
+//      int y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
 //      handleModeSelectorTouch(x, y);
 //      waitingForRelease = true;
 //      modeSelectorLastActivity = millis();  // Solo su tocco effettivo
-//    } else if (!ts.isTouched) {
+//    } else if (!touchState.isTouched) {
 //      waitingForRelease = false;
 //    }
 //    return;
 //  }
 
 if (modeSelectorActive) {
-    // Rimuovi ts.read() da qui, usa il touchDetected già calcolato sopra!
+    // Rimuovi touchRead() da qui, usa il touchDetected già calcolato sopra!
     if (touchDetected && !waitingForRelease) {
         // Usa le coordinate già mappate se disponibili, o mappale una sola volta
-        int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-        int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
+        int x = map(touchState.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
+        int y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
         
         handleModeSelectorTouch(x, y);
         
@@ -458,10 +372,10 @@ if (modeSelectorActive) {
 
   // ====================== GESTIONE PAGINA SETUP ======================
   if (setupPageActive) { // Se la pagina di setup è attiva.
-    if (ts.isTouched) { // Se lo schermo è toccato.
+    if (touchState.isTouched) { // Se lo schermo è toccato.
       // Calcola le coordinate del tocco.
-      int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
-      int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
+      int x = map(touchState.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
+      int y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
 
       // Se non stiamo già gestendo uno scroll e non stiamo aspettando il rilascio di un tocco precedente.
       if (!setupScrollActive && !waitingForRelease) {
@@ -486,49 +400,13 @@ if (modeSelectorActive) {
     return;  // Esce dalla funzione per concentrarsi solo sulla gestione della pagina di setup.
   }
 
-  // ====================== RILEVAMENTO RESET WIFI ======================
-  /*
-   * Rileva una pressione simultanea sui 4 angoli dello schermo per avviare la sequenza di reset del WiFi.
-   */
-  if (ts.touches >= 4 && !resetCountdownStarted) { // Se ci sono almeno 4 tocchi e la sequenza di reset non è già iniziata.
-    bool tl = false, tr = false, bl = false, br = false; // Flag per ogni angolo.
-
-    // Verifica se ci sono tocchi nelle aree dei quattro angoli.
-    for (int i = 0; i < ts.touches && i < 10; i++) {
-      int x = map(ts.points[i].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
-      int y = map(ts.points[i].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
-
-      if (x < 100 && y < 100) tl = true;
-      else if (x > 380 && y < 100) tr = true;
-      else if (x < 100 && y > 380) bl = true;
-      else if (x > 380 && y > 380) br = true;
-    }
-
-    // Se tutti e quattro gli angoli sono toccati contemporaneamente.
-    if (tl && tr && bl && br) {
-      resetCountdownStarted = true;   // Avvia il countdown per il reset.
-      touchStartTime = currentMillis;  // Memorizza il tempo di inizio.
-      cornerTouchLostCounter = 0;      // Resetta il contatore di perdita del tocco.
-
-      // Fornisce un feedback visivo iniziale all'utente.
-      gfx->fillScreen(YELLOW);
-      gfx->setTextColor(BLACK);
-      gfx->setCursor(80, 180);
-      gfx->println(F("RESET WIFI TRA"));
-      gfx->setCursor(210, 240);
-      gfx->println(F("5 SEC"));
-      gfx->setCursor(40, 300);
-      gfx->println(F("RILASCIA PER ANNULLARE"));
-
-      waitingForRelease = true; // Imposta il flag per aspettare il rilascio (anche se non necessario per l'avvio).
-      return;                   // Esce dalla funzione per concentrarsi sulla gestione del reset.
-    }
-  }
-
+  // ====================== MODALITA' CON GESTORE EVENTI ======================
+  // Pong, Breakout, Arcade, News: il tocco arriva solo come eventi (touchModeHandlerFor)
+  if (touchModeHandlerFor(currentMode)) return;
 
 #ifdef MENU_SCROLL
-  // ====================== CONTROLLO SCROLL SETUP ======================
-  if (ts.isTouched && !waitingForRelease && !checkingSetupScroll) {
+  // ====================== FASCIA ALTA: SCROLL SETUP ======================
+  if (touchState.isTouched && !waitingForRelease) {
     // ANTIRIMBALZO - Controlla se è passato abbastanza tempo dall'ultimo tocco.
     if (currentMillis - lastTouchTime < TOUCH_DEBOUNCE_MS) {
       return;
@@ -538,29 +416,27 @@ if (modeSelectorActive) {
     lastTouchTime = currentMillis;
 
     // Ottieni la coordinata Y del primo punto di contatto.
-    int16_t y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
+    int16_t y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
 
-    // Se il tocco è nella parte superiore dello schermo (area tipicamente non usata per interazioni dirette).
+    // Fascia alta (y<50): swipe verso il basso e tap arrivano come eventi (touchSystemGesture).
     if (y < 50) {
-      scrollStartY = y;          // Memorizza la coordinata Y iniziale del potenziale scroll.
-      scrollStartX = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1); // Memorizza X per tap rapido.
-      checkingSetupScroll = true; // Imposta il flag per indicare che stiamo controllando uno scroll.
+      waitingForRelease = true;
       return;
     }
 
     // Se il tocco è in una posizione normale, memorizza le coordinate per le interazioni standard (quadranti).
-    touch_last_x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
-    touch_last_y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
+    touch_last_x = map(touchState.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
+    touch_last_y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
 #else
   // Se MENU_SCROLL non è definito, comunque otteniamo le coordinate del tocco se presente.
-  if (ts.isTouched && !waitingForRelease) {
-    touch_last_x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
-    touch_last_y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
+  if (touchState.isTouched && !waitingForRelease) {
+    touch_last_x = map(touchState.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
+    touch_last_y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
   }
 #endif
 
   // ====================== GESTIONE DEI QUATTRO QUADRANTI ======================
-  if (ts.isTouched && !waitingForRelease) {
+  if (touchState.isTouched && !waitingForRelease) {
 
   // ====================== TOUCH MODALITA' AUDIO (MP3, WebRadio, RadioAlarm) ======================
   // MODE >> basso centro = cambio modo sequenziale
@@ -623,8 +499,8 @@ if (modeSelectorActive) {
   // ====================== GESTIONE TOUCH CALENDARIO ======================
   #ifdef EFFECT_CALENDAR
   if (currentMode == MODE_CALENDAR && touchDetected && !waitingForRelease) {
-    int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-    int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
+    int x = map(touchState.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
+    int y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
 
     // MODE>> button (basso centro) - unico punto cambio modo per Calendar
     // (l'header e' riservato alle frecce < > cambio mese)
@@ -640,87 +516,12 @@ if (modeSelectorActive) {
   }
   #endif
 
-  // ====================== GESTIONE TOUCH PONG ======================
-  #ifdef EFFECT_PONG
-  if (currentMode == MODE_PONG && touchDetected && !waitingForRelease) {
-    int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-    int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
-
-    #ifdef EFFECT_DUAL_DISPLAY
-    if (isDualSlave()) {
-      // Slave: tracking continuo per racchetta destra
-      forwardTouchToMaster(x, y, 0);
-      pongTrackingActive = true;
-      return;  // NO waitingForRelease - tracking continuo
-    }
-    #endif
-
-    // Master o standalone: angolo alto-sinistra = cambio modo
-    if (x < 80 && y < 80) {
-      playTouchSound();
-      handleModeChange();
-      waitingForRelease = true;
-      return;
-    }
-
-    // Master: tocco zona top (Y<50, fuori da angolo exit) = cambio velocita'
-    if (y < 50 && x >= 80) {
-      playTouchSound();
-      handlePongSpeedChange();
-      waitingForRelease = true;
-      return;
-    }
-
-    // Master: tracking continuo racchetta sinistra
-    handlePongTouch(x, y);
-    pongTrackingActive = true;
-    return;  // NO waitingForRelease - tracking continuo
-  }
-  #endif
-
-  // ====================== GESTIONE TOUCH BREAKOUT ======================
-  #ifdef EFFECT_BREAKOUT
-  if (currentMode == MODE_BREAKOUT && touchDetected && !waitingForRelease) {
-    int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-    int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
-
-    #ifdef EFFECT_DUAL_DISPLAY
-    if (isDualSlave()) {
-      forwardTouchToMaster(x, y, 0);
-      breakoutTrackingActive = true;
-      return;
-    }
-    #endif
-
-    // Master: angolo alto-sinistra = cambio modo
-    if (x < 80 && y < 80) {
-      playTouchSound();
-      handleModeChange();
-      waitingForRelease = true;
-      return;
-    }
-
-    // Master: tocco zona top (Y<50, fuori da angolo exit) = cambio velocita'
-    if (y < 50 && x >= 80) {
-      playTouchSound();
-      handleBreakoutSpeedChange();
-      waitingForRelease = true;
-      return;
-    }
-
-    // Master: tracking continuo paddle orizzontale
-    handleBreakoutTouch(x, y);
-    breakoutTrackingActive = true;
-    return;
-  }
-  #endif
-
   // ====================== GESTIONE TOUCH BATTLESHIP ======================
   // Ogni display e' 480x480 indipendente. Slave inoltra touch al master via ESP-NOW.
   #ifdef EFFECT_BATTLESHIP
   if (currentMode == MODE_BATTLESHIP && touchDetected && !waitingForRelease) {
-    int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-    int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
+    int x = map(touchState.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
+    int y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
     playTouchSound();
     #ifdef EFFECT_DUAL_DISPLAY
     if (isDualSlave()) {
@@ -735,47 +536,12 @@ if (modeSelectorActive) {
   }
   #endif
 
-  // ====================== GESTIONE TOUCH ARCADE ======================
-  #ifdef EFFECT_ARCADE
-  if (currentMode == MODE_ARCADE && touchDetected) {
-    int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-    int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
-
-    if (arcadeInMenu) {
-      // Menu: tap per selezionare gioco o uscire
-      if (!waitingForRelease) {
-        // NO playTouchSound() - I2S usato da arcadeAudio
-        handleArcadeMenuTouch(x, y);
-        waitingForRelease = true;
-      }
-      return;
-    }
-
-    // In-game: tap buttons sui pannelli laterali
-    if (!waitingForRelease) {
-      bool isTap = false;
-      if (x < 72 && (y <= 75 || y >= 404)) isTap = true;    // EXIT o BACK
-      if (x >= 408 && (y <= 75 || y >= 322)) isTap = true;   // COIN o START
-      if (isTap) {
-        handleArcadeGameTouch(x, y);
-        waitingForRelease = true;
-        return;
-      }
-    }
-
-    // D-pad (tutto schermo) + FIRE (pannello dx): tracking continuo
-    arcadeUpdateTouchInput(x, y);
-    arcadeTrackingActive = true;
-    return;
-  }
-  #endif
-
   // ====================== GESTIONE TOUCH SCROLL TEXT ======================
   // Tocco sx = prev msg, dx = next msg, centro = pausa
   #ifdef EFFECT_SCROLLTEXT
   if (currentMode == MODE_SCROLLTEXT && touchDetected && !waitingForRelease) {
-    int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-    int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
+    int x = map(touchState.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
+    int y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
 
     // Pulsante MODE >> (basso centro y>455, x 180-310)
     if (y > 455 && x >= 180 && x <= 310) {
@@ -807,68 +573,6 @@ if (modeSelectorActive) {
   }
   #endif
 
-  // ====================== GESTIONE TOUCH NEWS FEED ======================
-  #ifdef EFFECT_NEWS
-  if (currentMode == MODE_NEWS && touchDetected && !waitingForRelease) {
-    int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-    int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
-
-    // MODE>> button (basso centro)
-    if (y > 455 && x >= 180 && x <= 310) {
-      playTouchSound(); handleModeChange(); waitingForRelease = true; return;
-    }
-
-    // Cambio modo: angolo alto-sx (sotto icona news, sopra tabs)
-    // Icona news e' piccola (~40x40), tabs partono da y:80
-    if (x < 60 && y < 50) {
-      playTouchSound(); handleModeChange(); waitingForRelease = true; return;
-    }
-
-    // Pill fonte in alto a destra: tocca per cambiare fonte (ANSA/BBC/Repubblica)
-    if (newsIsSourcePillTapped(x, y)) {
-      playTouchSound();
-      newsNextSource();
-      waitingForRelease = true;
-      return;
-    }
-
-    // Zona tabs categorie: hit-test preciso sulla tab toccata
-    int tappedTab = newsGetTappedTab(x, y);
-    if (tappedTab >= 0) {
-      playTouchSound();
-      newsSetCategory(tappedTab);
-      waitingForRelease = true;
-      return;
-    }
-
-    // Area articoli: tap per aprire link / swipe per scroll
-    if (newsArticleCount > 0) {
-      int artStartY = newsGetArticlesStartY();
-      if (y >= artStartY && y <= 440) {
-        if (newsArticleCount > 4) {
-          // Avvia tracking swipe (scroll + tap al rilascio)
-          newsSwipeActive = true;
-          newsSwipeStartY = y;
-          newsSwipeScrolled = false;
-          return;  // NON impostare waitingForRelease - serve tracking continuo
-        } else {
-          // Nessuno scroll, tap diretto per aprire articolo
-          int article = newsGetTappedArticle(y);
-          if (article >= 0) {
-            playTouchSound();
-            newsOpenArticle(article);
-          }
-          waitingForRelease = true;
-          return;
-        }
-      }
-    }
-
-    waitingForRelease = true;
-    return;
-  }
-  #endif
-
   // ====================== ZONA NASCOSTA: MOSTRA URL SETTINGS (angolo basso-destra) ======================
   // Piccola area 50x50 pixel nell'angolo in basso a destra per mostrare l'URL della pagina settings
   if (touch_last_x >= 430 && touch_last_x <= 480 &&
@@ -896,21 +600,8 @@ if (modeSelectorActive) {
   }
   #endif
 
-  #ifdef EFFECT_BTTF
-  // In BTTF: reset long press se tocco è FUORI dal centro (per permettere cambio mode/preset)
-  if (currentMode == MODE_BTTF && bttfLongPressActive) {
-    bool isInCenter = (touch_last_x >= 190 && touch_last_x <= 290 &&
-                       touch_last_y >= 190 && touch_last_y <= 290);
-    if (!isInCenter) {
-      // Tocco fuori dal centro - reset e procedi con i quadranti
-      bttfLongPressActive = false;
-      bttfLongPressTriggered = false;
-    }
-  }
-  #endif
-
 // --------------------- TOCCO CENTRALE: Annuncia ora attuale --------------------------------//
-// In modalità BTTF: long press (2 sec) apre pagina setup sveglie
+// In modalità BTTF: tap e long press arrivano come eventi (touchSystemGesture)
 // Funziona sia con audio I2S locale che con audio WiFi esterno (ESP32C3)
 // NOTA: Area centrale RIDOTTA per BTTF (190-290) per non interferire con quadranti
 #ifdef EFFECT_BTTF
@@ -926,24 +617,9 @@ bool isNormalCenter = (touch_last_x >= 170 && touch_last_x <= 310 &&
 if ((currentMode == MODE_BTTF && isBTTFCenter) || (currentMode != MODE_BTTF && isNormalCenter)) {
 
   #ifdef EFFECT_BTTF
-  // In modalità BTTF: gestisci long press per setup sveglie
+  // In modalità BTTF il centro aspetta TAP (annuncio) o LONG_PRESS (setup sveglie)
   if (currentMode == MODE_BTTF) {
-    if (!bttfLongPressActive) {
-      // Inizio monitoraggio long press
-      bttfLongPressActive = true;
-      bttfCenterTouchStart = currentMillis;
-      bttfLongPressTriggered = false;
-      Serial.println("[BTTF] Monitoraggio long press centro iniziato...");
-    } else if (!bttfLongPressTriggered && (currentMillis - bttfCenterTouchStart >= 2000)) {
-      // Long press completato! Apri pagina setup sveglie
-      bttfLongPressTriggered = true;
-      bttfLongPressActive = false;
-      Serial.println("[BTTF] >>> LONG PRESS 2 SEC - APRO PAGINA SETUP SVEGLIE <<<");
-      showBTTFAlarmSetup();
-      waitingForRelease = true;
-      return;
-    }
-    // Non eseguire azioni finché non rilasciamo o non scade il timer
+    waitingForRelease = true;
     return;
   }
   #endif
@@ -1058,7 +734,7 @@ if ((currentMode == MODE_BTTF && isBTTFCenter) || (currentMode != MODE_BTTF && i
         // Salva il preset anche per la modalità corrente (sincronizza con pagina web)
         saveModePreset((uint8_t)currentMode, currentPreset);
 
-        EEPROM.commit(); // Scrive i dati.
+        settingsCommit(); // Salva in flash (commit differito).
         playTouchSound();  // Emette un suono di feedback.
 
         // Applica il nuovo preset chiamando la funzione apposita.
@@ -1075,7 +751,7 @@ if ((currentMode == MODE_BTTF && isBTTFCenter) || (currentMode != MODE_BTTF && i
         word_E_state = (word_E_state + 1) % 2;
           // Scrive il nuovo stato nella EEPROM.
         EEPROM.write(EEPROM_WORD_E_STATE_ADDR, word_E_state);
-        EEPROM.commit();
+        settingsCommit();
 
         const char* Msg;
         switch (word_E_state) {
@@ -1110,37 +786,6 @@ if ((currentMode == MODE_BTTF && isBTTFCenter) || (currentMode != MODE_BTTF && i
     // Segnala che stiamo aspettando il rilascio del tocco corrente.
     waitingForRelease = true;
   }
-
-  // ====================== CONTROLLO SCROLL SETUP ======================
-  #ifdef MENU_SCROLL
-  if (checkingSetupScroll) {
-    if (!ts.isTouched) {
-      // Rilascio senza scroll = tap rapido nella zona alta (y<50).
-      // Se era nella meta' sinistra, trattalo come cambio modo (quadrante 1).
-      if (scrollStartX >= 0 && scrollStartX < 240) {
-        playTouchSound();
-        handleModeChange();
-        waitingForRelease = true;
-      }
-      checkingSetupScroll = false;
-      scrollStartY = -1;
-      scrollStartX = -1;
-    } else {
-      // Verifica se il gesto di scroll verso il basso è sufficiente.
-      int16_t y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
-
-      if (y - scrollStartY > 100) {  // Se lo spostamento verticale è di almeno 100 pixel verso il basso.
-        checkingSetupScroll = false; // Annulla il controllo dello scroll.
-        scrollStartY = -1;           // Resetta la posizione iniziale dello scroll.
-        scrollStartX = -1;
-
-        // Attiva la visualizzazione della pagina di setup.
-        showSetupPage();
-        playTouchSound();  // Emette un suono di feedback.
-      }
-    }
-  }
-  #endif
 }
 
 void playTouchSound() {
@@ -1246,8 +891,8 @@ void showSettingsURL() {
   delay(500); // Debounce
 
   // Aspetta rilascio
-  while (ts.isTouched) {
-    ts.read();
+  while (touchState.isTouched) {
+    touchRead();
     delay(50);
   }
 
@@ -1255,8 +900,8 @@ void showSettingsURL() {
   bool exitWait = true;
   uint32_t showTime = millis();
   while (exitWait) {
-    ts.read();
-    if (ts.isTouched) {
+    touchRead();
+    if (touchState.isTouched) {
       exitWait = false;
     }
     // Auto-chiudi dopo 30 secondi
@@ -0,0 +1,393 @@
+// ================== TOUCH INPUT - TASK GT911, GESTURE E CODA EVENTI ==================
+// Unico punto in cui il GT911 viene letto via I2C (tramite l'arbitro del bus, 0_I2C_BUS.ino,
+// con la priorita' piu' alta). Il task touchInputTask:
+//  - con TOUCH_INT collegato: dorme finche' l'ISR sull'INT non lo sveglia (zero traffico
+//    I2C a riposo); con dito appoggiato una rilettura di sicurezza ogni 100ms intercetta
+//    un rilascio senza impulso
+//  - con TOUCH_INT = -1 (questa scheda): polling adattivo, 10ms con dito appoggiato, 25ms
+//    nei 2s dopo un rilascio (doppio tap) e 80ms a riposo prolungato (prima il loop leggeva
+//    fino a 3 volte per chiamata di checkButtons)
+//  - marca ogni campione con l'istante in cui il dato era disponibile, conferma il rilascio
+//    con campioni vuoti consecutivi e pubblica il campione per touchRead()
+//  - fa girare il riconoscitore di gesture (press/release, tap, doppio tap, long press,
+//    swipe, drag, 4 angoli) e mette gli eventi in una coda SPSC lock-free letta da
+//    checkButtons(), che li passa al gestore della modalita' (touchModeHandlerFor)
+//
+// Latenza misurata: INT -> campione letto (solo con INT) e campione -> evento consumato.
+
+#include <atomic>
+
+// ===== Parametri task =====
+#define TOUCH_TASK_CORE            1
+#define TOUCH_TASK_PRIORITY        2     // Sopra il loop (1): il campionamento non aspetta il render
+#define TOUCH_TASK_STACK           4096
+#define TOUCH_POLL_IDLE_MS         25    // Senza INT: polling dopo un rilascio
+#define TOUCH_POLL_SLEEP_MS        80    // Senza INT: polling a riposo prolungato
+#define TOUCH_POLL_SLEEP_AFTER_MS  2000  // Senza INT: riposo dopo cui si passa a TOUCH_POLL_SLEEP_MS
+#define TOUCH_POLL_ACTIVE_MS       10    // Senza INT: polling con dito appoggiato
+#define TOUCH_INT_WATCHDOG_MS      100   // Con INT: rilettura se il rilascio non arriva
+#define TOUCH_RELEASE_SAMPLES      2     // Senza INT: campioni vuoti per confermare il rilascio
+
+// ===== Parametri gesture (coordinate schermo 0-479) =====
+#define TOUCH_TAP_MAX_MS           350
+#define TOUCH_DOUBLE_TAP_MS        300
+#define TOUCH_DOUBLE_TAP_PX        40
+#define TOUCH_LONG_PRESS_MS        800
+#define TOUCH_DRAG_PX              20
+#define TOUCH_DRAG_STEP_PX         2     // Movimento minimo tra due DRAG_MOVE
+#define TOUCH_SWIPE_PX             60
+#define TOUCH_SWIPE_MAX_MS         600
+#define TOUCH_CORNER_PX            100
+#define TOUCH_CORNERS_HOLD_MS      5000
+#define TOUCH_CORNERS_LOST_MS      150   // Tolleranza: tempo senza tutti gli angoli prima dell'annullo
+
+#define TOUCH_EVENT_QUEUE          32    // Potenza di 2
+
+struct TouchInputStats {
+  uint32_t i2cReads;        // Letture GT911
+  uint32_t idleReads;       // Letture senza dito appoggiato (0 con INT)
+  uint32_t interrupts;
+  uint32_t readUsLast;      // Durata ultima lettura I2C
+  uint32_t readUsMax;
+  uint32_t readErrors;      // Letture scartate (bus in errore o registro di stato non valido)
+  uint32_t irqLatUsMax;     // INT -> campione letto
+  uint32_t events;          // Eventi accodati
+  uint32_t dropped;         // Eventi persi a coda piena
+  uint32_t unhandled;       // Eventi senza gestore della modalita'
+  uint32_t eventLatUsAvg;   // Campione -> evento consumato (media mobile 1/8)
+  uint32_t eventLatUsMax;
+  uint32_t eventLatUsLast;
+};
+
+TouchInputStats touchInputStats = {};
+
+static TaskHandle_t touchTaskHandle = nullptr;
+static volatile uint32_t touchIrqUs = 0;
+
+// Campione pubblicato dal task (copia protetta da spinlock, pochi byte)
+static TouchState touchShared;
+static portMUX_TYPE touchMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Coda eventi: produttore = task di input, consumatore = loop
+static TouchEvent touchQueue[TOUCH_EVENT_QUEUE];
+static std::atomic<uint32_t> touchQueueHead(0);
+static std::atomic<uint32_t> touchQueueTail(0);
+
+static bool touchQueuePush(const TouchEvent &ev) {
+  uint32_t head = touchQueueHead.load(std::memory_order_relaxed);
+  uint32_t tail = touchQueueTail.load(std::memory_order_acquire);
+  if (head - tail >= TOUCH_EVENT_QUEUE) {
+    touchInputStats.dropped++;
+    return false;
+  }
+  touchQueue[head & (TOUCH_EVENT_QUEUE - 1)] = ev;
+  touchQueueHead.store(head + 1, std::memory_order_release);
+  touchInputStats.events++;
+  return true;
+}
+
+// Estrae il prossimo evento (loop). Aggiorna la latenza campione -> consumo.
+bool touchPollEvent(TouchEvent &ev) {
+  uint32_t tail = touchQueueTail.load(std::memory_order_relaxed);
+  uint32_t head = touchQueueHead.load(std::memory_order_acquire);
+  if (tail == head) return false;
+  ev = touchQueue[tail & (TOUCH_EVENT_QUEUE - 1)];
+  touchQueueTail.store(tail + 1, std::memory_order_release);
+
+  uint32_t lat = (uint32_t)esp_timer_get_time() - ev.sampleUs;
+  touchInputStats.eventLatUsLast = lat;
+  if (lat > touchInputStats.eventLatUsMax) touchInputStats.eventLatUsMax = lat;
+  if (touchInputStats.eventLatUsAvg == 0) touchInputStats.eventLatUsAvg = lat;
+  else touchInputStats.eventLatUsAvg += ((int32_t)lat - (int32_t)touchInputStats.eventLatUsAvg) / 8;
+  return true;
+}
+
+// Dito appoggiato o eventi non ancora consumati (il loop resta reattivo)
+bool touchInputActive() {
+  if (touchQueueHead.load(std::memory_order_acquire) != touchQueueTail.load(std::memory_order_relaxed)) return true;
+  portENTER_CRITICAL(&touchMux);
+  bool down = touchShared.isTouched;
+  portEXIT_CRITICAL(&touchMux);
+  return down;
+}
+
+void touchEventUnhandled() {
+  touchInputStats.unhandled++;
+}
+
+// Copia l'ultimo campione in touchState (nessuna transazione I2C)
+void touchRead() {
+  portENTER_CRITICAL(&touchMux);
+  touchState = touchShared;
+  portEXIT_CRITICAL(&touchMux);
+}
+
+// ===== Riconoscitore gesture =====
+struct TouchGesture {
+  bool     down;
+  uint32_t downUs;
+  int16_t  x0, y0;          // Punto iniziale
+  int16_t  x, y;            // Ultimo punto
+  int16_t  lastMoveX, lastMoveY;
+  uint8_t  maxTouches;      // Multi-touch: niente gesture a un dito
+  bool     dragging;
+  bool     longFired;
+  uint32_t lastTapUs;
+  int16_t  lastTapX, lastTapY;
+  bool     cornersActive;
+  bool     cornersFired;
+  uint32_t cornersUs;       // Inizio pressione dei 4 angoli
+  uint32_t cornersSeenUs;   // Ultimo campione con tutti e 4 gli angoli
+};
+
+static TouchGesture touchGesture = {};
+
+static void touchEmit(uint8_t type, uint8_t dir, uint32_t sampleUs) {
+  const TouchGesture &g = touchGesture;
+  TouchEvent ev;
+  ev.type = type;
+  ev.dir = dir;
+  ev.x = g.x;
+  ev.y = g.y;
+  ev.dx = g.x - g.x0;
+  ev.dy = g.y - g.y0;
+  ev.durationMs = (sampleUs - g.downUs) / 1000;
+  ev.sampleUs = sampleUs;
+  touchQueuePush(ev);
+}
+
+static bool touchAllCorners(const TouchState &s) {
+  bool tl = false, tr = false, bl = false, br = false;
+  for (int i = 0; i < s.touches && i < TOUCH_MAX_POINTS; i++) {
+    int x = map(s.points[i].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
+    int y = map(s.points[i].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
+    if (x < TOUCH_CORNER_PX && y < TOUCH_CORNER_PX) tl = true;
+    else if (x > 479 - TOUCH_CORNER_PX && y < TOUCH_CORNER_PX) tr = true;
+    else if (x < TOUCH_CORNER_PX && y > 479 - TOUCH_CORNER_PX) bl = true;
+    else if (x > 479 - TOUCH_CORNER_PX && y > 479 - TOUCH_CORNER_PX) br = true;
+  }
+  return tl && tr && bl && br;
+}
+
+static void touchGestureFeed(const TouchState &s) {
+  TouchGesture &g = touchGesture;
+  uint32_t now = s.sampleUs;
+
+  // --- 4 angoli (reset WiFi) ---
+  if (s.touches >= 4 && touchAllCorners(s)) {
+    g.cornersSeenUs = now;
+    if (!g.cornersActive) {
+      g.cornersActive = true;
+      g.cornersFired = false;
+      g.cornersUs = now;
+      touchEmit(TOUCH_EV_CORNERS_START, TOUCH_SWIPE_NONE, now);
+    } else if (!g.cornersFired && now - g.cornersUs >= TOUCH_CORNERS_HOLD_MS * 1000UL) {
+      g.cornersFired = true;
+      touchEmit(TOUCH_EV_CORNERS_HOLD, TOUCH_SWIPE_NONE, now);
+    }
+  } else if (g.cornersActive) {
+    // Rilascio completo = annullo immediato; angoli parziali = tolleranza di alcuni campioni
+    if (!s.isTouched || now - g.cornersSeenUs >= TOUCH_CORNERS_LOST_MS * 1000UL) {
+      g.cornersActive = false;
+      if (!g.cornersFired) touchEmit(TOUCH_EV_CORNERS_LOST, TOUCH_SWIPE_NONE, now);
+    }
+  }
+
+  // --- Gesture a un dito ---
+  if (s.isTouched) {
+    int16_t x = constrain(map(s.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1), 0, 479);
+    int16_t y = constrain(map(s.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1), 0, 479);
+
+    if (!g.down) {
+      g.down = true;
+      g.downUs = now;
+      g.x0 = g.x = g.lastMoveX = x;
+      g.y0 = g.y = g.lastMoveY = y;
+      g.maxTouches = s.touches;
+      g.dragging = false;
+      g.longFired = false;
+      touchEmit(TOUCH_EV_PRESS, TOUCH_SWIPE_NONE, now);
+      return;
+    }
+
+    g.x = x;
+    g.y = y;
+    if (s.touches > g.maxTouches) g.maxTouches = s.touches;
+    if (g.maxTouches > 1) return;
+
+    int16_t dist = max(abs(g.x - g.x0), abs(g.y - g.y0));
+    if (!g.dragging && !g.longFired && dist >= TOUCH_DRAG_PX) {
+      g.dragging = true;
+      g.lastMoveX = x;
+      g.lastMoveY = y;
+      touchEmit(TOUCH_EV_DRAG_START, TOUCH_SWIPE_NONE, now);
+    } else if (g.dragging) {
+      if (max(abs(x - g.lastMoveX), abs(y - g.lastMoveY)) >= TOUCH_DRAG_STEP_PX) {
+        g.lastMoveX = x;
+        g.lastMoveY = y;
+        touchEmit(TOUCH_EV_DRAG_MOVE, TOUCH_SWIPE_NONE, now);
+      }
+    } else if (!g.longFired && now - g.downUs >= TOUCH_LONG_PRESS_MS * 1000UL) {
+      g.longFired = true;
+      touchEmit(TOUCH_EV_LONG_PRESS, TOUCH_SWIPE_NONE, now);
+    }
+    return;
+  }
+
+  if (!g.down) return;
+
+  // --- Rilascio: coordinate = ultimo punto toccato ---
+  uint32_t durMs = (now - g.downUs) / 1000;
+  if (g.maxTouches == 1) {
+    if (g.dragging) {
+      int16_t dx = g.x - g.x0;
+      int16_t dy = g.y - g.y0;
+      if (max(abs(dx), abs(dy)) >= TOUCH_SWIPE_PX && durMs <= TOUCH_SWIPE_MAX_MS) {
+        uint8_t dir = abs(dx) > abs(dy) ? (dx < 0 ? TOUCH_SWIPE_LEFT : TOUCH_SWIPE_RIGHT)
+                                        : (dy < 0 ? TOUCH_SWIPE_UP : TOUCH_SWIPE_DOWN);
+        touchEmit(TOUCH_EV_SWIPE, dir, now);
+      }
+      touchEmit(TOUCH_EV_DRAG_END, TOUCH_SWIPE_NONE, now);
+    } else if (!g.longFired && durMs <= TOUCH_TAP_MAX_MS) {
+      touchEmit(TOUCH_EV_TAP, TOUCH_SWIPE_NONE, now);
+      bool nearLast = abs(g.x - g.lastTapX) <= TOUCH_DOUBLE_TAP_PX && abs(g.y - g.lastTapY) <= TOUCH_DOUBLE_TAP_PX;
+      if (g.lastTapUs != 0 && now - g.lastTapUs <= TOUCH_DOUBLE_TAP_MS * 1000UL && nearLast) {
+        touchEmit(TOUCH_EV_DOUBLE_TAP, TOUCH_SWIPE_NONE, now);
+        g.lastTapUs = 0;
+      } else {
+        g.lastTapUs = now;
+        g.lastTapX = g.x;
+        g.lastTapY = g.y;
+      }
+    }
+  }
+  touchEmit(TOUCH_EV_RELEASE, TOUCH_SWIPE_NONE, now);
+  g.down = false;
+}
+
+// ===== Lettura GT911 (eseguita dal task del bus I2C) =====
+// TAMC_GT911::read() non riporta errori: con il bus in errore Wire.read() ritorna -1 e il
+// registro di stato 0x814E diventa 0xFF, cioe' 15 tocchi con buffer pronto e punti spazzatura.
+// Il registro viene prima letto qui con l'esito I2C verificato; ts.read() solo se valido.
+#define GT911_REG_STATUS           0x814E
+
+static bool touchReadGt911(void *) {
+  Wire.beginTransmission(GT911_ADDR1);
+  Wire.write(GT911_REG_STATUS >> 8);
+  Wire.write(GT911_REG_STATUS & 0xFF);
+  if (Wire.endTransmission() != 0) return false;
+  if (Wire.requestFrom((uint8_t)GT911_ADDR1, (uint8_t)1) != 1) return false;
+  uint8_t status = Wire.read();
+  if ((status & 0x0F) > TOUCH_MAX_POINTS) return false;   // Il GT911 riporta al massimo 5 punti
+  ts.read();
+  return true;
+}
+
+// ===== ISR INT GT911: solo timestamp + notifica al task =====
+#if TOUCH_INT >= 0
+static void IRAM_ATTR touchIsr() {
+  touchIrqUs = (uint32_t)esp_timer_get_time();
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(touchTaskHandle, &woken);
+  if (woken) portYIELD_FROM_ISR();
+}
+#endif
+
+static void touchInputTask(void *param) {
+  bool fingerDown = false;   // Stato confermato (dopo il filtro sul rilascio)
+  uint8_t emptySamples = 0;
+  uint32_t releasedMs = 0;   // Ultimo rilascio confermato (polling a riposo)
+
+  for (;;) {
+    uint32_t sampleUs;
+#if TOUCH_INT >= 0
+    TickType_t wait = fingerDown ? pdMS_TO_TICKS(TOUCH_INT_WATCHDOG_MS) : portMAX_DELAY;
+    bool fromIrq = ulTaskNotifyTake(pdTRUE, wait) > 0;
+    sampleUs = fromIrq ? touchIrqUs : (uint32_t)esp_timer_get_time();
+    if (fromIrq) touchInputStats.interrupts++;
+    const uint8_t releaseSamples = 1;   // Dato segnalato dal controller: affidabile
+#else
+    uint32_t pollMs = fingerDown ? TOUCH_POLL_ACTIVE_MS :
+                      (millis() - releasedMs < TOUCH_POLL_SLEEP_AFTER_MS ? TOUCH_POLL_IDLE_MS : TOUCH_POLL_SLEEP_MS);
+    vTaskDelay(pdMS_TO_TICKS(pollMs));
+    sampleUs = (uint32_t)esp_timer_get_time();
+    const uint8_t releaseSamples = TOUCH_RELEASE_SAMPLES;
+#endif
+
+    uint32_t t0 = (uint32_t)esp_timer_get_time();
+    bool readOk = i2cBusRun(I2C_DEV_TOUCH, touchReadGt911, nullptr);
+    uint32_t t1 = (uint32_t)esp_timer_get_time();
+
+    touchInputStats.i2cReads++;
+    if (!fingerDown) touchInputStats.idleReads++;
+    touchInputStats.readUsLast = t1 - t0;
+    if (t1 - t0 > touchInputStats.readUsMax) touchInputStats.readUsMax = t1 - t0;
+    if (!readOk) {
+      touchInputStats.readErrors++;
+      continue;   // Campione non valido: resta pubblicato l'ultimo, gesture ferme
+    }
+#if TOUCH_INT >= 0
+    if (fromIrq && t1 - sampleUs > touchInputStats.irqLatUsMax) touchInputStats.irqLatUsMax = t1 - sampleUs;
+#endif
+
+    bool touched = ts.isTouched && ts.touches > 0;
+    if (!touched && fingerDown && ++emptySamples < releaseSamples) {
+      continue;   // Rilascio non ancora confermato: resta valido l'ultimo campione
+    }
+    if (touched) emptySamples = 0;
+
+    TouchState sample;
+    sample.isTouched = touched;
+    sample.touches = touched ? min((uint8_t)ts.touches, (uint8_t)TOUCH_MAX_POINTS) : 0;
+    for (uint8_t i = 0; i < sample.touches; i++) sample.points[i] = ts.points[i];
+    sample.sampleUs = sampleUs;
+
+    portENTER_CRITICAL(&touchMux);
+    touchShared = sample;
+    portEXIT_CRITICAL(&touchMux);
+
+    bool wasDown = fingerDown;
+    fingerDown = touched;
+    if (wasDown && !touched) releasedMs = millis();
+    touchGestureFeed(sample);
+    // Pressione, trascinamento e rilascio svegliano subito il loop (frame governor)
+    if (touched || wasDown) frameGovKick();
+  }
+}
+
+// Da chiamare dopo ts.begin()/setRotation() (setup_touch)
+void touchInputBegin() {
+  if (touchTaskHandle) return;
+  xTaskCreatePinnedToCore(touchInputTask, "TouchInput", TOUCH_TASK_STACK, NULL,
+                          TOUCH_TASK_PRIORITY, &touchTaskHandle, TOUCH_TASK_CORE);
+#if TOUCH_INT >= 0
+  pinMode(TOUCH_INT, INPUT);
+  attachInterrupt(digitalPinToInterrupt(TOUCH_INT), touchIsr, TOUCH_INT_EDGE);
+  Serial.printf("[TOUCH] Task input avviato, INT su GPIO %d\n", TOUCH_INT);
+#else
+  Serial.printf("[TOUCH] Task input avviato, polling %d/%d/%dms (INT non collegato)\n",
+                TOUCH_POLL_SLEEP_MS, TOUCH_POLL_IDLE_MS, TOUCH_POLL_ACTIVE_MS);
+#endif
+}
+
+// ===== Statistiche in JSON =====
+String getTouchStatsJson() {
+  const TouchInputStats &st = touchInputStats;
+  String json = "{";
+  json += "\"mode\":\"" + String(TOUCH_INT >= 0 ? "interrupt" : "polling") + "\",";
+  json += "\"i2cReads\":" + String(st.i2cReads) + ",";
+  json += "\"idleReads\":" + String(st.idleReads) + ",";
+  json += "\"interrupts\":" + String(st.interrupts) + ",";
+  json += "\"readUs\":" + String(st.readUsLast) + ",";
+  json += "\"readUsMax\":" + String(st.readUsMax) + ",";
+  json += "\"readErrors\":" + String(st.readErrors) + ",";
+  json += "\"irqLatUsMax\":" + String(st.irqLatUsMax) + ",";
+  json += "\"events\":" + String(st.events) + ",";
+  json += "\"dropped\":" + String(st.dropped) + ",";
+  json += "\"unhandled\":" + String(st.unhandled) + ",";
+  json += "\"eventLatUs\":" + String(st.eventLatUsLast) + ",";
+  json += "\"eventLatUsAvg\":" + String(st.eventLatUsAvg) + ",";
+  json += "\"eventLatUsMax\":" + String(st.eventLatUsMax);
+  json += "}";
+  return json;
+}
@@ -40,6 +40,10 @@ extern bool playStreamViaI2C(const char* url);
 extern bool stopStreamViaI2C();
 extern bool setVolumeViaI2C(uint8_t volume);
 
+// Dichiarazioni esterne per audio Bluetooth (25_BLUETOOTH_AUDIO.ino)
+extern bool btAudioStreaming;
+extern bool btAudioHttpConnected;
+
 // ================== VARIABILI STATO MJPEG ==================
 bool mjpegInitialized = false;          // Flag inizializzazione
 bool mjpegStreaming = false;            // Flag streaming attivo
@@ -69,6 +73,12 @@ unsigned long mjpegLastVolumeCheck = 0; // Timestamp ultimo controllo volume
 // Ritardo avvio audio per sincronizzazione con video
 bool mjpegAudioC3Pending = false;       // Flag: audio C3 in attesa di avvio
 unsigned long mjpegAudioStartTime = 0;  // Timestamp quando avviare l'audio
+
+// Sincronizzazione audio Bluetooth: il server manda X-Timestamp (ms del video) in ogni parte
+static const char MJPEG_TS_HEADER[] = "X-Timestamp: ";
+unsigned long mjpegPartTimestamp = 0;   // Timestamp dell'ultimo frame letto (0 = sconosciuto)
+unsigned long mjpegLastBtAudioTry = 0;  // Ultimo tentativo di connessione a /audio_pcm
+#define MJPEG_BT_AUDIO_RETRY_MS 2000    // Intervallo tra i tentativi di connessione audio BT
 #define MJPEG_AUDIO_DELAY_MS 0          // Nessun ritardo - audio parte da 0 sul server
 
 // Client HTTP per streaming
@@ -260,6 +270,7 @@ void disconnectMjpegStream() {
     }
 
     mjpegHttp.end();
+    disconnectBtAudioHttp();
     mjpegStreaming = false;
     mjpegAudioC3Active = false;
     mjpegAudioC3Pending = false;  // Cancella eventuale avvio pendente
@@ -290,6 +301,8 @@ int readMjpegFrame() {
   int jpegSize = 0;
   bool foundSOI = false;
   uint8_t prevByte = 0;
+  uint8_t tsMatch = 0;                    // Caratteri di MJPEG_TS_HEADER gia' riconosciuti
+  unsigned long partTs = 0;
   unsigned long timeout = millis() + 1500;  // 1.5 secondi timeout
 
   while (millis() < timeout && stream->connected()) {
@@ -303,6 +316,18 @@ int readMjpegFrame() {
         uint8_t b = mjpegReadBuffer[i];
 
         if (!foundSOI) {
+          // Intestazioni della parte: X-Timestamp seguito dalle cifre in ms
+          if (tsMatch < sizeof(MJPEG_TS_HEADER) - 1) {
+            if (b == (uint8_t)MJPEG_TS_HEADER[tsMatch]) tsMatch++;
+            else tsMatch = (b == (uint8_t)MJPEG_TS_HEADER[0]) ? 1 : 0;
+            partTs = 0;
+          } else if (b >= '0' && b <= '9') {
+            partTs = partTs * 10 + (b - '0');
+          } else {
+            mjpegPartTimestamp = partTs;
+            tsMatch = 0;
+          }
+
           // Cerca marker SOI (0xFFD8)
           if (prevByte == 0xFF && b == 0xD8) {
             mjpegJpegBuffer[0] = 0xFF;
@@ -522,6 +547,9 @@ void updateMjpegStream() {
       mjpegFramesThisSecond++;
       mjpegLastFrameTime = millis();
 
+      // Frame visibile: riferimento video per il lip-sync dell'audio Bluetooth
+      if (mjpegPartTimestamp > 0) setBtVideoTimestamp(mjpegPartTimestamp);
+
       // Disegna overlay solo ogni 500ms per ridurre overhead
       if (millis() - lastOverlayUpdate > 500) {
         drawMjpegOverlay();
@@ -557,6 +585,18 @@ void updateMjpegStream() {
     mjpegLastFpsUpdate = now;
   }
 
+  // Audio Bluetooth: PCM con timestamp da /audio_pcm nel ring del task A2DP
+  if (btAudioStreaming) {
+    if (!btAudioHttpConnected && now - mjpegLastBtAudioTry >= MJPEG_BT_AUDIO_RETRY_MS) {
+      mjpegLastBtAudioTry = now;
+      int pathStart = mjpegStreamUrl.indexOf("/stream");
+      if (pathStart < 0) pathStart = mjpegStreamUrl.lastIndexOf('/');
+      String baseUrl = (pathStart > 0) ? mjpegStreamUrl.substring(0, pathStart) : mjpegStreamUrl;
+      connectBtAudioHttp(baseUrl);
+    }
+    updateBtAudioReceive();
+  }
+
   // Avvia audio C3 dopo ritardo (per sync con video)
   if (mjpegAudioC3Pending && !mjpegAudioC3Active && now >= mjpegAudioStartTime) {
     Serial.println("[MJPEG] Avvio audio C3 (dopo ritardo sync)...");
@@ -837,7 +837,7 @@ void saveEsp32camUrlToEEPROMNow() {
   EEPROM.write(EEPROM_ESPCAM_URL_VALID, EEPROM_ESPCAM_URL_VALID_VALUE);
   yield();
 
-  EEPROM.commit();
+  settingsCommit();
 
   Serial.printf("[ESP32-CAM] URL salvato in EEPROM: %s\n", esp32camStreamUrl.c_str());
 }
@@ -268,7 +268,7 @@ void setup_esp32cam_webserver(AsyncWebServer* server) {
     currentMode = MODE_ESP32CAM;
     userMode = MODE_ESP32CAM;
     EEPROM.write(EEPROM_MODE_ADDR, currentMode);
-    EEPROM.commit();
+    settingsCommit();
     esp32camInitialized = false;
 
     Serial.println("[ESP32-CAM] Avviata da web");
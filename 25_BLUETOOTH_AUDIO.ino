@@ -10,6 +10,22 @@
 // - Sincronizzazione audio/video tramite timestamp
 // - Discovery dispositivi BT Classic tramite BluetoothSerial
 //
+// BUFFER E DERIVA DI CLOCK:
+// Il PCM passa dal loop (produttore, HTTP) al task A2DP (consumatore) in un ring
+// single-producer/single-consumer: indici atomici a corsa libera, ognuno scritto da un
+// solo lato, trasferimenti in blocco con al massimo due memcpy (prima e dopo il giro).
+// Il clock del server e quello del ricevitore BT non sono identici: il consumatore
+// ricampiona con un passo frazionario (interpolazione lineare, fase Q32) regolato in ppm
+// da un controllo PI sul riempimento del ring. Il riempimento obiettivo viene dai
+// timestamp audio/video (audio in uscita = timestamp audio - audio bufferizzato), cosi'
+// la deriva viene assorbita senza perdere il sincronismo labiale.
+//
+// TIMESTAMP:
+// - /audio_pcm arriva a blocchi [timestamp ms][lunghezza][PCM] (big-endian, 4+4 byte):
+//   il timestamp dell'audio in testa al ring viene dal blocco in corso
+// - il video arriva con l'intestazione X-Timestamp di ogni parte MJPEG (21_MJPEG_STREAM.ino)
+// - entrambi sono il tempo del video sul server, in ms
+//
 // REQUISITI:
 // - ESP32-S3 (supporta Bluetooth Classic A2DP)
 // - Per streaming audio: Libreria ESP32-A2DP di Phil Schatzmann
@@ -19,6 +35,8 @@
 
 #ifdef EFFECT_MJPEG_STREAM
 
+#include <atomic>
+
 // Prova a includere la libreria A2DP se disponibile
 #if __has_include("BluetoothA2DPSource.h")
   #define BT_A2DP_AVAILABLE
@@ -39,12 +57,21 @@
 #define BT_AUDIO_SAMPLE_RATE    44100   // Sample rate audio (44.1kHz standard)
 #define BT_AUDIO_CHANNELS       2       // Stereo
 #define BT_AUDIO_BITS           16      // 16-bit audio
-#define BT_AUDIO_BUFFER_SIZE    4096    // Buffer audio circolare (samples)
+#define BT_AUDIO_RING_FRAMES    8192    // Ring audio in frame stereo (potenza di 2, ~186ms)
+#define BT_AUDIO_CHUNK_FRAMES   256     // Frame elaborati per blocco nel callback A2DP
+#define BT_PCM_HEADER_BYTES     8       // Intestazione dei blocchi /audio_pcm: timestamp + lunghezza
+#define BT_PCM_MAX_READS        16      // Letture HTTP (1 KB) per chiamata di updateBtAudioReceive
 #define BT_DEVICE_NAME          "OraQuadra_Audio"  // Nome dispositivo BT visibile
 
 // Buffer audio per sincronizzazione
 #define AUDIO_SYNC_BUFFER_MS    100     // Buffer di sincronizzazione (ms)
 #define AUDIO_HTTP_TIMEOUT      5000    // Timeout connessione HTTP audio (ms)
+#define BT_AUDIO_MIN_FILL_MS    20      // Riempimento minimo del ring (margine contro gli underrun)
+#define BT_AUDIO_RESYNC_MS      60      // Oltre questo errore si salta/inserisce audio invece di ricampionare
+#define BT_DRIFT_MAX_PPM        500     // Deriva di clock massima stimata (termine integrale)
+#define BT_CORRECTION_MAX_PPM   1000    // Correzione massima del ricampionatore (margine per il proporzionale)
+#define BT_DRIFT_UPDATE_MS      100     // Periodo del controllo di deriva (loop)
+#define BT_VIDEO_STALE_MS       1000    // Senza frame video da tanto, niente lip-sync (riempimento fisso)
 
 // ================== VARIABILI STATO BT AUDIO ==================
 bool btAudioEnabled = false;            // Audio BT abilitato
@@ -53,11 +80,35 @@ bool btAudioStreaming = false;          // Streaming audio attivo
 String btTargetDevice = "";             // Nome/MAC dispositivo target per auto-connect
 String btConnectedDevice = "";          // Nome dispositivo attualmente connesso
 
-// Buffer audio circolare
-int16_t *btAudioBuffer = nullptr;       // Buffer audio PCM in PSRAM
-volatile int btAudioWritePos = 0;       // Posizione scrittura buffer
-volatile int btAudioReadPos = 0;        // Posizione lettura buffer
-volatile int btAudioBufferCount = 0;    // Samples nel buffer
+// Ring audio SPSC: frame stereo (L nei 16 bit bassi, R negli alti, come Frame di ESP32-A2DP)
+uint32_t *btAudioRing = nullptr;        // Ring PCM in PSRAM
+static std::atomic<uint32_t> btRingHead(0);   // Scritto solo dal loop (produttore)
+static std::atomic<uint32_t> btRingTail(0);   // Scritto solo dal task A2DP (consumatore)
+static std::atomic<uint32_t> btRingSkip(0);   // Frame da scartare (richiesta del loop al consumatore)
+static std::atomic<uint32_t> btRingHold(0);   // Frame di silenzio da inserire senza consumare
+static std::atomic<uint32_t> btRingPrime(0);  // Riempimento da attendere dopo un underrun
+static std::atomic<int32_t>  btResampleDelta(0);  // Passo - 1 frame, in Q32 (ppm * 4294.97)
+static uint8_t  btRxCarry[4];           // Byte di un frame incompleto tra due letture HTTP
+static uint8_t  btRxCarryLen = 0;
+static uint8_t  btRxHeader[BT_PCM_HEADER_BYTES];  // Intestazione del blocco in arrivo
+static uint8_t  btRxHeaderLen = 0;
+static uint32_t btRxRecordLeft = 0;     // Byte PCM ancora da leggere nel blocco corrente
+static uint32_t btRxRecordTs = 0;       // Timestamp del blocco corrente (ms)
+static uint32_t btRxRecordBytes = 0;    // Byte PCM gia' letti del blocco corrente
+
+// Ricampionatore (stato del consumatore)
+static uint32_t btResamplePhase = 0;    // Posizione frazionaria tra due frame (Q32)
+static volatile bool btRingPriming = true;  // Silenzio finché il ring non raggiunge btRingPrime
+static uint32_t btResampleIn[BT_AUDIO_CHUNK_FRAMES * 2 + 2];  // Blocco in ingresso (RAM interna)
+
+// Controllo di deriva (loop)
+static float    btDriftPpm = 0;         // Termine integrale: deriva di clock stimata
+static float    btCorrectionPpm = 0;    // Correzione applicata (proporzionale + integrale)
+static float    btErrAvgMs = 0;         // Errore di riempimento filtrato (ms)
+static int32_t  btTargetFillMs = AUDIO_SYNC_BUFFER_MS;
+static int32_t  btLipSyncMs = 0;        // Audio in uscita - video (ms)
+static uint32_t btDriftLastMs = 0;
+static uint32_t btVideoAtMs = 0;        // millis() a cui e' stato mostrato il frame videoTimestamp
 
 // Sincronizzazione audio/video
 unsigned long audioTimestamp = 0;       // Timestamp corrente audio (ms dal server)
@@ -73,40 +124,125 @@ bool btAudioHttpConnected = false;
 unsigned long btAudioBytesReceived = 0;
 unsigned long btAudioBytesSent = 0;
 float btAudioBufferLevel = 0;           // Livello buffer 0-100%
+volatile uint32_t btUnderruns = 0;      // Callback A2DP senza abbastanza audio
+volatile uint32_t btUnderrunFrames = 0; // Frame riempiti con silenzio
+volatile uint32_t btSkippedFrames = 0;  // Frame scartati per risincronizzare
+volatile uint32_t btHeldFrames = 0;     // Frame di silenzio inseriti per risincronizzare
+uint32_t btOverrunFrames = 0;           // Frame HTTP persi a ring pieno
+uint32_t btResyncs = 0;                 // Salti/inserimenti richiesti dal controllo
 
 #ifdef BT_A2DP_AVAILABLE
 BluetoothA2DPSource a2dp_source;
 
 // ================== CALLBACK A2DP ==================
+// Copia fino a count frame dal ring (due segmenti) senza spostare la coda
+static uint32_t btRingPeek(uint32_t* dst, uint32_t tail, uint32_t count) {
+  uint32_t pos = tail & (BT_AUDIO_RING_FRAMES - 1);
+  uint32_t first = min(count, (uint32_t)BT_AUDIO_RING_FRAMES - pos);
+  memcpy(dst, btAudioRing + pos, first * sizeof(uint32_t));
+  if (count > first) memcpy(dst + first, btAudioRing, (count - first) * sizeof(uint32_t));
+  return count;
+}
+
+// Interpolazione lineare dei due canali (peso Q15: differenza 17 bit x 15 bit sta in 32 bit)
+static inline uint32_t btLerpFrame(uint32_t a, uint32_t b, int32_t w) {
+  int32_t l = (int16_t)(a & 0xFFFF);
+  int32_t r = (int16_t)(a >> 16);
+  l += (((int32_t)(int16_t)(b & 0xFFFF) - l) * w) >> 15;
+  r += (((int32_t)(int16_t)(b >> 16) - r) * w) >> 15;
+  return (uint16_t)l | ((uint32_t)(uint16_t)r << 16);
+}
+
+// Produce n frame (n <= BT_AUDIO_CHUNK_FRAMES) ricampionati; restituisce i frame prodotti
+static int32_t btResampleChunk(uint32_t* out, int32_t n) {
+  uint32_t tail = btRingTail.load(std::memory_order_relaxed);
+  uint32_t avail = btRingHead.load(std::memory_order_acquire) - tail;
+  int64_t step = (1LL << 32) + btResampleDelta.load(std::memory_order_relaxed);
+
+  // Frame in ingresso necessari: indice dell'ultimo campione prodotto + 1 per l'interpolazione
+  uint32_t need = (uint32_t)(((int64_t)btResamplePhase + step * (n - 1)) >> 32) + 2;
+  if (need > avail) {
+    // Underrun: si producono solo i frame coperti dall'audio presente
+    if (avail < 2) return 0;
+    need = avail;
+  }
+  btRingPeek(btResampleIn, tail, need);
+
+  int64_t pos = btResamplePhase;   // Q32 relativa al primo frame del blocco
+  int32_t produced = 0;
+  while (produced < n) {
+    uint32_t i = (uint32_t)(pos >> 32);
+    if (i + 1 >= need) break;
+    out[produced++] = btLerpFrame(btResampleIn[i], btResampleIn[i + 1], (int32_t)((uint32_t)pos >> 17));
+    pos += step;
+  }
+
+  btResamplePhase = (uint32_t)pos;
+  btRingTail.store(tail + (uint32_t)(pos >> 32), std::memory_order_release);
+  return produced;
+}
+
 // Callback chiamata quando A2DP richiede dati audio
 int32_t btAudioDataCallback(Frame *frame, int32_t frame_count) {
-  if (!btAudioStreaming || btAudioBuffer == nullptr) {
+  if (!btAudioStreaming || btAudioRing == nullptr) {
     // Nessun audio disponibile - invia silenzio
     memset(frame, 0, frame_count * sizeof(Frame));
     return frame_count;
   }
 
-  int samplesNeeded = frame_count * 2;  // Stereo = 2 samples per frame
-  int samplesAvailable = btAudioBufferCount;
-  int samplesToCopy = min(samplesNeeded, samplesAvailable);
-
-  if (samplesToCopy < samplesNeeded) {
-    // Buffer underrun - riempi con silenzio quello che manca
-    memset(frame, 0, frame_count * sizeof(Frame));
+  uint32_t* out = (uint32_t*)frame;
+  int32_t done = 0;
+
+  // Richieste di risincronizzazione dal loop: scarto (audio in anticipo) o silenzio (in ritardo)
+  uint32_t skip = btRingSkip.exchange(0, std::memory_order_acq_rel);
+  if (skip > 0) {
+    uint32_t tail = btRingTail.load(std::memory_order_relaxed);
+    uint32_t avail = btRingHead.load(std::memory_order_acquire) - tail;
+    if (skip > avail) skip = avail;
+    btRingTail.store(tail + skip, std::memory_order_release);
+    btSkippedFrames += skip;
+  }
+  // Il loop puo' riscrivere btRingHold tra lettura e decremento: si sottrae solo dal valore
+  // letto (CAS), altrimenti una nuova richiesta piu' piccola andrebbe sotto zero
+  uint32_t hold = btRingHold.load(std::memory_order_relaxed);
+  uint32_t held = 0;
+  while (hold > 0) {
+    held = min((uint32_t)frame_count, hold);
+    if (btRingHold.compare_exchange_weak(hold, hold - held, std::memory_order_relaxed)) break;
+    held = 0;
+  }
+  if (held > 0) {
+    memset(out, 0, held * sizeof(uint32_t));
+    btHeldFrames += held;
+    done = held;
   }
 
-  // Copia samples dal buffer circolare
-  for (int i = 0; i < samplesToCopy / 2; i++) {
-    frame[i].channel1 = btAudioBuffer[btAudioReadPos];
-    btAudioReadPos = (btAudioReadPos + 1) % BT_AUDIO_BUFFER_SIZE;
-    frame[i].channel2 = btAudioBuffer[btAudioReadPos];
-    btAudioReadPos = (btAudioReadPos + 1) % BT_AUDIO_BUFFER_SIZE;
-    btAudioBufferCount -= 2;
+  // Dopo un underrun si riparte solo con il ring di nuovo pieno quanto serve
+  if (btRingPriming) {
+    uint32_t avail = btRingHead.load(std::memory_order_acquire) - btRingTail.load(std::memory_order_relaxed);
+    if (avail >= btRingPrime.load(std::memory_order_relaxed)) {
+      btRingPriming = false;
+    } else {
+      memset(out + done, 0, (frame_count - done) * sizeof(uint32_t));
+      return frame_count;
+    }
   }
 
-  btAudioBytesSent += samplesToCopy * sizeof(int16_t);
-  btAudioBufferLevel = (float)btAudioBufferCount / BT_AUDIO_BUFFER_SIZE * 100.0;
+  while (done < frame_count) {
+    int32_t n = min((int32_t)BT_AUDIO_CHUNK_FRAMES, frame_count - done);
+    int32_t got = btResampleChunk(out + done, n);
+    done += got;
+    if (got < n) {
+      // Underrun: silenzio solo sui frame mancanti, poi nuovo riempimento
+      memset(out + done, 0, (frame_count - done) * sizeof(uint32_t));
+      btUnderruns++;
+      btUnderrunFrames += frame_count - done;
+      btRingPriming = true;
+      break;
+    }
+  }
 
+  btAudioBytesSent += done * sizeof(Frame);
   return frame_count;
 }
 
@@ -137,21 +273,30 @@ bool initBtAudio() {
 #ifdef BT_A2DP_AVAILABLE
   Serial.println("[BT-A2DP] Inizializzazione Bluetooth A2DP Source...");
 
-  // Alloca buffer audio in PSRAM
-  if (btAudioBuffer == nullptr) {
-    btAudioBuffer = (int16_t *)heap_caps_malloc(BT_AUDIO_BUFFER_SIZE * sizeof(int16_t), MALLOC_CAP_SPIRAM);
-    if (btAudioBuffer == nullptr) {
+  // Alloca ring audio in PSRAM
+  if (btAudioRing == nullptr) {
+    btAudioRing = (uint32_t *)heap_caps_malloc(BT_AUDIO_RING_FRAMES * sizeof(uint32_t), MALLOC_CAP_SPIRAM);
+    if (btAudioRing == nullptr) {
       Serial.println("[BT-A2DP] ERRORE: Impossibile allocare buffer audio!");
       return false;
     }
-    memset(btAudioBuffer, 0, BT_AUDIO_BUFFER_SIZE * sizeof(int16_t));
-    Serial.printf("[BT-A2DP] Buffer audio allocato: %d KB\n", (BT_AUDIO_BUFFER_SIZE * sizeof(int16_t)) / 1024);
+    memset(btAudioRing, 0, BT_AUDIO_RING_FRAMES * sizeof(uint32_t));
+    Serial.printf("[BT-A2DP] Buffer audio allocato: %d KB\n", (BT_AUDIO_RING_FRAMES * sizeof(uint32_t)) / 1024);
   }
 
-  // Reset posizioni buffer
-  btAudioWritePos = 0;
-  btAudioReadPos = 0;
-  btAudioBufferCount = 0;
+  // Reset ring (il consumatore non è ancora avviato)
+  btRingHead.store(0);
+  btRingTail.store(0);
+  btRingSkip.store(0);
+  btRingHold.store(0);
+  btRingPrime.store((uint32_t)AUDIO_SYNC_BUFFER_MS * BT_AUDIO_SAMPLE_RATE / 1000);
+  btRingPriming = true;
+  btResamplePhase = 0;
+  btResampleDelta.store(0);
+  btRxCarryLen = 0;
+  btDriftPpm = 0;
+  btCorrectionPpm = 0;
+  btErrAvgMs = 0;
 
   // Configura A2DP source
   a2dp_source.set_auto_reconnect(true);
@@ -231,6 +376,12 @@ bool connectBtAudioHttp(const String& baseUrl) {
   int httpCode = btAudioHttp.GET();
 
   if (httpCode == HTTP_CODE_OK) {
+    // Nuovo stream: scarta l'audio rimasto dal precedente
+    btRingSkip.store(btRingHead.load() - btRingTail.load());
+    btRxCarryLen = 0;
+    btRxHeaderLen = 0;
+    btRxRecordLeft = 0;
+    audioTimestamp = 0;
     btAudioHttpConnected = true;
     Serial.println("[BT-AUDIO] Stream audio HTTP connesso!");
     return true;
@@ -251,9 +402,104 @@ void disconnectBtAudioHttp() {
 }
 
 // ================== RICEVI DATI AUDIO DAL SERVER ==================
+// Scrive n frame nel ring (due segmenti); restituisce i frame scritti
+static uint32_t btRingWrite(const uint32_t* src, uint32_t n) {
+  uint32_t head = btRingHead.load(std::memory_order_relaxed);
+  uint32_t space = BT_AUDIO_RING_FRAMES - (head - btRingTail.load(std::memory_order_acquire));
+  if (n > space) {
+    btOverrunFrames += n - space;
+    n = space;
+  }
+  uint32_t pos = head & (BT_AUDIO_RING_FRAMES - 1);
+  uint32_t first = min(n, (uint32_t)BT_AUDIO_RING_FRAMES - pos);
+  memcpy(btAudioRing + pos, src, first * sizeof(uint32_t));
+  if (n > first) memcpy(btAudioRing, src + first, (n - first) * sizeof(uint32_t));
+  btRingHead.store(head + n, std::memory_order_release);
+  return n;
+}
+
+// Controllo di deriva: porta il riempimento del ring al valore che allinea l'audio in
+// uscita al video. Errori piccoli -> ricampionamento (ppm), errori grandi -> salto/silenzio.
+static void btDriftUpdate() {
+  uint32_t now = millis();
+  if (now - btDriftLastMs < BT_DRIFT_UPDATE_MS) return;
+  float dt = (btDriftLastMs == 0) ? 0 : (now - btDriftLastMs) / 1000.0f;
+  btDriftLastMs = now;
+
+  uint32_t fill = btRingHead.load(std::memory_order_acquire) - btRingTail.load(std::memory_order_acquire);
+  float fillMs = fill * 1000.0f / BT_AUDIO_SAMPLE_RATE;
+  const int32_t maxFillMs = BT_AUDIO_RING_FRAMES * 1000 / BT_AUDIO_SAMPLE_RATE - BT_AUDIO_MIN_FILL_MS;
+
+  // Con entrambi i timestamp: l'audio in testa al ring e' audioTimestamp, quello in uscita
+  // e' indietro di fillMs. Per il lip-sync il ring deve contenere (audio - video) ms.
+  // Il frame a schermo resta visibile fino al successivo: il video "adesso" e' il suo timestamp
+  // piu' il tempo da quando e' apparso (senza, l'obiettivo avrebbe un dente di sega di un frame).
+  // audioTimestamp e fill salgono insieme a ogni blocco ricevuto, l'errore non ha quei gradini.
+  int32_t target = AUDIO_SYNC_BUFFER_MS;
+  if (audioTimestamp > 0 && videoTimestamp > 0 && now - btVideoAtMs < BT_VIDEO_STALE_MS) {
+    target = (int32_t)(audioTimestamp - (videoTimestamp + (now - btVideoAtMs)));
+    btLipSyncMs = target - (int32_t)fillMs;
+  }
+  btTargetFillMs = constrain(target, BT_AUDIO_MIN_FILL_MS, maxFillMs);
+  btRingPrime.store((uint32_t)btTargetFillMs * BT_AUDIO_SAMPLE_RATE / 1000, std::memory_order_relaxed);
+  float errMs = fillMs - btTargetFillMs;
+
+  // Durante il riempimento iniziale il livello non dice nulla sulla deriva
+  if (btRingPriming || !btAudioStreaming) {
+    btErrAvgMs = errMs;
+    return;
+  }
+
+  btErrAvgMs += (errMs - btErrAvgMs) / 8;
+  errMs = btErrAvgMs;
+
+  if (fabsf(errMs) > BT_AUDIO_RESYNC_MS) {
+    uint32_t frames = (uint32_t)(fabsf(errMs) * BT_AUDIO_SAMPLE_RATE / 1000);
+    if (errMs > 0) btRingSkip.store(frames, std::memory_order_release);
+    else btRingHold.store(frames, std::memory_order_release);
+    btErrAvgMs = 0;
+    btResyncs++;
+    return;
+  }
+
+  // PI: il termine integrale converge alla differenza tra i due clock.
+  // 1 ppm sposta il riempimento di 1 ms ogni 1000 s: Kp 50 ppm/ms, Ki 0.5 ppm/(ms*s)
+  // danno un anello smorzato (zeta ~1): l'errore si assesta in circa un minuto, la stima della
+  // deriva in qualche minuto (tests/host/bt_drift.cpp: +-480 ppm entro 1 ppm in 600 s).
+  btDriftPpm = constrain(btDriftPpm + errMs * 0.5f * dt, -(float)BT_DRIFT_MAX_PPM, (float)BT_DRIFT_MAX_PPM);
+  btCorrectionPpm = constrain(btDriftPpm + errMs * 50.0f, -(float)BT_CORRECTION_MAX_PPM, (float)BT_CORRECTION_MAX_PPM);
+  btResampleDelta.store((int32_t)(btCorrectionPpm * 4294.967296f), std::memory_order_relaxed);
+}
+
+// Separa intestazioni e PCM dei byte letti: il PCM viene accodato a pcm (da len byte),
+// restituisce la nuova lunghezza
+static int btRxParse(const uint8_t* raw, int count, uint8_t* pcm, int len) {
+  int i = 0;
+  while (i < count) {
+    if (btRxRecordLeft == 0) {
+      btRxHeader[btRxHeaderLen++] = raw[i++];
+      if (btRxHeaderLen == BT_PCM_HEADER_BYTES) {
+        const uint8_t* h = btRxHeader;
+        btRxRecordTs = ((uint32_t)h[0] << 24) | ((uint32_t)h[1] << 16) | ((uint32_t)h[2] << 8) | h[3];
+        btRxRecordLeft = ((uint32_t)h[4] << 24) | ((uint32_t)h[5] << 16) | ((uint32_t)h[6] << 8) | h[7];
+        btRxRecordBytes = 0;
+        btRxHeaderLen = 0;
+      }
+      continue;
+    }
+    int n = min(count - i, (int)btRxRecordLeft);
+    memcpy(pcm + len, raw + i, n);
+    len += n;
+    i += n;
+    btRxRecordLeft -= n;
+    btRxRecordBytes += n;
+  }
+  return len;
+}
+
 // Chiamare regolarmente nel loop per riempire il buffer audio
 void updateBtAudioReceive() {
-  if (!btAudioHttpConnected || btAudioBuffer == nullptr) return;
+  if (!btAudioHttpConnected || btAudioRing == nullptr) return;
 
   WiFiClient* stream = btAudioHttp.getStreamPtr();
   if (!stream || !stream->connected()) {
@@ -261,34 +507,45 @@ void updateBtAudioReceive() {
     return;
   }
 
-  // Leggi dati disponibili
-  int available = stream->available();
-  if (available > 0) {
-    // Limita lettura per non bloccare troppo
-    int toRead = min(available, 1024);
-
-    // Leggi come bytes, converti in int16_t
-    uint8_t tempBuffer[1024];
-    int bytesRead = stream->readBytes(tempBuffer, toRead);
-
-    // Converti e aggiungi al buffer circolare
-    int16_t* samples = (int16_t*)tempBuffer;
-    int sampleCount = bytesRead / sizeof(int16_t);
+  // Leggi dati disponibili (frame interi; i byte in eccesso restano per la lettura successiva).
+  // Piu' letture da 1 KB per chiamata: il loop MJPEG passa di qui una volta per frame video.
+  for (int reads = 0; reads < BT_PCM_MAX_READS; reads++) {
+    int available = stream->available();
+    uint32_t space = BT_AUDIO_RING_FRAMES - (btRingHead.load(std::memory_order_relaxed) - btRingTail.load(std::memory_order_acquire));
+    if (available <= 0 || space == 0) break;
+
+    uint8_t raw[1024];
+    uint32_t tempBuffer[sizeof(raw) / sizeof(uint32_t) + 1];
+    uint8_t* bytes = (uint8_t*)tempBuffer;
+    int toRead = min(available, (int)sizeof(raw));
+    toRead = min(toRead, (int)(space * sizeof(uint32_t)));
+    int bytesRead = stream->readBytes(raw, toRead);
+    if (bytesRead <= 0) break;
+
+    memcpy(bytes, btRxCarry, btRxCarryLen);
+    int total = btRxParse(raw, bytesRead, bytes, btRxCarryLen);
+    uint32_t frames = total / sizeof(uint32_t);
+    btRingWrite(tempBuffer, frames);
+
+    btRxCarryLen = total - frames * sizeof(uint32_t);
+    memcpy(btRxCarry, bytes + frames * sizeof(uint32_t), btRxCarryLen);
+    btAudioBytesReceived += bytesRead;
 
-    for (int i = 0; i < sampleCount && btAudioBufferCount < BT_AUDIO_BUFFER_SIZE - 1; i++) {
-      btAudioBuffer[btAudioWritePos] = samples[i];
-      btAudioWritePos = (btAudioWritePos + 1) % BT_AUDIO_BUFFER_SIZE;
-      btAudioBufferCount++;
+    // Audio in testa al ring: timestamp del blocco + PCM gia' scritto (il resto e' in btRxCarry)
+    if (frames > 0) {
+      uint32_t written = btRxRecordBytes > btRxCarryLen ? btRxRecordBytes - btRxCarryLen : 0;
+      setBtAudioTimestamp(btRxRecordTs + written * 1000UL / (BT_AUDIO_SAMPLE_RATE * sizeof(uint32_t)));
     }
-
-    btAudioBytesReceived += bytesRead;
   }
+
+  btDriftUpdate();
 }
 
 // ================== IMPOSTA TIMESTAMP VIDEO ==================
 // Chiamata da MJPEG stream quando riceve un nuovo frame con timestamp
 void setBtVideoTimestamp(unsigned long timestamp) {
   videoTimestamp = timestamp;
+  btVideoAtMs = millis();
 
   // Calcola offset se abbiamo entrambi i timestamp
   if (audioTimestamp > 0 && videoTimestamp > 0) {
@@ -297,6 +554,7 @@ void setBtVideoTimestamp(unsigned long timestamp) {
 }
 
 // ================== IMPOSTA TIMESTAMP AUDIO ==================
+// Chiamata da updateBtAudioReceive con il timestamp dell'audio in testa al ring
 void setBtAudioTimestamp(unsigned long timestamp) {
   audioTimestamp = timestamp;
 }
@@ -321,7 +579,20 @@ String getBtAudioStatus() {
   status += "\"connected\":" + String(btAudioConnected ? "true" : "false") + ",";
   status += "\"streaming\":" + String(btAudioStreaming ? "true" : "false") + ",";
   status += "\"device\":\"" + btConnectedDevice + "\",";
+  uint32_t fill = btRingHead.load() - btRingTail.load();
+  btAudioBufferLevel = (float)fill / BT_AUDIO_RING_FRAMES * 100.0;
   status += "\"bufferLevel\":" + String(btAudioBufferLevel, 1) + ",";
+  status += "\"bufferMs\":" + String(fill * 1000UL / BT_AUDIO_SAMPLE_RATE) + ",";
+  status += "\"targetMs\":" + String(btTargetFillMs) + ",";
+  status += "\"underruns\":" + String(btUnderruns) + ",";
+  status += "\"underrunFrames\":" + String(btUnderrunFrames) + ",";
+  status += "\"overrunFrames\":" + String(btOverrunFrames) + ",";
+  status += "\"driftPpm\":" + String(btDriftPpm, 1) + ",";
+  status += "\"correctionPpm\":" + String(btCorrectionPpm, 1) + ",";
+  status += "\"resyncs\":" + String(btResyncs) + ",";
+  status += "\"skippedFrames\":" + String(btSkippedFrames) + ",";
+  status += "\"heldFrames\":" + String(btHeldFrames) + ",";
+  status += "\"lipSyncMs\":" + String(btLipSyncMs) + ",";
   status += "\"bytesReceived\":" + String(btAudioBytesReceived) + ",";
   status += "\"bytesSent\":" + String(btAudioBytesSent) + ",";
   status += "\"syncOffset\":" + String(audioVideoOffset);
@@ -554,7 +825,8 @@ const char BT_AUDIO_CONFIG_HTML[] PROGMEM =
 "'Buffer: '+d.bufferLevel.toFixed(1)+'%% | '+"
 "'Ricevuti: '+(d.bytesReceived/1024).toFixed(1)+'KB | '+"
 "'Inviati: '+(d.bytesSent/1024).toFixed(1)+'KB | '+"
-"'Sync: '+d.syncOffset+'ms';"
+"'Sync: '+d.syncOffset+'ms<br>'+"
+"'Underrun: '+d.underruns+' | Deriva: '+d.driftPpm.toFixed(1)+' ppm | Lip-sync: '+d.lipSyncMs+'ms';"
 "}).catch(()=>{})}"
 "function scan(){var m=document.getElementById('scanMsg'),b=document.getElementById('scanBtn');"
 "m.className='msg info';m.textContent='Scansione in corso (10 sec)...';"
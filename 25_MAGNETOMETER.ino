@@ -44,16 +44,31 @@ int16_t magMinX = 32767, magMaxX = -32768;
 int16_t magMinY = 32767, magMaxY = -32768;
 int16_t magMinZ = 32767, magMaxZ = -32768;
 
+// ================== LETTURA TRAMITE ARBITRO I2C ==================
+// Ogni accesso al QMC5883P passa da i2cBusRun() (0_I2C_BUS.ino): una transazione
+// breve per volta, cosi' calibrazione e bussola non ritardano le letture del touch.
+// onlyIfReady: ritorna false senza leggere se il campione non e' ancora pronto.
+bool magReadRaw(int16_t &x, int16_t &y, int16_t &z, bool onlyIfReady) {
+  struct MagRead { int16_t x, y, z; bool onlyIfReady, ready; };
+  MagRead m = { 0, 0, 0, onlyIfReady, false };
+  bool ok = i2cBusRun(I2C_DEV_MAG, [](void *a) {
+    MagRead &r = *(MagRead *)a;
+    if (r.onlyIfReady && !qmc.isDataReady()) return true;   // Non pronto: non e' un errore di bus
+    r.ready = qmc.getRawMagnetic(&r.x, &r.y, &r.z);
+    return r.ready;
+  }, &m);
+  if (!ok || !m.ready) return false;
+  x = m.x; y = m.y; z = m.z;
+  return true;
+}
+
 // ================== SCAN I2C BUS ==================
 void scanI2CBus() {
   Serial.println("[MAG] Scansione bus I2C...");
   int deviceCount = 0;
 
   for (uint8_t address = 1; address < 127; address++) {
-    Wire.beginTransmission(address);
-    uint8_t error = Wire.endTransmission();
-
-    if (error == 0) {
+    if (i2cBusProbe(I2C_DEV_MAG, address)) {
       Serial.printf("  [I2C] 0x%02X", address);
       if (address == 0x5D || address == 0x14) Serial.print(" (GT911 Touch)");
       else if (address == 0x0C || address == 0x2C) Serial.print(" (QMC5883P Magnetometer)");
@@ -156,7 +171,7 @@ void calibrateMagnetometerGuided() {
 
   while (millis() - startTime < totalTime * 1000) {
     int16_t x, y, z;
-    if (qmc.getRawMagnetic(&x, &y, &z)) {
+    if (magReadRaw(x, y, z, false)) {
       if (x < magMinX) magMinX = x;
       if (x > magMaxX) magMaxX = x;
       if (y < magMinY) magMinY = y;
@@ -244,7 +259,7 @@ void setup_magnetometer() {
 
   for (int i = 0; i < 2; i++) {
     Serial.printf("\n[MAG] Provo indirizzo 0x%02X...\n", addresses[i]);
-    if (qmc.begin(addresses[i], &Wire)) {
+    if (i2cBusRun(I2C_DEV_MAG, [](void *a) { return qmc.begin(*(uint8_t *)a, &Wire); }, &addresses[i])) {
       magAddress = addresses[i];
       found = true;
       Serial.printf("[MAG] QMC5883P trovato a 0x%02X!\n", magAddress);
@@ -260,11 +275,14 @@ void setup_magnetometer() {
   }
 
   // Configura il sensore
-  qmc.setMode(QMC5883P_MODE_CONTINUOUS);
-  qmc.setODR(QMC5883P_ODR_100HZ);
-  qmc.setRange(QMC5883P_RANGE_8G);
-  qmc.setOSR(QMC5883P_OSR_8);
-  qmc.setSetResetMode(QMC5883P_SETRESET_ON);
+  i2cBusRun(I2C_DEV_MAG, [](void *) {
+    qmc.setMode(QMC5883P_MODE_CONTINUOUS);
+    qmc.setODR(QMC5883P_ODR_100HZ);
+    qmc.setRange(QMC5883P_RANGE_8G);
+    qmc.setOSR(QMC5883P_OSR_8);
+    qmc.setSetResetMode(QMC5883P_SETRESET_ON);
+    return true;
+  }, nullptr);
 
   magnetometerConnected = true;
 
@@ -285,7 +303,7 @@ void setup_magnetometer() {
 
   // Test lettura
   int16_t tx, ty, tz;
-  if (qmc.getRawMagnetic(&tx, &ty, &tz)) {
+  if (magReadRaw(tx, ty, tz, false)) {
     Serial.printf("[MAG] Test: X=%d Y=%d Z=%d\n", tx, ty, tz);
   }
 
@@ -301,10 +319,8 @@ void updateMagnetometer() {
   if (!magnetometerConnected) return;
 
   // Aspetta dati pronti
-  if (!qmc.isDataReady()) return;
-
   int16_t rawX, rawY, rawZ;
-  if (!qmc.getRawMagnetic(&rawX, &rawY, &rawZ)) return;
+  if (!magReadRaw(rawX, rawY, rawZ, true)) return;
 
   // Applica calibrazione
   float calX = (rawX - magOffsetX) * magScaleX;
@@ -31,7 +31,7 @@ void setLanguage(Language lang) {
     if (lang < LANG_COUNT) {
         currentLanguage = lang;
         EEPROM.write(EEPROM_LANGUAGE_ADDR, (uint8_t)lang);
-        EEPROM.commit();
+        settingsCommit();
         Serial.printf("[LANGUAGE] Lingua impostata: %s\n",
                       lang == LANG_IT ? "Italiano" : "English");
     }
@@ -226,7 +226,7 @@ void saveModeColor(uint8_t modeId, uint8_t r, uint8_t g, uint8_t b) {
   EEPROM.write(addr, r);
   EEPROM.write(addr + 1, g);
   EEPROM.write(addr + 2, b);
-  EEPROM.commit();
+  settingsCommit();
   Serial.printf("[MODE COLOR] Salvato colore mode %d: R%d G%d B%d\n", modeId, r, g, b);
 }
 
@@ -296,7 +296,7 @@ void saveModePreset(uint8_t modeId, uint8_t presetId) {
 
   uint16_t addr = EEPROM_MODE_PRESETS_BASE + idx;
   EEPROM.write(addr, presetId);
-  EEPROM.commit();
+  settingsCommit();
   delay(10);  // Piccolo delay per assicurare scrittura flash
 }
 
@@ -636,7 +636,7 @@ void saveEnabledModes() {
   EEPROM.write(EEPROM_ENABLED_MODES_ADDR + 2, (enabledModesMask >> 8) & 0xFF);
   EEPROM.write(EEPROM_ENABLED_MODES_ADDR + 3, enabledModesMask & 0xFF);
   EEPROM.write(EEPROM_ENABLED_MODES_EXT_ADDR, (enabledModesMask >> 32) & 0xFF);
-  EEPROM.commit();
+  settingsCommit();
   Serial.printf("[SETTINGS] Modalità abilitate salvate: 0x%02X%08lX\n",
                 (uint8_t)((enabledModesMask >> 32) & 0xFF),
                 (uint32_t)(enabledModesMask & 0xFFFFFFFF));
@@ -982,12 +982,8 @@ void handleSettingsSave(AsyncWebServerRequest *request) {
       EEPROM.write(EEPROM_BRIGHTNESS_DAY_ADDR, brightnessDay);
       changed = true;
       Serial.printf("[SETTINGS] brightnessDay = %d\n", brightnessDay);
-      // APPLICA IMMEDIATAMENTE se è giorno
-      if (!checkIsNightTime(currentHour, currentMinute)) {
-        ledcWrite(PWM_CHANNEL, brightnessDay);
-        lastAppliedBrightness = brightnessDay;
-        Serial.printf("[SETTINGS] Luminosità GIORNO applicata subito: %d\n", brightnessDay);
-      }
+      // APPLICA SUBITO (se è giorno e in modalità manuale) con rampa breve
+      backlightRequestUpdate(BL_RAMP_SETTINGS_MS);
     }
   }
 
@@ -1000,12 +996,8 @@ void handleSettingsSave(AsyncWebServerRequest *request) {
       EEPROM.write(EEPROM_BRIGHTNESS_NIGHT_ADDR, brightnessNight);
       changed = true;
       Serial.printf("[SETTINGS] brightnessNight = %d\n", brightnessNight);
-      // APPLICA IMMEDIATAMENTE se è notte
-      if (checkIsNightTime(currentHour, currentMinute)) {
-        ledcWrite(PWM_CHANNEL, brightnessNight);
-        lastAppliedBrightness = brightnessNight;
-        Serial.printf("[SETTINGS] Luminosità NOTTE applicata subito: %d\n", brightnessNight);
-      }
+      // APPLICA SUBITO (se è notte e in modalità manuale) con rampa breve
+      backlightRequestUpdate(BL_RAMP_SETTINGS_MS);
     }
   }
 
@@ -1179,7 +1171,7 @@ void handleSettingsSave(AsyncWebServerRequest *request) {
     if (val != setupOptions.touchSoundsVolume) {
       setupOptions.touchSoundsVolume = val;
       EEPROM.write(EEPROM_TOUCH_SOUNDS_VOLUME_ADDR, val);
-      EEPROM.commit();
+      settingsCommit();
       changed = true;
       Serial.printf("[SETTINGS] touchSoundsVolume = %d\n", val);
     }
@@ -1190,7 +1182,7 @@ void handleSettingsSave(AsyncWebServerRequest *request) {
     if (val != setupOptions.vuMeterShowEnabled) {
       setupOptions.vuMeterShowEnabled = val;
       EEPROM.write(EEPROM_VUMETER_ENABLED_ADDR, val ? 1 : 0);
-      EEPROM.commit();
+      settingsCommit();
       changed = true;
       Serial.printf("[SETTINGS] vuMeterShow = %s\n", val ? "ON" : "OFF");
     }
@@ -1480,7 +1472,7 @@ void handleSettingsSave(AsyncWebServerRequest *request) {
 
   // Salva tutte le modifiche
   if (changed) {
-    EEPROM.commit();
+    settingsCommit();
     saveSetupOptions();
     Serial.println("[SETTINGS] ✓ Impostazioni salvate con successo");
   } else {
@@ -1497,7 +1489,7 @@ void handleSettingsReset(AsyncWebServerRequest *request) {
 
   // Cancella marker EEPROM per forzare reinizializzazione
   EEPROM.write(0, 0xFF);
-  EEPROM.commit();
+  settingsFlush();
 
   request->send(200, "text/plain", "OK");
 
@@ -1525,7 +1517,7 @@ void handleSettingsSetMode(AsyncWebServerRequest *request) {
       currentMode = (DisplayMode)mode;
       userMode = currentMode;
       EEPROM.write(EEPROM_MODE_ADDR, mode);
-      EEPROM.commit();
+      settingsCommit();
 
       // Carica il preset salvato per questa modalità
       uint8_t savedPreset = loadModePreset(mode);
@@ -1582,7 +1574,7 @@ void handleSettingsSetMode(AsyncWebServerRequest *request) {
           Serial.printf("[SETTINGS] Colore custom mode %d caricato: R%d G%d B%d\n", mode, r, g, b);
         }
       }
-      EEPROM.commit();
+      settingsCommit();
 
       // Forza ridisegno
       gfx->fillScreen(BLACK);
@@ -1663,7 +1655,7 @@ void handleSettingsSaveModes(AsyncWebServerRequest *request) {
       Serial.printf("[SETTINGS] Modalità corrente %d disabilitata, segnalo switch a FADE\n", currentMode);
       userMode = MODE_FADE;
       EEPROM.write(EEPROM_MODE_ADDR, (uint8_t)MODE_FADE);
-      EEPROM.commit();
+      settingsCommit();
       pendingModeSwitch = true;  // Il main loop farà cleanup + forceDisplayUpdate
     }
 
@@ -1737,7 +1729,7 @@ void handleResetModeColor(AsyncWebServerRequest *request) {
   EEPROM.write(EEPROM_COLOR_R_ADDR, r);
   EEPROM.write(EEPROM_COLOR_G_ADDR, g);
   EEPROM.write(EEPROM_COLOR_B_ADDR, b);
-  EEPROM.commit();
+  settingsCommit();
 
   webForceDisplayUpdate = true;
 
@@ -1793,7 +1785,7 @@ void handleSaveBME280Calibration(AsyncWebServerRequest *request) {
   if (changed) {
     // Scrivi marker validità calibrazione
     EEPROM.write(EEPROM_BME280_CALIB_VALID_ADDR, EEPROM_BME280_CALIB_VALID_VALUE);
-    EEPROM.commit();
+    settingsCommit();
     Serial.println("[BME280 CALIB] ✓ Calibrazione salvata con successo");
 
     // Forza rilettura immediata del sensore per applicare i nuovi offset
@@ -1828,7 +1820,7 @@ void handleResetBME280Calibration(AsyncWebServerRequest *request) {
   EEPROM.write(EEPROM_BME280_HUM_OFFSET_ADDR, 0);
   EEPROM.write(EEPROM_BME280_HUM_OFFSET_ADDR + 1, 0);
   EEPROM.write(EEPROM_BME280_CALIB_VALID_ADDR, EEPROM_BME280_CALIB_VALID_VALUE);
-  EEPROM.commit();
+  settingsCommit();
 
   Serial.println("[BME280 CALIB] ✓ Reset completato");
 
@@ -1987,6 +1979,48 @@ void setup_settings_webserver(AsyncWebServer* server) {
   Serial.println("[SETTINGS WEB] ✓ GET /settings/dualdebug");
   #endif
 
+  // Stato archivio impostazioni: commit richiesti/eseguiti, byte scritti in flash, valori schema
+  server->on("/settings/store", HTTP_GET, [](AsyncWebServerRequest *request){
+    request->send(200, "application/json", getSettingsStoreJson());
+  });
+  Serial.println("[SETTINGS WEB] ✓ GET /settings/store");
+
+  // Timeline di avvio: passi, core, attesa dipendenze, durata, primo frame orologio
+  server->on("/boot", HTTP_GET, [](AsyncWebServerRequest *request){
+    request->send(200, "application/json", getBootJson());
+  });
+  Serial.println("[SETTINGS WEB] ✓ GET /boot");
+
+  // Input touch: letture I2C (totali e a riposo), eventi gesture, latenza touch -> evento
+  server->on("/touch/status", HTTP_GET, [](AsyncWebServerRequest *request){
+    request->send(200, "application/json", getTouchStatsJson());
+  });
+  Serial.println("[SETTINGS WEB] ✓ GET /touch/status");
+
+  // Endpoint stato arbitro I2C: latenza ed errori per dispositivo, cache BME280
+  server->on("/i2c/status", HTTP_GET, [](AsyncWebServerRequest *request){
+    request->send(200, "application/json", getI2cBusJson());
+  });
+  Serial.println("[SETTINGS WEB] ✓ GET /i2c/status");
+
+  // Endpoint frame governor: frequenza loop, % idle loop e core, risvegli
+  server->on("/governor/status", HTTP_GET, [](AsyncWebServerRequest *request){
+    request->send(200, "application/json", getFrameGovJson());
+  });
+  Serial.println("[SETTINGS WEB] ✓ GET /governor/status");
+
+  // Endpoint ciclo di vita modalita': stato cache, preparazioni, latenza cambio per coppia
+  server->on("/modes/lifecycle", HTTP_GET, [](AsyncWebServerRequest *request){
+    request->send(200, "application/json", getModeLifecycleJson());
+  });
+  Serial.println("[SETTINGS WEB] ✓ GET /modes/lifecycle");
+
+  // Endpoint cache skin: skin in PSRAM, tempi di decodifica (freddo) e decompressione (caldo)
+  server->on("/skins/cache", HTTP_GET, [](AsyncWebServerRequest *request){
+    request->send(200, "application/json", getSkinCacheJson());
+  });
+  Serial.println("[SETTINGS WEB] ✓ GET /skins/cache");
+
   server->on("/settings/getapikeys", HTTP_GET, handleGetApiKeys);
   Serial.println("[SETTINGS WEB] ✓ GET /settings/getapikeys");
 
@@ -30,7 +30,7 @@
 #define FLUX_ARM_BOTTOM_ANGLE     270.0f   // Braccio inferiore (dritto verso basso)
 
 // ================== PARAMETRI ANIMAZIONE (configurabili da web) ==================
-#define FLUX_MAX_PARTICLES 100        // Max particelle per braccio (per array)
+#define FLUX_MAX_PARTICLES 100        // Max particelle per braccio (capacità del sistema di particelle)
 uint8_t fluxAnimationSpeed = 10;      // ms tra frame (più basso = più veloce)
 uint16_t fluxNumParticles = 8;        // Particelle principali per braccio
 float fluxParticleSpeed = 0.15f;      // Velocità movimento (0.05-1.0 per ciclo)
@@ -39,6 +39,11 @@ float fluxParticleSpeed = 0.15f;      // Velocità movimento (0.05-1.0 per ciclo
 #define FLUX_TRAIL_LENGTH       8     // Numero di segmenti nella scia
 #define FLUX_TRAIL_SPACING      0.04f // Distanza tra segmenti scia
 
+// Punti e dispersione per segmento (dalla testa alla coda): 2 + 10*f e 3 + 5*f con f = (1 - t/8)^2
+static const uint8_t fluxTrailPoints[FLUX_TRAIL_LENGTH] = {12, 9, 7, 5, 4, 3, 2, 2};
+static const uint8_t fluxTrailSpread[FLUX_TRAIL_LENGTH] = {8, 6, 5, 4, 4, 3, 3, 3};
+#define FLUX_TRAIL_SPREAD_MAX   8
+
 // Colore configurabile (RGB separati)
 uint8_t fluxColorR = 255;             // Componente Rosso (default bianco)
 uint8_t fluxColorG = 255;             // Componente Verde
@@ -80,7 +85,7 @@ void saveFluxSettings() {
   EEPROM.write(EEPROM_FLUX_ANIM_SPEED_ADDR, fluxAnimationSpeed);
   EEPROM.write(EEPROM_FLUX_PART_SPEED_ADDR, (uint8_t)(fluxParticleSpeed * 100));
   EEPROM.write(EEPROM_FLUX_VALID_ADDR, EEPROM_FLUX_VALID_MARKER);
-  EEPROM.commit();
+  settingsCommit();
   Serial.println("[FLUX] Impostazioni salvate in EEPROM");
 }
 
@@ -118,19 +123,21 @@ void loadFluxSettings() {
 #define FLUX_COLOR_GLOW_YELLOW  0xCE40  // Giallo tenue per alone
 #define FLUX_COLOR_GLOW_ORANGE  0x8B00  // Arancione tenue per alone
 
-// ================== STRUTTURA PARTICELLA ==================
-struct FluxParticle {
-  float position;     // Posizione 0.0 (centro) - 1.0 (estremità)
-  float speed;        // Velocità individuale (leggera variazione)
-  uint8_t brightness; // Luminosità 0-255
-  bool active;        // Particella attiva
-};
-
 // ================== VARIABILI GLOBALI ==================
 uint16_t *fluxBackgroundBuffer = nullptr;
-
-// Array di particelle per ogni braccio
-static FluxParticle fluxParticles[3][FLUX_MAX_PARTICLES];
+bool fluxBackgroundLoaded = false;  // Sfondo gia' decodificato nel buffer (resta valido tra un ingresso e l'altro)
+
+// Geometria dei bracci precalcolata all'init: direzione verso l'esterno in Q15
+// (y dello schermo verso il basso), lunghezza e passo della scia in Q8
+static int32_t fluxArmDirX[3], fluxArmDirY[3];
+static int16_t fluxArmLength[3];
+static int32_t fluxTrailStepQ8[3];
+
+// Teste delle particelle nel motore condiviso (0_PARTICLES.ino): aux = braccio.
+// Il canvas ripristina dallo sfondo solo i rettangoli disegnati nel frame precedente.
+#define FLUX_CANVAS_RECTS (3 * FLUX_MAX_PARTICLES + 8)
+static ParticleSystem fluxHeads;
+static ParticleCanvas fluxCanvas;
 static unsigned long fluxLastUpdate = 0;
 static float fluxGlobalPhase = 0.0f;  // Fase globale per effetti sincronizzati
 
@@ -151,8 +158,9 @@ int fluxJpegDrawCallback(JPEGDRAW *pDraw) {
   return 1;
 }
 
-// Carica immagine di sfondo flux.jpg dalla SD
-bool loadFluxBackgroundToBuffer() {
+// Carica immagine di sfondo flux.jpg dalla SD con il decoder indicato
+// (decoder globale dal loop, decoder dedicato dal task di preparazione)
+bool decodeFluxBackground(JPEGDEC *decoder) {
   String filepath = "/Flux Capacitor.jpg";
 
   Serial.printf("[FLUX] Caricamento sfondo: '%s'\n", filepath.c_str());
@@ -199,11 +207,11 @@ bool loadFluxBackgroundToBuffer() {
   jpegFile.read(jpegBuffer, fileSize);
   jpegFile.close();
 
-  int result = jpeg.openRAM(jpegBuffer, fileSize, fluxJpegDrawCallback);
+  int result = decoder->openRAM(jpegBuffer, fileSize, fluxJpegDrawCallback);
   if (result == 1) {
-    jpeg.setPixelType(RGB565_LITTLE_ENDIAN);
-    jpeg.decode(0, 0, 0);
-    jpeg.close();
+    decoder->setPixelType(RGB565_LITTLE_ENDIAN);
+    decoder->decode(0, 0, 0);
+    decoder->close();
     Serial.println("[FLUX] Sfondo caricato con successo!");
   }
 
@@ -211,22 +219,79 @@ bool loadFluxBackgroundToBuffer() {
   return (result == 1);
 }
 
+bool loadFluxBackgroundToBuffer() {
+  return decodeFluxBackground(&jpeg);
+}
+
+// Preparazione in background (task di 2_MODE_LIFECYCLE): sfondo pronto prima dell'ingresso
+bool prepareFluxAssets(JPEGDEC *decoder) {
+  if (!fluxBackgroundLoaded) fluxBackgroundLoaded = decodeFluxBackground(decoder);
+  return fluxBackgroundLoaded;
+}
+
+// Rilascio su PSRAM scarsa: lo sfondo verra' ridecodificato al prossimo ingresso
+void releaseFluxAssets() {
+  fluxBackgroundLoaded = false;
+  if (fluxBackgroundBuffer != nullptr) {
+    free(fluxBackgroundBuffer);
+    fluxBackgroundBuffer = nullptr;
+  }
+}
+
+// Precalcola direzione e lunghezza dei 3 bracci (trigonometria solo qui)
+void initFluxArms() {
+  const float angles[3] = {FLUX_ARM_TOP_LEFT_ANGLE, FLUX_ARM_TOP_RIGHT_ANGLE, FLUX_ARM_BOTTOM_ANGLE};
+  const int16_t lengths[3] = {FLUX_ARM_TOP_LENGTH, FLUX_ARM_TOP_LENGTH, FLUX_ARM_BOTTOM_LENGTH};
+  for (int arm = 0; arm < 3; arm++) {
+    // Angolo antiorario con y verso l'alto: sullo schermo diventa -angolo
+    particleDirQ15(-angles[arm], &fluxArmDirX[arm], &fluxArmDirY[arm]);
+    fluxArmLength[arm] = lengths[arm];
+    fluxTrailStepQ8[arm] = (int32_t)(FLUX_TRAIL_SPACING * lengths[arm] * PART_ONE);
+  }
+}
+
+// Posiziona la testa i sul braccio a distanza distQ8 dal centro, diretta verso il centro
+static void fluxPlaceHead(uint16_t i, uint8_t arm, int32_t distQ8) {
+  // Velocità individuale (80-119% di quella configurata) in pixel/frame Q8
+  int32_t v = (int32_t)(fluxParticleSpeed * fluxArmLength[arm] * PART_ONE) * particleRandRange(80, 119) / 100;
+  if (v < 1) v = 1;
+  fluxHeads.x[i] = PART_PX(FLUX_CENTER_X) + ((fluxArmDirX[arm] * distQ8) >> 15);
+  fluxHeads.y[i] = PART_PX(FLUX_CENTER_Y) + ((fluxArmDirY[arm] * distQ8) >> 15);
+  fluxHeads.vx[i] = -((fluxArmDirX[arm] * v) >> 15);
+  fluxHeads.vy[i] = -((fluxArmDirY[arm] * v) >> 15);
+  fluxHeads.life[i] = max((int32_t)1, (distQ8 + v - 1) / v);  // Frame per arrivare al centro
+  fluxHeads.aux[i] = arm;
+}
+
+// Integratore: le teste scorrono verso il centro e ripartono dall'estremità
+static void fluxHeadIntegrate(ParticleSystem* ps) {
+  for (uint16_t i = 0; i < ps->count; i++) {
+    if (ps->life[i] <= 1) {
+      uint8_t arm = ps->aux[i];
+      fluxPlaceHead(i, arm, PART_PX(fluxArmLength[arm]));
+      continue;
+    }
+    ps->life[i]--;
+    ps->x[i] += ps->vx[i];
+    ps->y[i] += ps->vy[i];
+  }
+}
+
 // Inizializza le particelle con posizioni e velocità casuali
 void initFluxParticles() {
   // Aggiorna i colori RGB565
   updateFluxColors();
 
+  particleSeed(esp_random());
+  fluxHeads.count = 0;
+  fluxHeads.integrate = fluxHeadIntegrate;
   for (int arm = 0; arm < 3; arm++) {
+    int32_t lenQ8 = PART_PX(fluxArmLength[arm]);
     for (uint16_t i = 0; i < fluxNumParticles; i++) {
       // Distribuisci le particelle lungo il braccio
-      fluxParticles[arm][i].position = (float)i / fluxNumParticles;
-      fluxParticles[arm][i].speed = fluxParticleSpeed * (0.8f + (random(40) / 100.0f));
-      fluxParticles[arm][i].brightness = 200 + random(55);
-      fluxParticles[arm][i].active = true;
-    }
-    // Disattiva particelle oltre il limite
-    for (uint16_t i = fluxNumParticles; i < FLUX_MAX_PARTICLES; i++) {
-      fluxParticles[arm][i].active = false;
+      int idx = particleSpawn(&fluxHeads, 0, 0, 0, 0, 1, 0, PART_SPRITE_DOT);
+      if (idx < 0) break;
+      fluxPlaceHead(idx, arm, lenQ8 / fluxNumParticles * i);
     }
   }
 }
@@ -257,14 +322,19 @@ void initFluxCapacitor() {
     Serial.println("[FLUX] FrameBuffer allocato");
   }
 
-  // Crea GFX offscreen se non esiste
-  if (offscreenGfx == nullptr) {
-    offscreenGfx = new OffscreenGFX(frameBuffer, FLUX_SCREEN_WIDTH, FLUX_SCREEN_HEIGHT);
-    Serial.println("[FLUX] OffscreenGFX creato");
+  // Carica sfondo (salta la decodifica se e' ancora in PSRAM o preparato in background)
+  modeLifecycleClaim(MODE_FLUX_CAPACITOR);
+  if (!fluxBackgroundLoaded) {
+    fluxBackgroundLoaded = loadFluxBackgroundToBuffer();
   }
 
-  // Carica sfondo
-  loadFluxBackgroundToBuffer();
+  // Sistema di particelle e canvas (frameBuffer condiviso: il primo frame copia tutto lo sfondo)
+  initFluxArms();
+  if (fluxHeads.capacity < 3 * FLUX_MAX_PARTICLES) {
+    particleSystemAlloc(&fluxHeads, 3 * FLUX_MAX_PARTICLES);
+  }
+  particleCanvasBegin(&fluxCanvas, frameBuffer, fluxBackgroundBuffer,
+                      FLUX_SCREEN_WIDTH, FLUX_SCREEN_HEIGHT, FLUX_CANVAS_RECTS);
 
   // Inizializza particelle
   initFluxParticles();
@@ -277,81 +347,40 @@ void initFluxCapacitor() {
   Serial.println("[FLUX] Inizializzazione completata");
 }
 
-// Calcola posizione su un braccio
-// armIndex: 0=top-left, 1=top-right, 2=bottom
-// distance: 0.0 (centro) - 1.0 (estremità)
-void getFluxArmPosition(int armIndex, float distance, int16_t &outX, int16_t &outY) {
-  float angle, length;
-
-  switch (armIndex) {
-    case 0: // Top-left
-      angle = FLUX_ARM_TOP_LEFT_ANGLE;
-      length = FLUX_ARM_TOP_LENGTH;
-      break;
-    case 1: // Top-right
-      angle = FLUX_ARM_TOP_RIGHT_ANGLE;
-      length = FLUX_ARM_TOP_LENGTH;
-      break;
-    case 2: // Bottom
-    default:
-      angle = FLUX_ARM_BOTTOM_ANGLE;
-      length = FLUX_ARM_BOTTOM_LENGTH;
-      break;
-  }
+// Disegna una particella con scia luminosa (scia verso l'esterno, testa verso il centro).
+// hx/hy: testa in Q8, dist: distanza dal centro in Q8
+void drawFluxParticleWithTrail(uint8_t arm, int32_t hx, int32_t hy, int32_t dist) {
+  // Solo i segmenti che restano dentro il braccio
+  int32_t lenQ8 = PART_PX(fluxArmLength[arm]);
+  int32_t stepQ8 = fluxTrailStepQ8[arm];
+  int segments = FLUX_TRAIL_LENGTH;
+  while (segments > 1 && dist + (segments - 1) * stepQ8 > lenQ8) segments--;
 
-  float radians = angle * PI / 180.0f;
-  outX = FLUX_CENTER_X + (int16_t)(cos(radians) * distance * length);
-  outY = FLUX_CENTER_Y - (int16_t)(sin(radians) * distance * length);
-}
+  int32_t sx = (fluxArmDirX[arm] * stepQ8) >> 15;
+  int32_t sy = (fluxArmDirY[arm] * stepQ8) >> 15;
 
-// Interpola colore in base alla posizione (0=centro giallo, 1=estremità rosso)
-uint16_t getFluxParticleColor(float position, float brightness) {
-  // Gradiente: bianco/giallo al centro -> arancione -> rosso alle estremità
-  if (position < 0.3f) {
-    return (brightness > 200) ? FLUX_COLOR_WHITE : FLUX_COLOR_YELLOW;
-  } else if (position < 0.6f) {
-    return FLUX_COLOR_ORANGE;
-  } else if (position < 0.85f) {
-    return FLUX_COLOR_AMBER;
-  } else {
-    return FLUX_COLOR_RED;
-  }
-}
+  // Un rettangolo per tutta la scia: testa + ultimo segmento + dispersione massima
+  int16_t ax = PART_INT(hx), ay = PART_INT(hy);
+  int16_t bx = PART_INT(hx + (segments - 1) * sx), by = PART_INT(hy + (segments - 1) * sy);
+  particleCanvasMark(&fluxCanvas, min(ax, bx) - FLUX_TRAIL_SPREAD_MAX, min(ay, by) - FLUX_TRAIL_SPREAD_MAX,
+                     max(ax, bx) + FLUX_TRAIL_SPREAD_MAX, max(ay, by) + FLUX_TRAIL_SPREAD_MAX);
 
-// Disegna una particella con scia luminosa (scia verso l'esterno, testa verso il centro)
-void drawFluxParticleWithTrail(int armIndex, float headPosition, uint8_t brightness) {
   // Disegna la scia (dalla coda alla testa)
-  for (int t = FLUX_TRAIL_LENGTH - 1; t >= 0; t--) {
-    // Scia verso l'esterno (+ invece di -)
-    float segmentPos = headPosition + (t * FLUX_TRAIL_SPACING);
-
-    if (segmentPos < 0.0f || segmentPos > 1.0f) continue;
-
-    int16_t x, y;
-    getFluxArmPosition(armIndex, segmentPos, x, y);
-
-    // Fattore di dissolvenza
-    float fadeFactor = 1.0f - ((float)t / FLUX_TRAIL_LENGTH);
-    fadeFactor = fadeFactor * fadeFactor;
+  for (int t = segments - 1; t >= 0; t--) {
+    int16_t x = PART_INT(hx + t * sx);
+    int16_t y = PART_INT(hy + t * sy);
 
     // Colore sfumato
-    uint16_t segmentColor;
-    if (fadeFactor > 0.6f) {
-      segmentColor = fluxColorBright;
-    } else if (fadeFactor > 0.3f) {
-      segmentColor = fluxColorMedium;
-    } else {
-      segmentColor = fluxColorDark;
-    }
-
-    // Cluster di punti per effetto fiume
-    int numPoints = 2 + (int)(fadeFactor * 10);
-    int spread = 3 + (int)(fadeFactor * 5);
-
-    for (int p = 0; p < numPoints; p++) {
-      int16_t px = x + random(-spread, spread + 1);
-      int16_t py = y + random(-spread, spread + 1);
-      offscreenGfx->drawPixel(px, py, segmentColor);
+    uint16_t segmentColor = (t < 2) ? fluxColorBright : (t < 4) ? fluxColorMedium : fluxColorDark;
+
+    // Cluster di punti per effetto fiume (un numero casuale per punto: 16 bit per asse)
+    int16_t spread = fluxTrailSpread[t];
+    uint32_t side = 2 * spread + 1;
+    for (uint8_t p = 0; p < fluxTrailPoints[t]; p++) {
+      uint32_t r = particleRand();
+      int16_t px = x + (int16_t)(((r & 0xFFFF) * side) >> 16) - spread;
+      int16_t py = y + (int16_t)(((r >> 16) * side) >> 16) - spread;
+      particlePlot(&fluxCanvas, px, py, segmentColor);
     }
   }
 }
@@ -375,22 +404,24 @@ void drawFluxImpulses(float phase) {
       impulsePositions[arm] = 1.0f;
     }
 
-    // Calcola angolo e lunghezza per questo braccio
-    float angle, length;
-    switch (arm) {
-      case 0: angle = FLUX_ARM_TOP_LEFT_ANGLE; length = FLUX_ARM_TOP_LENGTH; break;
-      case 1: angle = FLUX_ARM_TOP_RIGHT_ANGLE; length = FLUX_ARM_TOP_LENGTH; break;
-      default: angle = FLUX_ARM_BOTTOM_ANGLE; length = FLUX_ARM_BOTTOM_LENGTH; break;
-    }
-    float radians = angle * PI / 180.0f;
-    float cosA = cos(radians);
-    float sinA = sin(radians);
+    // Direzione e lunghezza precalcolate per questo braccio
+    float length = fluxArmLength[arm];
+    float cosA = fluxArmDirX[arm] / 32767.0f;
+    float sinA = -fluxArmDirY[arm] / 32767.0f;
 
     // Posizione corrente dell'impulso
     float headPos = impulsePositions[arm];
     float tailPos = headPos + impulseWidth;
     if (tailPos > 1.0f) tailPos = 1.0f;
 
+    // Rettangolo del segmento (per il ripristino dello sfondo al frame successivo)
+    int16_t hx = FLUX_CENTER_X + (int16_t)(cosA * headPos * length);
+    int16_t hy = FLUX_CENTER_Y - (int16_t)(sinA * headPos * length);
+    int16_t tx = FLUX_CENTER_X + (int16_t)(cosA * tailPos * length);
+    int16_t ty = FLUX_CENTER_Y - (int16_t)(sinA * tailPos * length);
+    int half = lineThickness / 2 + 1;
+    particleCanvasMark(&fluxCanvas, min(hx, tx) - half, min(hy, ty) - half, max(hx, tx) + half, max(hy, ty) + half);
+
     // Disegna il segmento solido dall'esterno (tailPos) alla testa (headPos)
     // Usa piccoli step per riempire la linea
     for (float pos = headPos; pos <= tailPos; pos += 0.005f) {
@@ -419,7 +450,7 @@ void drawFluxImpulses(float phase) {
       for (int dx = -lineThickness/2; dx <= lineThickness/2; dx++) {
         for (int dy = -lineThickness/2; dy <= lineThickness/2; dy++) {
           if (dx*dx + dy*dy <= (lineThickness/2)*(lineThickness/2)) {
-            offscreenGfx->drawPixel(x + dx, y + dy, color);
+            particlePlot(&fluxCanvas, x + dx, y + dy, color);
           }
         }
       }
@@ -433,10 +464,15 @@ void drawFluxCenter(float phase) {
   int baseSpread = 10;
   int pulseSpread = baseSpread + (int)(pulse * 8);
   int numCenterPoints = 30 + (int)(pulse * 20);
+  uint32_t side = 2 * pulseSpread + 1;
+
+  particleCanvasMark(&fluxCanvas, FLUX_CENTER_X - pulseSpread, FLUX_CENTER_Y - pulseSpread,
+                     FLUX_CENTER_X + pulseSpread, FLUX_CENTER_Y + pulseSpread);
 
   for (int p = 0; p < numCenterPoints; p++) {
-    int16_t px = FLUX_CENTER_X + random(-pulseSpread, pulseSpread + 1);
-    int16_t py = FLUX_CENTER_Y + random(-pulseSpread, pulseSpread + 1);
+    uint32_t r = particleRand();
+    int16_t px = FLUX_CENTER_X + (int16_t)(((r & 0xFFFF) * side) >> 16) - pulseSpread;
+    int16_t py = FLUX_CENTER_Y + (int16_t)(((r >> 16) * side) >> 16) - pulseSpread;
     int dist = abs(px - FLUX_CENTER_X) + abs(py - FLUX_CENTER_Y);
     uint16_t color;
     if (dist < pulseSpread / 3) {
@@ -446,40 +482,22 @@ void drawFluxCenter(float phase) {
     } else {
       color = fluxColorDark;
     }
-    offscreenGfx->drawPixel(px, py, color);
-  }
-}
-
-// Aggiorna posizione di tutte le particelle (dall'esterno verso il centro)
-void updateFluxParticles() {
-  for (int arm = 0; arm < 3; arm++) {
-    for (uint16_t i = 0; i < fluxNumParticles; i++) {
-      FluxParticle &p = fluxParticles[arm][i];
-
-      // Muovi verso il centro (position decresce)
-      p.position -= p.speed;
-
-      // Quando arriva al centro, ricomincia dall'esterno
-      if (p.position <= 0.0f) {
-        p.position = 1.0f;
-        p.speed = fluxParticleSpeed * (0.8f + (random(40) / 100.0f));
-        p.brightness = 200 + random(55);
-      }
-
-      // Flicker leggero
-      p.brightness = constrain(p.brightness + random(-5, 6), 180, 255);
-    }
+    particlePlot(&fluxCanvas, px, py, color);
   }
 }
 
 // Disegna tutte le particelle con scie
 void drawFluxAllParticles() {
-  for (int arm = 0; arm < 3; arm++) {
-    for (uint16_t i = 0; i < fluxNumParticles; i++) {
-      FluxParticle &p = fluxParticles[arm][i];
-      if (p.active && p.position > 0.05f) {
-        drawFluxParticleWithTrail(arm, p.position, p.brightness);
-      }
+  const int32_t cxQ8 = PART_PX(FLUX_CENTER_X);
+  const int32_t cyQ8 = PART_PX(FLUX_CENTER_Y);
+  for (uint16_t i = 0; i < fluxHeads.count; i++) {
+    uint8_t arm = fluxHeads.aux[i];
+    int32_t hx = fluxHeads.x[i];
+    int32_t hy = fluxHeads.y[i];
+    // Distanza dal centro lungo il braccio (proiezione sulla direzione, Q8)
+    int32_t dist = ((hx - cxQ8) * fluxArmDirX[arm] + (hy - cyQ8) * fluxArmDirY[arm]) >> 15;
+    if (dist * 20 > PART_PX(fluxArmLength[arm])) {  // Oltre il 5% del braccio
+      drawFluxParticleWithTrail(arm, hx, hy, dist);
     }
   }
 }
@@ -502,12 +520,9 @@ void updateFluxCapacitor() {
 
     // ===== RENDERING OFFSCREEN =====
 
-    // Copia sfondo nel frameBuffer
-    if (fluxBackgroundBuffer != nullptr) {
-      memcpy(frameBuffer, fluxBackgroundBuffer, FLUX_SCREEN_WIDTH * FLUX_SCREEN_HEIGHT * sizeof(uint16_t));
-    } else {
-      memset(frameBuffer, 0, FLUX_SCREEN_WIDTH * FLUX_SCREEN_HEIGHT * sizeof(uint16_t));
-    }
+    // Ripristina lo sfondo dove il frame precedente ha disegnato
+    // (copia intera solo se l'area toccata è grande o il frameBuffer è stato usato da altri modi)
+    particleCanvasRestore(&fluxCanvas);
 
     // Disegna centro pulsante
     drawFluxCenter(fluxGlobalPhase);
@@ -518,18 +533,19 @@ void updateFluxCapacitor() {
       drawFluxImpulses(fluxGlobalPhase);
     } else {
       // Modalità Particelle
-      updateFluxParticles();
+      particleStep(&fluxHeads, currentTime);
       drawFluxAllParticles();
     }
 
-    // ===== TRASFERISCI AL DISPLAY =====
-    gfx->draw16bitRGBBitmap((gfx->width()-FLUX_SCREEN_WIDTH)/2, (gfx->height()-FLUX_SCREEN_HEIGHT)/2, frameBuffer, FLUX_SCREEN_WIDTH, FLUX_SCREEN_HEIGHT);
+    // ===== TRASFERISCI AL DISPLAY (solo le righe modificate) =====
+    particleCanvasBlit(&fluxCanvas);
   }
 }
 
 // Forza ridisegno completo
 void forceFluxCapacitorRedraw() {
   initFluxParticles();
+  particleCanvasInvalidate(&fluxCanvas);
   fluxGlobalPhase = 0.0f;
   fluxLastUpdate = 0;
 }
@@ -831,7 +847,7 @@ void handleFluxSave(AsyncWebServerRequest *request) {
     fluxColorB = (uint8_t)constrain(request->getParam("b")->value().toInt(), 0, 255);
   }
   if (request->hasParam("particles")) {
-    fluxNumParticles = constrain(request->getParam("particles")->value().toInt(), 3, 100);
+    fluxNumParticles = constrain(request->getParam("particles")->value().toInt(), 3, FLUX_MAX_PARTICLES);
   }
   if (request->hasParam("speed")) {
     fluxAnimationSpeed = constrain(request->getParam("speed")->value().toInt(), 5, 50);
@@ -12,7 +12,7 @@
 #ifdef EFFECT_CHRISTMAS
 
 // ================== CONFIGURAZIONE ==================
-#define XMAS_MAX_SNOWFLAKES  150     // Più fiocchi per effetto più denso
+#define XMAS_MAX_SNOWFLAKES  150     // Fiocchi nel motore particelle (0_PARTICLES.ino)
 #define XMAS_MAX_LIGHTS      30      // Luci sull'albero
 #define XMAS_MAX_ORNAMENTS   12      // Palline decorative
 
@@ -27,14 +27,10 @@
 #define XMAS_STAR_YELLOW     0xFFE0  // Giallo oro
 #define XMAS_GROUND_SNOW     0xDEFB  // Bianco leggermente grigio
 
-// Struttura fiocco di neve
-struct XmasSnowflake {
-  int16_t x;
-  int16_t y;
-  int8_t speedY;      // Velocità verticale (1-4)
-  int8_t driftX;      // Deriva orizzontale (-1, 0, 1)
-  uint8_t size;       // Dimensione (1-3)
-};
+// I fiocchi sono visibili solo sui pixel di cielo dello strato (blu 8..23, vedi getXmasSkyColor):
+// albero, regali, orario e neve al suolo li coprono senza test geometrici
+#define XMAS_SNOW_KEY_LO     0x0008
+#define XMAS_SNOW_KEY_HI     0x0017
 
 // Struttura luce albero
 struct XmasLight {
@@ -53,7 +49,13 @@ struct XmasOrnament {
 };
 
 // Variabili globali
-XmasSnowflake xmasSnow[XMAS_MAX_SNOWFLAKES];
+// Strato della scena (cielo, albero, luci, stella, orario, neve al suolo) e frame buffer in PSRAM:
+// i fiocchi si cancellano ripristinando dallo strato solo i pixel toccati
+uint16_t *xmasLayer = nullptr;
+uint16_t *xmasFrame = nullptr;
+OffscreenGFX *xmasLayerGfx = nullptr;
+ParticleSystem xmasSnow;
+ParticleCanvas xmasCanvas;
 XmasLight xmasLights[XMAS_MAX_LIGHTS];
 XmasOrnament xmasOrnaments[XMAS_MAX_ORNAMENTS];
 uint8_t xmasGroundSnow[480];  // Altezza neve accumulata per ogni X
@@ -61,6 +63,7 @@ bool christmasInitialized = false;
 uint32_t xmasLastUpdate = 0;
 uint32_t xmasLightTimer = 0;
 uint8_t xmasStarPhase = 0;
+bool xmasSceneDrawn = false;
 
 // Colori per luci e palline
 const uint16_t xmasLightColors[] = {0xF800, 0xFFE0, 0x001F, 0x07E0, 0xF81F, 0x07FF, 0xFBE0};
@@ -78,13 +81,22 @@ void initChristmas() {
     xmasGroundSnow[i] = random(3, 8);  // Neve iniziale irregolare
   }
 
+  // Strato, frame buffer e sistema di particelle
+  if (!allocChristmasBuffers()) {
+    Serial.println("[XMAS] ERRORE: PSRAM insufficiente!");
+    releaseChristmasBuffers();
+    gfx->fillScreen(XMAS_SKY_TOP);
+    christmasInitialized = true;
+    return;
+  }
+
   // Inizializza fiocchi di neve - distribuiti su tutto lo schermo
+  particleSeed(esp_random());
+  xmasSnow.count = 0;
   for (int i = 0; i < XMAS_MAX_SNOWFLAKES; i++) {
-    xmasSnow[i].x = random(0, 480);
-    xmasSnow[i].y = random(0, 480);  // Distribuiti ovunque all'inizio
-    xmasSnow[i].speedY = random(2, 6);
-    xmasSnow[i].driftX = random(-1, 2);
-    xmasSnow[i].size = random(1, 4);
+    int idx = particleSpawn(&xmasSnow, 0, 0, 0, 0, 0, XMAS_SNOW_WHITE, PART_SPRITE_DOT);
+    if (idx < 0) break;
+    xmasPlaceFlake(idx, particleRandRange(0, 479), 2, 5);  // Distribuiti ovunque all'inizio
   }
 
   // Inizializza luci sull'albero
@@ -122,79 +134,102 @@ void initChristmas() {
   xmasLastUpdate = millis();
   xmasLightTimer = millis();
 
-  // Disegno iniziale
-  gfx->fillScreen(XMAS_SKY_TOP);
-
   Serial.println("[XMAS] Inizializzato!");
 }
 
-// Variabili per evitare flickering
-int16_t xmasOldSnowX[XMAS_MAX_SNOWFLAKES];
-int16_t xmasOldSnowY[XMAS_MAX_SNOWFLAKES];
-bool xmasSceneDrawn = false;
-
 // Calcola colore sfondo per una Y
 uint16_t getXmasSkyColor(int y) {
   uint8_t blue = 8 + (y * 16 / 480);
   return blue;
 }
 
-// Controlla se un punto è dentro l'albero
-bool isInsideTree(int x, int y) {
-  int treeX = 240;
-  int treeTop = 95;
-
-  // Controlla per ogni livello dell'albero
-  for (int layer = 0; layer < 5; layer++) {
-    int layerTop = treeTop + layer * 55;
-    int layerBottom = layerTop + 100;
-    int bottomWidth = 60 + layer * 40;
-
-    if (y >= layerTop && y <= layerBottom) {
-      // Calcola la larghezza dell'albero a questa Y
-      float progress = (float)(y - layerTop) / (layerBottom - layerTop);
-      int widthAtY = (int)(progress * bottomWidth);
-      if (x >= treeX - widthAtY && x <= treeX + widthAtY) {
-        return true;
-      }
-    }
-  }
-
-  // Controlla tronco
-  if (y >= 385 && y <= 440 && x >= 220 && x <= 260) {
-    return true;
-  }
+// Libera strato, frame buffer e fiocchi (~920KB di PSRAM) all'uscita, come Capodanno:
+// chiamata da cleanupPreviousMode(), il prossimo ingresso rifa' l'init
+void releaseChristmasBuffers() {
+  particleSystemFree(&xmasSnow);
+  particleCanvasEnd(&xmasCanvas);
+  if (xmasLayerGfx != nullptr) { delete xmasLayerGfx; xmasLayerGfx = nullptr; }
+  if (xmasLayer != nullptr) { free(xmasLayer); xmasLayer = nullptr; }
+  if (xmasFrame != nullptr) { free(xmasFrame); xmasFrame = nullptr; }
+  christmasInitialized = false;
+  xmasSceneDrawn = false;
+}
 
-  return false;
+// Alloca strato, frame buffer e fiocchi (liberati da releaseChristmasBuffers all'uscita)
+bool allocChristmasBuffers() {
+  size_t bytes = 480 * 480 * sizeof(uint16_t);
+  if (xmasLayer == nullptr) xmasLayer = (uint16_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (xmasFrame == nullptr) xmasFrame = (uint16_t*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (xmasLayer == nullptr || xmasFrame == nullptr) return false;
+  if (xmasLayerGfx == nullptr) xmasLayerGfx = new OffscreenGFX(xmasLayer, 480, 480);
+
+  if (xmasSnow.capacity < XMAS_MAX_SNOWFLAKES && !particleSystemAlloc(&xmasSnow, XMAS_MAX_SNOWFLAKES)) return false;
+  xmasSnow.integrate = xmasSnowIntegrate;
+  xmasSnow.flags = PART_FLAG_KEYED;
+  xmasSnow.keyLo = XMAS_SNOW_KEY_LO;
+  xmasSnow.keyHi = XMAS_SNOW_KEY_HI;
+  // Senza lista di rettangoli il canvas ripristina comunque (copia intera a ogni frame)
+  particleCanvasBegin(&xmasCanvas, xmasFrame, xmasLayer, 480, 480, XMAS_MAX_SNOWFLAKES + 64);
+  return true;
 }
 
-// Controlla se un punto è sopra un regalo
-bool isInsideGift(int x, int y) {
-  // Regalo 1
-  if (x >= 160 && x <= 215 && y >= 410 && y <= 455) return true;
-  // Regalo 2
-  if (x >= 270 && x <= 315 && y >= 420 && y <= 455) return true;
-  // Regalo 3
-  if (x >= 225 && x <= 260 && y >= 430 && y <= 458) return true;
-  return false;
+// (Ri)posiziona il fiocco i alla riga y con velocità casuale tra minSpeed e maxSpeed pixel/frame
+static void xmasPlaceFlake(uint16_t i, int16_t y, int minSpeed, int maxSpeed) {
+  static const uint8_t sprites[3] = {PART_SPRITE_DOT, PART_SPRITE_SMALL, PART_SPRITE_DISC};
+  xmasSnow.x[i] = PART_PX(particleRandRange(0, 479));
+  xmasSnow.y[i] = PART_PX(y);
+  xmasSnow.vy[i] = PART_PX(particleRandRange(minSpeed, maxSpeed));
+  xmasSnow.vx[i] = particleRandRange(-1, 1) * PART_ONE / 3;  // Deriva di 1 pixel ogni ~3 frame
+  xmasSnow.sprite[i] = sprites[particleRandRange(0, 2)];
 }
 
-// Controlla se un punto è sopra il box orario
-bool isInsideTimeBox(int x, int y) {
-  return (x >= 150 && x <= 330 && y >= 8 && y <= 72);
+// Ridisegna sullo strato la cima della neve al suolo di una colonna e la riporta nel frame
+static void xmasDrawGroundColumn(int x) {
+  int h = xmasGroundSnow[x];
+  if (h <= 0) return;
+  int top = 480 - h;
+  xmasLayer[top * 480 + x] = XMAS_SNOW_WHITE;
+  if (h > 1) xmasLayer[(top + 1) * 480 + x] = XMAS_GROUND_SNOW;
+  particleCanvasRefresh(&xmasCanvas, x, top, x, top + 1);
 }
 
-// Controlla se un punto è in zona neve al suolo
-bool isInSnowZone(int x, int y) {
-  return y >= (480 - xmasGroundSnow[x]);
+// Integratore dei fiocchi: caduta con deriva, accumulo al suolo e ripartenza dall'alto
+static void xmasSnowIntegrate(ParticleSystem* ps) {
+  for (uint16_t i = 0; i < ps->count; i++) {
+    ps->y[i] += ps->vy[i];
+    ps->x[i] += ps->vx[i];
+
+    // Wrap X
+    if (ps->x[i] < 0) ps->x[i] += PART_PX(480);
+    if (ps->x[i] >= PART_PX(480)) ps->x[i] -= PART_PX(480);
+
+    // Tocca suolo?
+    int xi = PART_INT(ps->x[i]);
+    if (PART_INT(ps->y[i]) >= 480 - xmasGroundSnow[xi]) {
+      if (xmasGroundSnow[xi] < 80) {
+        xmasGroundSnow[xi]++;
+        xmasDrawGroundColumn(xi);
+        if (xi > 0 && xmasGroundSnow[xi] > xmasGroundSnow[xi-1] + 3) {
+          xmasGroundSnow[xi-1]++;
+          xmasDrawGroundColumn(xi - 1);
+        }
+        if (xi < 479 && xmasGroundSnow[xi] > xmasGroundSnow[xi+1] + 3) {
+          xmasGroundSnow[xi+1]++;
+          xmasDrawGroundColumn(xi + 1);
+        }
+      }
+      // Respawn
+      xmasPlaceFlake(i, particleRandRange(-30, -5), 3, 6);
+    }
+  }
 }
 
-// ================== DISEGNA SCENA STATICA (solo una volta) ==================
+// ================== DISEGNA SCENA STATICA SULLO STRATO (solo una volta) ==================
 void drawXmasStaticScene() {
   // Sfondo gradiente
   for (int y = 0; y < 480; y += 2) {
     uint16_t skyColor = getXmasSkyColor(y);
-    gfx->fillRect(0, y, 480, 2, skyColor);
+    xmasLayerGfx->fillRect(0, y, 480, 2, skyColor);
   }
 
   // Albero
@@ -203,8 +238,8 @@ void drawXmasStaticScene() {
   int treeBottom = 385;
 
   // Tronco
-  gfx->fillRect(treeX - 20, treeBottom, 40, 55, XMAS_TRUNK);
-  gfx->fillRect(treeX - 18, treeBottom, 36, 55, 0x5ACB);
+  xmasLayerGfx->fillRect(treeX - 20, treeBottom, 40, 55, XMAS_TRUNK);
+  xmasLayerGfx->fillRect(treeX - 18, treeBottom, 36, 55, 0x5ACB);
 
   // Rami - 5 livelli
   for (int layer = 0; layer < 5; layer++) {
@@ -212,12 +247,12 @@ void drawXmasStaticScene() {
     int layerBottom = layerTop + 100;
     int bottomWidth = 60 + layer * 40;
 
-    gfx->fillTriangle(treeX, layerTop, treeX - bottomWidth, layerBottom, treeX + bottomWidth, layerBottom, XMAS_TREE_DARK);
-    gfx->fillTriangle(treeX, layerTop + 5, treeX - bottomWidth + 15, layerBottom - 5, treeX + bottomWidth - 30, layerBottom - 5, XMAS_TREE_MID);
+    xmasLayerGfx->fillTriangle(treeX, layerTop, treeX - bottomWidth, layerBottom, treeX + bottomWidth, layerBottom, XMAS_TREE_DARK);
+    xmasLayerGfx->fillTriangle(treeX, layerTop + 5, treeX - bottomWidth + 15, layerBottom - 5, treeX + bottomWidth - 30, layerBottom - 5, XMAS_TREE_MID);
 
     for (int i = -bottomWidth; i < bottomWidth; i += 12) {
       int px = treeX + i;
-      gfx->fillTriangle(px, layerBottom, px + 6, layerBottom + 8, px + 12, layerBottom, XMAS_TREE_DARK);
+      xmasLayerGfx->fillTriangle(px, layerBottom, px + 6, layerBottom + 8, px + 12, layerBottom, XMAS_TREE_DARK);
     }
   }
 
@@ -226,30 +261,39 @@ void drawXmasStaticScene() {
     int ox = xmasOrnaments[i].x;
     int oy = xmasOrnaments[i].y;
     uint8_t r = xmasOrnaments[i].radius;
-    gfx->fillCircle(ox, oy, r, xmasOrnaments[i].color);
-    gfx->fillCircle(ox - r/3, oy - r/3, r/3, XMAS_SNOW_WHITE);
-    gfx->drawCircle(ox, oy, r, 0x0000);
+    xmasLayerGfx->fillCircle(ox, oy, r, xmasOrnaments[i].color);
+    xmasLayerGfx->fillCircle(ox - r/3, oy - r/3, r/3, XMAS_SNOW_WHITE);
+    xmasLayerGfx->drawCircle(ox, oy, r, 0x0000);
   }
 
   // Regali
-  gfx->fillRect(160, 410, 55, 45, 0xF800);
-  gfx->fillRect(183, 410, 8, 45, XMAS_STAR_YELLOW);
-  gfx->fillRect(160, 428, 55, 8, XMAS_STAR_YELLOW);
-  gfx->drawRect(160, 410, 55, 45, 0x8000);
-  gfx->fillCircle(187, 410, 8, XMAS_STAR_YELLOW);
-
-  gfx->fillRect(270, 420, 45, 35, 0x001F);
-  gfx->fillRect(289, 420, 6, 35, XMAS_SNOW_WHITE);
-  gfx->fillRect(270, 434, 45, 6, XMAS_SNOW_WHITE);
-  gfx->drawRect(270, 420, 45, 35, 0x0010);
-  gfx->fillCircle(292, 420, 6, XMAS_SNOW_WHITE);
-
-  gfx->fillRect(225, 430, 35, 28, 0x07E0);
-  gfx->fillRect(239, 430, 6, 28, 0xF800);
-  gfx->fillRect(225, 441, 35, 6, 0xF800);
-  gfx->drawRect(225, 430, 35, 28, 0x0400);
-  gfx->fillCircle(242, 430, 5, 0xF800);
+  xmasLayerGfx->fillRect(160, 410, 55, 45, 0xF800);
+  xmasLayerGfx->fillRect(183, 410, 8, 45, XMAS_STAR_YELLOW);
+  xmasLayerGfx->fillRect(160, 428, 55, 8, XMAS_STAR_YELLOW);
+  xmasLayerGfx->drawRect(160, 410, 55, 45, 0x8000);
+  xmasLayerGfx->fillCircle(187, 410, 8, XMAS_STAR_YELLOW);
+
+  xmasLayerGfx->fillRect(270, 420, 45, 35, 0x001F);
+  xmasLayerGfx->fillRect(289, 420, 6, 35, XMAS_SNOW_WHITE);
+  xmasLayerGfx->fillRect(270, 434, 45, 6, XMAS_SNOW_WHITE);
+  xmasLayerGfx->drawRect(270, 420, 45, 35, 0x0010);
+  xmasLayerGfx->fillCircle(292, 420, 6, XMAS_SNOW_WHITE);
+
+  xmasLayerGfx->fillRect(225, 430, 35, 28, 0x07E0);
+  xmasLayerGfx->fillRect(239, 430, 6, 28, 0xF800);
+  xmasLayerGfx->fillRect(225, 441, 35, 6, 0xF800);
+  xmasLayerGfx->drawRect(225, 430, 35, 28, 0x0400);
+  xmasLayerGfx->fillCircle(242, 430, 5, 0xF800);
+
+  // Neve al suolo iniziale
+  for (int x = 0; x < 480; x++) {
+    int h = xmasGroundSnow[x];
+    xmasLayerGfx->drawFastVLine(x, 480 - h, h, XMAS_GROUND_SNOW);
+    xmasLayer[(480 - h) * 480 + x] = XMAS_SNOW_WHITE;
+  }
 
+  // Il frame buffer va ricostruito per intero dallo strato
+  particleCanvasInvalidate(&xmasCanvas);
   xmasSceneDrawn = true;
 }
 
@@ -257,13 +301,9 @@ void drawXmasStaticScene() {
 void updateChristmas() {
   if (!christmasInitialized) {
     initChristmas();
-    // Inizializza posizioni vecchie
-    for (int i = 0; i < XMAS_MAX_SNOWFLAKES; i++) {
-      xmasOldSnowX[i] = xmasSnow[i].x;
-      xmasOldSnowY[i] = xmasSnow[i].y;
-    }
     return;
   }
+  if (xmasCanvas.fb == nullptr) return;  // PSRAM insufficiente: solo sfondo
 
   uint32_t now = millis();
 
@@ -271,92 +311,13 @@ void updateChristmas() {
   if (now - xmasLastUpdate < 40) return;
   xmasLastUpdate = now;
 
-  // Disegna scena statica solo la prima volta
+  // Disegna scena statica solo la prima volta (sullo strato)
   if (!xmasSceneDrawn) {
     drawXmasStaticScene();
   }
 
-  // === CANCELLA VECCHI FIOCCHI (solo se erano su sfondo cielo) ===
-  for (int i = 0; i < XMAS_MAX_SNOWFLAKES; i++) {
-    int ox = xmasOldSnowX[i];
-    int oy = xmasOldSnowY[i];
-    // Cancella solo se il fiocco era nel cielo (non sopra albero, regali, orario o neve)
-    if (oy >= 0 && oy < 480 && !isInsideTree(ox, oy) && !isInsideGift(ox, oy) && !isInsideTimeBox(ox, oy) && !isInSnowZone(ox, oy)) {
-      uint16_t bgColor = getXmasSkyColor(oy);
-      if (xmasSnow[i].size == 1) {
-        gfx->drawPixel(ox, oy, bgColor);
-      } else if (xmasSnow[i].size == 2) {
-        gfx->drawPixel(ox, oy, bgColor);
-        gfx->drawPixel(ox+1, oy, bgColor);
-        gfx->drawPixel(ox, oy+1, bgColor);
-      } else {
-        gfx->fillCircle(ox, oy, 2, bgColor);
-      }
-    }
-  }
-
-  // === AGGIORNA POSIZIONE FIOCCHI ===
-  for (int i = 0; i < XMAS_MAX_SNOWFLAKES; i++) {
-    // Salva posizione vecchia
-    xmasOldSnowX[i] = xmasSnow[i].x;
-    xmasOldSnowY[i] = xmasSnow[i].y;
-
-    // Muovi
-    xmasSnow[i].y += xmasSnow[i].speedY;
-    if ((now / 150 + i) % 3 == 0) {
-      xmasSnow[i].x += xmasSnow[i].driftX;
-    }
-
-    // Wrap X
-    if (xmasSnow[i].x < 0) xmasSnow[i].x = 479;
-    if (xmasSnow[i].x >= 480) xmasSnow[i].x = 0;
-
-    // Tocca suolo?
-    int groundLevel = 480 - xmasGroundSnow[xmasSnow[i].x];
-    if (xmasSnow[i].y >= groundLevel) {
-      if (xmasGroundSnow[xmasSnow[i].x] < 80) {
-        xmasGroundSnow[xmasSnow[i].x]++;
-        int xi = xmasSnow[i].x;
-        if (xi > 0 && xmasGroundSnow[xi] > xmasGroundSnow[xi-1] + 3) xmasGroundSnow[xi-1]++;
-        if (xi < 479 && xmasGroundSnow[xi] > xmasGroundSnow[xi+1] + 3) xmasGroundSnow[xi+1]++;
-      }
-      // Respawn
-      xmasSnow[i].x = random(0, 480);
-      xmasSnow[i].y = random(-30, -5);
-      xmasSnow[i].speedY = random(3, 7);
-      xmasSnow[i].driftX = random(-1, 2);
-      xmasSnow[i].size = random(1, 4);
-      xmasOldSnowX[i] = xmasSnow[i].x;
-      xmasOldSnowY[i] = -50;
-    }
-  }
-
-  // === DISEGNA NUOVI FIOCCHI (solo se visibili nel cielo) ===
-  for (int i = 0; i < XMAS_MAX_SNOWFLAKES; i++) {
-    int x = xmasSnow[i].x;
-    int y = xmasSnow[i].y;
-    // Disegna solo se nel cielo (non sopra albero, regali, orario)
-    if (y >= 0 && y < 480 && !isInsideTree(x, y) && !isInsideGift(x, y) && !isInsideTimeBox(x, y)) {
-      if (xmasSnow[i].size == 1) {
-        gfx->drawPixel(x, y, XMAS_SNOW_WHITE);
-      } else if (xmasSnow[i].size == 2) {
-        gfx->drawPixel(x, y, XMAS_SNOW_WHITE);
-        gfx->drawPixel(x+1, y, XMAS_SNOW_WHITE);
-        gfx->drawPixel(x, y+1, XMAS_SNOW_WHITE);
-      } else {
-        gfx->fillCircle(x, y, 2, XMAS_SNOW_WHITE);
-      }
-    }
-  }
-
-  // === AGGIORNA NEVE AL SUOLO (solo top della neve) ===
-  for (int x = 0; x < 480; x++) {
-    int h = xmasGroundSnow[x];
-    if (h > 0) {
-      gfx->drawPixel(x, 480 - h, XMAS_SNOW_WHITE);
-      if (h > 1) gfx->drawPixel(x, 480 - h + 1, XMAS_GROUND_SNOW);
-    }
-  }
+  // Cancella i fiocchi del frame precedente ripristinando dallo strato
+  particleCanvasRestore(&xmasCanvas);
 
   // === AGGIORNA LUCI (solo quando cambiano) ===
   if (now - xmasLightTimer > 300) {
@@ -367,14 +328,15 @@ void updateChristmas() {
         int ly = xmasLights[i].y;
         if (xmasLights[i].on) {
           // Spegni - ridisegna con verde albero
-          gfx->fillCircle(lx, ly, 7, XMAS_TREE_DARK);
+          xmasLayerGfx->fillCircle(lx, ly, 7, XMAS_TREE_DARK);
         }
         xmasLights[i].on = !xmasLights[i].on;
         if (xmasLights[i].on) {
           // Accendi
-          gfx->fillCircle(lx, ly, 4, xmasLights[i].color);
-          gfx->drawCircle(lx, ly, 6, xmasLights[i].color);
+          xmasLayerGfx->fillCircle(lx, ly, 4, xmasLights[i].color);
+          xmasLayerGfx->drawCircle(lx, ly, 6, xmasLights[i].color);
         }
+        particleCanvasRefresh(&xmasCanvas, lx - 7, ly - 7, lx + 7, ly + 7);
       }
     }
     xmasStarPhase = (xmasStarPhase + 1) % 10;
@@ -388,7 +350,7 @@ void updateChristmas() {
     int starY = 80;
 
     // Cancella stella vecchia
-    gfx->fillCircle(starX, starY, 30, getXmasSkyColor(starY));
+    xmasLayerGfx->fillCircle(starX, starY, 30, getXmasSkyColor(starY));
 
     // Disegna stella nuova
     int starSize = 18 + (xmasStarPhase < 5 ? xmasStarPhase : 10 - xmasStarPhase) * 2;
@@ -398,11 +360,12 @@ void updateChristmas() {
       float angle = (i * 72 - 90) * PI / 180.0;
       int px = starX + cos(angle) * starSize;
       int py = starY + sin(angle) * starSize;
-      gfx->drawLine(starX, starY, px, py, starColor);
-      gfx->drawLine(starX+1, starY, px+1, py, starColor);
+      xmasLayerGfx->drawLine(starX, starY, px, py, starColor);
+      xmasLayerGfx->drawLine(starX+1, starY, px+1, py, starColor);
     }
-    gfx->fillCircle(starX, starY, 8, XMAS_STAR_YELLOW);
-    gfx->fillCircle(starX, starY, 5, XMAS_SNOW_WHITE);
+    xmasLayerGfx->fillCircle(starX, starY, 8, XMAS_STAR_YELLOW);
+    xmasLayerGfx->fillCircle(starX, starY, 5, XMAS_SNOW_WHITE);
+    particleCanvasRefresh(&xmasCanvas, starX - 30, starY - 30, starX + 30, starY + 30);
   }
 
   // === ORARIO (aggiorna solo ogni secondo) ===
@@ -411,33 +374,42 @@ void updateChristmas() {
     lastSecond = currentSecond;
 
     // Box orario
-    gfx->fillRoundRect(155, 12, 170, 55, 12, 0x0000);
-    gfx->drawRoundRect(155, 12, 170, 55, 12, XMAS_SNOW_WHITE);
+    xmasLayerGfx->fillRoundRect(155, 12, 170, 55, 12, 0x0000);
+    xmasLayerGfx->drawRoundRect(155, 12, 170, 55, 12, XMAS_SNOW_WHITE);
 
     char timeStr[6];
     sprintf(timeStr, "%02d:%02d", currentHour, currentMinute);
-    gfx->setFont(u8g2_font_logisoso32_tn);
-    gfx->setTextColor(XMAS_SNOW_WHITE);
+    xmasLayerGfx->setFont(u8g2_font_logisoso32_tn);
+    xmasLayerGfx->setTextColor(XMAS_SNOW_WHITE);
     int16_t tx, ty;
     uint16_t tw, th;
-    gfx->getTextBounds(timeStr, 0, 0, &tx, &ty, &tw, &th);
-    gfx->setCursor(240 - tw/2, 52);
-    gfx->print(timeStr);
+    xmasLayerGfx->getTextBounds(timeStr, 0, 0, &tx, &ty, &tw, &th);
+    xmasLayerGfx->setCursor(240 - tw/2, 52);
+    xmasLayerGfx->print(timeStr);
+    particleCanvasRefresh(&xmasCanvas, 155, 12, 324, 66);
 
     // Buon Natale
     if (currentSecond % 10 < 5) {
-      gfx->setFont(u8g2_font_helvB14_tr);
+      xmasLayerGfx->setFont(u8g2_font_helvB14_tr);
       const char* msg = "Buon Natale!";
-      gfx->getTextBounds(msg, 0, 0, &tx, &ty, &tw, &th);
-      gfx->fillRoundRect(240 - tw/2 - 10, 458, tw + 20, 20, 5, 0xF800);
-      gfx->setTextColor(XMAS_SNOW_WHITE);
-      gfx->setCursor(240 - tw/2, 474);
-      gfx->print(msg);
+      xmasLayerGfx->getTextBounds(msg, 0, 0, &tx, &ty, &tw, &th);
+      xmasLayerGfx->fillRoundRect(240 - tw/2 - 10, 458, tw + 20, 20, 5, 0xF800);
+      xmasLayerGfx->setTextColor(XMAS_SNOW_WHITE);
+      xmasLayerGfx->setCursor(240 - tw/2, 474);
+      xmasLayerGfx->print(msg);
     } else {
       // Cancella scritta
-      gfx->fillRect(130, 455, 220, 25, getXmasSkyColor(460));
+      xmasLayerGfx->fillRect(130, 455, 220, 25, getXmasSkyColor(460));
     }
+    particleCanvasRefresh(&xmasCanvas, 130, 455, 349, 479);
   }
+
+  // === FIOCCHI: movimento, accumulo al suolo e disegno nel frame buffer ===
+  particleStep(&xmasSnow, now);
+  particleRender(&xmasSnow, &xmasCanvas);
+
+  // Al display solo le righe cambiate
+  particleCanvasBlit(&xmasCanvas);
 }
 
 #endif // EFFECT_CHRISTMAS
@@ -47,6 +47,7 @@ void audioStopWithTimeout(unsigned long timeoutMs = 3000) {
 // Chiamata PRIMA di cambiare pagina per liberare memoria e risorse
 void cleanupPreviousMode(DisplayMode previousMode) {
   Serial.printf("[CLEANUP] Pulizia risorse modalità %d...\n", previousMode);
+  modeSwitchBegin((uint8_t)previousMode);  // Inizio misura latenza cambio modo (2_MODE_LIFECYCLE.ino)
 
   //-------------------------------------------------------------------
   // 1. STOP AUDIO E CLEANUP COMPLETO (MP3 Player, Web Radio, Radio Alarm)
@@ -134,6 +135,7 @@ void cleanupPreviousMode(DisplayMode previousMode) {
 #ifdef EFFECT_CLOCK
   if (previousMode == MODE_CLOCK) {
     clockInitNeeded = true;
+    skinFadeCancel();
     Serial.println("[CLEANUP] Clock: reset flag");
   }
 #endif
@@ -203,6 +205,8 @@ void cleanupPreviousMode(DisplayMode previousMode) {
 #ifdef EFFECT_ANALOG_CLOCK
   if (previousMode == MODE_ANALOG_CLOCK) {
     analogClockInitNeeded = true;
+    analogClockFrameOnScreen = false;   // Al rientro nessuna dissolvenza dalla modalita' precedente
+    skinFadeCancel();
     Serial.println("[CLEANUP] Analog Clock: reset");
   }
 #endif
@@ -257,6 +261,12 @@ void cleanupPreviousMode(DisplayMode previousMode) {
   }
 #endif
 
+#ifdef EFFECT_CHRISTMAS
+  // Tema natalizio: non e' un modo, gira sopra quello corrente. Strato e frame buffer
+  // (~920KB PSRAM) liberati a ogni cambio modo, l'init li rialloca al prossimo avvio
+  releaseChristmasBuffers();
+#endif
+
 #ifdef EFFECT_BATTLESHIP
   if (previousMode == MODE_BATTLESHIP) {
     battleshipInitialized = false;
@@ -310,6 +320,12 @@ void cleanupPreviousMode(DisplayMode previousMode) {
   Serial.printf("[CLEANUP] Heap libero: %d bytes, PSRAM libera: %d bytes\n",
                 ESP.getFreeHeap(), ESP.getFreePsram());
 
+  //-------------------------------------------------------------------
+  // 7. SOSPENSIONE: sfondi e buffer PSRAM restano pronti per il prossimo ingresso
+  //    (rilasciati solo se la PSRAM libera scende sotto la riserva)
+  //-------------------------------------------------------------------
+  modeSuspend((uint8_t)previousMode);
+
   Serial.println("[CLEANUP] Pulizia completata.");
 }
 
@@ -646,6 +662,9 @@ void applyPreset(uint8_t preset) {
       break;
   }
 
+  // Preparazione asset in background mentre il nome del preset resta a schermo
+  modePrepare((uint8_t)currentMode);
+
   // Mostra il nome del preset
   gfx->fillScreen(BLACK);
   gfx->setFont(u8g2_font_maniac_te);
@@ -707,10 +726,10 @@ void applyPreset(uint8_t preset) {
   userColor = currentColor;
 
   // Commit dei dati in EEPROM
-  EEPROM.commit();
+  settingsCommit();
 
   // Forza ridisegno immediato
-  forceDisplayUpdate();
+  modeActivate((uint8_t)currentMode);
 
   // Dual display: invia sync aggiornato dopo forceDisplayUpdate
 #ifdef EFFECT_DUAL_DISPLAY
@@ -890,7 +909,10 @@ void handleModeChange() {
   EEPROM.write(EEPROM_COLOR_G_ADDR, currentColor.g);
   EEPROM.write(EEPROM_COLOR_B_ADDR, currentColor.b);
 
-  EEPROM.commit();
+  settingsCommit();
+
+  // Preparazione asset in background (core 0) mentre il nome modo resta a schermo
+  modePrepare((uint8_t)currentMode);
 
 #ifdef EFFECT_MJPEG_STREAM
   // Gestione audio streaming: muta quando esci da MJPEG, riattiva quando entri
@@ -1138,7 +1160,11 @@ void handleModeChange() {
   gfx->fillScreen(BLACK);
 
   // Forza un aggiornamento immediato del display per avviare la nuova modalità.
-  forceDisplayUpdate();
+  modeActivate((uint8_t)currentMode);
+
+  // Il prossimo tocco porta alla modalita' successiva: la prepara in anticipo
+  DisplayMode nextMode = getNextEnabledMode(currentMode);
+  if (nextMode != currentMode) modePrepare((uint8_t)nextMode);
 
   // Dual display: invia sync aggiornato dopo forceDisplayUpdate
 #ifdef EFFECT_DUAL_DISPLAY
@@ -1151,3 +1177,29 @@ void handleModeChange() {
   // Notifica ESP32C3 se entrati/usciti da MODE_GEMINI_AI (già chiamato in forceDisplayUpdate)
   // Nota: forceDisplayUpdate() chiama già notifyGeminiModeChange(), non serve duplicare
 }
+
+// Sceglie una modalita' random tra quelle abilitate, diversa da quella corrente
+// (usata dal cambio modo automatico, che la prepara in anticipo)
+DisplayMode pickRandomEnabledMode(DisplayMode current) {
+  DisplayMode newMode = getNextEnabledMode(current);
+
+  // Conta quante modalità sono abilitate
+  uint8_t enabledCount = 0;
+  for (int i = 0; i < NUM_MODES; i++) {
+    if (isModeEnabled(i)) enabledCount++;
+  }
+
+  if (enabledCount > 1) {
+    // Scegli una modalità random diversa da quella corrente
+    uint8_t attempts = 0;
+    do {
+      uint8_t randomIndex = random(NUM_MODES);
+      if (isModeEnabled(randomIndex) && randomIndex != (int)current) {
+        newMode = (DisplayMode)randomIndex;
+        break;
+      }
+      attempts++;
+    } while (attempts < 50);  // Max 50 tentativi per evitare loop infinito
+  }
+  return newMode;
+}
@@ -0,0 +1,383 @@
+// ================== MODE LIFECYCLE - PREPARAZIONE E CACHE CALDA DELLE MODALITA' ==================
+// Ciclo di vita di ogni modalita':
+//  - modePrepare(mode): asincrona. Un task sul core 0 alloca i buffer PSRAM e decodifica
+//    gli sfondi JPEG dalla SD mentre il loop continua (nome modo a schermo, modo corrente).
+//  - modeActivate(mode): attende la fine della preparazione e avvia la modalita'
+//    (forceDisplayUpdate). L'init trova gli asset gia' pronti. Task e loop si passano
+//    la modalita' sotto modePrepMutex (modeLifecycleClaim): la stessa modalita' non
+//    viene mai decodificata/allocata da due task insieme (buffer allocati una volta sola).
+//  - modeSuspend(mode): chiamata da cleanupPreviousMode(). La modalita' perde lo schermo ma
+//    tiene buffer e sfondi: al prossimo ingresso la decodifica viene saltata.
+//  - modeRelease(mode): libera gli asset. Solo quando la PSRAM libera scende sotto
+//    MODE_LIFE_PSRAM_RESERVE, partendo dalla modalita' sospesa usata meno di recente.
+//
+// Hanno asset da preparare le modalita' con sfondo JPEG decodificato a ogni ingresso:
+// orologio analogico (skin), BTTF, Flux Capacitor; il flip clock prepara la cache dei
+// frame di animazione delle palette. Le altre passano subito a READY.
+//
+// La latenza di ogni cambio modo (da cleanupPreviousMode al primo frame) viene registrata
+// per coppia origine/destinazione: GET /modes/lifecycle.
+
+#include <new>
+
+// ===== Parametri =====
+#define MODE_LIFE_PSRAM_RESERVE    (1024UL * 1024UL)  // PSRAM da lasciare sempre libera
+// MODE_LIFE_PRELOAD_LEAD_MS (anticipo nel cambio random) e' nel file principale, usato dal loop
+
+// ===== Stato per modalita' =====
+#define MODE_LIFE_COLD       0   // Nessun asset in memoria
+#define MODE_LIFE_PREPARING  1   // Preparazione in corso sul task di background
+#define MODE_LIFE_READY      2   // Asset pronti, modalita' non ancora attiva
+#define MODE_LIFE_ACTIVE     3   // Modalita' a schermo
+#define MODE_LIFE_SUSPENDED  4   // Fuori schermo, asset ancora in PSRAM
+
+struct ModeLifeSlot {
+  volatile uint8_t state;
+  volatile uint32_t gen;     // Incrementato dalle invalidazioni (skin cambiata, upload)
+  uint32_t lastUsedMs;       // Ultima attivazione/sospensione (per il rilascio LRU)
+  uint32_t prepareMs;        // Durata dell'ultima preparazione
+  uint16_t prepares;         // Preparazioni eseguite
+  uint16_t warmHits;         // Attivazioni con asset gia' pronti
+};
+static ModeLifeSlot modeLife[NUM_MODES] = {};
+
+// ===== Latenza cambio modo per coppia (PSRAM, NUM_MODES x NUM_MODES) =====
+struct ModeSwitchLat {
+  uint16_t count;
+  uint16_t lastMs;
+  uint16_t maxMs;
+  uint16_t activateMs;       // Ultimo tempo da modeActivate al primo frame
+  uint32_t sumMs;
+};
+static ModeSwitchLat* modeSwitchLat = nullptr;
+static int16_t  modeSwitchFrom = -1;    // Cambio in corso (-1 = nessuno)
+static uint32_t modeSwitchStartMs = 0;
+static uint32_t modeLifeReleases = 0;
+
+static portMUX_TYPE modeLifeMux = portMUX_INITIALIZER_UNLOCKED;
+static QueueHandle_t modePrepQueue = NULL;
+static SemaphoreHandle_t modePrepMutex = NULL;  // Tenuto dal task per tutta una preparazione
+static JPEGDEC* modePrepJpeg = nullptr;  // Decoder dedicato: il globale 'jpeg' resta del loop
+
+static const char* modeLifeStateName(uint8_t state) {
+  switch (state) {
+    case MODE_LIFE_PREPARING: return "preparing";
+    case MODE_LIFE_READY:     return "ready";
+    case MODE_LIFE_ACTIVE:    return "active";
+    case MODE_LIFE_SUSPENDED: return "suspended";
+    default:                  return "cold";
+  }
+}
+
+// ===== Asset per modalita' =====
+static bool modeHasAssets(uint8_t mode) {
+  switch (mode) {
+#ifdef EFFECT_ANALOG_CLOCK
+    case MODE_ANALOG_CLOCK:
+#endif
+#ifdef EFFECT_BTTF
+    case MODE_BTTF:
+#endif
+#ifdef EFFECT_FLUX_CAPACITOR
+    case MODE_FLUX_CAPACITOR:
+#endif
+#ifdef EFFECT_FLIP_CLOCK
+    case MODE_FLIP_CLOCK:
+#endif
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Diversi percorsi (web, sveglie, stream) cambiano currentMode senza passare dal ciclo di vita:
+// una modalita' segnata ACTIVE che non e' piu' quella corrente vale come sospesa
+static uint8_t modeLifeState(uint8_t mode) {
+  uint8_t state = modeLife[mode].state;
+  if (state == MODE_LIFE_ACTIVE && mode != (uint8_t)currentMode) {
+    return modeHasAssets(mode) ? MODE_LIFE_SUSPENDED : MODE_LIFE_COLD;
+  }
+  return state;
+}
+
+// Eseguita dal task di preparazione
+static bool modePrepareAssets(uint8_t mode) {
+  switch (mode) {
+#ifdef EFFECT_ANALOG_CLOCK
+    case MODE_ANALOG_CLOCK:   return prepareAnalogClockAssets(modePrepJpeg);
+#endif
+#ifdef EFFECT_BTTF
+    case MODE_BTTF:           return prepareBTTFAssets(modePrepJpeg);
+#endif
+#ifdef EFFECT_FLUX_CAPACITOR
+    case MODE_FLUX_CAPACITOR: return prepareFluxAssets(modePrepJpeg);
+#endif
+#ifdef EFFECT_FLIP_CLOCK
+    case MODE_FLIP_CLOCK:     return prepareFlipClockAssets();
+#endif
+    default:                  return true;
+  }
+}
+
+// Asset non piu' validi: l'init li ricarichera' dalla SD
+static void modeDropAssets(uint8_t mode) {
+  switch (mode) {
+#ifdef EFFECT_ANALOG_CLOCK
+    case MODE_ANALOG_CLOCK:   clockImageLoaded = false; break;
+#endif
+#ifdef EFFECT_BTTF
+    case MODE_BTTF:           bttfBackgroundLoaded = false; break;
+#endif
+#ifdef EFFECT_FLUX_CAPACITOR
+    case MODE_FLUX_CAPACITOR: fluxBackgroundLoaded = false; break;
+#endif
+    default: break;
+  }
+}
+
+// ===== Task di preparazione (core 0) =====
+static void modePrepTask(void* param) {
+  uint8_t mode;
+  for (;;) {
+    if (xQueueReceive(modePrepQueue, &mode, portMAX_DELAY) != pdTRUE) continue;
+    if (mode >= NUM_MODES) continue;
+    xSemaphoreTake(modePrepMutex, portMAX_DELAY);
+    // Gia' attivata (modeActivate ha preso il mutex prima di noi): ci pensa l'init nel loop
+    if (modeLife[mode].state != MODE_LIFE_PREPARING) {
+      xSemaphoreGive(modePrepMutex);
+      continue;
+    }
+
+    uint32_t gen = modeLife[mode].gen;
+    uint32_t t0 = millis();
+    bool ok = modePrepareAssets(mode);
+    modeLife[mode].prepareMs = millis() - t0;
+    modeLife[mode].prepares++;
+
+    // Invalidata durante la decodifica (nuova skin, upload): il risultato non vale
+    if (gen != modeLife[mode].gen) {
+      modeDropAssets(mode);
+      ok = false;
+    }
+
+    Serial.printf("[LIFECYCLE] Modo %d preparato in %lu ms (%s)\n", mode,
+                  (unsigned long)modeLife[mode].prepareMs, ok ? "ok" : "fallito");
+
+    taskENTER_CRITICAL(&modeLifeMux);
+    if (modeLife[mode].state == MODE_LIFE_PREPARING) {
+      modeLife[mode].state = ok ? MODE_LIFE_READY : MODE_LIFE_COLD;
+    }
+    taskEXIT_CRITICAL(&modeLifeMux);
+    xSemaphoreGive(modePrepMutex);
+    frameGovKick();
+  }
+}
+
+void modeLifecycleBegin() {
+  modeSwitchLat = (ModeSwitchLat*)ps_calloc(NUM_MODES * NUM_MODES, sizeof(ModeSwitchLat));
+
+  // JPEGDEC contiene ~20KB di buffer di decodifica: istanza dedicata in PSRAM
+  void* mem = heap_caps_malloc(sizeof(JPEGDEC), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (mem != nullptr) modePrepJpeg = new (mem) JPEGDEC();
+
+  modePrepQueue = xQueueCreate(4, sizeof(uint8_t));
+  modePrepMutex = xSemaphoreCreateMutex();
+  if (modePrepJpeg == nullptr || modePrepQueue == NULL || modePrepMutex == NULL ||
+      xTaskCreatePinnedToCore(modePrepTask, "modePrep", 8192, NULL, 1, NULL, 0) != pdPASS) {
+    Serial.println("[LIFECYCLE] ERRORE: task di preparazione non avviato, caricamento nel loop");
+    modePrepQueue = NULL;
+    return;
+  }
+
+  if (currentMode < NUM_MODES) modeLife[currentMode].state = MODE_LIFE_ACTIVE;
+  Serial.printf("[LIFECYCLE] Preparazione modalita' attiva (riserva PSRAM %lu KB)\n",
+                MODE_LIFE_PSRAM_RESERVE / 1024);
+}
+
+// ===== Rilascio =====
+void modeRelease(uint8_t mode) {
+  if (mode >= NUM_MODES) return;
+  uint8_t state = modeLifeState(mode);
+  if (state == MODE_LIFE_PREPARING || state == MODE_LIFE_ACTIVE) return;
+
+  switch (mode) {
+#ifdef EFFECT_ANALOG_CLOCK
+    case MODE_ANALOG_CLOCK:   releaseAnalogClockAssets(); break;
+#endif
+#ifdef EFFECT_BTTF
+    case MODE_BTTF:           releaseBTTFAssets(); break;
+#endif
+#ifdef EFFECT_FLUX_CAPACITOR
+    case MODE_FLUX_CAPACITOR: releaseFluxAssets(); break;
+#endif
+#ifdef EFFECT_FLIP_CLOCK
+    case MODE_FLIP_CLOCK:     releaseFlipClockAssets(); break;
+#endif
+    default: break;
+  }
+  modeLife[mode].state = MODE_LIFE_COLD;
+  modeLifeReleases++;
+  Serial.printf("[LIFECYCLE] Modo %d rilasciato, PSRAM libera: %u KB\n", mode, ESP.getFreePsram() / 1024);
+}
+
+// Libera le modalita' sospese (o preparate e mai usate) meno recenti finche' la PSRAM torna sopra la riserva
+static void modeLifecycleTrim() {
+  while (ESP.getFreePsram() < MODE_LIFE_PSRAM_RESERVE) {
+    int8_t lru = -1;
+    for (uint8_t m = 0; m < NUM_MODES; m++) {
+      uint8_t state = modeLifeState(m);
+      if ((state != MODE_LIFE_SUSPENDED && state != MODE_LIFE_READY) || !modeHasAssets(m) ||
+          m == (uint8_t)currentMode) continue;
+      if (lru < 0 || (int32_t)(modeLife[m].lastUsedMs - modeLife[lru].lastUsedMs) < 0) lru = m;
+    }
+    if (lru < 0) return;
+    modeRelease(lru);
+  }
+}
+
+// ===== Preparazione (asincrona) =====
+void modePrepare(uint8_t mode) {
+  if (mode >= NUM_MODES) return;
+  uint8_t state = modeLifeState(mode);
+  if (state == MODE_LIFE_PREPARING || state == MODE_LIFE_READY || state == MODE_LIFE_ACTIVE) return;
+  modeLife[mode].lastUsedMs = millis();   // Appena richiesta: ultima candidata al rilascio
+
+  if (!modeHasAssets(mode)) {
+    modeLife[mode].state = MODE_LIFE_READY;
+    return;
+  }
+
+  // Sospesa con asset ancora validi: niente da fare
+  if (state == MODE_LIFE_SUSPENDED) {
+    modeLife[mode].state = MODE_LIFE_READY;
+    return;
+  }
+
+  if (modePrepQueue == NULL) return;   // Nessun task: l'init carichera' nel loop
+  modeLifecycleTrim();
+
+  modeLife[mode].state = MODE_LIFE_PREPARING;
+  if (xQueueSend(modePrepQueue, &mode, 0) != pdTRUE) {
+    modeLife[mode].state = MODE_LIFE_COLD;
+  }
+}
+
+// ===== Invalidazione (skin cambiata, file caricati sulla SD) =====
+void modeLifecycleInvalidate(uint8_t mode) {
+  if (mode >= NUM_MODES) return;
+  modeLife[mode].gen++;
+  modeDropAssets(mode);
+  uint8_t state = modeLifeState(mode);
+  if (state == MODE_LIFE_READY || state == MODE_LIFE_SUSPENDED) {
+    modeLife[mode].state = MODE_LIFE_COLD;
+  }
+}
+
+void modeLifecycleInvalidateAll() {
+  for (uint8_t m = 0; m < NUM_MODES; m++) {
+    if (modeHasAssets(m)) modeLifecycleInvalidate(m);
+  }
+}
+
+// ===== Sospensione (da cleanupPreviousMode) =====
+void modeSwitchBegin(uint8_t fromMode) {
+  modeSwitchFrom = fromMode;
+  modeSwitchStartMs = millis();
+}
+
+void modeSuspend(uint8_t mode) {
+  if (mode >= NUM_MODES) return;
+  modeLife[mode].state = modeHasAssets(mode) ? MODE_LIFE_SUSPENDED : MODE_LIFE_COLD;
+  modeLife[mode].lastUsedMs = millis();
+  modeLifecycleTrim();
+}
+
+// ===== Presa in carico =====
+// Segna la modalita' ACTIVE e ritorna lo stato precedente. Se il task la sta preparando
+// attende la fine (il mutex e' suo fino ad allora); se e' ancora in coda il task la
+// saltera' e l'init carica nel loop. In nessun caso task e init lavorano insieme sugli
+// stessi buffer. Chiamata da modeActivate() e dagli init che decodificano nel loop
+// (anche quando currentMode cambia senza passare da modeActivate).
+uint8_t modeLifecycleClaim(uint8_t mode) {
+  if (mode >= NUM_MODES) return MODE_LIFE_COLD;
+  bool locked = false;
+  if (modeLife[mode].state == MODE_LIFE_PREPARING && modePrepMutex != NULL) {
+    locked = xSemaphoreTake(modePrepMutex, portMAX_DELAY) == pdTRUE;
+  }
+  taskENTER_CRITICAL(&modeLifeMux);
+  uint8_t state = modeLife[mode].state;
+  modeLife[mode].state = MODE_LIFE_ACTIVE;
+  taskEXIT_CRITICAL(&modeLifeMux);
+  if (locked) xSemaphoreGive(modePrepMutex);
+  return state;
+}
+
+// ===== Attivazione =====
+void modeActivate(uint8_t mode) {
+  uint32_t t0 = millis();
+
+  if (mode < NUM_MODES) {
+    uint8_t state = modeLifecycleClaim(mode);
+    if (modeHasAssets(mode) && (state == MODE_LIFE_READY || state == MODE_LIFE_SUSPENDED)) {
+      modeLife[mode].warmHits++;
+    }
+    modeLife[mode].lastUsedMs = t0;
+  }
+
+  forceDisplayUpdate();
+
+  uint32_t now = millis();
+  if (modeSwitchFrom >= 0 && modeSwitchLat != nullptr && mode < NUM_MODES) {
+    ModeSwitchLat& lat = modeSwitchLat[modeSwitchFrom * NUM_MODES + mode];
+    uint32_t total = now - modeSwitchStartMs;
+    lat.count++;
+    lat.lastMs = total > 65535 ? 65535 : total;
+    if (lat.lastMs > lat.maxMs) lat.maxMs = lat.lastMs;
+    lat.activateMs = (now - t0) > 65535 ? 65535 : (now - t0);
+    lat.sumMs += total;
+    Serial.printf("[LIFECYCLE] Cambio %d -> %d: %lu ms (avvio modo %u ms)\n",
+                  modeSwitchFrom, mode, (unsigned long)total, lat.activateMs);
+  }
+  modeSwitchFrom = -1;
+}
+
+// ===== Stato in JSON per /modes/lifecycle =====
+String getModeLifecycleJson() {
+  String json = "{";
+  json += "\"psramFree\":" + String(ESP.getFreePsram()) + ",";
+  json += "\"psramReserve\":" + String(MODE_LIFE_PSRAM_RESERVE) + ",";
+  json += "\"releases\":" + String(modeLifeReleases) + ",";
+  json += "\"modes\":[";
+  bool first = true;
+  for (uint8_t m = 0; m < NUM_MODES; m++) {
+    const ModeLifeSlot& slot = modeLife[m];
+    uint8_t state = modeLifeState(m);
+    if (state == MODE_LIFE_COLD && slot.prepares == 0 && m != (uint8_t)currentMode) continue;
+    if (!first) json += ",";
+    first = false;
+    json += "{\"mode\":" + String(m);
+    json += ",\"state\":\"" + String(modeLifeStateName(m == (uint8_t)currentMode ? MODE_LIFE_ACTIVE : state)) + "\"";
+    json += ",\"prepares\":" + String(slot.prepares);
+    json += ",\"prepareMs\":" + String(slot.prepareMs);
+    json += ",\"warmHits\":" + String(slot.warmHits) + "}";
+  }
+  json += "],\"switches\":[";
+  first = true;
+  if (modeSwitchLat != nullptr) {
+    for (uint16_t i = 0; i < NUM_MODES * NUM_MODES; i++) {
+      const ModeSwitchLat& lat = modeSwitchLat[i];
+      if (lat.count == 0) continue;
+      if (!first) json += ",";
+      first = false;
+      json += "{\"from\":" + String(i / NUM_MODES);
+      json += ",\"to\":" + String(i % NUM_MODES);
+      json += ",\"count\":" + String(lat.count);
+      json += ",\"lastMs\":" + String(lat.lastMs);
+      json += ",\"avgMs\":" + String(lat.sumMs / lat.count);
+      json += ",\"maxMs\":" + String(lat.maxMs);
+      json += ",\"activateMs\":" + String(lat.activateMs) + "}";
+    }
+  }
+  json += "]}";
+  return json;
+}
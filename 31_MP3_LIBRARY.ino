@@ -0,0 +1,851 @@
+// ================== LIBRERIA MP3 - INDICE PERSISTENTE SU SD ==================
+// L'elenco dei brani del lettore (31_MP3_PLAYER.ino) non viene piu' costruito in RAM a ogni
+// ingresso nella modalita': un task sul core 0 indicizza /MP3 e scrive su SD un indice
+// binario (MP3_INDEX_PATH) con un record a dimensione fissa per file (mp3_library_types.h).
+//  - chiave: nome + dimensione + data di modifica. Alla riscansione i record con chiave
+//    invariata vengono ricopiati dal vecchio indice; solo i file nuovi o modificati vengono
+//    aperti e analizzati (scansione incrementale)
+//  - MP3: tag ID3v2 (2.2/2.3/2.4, anche unsincronizzati) per titolo e artista, ID3v1/APE
+//    in coda, primo frame valido (confermato dal successivo), header Xing/Info o VBRI per la
+//    durata esatta dei VBR, tag LAME per ritardo/riempimento dell'encoder. Senza header:
+//    durata CBR dai byte. Test su host: tests/host/mp3_library.cpp
+//  - WAV: chunk fmt/data e LIST INFO (INAM/IART)
+//  - i record sono ordinati per nome; il nuovo indice viene scritto su un file temporaneo
+//    e sostituito al vecchio sotto mp3LibMutex (mp3LibraryGeneration() cambia)
+//
+// Lettore e pagina web leggono i record per posizione con mp3LibraryGet(): in RAM restano
+// solo MP3_LIB_PAGES pagine da MP3_LIB_PAGE_ENTRIES record, qualunque sia il numero di file.
+//
+// All'avvio mp3LibraryBegin() valida l'indice esistente (caricamento a caldo: solo
+// l'intestazione) e accoda una riscansione di verifica in background. Tempi di scansione
+// a freddo, caricamento a caldo e statistiche: GET /mp3player/library.
+
+#ifdef EFFECT_MP3_PLAYER
+
+// ===== Parametri =====
+#define MP3_INDEX_PATH          MP3_FOLDER "/.library.idx"
+#define MP3_INDEX_TMP_PATH      MP3_FOLDER "/.library.tmp"
+#define MP3_LIBRARY_MAX_FILES   4000     // Record massimi nell'indice
+#define MP3_LIB_TASK_CORE       0
+#define MP3_LIB_TASK_PRIORITY   1
+#define MP3_LIB_TASK_STACK      6144
+#define MP3_LIB_PAGE_ENTRIES    32       // Record per pagina della cache di lettura
+#define MP3_LIB_PAGES           2        // Pagine in cache (LRU)
+#define MP3_LIB_IO_BYTES        4096     // Buffer di analisi (frame MP3, tag, LIST INFO)
+#define MP3_LIB_TAG_BYTES       2048     // Byte di tag ID3v2/LIST letti per titolo e artista
+#define MP3_LIB_SYNC_LIMIT      65536    // Byte esplorati dopo il tag per trovare il primo frame
+
+// ===== Statistiche =====
+struct MP3LibraryStats {
+  uint32_t warmLoadUs;      // Apertura e validazione dell'indice all'avvio
+  uint32_t coldScanMs;      // Ultima scansione senza indice valido (tutti i file analizzati)
+  uint32_t coldScanFiles;
+  uint32_t lastScanMs;      // Ultima scansione (a freddo o incrementale)
+  uint32_t lastParseMs;     // di cui analisi dei file nuovi/modificati
+  uint16_t lastParsed;
+  uint16_t lastReused;      // Record ricopiati dal vecchio indice
+  uint16_t lastRemoved;
+  uint16_t lastSkipped;     // Nome troppo lungo o oltre MP3_LIBRARY_MAX_FILES
+  uint32_t parseUsTotal;    // Per la media per file
+  uint32_t parsedTotal;
+  uint32_t scans;
+  uint32_t writes;          // Indici riscritti (scansioni con modifiche)
+  uint32_t badFiles;        // Nessun frame/chunk audio riconosciuto
+  uint32_t pageHits;
+  uint32_t pageMisses;
+};
+MP3LibraryStats mp3LibStats;
+
+// ===== Stato =====
+static SemaphoreHandle_t mp3LibMutex = NULL;     // Protegge file indice, intestazione e cache
+static TaskHandle_t mp3LibTaskHandle = nullptr;
+static File mp3LibFile;                          // Indice aperto in lettura
+static MP3IndexHeader mp3LibHeader;
+static volatile uint32_t mp3LibCount = 0;
+static volatile uint32_t mp3LibGen = 0;
+static volatile bool mp3LibScanning = false;
+static volatile uint16_t mp3LibScanSeen = 0;     // Voci di directory lette nella scansione in corso
+static MP3IndexEntry* mp3LibPages = nullptr;     // MP3_LIB_PAGES x MP3_LIB_PAGE_ENTRIES (PSRAM)
+static int32_t mp3LibPageFirst[MP3_LIB_PAGES];   // Primo record di ogni pagina (-1 = vuota)
+static uint32_t mp3LibPageUse[MP3_LIB_PAGES];
+static uint32_t mp3LibPageTick = 0;
+static uint8_t* mp3LibIoBuf = nullptr;           // Usato solo dal task
+
+// ===== Helper binari =====
+static inline uint32_t mp3LibBE32(const uint8_t* b) {
+  return ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) | b[3];
+}
+static inline uint32_t mp3LibLE32(const uint8_t* b) {
+  return ((uint32_t)b[3] << 24) | ((uint32_t)b[2] << 16) | ((uint32_t)b[1] << 8) | b[0];
+}
+static inline uint32_t mp3LibSyncsafe(const uint8_t* b) {
+  return ((uint32_t)(b[0] & 0x7F) << 21) | ((uint32_t)(b[1] & 0x7F) << 14) |
+         ((uint32_t)(b[2] & 0x7F) << 7) | (b[3] & 0x7F);
+}
+
+static bool mp3LibReadAt(File& f, uint32_t pos, uint8_t* buf, size_t len) {
+  return f.seek(pos) && f.read(buf, len) == len;
+}
+
+// ===== Testo dei tag -> UTF-8 =====
+// Aggiunge un code point (BMP) senza spezzare caratteri; false se non c'e' piu' spazio
+static bool mp3LibPutUtf8(char* dst, size_t cap, size_t& len, uint32_t cp) {
+  if (cp < 0x20) cp = ' ';   // Tab e a capo: il testo finisce in JSON e a schermo
+  uint8_t tmp[3];
+  size_t n;
+  if (cp < 0x80) {
+    tmp[0] = cp; n = 1;
+  } else if (cp < 0x800) {
+    tmp[0] = 0xC0 | (cp >> 6); tmp[1] = 0x80 | (cp & 0x3F); n = 2;
+  } else {
+    tmp[0] = 0xE0 | (cp >> 12); tmp[1] = 0x80 | ((cp >> 6) & 0x3F); tmp[2] = 0x80 | (cp & 0x3F); n = 3;
+  }
+  if (len + n >= cap) return false;
+  memcpy(dst + len, tmp, n);
+  len += n;
+  dst[len] = '\0';
+  return true;
+}
+
+// Codifiche ID3v2: 0 = ISO-8859-1, 1 = UTF-16 con BOM, 2 = UTF-16BE, 3 = UTF-8
+static void mp3LibDecodeText(uint8_t enc, const uint8_t* p, size_t n, char* dst, size_t cap) {
+  size_t len = 0;
+  dst[0] = '\0';
+  if (enc == 1 || enc == 2) {
+    bool be = (enc == 2);
+    if (enc == 1 && n >= 2) {
+      if (p[0] == 0xFF && p[1] == 0xFE) { be = false; p += 2; n -= 2; }
+      else if (p[0] == 0xFE && p[1] == 0xFF) { be = true; p += 2; n -= 2; }
+    }
+    for (size_t i = 0; i + 1 < n; i += 2) {
+      uint32_t cu = be ? ((uint32_t)p[i] << 8 | p[i + 1]) : ((uint32_t)p[i + 1] << 8 | p[i]);
+      if (cu == 0) break;
+      if (cu >= 0xD800 && cu <= 0xDFFF) cu = '?';   // Fuori dal BMP: nessun font lo disegna
+      if (!mp3LibPutUtf8(dst, cap, len, cu)) break;
+    }
+  } else if (enc == 3) {
+    size_t i = 0;
+    while (i < n && p[i]) {
+      uint8_t c = p[i];
+      size_t cl = (c >= 0xF0) ? 4 : (c >= 0xE0) ? 3 : (c >= 0xC0) ? 2 : 1;
+      if (i + cl > n || len + cl >= cap) break;
+      if (cl == 1) {
+        dst[len++] = (c < 0x20) ? ' ' : (c >= 0x80) ? '?' : (char)c;   // Byte di continuazione isolato
+      } else {
+        memcpy(dst + len, p + i, cl);
+        len += cl;
+      }
+      i += cl;
+    }
+    dst[len] = '\0';
+  } else {
+    for (size_t i = 0; i < n && p[i]; i++) {
+      if (!mp3LibPutUtf8(dst, cap, len, p[i])) break;
+    }
+  }
+  // Spazi finali (ID3v1 e alcuni encoder riempiono i campi con spazi)
+  while (len > 0 && dst[len - 1] == ' ') dst[--len] = '\0';
+}
+
+// LIST INFO dei WAV: nessuna codifica dichiarata, UTF-8 se valido altrimenti ISO-8859-1
+static bool mp3LibLooksUtf8(const uint8_t* p, size_t n) {
+  for (size_t i = 0; i < n && p[i]; ) {
+    uint8_t c = p[i];
+    size_t cl = (c < 0x80) ? 1 : ((c & 0xE0) == 0xC0) ? 2 : ((c & 0xF0) == 0xE0) ? 3 : ((c & 0xF8) == 0xF0) ? 4 : 0;
+    if (cl == 0 || i + cl > n) return false;
+    for (size_t k = 1; k < cl; k++) {
+      if ((p[i + k] & 0xC0) != 0x80) return false;
+    }
+    i += cl;
+  }
+  return true;
+}
+
+// Copia troncando senza lasciare un carattere UTF-8 a meta'
+static void mp3LibCopyUtf8(char* dst, size_t cap, const char* src) {
+  size_t n = strlen(src);
+  if (n >= cap) {
+    n = cap - 1;
+    while (n > 0 && ((uint8_t)src[n] & 0xC0) == 0x80) n--;
+  }
+  memcpy(dst, src, n);
+  dst[n] = '\0';
+}
+
+// ===== ID3v2 =====
+// Unsincronizzazione: l'encoder inserisce 0x00 dopo ogni 0xFF che potrebbe sembrare un sync
+// MPEG; qui si tolgono sul posto. Restituisce la nuova lunghezza.
+static size_t mp3LibUnsync(uint8_t* p, size_t n) {
+  size_t w = 0;
+  for (size_t r = 0; r < n; r++) {
+    p[w++] = p[r];
+    if (p[r] == 0xFF && r + 1 < n && p[r + 1] == 0x00) r++;
+  }
+  return w;
+}
+
+// Restituisce la dimensione totale del tag in testa (0 = assente) e ne legge titolo/artista
+static uint32_t mp3LibParseID3v2(File& f, MP3IndexEntry& e) {
+  uint8_t h[10];
+  if (!mp3LibReadAt(f, 0, h, 10) || memcmp(h, "ID3", 3) != 0) return 0;
+  uint8_t ver = h[3], flags = h[5];
+  if (ver < 2 || ver > 4 || ((h[6] | h[7] | h[8] | h[9]) & 0x80)) return 0;
+  uint32_t body = mp3LibSyncsafe(h + 6);
+  uint32_t total = 10 + body + ((ver == 4 && (flags & 0x10)) ? 10 : 0);
+  e.flags |= MP3_IDX_ID3V2;
+
+  // I frame di testo stanno in testa: le copertine (APIC) di solito dopo
+  size_t n = (body < MP3_LIB_TAG_BYTES) ? body : MP3_LIB_TAG_BYTES;
+  uint8_t* b = mp3LibIoBuf;
+  if (n < 10 || !mp3LibReadAt(f, 10, b, n)) return total;
+  // v2.2/v2.3: flag 0x80 = tutto il tag unsincronizzato, le dimensioni dei frame valgono dopo.
+  // v2.4: per frame (flag 0x02, o 0x80 del tag), dimensioni come scritte su file.
+  bool unsyncAll = (flags & 0x80) != 0;
+  if (unsyncAll && ver < 4) n = mp3LibUnsync(b, n);
+
+  size_t pos = 0;
+  if (flags & 0x40) {   // Header esteso
+    if (ver == 3) pos = 4 + mp3LibBE32(b);
+    else if (ver == 4) pos = mp3LibSyncsafe(b);
+  }
+  const size_t idLen = (ver == 2) ? 3 : 4;
+  const size_t hdrLen = (ver == 2) ? 6 : 10;
+  const char* titleId = (ver == 2) ? "TT2" : "TIT2";
+  const char* artistId = (ver == 2) ? "TP1" : "TPE1";
+
+  while (pos + hdrLen < n) {
+    const uint8_t* fr = b + pos;
+    if (fr[0] == 0) break;   // Padding
+    uint32_t sz;
+    if (ver == 2) sz = ((uint32_t)fr[3] << 16) | ((uint32_t)fr[4] << 8) | fr[5];
+    else if (ver == 3) sz = mp3LibBE32(fr + 4);
+    else sz = mp3LibSyncsafe(fr + 4);
+    if (sz == 0 || sz > body) break;
+
+    bool isTitle = memcmp(fr, titleId, idLen) == 0;
+    bool isArtist = memcmp(fr, artistId, idLen) == 0;
+    if (isTitle || isArtist) {
+      const uint8_t* data = fr + hdrLen;
+      size_t avail = n - pos - hdrLen;   // Frame oltre il buffer: basta la parte letta
+      if (avail > sz) avail = sz;
+      // Frame compressi/cifrati/raggruppati non leggibili; v2.4 puo' anteporre la lunghezza
+      bool plain = true;
+      if (ver == 3) plain = (fr[9] & 0xE0) == 0;
+      else if (ver == 4) {
+        plain = (fr[9] & 0x4C) == 0;
+        if (plain && (fr[9] & 0x01) && avail > 4) { data += 4; avail -= 4; }
+        if (plain && (unsyncAll || (fr[9] & 0x02))) avail = mp3LibUnsync(b + (data - b), avail);
+      }
+      if (plain && avail > 1) {
+        if (isTitle && !e.title[0]) mp3LibDecodeText(data[0], data + 1, avail - 1, e.title, sizeof(e.title));
+        if (isArtist && !e.artist[0]) mp3LibDecodeText(data[0], data + 1, avail - 1, e.artist, sizeof(e.artist));
+      }
+      if (e.title[0] && e.artist[0]) break;
+    }
+    pos += hdrLen + sz;
+  }
+  return total;
+}
+
+// ===== ID3v1 / APE in coda =====
+static void mp3LibParseTail(File& f, MP3IndexEntry& e) {
+  uint32_t end = e.size;
+  uint8_t t[128];
+  if (end >= 128 && mp3LibReadAt(f, end - 128, t, 128) && memcmp(t, "TAG", 3) == 0) {
+    end -= 128;
+    e.flags |= MP3_IDX_ID3V1;
+    if (!e.title[0]) mp3LibDecodeText(0, t + 3, 30, e.title, sizeof(e.title));
+    if (!e.artist[0]) mp3LibDecodeText(0, t + 33, 30, e.artist, sizeof(e.artist));
+  }
+  // Footer APEv1/v2 (prima dell'eventuale ID3v1): dimensione senza l'header opzionale
+  if (end >= 32 && mp3LibReadAt(f, end - 32, t, 32) && memcmp(t, "APETAGEX", 8) == 0) {
+    uint32_t apeSize = mp3LibLE32(t + 12) + ((mp3LibLE32(t + 20) & 0x80000000UL) ? 32 : 0);
+    if (apeSize <= end) {
+      end -= apeSize;
+      e.flags |= MP3_IDX_ID3V1;
+    }
+  }
+  e.audioEnd = end;
+}
+
+// ===== Header frame MPEG audio =====
+static const uint16_t MP3_LIB_KBPS[2][3][16] = {
+  { // MPEG1: Layer I, II, III
+    {0, 32, 64, 96, 128, 160, 192, 224, 256, 288, 320, 352, 384, 416, 448, 0},
+    {0, 32, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 384, 0},
+    {0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0} },
+  { // MPEG2 / MPEG2.5
+    {0, 32, 48, 56, 64, 80, 96, 112, 128, 144, 160, 176, 192, 224, 256, 0},
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0},
+    {0, 8, 16, 24, 32, 40, 48, 56, 64, 80, 96, 112, 128, 144, 160, 0} }
+};
+static const uint16_t MP3_LIB_RATES[3] = {44100, 48000, 32000};
+
+// Lunghezza del frame in byte (0 = header non valido)
+static uint32_t mp3LibFrameInfo(const uint8_t* h, uint32_t& rate, uint16_t& kbps, uint16_t& spf, uint8_t& chans) {
+  if (h[0] != 0xFF || (h[1] & 0xE0) != 0xE0) return 0;
+  uint8_t ver = (h[1] >> 3) & 3;     // 3 = MPEG1, 2 = MPEG2, 0 = MPEG2.5
+  uint8_t layer = (h[1] >> 1) & 3;   // 3 = I, 2 = II, 1 = III
+  uint8_t bri = h[2] >> 4, sri = (h[2] >> 2) & 3, pad = (h[2] >> 1) & 1;
+  if (ver == 1 || layer == 0 || bri == 0 || bri == 15 || sri == 3) return 0;
+  bool mpeg1 = (ver == 3);
+  uint8_t li = 3 - layer;            // 0 = I, 1 = II, 2 = III
+  kbps = MP3_LIB_KBPS[mpeg1 ? 0 : 1][li][bri];
+  rate = MP3_LIB_RATES[sri] >> (mpeg1 ? 0 : (ver == 2 ? 1 : 2));
+  chans = ((h[3] >> 6) == 3) ? 1 : 2;
+  if (li == 0) {
+    spf = 384;
+    return (12UL * kbps * 1000 / rate + pad) * 4;
+  }
+  spf = (li == 2 && !mpeg1) ? 576 : 1152;
+  return (uint32_t)spf / 8 * kbps * 1000 / rate + pad;
+}
+
+// Stessa versione, layer e frequenza: conferma che il sync trovato non e' un falso positivo
+static bool mp3LibSameStream(const uint8_t* a, const uint8_t* b) {
+  return b[0] == 0xFF && (a[1] & 0xFE) == (b[1] & 0xFE) && (a[2] & 0x0C) == (b[2] & 0x0C);
+}
+
+// ===== MP3 =====
+static void mp3LibParseMP3(File& f, MP3IndexEntry& e) {
+  uint32_t start = mp3LibParseID3v2(f, e);
+  mp3LibParseTail(f, e);
+  uint8_t* b = mp3LibIoBuf;
+
+  // Primo frame valido confermato dall'header del successivo
+  uint32_t pos = 0, len = 0, rate = 0;
+  uint16_t kbps = 0, spf = 0;
+  uint8_t chans = 0;
+  bool found = false;
+  for (uint32_t off = start; !found && off + 4 <= e.audioEnd && off < start + MP3_LIB_SYNC_LIMIT; ) {
+    size_t n = e.audioEnd - off;
+    if (n > MP3_LIB_IO_BYTES) n = MP3_LIB_IO_BYTES;
+    if (!mp3LibReadAt(f, off, b, n)) break;
+    for (size_t i = 0; i + 4 <= n; i++) {
+      if (b[i] != 0xFF) continue;
+      uint32_t l = mp3LibFrameInfo(b + i, rate, kbps, spf, chans);
+      if (l == 0) continue;
+      uint32_t next = off + i + l;
+      uint8_t nh[4];
+      bool ok;
+      if (next == e.audioEnd) ok = true;                          // File di un solo frame
+      else if (i + l + 4 <= n) ok = mp3LibSameStream(b + i, b + i + l);
+      else ok = next + 4 <= e.audioEnd && mp3LibReadAt(f, next, nh, 4) && mp3LibSameStream(b + i, nh);
+      if (ok) {
+        pos = off + i;
+        len = l;
+        found = true;
+        break;
+      }
+    }
+    off += n - 3;   // Sovrapposizione: un header a cavallo dei blocchi non va perso
+  }
+  if (!found) {
+    e.flags |= MP3_IDX_BAD;
+    return;
+  }
+
+  e.audioStart = pos;
+  e.sampleRate = rate;
+  e.channels = chans;
+  e.bitrateKbps = kbps;
+
+  // Header Xing/Info (dopo le side info) o VBRI (offset fisso 36) nel primo frame
+  size_t n = (e.audioEnd - pos < 256) ? e.audioEnd - pos : 256;
+  uint64_t samples = 0;
+  if (mp3LibReadAt(f, pos, b, n)) {
+    bool mpeg1 = ((b[1] >> 3) & 3) == 3;
+    size_t x = 4 + (mpeg1 ? (chans == 1 ? 17 : 32) : (chans == 1 ? 9 : 17));
+    if (x + 8 <= n && (memcmp(b + x, "Xing", 4) == 0 || memcmp(b + x, "Info", 4) == 0)) {
+      e.flags |= MP3_IDX_XING;
+      if (b[x] == 'X') e.flags |= MP3_IDX_VBR;
+      uint32_t xf = mp3LibBE32(b + x + 4);
+      size_t p = x + 8;
+      if ((xf & 0x01) && p + 4 <= n) { samples = (uint64_t)mp3LibBE32(b + p) * spf; p += 4; }
+      if (xf & 0x02) p += 4;     // Byte
+      if (xf & 0x04) p += 100;   // TOC
+      if (xf & 0x08) p += 4;     // Qualita'
+      // Tag LAME (scritto anche da ffmpeg): ritardo e riempimento a 12 bit
+      if (p + 24 <= n && (memcmp(b + p, "LAME", 4) == 0 || memcmp(b + p, "Lavc", 4) == 0 ||
+                          memcmp(b + p, "Lavf", 4) == 0)) {
+        e.flags |= MP3_IDX_LAME;
+        e.encDelay = ((uint16_t)b[p + 21] << 4) | (b[p + 22] >> 4);
+        e.encPadding = ((uint16_t)(b[p + 22] & 0x0F) << 8) | b[p + 23];
+        if (samples > (uint64_t)e.encDelay + e.encPadding) samples -= e.encDelay + e.encPadding;
+      }
+      e.audioStart = pos + len;   // Il frame informativo non contiene audio
+    } else if (n >= 36 + 18 && memcmp(b + 36, "VBRI", 4) == 0) {
+      e.flags |= MP3_IDX_VBRI | MP3_IDX_VBR;
+      samples = (uint64_t)mp3LibBE32(b + 36 + 14) * spf;
+      e.audioStart = pos + len;
+    }
+  }
+
+  if (samples > 0) {
+    e.samples = (uint32_t)samples;
+    e.durationMs = samples * 1000 / rate;
+    if (e.durationMs > 0) e.bitrateKbps = (uint64_t)(e.audioEnd - e.audioStart) * 8 / e.durationMs;
+  } else if (kbps > 0) {
+    e.durationMs = (uint64_t)(e.audioEnd - e.audioStart) * 8 / kbps;   // CBR: bit / (kbit/s) = ms
+  }
+}
+
+// ===== WAV =====
+static void mp3LibParseWavInfo(File& f, uint32_t pos, uint32_t len, MP3IndexEntry& e) {
+  uint8_t* b = mp3LibIoBuf;
+  size_t n = (len < MP3_LIB_TAG_BYTES) ? len : MP3_LIB_TAG_BYTES;
+  if (n < 12 || !mp3LibReadAt(f, pos, b, n) || memcmp(b, "INFO", 4) != 0) return;
+  size_t p = 4;
+  while (p + 8 <= n) {
+    uint32_t sz = mp3LibLE32(b + p + 4);
+    size_t avail = n - p - 8;
+    if (avail > sz) avail = sz;
+    char* dst = nullptr;
+    size_t cap = 0;
+    if (memcmp(b + p, "INAM", 4) == 0 && !e.title[0]) { dst = e.title; cap = sizeof(e.title); }
+    else if (memcmp(b + p, "IART", 4) == 0 && !e.artist[0]) { dst = e.artist; cap = sizeof(e.artist); }
+    if (dst) mp3LibDecodeText(mp3LibLooksUtf8(b + p + 8, avail) ? 3 : 0, b + p + 8, avail, dst, cap);
+    if (sz > n) break;
+    p += 8 + sz + (sz & 1);
+  }
+}
+
+static void mp3LibParseWAV(File& f, MP3IndexEntry& e) {
+  uint8_t h[16];
+  if (!mp3LibReadAt(f, 0, h, 12) || memcmp(h, "RIFF", 4) != 0 || memcmp(h + 8, "WAVE", 4) != 0) {
+    e.flags |= MP3_IDX_BAD;
+    return;
+  }
+  uint32_t pos = 12, byteRate = 0, dataSize = 0, blockAlign = 0;
+  bool haveFmt = false, haveData = false;
+  for (int guard = 0; guard < 32 && pos + 8 <= e.size; guard++) {
+    if (!mp3LibReadAt(f, pos, h, 8)) break;
+    uint32_t len = mp3LibLE32(h + 4);
+    if (memcmp(h, "fmt ", 4) == 0 && len >= 16) {
+      if (!mp3LibReadAt(f, pos + 8, h, 16)) break;
+      e.channels = h[2];
+      e.sampleRate = mp3LibLE32(h + 4);
+      byteRate = mp3LibLE32(h + 8);
+      blockAlign = h[12] | ((uint16_t)h[13] << 8);
+      haveFmt = true;
+    } else if (memcmp(h, "data", 4) == 0) {
+      e.audioStart = pos + 8;
+      // Registrazioni interrotte lasciano 0 o 0xFFFFFFFF: vale la fine del file
+      uint32_t avail = e.size - e.audioStart;
+      dataSize = (len == 0 || len > avail) ? avail : len;
+      haveData = true;
+      len = dataSize;
+    } else if (memcmp(h, "LIST", 4) == 0) {
+      mp3LibParseWavInfo(f, pos + 8, len, e);
+    }
+    uint64_t next = (uint64_t)pos + 8 + len + (len & 1);
+    if (next > e.size) break;
+    pos = next;
+  }
+  if (!haveFmt || !haveData || byteRate == 0) {
+    e.flags |= MP3_IDX_BAD;
+    return;
+  }
+  e.audioEnd = e.audioStart + dataSize;
+  e.durationMs = (uint64_t)dataSize * 1000 / byteRate;
+  if (blockAlign > 0) e.samples = dataSize / blockAlign;
+  e.bitrateKbps = byteRate * 8 / 1000;
+}
+
+// Analizza un file nuovo o modificato (e: nome, dimensione, data e tipo gia' impostati)
+static void mp3LibParseFile(File& f, MP3IndexEntry& e) {
+  uint32_t t0 = micros();
+  if (e.type == AUDIO_TYPE_WAV) mp3LibParseWAV(f, e);
+  else mp3LibParseMP3(f, e);
+  if (!e.title[0]) mp3LibCopyUtf8(e.title, sizeof(e.title), extractTitle(e.name).c_str());
+  if (e.flags & MP3_IDX_BAD) {
+    mp3LibStats.badFiles++;
+    Serial.printf("[MP3-LIB] Formato non riconosciuto: %s\n", e.name);
+  }
+  mp3LibStats.parseUsTotal += micros() - t0;
+  mp3LibStats.parsedTotal++;
+}
+
+// ===== File indice =====
+// Chiamata con mp3LibMutex preso (o prima dell'avvio del task)
+static bool mp3LibOpenIndex() {
+  if (mp3LibFile) mp3LibFile.close();
+  mp3LibCount = 0;
+  memset(&mp3LibHeader, 0, sizeof(mp3LibHeader));
+  for (int p = 0; p < MP3_LIB_PAGES; p++) mp3LibPageFirst[p] = -1;
+
+  if (!SD.exists(MP3_INDEX_PATH)) return false;
+  File f = SD.open(MP3_INDEX_PATH, FILE_READ);
+  if (!f) return false;
+  MP3IndexHeader h;
+  if (f.read((uint8_t*)&h, sizeof(h)) != sizeof(h) || h.magic != MP3_INDEX_MAGIC ||
+      h.version != MP3_INDEX_VERSION || h.entrySize != sizeof(MP3IndexEntry) ||
+      h.count > MP3_LIBRARY_MAX_FILES ||
+      f.size() != sizeof(h) + (size_t)h.count * sizeof(MP3IndexEntry)) {
+    f.close();
+    Serial.println("[MP3-LIB] Indice non valido: verra' ricostruito");
+    return false;
+  }
+  mp3LibHeader = h;
+  mp3LibFile = f;
+  mp3LibCount = h.count;
+  return true;
+}
+
+static int mp3LibCompare(const void* a, const void* b) {
+  return strcasecmp(((const MP3IndexEntry*)a)->name, ((const MP3IndexEntry*)b)->name);
+}
+
+static uint32_t mp3LibHashName(const char* s) {
+  uint32_t h = 2166136261UL;   // FNV-1a
+  while (*s) h = (h ^ (uint8_t)*s++) * 16777619UL;
+  return h;
+}
+
+// ===== Scansione (task) =====
+static void mp3LibraryRebuild() {
+  uint32_t t0 = millis();
+  uint32_t parseUs0 = mp3LibStats.parseUsTotal;
+  mp3LibScanSeen = 0;
+
+  // 1. Vecchio indice in PSRAM con tabella hash per nome
+  MP3IndexEntry* old = nullptr;
+  int32_t* hash = nullptr;
+  uint32_t hashMask = 0;
+  xSemaphoreTake(mp3LibMutex, portMAX_DELAY);
+  bool hadIndex = (bool)mp3LibFile;
+  uint32_t oldCount = mp3LibCount;
+  if (oldCount > 0) {
+    size_t bytes = oldCount * sizeof(MP3IndexEntry);
+    old = (MP3IndexEntry*)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM);
+    if (old == nullptr || !mp3LibFile.seek(sizeof(MP3IndexHeader)) ||
+        mp3LibFile.read((uint8_t*)old, bytes) != bytes) {
+      if (old) heap_caps_free(old);
+      old = nullptr;
+      oldCount = 0;
+    }
+  }
+  xSemaphoreGive(mp3LibMutex);
+
+  if (oldCount > 0) {
+    uint32_t hsize = 64;
+    while (hsize < oldCount * 2) hsize <<= 1;
+    hash = (int32_t*)heap_caps_malloc(hsize * sizeof(int32_t), MALLOC_CAP_SPIRAM);
+    if (hash) {
+      memset(hash, 0xFF, hsize * sizeof(int32_t));
+      hashMask = hsize - 1;
+      for (uint32_t i = 0; i < oldCount; i++) {
+        uint32_t h = mp3LibHashName(old[i].name) & hashMask;
+        while (hash[h] >= 0) h = (h + 1) & hashMask;
+        hash[h] = i;
+      }
+    }
+  }
+
+  // 2. Lettura della cartella: record riusati o analizzati
+  uint32_t cap = oldCount + 64;
+  if (cap < 256) cap = 256;
+  if (cap > MP3_LIBRARY_MAX_FILES) cap = MP3_LIBRARY_MAX_FILES;
+  MP3IndexEntry* list = (MP3IndexEntry*)heap_caps_malloc(cap * sizeof(MP3IndexEntry), MALLOC_CAP_SPIRAM);
+  uint32_t count = 0, parsed = 0, reused = 0, skipped = 0;
+  uint64_t totalBytes = 0, totalMs = 0;
+  File root = SD.open(MP3_FOLDER);
+  bool dirOk = list != nullptr && root && root.isDirectory();
+
+  if (dirOk) {
+    File f = root.openNextFile();
+    while (f) {
+      const char* name = f.name();
+      size_t nl = strlen(name);
+      bool isWAV = nl > 4 && strcasecmp(name + nl - 4, ".wav") == 0;
+      bool isMP3 = nl > 4 && strcasecmp(name + nl - 4, ".mp3") == 0;
+      // I file nascosti ("._brano.mp3" di macOS) non sono audio
+      if (!f.isDirectory() && (isMP3 || isWAV) && name[0] != '.') {
+        if (count == cap && cap < MP3_LIBRARY_MAX_FILES) {
+          uint32_t newCap = (cap * 2 > MP3_LIBRARY_MAX_FILES) ? MP3_LIBRARY_MAX_FILES : cap * 2;
+          MP3IndexEntry* grown = (MP3IndexEntry*)heap_caps_realloc(list, newCap * sizeof(MP3IndexEntry), MALLOC_CAP_SPIRAM);
+          if (grown) {
+            list = grown;
+            cap = newCap;
+          }
+        }
+        if (nl >= MP3_INDEX_NAME_LEN || count == cap) {
+          skipped++;
+        } else {
+          MP3IndexEntry& e = list[count];
+          uint32_t size = f.size();
+          uint32_t mtime = (uint32_t)f.getLastWrite();
+          int32_t hit = -1;
+          if (hash) {
+            uint32_t h = mp3LibHashName(name) & hashMask;
+            while (hash[h] >= 0) {
+              if (strcmp(old[hash[h]].name, name) == 0) { hit = hash[h]; break; }
+              h = (h + 1) & hashMask;
+            }
+          }
+          if (hit >= 0 && old[hit].size == size && old[hit].mtime == mtime) {
+            e = old[hit];
+            reused++;
+          } else {
+            memset(&e, 0, sizeof(e));
+            memcpy(e.name, name, nl + 1);
+            e.size = size;
+            e.mtime = mtime;
+            e.type = isWAV ? AUDIO_TYPE_WAV : AUDIO_TYPE_MP3;
+            mp3LibParseFile(f, e);
+            parsed++;
+          }
+          totalBytes += e.size;
+          totalMs += e.durationMs;
+          count++;
+        }
+      }
+      f.close();
+      mp3LibScanSeen++;
+      if ((mp3LibScanSeen & 15) == 0) vTaskDelay(1);   // Lascia il bus SD all'audio
+      f = root.openNextFile();
+    }
+  }
+  if (root) root.close();
+
+  // 3. Nuovo indice ordinato per nome, scritto solo se qualcosa e' cambiato
+  bool changed = dirOk && (!hadIndex || parsed > 0 || count != oldCount);
+  bool written = false;
+  if (changed) {
+    qsort(list, count, sizeof(MP3IndexEntry), mp3LibCompare);
+    MP3IndexHeader h;
+    memset(&h, 0, sizeof(h));
+    h.magic = MP3_INDEX_MAGIC;
+    h.version = MP3_INDEX_VERSION;
+    h.entrySize = sizeof(MP3IndexEntry);
+    h.count = count;
+    h.totalSeconds = totalMs / 1000;
+    h.totalBytes = totalBytes;
+
+    size_t bytes = count * sizeof(MP3IndexEntry);
+    File out = SD.open(MP3_INDEX_TMP_PATH, FILE_WRITE);
+    bool ok = out && out.write((const uint8_t*)&h, sizeof(h)) == sizeof(h) &&
+              (bytes == 0 || out.write((const uint8_t*)list, bytes) == bytes);
+    if (out) out.close();
+
+    if (ok) {
+      xSemaphoreTake(mp3LibMutex, portMAX_DELAY);
+      if (mp3LibFile) mp3LibFile.close();
+      if (SD.exists(MP3_INDEX_PATH)) SD.remove(MP3_INDEX_PATH);
+      ok = SD.rename(MP3_INDEX_TMP_PATH, MP3_INDEX_PATH);
+      mp3LibOpenIndex();
+      mp3LibGen++;
+      xSemaphoreGive(mp3LibMutex);
+      written = ok;
+      mp3LibStats.writes++;
+      frameGovKick();   // Il lettore riallinea la traccia corrente al nuovo indice
+    }
+    if (!ok) {
+      SD.remove(MP3_INDEX_TMP_PATH);
+      Serial.println("[MP3-LIB] ERRORE: scrittura indice fallita");
+    }
+  }
+
+  if (old) heap_caps_free(old);
+  if (hash) heap_caps_free(hash);
+  if (list) heap_caps_free(list);
+
+  if (!dirOk) {
+    Serial.println("[MP3-LIB] ERRORE: cartella /MP3 non leggibile o memoria insufficiente");
+    return;
+  }
+
+  uint32_t ms = millis() - t0;
+  mp3LibStats.scans++;
+  mp3LibStats.lastScanMs = ms;
+  mp3LibStats.lastParseMs = (mp3LibStats.parseUsTotal - parseUs0) / 1000;
+  mp3LibStats.lastParsed = parsed;
+  mp3LibStats.lastReused = reused;
+  mp3LibStats.lastRemoved = oldCount - reused;
+  mp3LibStats.lastSkipped = skipped;
+  if (!hadIndex) {
+    mp3LibStats.coldScanMs = ms;
+    mp3LibStats.coldScanFiles = count;
+  }
+  Serial.printf("[MP3-LIB] Scansione %s: %lu brani (%lu analizzati, %lu invariati, %lu rimossi, %lu saltati) in %lu ms%s\n",
+                hadIndex ? "incrementale" : "a freddo", (unsigned long)count, (unsigned long)parsed,
+                (unsigned long)reused, (unsigned long)(oldCount - reused), (unsigned long)skipped,
+                (unsigned long)ms, written ? ", indice riscritto" : "");
+}
+
+static void mp3LibraryTask(void* param) {
+  for (;;) {
+    if (ulTaskNotifyTake(pdTRUE, portMAX_DELAY) == 0) continue;
+    // Richieste arrivate durante la scansione (upload multipli): una sola ripetizione
+    do {
+      mp3LibScanning = true;
+      mp3LibraryRebuild();
+    } while (ulTaskNotifyTake(pdTRUE, 0) > 0);
+    mp3LibScanning = false;
+  }
+}
+
+// ===== API =====
+// Idempotente: da chiamare con la SD montata (setup_sd, initMP3Player)
+void mp3LibraryBegin() {
+  if (mp3LibMutex != NULL || SD.cardType() == CARD_NONE) return;
+
+  mp3LibPages = (MP3IndexEntry*)heap_caps_malloc(MP3_LIB_PAGES * MP3_LIB_PAGE_ENTRIES * sizeof(MP3IndexEntry),
+                                                 MALLOC_CAP_SPIRAM);
+  mp3LibIoBuf = (uint8_t*)malloc(MP3_LIB_IO_BYTES);
+  SemaphoreHandle_t mutex = xSemaphoreCreateMutex();
+  if (mp3LibPages == nullptr || mp3LibIoBuf == nullptr || mutex == NULL) {
+    Serial.println("[MP3-LIB] ERRORE: memoria insufficiente per la libreria");
+    if (mp3LibPages) heap_caps_free(mp3LibPages);
+    if (mp3LibIoBuf) free(mp3LibIoBuf);
+    if (mutex) vSemaphoreDelete(mutex);
+    mp3LibPages = nullptr;
+    mp3LibIoBuf = nullptr;
+    return;
+  }
+
+  if (!SD.exists(MP3_FOLDER)) SD.mkdir(MP3_FOLDER);
+
+  // Caricamento a caldo: intestazione validata, i record si leggono a pagine su richiesta
+  uint32_t t0 = micros();
+  bool warm = mp3LibOpenIndex();
+  mp3LibStats.warmLoadUs = micros() - t0;
+  mp3LibMutex = mutex;
+  mp3LibGen++;
+  if (warm) {
+    Serial.printf("[MP3-LIB] Indice caricato: %lu brani in %lu us\n",
+                  (unsigned long)mp3LibCount, (unsigned long)mp3LibStats.warmLoadUs);
+  } else {
+    Serial.println("[MP3-LIB] Nessun indice: scansione completa in background");
+  }
+
+  if (xTaskCreatePinnedToCore(mp3LibraryTask, "mp3Lib", MP3_LIB_TASK_STACK, nullptr,
+                              MP3_LIB_TASK_PRIORITY, &mp3LibTaskHandle, MP3_LIB_TASK_CORE) != pdPASS) {
+    mp3LibTaskHandle = nullptr;
+    Serial.println("[MP3-LIB] ERRORE: task di indicizzazione non avviato");
+    return;
+  }
+  mp3LibraryRequestScan();   // Verifica incrementale dell'indice caricato
+}
+
+// Accoda una riscansione (upload, eliminazione). Sicura dai callback del webserver.
+void mp3LibraryRequestScan() {
+  if (mp3LibTaskHandle == nullptr) return;
+  mp3LibScanning = true;
+  xTaskNotifyGive(mp3LibTaskHandle);
+}
+
+int mp3LibraryCount() {
+  return (int)mp3LibCount;
+}
+
+// Cambia a ogni sostituzione dell'indice: le posizioni dei brani possono essere cambiate
+uint32_t mp3LibraryGeneration() {
+  return mp3LibGen;
+}
+
+bool mp3LibraryScanning() {
+  return mp3LibScanning;
+}
+
+uint16_t mp3LibraryScanProgress() {
+  return mp3LibScanSeen;
+}
+
+// Copia il record in posizione index. false se fuori intervallo o errore di lettura.
+bool mp3LibraryGet(int index, MP3IndexEntry* out) {
+  if (mp3LibMutex == NULL || index < 0) return false;
+  bool ok = false;
+  xSemaphoreTake(mp3LibMutex, portMAX_DELAY);
+  if ((uint32_t)index < mp3LibCount && mp3LibFile) {
+    int32_t first = index - index % MP3_LIB_PAGE_ENTRIES;
+    int slot = -1, lru = 0;
+    for (int p = 0; p < MP3_LIB_PAGES; p++) {
+      if (mp3LibPageFirst[p] == first) { slot = p; break; }
+      if (mp3LibPageUse[p] < mp3LibPageUse[lru]) lru = p;
+    }
+    if (slot >= 0) {
+      mp3LibStats.pageHits++;
+    } else {
+      uint32_t n = mp3LibCount - first;
+      if (n > MP3_LIB_PAGE_ENTRIES) n = MP3_LIB_PAGE_ENTRIES;
+      size_t bytes = n * sizeof(MP3IndexEntry);
+      MP3IndexEntry* dst = mp3LibPages + lru * MP3_LIB_PAGE_ENTRIES;
+      if (mp3LibFile.seek(sizeof(MP3IndexHeader) + (uint32_t)first * sizeof(MP3IndexEntry)) &&
+          mp3LibFile.read((uint8_t*)dst, bytes) == bytes) {
+        mp3LibPageFirst[lru] = first;
+        slot = lru;
+      } else {
+        mp3LibPageFirst[lru] = -1;
+      }
+      mp3LibStats.pageMisses++;
+    }
+    if (slot >= 0) {
+      *out = mp3LibPages[slot * MP3_LIB_PAGE_ENTRIES + (index - first)];
+      mp3LibPageUse[slot] = ++mp3LibPageTick;
+      ok = true;
+    }
+  }
+  xSemaphoreGive(mp3LibMutex);
+  return ok;
+}
+
+// Posizione del file nell'indice corrente (-1 = assente). Scorre le pagine: uso occasionale.
+int mp3LibraryFind(const char* name) {
+  MP3IndexEntry e;
+  int count = mp3LibraryCount();
+  for (int i = 0; i < count; i++) {
+    if (!mp3LibraryGet(i, &e)) break;
+    if (strcmp(e.name, name) == 0) return i;
+  }
+  return -1;
+}
+
+uint64_t mp3LibraryTotalBytes() {
+  if (mp3LibMutex == NULL) return 0;
+  xSemaphoreTake(mp3LibMutex, portMAX_DELAY);
+  uint64_t total = mp3LibHeader.totalBytes;
+  xSemaphoreGive(mp3LibMutex);
+  return total;
+}
+
+// ===== Stato per /mp3player/library =====
+String getMP3LibraryStatsJSON() {
+  MP3IndexHeader h;
+  memset(&h, 0, sizeof(h));
+  if (mp3LibMutex != NULL) {
+    xSemaphoreTake(mp3LibMutex, portMAX_DELAY);
+    h = mp3LibHeader;
+    xSemaphoreGive(mp3LibMutex);
+  }
+  const MP3LibraryStats& s = mp3LibStats;
+  String json = "{";
+  json += "\"ready\":" + String(mp3LibMutex != NULL ? "true" : "false") + ",";
+  json += "\"tracks\":" + String(mp3LibraryCount()) + ",";
+  json += "\"generation\":" + String(mp3LibGen) + ",";
+  json += "\"scanning\":" + String(mp3LibScanning ? "true" : "false") + ",";
+  json += "\"scanSeen\":" + String(mp3LibScanSeen) + ",";
+  json += "\"totalSeconds\":" + String(h.totalSeconds) + ",";
+  json += "\"totalMB\":" + String((uint32_t)(h.totalBytes / (1024 * 1024))) + ",";
+  json += "\"indexBytes\":" + String((uint32_t)(sizeof(MP3IndexHeader) + h.count * sizeof(MP3IndexEntry))) + ",";
+  json += "\"cacheBytes\":" + String((uint32_t)(MP3_LIB_PAGES * MP3_LIB_PAGE_ENTRIES * sizeof(MP3IndexEntry))) + ",";
+  json += "\"warmLoadUs\":" + String(s.warmLoadUs) + ",";
+  json += "\"coldScanMs\":" + String(s.coldScanMs) + ",";
+  json += "\"coldScanFiles\":" + String(s.coldScanFiles) + ",";
+  json += "\"lastScanMs\":" + String(s.lastScanMs) + ",";
+  json += "\"lastParseMs\":" + String(s.lastParseMs) + ",";
+  json += "\"lastParsed\":" + String(s.lastParsed) + ",";
+  json += "\"lastReused\":" + String(s.lastReused) + ",";
+  json += "\"lastRemoved\":" + String(s.lastRemoved) + ",";
+  json += "\"lastSkipped\":" + String(s.lastSkipped) + ",";
+  json += "\"avgParseUs\":" + String(s.parsedTotal ? s.parseUsTotal / s.parsedTotal : 0) + ",";
+  json += "\"scans\":" + String(s.scans) + ",";
+  json += "\"writes\":" + String(s.writes) + ",";
+  json += "\"badFiles\":" + String(s.badFiles) + ",";
+  json += "\"pageHits\":" + String(s.pageHits) + ",";
+  json += "\"pageMisses\":" + String(s.pageMisses);
+  json += "}";
+  return json;
+}
+
+#endif // EFFECT_MP3_PLAYER
@@ -11,14 +11,12 @@
 void saveMP3PlayerSettings();
 void loadMP3PlayerSettings();
 
-// Flag globale per rescan playlist dopo upload (settato dal webserver, consumato dal polling)
-static volatile bool mp3NeedRescan = false;
-
 // ================== CONFIGURAZIONE MP3 PLAYER ==================
-#define MP3_FOLDER "/MP3"           // Cartella sulla SD dove cercare i file
-#define MP3_MAX_FILES 100           // Numero massimo di file MP3 gestibili
-#define MP3_TITLE_MAX_LEN 40        // Lunghezza massima del titolo visualizzato
+// MP3_FOLDER e AudioFileType in mp3_library_types.h (condivisi con l'indice 31_MP3_LIBRARY.ino)
 #define MP3_SCROLL_SPEED 150        // Velocità scroll titolo lungo (ms)
+#define MP3_WEB_PAGE_SIZE 50        // Brani per pagina nella pagina web (lettura a pagine dall'indice)
+#define MP3_WEB_PAGE_MAX  100       // Limite massimo richiesto per pagina
+#define MP3_DECODER_DELAY 529       // Campioni di ritardo della sintesi MP3 (si sommano a encDelay del tag LAME)
 
 // ================== LAYOUT DISPLAY 480x480 - TEMA MODERNO ==================
 // VU Meter sinistro: x=0, larghezza=48
@@ -97,26 +95,19 @@ static volatile bool mp3NeedRescan = false;
 #define MP3_VU_BG         0x18C3    // Grigio-blu VU background
 
 // ================== STRUTTURE DATI ==================
-enum AudioFileType {
-  AUDIO_TYPE_MP3,
-  AUDIO_TYPE_WAV
-};
-
-struct MP3File {
-  char filename[64];               // Nome file completo
-  char title[MP3_TITLE_MAX_LEN];   // Titolo estratto (senza estensione)
-  AudioFileType type;              // Tipo file (MP3 o WAV)
-};
-
 struct MP3PlayerState {
   bool initialized;                 // Player inizializzato
   bool playing;                     // In riproduzione
   bool paused;                      // In pausa
   bool playAll;                     // Modalita' riproduzione: false=singolo brano, true=tutti i brani
   bool trackEnded;                  // Flag: traccia appena terminata (per gestire passaggio automatico)
+  bool trackAdvanced;               // Flag: la traccia accodata e' subentrata senza pausa (gapless)
+  int queuedTrack;                  // Traccia accodata nella libreria Audio (-1 = nessuna)
+  char queuedName[MP3_INDEX_NAME_LEN]; // Nome della traccia accodata (l'indice puo' cambiare nel frattempo)
   int currentTrack;                 // Indice traccia corrente
-  int totalTracks;                  // Numero totale tracce
-  MP3File* tracks;                  // Array dinamico delle tracce
+  int totalTracks;                  // Numero totale tracce (record nell'indice libreria)
+  MP3IndexEntry track;              // Record della traccia corrente (copia dall'indice)
+  uint32_t libraryGen;              // Generazione dell'indice a cui si riferisce currentTrack
   uint8_t volume;                   // Volume (0-21)
   uint8_t vuLeft;                   // Livello VU sinistro (0-100)
   uint8_t vuRight;                  // Livello VU destro (0-100)
@@ -142,6 +133,7 @@ static int8_t prevActiveRight = -1;
 static int8_t prevPeakLeft = -1;
 static int8_t prevPeakRight = -1;
 static bool vuBackgroundDrawn = false;
+static bool mp3IndexingScreen = false;   // Schermata di prima indicizzazione gia' disegnata
 
 // Task audio separato rimosso: audioTask globale (audio.loop()) gestisce tutto
 
@@ -149,6 +141,7 @@ static bool vuBackgroundDrawn = false;
 // Chiamato dalla libreria Audio.h quando un file MP3 termina
 void audio_eof_mp3(const char *info) {
   Serial.printf("[AUDIO] EOF: %s\n", info);
+  frameGovKick();   // Fine traccia: il loop passa subito alla successiva
   if (mp3Player.playing) {
     mp3Player.trackEnded = true;  // Segnala che la traccia e' terminata
     mp3Player.playing = false;
@@ -158,6 +151,14 @@ void audio_eof_mp3(const char *info) {
   }
 }
 
+// Chiamato dalla libreria quando la traccia accodata con queueFS() subentra al frame successivo:
+// niente audio_eof_mp3, l'I2S non si ferma
+void audio_next_mp3(const char *info) {
+  Serial.printf("[AUDIO] Gapless: %s\n", info);
+  frameGovKick();
+  if (mp3Player.playing) mp3Player.trackAdvanced = true;
+}
+
 // ================== PROTOTIPI FUNZIONI ==================
 void initMP3Player();
 void updateMP3Player();
@@ -172,7 +173,7 @@ void drawMP3VolumeBar();
 void drawMP3ModeButton();
 void drawMP3ExitButton();
 bool handleMP3PlayerTouch(int16_t x, int16_t y);
-void scanMP3Files();
+void syncMP3Library();
 void playMP3Track(int index);
 void stopMP3Track();
 void pauseMP3Track();
@@ -192,7 +193,7 @@ bool isMP3Playing() {
 
 // ================== INIZIALIZZAZIONE ==================
 void initMP3Player() {
-  Serial.println("[MP3] Inizializzazione lettore MP3...");
+  if (!mp3IndexingScreen) Serial.println("[MP3] Inizializzazione lettore MP3...");
 
   // Reset stato
   mp3Player.initialized = false;
@@ -200,9 +201,13 @@ void initMP3Player() {
   mp3Player.paused = false;
   mp3Player.playAll = false;    // Default: singolo brano
   mp3Player.trackEnded = false;
+  mp3Player.trackAdvanced = false;
+  mp3Player.queuedTrack = -1;
+  mp3Player.queuedName[0] = '\0';
   mp3Player.currentTrack = 0;
   mp3Player.totalTracks = 0;
-  mp3Player.tracks = nullptr;
+  memset(&mp3Player.track, 0, sizeof(mp3Player.track));
+  mp3Player.libraryGen = 0;
   mp3Player.volume = 70;  // Volume default (0-100)
   mp3Player.vuLeft = 0;
   mp3Player.vuRight = 0;
@@ -231,8 +236,33 @@ void initMP3Player() {
     Serial.println("[MP3] Cartella /MP3 creata");
   }
 
-  // Scansiona file MP3
-  scanMP3Files();
+  // Brani dall'indice libreria (la scansione della cartella gira nel task di background)
+  mp3LibraryBegin();
+  syncMP3Library();
+
+  if (mp3Player.totalTracks == 0 && mp3LibraryScanning()) {
+    // Prima indicizzazione della SD: avanzamento a schermo senza bloccare il loop
+    static uint32_t lastIndexingDraw = 0;
+    if (!mp3IndexingScreen) {
+      gfx->fillScreen(MP3_BG_COLOR);
+      gfx->setTextColor(MP3_ACCENT_COLOR);
+      gfx->setFont(u8g2_font_helvB18_tr);
+      gfx->setCursor(95, 220);
+      gfx->print("INDICIZZAZIONE SD...");
+      mp3IndexingScreen = true;
+      lastIndexingDraw = 0;
+    }
+    if (millis() - lastIndexingDraw >= 500) {
+      lastIndexingDraw = millis();
+      gfx->fillRect(0, 240, 480, 40, MP3_BG_COLOR);
+      gfx->setTextColor(MP3_TEXT_DIM);
+      gfx->setFont(u8g2_font_helvR14_tr);
+      gfx->setCursor(150, 268);
+      gfx->printf("File letti: %u", mp3LibraryScanProgress());
+    }
+    return;
+  }
+  mp3IndexingScreen = false;
 
   if (mp3Player.totalTracks == 0) {
     Serial.println("[MP3] Nessun file MP3 trovato!");
@@ -266,65 +296,80 @@ void initMP3Player() {
   drawMP3PlayerUI();
 }
 
-// ================== SCANSIONE FILE MP3 ==================
-void scanMP3Files() {
-  // Libera memoria precedente
-  if (mp3Player.tracks != nullptr) {
-    free(mp3Player.tracks);
-    mp3Player.tracks = nullptr;
+// ================== ALLINEAMENTO ALL'INDICE LIBRERIA ==================
+// I brani stanno nell'indice su SD (31_MP3_LIBRARY.ino): in RAM resta solo il record della
+// traccia corrente. Dopo una riscansione le posizioni possono cambiare: la traccia corrente
+// viene ritrovata per nome.
+static bool loadMP3TrackEntry(int index) {
+  if (mp3LibraryGet(index, &mp3Player.track)) return true;
+  memset(&mp3Player.track, 0, sizeof(mp3Player.track));
+  return false;
+}
+
+void syncMP3Library() {
+  uint32_t gen = mp3LibraryGeneration();
+  if (gen == mp3Player.libraryGen && mp3Player.track.name[0]) return;
+
+  if (gen != mp3Player.libraryGen && mp3Player.track.name[0]) {
+    int index = mp3LibraryFind(mp3Player.track.name);
+    if (index >= 0) mp3Player.currentTrack = index;
+  }
+  mp3Player.libraryGen = gen;
+  mp3Player.totalTracks = mp3LibraryCount();
+  if (mp3Player.currentTrack < 0 || mp3Player.currentTrack >= mp3Player.totalTracks) {
+    mp3Player.currentTrack = 0;
   }
+  loadMP3TrackEntry(mp3Player.currentTrack);
+}
 
-  // Alloca memoria per l'array di file (usa PSRAM se disponibile)
-  mp3Player.tracks = (MP3File*)heap_caps_malloc(MP3_MAX_FILES * sizeof(MP3File), MALLOC_CAP_SPIRAM);
-  if (mp3Player.tracks == nullptr) {
-    // Fallback a RAM normale
-    mp3Player.tracks = (MP3File*)malloc(MP3_MAX_FILES * sizeof(MP3File));
-    if (mp3Player.tracks == nullptr) {
-      Serial.println("[MP3] ERRORE: Impossibile allocare memoria!");
-      return;
-    }
+// ================== CODA GAPLESS ==================
+// Parametri per connecttoFS()/queueFS() dal record dell'indice: l'MP3 parte dal primo frame audio
+// (ID3 e frame Xing/Info saltati); con il tag LAME si scartano ritardo encoder + ritardo decoder
+// all'inizio e il riempimento finale. WAV: header letto dalla libreria, solo i campioni del chunk data.
+static void mp3GaplessParams(const MP3IndexEntry& e, uint32_t* startPos, uint32_t* skip, uint32_t* total) {
+  *startPos = 0;
+  *skip = 0;
+  *total = 0;
+  if (e.type == AUDIO_TYPE_WAV) {
+    *total = e.samples;
+    return;
+  }
+  *startPos = e.audioStart;
+  if (e.flags & MP3_IDX_LAME) {
+    *skip = e.encDelay + MP3_DECODER_DELAY;
+    *total = e.samples;
   }
+}
 
-  mp3Player.totalTracks = 0;
+// Accoda nella libreria Audio la traccia successiva (modalita' TUTTI): viene aperta e letta in
+// anticipo negli ultimi secondi di quella corrente e subentra senza fermare l'I2S
+static void queueNextMP3Track() {
+  #ifdef AUDIO
+  extern Audio audio;
+  mp3Player.queuedTrack = -1;
+  mp3Player.queuedName[0] = '\0';
+  if (!mp3Player.playing || !mp3Player.playAll || mp3Player.totalTracks == 0) {
+    audio.clearQueue();
+    return;
+  }
 
-  File root = SD.open(MP3_FOLDER);
-  if (!root) {
-    Serial.println("[MP3] ERRORE: Impossibile aprire cartella /MP3");
+  int next = (mp3Player.currentTrack + 1) % mp3Player.totalTracks;
+  MP3IndexEntry entry;
+  if (!mp3LibraryGet(next, &entry) || (entry.flags & MP3_IDX_BAD)) {
+    audio.clearQueue();   // Passaggio classico da audio_eof_mp3
     return;
   }
 
-  File file = root.openNextFile();
-  while (file && mp3Player.totalTracks < MP3_MAX_FILES) {
-    if (!file.isDirectory()) {
-      String filename = String(file.name());
-      filename.toLowerCase();
-
-      // Controlla se e' un file audio supportato
-      bool isMP3 = filename.endsWith(".mp3");
-      bool isWAV = filename.endsWith(".wav");
-
-      if (isMP3 || isWAV) {
-        // Copia nome file
-        strncpy(mp3Player.tracks[mp3Player.totalTracks].filename, file.name(), 63);
-        mp3Player.tracks[mp3Player.totalTracks].filename[63] = '\0';
-
-        // Imposta tipo file
-        mp3Player.tracks[mp3Player.totalTracks].type = isWAV ? AUDIO_TYPE_WAV : AUDIO_TYPE_MP3;
-
-        // Estrai titolo (rimuovi estensione)
-        String title = extractTitle(file.name());
-        strncpy(mp3Player.tracks[mp3Player.totalTracks].title, title.c_str(), MP3_TITLE_MAX_LEN - 1);
-        mp3Player.tracks[mp3Player.totalTracks].title[MP3_TITLE_MAX_LEN - 1] = '\0';
-
-        const char* typeStr = isWAV ? "WAV" : "MP3";
-        Serial.printf("[AUDIO] %d: %s [%s]\n", mp3Player.totalTracks + 1,
-                      mp3Player.tracks[mp3Player.totalTracks].title, typeStr);
-        mp3Player.totalTracks++;
-      }
-    }
-    file = root.openNextFile();
+  uint32_t startPos, skip, total;
+  mp3GaplessParams(entry, &startPos, &skip, &total);
+  String fullPath = String(MP3_FOLDER) + "/" + String(entry.name);
+  if (!audio.queueFS(SD, fullPath.c_str(), startPos, skip, total)) {
+    audio.clearQueue();
+    return;
   }
-  root.close();
+  mp3Player.queuedTrack = next;
+  memcpy(mp3Player.queuedName, entry.name, sizeof(mp3Player.queuedName));
+  #endif
 }
 
 // ================== ESTRAI TITOLO DA FILENAME ==================
@@ -472,7 +517,7 @@ void drawMP3Preview() {
     // Tipo file (MP3/WAV)
     gfx->setFont(u8g2_font_helvR10_tr);
     gfx->setTextColor(MP3_ACCENT_DARK);
-    const char* typeStr = (mp3Player.tracks[mp3Player.currentTrack].type == AUDIO_TYPE_WAV) ? "WAV" : "MP3";
+    const char* typeStr = (mp3Player.track.type == AUDIO_TYPE_WAV) ? "WAV" : "MP3";
     gfx->setCursor(PREVIEW_X + PREVIEW_W - 45, PREVIEW_Y + 22);
     gfx->print(typeStr);
 
@@ -494,7 +539,7 @@ void drawMP3Preview() {
     gfx->setFont(u8g2_font_helvB18_tr);
     gfx->setTextColor(MP3_TEXT_COLOR);
 
-    String title = String(mp3Player.tracks[mp3Player.currentTrack].title);
+    String title = String(mp3Player.track.title);
     int textWidth = title.length() * 11;
     int maxWidth = PREVIEW_W - 80;
 
@@ -850,12 +895,14 @@ void drawMP3ProgressBar() {
   #ifdef AUDIO
   extern Audio audio;
 
+  // Durata dall'indice libreria: esatta anche per i VBR (header Xing/VBRI), visibile
+  // anche da fermo. La stima del decoder resta il ripiego per i record senza durata.
   uint32_t currentTime = 0;
-  uint32_t duration = 0;
+  uint32_t duration = mp3Player.track.durationMs / 1000;
 
   if (mp3Player.playing || mp3Player.paused) {
     currentTime = audio.getAudioCurrentTime();
-    duration = audio.getAudioFileDuration();
+    if (duration == 0) duration = audio.getAudioFileDuration();
   }
 
   // Formato MM:SS
@@ -1042,6 +1089,7 @@ bool handleMP3PlayerTouch(int16_t x, int16_t y) {
       // Toggle modalita'
       mp3Player.playAll = !mp3Player.playAll;
       Serial.printf("[MP3] Modalita' cambiata: %s\n", mp3Player.playAll ? "TUTTI I BRANI" : "SINGOLO BRANO");
+      if (mp3Player.playing) queueNextMP3Track();
       //saveMP3PlayerSettings();
       mp3Player.needsRedraw = true;
       return false;
@@ -1082,30 +1130,42 @@ void playMP3Track(int index) {
     delay(50);
   }
 
+  MP3IndexEntry entry;
+  if (!mp3LibraryGet(index, &entry)) {
+    Serial.println("[MP3] ERRORE: lettura indice libreria");
+    return;
+  }
+
   // Ferma eventuale riproduzione
   stopMP3Track();
   mp3Player.currentTrack = index;
+  mp3Player.track = entry;
 
-  String fullPath = String(MP3_FOLDER) + "/" + String(mp3Player.tracks[index].filename);
+  String fullPath = String(MP3_FOLDER) + "/" + String(entry.name);
   Serial.printf("[MP3] Riproduzione: %s (volume: %d)\n", fullPath.c_str(), mp3Player.volume);
 
   if (!SD.exists(fullPath)) {
     Serial.println("[MP3] ERRORE: File non trovato!");
+    mp3LibraryRequestScan();   // Rimosso fuori dal webserver: l'indice va aggiornato
     return;
   }
 
   // Imposta volume MP3 Player (converte 0-100 a 0-21)
   audio.setVolume(map(mp3Player.volume, 0, 100, 0, 21));
 
-  // Usa audio.connecttoFS con SD
-  if (!audio.connecttoFS(SD, fullPath.c_str())) {
+  // Usa audio.connecttoFS con SD (primo frame e rifilatura gapless dall'indice)
+  uint32_t startPos, skip, total;
+  mp3GaplessParams(entry, &startPos, &skip, &total);
+  if (!audio.connecttoFS(SD, fullPath.c_str(), startPos, skip, total)) {
     Serial.println("[MP3] Errore connessione file!");
     return;
   }
 
   mp3Player.playing = true;
   mp3Player.paused = false;
+  mp3Player.trackAdvanced = false;
   isPlaying = true;
+  queueNextMP3Track();
   //saveMP3PlayerSettings();
   mp3Player.needsRedraw = true;
   #endif
@@ -1174,6 +1234,7 @@ void nextMP3Track() {
     playMP3Track(nextIndex);
   } else {
     mp3Player.currentTrack = nextIndex;
+    loadMP3TrackEntry(nextIndex);
     mp3Player.needsRedraw = true;
   }
 
@@ -1190,6 +1251,7 @@ void prevMP3Track() {
     playMP3Track(prevIndex);
   } else {
     mp3Player.currentTrack = prevIndex;
+    loadMP3TrackEntry(prevIndex);
     mp3Player.needsRedraw = true;
   }
 
@@ -1286,6 +1348,18 @@ void updateMP3Player() {
     return;
   }
 
+  // Indice sostituito dal task di scansione (upload, eliminazione, verifica all'avvio)
+  if (mp3LibraryGeneration() != mp3Player.libraryGen) {
+    syncMP3Library();
+    mp3Player.scrollOffset = 0;
+    mp3Player.needsRedraw = true;
+    if (mp3Player.totalTracks == 0) {
+      mp3Player.initialized = false;   // initMP3Player mostra il messaggio "nessun file"
+      return;
+    }
+    if (mp3Player.playing) queueNextMP3Track();   // Gli indici sono cambiati
+  }
+
   uint32_t now = millis();
 
   // 1. GESTIONE SCROLL (Deve essere fuori dai blocchi if playing/paused)
@@ -1293,7 +1367,7 @@ void updateMP3Player() {
   static uint32_t lastScrollTime = 0;
   if (now - lastScrollTime >= 500) { 
     if (mp3Player.totalTracks > 0) {
-      String title = String(mp3Player.tracks[mp3Player.currentTrack].title);
+      String title = String(mp3Player.track.title);
       // Se il titolo è lungo, sposta l'offset e ridisegna la preview
       if (title.length() > 20) {
         mp3Player.scrollOffset++;
@@ -1309,6 +1383,19 @@ void updateMP3Player() {
   // 2. GESTIONE AUDIO (EOF e Track Ended)
   #ifdef AUDIO
   extern Audio audio;
+  if (mp3Player.trackAdvanced) {
+    mp3Player.trackAdvanced = false;
+    int index = mp3LibraryFind(mp3Player.queuedName);
+    if (index < 0) index = mp3Player.queuedTrack;
+    if (index >= 0 && index < mp3Player.totalTracks) {
+      mp3Player.currentTrack = index;
+      loadMP3TrackEntry(index);
+    }
+    Serial.printf("[MP3] Traccia %d senza pausa: %s\n", mp3Player.currentTrack, mp3Player.track.name);
+    mp3Player.scrollOffset = 0;
+    mp3Player.needsRedraw = true;
+    queueNextMP3Track();
+  }
   if (mp3Player.trackEnded) {
     mp3Player.trackEnded = false;
     if (mp3Player.playAll) {
@@ -1396,14 +1483,11 @@ void drawMP3StatusAnim() {
 void cleanupMP3Player() {
   stopMP3Track();
 
-  if (mp3Player.tracks != nullptr) {
-    heap_caps_free(mp3Player.tracks);
-    mp3Player.tracks = nullptr;
-  }
-
+  // L'indice resta su SD: al prossimo ingresso si rilegge solo il record corrente
   mp3Player.initialized = false;
   mp3PlayerInitialized = false;
   mp3Player.totalTracks = 0;
+  mp3Player.libraryGen = 0;
 
   Serial.println("[MP3] Lettore MP3 chiuso");
 }
@@ -1430,6 +1514,10 @@ body{font-family:Arial,sans-serif;background:#1a1a2e;min-height:100vh;padding:20
 .track.active{background:rgba(156,39,176,.5);border:2px solid #ce93d8}
 .track .name{flex:1}
 .track .type{font-size:0.8em;opacity:0.7;padding:2px 8px;background:rgba(255,255,255,.1);border-radius:4px}
+.track .meta{font-size:.8em;opacity:.6;margin:0 10px;white-space:nowrap}
+.pager{display:flex;justify-content:center;align-items:center;gap:12px;margin-top:10px;font-size:.9em}
+.pager button{background:rgba(255,255,255,.1);color:#fff;border:none;border-radius:6px;padding:6px 14px;cursor:pointer}
+.pager button:disabled{opacity:.3;cursor:default}
 .controls{display:flex;justify-content:center;gap:15px;margin:20px 0}
 .btn{width:60px;height:60px;border-radius:50%;border:none;cursor:pointer;font-size:1.5em;display:flex;align-items:center;justify-content:center;transition:all 0.3s}
 .btn-prev,.btn-next{background:rgba(255,255,255,.1);color:#fff}
@@ -1494,7 +1582,9 @@ body{font-family:Arial,sans-serif;background:#1a1a2e;min-height:100vh;padding:20
 <div class="playmode-btn" id="modeAll" onclick="setMode(true)">🔁 Tutti</div>
 </div>
 <div class="s"><h3>Playlist</h3>
+<div class="sd-info"><span id="libInfo"></span><span id="libStats"></span></div>
 <div id="playlist"></div>
+<div class="pager" id="trackPager"></div>
 </div>
 <div class="s"><h3>📂 Gestione File SD</h3>
 <div class="sd-info"><span id="sdInfo">Caricamento...</span><span id="sdCount"></span></div>
@@ -1509,10 +1599,21 @@ body{font-family:Arial,sans-serif;background:#1a1a2e;min-height:100vh;padding:20
 <div class="prog-text" id="progText">Caricamento...</div>
 </div>
 <div id="fileList"></div>
+<div class="pager" id="filePager"></div>
 </div>
 <button class="mode-btn" onclick="activateMode()">Mostra su Display</button>
 </div></div><script>
-var cfg={playing:false,paused:false,current:-1,playAll:false,volume:70,tracks:[]};
+var cfg={playing:false,paused:false,current:-1,playAll:false,volume:70,total:0};
+var PAGE=50,tPage=0,fPage=0,libGen=-1,trackData=null;
+function esc(s){return String(s).replace(/&/g,'&amp;').replace(/</g,'&lt;').replace(/>/g,'&gt;').replace(/"/g,'&quot;');}
+function fmtDur(s){s=s||0;var h=Math.floor(s/3600),m=Math.floor(s/60)%60,x=s%60;return(h?h+':'+(m<10?'0':''):'')+m+':'+(x<10?'0':'')+x;}
+function pager(id,page,total,fn){
+  var pages=Math.ceil(total/PAGE),el=document.getElementById(id);
+  if(pages<=1){el.innerHTML='';return;}
+  el.innerHTML='<button '+(page<=0?'disabled ':'')+'onclick="'+fn+'('+(page-1)+')">&lsaquo;</button>'+
+    '<span>Pagina '+(page+1)+' / '+pages+'</span>'+
+    '<button '+(page>=pages-1?'disabled ':'')+'onclick="'+fn+'('+(page+1)+')">&rsaquo;</button>';
+}
 function cmd(c,idx){
   var url='/mp3player/cmd?action='+c;
   if(typeof idx!=='undefined')url+='&track='+idx;
@@ -1529,7 +1630,7 @@ function setVolume(){
 }
 function update(d){
   cfg.playing=d.playing;cfg.paused=d.paused;cfg.current=d.current;cfg.playAll=d.playAll;
-  cfg.volume=d.volume||70;cfg.tracks=d.tracks||[];
+  cfg.volume=d.volume||70;cfg.total=d.total||0;
   document.getElementById('playBtn').innerHTML=cfg.playing&&!cfg.paused?'⏸':'▶';
   document.getElementById('playBtn').className='btn btn-play'+(cfg.playing&&!cfg.paused?' playing':'');
   var stateText=cfg.playing?(cfg.paused?'In pausa':'In riproduzione'):'Fermo';
@@ -1539,20 +1640,43 @@ function update(d){
   document.getElementById('modeAll').className='playmode-btn'+(cfg.playAll?' active':'');
   document.getElementById('volume').value=cfg.volume;
   document.getElementById('volVal').textContent=cfg.volume+'%';
-  if(cfg.tracks.length>0){
-    document.getElementById('nowPlaying').textContent=cfg.current>=0?cfg.tracks[cfg.current].title:'Seleziona un brano';
-    var html='';
-    for(var i=0;i<cfg.tracks.length;i++){
-      html+='<div class="track'+(i==cfg.current?' active':'')+'" onclick="cmd(\'play\','+i+')">';
-      html+='<span class="name">'+(i+1)+'. '+cfg.tracks[i].title+'</span>';
-      html+='<span class="type">'+cfg.tracks[i].type+'</span></div>';
-    }
-    document.getElementById('playlist').innerHTML=html;
-  }else{
+  document.getElementById('nowPlaying').textContent=cfg.total>0?(d.title?d.title+(d.artist?' - '+d.artist:''):'Seleziona un brano'):'Nessun brano';
+  document.getElementById('libInfo').textContent=d.scanning?'Indicizzazione in corso...':cfg.total+' brani';
+  // Indice libreria sostituito (upload, eliminazione, verifica): ricarica le pagine
+  if(d.libGen!==libGen){libGen=d.libGen;loadTracks();loadFiles();}
+  else renderTracks();
+  updateVU(d.vuL||0,d.vuR||0);
+}
+function loadTracks(){
+  fetch('/mp3player/tracks?offset='+(tPage*PAGE)+'&limit='+PAGE).then(r=>r.json()).then(d=>{
+    trackData=d;tPage=Math.floor(d.offset/PAGE);renderTracks();
+  }).catch(()=>{});
+  fetch('/mp3player/library').then(r=>r.json()).then(s=>{
+    var t='Durata '+fmtDur(s.totalSeconds);
+    if(s.coldScanMs)t+=' | scansione completa '+(s.coldScanMs/1000).toFixed(1)+' s ('+s.coldScanFiles+' file)';
+    t+=' | indice '+(s.warmLoadUs/1000).toFixed(1)+' ms';
+    document.getElementById('libStats').textContent=t;
+  }).catch(()=>{});
+}
+function renderTracks(){
+  var d=trackData;
+  if(!d||d.total===0){
     document.getElementById('playlist').innerHTML='<div class="empty">Nessun file MP3/WAV trovato nella cartella /MP3</div>';
+    document.getElementById('trackPager').innerHTML='';return;
   }
-  updateVU(d.vuL||0,d.vuR||0);
+  var html='';
+  for(var k=0;k<d.tracks.length;k++){
+    var t=d.tracks[k];
+    html+='<div class="track'+(t.i==cfg.current?' active':'')+'" onclick="cmd(\'play\','+t.i+')">';
+    html+='<span class="name">'+(t.i+1)+'. '+esc(t.title)+(t.artist?' <small style="opacity:.7">'+esc(t.artist)+'</small>':'')+'</span>';
+    html+='<span class="meta">'+fmtDur(t.dur)+(t.kbps?' '+t.kbps+(t.vbr?' VBR':' kbps'):'')+'</span>';
+    html+='<span class="type">'+t.type+'</span></div>';
+  }
+  document.getElementById('playlist').innerHTML=html;
+  pager('trackPager',tPage,d.total,'goTracks');
 }
+function goTracks(p){tPage=p;loadTracks();}
+function goFiles(p){fPage=p;loadFiles();}
 function updateVU(l,r){
   var vu=document.getElementById('vuMeter');
   var html='';
@@ -1572,18 +1696,20 @@ dz.addEventListener('dragleave',function(){dz.classList.remove('drag');});
 dz.addEventListener('drop',function(e){e.preventDefault();dz.classList.remove('drag');uploadFiles(e.dataTransfer.files);});
 function fmtSize(b){if(b<1024)return b+' B';if(b<1048576)return(b/1024).toFixed(1)+' KB';return(b/1048576).toFixed(1)+' MB';}
 function loadFiles(){
-  fetch('/mp3player/files').then(r=>r.json()).then(d=>{
+  fetch('/mp3player/files?offset='+(fPage*PAGE)+'&limit='+PAGE).then(r=>r.json()).then(d=>{
+    fPage=Math.floor(d.offset/PAGE);
     document.getElementById('sdInfo').textContent='SD: '+d.total+' file, '+fmtSize(d.usedBytes);
     document.getElementById('sdCount').textContent=fmtSize(d.freeBytes)+' liberi';
     var h='';
     if(d.files.length===0){h='<div class="empty">Nessun file nella cartella /MP3</div>';}
     else{for(var i=0;i<d.files.length;i++){
       var f=d.files[i];
-      h+='<div class="frow"><span class="fname">'+f.name+'</span>';
+      h+='<div class="frow"><span class="fname">'+esc(f.name)+'</span>';
       h+='<span class="fsize">'+fmtSize(f.size)+'</span>';
       h+='<button class="fdel" onclick="delFile(\''+f.name.replace(/'/g,"\\'")+'\')">Elimina</button></div>';
     }}
     document.getElementById('fileList').innerHTML=h;
+    pager('filePager',fPage,d.total,'goFiles');
   }).catch(()=>{document.getElementById('sdInfo').textContent='Errore lettura SD';});
 }
 function uploadFiles(files){
@@ -1622,7 +1748,6 @@ function delFile(name){
     if(d.success){loadFiles();poll();}else{alert('Errore: '+d.error);}
   });
 }
-loadFiles();
 </script></body></html>
 )rawliteral";
 
@@ -1637,18 +1762,33 @@ String getMP3PlayerStatusJSON() {
   json += "\"volume\":" + String(mp3Player.volume) + ",";
   json += "\"vuL\":" + String(mp3Player.vuLeft) + ",";
   json += "\"vuR\":" + String(mp3Player.vuRight) + ",";
-  json += "\"tracks\":[";
-
-  for (int i = 0; i < mp3Player.totalTracks && i < 50; i++) {
-    if (i > 0) json += ",";
-    json += "{\"title\":\"" + String(mp3Player.tracks[i].title) + "\",";
-    json += "\"type\":\"" + String(mp3Player.tracks[i].type == AUDIO_TYPE_WAV ? "WAV" : "MP3") + "\"}";
-  }
-
-  json += "]}";
+  // Traccia corrente; l'elenco si legge a pagine da /mp3player/tracks
+  json += "\"title\":\"" + jsonEscape(String(mp3Player.track.title)) + "\",";
+  json += "\"artist\":\"" + jsonEscape(String(mp3Player.track.artist)) + "\",";
+  json += "\"type\":\"" + String(mp3Player.track.type == AUDIO_TYPE_WAV ? "WAV" : "MP3") + "\",";
+  json += "\"duration\":" + String(mp3Player.track.durationMs / 1000) + ",";
+  json += "\"libGen\":" + String(mp3LibraryGeneration()) + ",";
+  json += "\"scanning\":" + String(mp3LibraryScanning() ? "true" : "false");
+  #ifdef AUDIO
+  // Ultimo passaggio gapless: campioni di silenzio stimati e tempo di commutazione
+  extern Audio audio;
+  json += ",\"queued\":" + String(mp3Player.queuedTrack);
+  json += ",\"gapSamples\":" + String(audio.getGapSamples());
+  json += ",\"switchUs\":" + String(audio.getSwitchTime());
+  #endif
+  json += "}";
   return json;
 }
 
+// Parametri offset/limit delle liste a pagine (offset oltre la fine: ultima pagina)
+static void mp3WebPageParams(AsyncWebServerRequest *request, int total, int &offset, int &limit) {
+  offset = request->hasParam("offset") ? request->getParam("offset")->value().toInt() : 0;
+  limit = request->hasParam("limit") ? request->getParam("limit")->value().toInt() : MP3_WEB_PAGE_SIZE;
+  limit = constrain(limit, 1, MP3_WEB_PAGE_MAX);
+  if (offset >= total) offset = (total > 0) ? ((total - 1) / limit) * limit : 0;
+  if (offset < 0) offset = 0;
+}
+
 // ================== SALVATAGGIO/CARICAMENTO IMPOSTAZIONI MP3 ==================
 // Salva impostazioni MP3 Player in EEPROM
 void saveMP3PlayerSettings() {
@@ -1656,7 +1796,7 @@ void saveMP3PlayerSettings() {
   EEPROM.write(EEPROM_MP3PLAYER_PLAYING_ADDR, mp3Player.playing ? 1 : 0);
   EEPROM.write(EEPROM_MP3PLAYER_VOLUME_ADDR, mp3Player.volume);
   EEPROM.write(EEPROM_MP3PLAYER_PLAYALL_ADDR, mp3Player.playAll ? 1 : 0);
-  EEPROM.commit();
+  settingsCommit();
   Serial.printf("[MP3] Impostazioni salvate: track=%d, playing=%d, volume=%d, playAll=%d\n",
                 mp3Player.currentTrack, mp3Player.playing, mp3Player.volume, mp3Player.playAll);
 }
@@ -1680,6 +1820,7 @@ void loadMP3PlayerSettings() {
   // Applica solo traccia salvata (se valida), ma NON avviare riproduzione
   if (mp3Player.initialized && savedTrack < mp3Player.totalTracks) {
     mp3Player.currentTrack = savedTrack;
+    loadMP3TrackEntry(savedTrack);
     Serial.printf("[MP3] Traccia ripristinata: %d (non avviata)\n", savedTrack);
   }
 
@@ -1698,16 +1839,9 @@ void setup_mp3player_webserver(AsyncWebServer* server) {
 
   // API stato player
   server->on("/mp3player/status", HTTP_GET, [](AsyncWebServerRequest *request){
-    // Se non inizializzato, scansiona prima i file
-    if (!mp3Player.initialized && mp3Player.totalTracks == 0) {
-      scanMP3Files();
-    }
-    // Rescan dopo upload/delete (schedulato dal callback, eseguito qui nel contesto sicuro)
-    if (mp3NeedRescan) {
-      mp3NeedRescan = false;
-      scanMP3Files();
-      if (currentMode == MODE_MP3_PLAYER) mp3Player.needsRedraw = true;
-      Serial.printf("[MP3] Playlist aggiornata dopo upload/delete: %d tracce\n", mp3Player.totalTracks);
+    // Con la modalita' a schermo il riallineamento all'indice lo fa updateMP3Player()
+    if (currentMode != MODE_MP3_PLAYER || !mp3Player.initialized) {
+      syncMP3Library();
     }
     request->send(200, "application/json", getMP3PlayerStatusJSON());
   });
@@ -1719,7 +1853,7 @@ void setup_mp3player_webserver(AsyncWebServer* server) {
 
       // Se non inizializzato, inizializza prima
       if (!mp3Player.initialized) {
-        scanMP3Files();
+        syncMP3Library();
         mp3Player.initialized = true;
       }
 
@@ -1765,41 +1899,62 @@ void setup_mp3player_webserver(AsyncWebServer* server) {
       else if (action == "setmode" && request->hasParam("playall")) {
         int mode = request->getParam("playall")->value().toInt();
         mp3Player.playAll = (mode == 1);
+        if (mp3Player.playing) queueNextMP3Track();
         saveMP3PlayerSettings();
         if (currentMode == MODE_MP3_PLAYER) mp3Player.needsRedraw = true;
         Serial.printf("[MP3-WEB] Modalita' cambiata: %s\n", mp3Player.playAll ? "TUTTI" : "SINGOLO");
       }
+      else if (action == "rescan") {
+        mp3LibraryRequestScan();
+        Serial.println("[MP3-WEB] Riscansione libreria richiesta");
+      }
     }
     request->send(200, "application/json", getMP3PlayerStatusJSON());
   });
 
-  // API lista file sulla SD (/MP3)
+  // API elenco brani a pagine dall'indice libreria
+  server->on("/mp3player/tracks", HTTP_GET, [](AsyncWebServerRequest *request){
+    int total = mp3LibraryCount();
+    int offset, limit;
+    mp3WebPageParams(request, total, offset, limit);
+    String json = "{\"total\":" + String(total) + ",\"offset\":" + String(offset);
+    json += ",\"gen\":" + String(mp3LibraryGeneration()) + ",\"tracks\":[";
+    MP3IndexEntry e;
+    for (int i = offset; i < total && i < offset + limit; i++) {
+      if (!mp3LibraryGet(i, &e)) break;
+      if (i > offset) json += ",";
+      json += "{\"i\":" + String(i);
+      json += ",\"title\":\"" + jsonEscape(String(e.title)) + "\"";
+      json += ",\"artist\":\"" + jsonEscape(String(e.artist)) + "\"";
+      json += ",\"type\":\"" + String(e.type == AUDIO_TYPE_WAV ? "WAV" : "MP3") + "\"";
+      json += ",\"dur\":" + String(e.durationMs / 1000);
+      json += ",\"kbps\":" + String(e.bitrateKbps);
+      json += ",\"vbr\":" + String((e.flags & MP3_IDX_VBR) ? "true" : "false") + "}";
+    }
+    json += "]}";
+    request->send(200, "application/json", json);
+  });
+
+  // API statistiche indice libreria (tempi scansione a freddo / caricamento a caldo)
+  server->on("/mp3player/library", HTTP_GET, [](AsyncWebServerRequest *request){
+    request->send(200, "application/json", getMP3LibraryStatsJSON());
+  });
+
+  // API lista file sulla SD (/MP3) a pagine dall'indice: nessuna scansione della cartella
   server->on("/mp3player/files", HTTP_GET, [](AsyncWebServerRequest *request){
+    int total = mp3LibraryCount();
+    int offset, limit;
+    mp3WebPageParams(request, total, offset, limit);
     String json = "{\"files\":[";
-    File dir = SD.open(MP3_FOLDER);
-    int count = 0;
-    size_t usedBytes = 0;
-    if (dir && dir.isDirectory()) {
-      File f = dir.openNextFile();
-      while (f) {
-        if (!f.isDirectory()) {
-          String name = String(f.name());
-          String lower = name;
-          lower.toLowerCase();
-          if (lower.endsWith(".mp3") || lower.endsWith(".wav")) {
-            if (count > 0) json += ",";
-            size_t sz = f.size();
-            usedBytes += sz;
-            json += "{\"name\":\"" + name + "\",\"size\":" + String(sz) + "}";
-            count++;
-          }
-        }
-        f = dir.openNextFile();
-      }
-      dir.close();
+    MP3IndexEntry e;
+    for (int i = offset; i < total && i < offset + limit; i++) {
+      if (!mp3LibraryGet(i, &e)) break;
+      if (i > offset) json += ",";
+      json += "{\"name\":\"" + jsonEscape(String(e.name)) + "\",\"size\":" + String(e.size) + "}";
     }
-    json += "],\"total\":" + String(count);
-    json += ",\"usedBytes\":" + String(usedBytes);
+    json += "],\"total\":" + String(total);
+    json += ",\"offset\":" + String(offset);
+    json += ",\"usedBytes\":" + String((uint32_t)mp3LibraryTotalBytes());
     uint64_t totalSD = SD.totalBytes();
     uint64_t usedSD = SD.usedBytes();
     json += ",\"freeBytes\":" + String((uint32_t)(totalSD - usedSD));
@@ -1819,8 +1974,8 @@ void setup_mp3player_webserver(AsyncWebServer* server) {
       } else {
         resp = "{\"success\":false,\"error\":\"Upload fallito\"}";
       }
-      // Schedula rescan nel loop (non qui nel callback)
-      mp3NeedRescan = true;
+      // Riscansione incrementale nel task della libreria (analizza solo il file nuovo)
+      mp3LibraryRequestScan();
       request->send(200, "application/json", resp);
     },
     [](AsyncWebServerRequest *request, String filename, size_t index, uint8_t *data, size_t len, bool final){
@@ -1890,7 +2045,7 @@ void setup_mp3player_webserver(AsyncWebServer* server) {
           mp3LastUploaded = "";
         }
         uploadValid = false;
-        // NON fare scanMP3Files() qui - schedulata nel response handler via mp3NeedRescan
+        // Riscansione richiesta nel response handler (mp3LibraryRequestScan)
       }
     }
   );
@@ -1909,8 +2064,8 @@ void setup_mp3player_webserver(AsyncWebServer* server) {
     }
     // Ferma audio se il file in riproduzione viene eliminato
     #ifdef AUDIO
-    if (mp3Player.playing && mp3Player.currentTrack >= 0 && mp3Player.currentTrack < mp3Player.totalTracks) {
-      String currentFile = String(mp3Player.tracks[mp3Player.currentTrack].filename);
+    if (mp3Player.playing) {
+      String currentFile = String(mp3Player.track.name);
       if (currentFile == filename) {
         extern Audio audio;
         audio.stopSong();
@@ -1921,8 +2076,8 @@ void setup_mp3player_webserver(AsyncWebServer* server) {
     #endif
     if (SD.remove(path.c_str())) {
       Serial.printf("[MP3-DELETE] Eliminato: %s\n", path.c_str());
-      // Schedula rescan nel prossimo polling (non qui)
-      mp3NeedRescan = true;
+      // L'indice viene aggiornato dal task della libreria
+      mp3LibraryRequestScan();
       request->send(200, "application/json", "{\"success\":true}");
     } else {
       request->send(500, "application/json", "{\"success\":false,\"error\":\"Errore eliminazione\"}");
@@ -311,14 +311,16 @@ void drawWebRadioStatus() {
     // Puliamo l'area delle barre per l'animazione
     gfx->fillRect(centerX + 105, y, 40, 30, WR_BG_COLOR); 
     
+    // In buffering (avvio, underrun o riconnessione) le barre restano basse e grigie
+    bool buffering = audio.getStreamHealth().buffering;
     for (int i = 0; i < 3; i++) {
       // Calcolo altezza dinamica (sinusoide sfasata per ogni barra)
       float barPhase = phase * 2.0 * PI + (i * 1.5);
-      int barH = 6 + (int)(12 * (0.5 + 0.5 * sin(barPhase)));
+      int barH = buffering ? 6 : 6 + (int)(12 * (0.5 + 0.5 * sin(barPhase)));
       
       int barX = centerX + 110 + (i * 10);
       // Y portata a y + 14 per allinearla alla parte alta/media del testo
-      gfx->fillRoundRect(barX, y + 14 - barH / 2, 5, barH, 2, WR_STATUS_ON);
+      gfx->fillRoundRect(barX, y + 14 - barH / 2, 5, barH, 2, buffering ? WR_TEXT_MUTED : WR_STATUS_ON);
     }
   } else {
     // --- SINISTRA: LED ROSSO ---
@@ -933,6 +935,7 @@ body{font-family:Arial,sans-serif;background:#1a1a2e;min-height:100vh;padding:20
 <div class="status off" id="statusBox">
 <div class="now-playing" id="nowPlaying">Radio spenta</div>
 <div class="station-url" id="stationUrl"></div>
+<div class="station-url" id="health"></div>
 </div>
 <button class="power-btn off" id="powerBtn" onclick="toggleRadio()">
 <span class="power-icon">📻</span>
@@ -1046,6 +1049,10 @@ function load(){
     cfg.name=d.name;cfg.url=d.url;cfg.stations=d.stations||[];
     render();
     updateVU(d.vuL||0,d.vuR||0);
+    var h=d.health,he=document.getElementById('health');
+    he.textContent=(cfg.enabled&&h)?((h.buffering?'Buffering':'Buffer')+' '+Math.round(h.fill*100/Math.max(1,h.size))+'% · '+
+      Math.round(h.arrival/1000)+'/'+Math.round(h.bitrate/1000)+' kbps · jitter '+h.jitter+' ms · underrun '+h.underruns+
+      ' · riconnessioni '+h.reconnects):'';
   }).catch(()=>{});
 }
 load();setInterval(load,2000);
@@ -1062,9 +1069,10 @@ void setup_webradio_webserver(AsyncWebServer* server) {
   server->on("/webradio/status", HTTP_GET, [](AsyncWebServerRequest* request) {
     char jsonBuf[2048];
     int pos = 0;
+    Audio::streamHealth_t h = audio.getStreamHealth();
 
     pos += snprintf(jsonBuf + pos, sizeof(jsonBuf) - pos,
-      "{\"enabled\":%s,\"station\":%d,\"volume\":%d,\"name\":\"%s\",\"url\":\"%s\",\"vuL\":%d,\"vuR\":%d,\"stations\":[",
+      "{\"enabled\":%s,\"station\":%d,\"volume\":%d,\"name\":\"%s\",\"url\":\"%s\",\"vuL\":%d,\"vuR\":%d,",
       webRadioEnabled ? "true" : "false",
       webRadioCurrentIndex,
       webRadioVolume,
@@ -1072,6 +1080,14 @@ void setup_webradio_webserver(AsyncWebServer* server) {
       webRadioUrl.c_str(),
       wrVuLeft, wrVuRight
     );
+    // Salute dello stream (buffer, rete vs codec, jitter, underrun, riconnessioni)
+    pos += snprintf(jsonBuf + pos, sizeof(jsonBuf) - pos,
+      "\"health\":{\"fill\":%lu,\"size\":%lu,\"arrival\":%lu,\"bitrate\":%lu,\"jitter\":%lu,\"startFill\":%lu,"
+      "\"underruns\":%lu,\"reconnects\":%lu,\"resyncs\":%lu,\"buffering\":%s},\"stations\":[",
+      (unsigned long)h.fill, (unsigned long)h.size, (unsigned long)h.arrivalBps, (unsigned long)h.codecBps,
+      (unsigned long)h.jitterMs, (unsigned long)h.startFill, (unsigned long)h.underruns,
+      (unsigned long)h.reconnects, (unsigned long)h.resyncs, h.buffering ? "true" : "false"
+    );
 
     for (int i = 0; i < webRadioStationCount && i < 30; i++) {
       if (i > 0) pos += snprintf(jsonBuf + pos, sizeof(jsonBuf) - pos, ",");
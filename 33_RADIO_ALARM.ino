@@ -18,6 +18,10 @@
 #define EEPROM_ALARM_SNOOZE_ADDR     576  // Minuti snooze (1 byte)
 #define EEPROM_ALARM_VALID_ADDR      577  // Marker validita' (0xAA)
 
+// Pre-roll: lo stream viene connesso a volume 0 prima dell'orario, cosi' alla sveglia
+// il buffer e' gia' pieno e la radio parte subito (anche se il server risponde lento)
+#define RADIO_ALARM_PREROLL_S        45   // Secondi di anticipo (30-60)
+
 // ================== EXTERN VARIABILI WEB RADIO ==================
 #ifdef EFFECT_WEB_RADIO
 extern WebRadioStation webRadioStations[];
@@ -79,6 +83,9 @@ bool radioAlarmNeedsRedraw = true;
 bool radioAlarmRinging = false;       // Sveglia sta suonando
 bool radioAlarmSnoozed = false;       // In modalita' snooze
 uint32_t radioAlarmSnoozeUntil = 0;   // Timestamp fine snooze
+bool radioAlarmPreroll = false;       // Stream gia' connesso e muto in attesa della sveglia
+uint32_t radioAlarmPrerollStart = 0;  // millis() di inizio pre-roll
+uint8_t radioAlarmPrerollVolume = 0;  // Volume audio da ripristinare se il pre-roll viene annullato
 uint8_t radioAlarmEditField = 0;      // Campo in modifica (0=ora, 1=min, 2=stazione, 3=volume)
 
 // ================== PROTOTIPI FUNZIONI ==================
@@ -99,6 +106,8 @@ void saveRadioAlarmSettings();
 void loadRadioAlarmSettings();
 void checkRadioAlarmTrigger();
 void triggerRadioAlarm();
+void startRadioAlarmPreroll();
+void cancelRadioAlarmPreroll();
 void stopRadioAlarm();
 void snoozeRadioAlarm();
 String getRAStationName(int index);
@@ -870,7 +879,7 @@ void saveRadioAlarmSettings() {
   EEPROM.write(EEPROM_ALARM_VOLUME_ADDR, radioAlarm.volume);
   EEPROM.write(EEPROM_ALARM_SNOOZE_ADDR, radioAlarm.snoozeMinutes);
   EEPROM.write(EEPROM_ALARM_VALID_ADDR, 0xAA);
-  EEPROM.commit();
+  settingsCommit();
   yield();  // Previene watchdog timeout
 
   Serial.printf("[RADIO-ALARM] Impostazioni salvate: %02d:%02d, Stazione %d, Volume %d\n",
@@ -912,12 +921,18 @@ void loadRadioAlarmSettings() {
 
 // ================== CONTROLLO TRIGGER SVEGLIA ==================
 void checkRadioAlarmTrigger() {
-  if (!radioAlarm.enabled) return;
+  if (!radioAlarm.enabled) {
+    cancelRadioAlarmPreroll();
+    return;
+  }
   if (radioAlarmRinging) return;
 
   // Controlla snooze - se e' finito, ri-attiva la sveglia
   if (radioAlarmSnoozed) {
-    if (millis() < radioAlarmSnoozeUntil) return;
+    if (millis() < radioAlarmSnoozeUntil) {
+      if (radioAlarmSnoozeUntil - millis() <= RADIO_ALARM_PREROLL_S * 1000UL) startRadioAlarmPreroll();
+      return;
+    }
     // Snooze finito, ri-attiva la sveglia!
     Serial.println("[RADIO-ALARM] Snooze terminato, ri-attivo sveglia!");
     radioAlarmSnoozed = false;
@@ -931,6 +946,20 @@ void checkRadioAlarmTrigger() {
   int currentSecond = myTZ.second();
   int dayOfWeek = myTZ.weekday() - 1; // ezTime: 1=Dom -> 0=Dom
 
+  // Pre-roll nei RADIO_ALARM_PREROLL_S secondi prima della sveglia (anche a cavallo della mezzanotte)
+  int32_t toAlarm = (radioAlarm.hour * 3600L + radioAlarm.minute * 60L) -
+                    (currentHour * 3600L + currentMinute * 60L + currentSecond);
+  int alarmDay = dayOfWeek;
+  if (toAlarm < 0) {
+    toAlarm += 86400L;
+    alarmDay = (dayOfWeek + 1) % 7;
+  }
+  if (toAlarm > 0 && toAlarm <= RADIO_ALARM_PREROLL_S && (radioAlarm.daysMask & (1 << alarmDay))) {
+    startRadioAlarmPreroll();
+  } else if (radioAlarmPreroll && millis() - radioAlarmPrerollStart > (RADIO_ALARM_PREROLL_S + 30) * 1000UL) {
+    cancelRadioAlarmPreroll();  // Orario o giorni cambiati durante il pre-roll
+  }
+
   // Controlla se e' il giorno giusto
   if (!(radioAlarm.daysMask & (1 << dayOfWeek))) return;
 
@@ -953,16 +982,23 @@ void triggerRadioAlarm() {
       radioAlarm.stationIndex = 0;
     }
 
-    // Seleziona stazione
+    // Seleziona stazione (a radio spenta aggiorna solo nome e URL, non riconnette)
     selectWebRadioStation(radioAlarm.stationIndex);
 
-    // Avvia radio SE non attiva
-    if (!webRadioEnabled) {
+    extern Audio audio;
+    if (radioAlarmPreroll && !webRadioEnabled && audio.isRunning()) {
+      // Stream connesso dal pre-roll: il buffer e' pieno, basta alzare il volume
+      webRadioEnabled = true;
+      Audio::streamHealth_t h = audio.getStreamHealth();
+      Serial.printf("[RADIO-ALARM] Pre-roll pronto: buffer %lu/%lu byte, underrun %lu, riconnessioni %lu\n",
+                    (unsigned long)h.fill, (unsigned long)h.size, (unsigned long)h.underruns, (unsigned long)h.reconnects);
+    } else if (!webRadioEnabled) {
+      // Avvia radio SE non attiva
       startWebRadio();
     }
+    radioAlarmPreroll = false;
 
     // Imposta volume sveglia (dopo avvio, NON modifica webRadioVolume)
-    extern Audio audio;
     audio.setVolume(map(radioAlarm.volume, 0, 100, 0, 21));  // Converte 0-100 a 0-21
     Serial.printf("[RADIO-ALARM] Volume sveglia: %d%%\n", radioAlarm.volume);
   } else {
@@ -977,6 +1013,44 @@ void triggerRadioAlarm() {
   radioAlarmNeedsRedraw = true;
 }
 
+// ================== PRE-ROLL SVEGLIA ==================
+// Connette la stazione della sveglia a volume 0: il buffer si riempie in anticipo e
+// triggerRadioAlarm() deve solo alzare il volume.
+void startRadioAlarmPreroll() {
+  #ifdef EFFECT_WEB_RADIO
+  if (radioAlarmPreroll || webRadioEnabled || webRadioStationCount == 0) return;
+
+  extern Audio audio;
+  if (audio.isRunning()) return;  // MP3 o annuncio in corso: la sveglia partira' normalmente
+
+  if (radioAlarm.stationIndex >= webRadioStationCount) {
+    radioAlarm.stationIndex = 0;
+  }
+  selectWebRadioStation(radioAlarm.stationIndex);
+
+  radioAlarmPrerollVolume = audio.getVolume();
+  audio.setVolume(0);
+  audio.connecttohost(webRadioUrl.c_str());
+  radioAlarmPreroll = true;
+  radioAlarmPrerollStart = millis();
+  Serial.printf("[RADIO-ALARM] Pre-roll: connessione anticipata a %s\n", webRadioName.c_str());
+  #endif
+}
+
+void cancelRadioAlarmPreroll() {
+  if (!radioAlarmPreroll) return;
+  radioAlarmPreroll = false;
+
+  #ifdef EFFECT_WEB_RADIO
+  extern Audio audio;
+  if (!webRadioEnabled) {  // Se l'utente ha acceso la radio nel frattempo la lascia suonare
+    audio.stopSong();
+    audio.setVolume(radioAlarmPrerollVolume);
+  }
+  #endif
+  Serial.println("[RADIO-ALARM] Pre-roll annullato");
+}
+
 // ================== FERMA SVEGLIA ==================
 void stopRadioAlarm() {
   Serial.println("[RADIO-ALARM] Sveglia fermata");
@@ -1237,7 +1311,7 @@ void setup_radioalarm_webserver(AsyncWebServer* server) {
     int pos = 0;
 
     pos += snprintf(jsonBuf + pos, sizeof(jsonBuf) - pos,
-      "{\"enabled\":%s,\"hour\":%d,\"minute\":%d,\"station\":%d,\"days\":%d,\"volume\":%d,\"snooze\":%d,\"ringing\":%s,\"snoozed\":%s,\"snoozeRemaining\":%lu,\"stations\":[",
+      "{\"enabled\":%s,\"hour\":%d,\"minute\":%d,\"station\":%d,\"days\":%d,\"volume\":%d,\"snooze\":%d,\"ringing\":%s,\"snoozed\":%s,\"snoozeRemaining\":%lu,\"preroll\":%s,\"stations\":[",
       radioAlarm.enabled ? "true" : "false",
       radioAlarm.hour,
       radioAlarm.minute,
@@ -1247,7 +1321,8 @@ void setup_radioalarm_webserver(AsyncWebServer* server) {
       radioAlarm.snoozeMinutes,
       radioAlarmRinging ? "true" : "false",
       radioAlarmSnoozed ? "true" : "false",
-      snoozeRemaining
+      snoozeRemaining,
+      radioAlarmPreroll ? "true" : "false"
     );
 
     #ifdef EFFECT_WEB_RADIO
@@ -299,12 +299,12 @@ void updateWebTV() {
   uint32_t now = millis();
   if (now - lastTouchCheck > (webTVStreaming ? 200 : 50)) {
     lastTouchCheck = now;
-    ts.read();
-    if (ts.isTouched && ts.touches > 0) {
+    touchRead();
+    if (touchState.isTouched && touchState.touches > 0) {
       static uint32_t lastTouch = 0;
       if (now - lastTouch > 400) {
-        int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
-        int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
+        int x = map(touchState.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 479);
+        int y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 479);
 
         x = constrain(x, 0, 479);
         y = constrain(y, 0, 479);
@@ -828,7 +828,7 @@ void loadCalSnoozeFromEEPROM() {
 void saveCalSnoozeToEEPROM() {
   EEPROM.write(EEPROM_CAL_SNOOZE_ADDR, (uint8_t)calAlarmSnoozeMinutes);
   EEPROM.write(EEPROM_CAL_SNOOZE_VALID, 0xBB);
-  EEPROM.commit();
+  settingsCommit();
   Serial.printf("[CAL ALARM] Snooze salvato: %d minuti\n", calAlarmSnoozeMinutes);
 }
 
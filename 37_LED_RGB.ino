@@ -2,10 +2,22 @@
 // Anello WS2812 con 12 LED RGB collegato al GPIO9
 // Cambia colore automaticamente in base al tema/modalità display attivo
 // Controllo on/off, luminosità e override colore dalla pagina web /ledrgb
+//
+// Motore LED:
+//  - ogni frame viene composto in un buffer (GRB) e confrontato con l'ultimo
+//    inviato: se identico non si trasmette nulla (colore fisso = zero traffico)
+//  - la trasmissione usa la periferica RMT in modalita' non bloccante: il loop
+//    accoda il frame e prosegue, il driver RMT genera i bit WS2812 in hardware
+//    (niente bit-bang con interrupt disabilitati). Se il frame precedente e'
+//    ancora in uscita il nuovo viene ritentato al tick successivo
+//  - effetti a tempo (fisso, respiro, inseguimento, spettro) calcolati da millis(),
+//    quindi indipendenti dalla frequenza del loop
+//  - in modalita' audio il livello viene misurato sul PCM decodificato
+//    (audio_process_extern, task audio): RMS complessivo + energia in 12 bande
 
 #ifdef EFFECT_LED_RGB
 
-#include <Adafruit_NeoPixel.h>
+#include "driver/rmt.h"
 #include "driver/uart.h"
 #include "driver/gpio.h"
 #include "esp_rom_gpio.h"
@@ -15,20 +27,28 @@
 #define WS2812_PIN        43  // GPIO43 - su ESP32-S3 Serial usa USB-CDC, non UART0, quindi GPIO43 e' libero
 #define WS2812_NUM_LEDS   12
 
-// ===== EEPROM addresses (900-907) =====
-// NOTA: 700-704 sono usati da enabledModesMask e rainbowMode!
-#define EEPROM_LED_RGB_ENABLED    900
-#define EEPROM_LED_RGB_BRIGHTNESS 901
-#define EEPROM_LED_RGB_OVERRIDE   902
-#define EEPROM_LED_RGB_R          903
-#define EEPROM_LED_RGB_G          904
-#define EEPROM_LED_RGB_B          905
-#define EEPROM_LED_RGB_MARKER     906
-#define EEPROM_LED_RGB_VALID      0xAC  // Cambiato per forzare reset default
-#define EEPROM_LED_RGB_AUDIOREACT 907
-
-// ===== Oggetto NeoPixel =====
-Adafruit_NeoPixel ledStrip(WS2812_NUM_LEDS, WS2812_PIN, NEO_GRB + NEO_KHZ800);
+// ===== RMT =====
+// clk_div 2 -> 40MHz, 1 tick = 25ns. Tempi WS2812: T0H 0.4us, T0L 0.85us, T1H 0.8us, T1L 0.45us
+#define LED_RMT_CHANNEL   RMT_CHANNEL_0
+#define LED_RMT_CLK_DIV   2
+#define WS2812_T0H        16
+#define WS2812_T0L        34
+#define WS2812_T1H        32
+#define WS2812_T1L        18
+
+// ===== EEPROM addresses (900-907, 952) =====
+// Nel file principale (EEPROM_LED_RGB_*): servono anche alla tabella schema di 0_SETTINGS_STORE.ino
+
+// ===== Effetti =====
+#define LED_FX_SOLID      0   // Colore fisso
+#define LED_FX_BREATH     1   // Respiro (luminosita' sinusoidale)
+#define LED_FX_CHASE      2   // Inseguimento con coda sfumata
+#define LED_FX_SPECTRUM   3   // Barre di spettro: 1 LED = 1 banda audio
+#define LED_FX_COUNT      4
+
+#define LED_BREATH_PERIOD_MS  4000
+#define LED_CHASE_PERIOD_MS   1500   // Un giro completo dell'anello
+#define LED_CHASE_TAIL        4      // Lunghezza coda in LED
 
 // ===== Variabili globali =====
 bool    ledRgbEnabled       = true;
@@ -37,20 +57,63 @@ bool    ledRgbOverride      = false;
 uint8_t ledRgbOverrideR     = 255;
 uint8_t ledRgbOverrideG     = 255;
 uint8_t ledRgbOverrideB     = 255;
+uint8_t ledRgbEffect        = LED_FX_SOLID;
 
-// Throttle: aggiorna LED ogni 100ms (non serve di più)
+// Frame LED: 20ms (50fps) per gli effetti animati; a colore fisso il frame
+// viene comunque ricalcolato ma non trasmesso
 static unsigned long lastLedUpdate = 0;
-#define LED_UPDATE_INTERVAL 100
-
-// ===== Audio reactive (lampeggio a tempo) =====
+#define LED_FRAME_INTERVAL 20
+
+// Buffer frame (ordine GRB come richiesto dai WS2812)
+static uint8_t ledFrame[WS2812_NUM_LEDS * 3];
+static uint8_t ledTxFrame[WS2812_NUM_LEDS * 3];   // Frame in trasmissione (letto dal driver RMT)
+static bool    ledRmtReady = false;
+
+// ===== Statistiche motore =====
+static uint32_t ledStatRendered   = 0;   // Frame calcolati
+static uint32_t ledStatPushed     = 0;   // Frame trasmessi
+static uint32_t ledStatSkipped    = 0;   // Frame identici al precedente (non trasmessi)
+static uint32_t ledStatBusy       = 0;   // Frame rinviati perche' RMT ancora occupato
+static uint32_t ledStatRenderUs   = 0;   // Accumulo tempo render+push nella finestra
+static uint32_t ledStatWinStart   = 0;
+static uint32_t ledStatWinRendered = 0;
+static uint32_t ledStatWinPushed  = 0;
+static float    ledFps            = 0;   // Frame trasmessi/s
+static float    ledRenderFps      = 0;   // Frame calcolati/s
+static float    ledRenderUsAvg    = 0;   // Costo medio per frame (us)
+static float    ledRenderLoad     = 0;   // % CPU del loop spesa nel motore LED
+
+// ===== Audio reactive (livello misurato sul PCM) =====
 // 0 = Disattivato, 1 = Pulsazione (solo LED accesi), 2 = Accendi con audio (anche LED spenti)
 uint8_t ledAudioReactive = 1;       // Default: pulsazione
-static uint8_t ledAudioTarget  = 0; // Target livello simulato
-static uint8_t ledAudioSmooth  = 0; // Livello smoothed
-static uint8_t ledAudioLevel   = 0; // Livello finale 0-100
-#define LED_AUDIO_ATTACK  12   // Velocità salita
-#define LED_AUDIO_DECAY    4   // Velocità discesa
+#define LED_AUDIO_BANDS    WS2812_NUM_LEDS
+#define LED_AUDIO_ATTACK  40   // Velocità salita (per frame, livello 0-100)
+#define LED_AUDIO_DECAY    3   // Velocità discesa
+#define LED_BAND_DECAY    10   // Discesa barre spettro (per frame, 0-255)
 #define LED_AUDIO_MIN_BRI 30   // Luminosità minima durante audio (% della brightness impostata)
+#define LED_AUDIO_STALE_MS 300 // Nessun PCM da 300ms -> livello a zero
+#define LED_AUDIO_DEC_RATE 11025 // Frequenza di analisi dopo decimazione
+
+// Pubblicati dal task audio (protetti da ledAudioMux)
+static portMUX_TYPE ledAudioMux = portMUX_INITIALIZER_UNLOCKED;
+static uint8_t  ledAudioRawLevel = 0;                  // 0-100
+static uint8_t  ledAudioRawBands[LED_AUDIO_BANDS];     // 0-255
+static uint32_t ledAudioStampMs  = 0;
+
+// Inviluppo lato render (loop)
+static uint8_t ledAudioLevel = 0;                      // 0-100
+static uint8_t ledAudioBands[LED_AUDIO_BANDS];
+
+// Stato analisi (usato solo dal task audio)
+static float    ledBqB0[LED_AUDIO_BANDS], ledBqA1[LED_AUDIO_BANDS], ledBqA2[LED_AUDIO_BANDS];
+static float    ledBqZ1[LED_AUDIO_BANDS], ledBqZ2[LED_AUDIO_BANDS];
+static uint32_t ledAnaRate  = 0;
+static uint8_t  ledAnaDecim = 1;
+static int32_t  ledAnaDecAcc = 0;
+static uint8_t  ledAnaDecCnt = 0;
+static uint32_t ledAnaUsAcc = 0;       // Tempo analisi nella finestra (us)
+static uint32_t ledAnaFramesAcc = 0;   // Campioni audio analizzati nella finestra
+static float    ledAnaUsPerSec = 0;    // Costo analisi per secondo di audio (us)
 
 // ===== Carica impostazioni da EEPROM =====
 void loadLedRgbSettings() {
@@ -63,8 +126,10 @@ void loadLedRgbSettings() {
     ledRgbOverrideB  = EEPROM.read(EEPROM_LED_RGB_B);
     ledAudioReactive = EEPROM.read(EEPROM_LED_RGB_AUDIOREACT);
     if (ledAudioReactive > 2) ledAudioReactive = 1; // Sanitize
-    Serial.printf("[LED RGB] Impostazioni caricate: enabled=%d, brightness=%d, override=%d, R=%d G=%d B=%d, audioReactive=%d\n",
-                  ledRgbEnabled, ledRgbBrightness, ledRgbOverride, ledRgbOverrideR, ledRgbOverrideG, ledRgbOverrideB, ledAudioReactive);
+    ledRgbEffect     = EEPROM.read(EEPROM_LED_RGB_EFFECT);
+    if (ledRgbEffect >= LED_FX_COUNT) ledRgbEffect = LED_FX_SOLID; // Cella mai scritta (0xFF)
+    Serial.printf("[LED RGB] Impostazioni caricate: enabled=%d, brightness=%d, override=%d, R=%d G=%d B=%d, audioReactive=%d, effect=%d\n",
+                  ledRgbEnabled, ledRgbBrightness, ledRgbOverride, ledRgbOverrideR, ledRgbOverrideG, ledRgbOverrideB, ledAudioReactive, ledRgbEffect);
   } else {
     Serial.println("[LED RGB] Nessuna impostazione salvata, uso valori predefiniti");
     saveLedRgbSettings(); // Salva i default
@@ -80,11 +145,98 @@ void saveLedRgbSettings() {
   EEPROM.write(EEPROM_LED_RGB_G, ledRgbOverrideG);
   EEPROM.write(EEPROM_LED_RGB_B, ledRgbOverrideB);
   EEPROM.write(EEPROM_LED_RGB_AUDIOREACT, ledAudioReactive);
+  EEPROM.write(EEPROM_LED_RGB_EFFECT, ledRgbEffect);
   EEPROM.write(EEPROM_LED_RGB_MARKER, EEPROM_LED_RGB_VALID);
-  EEPROM.commit();
+  settingsCommit();
   Serial.println("[LED RGB] Impostazioni salvate in EEPROM");
 }
 
+// ===== Traduttore RMT: byte del frame -> simboli WS2812 =====
+// Chiamato dal driver RMT (anche da ISR) man mano che la memoria del canale si libera
+static void IRAM_ATTR ledRmtTranslate(const void *src, rmt_item32_t *dest, size_t srcSize,
+                                      size_t wantedNum, size_t *translatedSize, size_t *itemNum) {
+  if (src == NULL || dest == NULL) {
+    *translatedSize = 0;
+    *itemNum = 0;
+    return;
+  }
+  rmt_item32_t bit0, bit1;
+  bit0.duration0 = WS2812_T0H; bit0.level0 = 1; bit0.duration1 = WS2812_T0L; bit0.level1 = 0;
+  bit1.duration0 = WS2812_T1H; bit1.level0 = 1; bit1.duration1 = WS2812_T1L; bit1.level1 = 0;
+
+  const uint8_t *psrc = (const uint8_t *)src;
+  size_t size = 0, num = 0;
+  while (size < srcSize && num + 8 <= wantedNum) {
+    uint8_t v = psrc[size];
+    for (int i = 0; i < 8; i++) {
+      dest[num++].val = (v & (0x80 >> i)) ? bit1.val : bit0.val;
+    }
+    size++;
+  }
+  *translatedSize = size;
+  *itemNum = num;
+}
+
+static bool ledRmtBegin() {
+  rmt_config_t cfg = RMT_DEFAULT_CONFIG_TX((gpio_num_t)WS2812_PIN, LED_RMT_CHANNEL);
+  cfg.clk_div = LED_RMT_CLK_DIV;
+  cfg.tx_config.idle_output_en = true;
+  cfg.tx_config.idle_level = RMT_IDLE_LEVEL_LOW;
+  if (rmt_config(&cfg) != ESP_OK) return false;
+  if (rmt_driver_install(LED_RMT_CHANNEL, 0, 0) != ESP_OK) return false;
+  if (rmt_translator_init(LED_RMT_CHANNEL, ledRmtTranslate) != ESP_OK) {
+    rmt_driver_uninstall(LED_RMT_CHANNEL);
+    return false;
+  }
+  return true;
+}
+
+// ===== Composizione frame =====
+static inline void ledSetPixel(uint8_t i, uint8_t r, uint8_t g, uint8_t b, uint8_t scale) {
+  uint8_t *p = &ledFrame[i * 3];
+  p[0] = ((uint16_t)g * (scale + 1)) >> 8;
+  p[1] = ((uint16_t)r * (scale + 1)) >> 8;
+  p[2] = ((uint16_t)b * (scale + 1)) >> 8;
+}
+
+static void ledFill(uint8_t r, uint8_t g, uint8_t b, uint8_t scale) {
+  for (uint8_t i = 0; i < WS2812_NUM_LEDS; i++) ledSetPixel(i, r, g, b, scale);
+}
+
+// Ruota colori 0-255 (rosso -> verde -> blu -> rosso) per le barre di spettro
+static void ledWheel(uint8_t pos, uint8_t &r, uint8_t &g, uint8_t &b) {
+  if (pos < 85) {
+    r = 255 - pos * 3; g = pos * 3; b = 0;
+  } else if (pos < 170) {
+    pos -= 85;
+    r = 0; g = 255 - pos * 3; b = pos * 3;
+  } else {
+    pos -= 170;
+    r = pos * 3; g = 0; b = 255 - pos * 3;
+  }
+}
+
+// Invia il frame solo se diverso dall'ultimo trasmesso, senza attendere la fine
+static void ledPushFrame() {
+  if (memcmp(ledFrame, ledTxFrame, sizeof(ledFrame)) == 0) {
+    ledStatSkipped++;
+    return;
+  }
+  if (ledRmtReady) {
+    // Frame precedente ancora in uscita: il buffer TX e' in uso dal driver, riprova al prossimo tick
+    if (rmt_wait_tx_done(LED_RMT_CHANNEL, 0) != ESP_OK) {
+      ledStatBusy++;
+      return;
+    }
+    memcpy(ledTxFrame, ledFrame, sizeof(ledFrame));
+    rmt_write_sample(LED_RMT_CHANNEL, ledTxFrame, sizeof(ledTxFrame), false);
+  } else {
+    memcpy(ledTxFrame, ledFrame, sizeof(ledFrame));
+  }
+  ledStatPushed++;
+  ledStatWinPushed++;
+}
+
 // ===== Setup LED RGB =====
 void setup_led_rgb() {
   // === GPIO43 è UART0 TX (IOMUX) su ESP32-S3 ===
@@ -99,14 +251,23 @@ void setup_led_rgb() {
   gpio_reset_pin((gpio_num_t)WS2812_PIN);
   esp_rom_gpio_connect_out_signal(WS2812_PIN, SIG_GPIO_OUT_IDX, false, false);
 
-  ledStrip.begin();
-  ledStrip.clear();
-  ledStrip.show();
+  ledRmtReady = ledRmtBegin();
+  if (!ledRmtReady) {
+    Serial.println("[LED RGB] ERRORE: inizializzazione RMT fallita, LED disabilitati");
+  }
+
+  // Primo frame: spegne l'anello (stato dei LED indefinito all'accensione)
+  memset(ledFrame, 0, sizeof(ledFrame));
+  memset(ledTxFrame, 0, sizeof(ledTxFrame));
+  if (ledRmtReady) {
+    rmt_write_sample(LED_RMT_CHANNEL, ledTxFrame, sizeof(ledTxFrame), true);
+  }
+  ledStatWinStart = millis();
+
   loadLedRgbSettings();
-  ledStrip.setBrightness(ledRgbBrightness);
-  Serial.printf("[LED RGB] Inizializzato - 12 LED WS2812 su GPIO43\n");
-  Serial.printf("[LED RGB] Stato: enabled=%d, brightness=%d, override=%d, audioReactive=%d\n",
-                ledRgbEnabled, ledRgbBrightness, ledRgbOverride, ledAudioReactive);
+  Serial.printf("[LED RGB] Inizializzato - 12 LED WS2812 su GPIO43 (RMT ch%d)\n", (int)LED_RMT_CHANNEL);
+  Serial.printf("[LED RGB] Stato: enabled=%d, brightness=%d, override=%d, audioReactive=%d, effect=%d\n",
+                ledRgbEnabled, ledRgbBrightness, ledRgbOverride, ledAudioReactive, ledRgbEffect);
   if (ledRgbOverride) {
     Serial.printf("[LED RGB] ATTENZIONE: Override attivo! Colore fisso: R=%d G=%d B=%d\n",
                   ledRgbOverrideR, ledRgbOverrideG, ledRgbOverrideB);
@@ -321,22 +482,215 @@ void getLedColorForMode(DisplayMode mode, uint8_t &r, uint8_t &g, uint8_t &b) {
   }
 }
 
+// ===== Analisi audio (task audio) =====
+// Hook della libreria Audio: riceve ogni blocco PCM decodificato (16 bit,
+// interleaved se stereo, len = frame) prima che vada all'I2S.
+// Downmix mono -> decimazione a ~11kHz (media a blocchi, fa anche da passa-basso)
+// -> 12 biquad passa-banda a spaziatura logaritmica 60Hz-4.5kHz.
+// Il risultato viene pubblicato in ledAudioRaw*, letto dal loop in updateLedRgb().
+
+// Coefficienti RBJ passa-banda (guadagno 0dB al centro), ricalcolati al cambio sample rate
+static void ledAnalysisSetup(uint32_t sampleRate) {
+  ledAnaRate  = sampleRate;
+  ledAnaDecim = (sampleRate > LED_AUDIO_DEC_RATE) ? (uint8_t)(sampleRate / LED_AUDIO_DEC_RATE) : 1;
+  ledAnaDecAcc = 0;
+  ledAnaDecCnt = 0;
+  float fs = (float)sampleRate / ledAnaDecim;
+  float fTop = fs * 0.4f;
+  if (fTop > 4500.0f) fTop = 4500.0f;
+  const float fLow = 60.0f;
+  const float q = 2.5f;
+  for (uint8_t b = 0; b < LED_AUDIO_BANDS; b++) {
+    float f0 = fLow * powf(fTop / fLow, (float)b / (LED_AUDIO_BANDS - 1));
+    float w0 = 2.0f * PI * f0 / fs;
+    float alpha = sinf(w0) / (2.0f * q);
+    float a0 = 1.0f + alpha;
+    ledBqB0[b] = alpha / a0;
+    ledBqA1[b] = -2.0f * cosf(w0) / a0;
+    ledBqA2[b] = (1.0f - alpha) / a0;
+    ledBqZ1[b] = 0;
+    ledBqZ2[b] = 0;
+  }
+  Serial.printf("[LED RGB] Analisi audio: %luHz, decimazione %d, bande 60-%.0fHz\n",
+                (unsigned long)sampleRate, ledAnaDecim, fTop);
+}
+
+// dB -> scala 0..outMax con soglia a dbFloor e fondo scala a dbTop
+static uint8_t ledDbScale(float meanSq, float dbFloor, float dbTop, uint8_t outMax) {
+  if (meanSq <= 0) return 0;
+  float db = 10.0f * log10f(meanSq / (32768.0f * 32768.0f));
+  if (db <= dbFloor) return 0;
+  if (db >= dbTop) return outMax;
+  return (uint8_t)((db - dbFloor) * outMax / (dbTop - dbFloor));
+}
+
+void audio_process_extern(int16_t* buff, uint16_t len, bool *continueI2S) {
+  *continueI2S = true;   // Il PCM prosegue comunque verso l'I2S
+  if (buff == NULL || len == 0) return;
+  if (audio.getBitsPerSample() != 16) return;
+  uint32_t sampleRate = audio.getSampleRate();
+  if (sampleRate == 0) return;
+
+  uint32_t t0 = micros();
+  if (sampleRate != ledAnaRate) ledAnalysisSetup(sampleRate);
+
+  bool stereo = (audio.getChannels() == 2);
+  float sumSq = 0;
+  float bandSq[LED_AUDIO_BANDS] = {0};
+  uint16_t nDec = 0;
+
+  for (uint16_t i = 0; i < len; i++) {
+    int32_t s = stereo ? (((int32_t)buff[2 * i] + buff[2 * i + 1]) >> 1) : buff[i];
+    sumSq += (float)s * (float)s;
+
+    ledAnaDecAcc += s;
+    if (++ledAnaDecCnt < ledAnaDecim) continue;
+    float x = (float)ledAnaDecAcc / ledAnaDecim;
+    ledAnaDecAcc = 0;
+    ledAnaDecCnt = 0;
+    nDec++;
+
+    // Biquad forma diretta II trasposta (b1 = 0, b2 = -b0)
+    for (uint8_t b = 0; b < LED_AUDIO_BANDS; b++) {
+      float y = ledBqB0[b] * x + ledBqZ1[b];
+      ledBqZ1[b] = ledBqZ2[b] - ledBqA1[b] * y;
+      ledBqZ2[b] = -ledBqB0[b] * x - ledBqA2[b] * y;
+      bandSq[b] += y * y;
+    }
+  }
+
+  uint8_t level = ledDbScale(sumSq / len, -50.0f, -6.0f, 100);
+  uint8_t bands[LED_AUDIO_BANDS];
+  for (uint8_t b = 0; b < LED_AUDIO_BANDS; b++) {
+    bands[b] = nDec ? ledDbScale(bandSq[b] / nDec, -45.0f, -12.0f, 255) : 0;
+  }
+
+  portENTER_CRITICAL(&ledAudioMux);
+  ledAudioRawLevel = level;
+  memcpy(ledAudioRawBands, bands, sizeof(bands));
+  ledAudioStampMs = millis();
+  ledAnaUsAcc += micros() - t0;
+  ledAnaFramesAcc += len;
+  portEXIT_CRITICAL(&ledAudioMux);
+}
+
+// Inviluppo attacco/decadimento sul livello misurato (chiamato una volta per frame)
+static void ledAudioFollow(bool active) {
+  uint8_t level = 0;
+  uint8_t bands[LED_AUDIO_BANDS];
+  memset(bands, 0, sizeof(bands));
+  if (active) {
+    portENTER_CRITICAL(&ledAudioMux);
+    bool fresh = (millis() - ledAudioStampMs) < LED_AUDIO_STALE_MS;
+    if (fresh) {
+      level = ledAudioRawLevel;
+      memcpy(bands, ledAudioRawBands, sizeof(bands));
+    }
+    portEXIT_CRITICAL(&ledAudioMux);
+  }
+
+  if (ledAudioLevel < level) {
+    int v = ledAudioLevel + LED_AUDIO_ATTACK;
+    ledAudioLevel = (v > level) ? level : (uint8_t)v;
+  } else {
+    int v = ledAudioLevel - LED_AUDIO_DECAY;
+    ledAudioLevel = (v < (int)level) ? level : (uint8_t)v;
+  }
+  for (uint8_t b = 0; b < LED_AUDIO_BANDS; b++) {
+    if (bands[b] >= ledAudioBands[b]) {
+      ledAudioBands[b] = bands[b];
+    } else {
+      int v = ledAudioBands[b] - LED_BAND_DECAY;
+      ledAudioBands[b] = (v < (int)bands[b]) ? bands[b] : (uint8_t)v;
+    }
+  }
+}
+
+// ===== Render effetti =====
+// scale = luminosità finale 0-255 (già modulata dall'audio se attivo)
+static void ledRenderEffect(uint8_t effect, uint8_t r, uint8_t g, uint8_t b, uint8_t scale,
+                            bool audioLive, unsigned long now) {
+  switch (effect) {
+    case LED_FX_BREATH: {
+      float k = 0.5f - 0.5f * cosf(2.0f * PI * (now % LED_BREATH_PERIOD_MS) / LED_BREATH_PERIOD_MS);
+      ledFill(r, g, b, (uint8_t)(scale * (0.08f + 0.92f * k)));
+      break;
+    }
+
+    case LED_FX_CHASE: {
+      // Testa in 1/256 di LED: movimento continuo, coda che sfuma linearmente
+      const uint32_t ring = WS2812_NUM_LEDS * 256;
+      uint32_t head = (uint32_t)(now % LED_CHASE_PERIOD_MS) * ring / LED_CHASE_PERIOD_MS;
+      for (uint8_t i = 0; i < WS2812_NUM_LEDS; i++) {
+        uint32_t d = (head + ring - (uint32_t)i * 256) % ring;
+        uint32_t inten = (d < LED_CHASE_TAIL * 256) ? 255 - d * 255 / (LED_CHASE_TAIL * 256) : 0;
+        ledSetPixel(i, r, g, b, (uint8_t)((scale * inten) / 255));
+      }
+      break;
+    }
+
+    case LED_FX_SPECTRUM:
+      if (audioLive) {
+        // Un LED per banda: colore dalla ruota (o colore override), intensità = energia
+        for (uint8_t i = 0; i < WS2812_NUM_LEDS; i++) {
+          uint8_t cr = r, cg = g, cb = b;
+          if (!ledRgbOverride) ledWheel((uint8_t)(i * 170 / (WS2812_NUM_LEDS - 1)), cr, cg, cb);
+          ledSetPixel(i, cr, cg, cb, (uint8_t)(((uint16_t)scale * ledAudioBands[i]) / 255));
+        }
+        break;
+      }
+      // Senza audio lo spettro ricade sul colore fisso
+      ledFill(r, g, b, scale);
+      break;
+
+    default:
+      ledFill(r, g, b, scale);
+      break;
+  }
+}
+
+// Finestra statistiche (1s): fps, costo medio, carico analisi
+static void ledUpdateStats(unsigned long now) {
+  uint32_t elapsed = now - ledStatWinStart;
+  if (elapsed < 1000) return;
+  ledFps         = ledStatWinPushed * 1000.0f / elapsed;
+  ledRenderFps   = ledStatWinRendered * 1000.0f / elapsed;
+  ledRenderUsAvg = ledStatWinRendered ? (float)ledStatRenderUs / ledStatWinRendered : 0;
+  ledRenderLoad  = ledStatRenderUs / (elapsed * 10.0f);
+
+  uint32_t anaUs, anaFrames;
+  portENTER_CRITICAL(&ledAudioMux);
+  anaUs = ledAnaUsAcc;
+  anaFrames = ledAnaFramesAcc;
+  ledAnaUsAcc = 0;
+  ledAnaFramesAcc = 0;
+  portEXIT_CRITICAL(&ledAudioMux);
+  // Costo per secondo di audio: indipendente da quanto velocemente il decoder riempie i buffer
+  ledAnaUsPerSec = (anaFrames && ledAnaRate) ? (float)anaUs * ledAnaRate / anaFrames : 0;
+
+  ledStatRenderUs    = 0;
+  ledStatWinRendered = 0;
+  ledStatWinPushed   = 0;
+  ledStatWinStart    = now;
+}
+
 // ===== Aggiornamento LED (chiamato nel loop) =====
 static unsigned long lastLedDebug = 0;
 
 void updateLedRgb() {
   unsigned long now = millis();
-  if (now - lastLedUpdate < LED_UPDATE_INTERVAL) return;
+  if (now - lastLedUpdate < LED_FRAME_INTERVAL) return;
   lastLedUpdate = now;
+  uint32_t t0 = micros();
 
   // Debug periodico ogni 5 secondi
   if (now - lastLedDebug > 5000) {
     lastLedDebug = now;
     uint8_t dr, dg, db;
     getLedColorForMode((DisplayMode)currentMode, dr, dg, db);
-    Serial.printf("[LED RGB] mode=%d, enabled=%d, override=%d, theme=(%d,%d,%d), overrideColor=(%d,%d,%d)\n",
-                  currentMode, ledRgbEnabled, ledRgbOverride, dr, dg, db,
-                  ledRgbOverrideR, ledRgbOverrideG, ledRgbOverrideB);
+    Serial.printf("[LED RGB] mode=%d, enabled=%d, override=%d, effect=%d, theme=(%d,%d,%d), overrideColor=(%d,%d,%d), fps=%.1f, skip=%lu\n",
+                  currentMode, ledRgbEnabled, ledRgbOverride, ledRgbEffect, dr, dg, db,
+                  ledRgbOverrideR, ledRgbOverrideG, ledRgbOverrideB, ledFps, (unsigned long)ledStatSkipped);
   }
 
   // Audio reactive solo in modalità audio (Radio, MP3, Radio Alarm)
@@ -351,90 +705,120 @@ void updateLedRgb() {
   if ((DisplayMode)currentMode == MODE_RADIO_ALARM) isAudioMode = true;
 #endif
 
+  bool audioLive = ledAudioReactive > 0 && isAudioMode && audio.isRunning();
+  ledAudioFollow(audioLive);
+
+  bool ledOff = false;
+
   // Mode 2: LED controllati solo dall'audio (solo in modalità audio)
   if (ledAudioReactive == 2 && isAudioMode) {
-    if (!audio.isRunning()) {
-      ledStrip.clear();
-      ledStrip.show();
-      return;
-    }
+    if (!audio.isRunning()) ledOff = true;
     // Audio attivo → continua per accendere e pulsare
   }
   // Mode 0 e 1, oppure mode 2 fuori da modalità audio: rispetta toggle on/off
   else if (!ledRgbEnabled) {
-    ledStrip.clear();
-    ledStrip.show();
-    return;
+    ledOff = true;
   }
 
   // Se radar attivo e nessuna presenza, spegni LED
-  {
-    bool noPresence = false;
+  if (!ledOff) {
     if (radarServerEnabled) {
       // Radar remoto
-      noPresence = !radarRemotePresence;
+      ledOff = !radarRemotePresence;
     } else if (radarConnectedOnce) {
       // Radar locale
-      noPresence = !presenceDetected;
-    }
-    if (noPresence) {
-      ledStrip.clear();
-      ledStrip.show();
-      return;
+      ledOff = !presenceDetected;
     }
   }
 
-  // ===== Calcolo luminosità con audio reactive =====
-  uint8_t activeBrightness = ledRgbBrightness;
-
-  if (ledAudioReactive > 0 && isAudioMode && audio.isRunning()) {
-    // Simula livello audio con variazione pseudo-casuale (come VU meter)
-    if (random(100) < 35) {
-      ledAudioTarget = random(30, 100);
+  if (ledOff) {
+    memset(ledFrame, 0, sizeof(ledFrame));
+  } else {
+    // ===== Calcolo luminosità con audio reactive =====
+    uint8_t activeBrightness = ledRgbBrightness;
+    if (audioLive && ledRgbEffect != LED_FX_SPECTRUM) {
+      // Modula brightness: da LED_AUDIO_MIN_BRI% a 100% della brightness impostata
+      uint16_t minBri = ((uint16_t)ledRgbBrightness * LED_AUDIO_MIN_BRI) / 100;
+      uint16_t range  = ledRgbBrightness - minBri;
+      activeBrightness = minBri + (uint8_t)(((uint16_t)range * ledAudioLevel) / 100);
     }
-    // Smooth attack/decay
-    if (ledAudioSmooth < ledAudioTarget) {
-      int v = ledAudioSmooth + LED_AUDIO_ATTACK;
-      ledAudioSmooth = (v > ledAudioTarget) ? ledAudioTarget : (uint8_t)v;
+
+    // ===== Calcolo colore =====
+    uint8_t r, g, b;
+    if (ledRgbOverride) {
+      // Override: usa colore personalizzato per tutti i LED
+      r = ledRgbOverrideR; g = ledRgbOverrideG; b = ledRgbOverrideB;
     } else {
-      int v = ledAudioSmooth - LED_AUDIO_DECAY;
-      ledAudioSmooth = (v < (int)ledAudioTarget) ? ledAudioTarget : (uint8_t)v;
+      // Colore tema basato sulla modalità corrente
+      getLedColorForMode((DisplayMode)currentMode, r, g, b);
     }
-    ledAudioLevel = ledAudioSmooth + random(-4, 5);
-    if (ledAudioLevel > 100) ledAudioLevel = 100;
-    if (ledAudioLevel < 5) ledAudioLevel = 5;
-
-    // Modula brightness: da LED_AUDIO_MIN_BRI% a 100% della brightness impostata
-    uint16_t minBri = ((uint16_t)ledRgbBrightness * LED_AUDIO_MIN_BRI) / 100;
-    uint16_t range  = ledRgbBrightness - minBri;
-    activeBrightness = minBri + (uint8_t)(((uint16_t)range * ledAudioLevel) / 100);
-  } else {
-    // Reset livello quando audio non attivo
-    ledAudioSmooth = 0;
-    ledAudioTarget = 0;
-    ledAudioLevel  = 0;
+    ledRenderEffect(ledRgbEffect, r, g, b, activeBrightness, audioLive, now);
   }
 
-  ledStrip.setBrightness(activeBrightness);
-
-  // ===== Calcolo colore =====
-  if (ledRgbOverride) {
-    // Override: usa colore personalizzato per tutti i LED
-    uint32_t color = ledStrip.Color(ledRgbOverrideR, ledRgbOverrideG, ledRgbOverrideB);
-    for (int i = 0; i < WS2812_NUM_LEDS; i++) {
-      ledStrip.setPixelColor(i, color);
-    }
-  } else {
-    // Colore tema basato sulla modalità corrente
-    uint8_t r, g, b;
-    getLedColorForMode((DisplayMode)currentMode, r, g, b);
-    uint32_t color = ledStrip.Color(r, g, b);
-    for (int i = 0; i < WS2812_NUM_LEDS; i++) {
-      ledStrip.setPixelColor(i, color);
-    }
+  ledPushFrame();
+  // Frame governor: servono frame regolari solo per effetti animati, audio o invio rinviato
+  if ((!ledOff && (ledRgbEffect != LED_FX_SOLID || audioLive)) ||
+      memcmp(ledFrame, ledTxFrame, sizeof(ledFrame)) != 0) {
+    frameGovServiceAt(now + LED_FRAME_INTERVAL);
   }
+  ledStatRendered++;
+  ledStatWinRendered++;
+  ledStatRenderUs += micros() - t0;
+  ledUpdateStats(now);
+}
+
+// ===== Pulsazione durante gli annunci vocali =====
+// Chiamata dal ciclo di attesa di playLocalMP3(): colore tema, luminosità dal livello misurato
+void ledRgbAnnounceFrame() {
+  unsigned long now = millis();
+  if (now - lastLedUpdate < LED_FRAME_INTERVAL) return;
+  lastLedUpdate = now;
 
-  ledStrip.show();
+  ledAudioFollow(true);
+  // Da 20% a 100% della brightness impostata
+  uint8_t bri = ledRgbBrightness > 0 ? ledRgbBrightness : 80;
+  uint8_t minBri = bri / 5;
+  uint8_t pulseBri = minBri + (uint8_t)((uint16_t)(bri - minBri) * ledAudioLevel / 100);
+
+  uint8_t r, g, b;
+  getLedColorForMode((DisplayMode)currentMode, r, g, b);
+  ledFill(r, g, b, pulseBri);
+  ledPushFrame();
+}
+
+// Spegne l'anello (il loop principale lo riaccenderà al frame successivo)
+void ledRgbClear() {
+  ledAudioLevel = 0;
+  memset(ledAudioBands, 0, sizeof(ledAudioBands));
+  memset(ledFrame, 0, sizeof(ledFrame));
+  ledPushFrame();
+}
+
+// ===== Stato motore per /ledrgb/status =====
+String getLedRgbEngineJson() {
+  String json = "{";
+  json += "\"driver\":\"" + String(ledRmtReady ? "rmt" : "none") + "\",";
+  json += "\"fps\":" + String(ledFps, 1) + ",";
+  json += "\"renderFps\":" + String(ledRenderFps, 1) + ",";
+  json += "\"renderUs\":" + String(ledRenderUsAvg, 1) + ",";
+  json += "\"cpuPercent\":" + String(ledRenderLoad, 2) + ",";
+  json += "\"rendered\":" + String(ledStatRendered) + ",";
+  json += "\"pushed\":" + String(ledStatPushed) + ",";
+  json += "\"skipped\":" + String(ledStatSkipped) + ",";
+  json += "\"busy\":" + String(ledStatBusy) + ",";
+  json += "\"audio\":{";
+  json += "\"sampleRate\":" + String(ledAnaRate) + ",";
+  json += "\"decimation\":" + String(ledAnaDecim) + ",";
+  json += "\"level\":" + String(ledAudioLevel) + ",";
+  json += "\"analysisUsPerSec\":" + String(ledAnaUsPerSec, 0) + ",";
+  json += "\"cpuPercent\":" + String(ledAnaUsPerSec / 10000.0f, 2) + ",";
+  json += "\"bands\":[";
+  for (uint8_t b = 0; b < LED_AUDIO_BANDS; b++) {
+    if (b) json += ",";
+    json += String(ledAudioBands[b]);
+  }
+  json += "]}}";
+  return json;
 }
 
 #endif // EFFECT_LED_RGB
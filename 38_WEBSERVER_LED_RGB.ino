@@ -117,6 +117,20 @@ static const char LED_RGB_HTML[] PROGMEM = R"rawliteral(
           <option value="2">LED spenti: si accendono con la musica</option>
         </select>
       </div>
+      <div class="row" style="flex-direction:column;align-items:stretch">
+        <div style="display:flex;justify-content:space-between;margin-bottom:8px">
+          <div>
+            <div class="label">Effetto</div>
+            <div class="sublabel" id="engineInfo">-</div>
+          </div>
+        </div>
+        <select id="effect" style="width:100%;padding:10px;border-radius:8px;border:1px solid rgba(255,255,255,0.15);background:#1e293b;color:#fff;font-size:0.9rem">
+          <option value="0">Fisso</option>
+          <option value="1">Respiro</option>
+          <option value="2">Inseguimento</option>
+          <option value="3">Spettro audio (1 LED per banda)</option>
+        </select>
+      </div>
     </div>
 
     <div class="card">
@@ -255,6 +269,7 @@ static const char LED_RGB_HTML[] PROGMEM = R"rawliteral(
         +'&g='+$('sliderG').value
         +'&b='+$('sliderB').value
         +'&audioReactive='+$('audioReactive').value
+        +'&effect='+$('effect').value
         +'&_t='+Date.now();
       fetch(url)
         .then(function(r){ return r.text(); })
@@ -262,6 +277,19 @@ static const char LED_RGB_HTML[] PROGMEM = R"rawliteral(
         .catch(function(e){ showStatus('Errore', false); });
     }
 
+    function showEngine(e){
+      if(!e) return;
+      $('engineInfo').textContent = e.fps.toFixed(1)+' fps, '+e.renderUs.toFixed(0)+' us/frame, CPU '
+        + e.cpuPercent.toFixed(2)+'% (audio '+e.audio.cpuPercent.toFixed(2)+'%)';
+    }
+
+    function pollEngine(){
+      fetch('/ledrgb/status?_t='+Date.now())
+        .then(function(r){ return r.json(); })
+        .then(function(d){ showEngine(d.engine); })
+        .catch(function(e){});
+    }
+
     function loadStatus(){
       fetch('/ledrgb/status?_t='+Date.now())
         .then(function(r){
@@ -280,6 +308,8 @@ static const char LED_RGB_HTML[] PROGMEM = R"rawliteral(
           $('valG').textContent = d.g;
           $('valB').textContent = d.b;
           $('audioReactive').value = d.audioReactive;
+          $('effect').value = d.effect;
+          showEngine(d.engine);
           themeR = d.themeR;
           themeG = d.themeG;
           themeB = d.themeB;
@@ -300,6 +330,8 @@ static const char LED_RGB_HTML[] PROGMEM = R"rawliteral(
       // Toggle e checkbox: salva su change
       $('enabled').addEventListener('change', function(){ updatePreview(); schedSave(); });
       $('audioReactive').addEventListener('change', function(){ schedSave(); });  // select
+      $('effect').addEventListener('change', function(){ schedSave(); });         // select
+      setInterval(pollEngine, 2000);
       $('override').addEventListener('change', function(){ toggleOverride(); schedSave(); });
 
       // Brightness slider
@@ -348,7 +380,9 @@ void setup_ledrgb_webserver(AsyncWebServer* server) {
     json += "\"audioReactive\":" + String(ledAudioReactive) + ",";
     json += "\"themeR\":" + String(tR) + ",";
     json += "\"themeG\":" + String(tG) + ",";
-    json += "\"themeB\":" + String(tB);
+    json += "\"themeB\":" + String(tB) + ",";
+    json += "\"effect\":" + String(ledRgbEffect) + ",";
+    json += "\"engine\":" + getLedRgbEngineJson();
     json += "}";
 
     AsyncWebServerResponse *response = request->beginResponse(200, "application/json", json);
@@ -381,6 +415,10 @@ void setup_ledrgb_webserver(AsyncWebServer* server) {
       ledAudioReactive = request->getParam("audioReactive")->value().toInt();
       if (ledAudioReactive > 2) ledAudioReactive = 0;
     }
+    if (request->hasParam("effect")) {
+      ledRgbEffect = request->getParam("effect")->value().toInt();
+      if (ledRgbEffect >= LED_FX_COUNT) ledRgbEffect = LED_FX_SOLID;
+    }
 
     saveLedRgbSettings();
 
@@ -388,8 +426,8 @@ void setup_ledrgb_webserver(AsyncWebServer* server) {
     response->addHeader("Cache-Control", "no-cache, no-store, must-revalidate");
     response->addHeader("Pragma", "no-cache");
     request->send(response);
-    Serial.printf("[LED RGB] Salvato: enabled=%d, bright=%d, override=%d, R=%d G=%d B=%d, audio=%d\n",
-                  ledRgbEnabled, ledRgbBrightness, ledRgbOverride, ledRgbOverrideR, ledRgbOverrideG, ledRgbOverrideB, ledAudioReactive);
+    Serial.printf("[LED RGB] Salvato: enabled=%d, bright=%d, override=%d, R=%d G=%d B=%d, audio=%d, effect=%d\n",
+                  ledRgbEnabled, ledRgbBrightness, ledRgbOverride, ledRgbOverrideR, ledRgbOverrideG, ledRgbOverrideB, ledAudioReactive, ledRgbEffect);
   });
 
   // Pagina HTML (registrata PER ULTIMA)
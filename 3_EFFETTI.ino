@@ -4182,6 +4182,25 @@ bool loadClockImage() {
     return false;
   }
 
+  return decodeClockSkin(&jpeg, clockActiveSkin);
+}
+
+// Legge la skin dalla SD e la decodifica nel clockBackgroundBuffer con il decoder indicato
+// (decoder globale dal loop, decoder dedicato dal task di preparazione in background)
+bool decodeClockSkin(JPEGDEC *decoder, const char* skinName) {
+  String filepath = "/";
+  filepath += skinName;
+
+  if (clockBackgroundBuffer == nullptr) return false;
+
+  // Skin gia' decodificata in passato: decompressione dalla cache in PSRAM (0_SKIN_CACHE.ino)
+  if (skinCacheFetch(filepath.c_str(), clockBackgroundBuffer)) {
+    strncpy(clockLoadedSkin, skinName, sizeof(clockLoadedSkin) - 1);
+    clockLoadedSkin[sizeof(clockLoadedSkin) - 1] = '\0';
+    return true;
+  }
+
+  uint32_t decodeStart = millis();
   File jpegFile = SD.open(filepath.c_str(), FILE_READ);
 
   if (!jpegFile) {
@@ -4214,7 +4233,7 @@ bool loadClockImage() {
   }
 
   // Decodifica e salva l'immagine JPEG nel buffer
-  int result = jpeg.openRAM(jpegBuffer, fileSize, jpegDrawToBackgroundBuffer);
+  int result = decoder->openRAM(jpegBuffer, fileSize, jpegDrawToBackgroundBuffer);
 
   if (result != 1) {
     Serial.printf("Errore: impossibile aprire JPEG, codice: %d\n", result);
@@ -4223,28 +4242,131 @@ bool loadClockImage() {
   }
 
   // Configura formato pixel RGB565 little-endian
-  jpeg.setPixelType(RGB565_LITTLE_ENDIAN);
+  decoder->setPixelType(RGB565_LITTLE_ENDIAN);
 
   // Decodifica l'immagine
-  jpeg.decode(0, 0, 0); // x, y, flags (0 = no scaling)
-  jpeg.close();
+  decoder->decode(0, 0, 0); // x, y, flags (0 = no scaling)
+  decoder->close();
 
   free(jpegBuffer);
 
-  Serial.println("Immagine orologio.jpg caricata con successo!");
+  skinCacheStore(filepath.c_str(), clockBackgroundBuffer, millis() - decodeStart);
+
+  // Ricorda quale skin contiene il buffer: al prossimo ingresso non serve ridecodificarla
+  strncpy(clockLoadedSkin, skinName, sizeof(clockLoadedSkin) - 1);
+  clockLoadedSkin[sizeof(clockLoadedSkin) - 1] = '\0';
+
+  Serial.printf("Immagine %s caricata con successo!\n", skinName);
   return true;
 }
 
+// Strato statico dell'orologio analogico: sfondo + data + IP, base del ridisegno parziale.
+// Ad ogni tick si ripristina da qui solo il rettangolo delle lancette mosse.
+#define ANALOG_CLOCK_BLIT_MAX_PIXELS (480 * 240)   // Oltre meta' schermo conviene il blit completo
+uint16_t* analogClockStaticLayer = nullptr;
+uint16_t* analogClockBlitBuffer = nullptr;        // Rettangolo sporco compattato per il blit
+bool analogClockStaticValid = false;
+int analogClockStaticDay = -1;
+uint32_t analogClockStaticIp = 0;
+bool analogClockStaticDate = false;
+float analogHandLastAngle[3] = { -1, -1, -1 };
+uint16_t analogHandLastColor[3] = { 0, 0, 0 };
+int16_t analogHandLastRect[3][4] = {};
+
+// Alloca i buffer PSRAM dell'orologio analogico (sfondo + frameBuffer + strato statico)
+bool allocAnalogClockBuffers() {
+  if (clockBackgroundBuffer == nullptr) {
+    clockBackgroundBuffer = (uint16_t*)ps_malloc(CLOCK_BUFFER_SIZE * sizeof(uint16_t));
+    if (clockBackgroundBuffer == nullptr) {
+      Serial.println("[ANALOG CLOCK] ERRORE: Impossibile allocare buffer in PSRAM!");
+    } else {
+      Serial.printf("[ANALOG CLOCK] Buffer allocato in PSRAM: %d KB\n",
+                    (CLOCK_BUFFER_SIZE * sizeof(uint16_t)) / 1024);
+    }
+  }
+
+  if (analogClockFrameBuffer == nullptr) {
+    analogClockFrameBuffer = (uint16_t*)heap_caps_malloc(
+      480 * 480 * sizeof(uint16_t),
+      MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT
+    );
+
+    if (analogClockFrameBuffer == nullptr) {
+      analogClockFrameBuffer = (uint16_t*)ps_malloc(480 * 480 * sizeof(uint16_t));
+      if (analogClockFrameBuffer == nullptr) {
+        Serial.println("[ANALOG CLOCK] ERRORE: Impossibile allocare frameBuffer!");
+        return false;
+      }
+    }
+    Serial.println("[ANALOG CLOCK] FrameBuffer allocato");
+  }
+
+  // Facoltativo: senza strato statico ogni frame viene ricomposto per intero
+  if (analogClockStaticLayer == nullptr) {
+    analogClockStaticLayer = (uint16_t*)ps_malloc(480 * 480 * sizeof(uint16_t));
+    analogClockStaticValid = false;
+  }
+  return true;
+}
+
+// Lo sfondo in PSRAM corrisponde ancora alla skin attiva?
+bool analogClockSkinWarm() {
+  return clockImageLoaded && clockBackgroundBuffer != nullptr &&
+         strcmp(clockLoadedSkin, clockActiveSkin) == 0;
+}
+
+// Preparazione in background (task di 2_MODE_LIFECYCLE): buffer e skin pronti prima dell'ingresso
+bool prepareAnalogClockAssets(JPEGDEC *decoder) {
+  if (analogClockSkinWarm()) return true;
+  if (!allocAnalogClockBuffers() || clockBackgroundBuffer == nullptr) return false;
+
+  // Copia locale del nome: la skin puo' cambiare dal web durante la decodifica
+  char skin[sizeof(clockActiveSkin)];
+  strncpy(skin, clockActiveSkin, sizeof(skin) - 1);
+  skin[sizeof(skin) - 1] = '\0';
+
+  clockImageLoaded = decodeClockSkin(decoder, skin);
+  return clockImageLoaded;
+}
+
+// Rilascio su PSRAM scarsa: buffer liberati, skin ridecodificata al prossimo ingresso
+void releaseAnalogClockAssets() {
+  clockImageLoaded = false;
+  analogClockFrameOnScreen = false;
+  analogClockStaticValid = false;
+  if (analogClockStaticLayer != nullptr) {
+    free(analogClockStaticLayer);
+    analogClockStaticLayer = nullptr;
+  }
+  if (analogClockBlitBuffer != nullptr) {
+    free(analogClockBlitBuffer);
+    analogClockBlitBuffer = nullptr;
+  }
+  clockLoadedSkin[0] = '\0';
+  analogClockInitNeeded = true;
+  if (analogClockOffscreenGfx != nullptr) {
+    delete analogClockOffscreenGfx;
+    analogClockOffscreenGfx = nullptr;
+  }
+  if (analogClockFrameBuffer != nullptr) {
+    free(analogClockFrameBuffer);
+    analogClockFrameBuffer = nullptr;
+  }
+  if (clockBackgroundBuffer != nullptr) {
+    free(clockBackgroundBuffer);
+    clockBackgroundBuffer = nullptr;
+  }
+}
+
 // Forward declarations per le funzioni di disegno lancette
 void fillPolygon4(Arduino_GFX* gfx, int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, int16_t x3, int16_t y3, uint16_t color);
 void drawClockHandOffscreenStyled(Arduino_GFX* targetGfx, int centerX, int centerY, float angle, int length, uint16_t color, int thickness, uint8_t style);
-void drawClockHandOffscreen(Arduino_GFX* targetGfx, int centerX, int centerY, float angle, int length, uint16_t color, int thickness);
+void drawClockHandOffscreen(OffscreenGFX* targetGfx, int centerX, int centerY, float angle, int length, uint16_t color, int thickness);
+uint8_t clockHandStyleFor(int thickness);
 
-// Disegna una lancetta dell'orologio (versione per gfx diretto)
-// Richiama la versione offscreen usando gfx globale
+// Disegna una lancetta dell'orologio (versione per gfx diretto, senza frame buffer)
 void drawClockHand(int centerX, int centerY, float angle, int length, uint16_t color, int thickness) {
-  // Usa la funzione offscreen migliorata passando il gfx globale
-  drawClockHandOffscreen(gfx, centerX, centerY, angle, length, color, thickness);
+  drawClockHandOffscreenStyled(gfx, centerX, centerY, angle, length, color, thickness, clockHandStyleFor(thickness));
 }
 
 // Seleziona il font in base al valore fontSize (1-5)
@@ -4313,45 +4435,6 @@ void drawClockDate() {
   drawDateField(yearStr, clockYearField);        // Anno (es: "2025")
 }
 
-// Cancella una lancetta dell'orologio usando il buffer di sfondo
-void eraseClockHandFromBuffer(int centerX, int centerY, float angle, int length, int thickness) {
-  if (clockBackgroundBuffer == nullptr) return;
-
-  // Calcola la posizione finale della lancetta
-  float angleRad = (angle - 90.0) * PI / 180.0;
-  int endX = centerX + (int)(cos(angleRad) * length);
-  int endY = centerY + (int)(sin(angleRad) * length);
-
-  // Calcola bounding box con margine maggiore per includere il contorno (+2px) e il perno centrale
-  // thickness + 2 (contorno) + 5 (margine sicurezza) = thickness + 7
-  int minX = min(centerX, endX) - thickness - 7;
-  int maxX = max(centerX, endX) + thickness + 7;
-  int minY = min(centerY, endY) - thickness - 7;
-  int maxY = max(centerY, endY) + thickness + 7;
-
-  // Limita ai bordi dello schermo
-  minX = max(0, minX);
-  maxX = min(479, maxX);
-  minY = max(0, minY);
-  maxY = min(479, maxY);
-
-  // Calcola larghezza e altezza dell'area da ripristinare
-  int width = maxX - minX + 1;
-  int height = maxY - minY + 1;
-
-  // Ripristina l'area dal buffer usando draw16bitRGBBitmap per massima velocità
-  // Crea un buffer temporaneo per l'area da copiare
-  if (width > 0 && height > 0 && width <= 480 && height <= 480) {
-    // Copia linea per linea dal buffer al display (più veloce di pixel singoli)
-    for (int y = minY; y <= maxY; y++) {
-      // Puntatore all'inizio della linea nel buffer
-      uint16_t* lineBuffer = &clockBackgroundBuffer[y * 480 + minX];
-      // Disegna l'intera linea in una volta
-      gfx->draw16bitRGBBitmap(minX, y, lineBuffer, width, 1);
-    }
-  }
-}
-
 // ========== FUNZIONI OFFSCREEN PER DOUBLE BUFFERING ==========
 
 // Funzione helper: disegna un poligono pieno (triangolo o quadrilatero)
@@ -4469,22 +4552,18 @@ void drawClockHandOffscreenStyled(Arduino_GFX* targetGfx, int centerX, int cente
   targetGfx->fillCircle(centerX, centerY, pinRadius, color);
 }
 
-// Wrapper per compatibilità - determina automaticamente lo stile dalla larghezza
-void drawClockHandOffscreen(Arduino_GFX* targetGfx, int centerX, int centerY, float angle, int length, uint16_t color, int thickness) {
-  // Determina quale lancetta stiamo disegnando in base allo spessore
-  uint8_t style = 0; // default round
-
-  // Confronta con le variabili globali per determinare il tipo di lancetta
-  if (thickness == (int)clockHourHandWidth) {
-    style = clockHourHandStyle;
-  } else if (thickness == (int)clockMinuteHandWidth) {
-    style = clockMinuteHandStyle;
-  } else if (thickness == (int)clockSecondHandWidth) {
-    style = clockSecondHandStyle;
-  }
+// Determina lo stile della lancetta dalla larghezza (confronto con le variabili globali)
+uint8_t clockHandStyleFor(int thickness) {
+  if (thickness == (int)clockHourHandWidth) return clockHourHandStyle;
+  if (thickness == (int)clockMinuteHandWidth) return clockMinuteHandStyle;
+  if (thickness == (int)clockSecondHandWidth) return clockSecondHandStyle;
+  return 0; // default round
+}
 
-  // Chiama la funzione con stile esplicito
-  drawClockHandOffscreenStyled(targetGfx, centerX, centerY, angle, length, color, thickness, style);
+// Lancetta sul frame buffer offscreen: rasterizzatore antialias di 0_HAND_RASTER.ino
+void drawClockHandOffscreen(OffscreenGFX* targetGfx, int centerX, int centerY, float angle, int length, uint16_t color, int thickness) {
+  drawClockHandAA(targetGfx->getBuffer(), targetGfx->width(), targetGfx->height(), centerX, centerY,
+                  angle, length, color, thickness, clockHandStyleFor(thickness));
 }
 
 // Disegna un singolo campo della data su target GFX offscreen
@@ -4633,6 +4712,7 @@ void checkSDCardStatus() {
       // Invalida l'immagine caricata
       clockImageLoaded = false;
       analogClockInitNeeded = true;
+      analogClockFrameOnScreen = false;
 
     } else {
       // SD CARD REINSERITA!
@@ -4677,6 +4757,7 @@ void checkSDCardStatus() {
           // Forza reinizializzazione orologio
           analogClockInitNeeded = true;
           clockImageLoaded = false;
+          analogClockFrameOnScreen = false;
 
           // Imposta il tempo di reinizializzazione per evitare controlli immediati
           sdReinitTime = millis();
@@ -4704,6 +4785,8 @@ void checkSDCardStatus() {
 
 void updateAnalogClock() {
   static uint8_t lastDisplayedSecond = 255;
+  static uint32_t skinSwitchStart = 0;   // Inizio cambio skin (per /skins/cache)
+  static bool skinSwitchPending = false;
 
   // Controlla periodicamente lo stato della SD Card
   checkSDCardStatus();
@@ -4717,41 +4800,23 @@ void updateAnalogClock() {
   // Inizializzazione
   if (analogClockInitNeeded) {
     Serial.println("[ANALOG CLOCK] Inizializzazione orologio analogico con DOUBLE BUFFERING");
+    skinSwitchStart = millis();
+    analogClockStaticValid = false;   // Skin o configurazione cambiate: strato statico da ricomporre
+
+    // Skin ancora in PSRAM (preparata in background o rimasta dall'ultimo ingresso)?
+    // Prima si attende un'eventuale preparazione in corso: buffer e flag sono suoi fino alla fine
+    modeLifecycleClaim(MODE_ANALOG_CLOCK);
+    bool skinWarm = analogClockSkinWarm();
 
     analogClockInitNeeded = false;
-    clockImageLoaded = false;
+    if (!skinWarm) clockImageLoaded = false;
     lastDisplayedSecond = 255;
     lastSecondAngle = 0;
     lastMinuteAngle = 0;
     lastHourAngle = 0;
 
-    // Alloca buffer in PSRAM per salvare l'immagine di sfondo
-    if (clockBackgroundBuffer == nullptr) {
-      clockBackgroundBuffer = (uint16_t*)ps_malloc(CLOCK_BUFFER_SIZE * sizeof(uint16_t));
-      if (clockBackgroundBuffer == nullptr) {
-        Serial.println("[ANALOG CLOCK] ERRORE: Impossibile allocare buffer in PSRAM!");
-      } else {
-        Serial.printf("[ANALOG CLOCK] Buffer allocato in PSRAM: %d KB\n",
-                      (CLOCK_BUFFER_SIZE * sizeof(uint16_t)) / 1024);
-      }
-    }
-
-    // Alloca frameBuffer per double buffering
-    if (analogClockFrameBuffer == nullptr) {
-      analogClockFrameBuffer = (uint16_t*)heap_caps_malloc(
-        480 * 480 * sizeof(uint16_t),
-        MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT
-      );
-
-      if (analogClockFrameBuffer == nullptr) {
-        analogClockFrameBuffer = (uint16_t*)ps_malloc(480 * 480 * sizeof(uint16_t));
-        if (analogClockFrameBuffer == nullptr) {
-          Serial.println("[ANALOG CLOCK] ERRORE: Impossibile allocare frameBuffer!");
-          return;
-        }
-      }
-      Serial.println("[ANALOG CLOCK] FrameBuffer allocato");
-    }
+    // Alloca buffer in PSRAM (sfondo + frameBuffer per double buffering)
+    if (!allocAnalogClockBuffers()) return;
 
     // Crea GFX offscreen
     if (analogClockOffscreenGfx == nullptr) {
@@ -4759,8 +4824,17 @@ void updateAnalogClock() {
       Serial.println("[ANALOG CLOCK] OffscreenGFX creato");
     }
 
+    // Cambio skin con l'orologio a schermo: salva il frame visualizzato prima di sovrascriverlo,
+    // il primo frame completo (sfondo nuovo + lancette) partira' in dissolvenza da questo
+    bool skinFading = analogClockFrameOnScreen && skinFadeBegin(analogClockFrameBuffer);
+
     // Carica l'immagine di sfondo (carica SOLO nel clockBackgroundBuffer, NON sul display)
-    clockImageLoaded = loadClockImage();
+    if (skinWarm) {
+      loadClockConfig(clockActiveSkin);
+      Serial.printf("[ANALOG CLOCK] Skin '%s' gia' in PSRAM, decodifica saltata\n", clockActiveSkin);
+    } else {
+      clockImageLoaded = loadClockImage();
+    }
 
     // Copia lo sfondo caricato nel frameBuffer
     if (clockImageLoaded && clockBackgroundBuffer != nullptr && analogClockFrameBuffer != nullptr) {
@@ -4802,16 +4876,21 @@ void updateAnalogClock() {
       }
     }
 
-    // Mostra l'immagine iniziale
-    if (analogClockFrameBuffer != nullptr) {
+    // In dissolvenza niente blit netto: lo sfondo nuovo arriva con il primo frame completo
+    if (skinFading) {
+      skinSwitchPending = true;
+      Serial.println("[ANALOG CLOCK] Cambio skin in dissolvenza");
+    } else if (analogClockFrameBuffer != nullptr) {
+      // Mostra l'immagine iniziale
       gfx->draw16bitRGBBitmap((gfx->width()-480)/2, (gfx->height()-480)/2, analogClockFrameBuffer, 480, 480);
+      analogClockFrameOnScreen = true;
     } else {
       gfx->fillScreen(BLACK);
     }
   }
 
-  // Aggiorna le lancette ogni secondo (o continuamente se smooth seconds è attivo)
-  bool needsUpdate = (currentSecond != lastDisplayedSecond) || clockSmoothSeconds;
+  // Aggiorna le lancette ogni secondo (o continuamente se smooth seconds è attivo o durante la dissolvenza)
+  bool needsUpdate = (currentSecond != lastDisplayedSecond) || clockSmoothSeconds || skinFadeActive();
 
   if (needsUpdate) {
     // Aggiorna lastDisplayedSecond solo se cambia
@@ -4825,11 +4904,6 @@ void updateAnalogClock() {
       return;
     }
 
-    // Log solo quando cambia secondo (non continuamente se smooth)
-    if (currentSecond != lastDisplayedSecond || !clockSmoothSeconds) {
-      Serial.println("[ANALOG CLOCK] *** RENDERING OFFSCREEN - INIZIO ***");
-    }
-
     // Calcola angoli delle lancette
     // Ore (0-12): ogni ora = 30 gradi, più frazione per minuti
     float hourAngle = ((currentHour % 12) * 30.0) + (currentMinute * 0.5);
@@ -4867,21 +4941,6 @@ void updateAnalogClock() {
       secondAngle = currentSecond * 6.0;
     }
 
-    // ===== FASE 1: COPIA LO SFONDO NEL FRAMEBUFFER =====
-    if (clockBackgroundBuffer != nullptr) {
-      memcpy(analogClockFrameBuffer, clockBackgroundBuffer, 480 * 480 * sizeof(uint16_t));
-    } else {
-      // Fallback: riempi di nero
-      for (int i = 0; i < 480 * 480; i++) {
-        analogClockFrameBuffer[i] = BLACK;
-      }
-    }
-
-    // ===== FASE 2: DISEGNA TUTTO SUL FRAMEBUFFER =====
-
-    // Disegna la data (se abilitata)
-    drawClockDateOffscreen(analogClockOffscreenGfx);
-
     // Determina i colori delle lancette (rainbow o fissi)
     uint16_t hourColor, minuteColor, secondColor;
 
@@ -4906,64 +4965,175 @@ void updateAnalogClock() {
       secondColor = clockSecondHandColor;
     }
 
-    // Disegna le lancette (dalla più corta alla più lunga)
-    // Usa le variabili globali configurabili dalla pagina web (colore, lunghezza, larghezza)
-    // Lancetta delle ore
-    drawClockHandOffscreen(analogClockOffscreenGfx, CLOCK_CENTER_X, CLOCK_CENTER_Y, hourAngle, clockHourHandLength, hourColor, clockHourHandWidth);
+    // Geometria delle lancette (dalla più corta alla più lunga) e rettangolo di ciascuna
+    const float handAngle[3] = { hourAngle, minuteAngle, secondAngle };
+    const uint16_t handColor[3] = { hourColor, minuteColor, secondColor };
+    const int handLength[3] = { clockHourHandLength, clockMinuteHandLength, clockSecondHandLength };
+    const int handWidth[3] = { clockHourHandWidth, clockMinuteHandWidth, clockSecondHandWidth };
+    int16_t handRect[3][4];
+    for (int h = 0; h < 3; h++) {
+      clockHandBounds(CLOCK_CENTER_X, CLOCK_CENTER_Y, handAngle[h], handLength[h], handWidth[h],
+                      clockHandStyleFor(handWidth[h]), &handRect[h][0], &handRect[h][1], &handRect[h][2], &handRect[h][3]);
+    }
 
-    // Lancetta dei minuti
-    drawClockHandOffscreen(analogClockOffscreenGfx, CLOCK_CENTER_X, CLOCK_CENTER_Y, minuteAngle, clockMinuteHandLength, minuteColor, clockMinuteHandWidth);
+    uint32_t renderStart = micros();
 
-    // Lancetta dei secondi
-    drawClockHandOffscreen(analogClockOffscreenGfx, CLOCK_CENTER_X, CLOCK_CENTER_Y, secondAngle, clockSecondHandLength, secondColor, clockSecondHandWidth);
+    // ===== FASE 1: STRATO STATICO (sfondo + data + IP), ricostruito solo quando cambia =====
+    uint32_t ipShown = (WiFi.status() == WL_CONNECTED) ? (uint32_t)WiFi.localIP() : 0;
+    int today = myTZ.day();
+    if (analogClockStaticValid && (today != analogClockStaticDay || ipShown != analogClockStaticIp ||
+                                   showClockDate != analogClockStaticDate)) {
+      analogClockStaticValid = false;
+    }
 
-    // Mostra indirizzo IP in alto a sinistra (solo se WiFi connesso)
-    if (WiFi.status() == WL_CONNECTED) {
-      // Determina colore testo in base allo sfondo del JPEG
-      uint16_t textColor = WHITE;  // Default bianco
+    bool fullFrame = !analogClockStaticValid || !analogClockFrameOnScreen || skinFadeActive() ||
+                     analogClockStaticLayer == nullptr;
 
+    if (!analogClockStaticValid || analogClockStaticLayer == nullptr) {
       if (clockBackgroundBuffer != nullptr) {
-        // Campiona alcuni pixel nell'area dove verrà mostrato il testo
-        // Calcola luminosità media per decidere se usare bianco o nero
-        uint32_t totalLuminance = 0;
-        int sampleCount = 0;
-
-        // Campiona 10 pixel in orizzontale nell'area del testo
-        for (int x = 5; x < 100; x += 10) {
-          int y = 10;  // Poco sopra il testo
-          if (x >= 0 && x < 480 && y >= 0 && y < 480) {
-            uint16_t pixel = clockBackgroundBuffer[y * 480 + x];
-
-            // Converti RGB565 -> RGB888
-            uint8_t r = ((pixel >> 11) & 0x1F) << 3;  // 5 bit -> 8 bit
-            uint8_t g = ((pixel >> 5) & 0x3F) << 2;   // 6 bit -> 8 bit
-            uint8_t b = (pixel & 0x1F) << 3;          // 5 bit -> 8 bit
-
-            // Calcola luminosità (formula standard)
-            uint8_t luminance = (uint8_t)(0.299 * r + 0.587 * g + 0.114 * b);
-            totalLuminance += luminance;
-            sampleCount++;
-          }
+        memcpy(analogClockFrameBuffer, clockBackgroundBuffer, 480 * 480 * sizeof(uint16_t));
+      } else {
+        // Fallback: riempi di nero
+        for (int i = 0; i < 480 * 480; i++) {
+          analogClockFrameBuffer[i] = BLACK;
         }
+      }
+
+      // Disegna la data (se abilitata)
+      drawClockDateOffscreen(analogClockOffscreenGfx);
+
+      // Mostra indirizzo IP in alto a sinistra (solo se WiFi connesso)
+      if (ipShown) {
+        // Determina colore testo in base allo sfondo del JPEG
+        uint16_t textColor = WHITE;  // Default bianco
+
+        if (clockBackgroundBuffer != nullptr) {
+          // Campiona alcuni pixel nell'area dove verrà mostrato il testo
+          // Calcola luminosità media per decidere se usare bianco o nero
+          uint32_t totalLuminance = 0;
+          int sampleCount = 0;
+
+          // Campiona 10 pixel in orizzontale nell'area del testo
+          for (int x = 5; x < 100; x += 10) {
+            int y = 10;  // Poco sopra il testo
+            if (x >= 0 && x < 480 && y >= 0 && y < 480) {
+              uint16_t pixel = clockBackgroundBuffer[y * 480 + x];
+
+              // Converti RGB565 -> RGB888
+              uint8_t r = ((pixel >> 11) & 0x1F) << 3;  // 5 bit -> 8 bit
+              uint8_t g = ((pixel >> 5) & 0x3F) << 2;   // 6 bit -> 8 bit
+              uint8_t b = (pixel & 0x1F) << 3;          // 5 bit -> 8 bit
+
+              // Calcola luminosità (formula standard)
+              uint8_t luminance = (uint8_t)(0.299 * r + 0.587 * g + 0.114 * b);
+              totalLuminance += luminance;
+              sampleCount++;
+            }
+          }
 
-        // Calcola luminosità media
-        if (sampleCount > 0) {
-          uint8_t avgLuminance = totalLuminance / sampleCount;
+          // Calcola luminosità media
+          if (sampleCount > 0) {
+            uint8_t avgLuminance = totalLuminance / sampleCount;
 
-          // Se lo sfondo è chiaro (luminosità > 128), usa testo nero
-          // Se lo sfondo è scuro, usa testo bianco
-          textColor = (avgLuminance > 128) ? BLACK : WHITE;
+            // Se lo sfondo è chiaro (luminosità > 128), usa testo nero
+            // Se lo sfondo è scuro, usa testo bianco
+            textColor = (avgLuminance > 128) ? BLACK : WHITE;
+          }
         }
+
+        analogClockOffscreenGfx->setFont(u8g2_font_helvR08_tr);  // Font piccolo
+        analogClockOffscreenGfx->setTextColor(textColor);
+        analogClockOffscreenGfx->setCursor(5, 15);  // In alto a sinistra
+        analogClockOffscreenGfx->print(WiFi.localIP().toString() + ":8080/clock");
       }
 
-      analogClockOffscreenGfx->setFont(u8g2_font_helvR08_tr);  // Font piccolo
-      analogClockOffscreenGfx->setTextColor(textColor);
-      analogClockOffscreenGfx->setCursor(5, 15);  // In alto a sinistra
-      analogClockOffscreenGfx->print(WiFi.localIP().toString() + ":8080/clock");
+      if (analogClockStaticLayer != nullptr) {
+        memcpy(analogClockStaticLayer, analogClockFrameBuffer, 480 * 480 * sizeof(uint16_t));
+        analogClockStaticValid = true;
+        analogClockStaticDay = today;
+        analogClockStaticIp = ipShown;
+        analogClockStaticDate = showClockDate;
+      }
+    } else if (fullFrame) {
+      memcpy(analogClockFrameBuffer, analogClockStaticLayer, 480 * 480 * sizeof(uint16_t));
+    }
+
+    // ===== FASE 2: RETTANGOLO SPORCO (lancette mosse: posizione vecchia + nuova) =====
+    int16_t dirtyX0 = 0, dirtyY0 = 0, dirtyX1 = 479, dirtyY1 = 479;
+    if (!fullFrame) {
+      dirtyX0 = 480; dirtyY0 = 480; dirtyX1 = -1; dirtyY1 = -1;
+      for (int h = 0; h < 3; h++) {
+        if (handAngle[h] == analogHandLastAngle[h] && handColor[h] == analogHandLastColor[h] &&
+            memcmp(handRect[h], analogHandLastRect[h], sizeof(handRect[h])) == 0) continue;
+        const int16_t* was = analogHandLastRect[h];
+        const int16_t* now = handRect[h];
+        dirtyX0 = min(dirtyX0, min(was[0], now[0]));
+        dirtyY0 = min(dirtyY0, min(was[1], now[1]));
+        dirtyX1 = max(dirtyX1, max(was[2], now[2]));
+        dirtyY1 = max(dirtyY1, max(was[3], now[3]));
+      }
+      dirtyX0 = max((int16_t)0, dirtyX0);
+      dirtyY0 = max((int16_t)0, dirtyY0);
+      dirtyX1 = min((int16_t)479, dirtyX1);
+      dirtyY1 = min((int16_t)479, dirtyY1);
+
+      // Ripristina dallo strato statico solo il rettangolo sporco
+      int16_t w = dirtyX1 - dirtyX0 + 1;
+      for (int16_t y = dirtyY0; y <= dirtyY1 && w > 0; y++) {
+        memcpy(&analogClockFrameBuffer[y * 480 + dirtyX0], &analogClockStaticLayer[y * 480 + dirtyX0], w * sizeof(uint16_t));
+      }
+    }
+
+    // ===== FASE 3: LANCETTE ANTIALIAS SUL FRAMEBUFFER (limitate al rettangolo sporco) =====
+    if (dirtyX0 <= dirtyX1 && dirtyY0 <= dirtyY1) {
+      handRasterSetClip(dirtyX0, dirtyY0, dirtyX1, dirtyY1);
+      for (int h = 0; h < 3; h++) {
+        drawClockHandOffscreen(analogClockOffscreenGfx, CLOCK_CENTER_X, CLOCK_CENTER_Y, handAngle[h], handLength[h], handColor[h], handWidth[h]);
+      }
+      handRasterClearClip();
+    }
+    for (int h = 0; h < 3; h++) {
+      analogHandLastAngle[h] = handAngle[h];
+      analogHandLastColor[h] = handColor[h];
+      memcpy(analogHandLastRect[h], handRect[h], sizeof(handRect[h]));
+    }
+
+    // Dissolvenza dalla skin precedente (un passo per frame, nessuna attesa)
+    skinFadeApply(analogClockFrameBuffer);
+
+    // ===== FASE 4: UN SOLO BLIT (frame intero o rettangolo sporco) =====
+    int16_t offX = (gfx->width() - 480) / 2;
+    int16_t offY = (gfx->height() - 480) / 2;
+    int32_t dirtyW = dirtyX1 - dirtyX0 + 1;
+    int32_t dirtyH = dirtyY1 - dirtyY0 + 1;
+    if (fullFrame || dirtyW * dirtyH > ANALOG_CLOCK_BLIT_MAX_PIXELS) {
+      gfx->draw16bitRGBBitmap(offX, offY, analogClockFrameBuffer, 480, 480);
+      dirtyW = dirtyH = 480;
+    } else if (dirtyW > 0 && dirtyH > 0) {
+      if (analogClockBlitBuffer == nullptr) {
+        analogClockBlitBuffer = (uint16_t*)ps_malloc(ANALOG_CLOCK_BLIT_MAX_PIXELS * sizeof(uint16_t));
+      }
+      if (analogClockBlitBuffer != nullptr) {
+        // Righe del rettangolo compattate per un'unica chiamata al display
+        for (int32_t row = 0; row < dirtyH; row++) {
+          memcpy(&analogClockBlitBuffer[row * dirtyW], &analogClockFrameBuffer[(dirtyY0 + row) * 480 + dirtyX0], dirtyW * sizeof(uint16_t));
+        }
+        gfx->draw16bitRGBBitmap(offX + dirtyX0, offY + dirtyY0, analogClockBlitBuffer, dirtyW, dirtyH);
+      } else {
+        gfx->draw16bitRGBBitmap(offX, offY, analogClockFrameBuffer, 480, 480);
+        dirtyW = dirtyH = 480;
+      }
+    }
+    analogClockFrameOnScreen = true;
+    if (skinSwitchPending) {
+      skinSwitchPending = false;
+      skinFadeNoteSwitch(skinSwitchStart);
     }
 
-    // ===== FASE 3: TRASFERISCI TUTTO AL DISPLAY IN UN COLPO SOLO =====
-    gfx->draw16bitRGBBitmap((gfx->width()-480)/2, (gfx->height()-480)/2, analogClockFrameBuffer, 480, 480);
+    if (!clockSmoothSeconds) {
+      Serial.printf("[ANALOG CLOCK] Frame %s: %ldx%ld px in %lu us\n", fullFrame ? "completo" : "parziale",
+                    (long)max((int32_t)0, dirtyW), (long)max((int32_t)0, dirtyH), (unsigned long)(micros() - renderStart));
+    }
 
     // Salva gli angoli correnti per il prossimo aggiornamento
     lastHourAngle = hourAngle;
@@ -4973,12 +5143,12 @@ void updateAnalogClock() {
 
   // Gestione touch per attivare/disattivare la data
   // Tocca la parte bassa dello schermo per toggle della data
-  ts.read(); // Legge lo stato del touch screen
+  touchRead(); // Legge lo stato del touch screen
 
-  if (ts.isTouched) {
+  if (touchState.isTouched) {
     // Mappa le coordinate del primo punto di contatto
-    int x = map(ts.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
-    int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
+    int x = map(touchState.points[0].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
+    int y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
 
     // Area touch per toggle data: parte inferiore dello schermo (sotto y=360)
     if (y > 360) {
@@ -4987,7 +5157,7 @@ void updateAnalogClock() {
 
       // Salva in EEPROM
       EEPROM.write(EEPROM_CLOCK_DATE_ADDR, showClockDate ? 1 : 0);
-      EEPROM.commit();
+      settingsCommit();
 
       Serial.printf("[ANALOG CLOCK] Data %s\n", showClockDate ? "ABILITATA" : "DISABILITATA");
 
@@ -4997,8 +5167,8 @@ void updateAnalogClock() {
       // Aspetta il rilascio del touch
       do {
         delay(10);
-        ts.read();
-      } while (ts.isTouched);
+        touchRead();
+      } while (touchState.isTouched);
 
       delay(200); // Debounce
     }
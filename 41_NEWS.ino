@@ -782,4 +782,68 @@ bool newsIsSourcePillTapped(int tx, int ty) {
           ty >= SOURCE_PILL_Y - 10 && ty <= SOURCE_PILL_Y + SOURCE_PILL_H + 10);
 }
 
+// ===== Touch a eventi (1_TOUCH_INPUT.ino) =====
+// TAP: MODE>>, angolo alto-sx (cambio modo), pill fonte, tab categorie, articolo.
+// Trascinamento verticale nell'area articoli: 1 articolo ogni 40px (solo con piu' di 4).
+
+static int16_t newsDragY = -1;   // Ultimo punto di scroll, -1 = trascinamento fuori dagli articoli
+
+void handleNewsTouchEvent(const TouchEvent &ev) {
+  switch (ev.type) {
+    case TOUCH_EV_TAP: {
+      int x = ev.x, y = ev.y;
+      if ((y > 455 && x >= 180 && x <= 310) || (x < 60 && y < 50)) {
+        playTouchSound();
+        handleModeChange();
+        return;
+      }
+      if (newsIsSourcePillTapped(x, y)) {
+        playTouchSound();
+        newsNextSource();
+        return;
+      }
+      int tappedTab = newsGetTappedTab(x, y);
+      if (tappedTab >= 0) {
+        playTouchSound();
+        newsSetCategory(tappedTab);
+        return;
+      }
+      if (newsArticleCount > 0 && y >= newsGetArticlesStartY() && y <= 440) {
+        int article = newsGetTappedArticle(y);
+        if (article >= 0) {
+          playTouchSound();
+          newsOpenArticle(article);
+        }
+      }
+      return;
+    }
+
+    case TOUCH_EV_DRAG_START: {
+      int y0 = ev.y - ev.dy;   // Punto di partenza del dito
+      newsDragY = (newsArticleCount > 4 && y0 >= newsGetArticlesStartY() && y0 <= 440) ? y0 : -1;
+      // Prosegue come DRAG_MOVE: i primi pixel del trascinamento contano gia'
+    }
+    // fall through
+    case TOUCH_EV_DRAG_MOVE: {
+      if (newsDragY < 0) return;
+      int deltaY = newsDragY - ev.y;
+      if (deltaY >= 40) {
+        newsScrollDown();   // Dito sale = articoli successivi
+        newsDragY = ev.y;
+      } else if (deltaY <= -40) {
+        newsScrollUp();     // Dito scende = articoli precedenti
+        newsDragY = ev.y;
+      }
+      return;
+    }
+
+    case TOUCH_EV_DRAG_END:
+      newsDragY = -1;
+      return;
+
+    default:
+      return;
+  }
+}
+
 #endif // EFFECT_NEWS
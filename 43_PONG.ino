@@ -582,6 +582,34 @@ void handlePongTouch(int x, int y) {
   #endif
 }
 
+// ===== Touch a eventi (1_TOUCH_INPUT.ino) =====
+// PRESS: angolo alto-sx = cambio modo, fascia alta = velocita', altrove racchetta.
+// Trascinamento: la racchetta segue il dito. Slave dual display: tutto inoltrato al master.
+void handlePongTouchEvent(const TouchEvent &ev) {
+  if (ev.type != TOUCH_EV_PRESS && ev.type != TOUCH_EV_DRAG_START && ev.type != TOUCH_EV_DRAG_MOVE) return;
+
+  #ifdef EFFECT_DUAL_DISPLAY
+  if (isDualSlave()) {
+    forwardTouchToMaster(ev.x, ev.y, 0);   // Racchetta destra
+    return;
+  }
+  #endif
+
+  if (ev.type == TOUCH_EV_PRESS) {
+    if (ev.x < 80 && ev.y < 80) {
+      playTouchSound();
+      handleModeChange();
+      return;
+    }
+    if (ev.y < 50) {
+      playTouchSound();
+      handlePongSpeedChange();
+      return;
+    }
+  }
+  handlePongTouch(ev.x, ev.y);
+}
+
 void handlePongRemoteTouch(int vy) {
   pongRemotePaddleY = vy;
 
@@ -25,23 +25,8 @@
 
 #include <esp_now.h>
 
-// ===== EEPROM addresses (908-932) =====
-#define EEPROM_DUAL_ENABLED       908
-#define EEPROM_DUAL_PANEL_X       909
-#define EEPROM_DUAL_PANEL_Y       910
-#define EEPROM_DUAL_GRID_W        911
-#define EEPROM_DUAL_GRID_H        912
-#define EEPROM_DUAL_ROLE          913
-#define EEPROM_DUAL_PEER1_MAC     914  // 6 bytes (914-919)
-#define EEPROM_DUAL_PEER2_MAC     920  // 6 bytes (920-925)
-#define EEPROM_DUAL_PEER3_MAC     926  // 6 bytes (926-931)
-#define EEPROM_DUAL_MARKER        932
-#define EEPROM_DUAL_MARKER_VALUE  0xDD
-
-// ===== EEPROM per-mode dual display mask (943-948) =====
-#define EEPROM_DUAL_MODES_MASK_ADDR   943  // 5 bytes (943-947) = 40 bit per i modi 0-39
-#define EEPROM_DUAL_MODES_MARKER_ADDR 948  // Marker 0xDE
-#define EEPROM_DUAL_MODES_MARKER_VALUE 0xDE
+// Indirizzi EEPROM (908-932, maschera modi 943-948) in oraQuadra_Nano_Ver_1.5.ino:
+// servono anche alla tabella schema di 0_SETTINGS_STORE.ino
 
 // ===== Costanti protocollo =====
 #define DUAL_MAGIC               0xDC  // "Dual Clock"
@@ -61,6 +46,9 @@
 #define PKT_CONFIG_PUSH      6  // Il master invia configurazione allo slave
 #define PKT_MODE_CONFIG      7  // Sync config mode-specific (chunked, master->slave)
 #define PKT_JOYSTICK         8  // Input da joystick controller ESP-NOW
+#define PKT_FRAME_SYNC       9  // Sync compatto v2: header per-frame + blocchi opzionali (master->slave)
+#define PKT_TIME_PING       10  // Stima offset orologio: slave->master (t1)
+#define PKT_TIME_PONG       11  // Risposta master->slave (t1, t2, t3)
 #define ROLE_JOYSTICK        3  // Ruolo joystick nel discovery
 
 // ===== Config ID per PKT_MODE_CONFIG =====
@@ -71,6 +59,8 @@ static const uint8_t broadcastMAC[6] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
 
 // ===== Struttura pacchetto di sincronizzazione =====
 // Dimensione max ESP-NOW: 250 bytes
+// Formato v1 in aria (PKT_STATE_SYNC, ancora accettato dagli slave); internamente
+// e' lo stato completo che sendSyncPacket() riempie e processSyncPacket() applica
 struct SyncPacket {
   uint8_t  magic;           // 0xDC per "Dual Clock"
   uint8_t  packetType;      // Tipo pacchetto (vedi costanti PKT_*)
@@ -107,6 +97,125 @@ struct SyncPacket {
   uint8_t  data[200];       // Dati mode-specific
 };
 
+// ===== Protocollo sync v2 (PKT_FRAME_SYNC) =====
+// Il SyncPacket completo (~40 byte + dati) ripete ad ogni frame 16 byte di
+// impostazioni che non cambiano quasi mai. Il v2 invia:
+//   FrameSyncHeader (sempre, 20 byte)
+//   + SyncSettingsBlock (solo se le impostazioni cambiano o nei keyframe)
+//   + dati mode-specific (solo se diversi dal frame precedente o nei keyframe)
+// Un keyframe completo ogni DUAL_KEYFRAME_INTERVAL frame recupera gli slave
+// che hanno perso pacchetti. Con 2+ slave si usa UN broadcast invece di N unicast
+// (il broadcast non ha ACK/retry: la perdita si recupera col keyframe).
+#define DUAL_PROTO_VERSION       3     // v3: presentUs nell'header
+#define DUAL_KEYFRAME_INTERVAL   30    // 1 keyframe al secondo @ 30fps
+#define DUAL_RX_REORDER_WINDOW   8     // Frame indietro ancora trattati come riordino (scartati)
+#define DUAL_RX_RESYNC_MS        3000  // Silenzio oltre il quale la sequenza si riaggancia al primo frame
+#define SYNC_FLAG_KEYFRAME       0x01
+#define SYNC_FLAG_SETTINGS       0x02  // segue SyncSettingsBlock
+#define SYNC_FLAG_MODEDATA       0x04  // seguono dataLen byte di dati mode-specific
+
+struct __attribute__((packed)) FrameSyncHeader {
+  uint8_t  magic;           // 0xDC
+  uint8_t  packetType;      // PKT_FRAME_SYNC
+  uint8_t  version;         // DUAL_PROTO_VERSION
+  uint8_t  flags;           // SYNC_FLAG_*
+  uint16_t seq;             // Numero di sequenza (rilevamento perdite)
+  uint16_t frameCounter;    // Contatore frame animazioni
+  uint8_t  mode;            // currentMode (bit 7 = bypass dual)
+  uint8_t  hours;
+  uint8_t  minutes;
+  uint8_t  seconds;
+  uint8_t  colorR;
+  uint8_t  colorG;
+  uint8_t  colorB;
+  uint8_t  brightness;
+  uint8_t  preset;
+  uint8_t  rainbowEnabled;
+  uint8_t  settingsVersion; // Incrementato ad ogni cambio impostazioni
+  uint8_t  dataLen;         // Byte di dati mode-specific in coda (se SYNC_FLAG_MODEDATA)
+  uint32_t presentUs;       // Istante di presentazione (orologio master, us, 32 bit bassi)
+};
+
+// ===== Sincronizzazione orologi (stile NTP su ESP-NOW) =====
+// Lo slave invia PING con t1 (suo orologio), il master risponde con t2 (ricezione)
+// e t3 (invio), lo slave registra t4 all'arrivo:
+//   offset = ((t2 - t1) + (t3 - t4)) / 2     (master - slave)
+//   rtt    = (t4 - t1) - (t3 - t2)
+// I campioni con rtt molto sopra il minimo recente (code WiFi) vengono scartati.
+// Il master timbra ogni frame con presentUs = ora + anticipo; gli slave applicano
+// il frame quando il loro orologio condiviso raggiunge presentUs, invece che
+// all'arrivo, e riportano al master il ritardo di presentazione misurato.
+#define DUAL_PING_INTERVAL_FAST   200     // ms, finche' l'orologio non e' agganciato
+#define DUAL_PING_INTERVAL        1000    // ms, a regime
+#define DUAL_PRESENT_LEAD_MIN_US  1500    // anticipo minimo presentazione
+#define DUAL_PRESENT_LEAD_MAX_US  25000   // oltre: meglio presentare in ritardo
+#define DUAL_CLOCK_SYNC_SAMPLES   4       // campioni validi prima di considerare l'orologio agganciato
+
+struct __attribute__((packed)) TimeSyncPacket {
+  uint8_t  magic;        // 0xDC
+  uint8_t  packetType;   // PKT_TIME_PING / PKT_TIME_PONG
+  uint8_t  seq;
+  int64_t  t1;           // Invio ping (orologio slave)
+  int64_t  t2;           // Ricezione ping (orologio master)
+  int64_t  t3;           // Invio pong (orologio master)
+  int32_t  presentErrUs; // Slave: errore medio di presentazione (applicazione - presentUs)
+  uint32_t oneWayUs;     // Slave: stima latenza master->slave (rtt/2)
+};
+
+struct DualClockState {
+  int64_t  offsetUs;       // master - locale
+  uint32_t rttUs;          // ultimo rtt accettato
+  uint32_t rttMinUs;       // minimo recente (decade lentamente)
+  uint32_t jitterUs;       // EMA |campione - stima|
+  uint16_t samples;        // campioni accettati
+  uint16_t rejected;       // campioni scartati (rtt troppo alto)
+  int32_t  presentErrUs;   // EMA (istante applicazione - presentUs), lato slave
+  uint32_t presentLateCnt; // frame applicati oltre 1 frame di ritardo
+};
+DualClockState dualClock = {0};
+
+// Lato master: ultimo report di ogni slave (errore presentazione e latenza)
+int32_t  peerPresentErrUs[3] = {0};
+uint32_t peerOneWayUs[3]     = {0};
+uint32_t dualPresentLeadUs   = DUAL_PRESENT_LEAD_MIN_US;
+
+// Stessi campi (e stesso ordine) di SyncPacket da brightnessDay a ledAudioReact
+struct __attribute__((packed)) SyncSettingsBlock {
+  uint8_t  brightnessDay;
+  uint8_t  brightnessNight;
+  uint8_t  volumeDay;
+  uint8_t  volumeNight;
+  uint8_t  enabledMask[5];
+  uint8_t  ledEnabled;
+  uint8_t  ledBrightness;
+  uint8_t  ledOverride;
+  uint8_t  ledOverR;
+  uint8_t  ledOverG;
+  uint8_t  ledOverB;
+  uint8_t  ledAudioReact;
+};
+
+// Statistiche protocollo (esposte in getDualDisplayStatusJson)
+struct DualSyncStats {
+  uint32_t txPackets;         // Pacchetti sync inviati (totale)
+  uint32_t txBytes;           // Byte payload sync inviati (totale)
+  uint32_t txKeyframes;
+  uint32_t txSettingsBlocks;
+  uint32_t rxPackets;
+  uint32_t rxLost;            // Pacchetti persi (buchi nella sequenza)
+  uint32_t rxStale;           // Pacchetti arrivati fuori ordine (piu' vecchi dell'ultimo) e scartati
+  uint32_t rxResyncs;         // Sequenza riagganciata (riavvio master, keyframe all'indietro, silenzio)
+  uint32_t recoveries;        // Recuperi completati (keyframe dopo una perdita)
+  uint32_t recoveryMsTotal;
+  uint32_t recoveryMsMax;
+  // Finestra di 1 secondo (aggiornata in updateDualDisplay)
+  uint32_t bytesPerSec;
+  uint32_t packetsPerSec;
+  uint32_t airtimeUsPerSec;   // Stima tempo radio occupato
+};
+DualSyncStats dualSyncStats = {0};
+uint32_t dualAirtimeUsAccum = 0;  // Airtime accumulato nella finestra corrente
+
 // ===== Struttura pacchetto touch =====
 struct TouchPacket {
   uint8_t  magic;       // 0xDC
@@ -188,6 +297,60 @@ SyncPacket lastReceivedSync;
 volatile bool newSyncAvailable = false; // Flag: nuovo pacchetto sync da processare (volatile: scritto da callback WiFi)
 portMUX_TYPE syncMux = portMUX_INITIALIZER_UNLOCKED; // Mutex per proteggere lastReceivedSync da race condition
 
+// Stato protocollo v2 - lato master
+// In struct (non globali sparse): encodeFrameSync()/decodeFrameSyncInto() lavorano su qualsiasi stato
+struct DualTxState {
+  uint16_t seq;                    // Sequenza prossimo pacchetto
+  uint8_t  settingsVersion;        // Versione impostazioni corrente
+  SyncSettingsBlock lastSettings;  // Ultime impostazioni inviate
+  uint8_t  lastData[200];          // Ultimi dati mode-specific inviati
+  uint8_t  lastDataLen;
+  bool     forceKeyframe;          // Prossimo pacchetto keyframe (primo, nuovo peer, reinit)
+};
+DualTxState dualTx = { 0, 0, {}, {}, 0, true };
+bool     dualUseBroadcast = false;       // true se l'ultimo sync e' andato in broadcast
+
+// Stato protocollo v2 - lato slave (scritto dalla callback WiFi sotto syncMux)
+struct DualRxState {
+  SyncSettingsBlock settings;      // Ultime impostazioni ricevute dal master
+  bool     settingsValid;          // false finche' non arriva un blocco impostazioni
+  uint16_t expectedSeq;
+  bool     seqValid;
+  unsigned long lossStart;         // 0 = nessuna perdita in attesa di recupero
+  unsigned long lastRxMs;          // Ultimo frame accettato (riaggancio dopo DUAL_RX_RESYNC_MS)
+};
+DualRxState dualRx = {};
+uint32_t dualRxPresentUs = 0;            // presentUs del sync in attesa in lastReceivedSync
+
+// Presentazione schedulata senza attese attive: se presentUs non e' ancora arrivato
+// il loop prosegue e un esp_timer one-shot lo risveglia (frameGovKick) all'istante
+// giusto. Il master trattiene il ridisegno del proprio modo fino allo stesso presentUs.
+esp_timer_handle_t dualPresentTimer = nullptr;
+uint32_t dualPresentArmedUs = 0;         // presentUs per cui il timer e' armato
+bool     dualPresentPending = false;     // Master: frame inviato non ancora presentato
+uint32_t dualPendingPresentUs = 0;
+
+// ===== Trasporto pacchetti =====
+// Tutti gli invii del dual display passano da dualSend(): ESP-NOW in produzione,
+// canale simulato nel test host (tests/host/dual_display.cpp: master e 3 slave con
+// latenza/perdita/riordino). In ricezione ogni trasporto chiama
+// onDualDataRecv()/onDualDataSent(), che restano l'unico ingresso della macchina a stati.
+struct DualTransport {
+  const char *name;
+  esp_err_t (*send)(const uint8_t *mac, const uint8_t *data, size_t len);
+};
+
+static esp_err_t dualEspNowSend(const uint8_t *mac, const uint8_t *data, size_t len) {
+  return esp_now_send(mac, data, len);
+}
+
+DualTransport dualEspNowTransport = { "espnow", dualEspNowSend };
+DualTransport *dualTransport = &dualEspNowTransport;
+
+static inline esp_err_t dualSend(const uint8_t *mac, const void *data, size_t len) {
+  return dualTransport->send(mac, (const uint8_t*)data, len);
+}
+
 // ===== Forward declarations (necessarie per Arduino IDE) =====
 // Coordinate virtuali
 void vDrawHLine(int vx, int vy, int w, uint16_t color);
@@ -206,6 +369,16 @@ void scanForPanels();
 static void sendDiscoveryBroadcast();
 // Sincronizzazione
 void sendSyncPacket();
+void transmitFrameSync(const SyncPacket &pkt);
+size_t encodeFrameSync(DualTxState &tx, const SyncPacket &pkt, uint8_t *buf, uint32_t presentUs, DualSyncStats &st);
+void decodeFrameSync(const uint8_t *mac_addr, const uint8_t *incomingData, int len);
+bool decodeFrameSyncInto(DualRxState &rx, const uint8_t *data, int len, SyncPacket &out,
+                         uint32_t &presentUs, bool keepPendingData, unsigned long nowMs, DualSyncStats &st);
+int64_t dualSharedTimeUs();
+void sendTimePing();
+void handleTimePing(const uint8_t *mac_addr, const uint8_t *incomingData, int len, int64_t rxUs);
+void handleTimePong(const uint8_t *incomingData, int len, int64_t rxUs);
+String getDualSyncStatsJson();
 void processSyncPacket(SyncPacket &pkt);
 void sendHeartbeat();
 void packModeSpecificData(SyncPacket &pkt);
@@ -347,19 +520,12 @@ void saveDualModesMask() {
     EEPROM.write(EEPROM_DUAL_MODES_MASK_ADDR + i, (uint8_t)(dualModesMask >> (i * 8)));
   }
   EEPROM.write(EEPROM_DUAL_MODES_MARKER_ADDR, EEPROM_DUAL_MODES_MARKER_VALUE);
-  EEPROM.commit();
+  settingsCommit();
   Serial.printf("[DUAL] Salvata dualModesMask: 0x%010llX\n", dualModesMask);
 }
 
-// Carica dualModesMask da EEPROM (5 bytes + marker check)
+// Carica dualModesMask da EEPROM (5 bytes, default tutti abilitati dalla tabella schema)
 void loadDualModesMask() {
-  if (EEPROM.read(EEPROM_DUAL_MODES_MARKER_ADDR) != EEPROM_DUAL_MODES_MARKER_VALUE) {
-    // Prima volta: scrivi il default in EEPROM per evitare dati sporchi
-    dualModesMask = 0xFFFFFFFFFFULL;
-    saveDualModesMask();
-    Serial.println("[DUAL] dualModesMask: primo avvio, scritto default tutti abilitati");
-    return;
-  }
   dualModesMask = 0;
   for (int i = 0; i < 5; i++) {
     dualModesMask |= ((uint64_t)EEPROM.read(EEPROM_DUAL_MODES_MASK_ADDR + i)) << (i * 8);
@@ -881,7 +1047,17 @@ void onDualDataSent(const uint8_t *mac_addr, esp_now_send_status_t status) {
 
 // ===== Callback ricezione dati ESP-NOW =====
 // Gestisce tutti i tipi di pacchetto ricevuti
+static void dualHandlePacket(const uint8_t *mac_addr, const uint8_t *incomingData, int len, int64_t rxUs);
+
 void onDualDataRecv(const uint8_t *mac_addr, const uint8_t *incomingData, int len) {
+  // Timestamp di ricezione il prima possibile (usato dalla sync orologi)
+  int64_t rxUs = esp_timer_get_time();
+  dualHandlePacket(mac_addr, incomingData, len, rxUs);
+  frameGovKick();   // Stato/orario dal peer applicato: il loop ridisegna subito
+}
+
+static void dualHandlePacket(const uint8_t *mac_addr, const uint8_t *incomingData, int len, int64_t rxUs) {
+
   // Verifica dimensione minima (almeno magic + packetType)
   if (len < 2) return;
 
@@ -899,6 +1075,7 @@ void onDualDataRecv(const uint8_t *mac_addr, const uint8_t *incomingData, int le
 
       portENTER_CRITICAL(&syncMux);
       memcpy(&lastReceivedSync, incomingData, min((size_t)len, sizeof(SyncPacket)));
+      dualRxPresentUs = 0;  // Formato legacy: nessun istante di presentazione, applica subito
       newSyncAvailable = true;
       portEXIT_CRITICAL(&syncMux);
 
@@ -911,6 +1088,26 @@ void onDualDataRecv(const uint8_t *mac_addr, const uint8_t *incomingData, int le
       break;
     }
 
+    // --- Sync compatto v2 (slave riceve dal master, unicast o broadcast) ---
+    case PKT_FRAME_SYNC: {
+      if (panelRole != 2) return;
+      decodeFrameSync(mac_addr, incomingData, len);
+      break;
+    }
+
+    // --- Sync orologi: il master risponde ai ping, lo slave elabora i pong ---
+    case PKT_TIME_PING: {
+      if (panelRole != 1) return;
+      handleTimePing(mac_addr, incomingData, len, rxUs);
+      break;
+    }
+    case PKT_TIME_PONG: {
+      if (panelRole != 2) return;
+      if (findPeerIndex(mac_addr) != 0) return;  // Solo dal proprio master
+      handleTimePong(incomingData, len, rxUs);
+      break;
+    }
+
     // --- Heartbeat (entrambe le direzioni) ---
     case PKT_HEARTBEAT: {
       int idx = findPeerIndex(mac_addr);
@@ -980,7 +1177,7 @@ void onDualDataRecv(const uint8_t *mac_addr, const uint8_t *incomingData, int le
       Serial.printf("[DUAL] Assegnata posizione (%d,%d) a %s\n",
                     resp.assignedX, resp.assignedY, macToString(mac_addr).c_str());
 
-      esp_now_send(mac_addr, (uint8_t*)&resp, sizeof(resp));
+      dualSend(mac_addr, &resp, sizeof(resp));
       break;
     }
 
@@ -1084,7 +1281,7 @@ void onDualDataRecv(const uint8_t *mac_addr, const uint8_t *incomingData, int le
         jResp.gridW      = gridW;
         jResp.gridH      = gridH;
         WiFi.macAddress(jResp.mac);
-        esp_now_send(mac_addr, (uint8_t*)&jResp, sizeof(jResp));
+        dualSend(mac_addr, &jResp, sizeof(jResp));
 
         // Salva MAC del joystick
         memcpy(joystickMAC, mac_addr, 6);
@@ -1142,7 +1339,7 @@ void onDualDataRecv(const uint8_t *mac_addr, const uint8_t *incomingData, int le
       Serial.printf("[DUAL] Discovery response: posizione (%d,%d) per %s\n",
                     resp.assignedX, resp.assignedY, macToString(mac_addr).c_str());
 
-      esp_now_send(mac_addr, (uint8_t*)&resp, sizeof(resp));
+      dualSend(mac_addr, &resp, sizeof(resp));
       break;
     }
 
@@ -1288,6 +1485,7 @@ void addPeerPanel(const uint8_t* mac) {
 
   // Copia MAC nell'array
   memcpy(peerMACs[peerCount], mac, 6);
+  dualTx.forceKeyframe = true;  // Il nuovo pannello riceve subito impostazioni e dati completi
 
   // Inizializza stato peer
   peerStates[peerCount].active = true;
@@ -1392,7 +1590,7 @@ static void sendDiscoveryBroadcast() {
   pkt.gridH      = gridH;
   WiFi.macAddress(pkt.mac);
 
-  esp_err_t result = esp_now_send(broadcastMAC, (uint8_t*)&pkt, sizeof(pkt));
+  esp_err_t result = dualSend(broadcastMAC, &pkt, sizeof(pkt));
   if (result == ESP_OK) {
     Serial.println("[DUAL] Discovery broadcast inviato");
   } else {
@@ -1471,16 +1669,344 @@ void sendSyncPacket() {
     pkt.mode |= 0x80;
   }
 
-  // Calcola la dimensione effettiva del pacchetto (senza i byte data[] non usati)
-  size_t pktSize = sizeof(SyncPacket) - 200 + pkt.dataLen;
+  // Codifica v2 (header + blocchi solo se cambiati) e invio
+  transmitFrameSync(pkt);
+
+  // Incrementa il frame counter
+  dualFrameCounter++;
+}
+
+// ===== Stima tempo radio di un pacchetto ESP-NOW =====
+// 1 Mbps (rate default ESP-NOW): preambolo lungo 192us + header MAC/vendor (~43 byte)
+// + payload; gli unicast aggiungono l'ACK (~304us con SIFS)
+static uint32_t espNowAirtimeUs(size_t payloadLen, bool unicast) {
+  uint32_t us = 192 + (uint32_t)(payloadLen + 43) * 8;
+  if (unicast) us += 304;
+  return us;
+}
+
+// ===== Ritardo di coda degli unicast =====
+// Gli unicast partono uno dopo l'altro: l'ultimo slave riceve il frame
+// (n-1) slot radio dopo il primo. Va sommato all'anticipo di presentazione
+// (le latenze misurate dai ping non lo vedono: il ping viaggia da solo).
+static uint32_t dualUnicastQueueUs(int receivers, uint8_t dataLen) {
+  if (receivers <= 1) return 0;
+  return espNowAirtimeUs(sizeof(FrameSyncHeader) + sizeof(SyncSettingsBlock) + dataLen, true) * (receivers - 1);
+}
+
+// ===== Codifica un frame sync v2 =====
+// Header sempre, blocco impostazioni e dati mode-specific solo se cambiati
+// (o keyframe). Aggiorna lo stato delta di 'tx'; ritorna la lunghezza in 'buf'
+// (almeno sizeof(FrameSyncHeader) + sizeof(SyncSettingsBlock) + 200 byte).
+size_t encodeFrameSync(DualTxState &tx, const SyncPacket &pkt, uint8_t *buf, uint32_t presentUs, DualSyncStats &st) {
+  FrameSyncHeader *hdr = (FrameSyncHeader*)buf;
+
+  SyncSettingsBlock settings;
+  memcpy(&settings, &pkt.brightnessDay, sizeof(SyncSettingsBlock));
+
+  bool keyframe = tx.forceKeyframe || (tx.seq % DUAL_KEYFRAME_INTERVAL) == 0;
+  bool settingsChanged = memcmp(&settings, &tx.lastSettings, sizeof(SyncSettingsBlock)) != 0;
+  if (settingsChanged) {
+    tx.settingsVersion++;
+    memcpy(&tx.lastSettings, &settings, sizeof(SyncSettingsBlock));
+  }
+  bool dataChanged = pkt.dataLen != tx.lastDataLen ||
+                     memcmp(pkt.data, tx.lastData, pkt.dataLen) != 0;
+  if (dataChanged) {
+    memcpy(tx.lastData, pkt.data, pkt.dataLen);
+    tx.lastDataLen = pkt.dataLen;
+  }
+
+  hdr->magic           = DUAL_MAGIC;
+  hdr->packetType      = PKT_FRAME_SYNC;
+  hdr->version         = DUAL_PROTO_VERSION;
+  hdr->flags           = 0;
+  hdr->seq             = tx.seq;
+  hdr->frameCounter    = pkt.frameCounter;
+  hdr->mode            = pkt.mode;
+  hdr->hours           = pkt.hours;
+  hdr->minutes         = pkt.minutes;
+  hdr->seconds         = pkt.seconds;
+  hdr->colorR          = pkt.colorR;
+  hdr->colorG          = pkt.colorG;
+  hdr->colorB          = pkt.colorB;
+  hdr->brightness      = pkt.brightness;
+  hdr->preset          = pkt.preset;
+  hdr->rainbowEnabled  = pkt.rainbowEnabled;
+  hdr->settingsVersion = tx.settingsVersion;
+  hdr->dataLen         = 0;
+  hdr->presentUs       = presentUs;
+
+  size_t len = sizeof(FrameSyncHeader);
+  if (keyframe) hdr->flags |= SYNC_FLAG_KEYFRAME;
+  if (keyframe || settingsChanged) {
+    hdr->flags |= SYNC_FLAG_SETTINGS;
+    memcpy(buf + len, &settings, sizeof(SyncSettingsBlock));
+    len += sizeof(SyncSettingsBlock);
+    st.txSettingsBlocks++;
+  }
+  if ((keyframe || dataChanged) && pkt.dataLen > 0) {
+    hdr->flags |= SYNC_FLAG_MODEDATA;
+    hdr->dataLen = pkt.dataLen;
+    memcpy(buf + len, pkt.data, pkt.dataLen);
+    len += pkt.dataLen;
+  }
+  if (keyframe) st.txKeyframes++;
+
+  tx.forceKeyframe = false;
+  tx.seq++;
+  return len;
+}
+
+// ===== Risveglio del loop a presentUs =====
+// waitUs: attesa relativa (orologio locale); ri-armato solo se presentUs cambia
+static void dualSchedulePresent(uint32_t presentUs, int32_t waitUs) {
+  if (!dualPresentTimer) {
+    esp_timer_create_args_t args = {};
+    args.callback = [](void*) { frameGovKick(); };
+    args.name = "dualPresent";
+    if (esp_timer_create(&args, &dualPresentTimer) != ESP_OK) {
+      dualPresentTimer = nullptr;
+      return;
+    }
+  }
+  if (presentUs == dualPresentArmedUs && esp_timer_is_active(dualPresentTimer)) return;
+  esp_timer_stop(dualPresentTimer);
+  esp_timer_start_once(dualPresentTimer, waitUs);
+  dualPresentArmedUs = presentUs;
+}
+
+// ===== Master: trattiene il ridisegno del modo fino a presentUs =====
+// Chiamata dal loop prima dello switch dei modi: true = non disegnare in questo giro
+bool dualPresentHold() {
+  if (panelRole != 1 || !dualPresentPending) return false;
+  int32_t wait = (int32_t)(dualPendingPresentUs - (uint32_t)esp_timer_get_time());
+  if (wait <= 0 || wait > DUAL_PRESENT_LEAD_MAX_US * 2) {
+    dualPresentPending = false;
+    return false;
+  }
+  dualSchedulePresent(dualPendingPresentUs, wait);
+  return true;
+}
+
+// ===== Codifica e invia un frame sync v2 =====
+// Parte dal SyncPacket gia' riempito da sendSyncPacket()
+void transmitFrameSync(const SyncPacket &pkt) {
+  uint8_t buf[sizeof(FrameSyncHeader) + sizeof(SyncSettingsBlock) + 200];
+
+  // 2+ slave: un solo broadcast (meno airtime), altrimenti unicast con ACK
+  dualUseBroadcast = (peerCount >= 2 && broadcastPeerAdded);
+  uint32_t leadUs = dualPresentLeadUs + dualUnicastQueueUs(dualUseBroadcast ? 1 : peerCount, pkt.dataLen);
+  uint32_t presentUs = (uint32_t)(esp_timer_get_time() + leadUs);
+  size_t len = encodeFrameSync(dualTx, pkt, buf, presentUs, dualSyncStats);
+
+  // Il master presenta lo stesso frame allo stesso istante degli slave
+  // (solo per i modi in dual: in bypass ogni pannello disegna per conto suo)
+  if (!(pkt.mode & 0x80)) {
+    dualPendingPresentUs = presentUs;
+    dualPresentPending = true;
+  }
+
+  if (dualUseBroadcast) {
+    dualSend(broadcastMAC, buf, len);
+    dualSyncStats.txBytes += len;
+    dualSyncStats.txPackets++;
+  } else {
+    for (int i = 0; i < (int)peerCount; i++) {
+      dualSend(peerMACs[i], buf, len);
+      dualSyncStats.txBytes += len;
+      dualSyncStats.txPackets++;
+    }
+  }
+  dualAirtimeUsAccum += dualUseBroadcast ? espNowAirtimeUs(len, false)
+                                                    : espNowAirtimeUs(len, true) * peerCount;
+}
+
+// ===== Decodifica un frame sync v2 in un SyncPacket completo =====
+// Aggiorna lo stato 'rx' (sequenza, perdite, impostazioni) e ricostruisce 'out'
+// con le ultime impostazioni ricevute, cosi' processSyncPacket() resta invariata.
+// Se keepPendingData e il frame non porta dati mode-specific, 'out.data' resta
+// com'e' (il loop non ha ancora consumato il sync precedente).
+// Ritorna false se il frame e' invalido o mancano ancora le impostazioni.
+bool decodeFrameSyncInto(DualRxState &rx, const uint8_t *data, int len, SyncPacket &out,
+                         uint32_t &presentUs, bool keepPendingData, unsigned long nowMs, DualSyncStats &st) {
+  if ((size_t)len < sizeof(FrameSyncHeader)) return false;
+
+  FrameSyncHeader hdr;
+  memcpy(&hdr, data, sizeof(FrameSyncHeader));
+  if (hdr.version != DUAL_PROTO_VERSION) return false;
+
+  const uint8_t *p = data + sizeof(FrameSyncHeader);
+  size_t remaining = len - sizeof(FrameSyncHeader);
+
+  // Riaggancio della sequenza: dopo un silenzio lungo (master riavviato o fuori
+  // portata) il primo frame che arriva fa da riferimento
+  if (rx.seqValid && nowMs - rx.lastRxMs > DUAL_RX_RESYNC_MS) {
+    rx.seqValid = false;
+    st.rxResyncs++;
+  }
+
+  // Rilevamento perdite dalla sequenza. Un frame di poco piu' vecchio dell'ultimo
+  // ricevuto (riordino) riporterebbe indietro lo stato: scartato, anche se e' un
+  // keyframe in ritardo. Un salto indietro oltre la finestra di riordino, o il
+  // keyframe seq 0 all'indietro, e' un master riavviato: si riaggancia
+  if (rx.seqValid && hdr.seq != rx.expectedSeq) {
+    uint16_t gap = (uint16_t)(hdr.seq - rx.expectedSeq);
+    if (gap >= 0x8000) {
+      uint16_t back = (uint16_t)(rx.expectedSeq - hdr.seq);
+      if (back <= DUAL_RX_REORDER_WINDOW && !(hdr.seq == 0 && (hdr.flags & SYNC_FLAG_KEYFRAME))) {
+        st.rxStale++;
+        return false;
+      }
+      st.rxResyncs++;
+      rx.lossStart = 0;
+    } else {
+      st.rxLost += gap;
+      if (rx.lossStart == 0) rx.lossStart = nowMs ? nowMs : 1;
+    }
+  }
+  rx.expectedSeq = hdr.seq + 1;
+  rx.seqValid = true;
+  rx.lastRxMs = nowMs;
+  st.rxPackets++;
+
+  if ((hdr.flags & SYNC_FLAG_SETTINGS) && remaining >= sizeof(SyncSettingsBlock)) {
+    memcpy(&rx.settings, p, sizeof(SyncSettingsBlock));
+    rx.settingsValid = true;
+    p += sizeof(SyncSettingsBlock);
+    remaining -= sizeof(SyncSettingsBlock);
+  }
+
+  // Keyframe ricevuto dopo una perdita: stato di nuovo completo
+  if ((hdr.flags & SYNC_FLAG_KEYFRAME) && rx.lossStart != 0) {
+    uint32_t rec = nowMs - rx.lossStart;
+    st.recoveries++;
+    st.recoveryMsTotal += rec;
+    if (rec > st.recoveryMsMax) st.recoveryMsMax = rec;
+    rx.lossStart = 0;
+  }
+
+  // Senza impostazioni valide non possiamo ricostruire il pacchetto
+  if (!rx.settingsValid) return false;
+
+  out.magic          = DUAL_MAGIC;
+  out.packetType     = PKT_STATE_SYNC;
+  out.mode           = hdr.mode;
+  out.hours          = hdr.hours;
+  out.minutes        = hdr.minutes;
+  out.seconds        = hdr.seconds;
+  out.frameCounter   = hdr.frameCounter;
+  out.colorR         = hdr.colorR;
+  out.colorG         = hdr.colorG;
+  out.colorB         = hdr.colorB;
+  out.brightness     = hdr.brightness;
+  out.preset         = hdr.preset;
+  out.rainbowEnabled = hdr.rainbowEnabled;
+  memcpy(&out.brightnessDay, &rx.settings, sizeof(SyncSettingsBlock));
+  presentUs = hdr.presentUs;
+  if ((hdr.flags & SYNC_FLAG_MODEDATA) && hdr.dataLen <= remaining && hdr.dataLen <= 200) {
+    memcpy(out.data, p, hdr.dataLen);
+    out.dataLen = hdr.dataLen;
+  } else if (!keepPendingData) {
+    out.dataLen = 0;
+  }
+  return true;
+}
+
+// ===== Ricezione frame sync v2 (callback WiFi, lato slave) =====
+void decodeFrameSync(const uint8_t *mac_addr, const uint8_t *incomingData, int len) {
+  // In broadcast arrivano anche i sync di altre griglie: accetta solo dal proprio master
+  int peerIdx = findPeerIndex(mac_addr);
+  if (peerIdx < 0) return;
+  unsigned long now = millis();
+
+  portENTER_CRITICAL(&syncMux);
+  bool ok = decodeFrameSyncInto(dualRx, incomingData, len, lastReceivedSync, dualRxPresentUs,
+                                newSyncAvailable, now, dualSyncStats);
+  if (ok) newSyncAvailable = true;
+  portEXIT_CRITICAL(&syncMux);
+  if (!ok) return;
+
+  peerStates[peerIdx].lastHeartbeat = now;
+  peerStates[peerIdx].active = true;
+}
 
-  // Invia a tutti i peer registrati
+// ===== Orologio condiviso (tempo del master in us) =====
+// Master: il proprio esp_timer. Slave: esp_timer + offset stimato.
+int64_t dualSharedTimeUs() {
+  int64_t now = esp_timer_get_time();
+  return panelRole == 2 ? now + dualClock.offsetUs : now;
+}
+
+// ===== Slave: invia un ping di sincronizzazione orologio al master =====
+void sendTimePing() {
+  if (panelRole != 2 || peerCount == 0) return;
+  static uint8_t pingSeq = 0;
+  TimeSyncPacket tp;
+  memset(&tp, 0, sizeof(tp));
+  tp.magic        = DUAL_MAGIC;
+  tp.packetType   = PKT_TIME_PING;
+  tp.seq          = pingSeq++;
+  tp.presentErrUs = dualClock.presentErrUs;
+  tp.oneWayUs     = dualClock.rttUs / 2;
+  tp.t1           = esp_timer_get_time();
+  dualSend(peerMACs[0], &tp, sizeof(tp));
+}
+
+// ===== Master: risponde al ping e registra il report dello slave =====
+void handleTimePing(const uint8_t *mac_addr, const uint8_t *incomingData, int len, int64_t rxUs) {
+  if ((size_t)len < sizeof(TimeSyncPacket)) return;
+  int idx = findPeerIndex(mac_addr);
+  if (idx < 0) return;
+
+  TimeSyncPacket tp;
+  memcpy(&tp, incomingData, sizeof(TimeSyncPacket));
+  peerPresentErrUs[idx] = tp.presentErrUs;
+  peerOneWayUs[idx]     = tp.oneWayUs;
+
+  // Anticipo di presentazione: la latenza peggiore tra gli slave + 1ms di margine
+  uint32_t worst = 0;
   for (int i = 0; i < (int)peerCount; i++) {
-    esp_now_send(peerMACs[i], (uint8_t*)&pkt, pktSize);
+    if (peerStates[i].active && peerOneWayUs[i] > worst) worst = peerOneWayUs[i];
   }
+  dualPresentLeadUs = constrain(worst + 1000, (uint32_t)DUAL_PRESENT_LEAD_MIN_US, (uint32_t)DUAL_PRESENT_LEAD_MAX_US);
 
-  // Incrementa il frame counter
-  dualFrameCounter++;
+  tp.packetType = PKT_TIME_PONG;
+  tp.t2 = rxUs;
+  tp.t3 = esp_timer_get_time();
+  dualSend(mac_addr, &tp, sizeof(tp));
+}
+
+// ===== Slave: aggiorna la stima offset/jitter con un pong =====
+void handleTimePong(const uint8_t *incomingData, int len, int64_t rxUs) {
+  if ((size_t)len < sizeof(TimeSyncPacket)) return;
+  TimeSyncPacket tp;
+  memcpy(&tp, incomingData, sizeof(TimeSyncPacket));
+
+  int64_t rtt = (rxUs - tp.t1) - (tp.t3 - tp.t2);
+  if (rtt < 0 || rtt > 200000) return;  // Pong vecchio o corrotto
+  int64_t sample = ((tp.t2 - tp.t1) + (tp.t3 - rxUs)) / 2;
+
+  // Il minimo rtt decade lentamente (+1%/campione) per seguire cambi di canale
+  if (dualClock.rttMinUs == 0 || (uint32_t)rtt < dualClock.rttMinUs) dualClock.rttMinUs = rtt;
+  else dualClock.rttMinUs += dualClock.rttMinUs / 100 + 1;
+
+  // Campioni con rtt > 2x minimo hanno passato tempo in coda: asimmetrici, scarta
+  if (dualClock.samples > 0 && (uint32_t)rtt > dualClock.rttMinUs * 2 + 500) {
+    dualClock.rejected++;
+    return;
+  }
+
+  if (dualClock.samples == 0) {
+    dualClock.offsetUs = sample;
+  } else {
+    int64_t err = sample - dualClock.offsetUs;
+    dualClock.offsetUs += err / 4;  // EMA alpha = 1/4
+    uint32_t absErr = (uint32_t)(err < 0 ? -err : err);
+    dualClock.jitterUs += ((int32_t)absErr - (int32_t)dualClock.jitterUs) / 8;
+  }
+  dualClock.rttUs = (uint32_t)rtt;
+  if (dualClock.samples < 0xFFFF) dualClock.samples++;
 }
 
 // ===== Prepara dati mode-specific per il pacchetto sync =====
@@ -1964,7 +2490,7 @@ void sendHeartbeat() {
 
   // Invia a tutti i peer
   for (int i = 0; i < (int)peerCount; i++) {
-    esp_now_send(peerMACs[i], (uint8_t*)&hb, hbSize);
+    dualSend(peerMACs[i], &hb, hbSize);
   }
 }
 
@@ -1985,7 +2511,7 @@ void forwardTouchToMaster(int touchX, int touchY, uint8_t touchType) {
   tp.touchType  = touchType;
 
   // Invia al primo peer (che dovrebbe essere il master)
-  esp_now_send(peerMACs[0], (uint8_t*)&tp, sizeof(tp));
+  dualSend(peerMACs[0], &tp, sizeof(tp));
 
   Serial.printf("[DUAL] Touch inoltrato al master: (%d,%d) tipo=%d\n", touchX, touchY, touchType);
 }
@@ -1995,38 +2521,25 @@ void forwardTouchToMaster(int touchX, int touchY, uint8_t touchType) {
 // ========================================================================
 
 // ===== Carica impostazioni dual display dalla EEPROM =====
+// Default e range (pannello singolo standalone) nella tabella schema di 0_SETTINGS_STORE.ino:
+// settingsLoad() riporta al default un valore fuori range
 void loadDualDisplaySettings() {
-  // Verifica marker di validita'
+  dualDisplayEnabled = settingsLoad(EEPROM_DUAL_ENABLED) != 0;
+  panelX    = settingsLoad(EEPROM_DUAL_PANEL_X);
+  panelY    = settingsLoad(EEPROM_DUAL_PANEL_Y);
+  gridW     = settingsLoad(EEPROM_DUAL_GRID_W);
+  gridH     = settingsLoad(EEPROM_DUAL_GRID_H);
+  panelRole = settingsLoad(EEPROM_DUAL_ROLE);
+
+  // I MAC dei peer sono validi solo se la configurazione e' stata salvata almeno una volta
+  peerCount = 0;
+  memset(peerMACs, 0, sizeof(peerMACs));
   if (EEPROM.read(EEPROM_DUAL_MARKER) != EEPROM_DUAL_MARKER_VALUE) {
     Serial.println("[DUAL] Nessuna configurazione salvata in EEPROM, uso valori predefiniti");
-    // Mantieni i valori di default (disabled, standalone)
-    dualDisplayEnabled = false;
-    panelX    = 0;
-    panelY    = 0;
-    gridW     = 1;
-    gridH     = 1;
-    panelRole = 0;
-    peerCount = 0;
-    memset(peerMACs, 0, sizeof(peerMACs));
     return;
   }
 
-  dualDisplayEnabled = EEPROM.read(EEPROM_DUAL_ENABLED) != 0;
-  panelX    = EEPROM.read(EEPROM_DUAL_PANEL_X);
-  panelY    = EEPROM.read(EEPROM_DUAL_PANEL_Y);
-  gridW     = EEPROM.read(EEPROM_DUAL_GRID_W);
-  gridH     = EEPROM.read(EEPROM_DUAL_GRID_H);
-  panelRole = EEPROM.read(EEPROM_DUAL_ROLE);
-
-  // Sanitize dei valori
-  if (panelX > 1) panelX = 0;
-  if (panelY > 1) panelY = 0;
-  if (gridW < 1 || gridW > 2) gridW = 1;
-  if (gridH < 1 || gridH > 2) gridH = 1;
-  if (panelRole > 2) panelRole = 0;
-
   // Carica MAC dei peer
-  peerCount = 0;
   for (int i = 0; i < 3; i++) {
     int baseAddr = EEPROM_DUAL_PEER1_MAC + i * 6;
     uint8_t mac[6];
@@ -2050,7 +2563,7 @@ void loadDualDisplaySettings() {
 }
 
 // ===== Salva impostazioni dual display nella EEPROM =====
-// Ritorna true se EEPROM.commit() ha successo, false altrimenti
+// Ritorna true se settingsFlush() ha successo, false altrimenti
 bool saveDualDisplaySettings() {
   EEPROM.write(EEPROM_DUAL_ENABLED, dualDisplayEnabled ? 1 : 0);
   EEPROM.write(EEPROM_DUAL_PANEL_X, panelX);
@@ -2073,7 +2586,7 @@ bool saveDualDisplaySettings() {
 
   // Scrivi il marker di validita'
   EEPROM.write(EEPROM_DUAL_MARKER, EEPROM_DUAL_MARKER_VALUE);
-  bool ok = EEPROM.commit();
+  bool ok = settingsFlush();
 
   if (ok) {
     Serial.println("[DUAL] Impostazioni salvate in EEPROM");
@@ -2112,7 +2625,7 @@ void sendConfigPushToAllPeers() {
   for (uint8_t i = 0; i < peerCount; i++) {
     pkt.assignedX = peerStates[i].peerPanelX;
     pkt.assignedY = peerStates[i].peerPanelY;
-    esp_err_t result = esp_now_send(peerMACs[i], (uint8_t*)&pkt, sizeof(pkt));
+    esp_err_t result = dualSend(peerMACs[i], &pkt, sizeof(pkt));
     Serial.printf("[DUAL] Config push a %s: enabled=%d grid=%dx%d result=%d\n",
                   macToString(peerMACs[i]).c_str(), pkt.enabled, gridW, gridH, result);
   }
@@ -2243,6 +2756,9 @@ void initDualDisplay() {
 
   dualDisplayInitialized = true;
   dualFrameCounter = 0;
+  dualTx.forceKeyframe = true;
+  dualRx.seqValid = false;
+  dualPresentPending = false;
 
   // Attiva/disattiva proxy DualGFX in base alla griglia
   initDualGfxProxy();
@@ -2391,15 +2907,61 @@ void updateDualDisplay() {
     lastSync = now;
   }
 
+  // === Statistiche banda: finestra di 1 secondo ===
+  static unsigned long lastStatsWindow = 0;
+  static uint32_t windowBytesStart = 0, windowPktStart = 0;
+  if (now - lastStatsWindow >= 1000) {
+    dualSyncStats.bytesPerSec   = dualSyncStats.txBytes - windowBytesStart;
+    dualSyncStats.packetsPerSec = dualSyncStats.txPackets - windowPktStart;
+    windowBytesStart = dualSyncStats.txBytes;
+    windowPktStart   = dualSyncStats.txPackets;
+    dualSyncStats.airtimeUsPerSec = dualAirtimeUsAccum;
+    dualAirtimeUsAccum = 0;
+    lastStatsWindow = now;
+  }
+
   // === SLAVE: Processa pacchetti sync ricevuti ===
   // Copia locale protetta da mutex per evitare race condition con callback ESP-NOW
+  // Con l'orologio agganciato il frame viene applicato all'istante presentUs
+  // (stesso istante su tutti i pannelli), non appena arriva
   if (panelRole == 2 && newSyncAvailable) {
-    SyncPacket localPkt;
-    portENTER_CRITICAL(&syncMux);
-    memcpy(&localPkt, &lastReceivedSync, sizeof(SyncPacket));
-    newSyncAvailable = false;
-    portEXIT_CRITICAL(&syncMux);
-    processSyncPacket(localPkt);
+    bool clockLocked = dualClock.samples >= DUAL_CLOCK_SYNC_SAMPLES && dualRxPresentUs != 0;
+    int32_t wait = clockLocked ? (int32_t)(dualRxPresentUs - (uint32_t)dualSharedTimeUs()) : 0;
+    // Non ancora: il timer risveglia il loop a presentUs e il frame si applica al giro dopo.
+    // Oltre DUAL_PRESENT_LEAD_MAX_US l'orologio e' incoerente: applica subito.
+    if (wait > 0 && wait <= DUAL_PRESENT_LEAD_MAX_US) {
+      dualSchedulePresent(dualRxPresentUs, wait);
+    } else {
+      SyncPacket localPkt;
+      uint32_t presentUs;
+      portENTER_CRITICAL(&syncMux);
+      memcpy(&localPkt, &lastReceivedSync, sizeof(SyncPacket));
+      presentUs = dualRxPresentUs;
+      newSyncAvailable = false;
+      portEXIT_CRITICAL(&syncMux);
+      processSyncPacket(localPkt);
+
+      if (clockLocked) {
+        // Errore di presentazione (positivo = in ritardo). Se siamo indietro di
+        // piu' frame, il frame counter si riallinea al tempo condiviso
+        int32_t err = (int32_t)((uint32_t)dualSharedTimeUs() - presentUs);
+        dualClock.presentErrUs += (err - dualClock.presentErrUs) / 8;
+        if (err > DUAL_SYNC_INTERVAL_MS * 1000) {
+          dualClock.presentLateCnt++;
+          dualFrameCounter += err / (DUAL_SYNC_INTERVAL_MS * 1000);
+        }
+      }
+    }
+  }
+
+  // === SLAVE: ping periodici per la stima offset orologio ===
+  static unsigned long lastPing = 0;
+  if (panelRole == 2 && peerCount > 0) {
+    unsigned long pingInterval = dualClock.samples < DUAL_CLOCK_SYNC_SAMPLES ? DUAL_PING_INTERVAL_FAST : DUAL_PING_INTERVAL;
+    if (now - lastPing >= pingInterval) {
+      sendTimePing();
+      lastPing = now;
+    }
   }
 
   // === TUTTI: Invia heartbeat ogni secondo ===
@@ -2482,6 +3044,55 @@ bool isDualSlave() {
   return dualDisplayEnabled && panelRole == 2;
 }
 
+// ===== Statistiche sync/orologio (condivise da getDualDisplayStatusJson e /dualdisplay/status) =====
+// Ritorna i campi "sync" e "clock" senza graffe esterne.
+String getDualSyncStatsJson() {
+  String json;
+  // Protocollo sync v2: banda/airtime (master) e perdite/recupero (slave)
+  json += "\"sync\":{";
+  json += "\"proto\":" + String(DUAL_PROTO_VERSION) + ",";
+  json += "\"seq\":" + String(panelRole == 1 ? dualTx.seq : dualRx.expectedSeq) + ",";
+  json += "\"broadcast\":" + String(dualUseBroadcast ? "true" : "false") + ",";
+  json += "\"bytesPerSec\":" + String(dualSyncStats.bytesPerSec) + ",";
+  json += "\"packetsPerSec\":" + String(dualSyncStats.packetsPerSec) + ",";
+  json += "\"airtimeMsPerSec\":" + String(dualSyncStats.airtimeUsPerSec / 1000.0f, 2) + ",";
+  json += "\"keyframes\":" + String(dualSyncStats.txKeyframes) + ",";
+  json += "\"settingsBlocks\":" + String(dualSyncStats.txSettingsBlocks) + ",";
+  json += "\"rxPackets\":" + String(dualSyncStats.rxPackets) + ",";
+  json += "\"rxLost\":" + String(dualSyncStats.rxLost) + ",";
+  json += "\"rxStale\":" + String(dualSyncStats.rxStale) + ",";
+  json += "\"rxResyncs\":" + String(dualSyncStats.rxResyncs) + ",";
+  json += "\"recoveries\":" + String(dualSyncStats.recoveries) + ",";
+  json += "\"recoveryMsAvg\":" + String(dualSyncStats.recoveries ? dualSyncStats.recoveryMsTotal / dualSyncStats.recoveries : 0) + ",";
+  json += "\"recoveryMsMax\":" + String(dualSyncStats.recoveryMsMax);
+  json += "},";
+
+  // Sync orologi: offset/jitter (slave) e skew tra pannelli (master).
+  // Errore di presentazione di ogni pannello rispetto a presentUs: il master
+  // mostra il frame all'invio (-anticipo), gli slave riportano il proprio.
+  int32_t errMin = -(int32_t)dualPresentLeadUs, errMax = errMin;
+  if (panelRole == 1) {
+    for (int i = 0; i < (int)peerCount; i++) {
+      if (!peerStates[i].active || peerOneWayUs[i] == 0) continue;
+      if (peerPresentErrUs[i] < errMin) errMin = peerPresentErrUs[i];
+      if (peerPresentErrUs[i] > errMax) errMax = peerPresentErrUs[i];
+    }
+  }
+  json += "\"clock\":{";
+  json += "\"synced\":" + String(dualClock.samples >= DUAL_CLOCK_SYNC_SAMPLES ? "true" : "false") + ",";
+  json += "\"offsetUs\":" + String((long)dualClock.offsetUs) + ",";
+  json += "\"rttUs\":" + String(dualClock.rttUs) + ",";
+  json += "\"jitterUs\":" + String(dualClock.jitterUs) + ",";
+  json += "\"samples\":" + String(dualClock.samples) + ",";
+  json += "\"rejected\":" + String(dualClock.rejected) + ",";
+  json += "\"leadUs\":" + String(dualPresentLeadUs) + ",";
+  json += "\"presentErrUs\":" + String(dualClock.presentErrUs) + ",";
+  json += "\"lateFrames\":" + String(dualClock.presentLateCnt) + ",";
+  json += "\"skewUs\":" + String(panelRole == 1 ? errMax - errMin : 0);
+  json += "}";
+  return json;
+}
+
 // ===== Ottieni informazioni di stato per la pagina web =====
 String getDualDisplayStatusJson() {
   String json = "{";
@@ -2502,6 +3113,8 @@ String getDualDisplayStatusJson() {
   json += "\"activePeers\":" + String(getActivePeerCount()) + ",";
   json += "\"discovery\":" + String(discoveryInProgress ? "true" : "false") + ",";
 
+  json += getDualSyncStatsJson() + ",";
+
   json += "\"peers\":[";
   for (int i = 0; i < (int)peerCount; i++) {
     if (i > 0) json += ",";
@@ -1,7 +1,7 @@
 // ============================================================================
 // 45_WEBSERVER_DUAL_DISPLAY.ino
 // Endpoint web per la configurazione dual display (griglia multi-pannello)
-// Gestisce: stato, configurazione, peer, scansione e auto-discovery
+// Gestisce: stato, configurazione, peer, scansione, auto-discovery
 // ============================================================================
 
 #include "dualdisplay_web_html.h"
@@ -98,7 +98,8 @@ void setup_dualdisplay_webserver(AsyncWebServer* server) {
     json += "\"myMAC\":\"" + myMACStr + "\",";
     json += "\"virtualW\":" + String(vw) + ",";
     json += "\"virtualH\":" + String(vh) + ",";
-    json += "\"discovery\":" + String(discoveryInProgress ? "true" : "false");
+    json += "\"discovery\":" + String(discoveryInProgress ? "true" : "false") + ",";
+    json += getDualSyncStatsJson();
     json += "}";
 
     AsyncWebServerResponse *response = request->beginResponse(200, "application/json", json);
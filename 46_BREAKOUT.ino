@@ -643,6 +643,33 @@ void handleBreakoutTouch(int x, int y) {
   #endif
 }
 
+// Touch a eventi (1_TOUCH_INPUT.ino): PRESS su angolo alto-sx = cambio modo, fascia alta =
+// velocita', altrove e durante il trascinamento il paddle segue il dito. Slave: inoltro al master.
+void handleBreakoutTouchEvent(const TouchEvent &ev) {
+  if (ev.type != TOUCH_EV_PRESS && ev.type != TOUCH_EV_DRAG_START && ev.type != TOUCH_EV_DRAG_MOVE) return;
+
+  #ifdef EFFECT_DUAL_DISPLAY
+  if (isDualSlave()) {
+    forwardTouchToMaster(ev.x, ev.y, 0);
+    return;
+  }
+  #endif
+
+  if (ev.type == TOUCH_EV_PRESS) {
+    if (ev.x < 80 && ev.y < 80) {
+      playTouchSound();
+      handleModeChange();
+      return;
+    }
+    if (ev.y < 50) {
+      playTouchSound();
+      handleBreakoutSpeedChange();
+      return;
+    }
+  }
+  handleBreakoutTouch(ev.x, ev.y);
+}
+
 void handleBreakoutRemoteTouch(int vx, int vy) {
   // vx e' la coordinata virtuale X (0-959)
   brkRemotePaddleX = vx;
@@ -666,7 +666,10 @@ void executePendingModeSwitch() {
   EEPROM.write(EEPROM_COLOR_R_ADDR, currentColor.r);
   EEPROM.write(EEPROM_COLOR_G_ADDR, currentColor.g);
   EEPROM.write(EEPROM_COLOR_B_ADDR, currentColor.b);
-  EEPROM.commit();
+  settingsCommit();
+
+  // Preparazione asset in background mentre il nome modo resta a schermo
+  modePrepare((uint8_t)currentMode);
 
 #ifdef EFFECT_MJPEG_STREAM
   if (previousMode == MODE_MJPEG_STREAM && currentMode != MODE_MJPEG_STREAM) {
@@ -712,7 +715,7 @@ void executePendingModeSwitch() {
 
   gfx->setFont(u8g2_font_inb21_mr);
   gfx->fillScreen(BLACK);
-  forceDisplayUpdate();
+  modeActivate((uint8_t)currentMode);
 
   // Dual display: invia sync aggiornato dopo forceDisplayUpdate
 #ifdef EFFECT_DUAL_DISPLAY
@@ -404,7 +404,7 @@ void saveScrollTextToFS() {
   EEPROM.write(EEPROM_SCROLLTEXT_BG_B, scrollBgB);
   EEPROM.write(EEPROM_SCROLLTEXT_SHOW_TIME, scrollShowTime ? 1 : 0);
   EEPROM.write(EEPROM_SCROLLTEXT_SHOW_DATE, scrollShowDate ? 1 : 0);
-  EEPROM.commit();
+  settingsCommit();
 
   Serial.printf("[SCROLLTEXT] Salvati %d messaggi su LittleFS + EEPROM\n", scrollMessageCount);
 }
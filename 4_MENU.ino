@@ -5,14 +5,14 @@ bool checkSetupScroll() {
 
   try {
     // Verifica se lo schermo non è attualmente toccato.
-    if (!ts.isTouched) {
+    if (!touchState.isTouched) {
       setupScrollActive = false; // Resetta il flag di scroll attivo.
       lastY = -1;              // Resetta l'ultima coordinata Y.
       return false;            // Indica che non c'è stato uno scroll.
     }
 
     // Ottiene la coordinata Y del primo punto di contatto. Mappa il valore grezzo del touch screen all'intervallo delle coordinate del display (0-479).
-    int y = map(ts.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
+    int y = map(touchState.points[0].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
     uint32_t currentTime = millis(); // Ottiene il tempo attuale in millisecondi.
 
     // Gestisce la prima inizializzazione della coordinata Y al primo tocco.
@@ -509,7 +509,7 @@ void saveSetupOptions() {
     EEPROM.write(EEPROM_VUMETER_ENABLED_ADDR, setupOptions.vuMeterShowEnabled ? 1 : 0);
 
     // Scrive i dati dalla cache della EEPROM alla memoria fisica.
-    EEPROM.commit();
+    settingsCommit();
 
     // NON cambiare currentMode qui - la modalità deve rimanere quella scelta dall'utente
     // currentMode = (DisplayMode)setupOptions.defaultDisplayMode;  // RIMOSSO
@@ -47,7 +47,7 @@ void saveClockDateVisibility() {
   // Salva rainbow hands (impostazione globale)
   EEPROM.write(EEPROM_CLOCK_RAINBOW_ADDR, clockHandsRainbow ? 1 : 0);
 
-  EEPROM.commit();
+  settingsCommit();
 
   Serial.printf("[WEBSERVER] Configurazione orologio salvata: Data=%s, SmoothSeconds=%s, Rainbow=%s\n",
                 showClockDate ? "SI" : "NO",
@@ -2770,13 +2770,13 @@ void setup_clock_webserver(AsyncWebServer* server) {
           for (int i = 0; i < 32; i++) {
             EEPROM.write(EEPROM_CLOCK_SKIN_NAME_ADDR + i, clockActiveSkin[i]);
           }
-          EEPROM.commit();
+          settingsCommit();
 
           Serial.printf("[WEBSERVER] Skin cambiata: %s\n", clockActiveSkin);
 
-          // Forza ricaricamento dell'immagine
+          // Forza ricaricamento dell'immagine (e scarta eventuali preparazioni in corso)
           analogClockInitNeeded = true;
-          clockImageLoaded = false;
+          modeLifecycleInvalidate(MODE_ANALOG_CLOCK);
 
           request->send(200, "application/json", "{\"status\":\"ok\"}");
         } else {
@@ -2842,6 +2842,7 @@ void setup_clock_webserver(AsyncWebServer* server) {
           Serial.println("[WEBSERVER] File chiuso");
         }
         Serial.printf("[WEBSERVER] Upload Complete: %s (%u bytes)\n", uploadFilename.c_str(), index + len);
+        skinCacheInvalidate(uploadFilename.c_str());   // Stesso nome, contenuto nuovo
 
         // Verifica dimensione file
         if (SD.exists(uploadFilename.c_str())) {
@@ -2863,9 +2864,10 @@ void setup_clock_webserver(AsyncWebServer* server) {
           }
         }
 
-        // Forza ricaricamento immagine solo se era la skin attiva
+        // Forza ricaricamento immagine solo se era la skin attiva.
+        // Il file puo' sostituire anche bttf.jpg o lo sfondo Flux: invalida tutte le cache
         analogClockInitNeeded = true;
-        clockImageLoaded = false;
+        modeLifecycleInvalidateAll();
       }
     }
   );
@@ -2905,6 +2907,7 @@ void setup_clock_webserver(AsyncWebServer* server) {
           // Elimina il file JPG
           if (SD.remove(fullPath.c_str())) {
             Serial.printf("[WEBSERVER] File JPG eliminato con successo: %s\n", fullPath.c_str());
+            skinCacheInvalidate(fullPath.c_str());
 
             // Elimina anche il file .cfg se esiste
             if (SD.exists(cfgPath.c_str())) {
@@ -2944,7 +2947,7 @@ void setup_clock_webserver(AsyncWebServer* server) {
 
                       // Forza ricaricamento
                       analogClockInitNeeded = true;
-                      clockImageLoaded = false;
+                      modeLifecycleInvalidate(MODE_ANALOG_CLOCK);
                     }
                   }
                   file.close();
@@ -13,6 +13,7 @@
 
 #include "esp_task_wdt.h"
 #include <esp_system.h>
+#include <esp_rom_crc.h>
 
 // RTC memory survives soft resets - tracks if arcade was running when crash occurred
 RTC_DATA_ATTR uint8_t arcadeCrashFlag = 0;
@@ -230,6 +231,58 @@ unsigned long arcadeLastFrameTime = 0;
 unsigned long arcadeFrameCount = 0;
 unsigned long arcadeBootStartMs = 0;   // Tracks boot duration (reset per game)
 
+// ===== Benchmark / Determinism (profilo per-frame + replay input) =====
+// Emulazione misurata su Core 0 (run_frame + transmit), render su Core 1.
+// Replay: /ARCADE/<GIOCO>/replay.bin = 1 byte (maschera ArcadeInput) per frame emulato.
+// In replay l'input viene applicato dal task Z80 frame per frame, quindi la
+// CRC della RAM Z80 dopo ogni frame e' deterministica e confrontabile tra build.
+#define ARCADE_REPLAY_MAX_FRAMES 36000   // 10 minuti @ 60fps
+
+struct ArcadeProfile {
+  uint32_t emuFrames;        // frame emulati (dopo il boot)
+  uint64_t emuUsTotal;       // somma run_frame()
+  uint32_t emuUsMax;
+  uint64_t audioUsTotal;     // somma arcadeAudio->transmit()
+  uint64_t audioSamples;     // campioni consegnati da transmit() all'I2S (0 = non riportati)
+  uint32_t renderFrames;     // frame disegnati su display
+  uint64_t renderUsTotal;    // prepare_frame + render_row + upscale + blit (senza attese del mutex e yield)
+  uint32_t renderUsMax;
+  uint32_t ramCrc;           // CRC32 RAM Z80 dell'ultimo frame emulato
+  uint32_t traceCrc;         // CRC32 concatenata di tutte le ramCrc (firma del replay)
+  uint32_t frameCrc;         // CRC32 concatenata dei framebuffer nativi (task Z80, solo replay)
+};
+ArcadeProfile arcadeProfile;
+
+// prepare_frame/render_row scrivono arcadeFrameBuffer: render (Core 1) e
+// frame CRC del replay (task Z80, Core 0) non devono sovrapporsi
+SemaphoreHandle_t arcadeRenderMutex = nullptr;
+uint32_t arcadeRenderUs = 0;             // render del frame corrente, solo a mutex preso
+uint32_t arcadeRenderT0 = 0;
+
+// Stop cooperativo del task Z80: esce da solo a fine frame, mai con il mutex preso
+volatile bool arcadeEmuStopRequest = false;
+volatile bool arcadeEmuRunning = false;
+
+// transmit() di ArcadeAudio: campioni scritti sull'I2S se li restituisce,
+// altrimenti 0 e il report li indica come non disponibili
+struct ArcadeTransmit {
+  template <typename A> static auto run(A* a, int) -> decltype(uint32_t(a->transmit())) { return a->transmit(); }
+  template <typename A> static uint32_t run(A* a, long) { a->transmit(); return 0; }
+};
+
+uint8_t* arcadeReplayData = nullptr;     // input registrati (PSRAM)
+uint32_t arcadeReplayLen = 0;            // frame disponibili nel replay
+volatile uint32_t arcadeReplayPos = 0;   // prossimo frame da applicare
+volatile bool arcadeReplayActive = false;
+volatile bool arcadeReplayDone = false;
+bool arcadeRecordActive = false;         // registra gli input reali su replay.bin
+volatile uint8_t arcadeLiveButtons = 0;  // ultimo input da touch/BLE/ESP-NOW (per record)
+
+// Benchmark armato da web fuori dal modo arcade: initArcade spegne il WiFi,
+// quindi replay/record vengono prenotati e partono all'ingresso nel modo
+volatile int8_t arcadeArmedGame = -1;
+volatile bool arcadeArmedRecord = false;
+
 // ===== Arcade Enabled Mask (EEPROM 949-951) =====
 #define ARCADE_EEPROM_MASK_LO  949
 #define ARCADE_EEPROM_MASK_HI  950
@@ -250,7 +303,7 @@ void saveArcadeEnabledMask() {
   EEPROM.write(ARCADE_EEPROM_MASK_LO, arcadeEnabledMask & 0xFF);
   EEPROM.write(ARCADE_EEPROM_MASK_HI, (arcadeEnabledMask >> 8) & 0xFF);
   EEPROM.write(ARCADE_EEPROM_MASK_MARKER, ARCADE_MASK_MARKER_VAL);
-  EEPROM.commit();
+  settingsCommit();
 }
 
 bool isArcadeGameEnabled(int idx) {
@@ -286,6 +339,14 @@ void arcadeTriggerStart();
 void handleArcadeGameTouch(int x, int y);
 void arcadeUpdateTouchInput(int x, int y);
 void arcadeClearTouchInput();
+void arcadeProfileReset();
+void arcadeProfilePrint();
+uint32_t arcadeProfileAudioSamples();
+bool arcadeReplayLoad(uint8_t machineType);
+void arcadeReplaySave(uint8_t machineType);
+void arcadeReplayFree();
+bool arcadeStartBenchmark(int gameIdx, bool record);
+void arcadeCheckSerial();
 
 // ===== Initialization =====
 void initArcade() {
@@ -377,7 +438,18 @@ void initArcade() {
   // NimBLE init viene eseguito in background task - non blocca il menu
   bleGamepadInit();
 
+  if (!arcadeRenderMutex) arcadeRenderMutex = xSemaphoreCreateMutex();
+
   arcadeInitialized = true;
+
+  // Benchmark prenotato da web prima dell'ingresso
+  if (arcadeArmedGame >= 0) {
+    int8_t idx = arcadeArmedGame;
+    arcadeArmedGame = -1;
+    if (!arcadeStartBenchmark(idx, arcadeArmedRecord)) {
+      Serial.printf("[ARCADE-PROF] Benchmark non avviato: gioco %d non valido o replay.bin assente\n", idx);
+    }
+  }
 }
 
 // ===== Cleanup =====
@@ -401,9 +473,14 @@ void cleanupArcade() {
     delete arcadeAudio;
     arcadeAudio = nullptr;
   }
+  #ifdef AUDIO
+  // ArcadeAudio riprogramma l'I2S a 24kHz: ripristina il clock fisso della libreria Audio
+  audio.setOutputRate(AUDIO_OUTPUT_RATE, AUDIO_OUTPUT_QUALITY);
+  #endif
 
-  // Free buffers
+  // Free buffers (anche la cache ROM: fuori dall'arcade la PSRAM serve ad altri modi)
   arcadeFreeBuffers();
+  arcadeRomCacheFree();
 
   arcadeInitialized = false;
   arcadeInMenu = true;
@@ -425,80 +502,360 @@ bool arcadeRomsAvailable() {
   return SD.exists("/ARCADE");
 }
 
-// ===== Build Game List (only games with ROM files on SD) =====
-void arcadeBuildGameList() {
-  arcadeMachineCount = 0;
-
-  // Check ALL required ROMs per game (multi-CPU games need rom2/rom3 too!)
-  // Without all ROMs, sub-CPUs read from 1-byte PROGMEM stub → crash
+// ===== Compiled game table (nome + tipo, in ordine di menu) =====
+static const ArcadeGameInfo arcadeCompiledGames[] = {
 #ifdef ENABLE_PACMAN
-  if (SD.exists("/ARCADE/PACMAN/rom1.bin"))
-    arcadeGames[arcadeMachineCount++] = {"PAC-MAN", MCH_PACMAN, true};
+  {"PAC-MAN", MCH_PACMAN, true},
 #endif
 #ifdef ENABLE_GALAGA
-  if (SD.exists("/ARCADE/GALAGA/rom1.bin") && SD.exists("/ARCADE/GALAGA/rom2.bin") &&
-      SD.exists("/ARCADE/GALAGA/rom3.bin"))
-    arcadeGames[arcadeMachineCount++] = {"GALAGA", MCH_GALAGA, true};
+  {"GALAGA", MCH_GALAGA, true},
 #endif
 #ifdef ENABLE_DKONG
-  if (SD.exists("/ARCADE/DKONG/rom1.bin") && SD.exists("/ARCADE/DKONG/rom2.bin"))
-    arcadeGames[arcadeMachineCount++] = {"DONKEY KONG", MCH_DKONG, true};
+  {"DONKEY KONG", MCH_DKONG, true},
 #endif
 #ifdef ENABLE_FROGGER
-  if (SD.exists("/ARCADE/FROGGER/rom1.bin") && SD.exists("/ARCADE/FROGGER/rom2.bin"))
-    arcadeGames[arcadeMachineCount++] = {"FROGGER", MCH_FROGGER, true};
+  {"FROGGER", MCH_FROGGER, true},
 #endif
 #ifdef ENABLE_DIGDUG
-  if (SD.exists("/ARCADE/DIGDUG/rom1.bin") && SD.exists("/ARCADE/DIGDUG/rom2.bin") &&
-      SD.exists("/ARCADE/DIGDUG/rom3.bin"))
-    arcadeGames[arcadeMachineCount++] = {"DIG DUG", MCH_DIGDUG, true};
+  {"DIG DUG", MCH_DIGDUG, true},
 #endif
 #ifdef ENABLE_1942
-  if (SD.exists("/ARCADE/1942/rom1.bin") && SD.exists("/ARCADE/1942/rom2.bin") &&
-      SD.exists("/ARCADE/1942/rom1_b0.bin") && SD.exists("/ARCADE/1942/rom1_b1.bin") &&
-      SD.exists("/ARCADE/1942/rom1_b2.bin"))
-    arcadeGames[arcadeMachineCount++] = {"1942", MCH_1942, true};
+  {"1942", MCH_1942, true},
 #endif
 #ifdef ENABLE_EYES
-  if (SD.exists("/ARCADE/EYES/rom1.bin"))
-    arcadeGames[arcadeMachineCount++] = {"EYES", MCH_EYES, true};
+  {"EYES", MCH_EYES, true},
 #endif
 #ifdef ENABLE_MRTNT
-  if (SD.exists("/ARCADE/MRTNT/rom1.bin"))
-    arcadeGames[arcadeMachineCount++] = {"MR. TNT", MCH_MRTNT, true};
+  {"MR. TNT", MCH_MRTNT, true},
 #endif
 #ifdef ENABLE_LIZWIZ
-  if (SD.exists("/ARCADE/LIZWIZ/rom1.bin"))
-    arcadeGames[arcadeMachineCount++] = {"LIZ WIZ", MCH_LIZWIZ, true};
+  {"LIZ WIZ", MCH_LIZWIZ, true},
 #endif
 #ifdef ENABLE_THEGLOB
-  if (SD.exists("/ARCADE/THEGLOB/rom1.bin"))
-    arcadeGames[arcadeMachineCount++] = {"THE GLOB", MCH_THEGLOB, true};
+  {"THE GLOB", MCH_THEGLOB, true},
 #endif
 #ifdef ENABLE_CRUSH
-  if (SD.exists("/ARCADE/CRUSH/rom1.bin"))
-    arcadeGames[arcadeMachineCount++] = {"CRUSH ROLLER", MCH_CRUSH, true};
+  {"CRUSH ROLLER", MCH_CRUSH, true},
 #endif
 #ifdef ENABLE_ANTEATER
-  if (SD.exists("/ARCADE/ANTEATER/rom1.bin") && SD.exists("/ARCADE/ANTEATER/rom2.bin"))
-    arcadeGames[arcadeMachineCount++] = {"ANTEATER", MCH_ANTEATER, true};
+  {"ANTEATER", MCH_ANTEATER, true},
 #endif
 #ifdef ENABLE_LADYBUG
-  // ROM embedded in PROGMEM - SD optional (override)
-  arcadeGames[arcadeMachineCount++] = {"LADY BUG", MCH_LADYBUG, true};
+  {"LADY BUG", MCH_LADYBUG, true},   // ROM embedded in PROGMEM - SD optional (override)
 #endif
 #ifdef ENABLE_XEVIOUS
-  if (SD.exists("/ARCADE/XEVIOUS/rom1.bin") && SD.exists("/ARCADE/XEVIOUS/rom2.bin") && SD.exists("/ARCADE/XEVIOUS/rom3.bin"))
-    arcadeGames[arcadeMachineCount++] = {"XEVIOUS", MCH_XEVIOUS, true};
+  {"XEVIOUS", MCH_XEVIOUS, true},
 #endif
 #ifdef ENABLE_BOMBJACK
-  if (SD.exists("/ARCADE/BOMBJACK/rom1.bin"))
-    arcadeGames[arcadeMachineCount++] = {"BOMB JACK", MCH_BOMBJACK, true};
+  {"BOMB JACK", MCH_BOMBJACK, true},
 #endif
 #ifdef ENABLE_GYRUSS
-  // ROM embedded in PROGMEM - SD optional (override)
-  arcadeGames[arcadeMachineCount++] = {"GYRUSS", MCH_GYRUSS, true};
+  {"GYRUSS", MCH_GYRUSS, true},      // ROM embedded in PROGMEM - SD optional (override)
 #endif
+};
+#define ARCADE_COMPILED_COUNT (sizeof(arcadeCompiledGames) / sizeof(arcadeCompiledGames[0]))
+
+// ===== ROM Index (/ARCADE/romindex.txt) =====
+// Una riga per ROM trovata: tipo|slot|path|offset|size|crc32
+//   offset = 8 se il file ha header GALG, altrimenti 0; size = byte di dati ROM
+// Il menu si costruisce con UNA lettura dell'indice invece di ~30 SD.exists().
+// L'indice viene rigenerato se manca, dopo upload/delete e su /arcade/roms/refresh,
+// e se la firma delle cartelle ROM (nome, dimensione e data di ogni file) e'
+// cambiata: file copiati a mano sulla SD. La firma costa un listing completo
+// di /ARCADE e /roms, quindi si controlla una volta per boot; i rientri nel menu
+// usano l'indice gia' in RAM. Una CRC errata all'avvio di un gioco riscansiona
+// solo quel gioco e rimanda il resto al boot successivo.
+#define ARC_ROM_SLOTS      5      // rom1..rom3 + banchi 1942 (indici 2..4)
+#define ARC_ROM_INDEX_PATH "/ARCADE/romindex.txt"
+#define ARC_ROM_READ_CHUNK (32 * 1024)   // letture sequenziali grandi (SD SPI a burst)
+
+struct ArcadeRomIndexEntry {
+  uint8_t machineType;
+  bool ok;                                // tutte le ROM richieste presenti (known-good)
+  uint8_t slotMask;                       // bit i = slot i presente
+  char path[ARC_ROM_SLOTS][40];
+  uint32_t offset[ARC_ROM_SLOTS];
+  uint32_t size[ARC_ROM_SLOTS];
+  uint32_t crc[ARC_ROM_SLOTS];
+};
+
+ArcadeRomIndexEntry arcadeRomIndex[ARCADE_MAX_GAMES];
+int arcadeRomIndexCount = 0;
+bool arcadeRomIndexVerified = false;      // firma cartelle confrontata in questo boot
+
+// Cache ROM in PSRAM: un'arena contigua per gioco, mantenuta tra menu e partita
+struct ArcadeRomCache {
+  int8_t machineType;                     // -1 = vuota
+  unsigned char* arena;
+  uint32_t arenaSize;
+  uint32_t slotOffset[ARC_ROM_SLOTS];
+};
+ArcadeRomCache arcadeRomCache = {-1, nullptr, 0, {0}};
+#define ARC_ROM_CACHE_MIN_FREE_PSRAM (1024 * 1024)  // tieni la cache solo se resta >=1MB PSRAM
+
+// Statistiche ultimo avvio (esposte su /arcade/status)
+uint32_t arcadeLastLoadMs = 0;         // tempo caricamento ROM
+uint32_t arcadeLastLoadBytes = 0;
+uint32_t arcadeLastStartMs = 0;        // tap → primo frame di gioco
+bool arcadeLastLoadCached = false;
+unsigned long arcadeStartRequestMs = 0;
+
+// Nome file per slot (nullptr = slot non usato dal gioco)
+const char* arcadeRomSlotFile(uint8_t machineType, int slot) {
+  static const char* genericNames[] = {"rom1.bin", "rom2.bin", "rom3.bin", "rom4.bin", "rom5.bin"};
+  static const char* bankNames[] = {"rom1_b0.bin", "rom1_b1.bin", "rom1_b2.bin"};
+  if (machineType == MCH_1942) {
+    if (slot < 2) return genericNames[slot];
+    if (slot < 5) return bankNames[slot - 2];
+    return nullptr;
+  }
+  if (slot < EXTERNAL_ROM_MAX && slot < ARC_ROM_SLOTS) return genericNames[slot];
+  return nullptr;
+}
+
+ArcadeRomIndexEntry* arcadeRomIndexFind(uint8_t machineType) {
+  for (int i = 0; i < arcadeRomIndexCount; i++) {
+    if (arcadeRomIndex[i].machineType == machineType) return &arcadeRomIndex[i];
+  }
+  return nullptr;
+}
+
+// Known-good: tutte le rom1..romN richieste (+ banchi 1942) presenti
+bool arcadeRomIndexIsComplete(const ArcadeRomIndexEntry* e) {
+  int required = arcadeRequiredRomCount(e->machineType);
+  uint8_t need = (1 << required) - 1;
+  if (e->machineType == MCH_1942) need |= 0x1C;
+  return (e->slotMask & need) == need;
+}
+
+// Rilegge un file ROM calcolando offset GALG, size e CRC32 dei soli dati
+bool arcadeRomProbeFile(const char* path, uint8_t* buf, uint32_t &outOffset, uint32_t &outSize, uint32_t &outCrc) {
+  File f = SD.open(path, FILE_READ);
+  if (!f || f.isDirectory()) {
+    if (f) f.close();
+    return false;
+  }
+  uint32_t fileSize = f.size();
+  if (fileSize == 0 || fileSize > 512 * 1024) { f.close(); return false; }
+  outOffset = 0;
+  outSize = fileSize;
+  if (fileSize > 8) {
+    unsigned char header[8];
+    if (f.read(header, 8) == 8 && header[0] == 0x47 && header[1] == 0x41 &&
+        header[2] == 0x4C && header[3] == 0x47) {
+      uint32_t sz = header[4] | (header[5] << 8) | (header[6] << 16) | (header[7] << 24);
+      if (sz > 0 && sz <= fileSize - 8) { outOffset = 8; outSize = sz; }
+    }
+    f.seek(outOffset);
+  }
+  uint32_t crc = 0, done = 0;
+  while (done < outSize) {
+    uint32_t chunk = outSize - done > ARC_ROM_READ_CHUNK ? ARC_ROM_READ_CHUNK : outSize - done;
+    size_t rd = f.read(buf, chunk);
+    if (rd == 0) break;
+    crc = esp_rom_crc32_le(crc, buf, rd);
+    done += rd;
+    yield();
+  }
+  f.close();
+  outCrc = crc;
+  return done == outSize;
+}
+
+// Firma delle cartelle ROM: /ARCADE/<GIOCO>/ e /roms/<gioco>/, solo directory
+// listing (nessuna lettura dei dati). replay.bin non conta: cambia a ogni record.
+uint32_t arcadeRomFolderSignature() {
+  static const char* roots[] = {"/ARCADE", "/roms"};
+  uint32_t sig = 0, files = 0;
+  for (int r = 0; r < 2; r++) {
+    File root = SD.open(roots[r]);
+    if (!root || !root.isDirectory()) {
+      if (root) root.close();
+      continue;
+    }
+    File dir = root.openNextFile();
+    while (dir) {
+      if (dir.isDirectory()) {
+        File f = dir.openNextFile();
+        while (f) {
+          const char* name = strrchr(f.name(), '/');
+          name = name ? name + 1 : f.name();
+          if (!f.isDirectory() && strcmp(name, "replay.bin") != 0) {
+            struct { uint32_t size, mtime; } st = {(uint32_t)f.size(), (uint32_t)f.getLastWrite()};
+            sig = esp_rom_crc32_le(sig, (const uint8_t*)dir.name(), strlen(dir.name()));
+            sig = esp_rom_crc32_le(sig, (const uint8_t*)name, strlen(name));
+            sig = esp_rom_crc32_le(sig, (const uint8_t*)&st, sizeof(st));
+            files++;
+          }
+          f.close();
+          f = dir.openNextFile();
+        }
+      }
+      dir.close();
+      dir = root.openNextFile();
+    }
+    root.close();
+  }
+  return esp_rom_crc32_le(sig, (const uint8_t*)&files, sizeof(files));
+}
+
+// Cerca e rilegge le ROM di un gioco (buf = nullptr: entry vuota, solo PROGMEM)
+void arcadeRomIndexProbeEntry(ArcadeRomIndexEntry &e, uint8_t type, uint8_t* buf) {
+  memset(&e, 0, sizeof(e));
+  e.machineType = type;
+  const char* folder = arcadeGetRomFolder(type);
+  for (int slot = 0; buf && folder && slot < ARC_ROM_SLOTS; slot++) {
+    const char* fname = arcadeRomSlotFile(type, slot);
+    if (!fname) continue;
+    if (!arcadeFindRomFile(e.path[slot], sizeof(e.path[slot]), folder, arcadeGetRomFolderGalag(type), fname)) {
+      e.path[slot][0] = 0;
+      continue;
+    }
+    if (arcadeRomProbeFile(e.path[slot], buf, e.offset[slot], e.size[slot], e.crc[slot])) {
+      e.slotMask |= (1 << slot);
+    } else {
+      e.path[slot][0] = 0;
+    }
+  }
+  e.ok = arcadeRomIndexIsComplete(&e);
+}
+
+// Scrive l'indice in RAM su SD con la firma cartelle data (0 = da rigenerare al prossimo boot)
+void arcadeRomIndexSave(uint32_t sig) {
+  File f = SD.open(ARC_ROM_INDEX_PATH, FILE_WRITE);
+  if (!f) return;
+  f.printf("#ROMIDX2 %08lX\n", (unsigned long)sig);
+  for (int i = 0; i < arcadeRomIndexCount; i++) {
+    ArcadeRomIndexEntry &e = arcadeRomIndex[i];
+    for (int slot = 0; slot < ARC_ROM_SLOTS; slot++) {
+      if (!(e.slotMask & (1 << slot))) continue;
+      f.printf("%u|%d|%s|%lu|%lu|%08lX\n", e.machineType, slot, e.path[slot],
+               (unsigned long)e.offset[slot], (unsigned long)e.size[slot], (unsigned long)e.crc[slot]);
+    }
+  }
+  f.close();
+}
+
+// Scansione completa SD (entrambe le convenzioni cartelle) e scrittura indice
+void arcadeRomIndexRebuild() {
+  unsigned long t0 = millis();
+  arcadeRomIndexCount = 0;
+  uint32_t sig = arcadeRomFolderSignature();
+  arcadeRomIndexVerified = true;
+  // Senza buffer di lettura niente probe SD, ma i giochi PROGMEM restano nel menu
+  // (l'indice non viene scritto: si riprova al prossimo ingresso)
+  uint8_t* buf = (uint8_t*)ps_malloc(ARC_ROM_READ_CHUNK);
+  if (!buf) Serial.println("[ARCADE] Indice ROM: PSRAM insufficiente, solo giochi PROGMEM");
+
+  for (size_t g = 0; g < ARCADE_COMPILED_COUNT && arcadeRomIndexCount < ARCADE_MAX_GAMES; g++) {
+    uint8_t type = arcadeCompiledGames[g].machineType;
+    if (!arcadeGetRomFolder(type)) continue;
+    arcadeRomIndexProbeEntry(arcadeRomIndex[arcadeRomIndexCount++], type, buf);
+  }
+  if (!buf) {
+    arcadeRomIndexVerified = false;
+    return;
+  }
+  free(buf);
+
+  arcadeRomIndexSave(sig);
+  Serial.printf("[ARCADE] Indice ROM rigenerato: %d giochi in %lu ms\n", arcadeRomIndexCount, millis() - t0);
+}
+
+// CRC errata al caricamento: riscansiona solo il gioco in avvio e salva l'indice
+// con firma nulla, cosi' il resto viene verificato al prossimo boot invece di
+// bloccare l'avvio con una scansione completa
+bool arcadeRomIndexRebuildEntry(uint8_t machineType) {
+  ArcadeRomIndexEntry* e = arcadeRomIndexFind(machineType);
+  if (!e) return false;
+  uint8_t* buf = (uint8_t*)ps_malloc(ARC_ROM_READ_CHUNK);
+  if (!buf) return false;
+  unsigned long t0 = millis();
+  arcadeRomIndexProbeEntry(*e, machineType, buf);
+  free(buf);
+  arcadeRomIndexSave(0);
+  Serial.printf("[ARCADE] Indice ROM: gioco %u riscansionato in %lu ms\n", machineType, millis() - t0);
+  return e->ok;
+}
+
+// Lettura indice in un colpo solo. Ritorna false se assente/non valido o se
+// (primo caricamento del boot) le cartelle ROM sono cambiate rispetto alla
+// firma salvata nell'header. Con l'indice gia' in RAM non tocca la SD.
+bool arcadeRomIndexLoad() {
+  if (arcadeRomIndexCount > 0 && arcadeRomIndexVerified) return true;
+  arcadeRomIndexCount = 0;
+  File f = SD.open(ARC_ROM_INDEX_PATH, FILE_READ);
+  if (!f) return false;
+  String header = f.readStringUntil('\n');
+  header.trim();
+  if (!header.startsWith("#ROMIDX2 ")) { f.close(); return false; }
+  uint32_t sig = strtoul(header.c_str() + 9, nullptr, 16);
+  if (!arcadeRomIndexVerified) {
+    if (sig == 0 || sig != arcadeRomFolderSignature()) {
+      Serial.println("[ARCADE] Cartelle ROM modificate: indice da rigenerare");
+      f.close();
+      return false;
+    }
+    arcadeRomIndexVerified = true;
+  }
+
+  // Un entry per ogni gioco compilato (anche senza ROM: i PROGMEM sono comunque ok)
+  for (size_t g = 0; g < ARCADE_COMPILED_COUNT && arcadeRomIndexCount < ARCADE_MAX_GAMES; g++) {
+    ArcadeRomIndexEntry &e = arcadeRomIndex[arcadeRomIndexCount++];
+    memset(&e, 0, sizeof(e));
+    e.machineType = arcadeCompiledGames[g].machineType;
+  }
+
+  while (f.available()) {
+    String line = f.readStringUntil('\n');
+    line.trim();
+    if (line.length() == 0 || line[0] == '#') continue;
+    int p1 = line.indexOf('|'), p2 = line.indexOf('|', p1 + 1), p3 = line.indexOf('|', p2 + 1);
+    int p4 = line.indexOf('|', p3 + 1), p5 = line.indexOf('|', p4 + 1);
+    if (p1 < 0 || p2 < 0 || p3 < 0 || p4 < 0 || p5 < 0) continue;
+    ArcadeRomIndexEntry* e = arcadeRomIndexFind(line.substring(0, p1).toInt());
+    int slot = line.substring(p1 + 1, p2).toInt();
+    if (!e || slot < 0 || slot >= ARC_ROM_SLOTS) continue;
+    strlcpy(e->path[slot], line.substring(p2 + 1, p3).c_str(), sizeof(e->path[slot]));
+    e->offset[slot] = strtoul(line.substring(p3 + 1, p4).c_str(), nullptr, 10);
+    e->size[slot] = strtoul(line.substring(p4 + 1, p5).c_str(), nullptr, 10);
+    e->crc[slot] = strtoul(line.substring(p5 + 1).c_str(), nullptr, 16);
+    e->slotMask |= (1 << slot);
+  }
+  f.close();
+  for (int i = 0; i < arcadeRomIndexCount; i++) {
+    arcadeRomIndex[i].ok = arcadeRomIndexIsComplete(&arcadeRomIndex[i]);
+  }
+  return true;
+}
+
+void arcadeRomCacheFree() {
+  if (arcadeRomCache.arena) free(arcadeRomCache.arena);
+  arcadeRomCache.arena = nullptr;
+  arcadeRomCache.arenaSize = 0;
+  arcadeRomCache.machineType = -1;
+}
+
+// Chiamato dopo upload/delete/refresh: indice e cache non sono piu' affidabili
+void arcadeRomIndexInvalidate() {
+  // Con un gioco in corso l'arena e' in uso: marcala solo come non riutilizzabile
+  if (arcadeInMenu) arcadeRomCacheFree();
+  else arcadeRomCache.machineType = -1;
+  if (SD.exists(ARC_ROM_INDEX_PATH)) SD.remove(ARC_ROM_INDEX_PATH);
+  arcadeRomIndexCount = 0;
+}
+
+// ===== Build Game List (only games with ROM files on SD) =====
+// Check ALL required ROMs per game (multi-CPU games need rom2/rom3 too!)
+// Without all ROMs, sub-CPUs read from 1-byte PROGMEM stub → crash
+void arcadeBuildGameList() {
+  arcadeMachineCount = 0;
+  if (!arcadeRomIndexLoad()) arcadeRomIndexRebuild();
+
+  for (size_t g = 0; g < ARCADE_COMPILED_COUNT && arcadeMachineCount < ARCADE_MAX_GAMES; g++) {
+    ArcadeRomIndexEntry* e = arcadeRomIndexFind(arcadeCompiledGames[g].machineType);
+    if (e && e->ok) arcadeGames[arcadeMachineCount++] = arcadeCompiledGames[g];
+  }
 }
 
 // ===== Buffer Management =====
@@ -581,10 +938,10 @@ unsigned char* arcadeLoadRomFromSD(const char* path, uint32_t &outSize) {
     return nullptr;
   }
 
-  // Read in 4KB chunks
+  // Read in large sequential chunks (32KB)
   uint32_t offset = 0;
   while (offset < dataSize) {
-    uint32_t chunk = (dataSize - offset > 4096) ? 4096 : (dataSize - offset);
+    uint32_t chunk = (dataSize - offset > ARC_ROM_READ_CHUNK) ? ARC_ROM_READ_CHUNK : (dataSize - offset);
     size_t rd = f.read(buf + offset, chunk);
     if (rd == 0) break;
     offset += rd;
@@ -661,51 +1018,138 @@ bool arcadeFindRomFile(char* outPath, size_t pathLen, const char* folder, const
   return false;
 }
 
-// Load external ROMs from SD for a machine
+// Legacy loader: un ps_malloc per file (usato se l'indice non e' affidabile)
 // Searches both /ARCADE/GAME/ and /roms/game/ (galag compatibility)
 // Supports raw binary and GALG header format
 // Generic: rom1.bin, rom2.bin, rom3.bin (indices 0,1,2)
 // 1942 extra: rom1_b0.bin, rom1_b1.bin, rom1_b2.bin (indices 2,3,4)
-void arcadeLoadExternalRoms(machineBase* machine, uint8_t machineType) {
+void arcadeLoadExternalRomsLegacy(machineBase* machine, uint8_t machineType) {
   const char* folder = arcadeGetRomFolder(machineType);
   if (!folder) return;
   const char* galagFolder = arcadeGetRomFolderGalag(machineType);
 
-  // Generic ROM loading (rom1..rom3 → indices 0..2)
-  int genericMax = (machineType == MCH_1942) ? 2 : EXTERNAL_ROM_MAX;
-  int loadedCount = 0;
-  for (int i = 0; i < genericMax; i++) {
-    char romName[20];
-    snprintf(romName, sizeof(romName), "rom%d.bin", i + 1);
+  for (int slot = 0; slot < ARC_ROM_SLOTS; slot++) {
+    const char* fname = arcadeRomSlotFile(machineType, slot);
+    if (!fname) continue;
     char path[64];
-    bool found = arcadeFindRomFile(path, sizeof(path), folder, galagFolder, romName);
-    if (found) {
-      uint32_t sz = 0;
-      unsigned char* data = arcadeLoadRomFromSD(path, sz);
-      if (data) {
-        machine->externalRom[i] = data;
-        machine->externalRomSize[i] = sz;
-        loadedCount++;
-      }
+    if (!arcadeFindRomFile(path, sizeof(path), folder, galagFolder, fname)) continue;
+    uint32_t sz = 0;
+    unsigned char* data = arcadeLoadRomFromSD(path, sz);
+    if (data) {
+      machine->externalRom[slot] = data;
+      machine->externalRomSize[slot] = sz;
+      arcadeLastLoadBytes += sz;
     }
   }
+}
 
-  // 1942 bank ROMs: rom1_b0.bin→idx2, rom1_b1.bin→idx3, rom1_b2.bin→idx4
-  if (machineType == MCH_1942) {
-    const char* bankNames[] = {"rom1_b0.bin", "rom1_b1.bin", "rom1_b2.bin"};
-    for (int b = 0; b < 3; b++) {
-      char path[64];
-      bool found = arcadeFindRomFile(path, sizeof(path), folder, galagFolder, bankNames[b]);
-      if (found) {
-        uint32_t sz = 0;
-        unsigned char* data = arcadeLoadRomFromSD(path, sz);
-        if (data) {
-          machine->externalRom[2 + b] = data;
-          machine->externalRomSize[2 + b] = sz;
-        }
-      }
+// Assegna alla macchina i puntatori dentro l'arena della cache
+void arcadeApplyRomCache(machineBase* machine, const ArcadeRomIndexEntry* e) {
+  for (int slot = 0; slot < ARC_ROM_SLOTS; slot++) {
+    if (!(e->slotMask & (1 << slot))) continue;
+    machine->externalRom[slot] = arcadeRomCache.arena + arcadeRomCache.slotOffset[slot];
+    machine->externalRomSize[slot] = e->size[slot];
+  }
+}
+
+// Legge tutte le ROM del gioco in un'unica arena PSRAM contigua, con letture
+// sequenziali da 32KB e verifica CRC32 contro l'indice. Se il gioco e' gia'
+// in cache (rientro dal menu) non tocca la SD.
+void arcadeLoadExternalRoms(machineBase* machine, uint8_t machineType) {
+  unsigned long t0 = millis();
+  arcadeLastLoadBytes = 0;
+  arcadeLastLoadCached = false;
+
+  ArcadeRomIndexEntry* e = arcadeRomIndexFind(machineType);
+  if (!e || e->slotMask == 0) {
+    // Nessuna ROM indicizzata (es. giochi PROGMEM): tentativo legacy
+    arcadeLoadExternalRomsLegacy(machine, machineType);
+    arcadeLastLoadMs = millis() - t0;
+    return;
+  }
+
+  if (arcadeRomCache.arena && arcadeRomCache.machineType == (int8_t)machineType) {
+    arcadeApplyRomCache(machine, e);
+    arcadeLastLoadCached = true;
+    arcadeLastLoadMs = millis() - t0;
+    Serial.printf("[ARCADE] ROM da cache PSRAM (%lu KB) in %lu ms\n",
+                  (unsigned long)(arcadeRomCache.arenaSize / 1024), (unsigned long)arcadeLastLoadMs);
+    return;
+  }
+
+  // Cache di un solo gioco: libera quella precedente
+  arcadeRomCacheFree();
+
+  uint32_t total = 0;
+  for (int slot = 0; slot < ARC_ROM_SLOTS; slot++) {
+    if (!(e->slotMask & (1 << slot))) continue;
+    arcadeRomCache.slotOffset[slot] = total;
+    total += (e->size[slot] + 3) & ~3u;  // allineamento 4 byte per accessi 32-bit
+  }
+  unsigned char* arena = (unsigned char*)ps_malloc(total);
+  if (!arena) {
+    arcadeLoadExternalRomsLegacy(machine, machineType);
+    arcadeLastLoadMs = millis() - t0;
+    return;
+  }
+
+  bool valid = true;
+  for (int slot = 0; slot < ARC_ROM_SLOTS && valid; slot++) {
+    if (!(e->slotMask & (1 << slot))) continue;
+    File f = SD.open(e->path[slot], FILE_READ);
+    if (!f) { valid = false; break; }
+    f.seek(e->offset[slot]);
+    unsigned char* dst = arena + arcadeRomCache.slotOffset[slot];
+    uint32_t done = 0;
+    while (done < e->size[slot]) {
+      uint32_t chunk = e->size[slot] - done;
+      if (chunk > ARC_ROM_READ_CHUNK) chunk = ARC_ROM_READ_CHUNK;
+      size_t rd = f.read(dst + done, chunk);
+      if (rd == 0) break;
+      done += rd;
+      yield();
+    }
+    f.close();
+    if (done != e->size[slot] || esp_rom_crc32_le(0, dst, done) != e->crc[slot]) {
+      Serial.printf("[ARCADE] CRC/size mismatch su %s, indice obsoleto\n", e->path[slot]);
+      valid = false;
+    }
+    arcadeLastLoadBytes += done;
+  }
+
+  if (!valid) {
+    // File cambiati sulla SD: riscansiona solo questo gioco e carica alla vecchia maniera
+    free(arena);
+    arcadeRomIndexRebuildEntry(machineType);
+    arcadeLastLoadBytes = 0;
+    arcadeLoadExternalRomsLegacy(machine, machineType);
+    arcadeLastLoadMs = millis() - t0;
+    return;
+  }
+
+  arcadeRomCache.machineType = machineType;
+  arcadeRomCache.arena = arena;
+  arcadeRomCache.arenaSize = total;
+  arcadeApplyRomCache(machine, e);
+
+  arcadeLastLoadMs = millis() - t0;
+  uint32_t kbps = arcadeLastLoadMs ? (arcadeLastLoadBytes / arcadeLastLoadMs) : 0;  // byte/ms = KB/s
+  Serial.printf("[ARCADE] ROM caricate: %lu KB in %lu ms (%lu KB/s)\n",
+                (unsigned long)(arcadeLastLoadBytes / 1024), (unsigned long)arcadeLastLoadMs, (unsigned long)kbps);
+}
+
+// Prima di delete machine: stacca i puntatori dell'arena (la possiede la cache)
+// e decide se tenerla per il prossimo avvio in base alla PSRAM libera
+void arcadeReleaseRomCache(machineBase* machine) {
+  if (!arcadeRomCache.arena) return;
+  for (int slot = 0; slot < ARC_ROM_SLOTS; slot++) {
+    unsigned char* p = machine->externalRom[slot];
+    if (p >= arcadeRomCache.arena && p < arcadeRomCache.arena + arcadeRomCache.arenaSize) {
+      machine->externalRom[slot] = nullptr;
+      machine->externalRomSize[slot] = 0;
     }
   }
+  if (ESP.getFreePsram() < ARC_ROM_CACHE_MIN_FREE_PSRAM) arcadeRomCacheFree();
 }
 
 // ===== Required ROM count per machine type =====
@@ -808,6 +1252,8 @@ machineBase* arcadeCreateMachine(uint8_t type) {
 // ===== Start Game =====
 void arcadeStartGame(int8_t index) {
   if (index < 0 || index >= arcadeMachineCount) return;
+  arcadeStartRequestMs = millis();
+  arcadeLastStartMs = 0;
 
   // Loading screen with game icon
   gfx->fillScreen(BLACK);
@@ -880,6 +1326,7 @@ void arcadeStartGame(int8_t index) {
     gfx->setTextColor(0xF800);
     gfx->setCursor(60, 300);
     gfx->print("ROM mancanti! Serve /ARCADE con i .bin");
+    arcadeReleaseRomCache(arcadeCurrentMachine);
     delete arcadeCurrentMachine;
     arcadeCurrentMachine = nullptr;
     arcadeInMenu = true;
@@ -926,6 +1373,13 @@ void arcadeStartGame(int8_t index) {
   arcadeStartState = 0;
   arcadeFrameCount = 0;
   arcadeBootFrames = 0;
+  arcadeProfileReset();
+  if (arcadeRecordActive) {
+    // Buffer di registrazione: riusa lo storage del replay
+    arcadeReplayFree();
+    arcadeReplayData = (uint8_t*)ps_malloc(ARCADE_REPLAY_MAX_FRAMES);
+    if (!arcadeReplayData) arcadeRecordActive = false;
+  }
   arcadeBootStartMs = millis();
   arcadeLastFrameTime = millis();
 
@@ -940,6 +1394,8 @@ void arcadeStartGame(int8_t index) {
   if (maxBlock < stackSize + 1024) stackSize = 12288;
   if (maxBlock < stackSize + 1024) stackSize = 8192;
 
+  arcadeEmuStopRequest = false;
+  arcadeEmuRunning = true;
   BaseType_t taskResult = xTaskCreatePinnedToCore(
     arcadeEmulationTask,
     "arcadeZ80",
@@ -951,6 +1407,8 @@ void arcadeStartGame(int8_t index) {
   );
 
   if (taskResult != pdPASS) {
+    arcadeEmuRunning = false;
+    arcadeEmulationTaskHandle = nullptr;
     gfx->setTextSize(1);
     gfx->setTextColor(0xF800);
     gfx->setCursor(80, 300);
@@ -970,19 +1428,31 @@ void arcadeStopGame() {
   // Clear crash tracking flag (normal exit, not a crash)
   arcadeCrashFlag = 0;
 
-  // Delete emulation task
+  // Stop emulation task: chiede l'uscita e attende che il task termini il frame
+  // (mutex e DMA audio restano in uno stato coerente, niente vTaskDelete dall'esterno)
   if (arcadeEmulationTaskHandle) {
-    vTaskDelete(arcadeEmulationTaskHandle);
+    arcadeEmuStopRequest = true;
+    while (arcadeEmuRunning) vTaskDelay(1);
     arcadeEmulationTaskHandle = nullptr;
+    arcadeEmuStopRequest = false;
     // Let FreeRTOS idle task reclaim the 32KB task stack before we proceed
     vTaskDelay(pdMS_TO_TICKS(50));
   }
 
+  // Report profilo + salvataggio eventuale registrazione input
+  arcadeProfilePrint();
+  if (arcadeRecordActive && arcadeSelectedGame >= 0) {
+    arcadeReplaySave(arcadeGames[arcadeSelectedGame].machineType);
+    arcadeRecordActive = false;
+  }
+  arcadeReplayFree();
+
   // Stop arcade audio before deleting machine
   if (arcadeAudio) arcadeAudio->stop();
 
   // Delete machine
   if (arcadeCurrentMachine) {
+    arcadeReleaseRomCache(arcadeCurrentMachine);
     delete arcadeCurrentMachine;
     arcadeCurrentMachine = nullptr;
   }
@@ -1009,6 +1479,136 @@ void arcadeStopGame() {
 
 }
 
+// ===== Profiling & Replay =====
+void arcadeProfileReset() {
+  memset(&arcadeProfile, 0, sizeof(arcadeProfile));
+}
+
+// Stampa il report su seriale (chiamato a fine replay e su arcadeStopGame)
+void arcadeProfilePrint() {
+  if (arcadeProfile.emuFrames == 0) return;
+  uint32_t emuAvg = (uint32_t)(arcadeProfile.emuUsTotal / arcadeProfile.emuFrames);
+  uint64_t samples = arcadeProfile.audioSamples;
+  uint32_t audPerFrame = (uint32_t)(samples / arcadeProfile.emuFrames);
+  uint32_t audNs = samples ? (uint32_t)(arcadeProfile.audioUsTotal * 1000 / samples) : 0;
+  uint32_t renAvg = arcadeProfile.renderFrames ? (uint32_t)(arcadeProfile.renderUsTotal / arcadeProfile.renderFrames) : 0;
+  uint32_t audAvg = (uint32_t)(arcadeProfile.audioUsTotal / arcadeProfile.emuFrames);
+  Serial.printf("[ARCADE-PROF] %s: emu %lu frame, %lu us/frame (max %lu), transmit %lu us/frame\n",
+                arcadeSelectedGame >= 0 ? arcadeGames[arcadeSelectedGame].name : "?",
+                (unsigned long)arcadeProfile.emuFrames, (unsigned long)emuAvg,
+                (unsigned long)arcadeProfile.emuUsMax, (unsigned long)audAvg);
+  if (samples)
+    Serial.printf("[ARCADE-PROF] audio %lu campioni/frame, %lu ns/campione\n",
+                  (unsigned long)audPerFrame, (unsigned long)audNs);
+  else
+    Serial.println("[ARCADE-PROF] audio: transmit() non riporta i campioni scritti");
+  Serial.printf("[ARCADE-PROF] render %lu frame, %lu us/frame (max %lu), trace CRC %08lX, frame CRC %08lX\n",
+                (unsigned long)arcadeProfile.renderFrames, (unsigned long)renAvg,
+                (unsigned long)arcadeProfile.renderUsMax,
+                (unsigned long)arcadeProfile.traceCrc, (unsigned long)arcadeProfile.frameCrc);
+}
+
+// Carica /ARCADE/<GIOCO>/replay.bin in PSRAM. Ritorna false se assente.
+bool arcadeReplayLoad(uint8_t machineType) {
+  arcadeReplayFree();
+  const char* folder = arcadeGetRomFolder(machineType);
+  if (!folder) return false;
+  char path[64];
+  snprintf(path, sizeof(path), "/ARCADE/%s/replay.bin", folder);
+  File f = SD.open(path, FILE_READ);
+  if (!f) return false;
+  uint32_t len = f.size();
+  if (len > ARCADE_REPLAY_MAX_FRAMES) len = ARCADE_REPLAY_MAX_FRAMES;
+  if (len == 0) { f.close(); return false; }
+  arcadeReplayData = (uint8_t*)ps_malloc(len);
+  if (!arcadeReplayData) { f.close(); return false; }
+  arcadeReplayLen = f.read(arcadeReplayData, len);
+  f.close();
+  arcadeReplayPos = 0;
+  arcadeReplayDone = false;
+  Serial.printf("[ARCADE-PROF] Replay caricato: %s (%lu frame)\n", path, (unsigned long)arcadeReplayLen);
+  return arcadeReplayLen > 0;
+}
+
+// Salva gli input registrati (arcadeRecordActive) su /ARCADE/<GIOCO>/replay.bin
+void arcadeReplaySave(uint8_t machineType) {
+  const char* folder = arcadeGetRomFolder(machineType);
+  if (!folder || !arcadeReplayData || arcadeReplayPos == 0) return;
+  char path[64];
+  snprintf(path, sizeof(path), "/ARCADE/%s/replay.bin", folder);
+  File f = SD.open(path, FILE_WRITE);
+  if (!f) return;
+  f.write(arcadeReplayData, arcadeReplayPos);
+  f.close();
+  Serial.printf("[ARCADE-PROF] Replay salvato: %s (%lu frame)\n", path, (unsigned long)arcadeReplayPos);
+}
+
+void arcadeReplayFree() {
+  arcadeReplayActive = false;
+  if (arcadeReplayData) { free(arcadeReplayData); arcadeReplayData = nullptr; }
+  arcadeReplayLen = 0;
+  arcadeReplayPos = 0;
+}
+
+// Avvia un gioco in replay (replay.bin) o registrando gli input.
+// false se l'indice non e' valido o manca replay.bin
+bool arcadeStartBenchmark(int gameIdx, bool record) {
+  if (gameIdx < 0 || gameIdx >= arcadeMachineCount) return false;
+  if (!arcadeInMenu) {
+    arcadeStopGame();
+    delay(100);
+  }
+  arcadeRecordActive = record;
+  if (!record && !arcadeReplayLoad(arcadeGames[gameIdx].machineType)) return false;
+  arcadeStartGame(gameIdx);
+  if (!record) arcadeReplayActive = (arcadeCurrentMachine != nullptr);
+  return true;
+}
+
+// ===== Comandi seriali (nel modo arcade il WiFi e' spento) =====
+// "replay <n>", "record <n>", "stop", "prof"
+void arcadeCheckSerial() {
+  static char line[24];
+  static uint8_t len = 0;
+  while (Serial.available()) {
+    char c = Serial.read();
+    if (c != '\n' && c != '\r') {
+      if (len < sizeof(line) - 1) line[len++] = c;
+      continue;
+    }
+    if (len == 0) continue;
+    line[len] = 0;
+    len = 0;
+    int idx = -1;
+    if (sscanf(line, "replay %d", &idx) == 1) {
+      if (!arcadeStartBenchmark(idx, false)) Serial.println("[ARCADE-PROF] Gioco non valido o replay.bin assente");
+    } else if (sscanf(line, "record %d", &idx) == 1) {
+      if (!arcadeStartBenchmark(idx, true)) Serial.println("[ARCADE-PROF] Gioco non valido");
+    } else if (!strcmp(line, "stop")) {
+      if (!arcadeInMenu) arcadeStopGame();
+    } else if (!strcmp(line, "prof")) {
+      arcadeProfilePrint();
+    }
+  }
+}
+
+// Frame CRC del replay: framebuffer nativo renderizzato sul task Z80 subito dopo
+// run_frame, quindi stesso input = stessa immagine (il render del Core 1 salta
+// frame a seconda del carico e non e' confrontabile tra build)
+static uint32_t arcadeEmuFrameCrc(uint32_t crc) {
+  int rowPixels = arcadeCurrentMachine->gameWidth() * 8;
+  int rows = arcadeCurrentMachine->gameHeight() / 8;
+  xSemaphoreTake(arcadeRenderMutex, portMAX_DELAY);
+  arcadeCurrentMachine->prepare_frame();
+  for (int r = 0; r < rows; r++) {
+    memset(arcadeFrameBuffer, 0, rowPixels * sizeof(unsigned short));
+    arcadeCurrentMachine->render_row(r);
+    crc = esp_rom_crc32_le(crc, (const uint8_t*)arcadeFrameBuffer, rowPixels * sizeof(unsigned short));
+  }
+  xSemaphoreGive(arcadeRenderMutex);
+  return crc;
+}
+
 // ===== Emulation Task (Core 0) =====
 void arcadeEmulationTask(void* param) {
   // Rimuovi questo task dal Task Watchdog Timer
@@ -1019,7 +1619,7 @@ void arcadeEmulationTask(void* param) {
   int bootFrames = 0;
 
   TickType_t lastWake = xTaskGetTickCount();
-  while (true) {
+  while (!arcadeEmuStopRequest) {
     if (arcadeCurrentMachine) {
       if (!arcadeCurrentMachine->game_started) {
         // BOOT: 20 frames per yield (come versione funzionante)
@@ -1041,16 +1641,52 @@ void arcadeEmulationTask(void* param) {
         unsigned long elapsed = millis() - emuStart;
         if (elapsed > 60000) {
           arcadeCurrentMachine->game_started = -1;
-          while (true) { vTaskDelay(1000); }
+          while (!arcadeEmuStopRequest) { vTaskDelay(10); }
+          break;
         }
 
         vTaskDelay(1);  // Yield per idle task Core 0
       } else {
+        // Replay: input del frame applicato qui (stesso core di run_frame)
+        // cosi' ogni frame emulato vede esattamente l'input registrato
+        if (arcadeReplayActive) {
+          if (arcadeReplayPos < arcadeReplayLen) {
+            arcadeInput.setButtons(arcadeReplayData[arcadeReplayPos++]);
+          } else {
+            arcadeReplayActive = false;
+            arcadeReplayDone = true;
+            arcadeInput.setButtons(0);
+          }
+        } else if (arcadeRecordActive && arcadeReplayData && arcadeReplayPos < ARCADE_REPLAY_MAX_FRAMES) {
+          arcadeReplayData[arcadeReplayPos++] = arcadeLiveButtons;
+        }
+
         // Self-timed at 60fps, decoupled from render
+        uint32_t tEmu = micros();
         arcadeCurrentMachine->run_frame();
+        uint32_t tAudio = micros();
         // Audio: transmit on same core as emulation (no soundregs race).
         // Fills DMA buffer with as many samples as available space allows.
-        if (arcadeAudio) arcadeAudio->transmit();
+        uint32_t written = arcadeAudio ? ArcadeTransmit::run(arcadeAudio, 0) : 0;
+        uint32_t tEnd = micros();
+
+        uint32_t emuUs = tAudio - tEmu;
+        arcadeProfile.emuFrames++;
+        arcadeProfile.audioSamples += written;
+        arcadeProfile.emuUsTotal += emuUs;
+        if (emuUs > arcadeProfile.emuUsMax) arcadeProfile.emuUsMax = emuUs;
+        arcadeProfile.audioUsTotal += tEnd - tAudio;
+        if (arcadeReplayActive || arcadeReplayDone) {
+          // Firma deterministica: CRC RAM Z80 per frame, concatenata nella trace
+          uint32_t crc = esp_rom_crc32_le(0, arcadeMemory, RAMSIZE);
+          arcadeProfile.ramCrc = crc;
+          arcadeProfile.traceCrc = esp_rom_crc32_le(arcadeProfile.traceCrc, (const uint8_t*)&crc, sizeof(crc));
+          arcadeProfile.frameCrc = arcadeEmuFrameCrc(arcadeProfile.frameCrc);
+          if (arcadeReplayDone) {
+            arcadeReplayDone = false;
+            arcadeProfilePrint();
+          }
+        }
 
         // Frame timing with MANDATORY yield to prevent IDLE task starvation.
         // Bomb Jack's run_frame (20K Z80 steps ~15-20ms) + transmit (~5ms)
@@ -1069,6 +1705,10 @@ void arcadeEmulationTask(void* param) {
       vTaskDelay(10);
     }
   }
+
+  // Uscita richiesta da arcadeStopGame(): nessun mutex preso, transmit() concluso
+  arcadeEmuRunning = false;
+  vTaskDelete(NULL);
 }
 
 // ===== Adaptive blend: smooth gradients, preserve sprite edges =====
@@ -1138,6 +1778,26 @@ IRAM_ATTR void arcadeUpscaleRowWide(unsigned short* src, unsigned short* dst, in
   }
 }
 
+// ===== Render lock =====
+// Il render tiene arcadeRenderMutex solo mentre lavora: prima di ogni yield lo
+// rilascia, cosi' il frame CRC del task Z80 non resta bloccato per un tick e
+// arcadeRenderUs somma solo il tempo di render (non l'attesa ne' lo sleep)
+static inline void arcadeRenderLock() {
+  xSemaphoreTake(arcadeRenderMutex, portMAX_DELAY);
+  arcadeRenderT0 = micros();
+}
+
+static inline void arcadeRenderUnlock() {
+  arcadeRenderUs += micros() - arcadeRenderT0;
+  xSemaphoreGive(arcadeRenderMutex);
+}
+
+static inline void arcadeRenderYield() {
+  arcadeRenderUnlock();
+  vTaskDelay(1);
+  arcadeRenderLock();
+}
+
 // ===== Main Update Loop (called from loop() on Core 1) =====
 void updateArcade() {
   if (!arcadeInitialized) {
@@ -1145,6 +1805,8 @@ void updateArcade() {
     return;
   }
 
+  arcadeCheckSerial();
+
   // If in menu, nothing to render continuously
   if (arcadeInMenu) {
     arcadeUpdateButtonStateMachines();
@@ -1165,7 +1827,9 @@ void updateArcade() {
   uint8_t merged = arcadeButtonState | (espNowJoystickButtons & 0x9F) | bleGamepadGetButtons();
 
   // ALWAYS update input (even during Z80 boot)
-  arcadeInput.setButtons(merged);
+  // In replay l'input lo fornisce il task Z80 dal file registrato
+  arcadeLiveButtons = merged;
+  if (!arcadeReplayActive) arcadeInput.setButtons(merged);
   arcadeUpdateButtonStateMachines();
 
   // FAST BOOT: skip rendering during Z80 boot, show progress on screen
@@ -1241,9 +1905,16 @@ void updateArcade() {
   }
 
   if (arcadeFrameCount == 0) {
-    // Boot completed - first frame
+    // Boot completed - first frame: latenza avvio (tap → primo frame)
+    arcadeLastStartMs = millis() - arcadeStartRequestMs;
+    Serial.printf("[ARCADE] Avvio %s: %lu ms (ROM %lu ms%s)\n", arcadeGames[arcadeSelectedGame].name,
+                  (unsigned long)arcadeLastStartMs, (unsigned long)arcadeLastLoadMs,
+                  arcadeLastLoadCached ? ", cache" : "");
   }
 
+  arcadeRenderUs = 0;
+  arcadeRenderLock();
+
   // Prepare frame (extract sprites from Z80 RAM)
   arcadeCurrentMachine->prepare_frame();
 
@@ -1262,9 +1933,9 @@ void updateArcade() {
       memset(arcadeFrameBuffer, 0, rowPixels * sizeof(unsigned short));
       arcadeCurrentMachine->render_row(nr);
       memcpy(&arcadeFullFrame[nr * rowPixels], arcadeFrameBuffer, rowPixels * sizeof(unsigned short));
-      if ((nr & 7) == 7) vTaskDelay(1);   // Yield every 8 rows (~3ms chunks)
+      if ((nr & 7) == 7) arcadeRenderYield();   // Yield every 8 rows (~3ms chunks)
     }
-    vTaskDelay(1);  // Let RTOS scheduler + GDMA settle between render phases
+    arcadeRenderYield();  // Let RTOS scheduler + GDMA settle between render phases
 
     // Phase 2: Extract rotated rows and display
     // After ROT90: output = gh_wide x gw_tall (e.g. 224 x 256)
@@ -1355,6 +2026,12 @@ void updateArcade() {
     }
     gfx->endWrite();
   }
+  arcadeRenderUnlock();
+
+  uint32_t renderUs = arcadeRenderUs;
+  arcadeProfile.renderFrames++;
+  arcadeProfile.renderUsTotal += renderUs;
+  if (renderUs > arcadeProfile.renderUsMax) arcadeProfile.renderUsMax = renderUs;
 
   arcadeFrameCount++;
 }
@@ -2010,6 +2687,46 @@ void arcadeClearTouchInput() {
   arcadeButtonState = preserve;
 }
 
+// ===== Touch events (1_TOUCH_INPUT.ino) =====
+// Menu: PRESS = selezione. In gioco: PRESS sui pulsanti laterali = EXIT/BACK/COIN/START,
+// altrove D-pad + FIRE che seguono il dito fino al RELEASE.
+static bool arcadeDpadHeld = false;
+
+void handleArcadeTouchEvent(const TouchEvent &ev) {
+  int x = ev.x, y = ev.y;
+  switch (ev.type) {
+    case TOUCH_EV_PRESS:
+      if (arcadeInMenu) {
+        // NO playTouchSound() - I2S usato da arcadeAudio
+        handleArcadeMenuTouch(x, y);
+        return;
+      }
+      if ((x < ARC_LB && (y <= ARC_EXIT_Y2 || y >= ARC_BACK_Y1)) ||
+          (x >= ARC_RB && (y <= ARC_COIN_Y2 || y >= ARC_START_Y1))) {
+        handleArcadeGameTouch(x, y);
+        return;
+      }
+      arcadeDpadHeld = true;
+      arcadeUpdateTouchInput(x, y);
+      return;
+
+    case TOUCH_EV_DRAG_START:
+    case TOUCH_EV_DRAG_MOVE:
+      if (arcadeDpadHeld) arcadeUpdateTouchInput(x, y);
+      return;
+
+    case TOUCH_EV_RELEASE:
+      if (arcadeDpadHeld) {
+        arcadeDpadHeld = false;
+        arcadeClearTouchInput();
+      }
+      return;
+
+    default:
+      return;
+  }
+}
+
 // ===== Touch Handler (menu only) =====
 void handleArcadeMenuTouch(int x, int y) {
   if (!arcadeInitialized || !arcadeInMenu) return;
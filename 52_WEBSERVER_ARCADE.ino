@@ -1,8 +1,9 @@
 // ============================================================================
 // 52_WEBSERVER_ARCADE.ino - Web API for Arcade mode
 // Endpoints: /arcade (HTML), /arcade/status, /arcade/start, /arcade/stop,
-//            /arcade/togglegame, /arcade/roms/list, /arcade/roms/upload,
-//            /arcade/roms/delete, /arcade/roms/refresh
+//            /arcade/replay, /arcade/record, /arcade/togglegame,
+//            /arcade/roms/list, /arcade/roms/upload, /arcade/roms/delete,
+//            /arcade/roms/refresh
 // ============================================================================
 
 #ifdef EFFECT_ARCADE
@@ -23,6 +24,39 @@ static String arcadeBaseName(const char* path) {
   return (i >= 0 && i < (int)s.length() - 1) ? s.substring(i + 1) : s;
 }
 
+// Prenota replay/record ed entra nel modo arcade (stesso cambio modo di /espcam/start)
+static void arcadeArmRequest(AsyncWebServerRequest *request, bool record) {
+  extern DisplayMode userMode;
+  extern void forceDisplayUpdate();
+  extern void cleanupPreviousMode(DisplayMode);
+
+  int gameIdx = request->hasParam("game") ? request->getParam("game")->value().toInt() : -1;
+  // arcadeMachineCount e' noto solo dopo il primo ingresso: validato di nuovo in initArcade()
+  if (gameIdx < 0 || (arcadeMachineCount > 0 && gameIdx >= arcadeMachineCount)) {
+    request->send(400, "application/json", "{\"error\":\"Invalid game index\"}");
+    return;
+  }
+  if (currentMode == MODE_ARCADE && arcadeInitialized) {
+    // Raggiungibile solo se il WiFi e' rimasto attivo
+    if (!arcadeStartBenchmark(gameIdx, record)) {
+      request->send(404, "application/json", "{\"error\":\"replay.bin not found\"}");
+      return;
+    }
+    request->send(200, "application/json", "{\"ok\":true,\"frames\":" + String(arcadeReplayLen) + "}");
+    return;
+  }
+  arcadeArmedRecord = record;
+  arcadeArmedGame = gameIdx;
+  Serial.printf("[ARCADE-PROF] %s gioco %d prenotato da web\n", record ? "Record" : "Replay", gameIdx);
+  request->send(200, "application/json", "{\"ok\":true,\"armed\":" + String(gameIdx) +
+                ",\"record\":" + String(record ? "true" : "false") + "}");
+
+  cleanupPreviousMode(currentMode);
+  currentMode = MODE_ARCADE;
+  userMode = MODE_ARCADE;
+  forceDisplayUpdate();
+}
+
 void setup_arcade_webserver(AsyncWebServer* server) {
   Serial.println("[ARCADE WEBSERVER] Registering endpoints...");
 
@@ -43,6 +77,37 @@ void setup_arcade_webserver(AsyncWebServer* server) {
     json += "\"frames\":" + String(arcadeFrameCount) + ",";
     json += "\"gameCount\":" + String(arcadeMachineCount) + ",";
 
+    // Profilo prestazioni (vedi ArcadeProfile in 51_ARCADE.ino)
+    uint32_t ef = arcadeProfile.emuFrames, rf = arcadeProfile.renderFrames;
+    json += "\"profile\":{";
+    json += "\"emuFrames\":" + String(ef) + ",";
+    json += "\"emuUs\":" + String(ef ? (uint32_t)(arcadeProfile.emuUsTotal / ef) : 0) + ",";
+    json += "\"emuUsMax\":" + String(arcadeProfile.emuUsMax) + ",";
+    uint32_t samples = arcadeProfileAudioSamples();
+    json += "\"audioSamplesPerFrame\":" + String(ef ? samples / ef : 0) + ",";
+    json += "\"audioNsPerSample\":" + String(samples ? (uint32_t)(arcadeProfile.audioUsTotal * 1000 / samples) : 0) + ",";
+    json += "\"renderFrames\":" + String(rf) + ",";
+    json += "\"renderUs\":" + String(rf ? (uint32_t)(arcadeProfile.renderUsTotal / rf) : 0) + ",";
+    json += "\"renderUsMax\":" + String(arcadeProfile.renderUsMax) + ",";
+    char crcBuf[64];
+    snprintf(crcBuf, sizeof(crcBuf), "\"traceCrc\":\"%08lX\",\"frameCrc\":\"%08lX\",",
+             (unsigned long)arcadeProfile.traceCrc, (unsigned long)arcadeProfile.frameCrc);
+    json += crcBuf;
+    json += "\"replay\":" + String(arcadeReplayActive ? "true" : "false") + ",";
+    json += "\"replayPos\":" + String(arcadeReplayPos) + ",";
+    json += "\"replayLen\":" + String(arcadeReplayLen) + ",";
+    json += "\"record\":" + String(arcadeRecordActive ? "true" : "false") + ",";
+    json += "\"armedGame\":" + String(arcadeArmedGame) + "},";
+
+    // Caricamento ROM (indice + cache PSRAM)
+    json += "\"romLoad\":{";
+    json += "\"loadMs\":" + String(arcadeLastLoadMs) + ",";
+    json += "\"loadKB\":" + String(arcadeLastLoadBytes / 1024) + ",";
+    json += "\"sdKBps\":" + String(arcadeLastLoadMs && !arcadeLastLoadCached ? arcadeLastLoadBytes / arcadeLastLoadMs : 0) + ",";
+    json += "\"cached\":" + String(arcadeLastLoadCached ? "true" : "false") + ",";
+    json += "\"startMs\":" + String(arcadeLastStartMs) + ",";
+    json += "\"cacheKB\":" + String(arcadeRomCache.arenaSize / 1024) + "},";
+
     // Games array
     json += "\"games\":[";
     for (int i = 0; i < arcadeMachineCount; i++) {
@@ -85,6 +150,19 @@ void setup_arcade_webserver(AsyncWebServer* server) {
     }
   });
 
+  // ===== Benchmark: avvia un gioco riproducendo /ARCADE/<GIOCO>/replay.bin =====
+  // Il report (us/frame emulazione/render, campioni audio/frame + CRC) va su seriale e /arcade/status
+  // Nel modo arcade il WiFi e' spento: la richiesta arriva da un altro modo, viene
+  // prenotata ed eseguita da initArcade(). Dentro il modo: comandi seriali (arcadeCheckSerial)
+  server->on("/arcade/replay", HTTP_POST, [](AsyncWebServerRequest *request) {
+    arcadeArmRequest(request, false);
+  });
+
+  // ===== Benchmark: avvia un gioco registrando gli input (salvati all'uscita) =====
+  server->on("/arcade/record", HTTP_POST, [](AsyncWebServerRequest *request) {
+    arcadeArmRequest(request, true);
+  });
+
   // Stop game
   server->on("/arcade/stop", HTTP_POST, [](AsyncWebServerRequest *request) {
     if (currentMode == MODE_ARCADE && !arcadeInMenu) {
@@ -355,6 +433,7 @@ void setup_arcade_webserver(AsyncWebServer* server) {
           arcadeUploadFile.flush();
           arcadeUploadFile.close();
           Serial.printf("[ARCADE-ROM] Upload complete: %s (%u bytes)\n", arcadeUploadPath.c_str(), index + len);
+          arcadeRomIndexInvalidate();  // rigenerato al prossimo refresh/avvio
         } else {
           arcadeLastUploaded = "";
         }
@@ -404,6 +483,7 @@ void setup_arcade_webserver(AsyncWebServer* server) {
       Serial.printf("[ARCADE-ROM] Deleted file: %s\n", fullPath.c_str());
     }
 
+    arcadeRomIndexInvalidate();
     request->send(200, "application/json", "{\"ok\":true}");
   });
 
@@ -416,7 +496,8 @@ void setup_arcade_webserver(AsyncWebServer* server) {
     extern uint16_t arcadeEnabledMask;
     extern bool arcadeInMenu;
 
-    // Rebuild game list from SD card
+    // Rebuild ROM index + game list from SD card
+    arcadeRomIndexInvalidate();
     arcadeBuildGameList();
     loadArcadeEnabledMask();
     for (int i = 0; i < arcadeMachineCount; i++) {
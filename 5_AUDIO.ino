@@ -24,6 +24,10 @@ static uint8_t vuPeak = 0;            // Livello picco
 static unsigned long vuLastUpdate = 0;
 static bool vuVisible = false;        // Flag se VU meter è visibile
 static bool inSequence = false;       // Flag per sequenza (non nascondere VU tra file)
+static const String* seqFiles = nullptr; // File della sequenza: playLocalMP3 accoda i successivi (gapless)
+static int seqCount = 0;
+static int seqNext = 0;               // Primo file della sequenza non ancora avviato/accodato
+static bool seqMissing = false;       // Un file accodabile mancava su LittleFS
 bool vuMeterEnabled = false;          // VU meter DISABILITATO di default (abilitato solo negli annunci)
 
 // Funzione per ottenere colore barra in base alla posizione
@@ -108,6 +112,8 @@ void forceClockRedraw() {
   #ifdef EFFECT_FLIP_CLOCK
   if (currentMode == MODE_FLIP_CLOCK) {
     extern void updateFlipClock();
+    extern void flipClockRequestFullBlit();
+    flipClockRequestFullBlit();  // Il flip clock trasferisce solo le aree cambiate
     updateFlipClock();
     return;
   }
@@ -573,6 +579,9 @@ void setVolumeLocal(uint8_t volume) {
   // Audio.h usa range 0-21
   uint8_t vol21 = map(volume, 0, 100, 0, 21);
   audio.setVolume(vol21);
+  // Loudness: il volume giorno/notte e' il livello d'ascolto, piu' e' basso piu' bassi e acuti
+  // vengono rinforzati (il volume di radio/MP3/annunci resta indipendente)
+  audio.setLoudness(volume);
   Serial.printf("[AUDIO] Volume locale impostato: %d%% (vol21=%d)\n", volume, vol21);
   #endif
 }
@@ -601,12 +610,21 @@ bool playMP3Sequence(const String files[], int count) {
 
   inSequence = true;  // Inizia sequenza - non nascondere VU tra file
 
-  for (int i = 0; i < count; i++) {
+  // playLocalMP3 accoda i file successivi mentre suona il precedente (niente pause tra le parole):
+  // si riparte dal primo file non accodato (coda rifiutata o passaggio non riuscito)
+  seqFiles = files;
+  seqCount = count;
+  seqMissing = false;
+  for (int i = 0; i < count; ) {
+    seqNext = i + 1;
     if (!playLocalMP3(files[i].c_str())) {
       success = false;
     }
+    i = seqNext;
     yield();
   }
+  if (seqMissing) success = false;
+  seqFiles = nullptr;
 
   inSequence = false;  // Fine sequenza
   hideVUMeter();       // Nascondi VU meter alla fine della sequenza
@@ -862,18 +880,43 @@ bool playLocalMP3(const char* filename) {
   // Timeout di sicurezza (max 30 secondi per file)
   unsigned long playStart = millis();
   const unsigned long MAX_PLAY_TIME = 30000;
+  bool seqQueued = false;
+  bool seqNoQueue = false;        // Coda fallita: i file restanti si riproducono in modo classico
+  uint32_t seqSwitches = 0;       // audio.getSwitchCount() quando il file e' stato accodato
 
   // Attendi fine riproduzione (audio.loop() è chiamato da audioTask)
-  // Variabili per lampeggio LED RGB a ritmo del parlato
-  #ifdef EFFECT_LED_RGB
-  static uint8_t bootLedTarget = 0;
-  static uint8_t bootLedSmooth = 0;
-  extern Adafruit_NeoPixel ledStrip;
-  extern uint8_t ledRgbBrightness;
-  extern void getLedColorForMode(DisplayMode mode, uint8_t &r, uint8_t &g, uint8_t &b);
-  #endif
-
   while (audio.isRunning()) {
+    // Sequenza: il file accodato subentra al frame successivo senza fermare l'I2S,
+    // appena e' subentrato si accoda il prossimo
+    if (inSequence && seqFiles && !seqNoQueue && !audio.isQueued()) {
+      if (seqQueued) {
+        seqQueued = false;
+        if (audio.getSwitchCount() == seqSwitches) {
+          // File accodato scartato (apertura o lettura anticipata fallita): torna alla sequenza classica
+          Serial.printf("[AUDIO] Coda fallita: %s\n", seqFiles[seqNext - 1].c_str());
+          seqNext--;
+          seqNoQueue = true;
+        } else {
+          playStart = millis();   // Timeout per file
+        }
+      }
+      while (!seqNoQueue && seqNext < seqCount) {
+        String nextPath = "/" + seqFiles[seqNext];
+        if (!LittleFS.exists(nextPath)) {
+          Serial.printf("[AUDIO] File non trovato: %s\n", nextPath.c_str());
+          seqMissing = true;
+          seqNext++;
+          continue;
+        }
+        seqSwitches = audio.getSwitchCount();
+        if (audio.queueFS(LittleFS, nextPath.c_str())) {
+          seqQueued = true;
+          seqNext++;
+        }
+        break;   // Coda rifiutata: il file viene riprodotto dopo, in modo classico
+      }
+    }
+
     if (millis() - playStart > MAX_PLAY_TIME) {
       Serial.println("[AUDIO] Timeout riproduzione!");
       audio.stopSong();
@@ -883,48 +926,21 @@ bool playLocalMP3(const char* filename) {
     // Aggiorna VU meter durante riproduzione
     if (vuMeterEnabled) updateVUMeter();
 
-    // Lampeggio LED RGB a ritmo del parlato (durante annunci)
+    // Lampeggio LED RGB a ritmo del parlato (durante annunci):
+    // livello misurato sul PCM decodificato dal motore LED
     #ifdef EFFECT_LED_RGB
-    if (vuMeterEnabled) {
-      // Simula livello audio con attacco/decadimento
-      if (random(100) < 35) {
-        bootLedTarget = random(25, 100);
-      }
-      if (bootLedSmooth < bootLedTarget) {
-        bootLedSmooth = min((int)bootLedSmooth + 12, (int)bootLedTarget);
-      } else {
-        bootLedSmooth = max((int)bootLedSmooth - 6, (int)bootLedTarget);
-      }
-      uint8_t level = constrain((int)bootLedSmooth + random(-5, 6), 5, 100);
-
-      // Modula brightness LED: da 20% a 100% della brightness impostata
-      uint8_t bri = ledRgbBrightness > 0 ? ledRgbBrightness : 80;
-      uint8_t minBri = bri / 5;
-      uint8_t pulseBri = minBri + (uint8_t)((uint16_t)(bri - minBri) * level / 100);
-      ledStrip.setBrightness(pulseBri);
-
-      // Colore tema per il modo corrente
-      uint8_t lr, lg, lb;
-      getLedColorForMode((DisplayMode)currentMode, lr, lg, lb);
-      uint32_t color = ledStrip.Color(lr, lg, lb);
-      for (int i = 0; i < 12; i++) {
-        ledStrip.setPixelColor(i, color);
-      }
-      ledStrip.show();
-    }
+    if (vuMeterEnabled) ledRgbAnnounceFrame();
     #endif
 
     delay(10);  // Breve pausa per non saturare CPU
   }
 
+  // Fine (o timeout) con un file ancora in coda che non e' subentrato: lo riproduce la sequenza
+  if (seqQueued && audio.getSwitchCount() == seqSwitches) seqNext--;
+
   // Spegni LED dopo annuncio (il loop principale li gestirà)
   #ifdef EFFECT_LED_RGB
-  if (vuMeterEnabled) {
-    bootLedSmooth = 0;
-    bootLedTarget = 0;
-    ledStrip.clear();
-    ledStrip.show();
-  }
+  if (vuMeterEnabled) ledRgbClear();
   #endif
 
   // Nascondi VU meter solo se NON siamo in una sequenza
@@ -184,7 +184,7 @@ void saveLedRingConfig() {
   EEPROM.write(EEPROM_LEDRING_MINUTES_RAINBOW, ledRingMinutesRainbow ? 1 : 0);
   EEPROM.write(EEPROM_LEDRING_SECONDS_RAINBOW, ledRingSecondsRainbow ? 1 : 0);
   EEPROM.write(EEPROM_LEDRING_VALID_ADDR, EEPROM_LEDRING_VALID_MARKER);
-  EEPROM.commit();
+  settingsCommit();
   Serial.println("[LED Ring] Config salvata");
   ledRingFirstDraw = true;
 }
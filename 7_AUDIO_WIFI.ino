@@ -151,10 +151,21 @@ bool sendI2CCommand(uint8_t* data, size_t length) {
     return false;
   }
 
+  // Ogni tentativo e' una transazione dell'arbitro I2C: la pausa tra i retry
+  // avviene fuori dal bus, il touch non resta in attesa
+  struct AudioTx { uint8_t *data; size_t length; size_t written; uint8_t error; };
+  AudioTx tx = { data, length, 0, 0 };
+
   for (int retry = 0; retry < I2C_RETRY_COUNT; retry++) {
-    Wire.beginTransmission(AUDIO_I2C_ADDR);
-    size_t written = Wire.write(data, length);
-    uint8_t error = Wire.endTransmission();
+    i2cBusRun(I2C_DEV_AUDIO, [](void *a) {
+      AudioTx &t = *(AudioTx *)a;
+      Wire.beginTransmission(AUDIO_I2C_ADDR);
+      t.written = Wire.write(t.data, t.length);
+      t.error = Wire.endTransmission();
+      return t.error == 0 && t.written == t.length;
+    }, &tx);
+    size_t written = tx.written;
+    uint8_t error = tx.error;
 
     if (error == 0 && written == length) {
       Serial.printf("✓ I2C TX: CMD 0x%02X (%d bytes)\n", data[0], length);
@@ -177,12 +188,23 @@ bool sendI2CCommand(uint8_t* data, size_t length) {
  * @return true se ESP32C3 risponde, false altrimenti
  */
 bool pingAudioSlave() {
-  uint8_t cmd[] = {CMD_PING};
-
-  // Invia CMD_PING
-  Wire.beginTransmission(AUDIO_I2C_ADDR);
-  Wire.write(cmd, sizeof(cmd));
-  uint8_t error = Wire.endTransmission();
+  // Invia CMD_PING e richiedi la risposta in un'unica transazione dell'arbitro I2C
+  struct AudioPing { uint8_t error, bytesReceived, response; };
+  AudioPing ping = { 0, 0, 0 };
+  i2cBusRun(I2C_DEV_AUDIO, [](void *a) {
+    AudioPing &p = *(AudioPing *)a;
+    uint8_t cmd[] = {CMD_PING};
+    Wire.beginTransmission(AUDIO_I2C_ADDR);
+    Wire.write(cmd, sizeof(cmd));
+    p.error = Wire.endTransmission();
+    if (p.error != 0) return false;
+    // Richiedi PONG response (cast espliciti per evitare warning ambiguità)
+    p.bytesReceived = Wire.requestFrom((uint8_t)AUDIO_I2C_ADDR, (uint8_t)1);
+    if (p.bytesReceived == 0) return false;
+    p.response = Wire.read();
+    return true;
+  }, &ping);
+  uint8_t error = ping.error;
 
   if (error != 0) {
     Serial.printf("❌ PING fallito (endTransmission error=%d)\n", error);
@@ -190,16 +212,13 @@ bool pingAudioSlave() {
     return false;
   }
 
-  // Richiedi PONG response (cast espliciti per evitare warning ambiguità)
-  uint8_t bytesReceived = Wire.requestFrom((uint8_t)AUDIO_I2C_ADDR, (uint8_t)1);
-
-  if (bytesReceived == 0) {
+  if (ping.bytesReceived == 0) {
     Serial.println("❌ PONG non ricevuto (timeout)");
     audioSlaveConnected = false;
     return false;
   }
 
-  uint8_t response = Wire.read();
+  uint8_t response = ping.response;
 
   if (response == RESP_PONG) {
     Serial.println("✓ PONG ricevuto (0xFF)");
@@ -195,6 +195,10 @@ ClockHand gmtHand;       // Lancetta GMT (opzionale)
 // Flag per distinguere tra "rientro nella modalità" e "cambio skin"
 bool justEnteredClockMode = true;
 
+// Cambio skin in dissolvenza (0_SKIN_CACHE.ino): tempo dalla richiesta al primo frame
+static uint32_t clockSkinSwitchStart = 0;
+static bool clockSkinSwitchPending = false;
+
 // Variabili per anti-flickering lancette (memorizzano angoli precedenti)
 float prevHourAngle = -1;
 float prevMinuteAngle = -1;
@@ -215,54 +219,9 @@ void drawGmtSubdial();
 void fetchOutdoorTemperature();
 void drawWeatherIconOnly(int16_t centerX, int16_t centerY, String iconCode);
 void drawWindArrow(int16_t centerX, int16_t centerY, float direction);
-void restoreHandArea(float angle, uint8_t length, uint8_t thickness);
 
 // Funzioni di disegno lancette (definite in 3_EFFETTI.ino)
-extern void drawClockHandOffscreen(Arduino_GFX* targetGfx, int centerX, int centerY, float angle, int length, uint16_t color, int thickness);
-
-// ===================================================================
-// FUNZIONE: Ripristina area lancetta dal buffer (anti-flickering)
-// ===================================================================
-void restoreHandArea(float angle, uint8_t length, uint8_t thickness) {
-  if (!clockFaceBufferLoaded || clockFaceBuffer == nullptr) return;
-  if (angle < 0) return;  // Angolo non valido (prima iterazione)
-
-  const int16_t centerX = 240;
-  const int16_t centerY = 240;
-
-  // Calcola punto finale della lancetta
-  float radians = (angle - 90) * PI / 180.0f;
-  int16_t endX = centerX + (int16_t)(cos(radians) * length);
-  int16_t endY = centerY + (int16_t)(sin(radians) * length);
-
-  // Calcola bounding box con margine per lo spessore
-  int16_t margin = thickness + 4;
-  int16_t x1 = min(centerX, endX) - margin;
-  int16_t y1 = min(centerY, endY) - margin;
-  int16_t x2 = max(centerX, endX) + margin;
-  int16_t y2 = max(centerY, endY) + margin;
-
-  // Clamp ai bordi dello schermo
-  x1 = max((int16_t)0, x1);
-  y1 = max((int16_t)0, y1);
-  x2 = min((int16_t)479, x2);
-  y2 = min((int16_t)479, y2);
-
-  int16_t w = x2 - x1 + 1;
-  int16_t h = y2 - y1 + 1;
-
-  // Alloca buffer temporaneo e copia l'area dal buffer PSRAM
-  uint16_t* tempBuf = (uint16_t*)malloc(w * h * 2);
-  if (tempBuf) {
-    // Copia riga per riga dal buffer PSRAM al buffer temporaneo
-    for (int16_t row = 0; row < h; row++) {
-      memcpy(&tempBuf[row * w], &clockFaceBuffer[(y1 + row) * 480 + x1], w * 2);
-    }
-    // Disegna tutto in una sola chiamata
-    gfx->draw16bitRGBBitmap(x1, y1, tempBuf, w, h);
-    free(tempBuf);
-  }
-}
+extern void drawClockHandOffscreen(OffscreenGFX* targetGfx, int centerX, int centerY, float angle, int length, uint16_t color, int thickness);
 
 // ===================================================================
 // OVERLOAD: drawClockHand per struttura ClockHand
@@ -292,152 +251,49 @@ void loadSavedOrRandomClockSkin() {
   // Forza sempre skin GMT Master (indice 1) come default
   currentClockSkin = 1;
   EEPROM.write(EEPROM_CLOCK_SKIN_ADDR, 1);
-  EEPROM.commit();
+  settingsCommit();
   Serial.printf("Skin forzata a GMT Master: %d (%s)\n", currentClockSkin, clockSkins[currentClockSkin].name);
 #endif
 }
 
 // ===================================================================
-// FUNZIONE: Animazione fade out/in della backlight
-// ===================================================================
-void fadeBacklight(bool fadeOut, uint16_t duration) {
-  uint8_t currentBrightnessRead = ledcRead(PWM_CHANNEL);
-  // Usa luminosità basata su orari GIORNO/NOTTE e presenza radar
-  extern uint8_t currentHour;
-  extern bool radarAvailable;
-  extern bool presenceDetected;
-
-  uint8_t targetBrightness;
-  if (fadeOut) {
-    targetBrightness = 0;
-  } else {
-    // Fade in: rispetta la presenza se il radar è disponibile
-    if (radarAvailable && !presenceDetected) {
-      targetBrightness = 0;  // Nessuna presenza = display spento
-    } else {
-      // Con presenza (o senza radar): usa la luminosità appropriata in base all'orario
-      if(checkIsNightTime(currentHour, currentMinute)) {
-        targetBrightness = brightnessNight;  // Notte: luminosità configurabile
-      } else {
-        targetBrightness = brightnessDay;    // Giorno: luminosità configurabile
-      }
-    }
-  }
-
-  int steps = 20;  // Numero di step per il fade
-  int delayPerStep = duration / steps;
-
-  for (int i = 0; i <= steps; i++) {
-    uint8_t brightness;
-    if (fadeOut) {
-      brightness = currentBrightnessRead - (currentBrightnessRead * i / steps);
-    } else {
-      brightness = (targetBrightness * i / steps);
-    }
-    ledcWrite(PWM_CHANNEL, brightness);
-    delay(delayPerStep);
-  }
-}
-
-// ===================================================================
-// FUNZIONE: Cambia skin dell'orologio con animazione
+// FUNZIONE: Cambia skin dell'orologio con dissolvenza
 // ===================================================================
+// Non bloccante: salva il frame a schermo, carica la nuova skin (da cache PSRAM se gia'
+// vista, altrimenti decodifica JPEG) e lascia a updateClockMode() la dissolvenza frame per frame.
 void changeClockSkin(uint8_t skinIndex) {
   if (skinIndex >= NUM_CLOCK_SKINS) {
     Serial.printf("Errore: skin index %d non valido (max: %d)\n", skinIndex, NUM_CLOCK_SKINS - 1);
     return;
   }
 
+  clockSkinSwitchStart = millis();
   currentClockSkin = skinIndex;
   ClockSkin& skin = clockSkins[currentClockSkin];
 
   Serial.printf("Cambio skin: %s (%s)\n", skin.name, skin.filename);
 
-  // ========== ANIMAZIONE: Fade out ==========
-  fadeBacklight(true, 300);  // Fade out in 300ms
-
-  // ========== FEEDBACK VISIVO: Mostra nome skin ==========
-  gfx->fillScreen(BLACK);
-  gfx->setFont(u8g2_font_maniac_te);
-  gfx->setTextColor(CYAN);
-
-  // Titolo
-  const char* title = "SKIN OROLOGIO:";
-  int titleWidth = strlen(title) * 18;
-  int titleX = (480 - titleWidth) / 2;
-  if (titleX < 0) titleX = 10;
-  gfx->setCursor(titleX, 210);
-  gfx->println(title);
-
-  // Nome skin
-  int nameWidth = strlen(skin.name) * 18;
-  int nameX = (480 - nameWidth) / 2;
-  if (nameX < 0) nameX = 10;
-  gfx->setCursor(nameX, 250);
-  gfx->setTextColor(WHITE);
-  gfx->println(skin.name);
-
-  // Indicatore numerazione (es: "2/4")
-  char indicator[16];
-  snprintf(indicator, sizeof(indicator), "%d/%d", skinIndex + 1, NUM_CLOCK_SKINS);
-  int indicatorWidth = strlen(indicator) * 18;
-  int indicatorX = (480 - indicatorWidth) / 2;
-  if (indicatorX < 0) indicatorX = 10;
-  gfx->setCursor(indicatorX, 290);
-  gfx->setTextColor(YELLOW);
-  gfx->println(indicator);
-
   // ========== SALVA SKIN IN EEPROM ==========
   EEPROM.write(EEPROM_CLOCK_SKIN_ADDR, skinIndex);
-  EEPROM.commit();
+  settingsCommit();
   Serial.printf("Skin salvata in EEPROM: %d\n", skinIndex);
 
-  // ========== ANIMAZIONE: Fade in ==========
-  fadeBacklight(false, 500);  // Fade in in 500ms
-
-  // Attendi 700ms prima di ridisegnare
-  delay(700);
-
-  // ========== ANIMAZIONE: Fade out prima del cambio ==========
-  fadeBacklight(true, 300);  // Fade out veloce prima di caricare nuova skin
+  // ========== DISSOLVENZA: parte dal frame attualmente visualizzato ==========
+  clockSkinSwitchPending = currentMode == MODE_CLOCK && clockFaceBufferLoaded &&
+                           clockSkinFrameBuffer != nullptr && skinFadeBegin(clockSkinFrameBuffer);
 
   // Se la skin è diversa da quella caricata, invalida il buffer
-  Serial.printf("DEBUG: loadedSkinFilename='%s', skin.filename='%s'\n", loadedSkinFilename.c_str(), skin.filename);
   if (loadedSkinFilename != String(skin.filename)) {
     clockFaceBufferLoaded = false;
     loadedSkinFilename = "";  // Reset anche loadedSkinFilename
     Serial.println("Buffer invalidato, verrà ricaricata nuova skin");
-  } else {
-    Serial.println("ATTENZIONE: Skin già caricata nel buffer!");
   }
 
-  // Applica configurazione lancette dalle variabili globali (configurabili da pagina web)
-  hourHand.length = clockHourHandLength;
-  hourHand.thickness = clockHourHandWidth;
-  hourHand.color = Color((clockHourHandColor >> 11) << 3, ((clockHourHandColor >> 5) & 0x3F) << 2, (clockHourHandColor & 0x1F) << 3);
-
-  minuteHand.length = clockMinuteHandLength;
-  minuteHand.thickness = clockMinuteHandWidth;
-  minuteHand.color = Color((clockMinuteHandColor >> 11) << 3, ((clockMinuteHandColor >> 5) & 0x3F) << 2, (clockMinuteHandColor & 0x1F) << 3);
-
-  secondHand.length = clockSecondHandLength;
-  secondHand.thickness = clockSecondHandWidth;
-  secondHand.color = Color((clockSecondHandColor >> 11) << 3, ((clockSecondHandColor >> 5) & 0x3F) << 2, (clockSecondHandColor & 0x1F) << 3);
-
-  gmtHand.length = skin.gmtHand.length;
-  gmtHand.thickness = skin.gmtHand.thickness;
-  gmtHand.color = skin.gmtHand.color;
-
-  // Forza ridisegno completo
+  // Forza ridisegno completo (configurazione lancette applicata in updateClockMode())
   clockInitNeeded = true;
   lastClockHour = 255;
   lastClockMinute = 255;
   lastClockSecond = 255;
-
-  // ========== ANIMAZIONE FINALE: Fade in nuovo quadrante ==========
-  // (verrà eseguito dopo che updateClockMode() ridisegna tutto)
-  // Per ora restaura luminosità normale
-  fadeBacklight(false, 400);  // Fade in finale in 400ms
 }
 
 // ===================================================================
@@ -466,8 +322,8 @@ void updateClockMode() {
   if (clockInitNeeded) {
     clockInitNeeded = false;
 
-    // Pulisci schermo SOLO all'inizializzazione
-    gfx->fillScreen(BLACK);
+    // Pulisci schermo SOLO all'inizializzazione (non durante la dissolvenza tra skin)
+    if (!skinFadeActive()) gfx->fillScreen(BLACK);
 
     // Reset buffer
     memset(activePixels, 0, sizeof(activePixels));
@@ -535,9 +391,9 @@ void updateClockMode() {
     drawClockFace();
   }
 
-  // Aggiorna ogni secondo
+  // Aggiorna ogni secondo (a cadenza piena durante la dissolvenza tra skin)
   uint32_t currentMillis = millis();
-  if (currentMillis - lastClockUpdate < 1000) {
+  if (currentMillis - lastClockUpdate < 1000 && !skinFadeActive()) {
     return;
   }
   lastClockUpdate = currentMillis;
@@ -556,7 +412,7 @@ void updateClockMode() {
   bool hourMinuteChanged = (currentHour != lastClockHour || currentMinute != lastClockMinute);
   bool secondChanged = (currentSecond != lastClockSecond);
 
-  if (!hourMinuteChanged && !secondChanged) {
+  if (!hourMinuteChanged && !secondChanged && !skinFadeActive()) {
     return;  // Nessun aggiornamento necessario
   }
 
@@ -615,8 +471,22 @@ void updateClockMode() {
     // FASE 6: Resetta target GFX
     clockTargetGfx = nullptr;
 
-    // FASE 7: Trasferisci TUTTO al display in un colpo solo (zero flickering)
+    // FASE 7: Dissolvenza dalla skin precedente (un passo per frame) con il nome della nuova skin
+    skinFadeApply(clockSkinFrameBuffer);
+    if (skinFadeActive()) {
+      clockSkinOffscreenGfx->setFont(u8g2_font_helvB14_tr);
+      clockSkinOffscreenGfx->setTextColor(WHITE);
+      int nameX = (480 - (int)strlen(skin.name) * 11) / 2;
+      clockSkinOffscreenGfx->setCursor(nameX < 10 ? 10 : nameX, 420);
+      clockSkinOffscreenGfx->print(skin.name);
+    }
+
+    // FASE 8: Trasferisci TUTTO al display in un colpo solo (zero flickering)
     gfx->draw16bitRGBBitmap((gfx->width()-480)/2, (gfx->height()-480)/2, clockSkinFrameBuffer, 480, 480);
+    if (clockSkinSwitchPending) {
+      clockSkinSwitchPending = false;
+      skinFadeNoteSwitch(clockSkinSwitchStart);
+    }
 
     // Aggiorna variabili
     lastClockHour = currentHour;
@@ -626,6 +496,8 @@ void updateClockMode() {
     return;  // Tutto fatto con double buffering completo
   } else {
     // Fallback: ricarica JPEG (non dovrebbe mai succedere)
+    skinFadeCancel();
+    clockSkinSwitchPending = false;
     drawJpegFromSD(clockSkins[currentClockSkin].filename, 0, 0, 480, 480);
   }
 
@@ -780,15 +652,23 @@ void drawClockFace() {
       Serial.println("OffscreenGFX creato per MODE_CLOCK");
     }
 
-    // Carica JPEG direttamente nel buffer PSRAM
-    if (loadJpegToBuffer(skin.filename, clockFaceBuffer, 480, 480)) {
-      // JPEG caricato con successo nel buffer!
+    // Skin gia' vista: decompressione dalla cache PSRAM, altrimenti JPEG dalla SD nel buffer
+    uint32_t decodeStart = millis();
+    bool faceLoaded = skinCacheFetch(skin.filename, clockFaceBuffer);
+    if (!faceLoaded && loadJpegToBuffer(skin.filename, clockFaceBuffer, 480, 480)) {
+      faceLoaded = true;
+      skinCacheStore(skin.filename, clockFaceBuffer, millis() - decodeStart);
+    }
+
+    if (faceLoaded) {
       clockFaceBufferLoaded = true;
       loadedSkinFilename = String(skin.filename);
       Serial.printf("Skin '%s' caricata in PSRAM!\n", skin.name);
 
-      // Copia il buffer sul display per la prima visualizzazione
-      gfx->draw16bitRGBBitmap((gfx->width()-480)/2, (gfx->height()-480)/2, clockFaceBuffer, 480, 480);
+      // Copia il buffer sul display per la prima visualizzazione (in dissolvenza ci pensa updateClockMode)
+      if (!skinFadeActive()) {
+        gfx->draw16bitRGBBitmap((gfx->width()-480)/2, (gfx->height()-480)/2, clockFaceBuffer, 480, 480);
+      }
     } else {
       // Fallback: JPEG non trovato
       Serial.printf("JPEG '%s' non trovato, uso quadrante tradizionale\n", skin.filename);
@@ -799,7 +679,7 @@ void drawClockFace() {
       gfx->fillScreen(BLACK);
       gfx->drawCircle(centerX, centerY, 200, convertColor(currentColor));
     }
-  } else {
+  } else if (!skinFadeActive()) {
     // Buffer già caricato, copialo velocemente sul display (molto più veloce di ricaricare JPEG!)
     gfx->draw16bitRGBBitmap((gfx->width()-480)/2, (gfx->height()-480)/2, clockFaceBuffer, 480, 480);
   }
@@ -937,74 +817,6 @@ void drawClockFace() {
 #endif
 }
 
-// ===================================================================
-// DISEGNA UNA LANCETTA A FORMA DI FRECCIA
-// ===================================================================
-void drawClockHand(const ClockHand& hand) {
-  // Centro dello schermo
-  int16_t centerX = 240;
-  int16_t centerY = 240;
-
-  // Converti angolo a radianti (-90 perché 0° è alle ore 3)
-  float rad = radians(hand.angle - 90);
-  float radPerp = rad + PI / 2;  // Angolo perpendicolare per larghezza
-
-  // Usa direttamente i parametri della lancetta
-  float lengthPx = hand.length;  // Lunghezza in pixel dalla configurazione
-
-  // Usa lo spessore dalla configurazione
-  float width = hand.thickness / 2.0f;  // Dividi per 2 perché verrà usato come raggio
-
-  // Calcola coordinate punto finale (punta)
-  int16_t tipX = centerX + cos(rad) * lengthPx;
-  int16_t tipY = centerY + sin(rad) * lengthPx;
-
-  // Calcola coordinate base (coda)
-  int16_t baseX = centerX - cos(rad) * 10;  // Leggermente dietro il centro
-  int16_t baseY = centerY - sin(rad) * 10;
-
-  // Calcola i 4 punti della freccia
-  int16_t left1X = baseX + cos(radPerp) * width;
-  int16_t left1Y = baseY + sin(radPerp) * width;
-  int16_t right1X = baseX - cos(radPerp) * width;
-  int16_t right1Y = baseY - sin(radPerp) * width;
-
-  int16_t left2X = tipX - cos(rad) * 15 + cos(radPerp) * (width / 2);
-  int16_t left2Y = tipY - sin(rad) * 15 + sin(radPerp) * (width / 2);
-  int16_t right2X = tipX - cos(rad) * 15 - cos(radPerp) * (width / 2);
-  int16_t right2Y = tipY - sin(rad) * 15 - sin(radPerp) * (width / 2);
-
-  uint16_t color565 = convertColor(hand.color);
-  uint16_t shadowColor = convertColor(Color(50, 50, 50));
-
-  // Disegna ombra (effetto 3D)
-  gfx->drawLine(left1X + 2, left1Y + 2, left2X + 2, left2Y + 2, shadowColor);
-  gfx->drawLine(right1X + 2, right1Y + 2, right2X + 2, right2Y + 2, shadowColor);
-  gfx->drawLine(left2X + 2, left2Y + 2, tipX + 2, tipY + 2, shadowColor);
-  gfx->drawLine(right2X + 2, right2Y + 2, tipX + 2, tipY + 2, shadowColor);
-
-  // Disegna corpo principale lancetta
-  gfx->drawLine(left1X, left1Y, left2X, left2Y, color565);
-  gfx->drawLine(right1X, right1Y, right2X, right2Y, color565);
-  gfx->drawLine(left2X, left2Y, tipX, tipY, color565);
-  gfx->drawLine(right2X, right2Y, tipX, tipY, color565);
-
-  // Riempimento (disegna linee parallele per riempire)
-  for (int i = -width; i <= width; i += 2) {
-    int16_t fillLeft1X = baseX + cos(radPerp) * i;
-    int16_t fillLeft1Y = baseY + sin(radPerp) * i;
-    int16_t fillLeft2X = tipX - cos(rad) * 15 + cos(radPerp) * (i / 2);
-    int16_t fillLeft2Y = tipY - sin(rad) * 15 + sin(radPerp) * (i / 2);
-
-    gfx->drawLine(fillLeft1X, fillLeft1Y, fillLeft2X, fillLeft2Y, color565);
-  }
-
-  // Bordo chiaro superiore (effetto riflessione)
-  uint16_t highlightColor = convertColor(Color(255, 255, 255));
-  gfx->drawLine(left1X - 1, left1Y - 1, left2X - 1, left2Y - 1, highlightColor);
-  gfx->drawLine(left2X - 1, left2Y - 1, tipX - 1, tipY - 1, highlightColor);
-}
-
 // ===================================================================
 // DISEGNA SOTTO-QUADRANTE GMT (separato dal quadrante principale)
 // ===================================================================
@@ -219,14 +219,7 @@ Audio::Audio(bool internalDAC /* = false */, uint8_t channelEnabled /* = I2S_DAC
     }
 
     i2s_zero_dma_buffer((i2s_port_t) m_i2s_num);
-
-    for(int i = 0; i <3; i++) {
-        m_filter[i].a0  = 1;
-        m_filter[i].a1  = 0;
-        m_filter[i].a2  = 0;
-        m_filter[i].b1  = 0;
-        m_filter[i].b2  = 0;
-    }
+    updateGain();
 }
 //---------------------------------------------------------------------------------------------------------------------
 void Audio::setBufsize(int rambuf_sz, int psrambuf_sz) {
@@ -293,6 +286,8 @@ Audio::~Audio() {
     //InBuff.~AudioBuffer(); #215 the AudioBuffer is automatically destroyed by the destructor
     setDefaults();
     if(m_playlistBuff) {free(m_playlistBuff); m_playlistBuff = NULL;}
+    if(nextfile) nextfile.close();
+    if(m_prefetchBuff) {free(m_prefetchBuff); m_prefetchBuff = NULL;}
     i2s_driver_uninstall((i2s_port_t)m_i2s_num); // #215 free I2S buffer
 }
 //---------------------------------------------------------------------------------------------------------------------
@@ -355,6 +350,26 @@ void Audio::setDefaults() {
     //TEST loop
     m_file_size = 0;
     //TEST loop
+
+    m_trackStartPos = 0;                                    // gapless trim, set again by connecttoFS()
+    m_skipSamples = 0;
+    m_skipLeft = 0;
+    m_totalSamples = 0;
+    m_trackSamples = 0;
+    m_f_trackDone = false;
+    m_f_gapMeasure = false;
+
+    m_f_reconnect = false;                                  // stream health, see processWebStream()
+    m_f_resync = false;
+    m_f_buffering = true;
+    m_tailLen = 0;
+    m_reconnectFails = 0;
+    m_arrivalBps = 0;
+    m_jitterMs = 0;
+    m_startFill = 0;
+    m_underruns = 0;
+    m_reconnects = 0;
+    m_resyncs = 0;
 }
 //---------------------------------------------------------------------------------------------------------------------
 void Audio::httpPrint(const char* url) {
@@ -452,7 +467,7 @@ bool Audio::connecttohost(const char* host, const char* user, const char* pwd) {
         memcpy(l_host, "http://", 7);
     }
 
-    setDefaults();
+    if(!m_f_reconnect) setDefaults();                         // soft reconnect: InBuff and decoder are kept
 
     AUDIO_INFO(sprintf(chbuf, "Connect to new host: \"%s\"", l_host);)
 
@@ -570,10 +585,12 @@ bool Audio::connecttohost(const char* host, const char* user, const char* pwd) {
         return true;
     }
     AUDIO_INFO(sprintf(chbuf, "Request %s failed!", l_host);)
-    if(audio_showstation) audio_showstation("");
-    if(audio_showstreamtitle) audio_showstreamtitle("");
-    if(audio_icydescription) audio_icydescription("");
-    if(audio_icyurl) audio_icyurl("");
+    if(!m_f_reconnect) {                                      // soft reconnect: the station plays on, retried later
+        if(audio_showstation) audio_showstation("");
+        if(audio_showstreamtitle) audio_showstreamtitle("");
+        if(audio_icydescription) audio_icydescription("");
+        if(audio_icyurl) audio_icyurl("");
+    }
     m_lastHost[0] = 0;
     if(hostwoext) {free(hostwoext); hostwoext = NULL;}
     if(extension) {free(extension); extension = NULL;}
@@ -637,13 +654,19 @@ bool Audio::connecttoSD(const char* path, uint32_t resumeFilePos) {
     return connecttoFS(SD, path, resumeFilePos);
 }
 //---------------------------------------------------------------------------------------------------------------------
-bool Audio::connecttoFS(fs::FS &fs, const char* path, uint32_t resumeFilePos) {
+bool Audio::connecttoFS(fs::FS &fs, const char* path, uint32_t resumeFilePos, uint32_t skipSamples, uint32_t totalSamples) {
+    // skipSamples, totalSamples: gapless trim (e.g. LAME tag), the samples before skipSamples and after
+    // totalSamples are not played. resumeFilePos can point to the first frame after the Xing/Info frame.
 
     if(strlen(path)>255) return false;
 
     m_resumeFilePos = resumeFilePos;
     char audioName[256];
     setDefaults(); // free buffers an set defaults
+    m_trackStartPos = resumeFilePos;
+    m_skipSamples   = skipSamples;
+    m_skipLeft      = skipSamples;
+    m_totalSamples  = totalSamples;
     memcpy(audioName, path, strlen(path)+1);
     if(audioName[0] != '/'){
         for(int i = 255; i > 0; i--){
@@ -749,6 +772,159 @@ bool Audio::connecttoFS(fs::FS &fs, const char* path, uint32_t resumeFilePos) {
     return false;
 }
 //---------------------------------------------------------------------------------------------------------------------
+bool Audio::queueFS(fs::FS &fs, const char* path, uint32_t startPos, uint32_t skipSamples, uint32_t totalSamples) {
+    // Gapless playback: the file follows the current one without restarting I2S. loop() opens it and reads
+    // m_prefetchSize bytes ahead as soon as the current file is completely in InBuff (the last seconds),
+    // at eof the decoder continues with it at the next frame boundary. startPos (mp3 only) is the first
+    // audio frame, the ID3 header is not parsed then. One file can be queued, a new call replaces it.
+
+    if(!path || strlen(path) > 254) return false;
+    if(!psramFound()) return false;
+
+    const char* ext = strrchr(path, '.');
+    if(!ext) return false;
+    uint8_t codec = CODEC_NONE;
+    if(strcasecmp(ext, ".mp3") == 0) codec = CODEC_MP3;
+    if(strcasecmp(ext, ".wav") == 0) codec = CODEC_WAV;
+    if(codec == CODEC_NONE) return false; // m4a, flac: the header parser needs random access
+    if(codec != CODEC_MP3) startPos = 0;
+
+    portENTER_CRITICAL(&m_queueMux);
+    m_queueReq.fs = &fs;
+    m_queueReq.path[0] = '/';
+    strcpy(m_queueReq.path + (path[0] == '/' ? 0 : 1), path);
+    m_queueReq.startPos = startPos;
+    m_queueReq.skipSamples = skipSamples;
+    m_queueReq.totalSamples = totalSamples;
+    m_queueReq.codec = codec;
+    m_f_queueReq = true;
+    portEXIT_CRITICAL(&m_queueMux);
+    return true;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::clearQueue() {
+    portENTER_CRITICAL(&m_queueMux);
+    m_f_queueReq = false;
+    m_f_queueClear = true;
+    portEXIT_CRITICAL(&m_queueMux);
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::processQueue() {
+    // runs in the audio task: nextfile and the prefetch buffer are only touched here and in processLocalFile()
+    if(!m_f_queueReq && !m_f_queueClear) return;
+
+    portENTER_CRITICAL(&m_queueMux);
+    bool f_clear = m_f_queueClear;
+    bool f_req   = m_f_queueReq;
+    if(f_req) memcpy(&m_queueNext, &m_queueReq, sizeof(queue_t));
+    m_f_queueClear = false;
+    m_f_queueReq = false;
+    portEXIT_CRITICAL(&m_queueMux);
+
+    if(nextfile) nextfile.close();
+    m_f_nextOpen = false;
+    m_prefetchLen = 0;
+    m_f_queued = f_req;
+    if(f_req) {AUDIO_INFO(sprintf(chbuf, "queued: \"%s\"", m_queueNext.path);)}
+    else if(f_clear) log_d("queue cleared");
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::prefetchNext() {
+    // first call: open the queued file, then m_prefetchChunk bytes per call until m_prefetchSize
+    if(!m_f_nextOpen) {
+        if(!m_prefetchBuff) m_prefetchBuff = (uint8_t*) ps_malloc(m_prefetchSize);
+        if(m_prefetchBuff && m_queueNext.fs) nextfile = m_queueNext.fs->open(m_queueNext.path);
+        if(!nextfile) {
+            AUDIO_INFO(sprintf(chbuf, "queued file \"%s\" can't be opened", m_queueNext.path);)
+            m_f_queued = false;
+            return;
+        }
+        if(m_queueNext.startPos) {
+            if(m_queueNext.startPos >= nextfile.size() || !nextfile.seek(m_queueNext.startPos)) {
+                m_queueNext.startPos = 0; // parse the header instead
+                nextfile.seek(0);
+            }
+        }
+        m_prefetchLen = 0;
+        m_f_nextOpen = true;
+        return;
+    }
+    if(m_prefetchLen >= m_prefetchSize) return;
+    size_t n = m_prefetchSize - m_prefetchLen;
+    if(n > m_prefetchChunk) n = m_prefetchChunk;
+    int res = nextfile.read(m_prefetchBuff + m_prefetchLen, n);
+    if(res > 0) m_prefetchLen += res;
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::switchToNext() {
+    // eof of the current file, its last frame is decoded and in the DMA. The queued file continues in the same
+    // InBuff: no playI2Sremains(), no i2s_zero_dma_buffer(), no reclocking if the samplerate is the same.
+    queue_t* q = &m_queueNext;
+
+    if(q->codec != m_codec) {
+        if(m_codec == CODEC_MP3) MP3Decoder_FreeBuffers();
+        if(m_codec == CODEC_AAC || m_codec == CODEC_M4A) AACDecoder_FreeBuffers();
+        if(m_codec == CODEC_FLAC) FLACDecoder_FreeBuffers();
+        m_codec = CODEC_NONE;
+        if(q->codec == CODEC_MP3 && !MP3Decoder_AllocateBuffers()) {
+            nextfile.close();
+            m_f_nextOpen = false;
+            m_f_queued = false;
+            return false; // normal eof
+        }
+    }
+    else if(m_codec == CODEC_MP3) {
+        MP3Decoder_ClearBuffer(); // no bit reservoir or overlap from the previous file
+    }
+
+    audiofile.close();
+    audiofile = nextfile;
+    nextfile = File();
+    m_codec = q->codec;
+    m_file_size = audiofile.size();
+
+    InBuff.changeMaxBlockSize(m_codec == CODEC_MP3 ? m_frameSizeMP3 : m_frameSizeWav);
+    InBuff.resetBuffer();
+    size_t n = m_prefetchLen;
+    if(n > InBuff.writeSpace()) n = InBuff.writeSpace();
+    if(n) {
+        memcpy(InBuff.getWritePtr(), m_prefetchBuff, n);
+        InBuff.bytesWritten(n);
+    }
+    if(n < m_prefetchLen) audiofile.seek(q->startPos + n);
+
+    m_controlCounter    = q->startPos ? 100 : 0;  // with startPos the header is known by the caller
+    m_audioDataStart    = q->startPos;
+    m_contentlength     = q->startPos ? m_file_size : 0;
+    m_audioDataSize     = q->startPos ? m_file_size - q->startPos : 0;
+    m_resumeFilePos     = 0;
+    m_f_playing         = false;                  // sendBytes() syncs and reads the decoder params again
+    m_audioCurrentTime  = 0;
+    m_audioFileDuration = 0;
+    m_avr_bitrate       = 0;
+    m_bitRate           = 0;
+    m_bytesNotDecoded   = 0;
+    m_validSamples      = 0;
+    m_curSample         = 0;
+
+    m_trackStartPos = q->startPos;
+    m_skipSamples   = q->skipSamples;
+    m_skipLeft      = q->skipSamples;
+    m_totalSamples  = q->totalSamples;
+    m_trackSamples  = 0;
+    m_f_trackDone   = false;
+    m_f_gapMeasure  = true;
+
+    m_f_queued   = false;
+    m_f_nextOpen = false;
+    m_prefetchLen = 0;
+
+    m_switchCount++;
+    AUDIO_INFO(sprintf(chbuf, "End of file, gapless to \"%s\"", q->path);)
+    if(audio_next_mp3) audio_next_mp3(q->path);
+    return true;
+}
+//---------------------------------------------------------------------------------------------------------------------
 bool Audio::connecttospeech(const char* speech, const char* lang){
 
     setDefaults();
@@ -1698,7 +1874,7 @@ int Audio::read_MP3_Header(uint8_t *data, size_t len) {
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     if(m_controlCounter == 99){ //  exist another ID3tag?
         m_audioDataStart += id3Size;
-        vTaskDelay(30);
+        if(!m_f_gapMeasure) vTaskDelay(30); // not in a gapless switch: the old file's DMA tail is draining
         if((*(data + 0) == 'I') && (*(data + 1) == 'D') && (*(data + 2) == '3')) {
             m_controlCounter = 0;
             return 0;
@@ -2181,6 +2357,9 @@ int Audio::read_OGG_Header(uint8_t *data, size_t len){
 //---------------------------------------------------------------------------------------------------------------------
 uint32_t Audio::stopSong() {
     uint32_t pos = 0;
+    clearQueue();
+    m_f_reconnect = false;
+    m_f_resync = false;
     if(m_f_running) {
         m_f_running = false;
         if(m_f_localfile){
@@ -2197,6 +2376,8 @@ uint32_t Audio::stopSong() {
         log_w("Closing audio file");  // for debug
     }
     memset(m_outBuff, 0, sizeof(m_outBuff));     //Clear OutputBuffer
+    m_src.reset();                               // no tail of this stream in front of the next one
+    m_i2sPendLen = 0;
     i2s_zero_dma_buffer((i2s_port_t) m_i2s_num);
     return pos;
 }
@@ -2229,89 +2410,70 @@ bool Audio::pauseResume() {
 //---------------------------------------------------------------------------------------------------------------------
 bool Audio::playChunk() {
     // If we've got data, try and pump it out..
-    int16_t sample[2];
-    if(getBitsPerSample() == 8) {
-        if(getChannels() == 1) {
-            while(m_validSamples) {
-                uint8_t x =  m_outBuff[m_curSample] & 0x00FF;
-                uint8_t y = (m_outBuff[m_curSample] & 0xFF00) >> 8;
-                sample[LEFTCHANNEL]  = x;
-                sample[RIGHTCHANNEL] = x;
-                while(1) {
-                    if(playSample(sample)) break;
-                } // Can't send?
-                sample[LEFTCHANNEL]  = y;
-                sample[RIGHTCHANNEL] = y;
-                while(1) {
-                    if(playSample(sample)) break;
-                } // Can't send?
-                m_validSamples--;
-                m_curSample++;
-            }
-        }
-        if(getChannels() == 2) {
-            while(m_validSamples) {
-                uint8_t x =  m_outBuff[m_curSample] & 0x00FF;
-                uint8_t y = (m_outBuff[m_curSample] & 0xFF00) >> 8;
-                if(!m_f_forceMono) { // stereo mode
-                    sample[LEFTCHANNEL]  = x;
-                    sample[RIGHTCHANNEL] = y;
-                }
-                else { // force mono
-                    uint8_t xy = (x + y) / 2;
-                    sample[LEFTCHANNEL]  = xy;
-                    sample[RIGHTCHANNEL] = xy;
+    // The samples are collected as L/R int16 in m_i2sBlock, one i2s_write() per block (see playBlock())
+    if(getBitsPerSample() != 8 && getBitsPerSample() != 16) {
+        log_e("BitsPer Sample must be 8 or 16!");
+        return false;
+    }
+    while(m_validSamples) {
+        if(!flushI2S()) return false; // the rest of the last block first, m_outBuff is kept until it's out
+        uint16_t n = 0;
+        if(getBitsPerSample() == 8) { // Upsample from unsigned 8 bits to signed 16 bits
+            if(getChannels() == 1) {  // two samples in each word
+                while(m_validSamples && n <= EQ_BLOCK - 2) {
+                    int16_t x = ((m_outBuff[m_curSample] & 0x00FF) - 128) << 8;
+                    int16_t y = (((m_outBuff[m_curSample] & 0xFF00) >> 8) - 128) << 8;
+                    m_i2sBlock[2 * n] = x; m_i2sBlock[2 * n + 1] = x; n++;
+                    m_i2sBlock[2 * n] = y; m_i2sBlock[2 * n + 1] = y; n++;
+                    m_validSamples--;
+                    m_curSample++;
                 }
-
-                while(1) {
-                    if(playSample(sample)) break;
-                } // Can't send?
-                m_validSamples--;
-                m_curSample++;
             }
-        }
-        m_curSample = 0;
-        return true;
-    }
-    if(getBitsPerSample() == 16) {
-        if(getChannels() == 1) {
-            while(m_validSamples) {
-                sample[LEFTCHANNEL]  = m_outBuff[m_curSample];
-                sample[RIGHTCHANNEL] = m_outBuff[m_curSample];
-                if(!playSample(sample)) {
-                    return false;
-                } // Can't send
-                m_validSamples--;
-                m_curSample++;
+            else {
+                while(m_validSamples && n < EQ_BLOCK) {
+                    int16_t x = ((m_outBuff[m_curSample] & 0x00FF) - 128) << 8;
+                    int16_t y = (((m_outBuff[m_curSample] & 0xFF00) >> 8) - 128) << 8;
+                    if(m_f_forceMono) x = y = (x + y) / 2; // force mono
+                    m_i2sBlock[2 * n] = x; m_i2sBlock[2 * n + 1] = y; n++;
+                    m_validSamples--;
+                    m_curSample++;
+                }
             }
         }
-        if(getChannels() == 2) {
-            while(m_validSamples) {
-                if(!m_f_forceMono) { // stereo mode
-                    sample[LEFTCHANNEL]  = m_outBuff[m_curSample * 2];
-                    sample[RIGHTCHANNEL] = m_outBuff[m_curSample * 2 + 1];
+        else {
+            if(getChannels() == 1) {
+                while(m_validSamples && n < EQ_BLOCK) {
+                    m_i2sBlock[2 * n] = m_i2sBlock[2 * n + 1] = m_outBuff[m_curSample]; n++;
+                    m_validSamples--;
+                    m_curSample++;
                 }
-                else { // mono mode, #100
-                    int16_t xy = (m_outBuff[m_curSample * 2] + m_outBuff[m_curSample * 2 + 1]) / 2;
-                    sample[LEFTCHANNEL] = xy;
-                    sample[RIGHTCHANNEL] = xy;
+            }
+            else {
+                while(m_validSamples && n < EQ_BLOCK) {
+                    if(!m_f_forceMono) { // stereo mode
+                        m_i2sBlock[2 * n]     = m_outBuff[m_curSample * 2];
+                        m_i2sBlock[2 * n + 1] = m_outBuff[m_curSample * 2 + 1];
+                    }
+                    else { // mono mode, #100
+                        int16_t xy = (m_outBuff[m_curSample * 2] + m_outBuff[m_curSample * 2 + 1]) / 2;
+                        m_i2sBlock[2 * n] = m_i2sBlock[2 * n + 1] = xy;
+                    }
+                    n++;
+                    m_validSamples--;
+                    m_curSample++;
                 }
-                if(!playSample(sample)) {
-                    return false;
-                } // Can't send
-                m_validSamples--;
-                m_curSample++;
             }
         }
-        m_curSample = 0;
-        return true;
+        if(!playBlock(n)) return false; // Can't send
     }
-    log_e("BitsPer Sample must be 8 or 16!");
-    return false;
+    m_curSample = 0;
+    return true;
 }
 //---------------------------------------------------------------------------------------------------------------------
 void Audio::loop() {
 
+    processQueue();                                          // queueFS() / clearQueue() from other tasks
+
     // - localfile - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     if(m_f_localfile) {                                      // Playing file fron SPIFFS or SD?
         processLocalFile();
@@ -2334,7 +2496,7 @@ void Audio::loop() {
         }
         if(m_datamode == AUDIO_HEADER){
             processAudioHeaderData();
-            if(m_f_m3u8data) processWebStream();
+            if(m_f_m3u8data || m_f_reconnect) processWebStream();
             return;
         }
         if(m_datamode == AUDIO_DATA){
@@ -2955,11 +3117,21 @@ void Audio::processLocalFile() {
            }
     }
     //----------------------------------------------------------------------------------------------------
+    if(m_f_trackDone) { // totalSamples played, the rest is encoder padding or tags: force eof
+        InBuff.resetBuffer();
+        bytesCanBeWritten = 0;
+    }
 
     bytesAddedToBuffer = audiofile.read(InBuff.getWritePtr(), bytesCanBeWritten);
     if(bytesAddedToBuffer > 0) {
         InBuff.bytesWritten(bytesAddedToBuffer);
     }
+    if(m_f_queued && !m_f_loop) { // the current file is completely in InBuff: read the queued one ahead
+        if(m_f_trackDone || !audiofile.available() ||
+          ((m_controlCounter == 100) && (m_contentlength > 0) && (getFilePos() >= m_contentlength))) {
+            prefetchNext();
+        }
+    }
 
     if(bytesAddedToBuffer == -1) bytesAddedToBuffer = 0; // read error? eof?
     bytesCanBeRead = InBuff.bufferFilled();
@@ -3029,12 +3201,22 @@ void Audio::processLocalFile() {
                 return;
             }
         }
+        if(m_f_queued && !m_f_loop) { // gapless: the queued file takes over, I2S is not flushed
+            if(!m_f_nextOpen) prefetchNext();
+            if(m_f_nextOpen && switchToNext()) {
+                f_stream = false;
+                return;
+            }
+        }
         InBuff.resetBuffer();
         playI2Sremains();
 
         if(m_f_loop  && f_stream){  //eof
             AUDIO_INFO(sprintf(chbuf, "loop from: %u to: %u", getFilePos(), m_audioDataStart);) //TEST loop
-            setFilePos(m_audioDataStart);
+            setFilePos(m_trackStartPos > m_audioDataStart ? m_trackStartPos : m_audioDataStart);
+            m_skipLeft = m_skipSamples;
+            m_trackSamples = 0;
+            m_f_trackDone = false;
             if(m_codec == CODEC_FLAC) FLACDecoderReset();
             /*
                 The current time of the loop mode is not reset,
@@ -3098,6 +3280,12 @@ void Audio::processWebStream() {
         m_t0 = millis();
         metacount = m_metaint;
         readMetadata(0, true); // reset all static vars
+        m_f_buffering = true;
+        m_lastArrival = millis();
+        m_winStart = millis();
+        m_winBytes = 0;
+        m_winMaxGap = 0;
+        m_startFill = streamFillBytes(500);
     }
     if(m_f_continue){ // next m3u8 chunk is available
         byteCounter = 0;
@@ -3105,12 +3293,14 @@ void Audio::processWebStream() {
         m_f_continue = false;
     }
 
-    if(m_datamode != AUDIO_DATA) return;        // guard
+    if(m_datamode != AUDIO_DATA && !m_f_reconnect) return;        // guard
 
     if(m_f_webfile){
 
     }
-    availableBytes = _client->available();      // available from stream
+    // while the headers of a soft reconnect arrive only the buffer tail is played
+    availableBytes = (m_datamode == AUDIO_DATA) ? _client->available() : 0; // available from stream
+    updateStreamHealth(availableBytes);
 
     // timer, triggers every second - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     if((tmr_1s + 1000) < millis()) {
@@ -3181,8 +3371,24 @@ void Audio::processWebStream() {
         }
     }
 
+    // live stream stalled or closed by the server: reconnect, the buffer tail keeps playing - - - - - - - - - - - - -
+    if(!m_f_webfile && !m_f_m3u8data && !availableBytes){
+        uint32_t silence = millis() - m_lastArrival;
+        // after a failed attempt there is no connection to lose: wait m_streamStallMs before the next one
+        bool     closed  = (m_datamode == AUDIO_DATA) && !m_reconnectFails && silence > 500 && !_client->connected();
+        if(closed || silence > m_streamStallMs) {
+            if(audio_info) audio_info(closed ? "Stream closed -> reconnect" : "Stream stalled -> reconnect");
+            if(!softReconnect() && m_reconnectFails >= 10) {  // ~30s without success, start from scratch
+                char host[strlen(m_lastHost) + 1];
+                strcpy(host, m_lastHost);
+                connecttohost(host);
+            }
+            return;
+        }
+    }
+
     // if the buffer can't filled for several seconds try a new connection  - - - - - - - - - - - - - - - - - - - - - -
-    if(f_stream && !availableBytes && !f_webFileAudioComplete){
+    if(f_stream && !availableBytes && !f_webFileAudioComplete && (m_f_webfile || m_f_m3u8data)){
         loopCnt++;
         if(loopCnt > 200000) {              // wait several seconds
             loopCnt = 0;
@@ -3194,7 +3400,7 @@ void Audio::processWebStream() {
     if(availableBytes) loopCnt = 0;
 
     // buffer fill routine  - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-    if(true) { // statement has no effect
+    if(m_datamode == AUDIO_DATA) {
         uint32_t bytesCanBeWritten = InBuff.writeSpace();
         if(!m_f_swm)    bytesCanBeWritten = min(metacount,  bytesCanBeWritten);
         if(m_f_chunked) bytesCanBeWritten = min(m_chunkcount, bytesCanBeWritten);
@@ -3227,17 +3433,23 @@ void Audio::processWebStream() {
             if(m_f_webfile)             byteCounter  += bytesAddedToBuffer;  // Pull request #42
             if(!m_f_swm)                metacount  -= bytesAddedToBuffer;
             if(m_f_chunked)             m_chunkcount -= bytesAddedToBuffer;
-            InBuff.bytesWritten(bytesAddedToBuffer);
+            m_winBytes += bytesAddedToBuffer;
+            if(m_f_resync)              bytesAddedToBuffer = resyncStream(InBuff.getWritePtr(), bytesAddedToBuffer);
+            if(!m_f_webfile)            storeStreamTail(InBuff.getWritePtr(), bytesAddedToBuffer);
+            if(bytesAddedToBuffer > 0)  InBuff.bytesWritten(bytesAddedToBuffer);
         }
 
-        if(InBuff.bufferFilled() > maxFrameSize && !f_stream) {  // waiting for buffer filled
+        // live streams prebuffer according to the measured jitter, files and m3u8 chunks start at once
+        uint32_t startFill = (m_f_webfile || m_f_m3u8data) ? maxFrameSize : m_startFill;
+        if(InBuff.bufferFilled() > startFill && !f_stream) {  // waiting for buffer filled
             f_stream = true;  // ready to play the audio data
+            m_f_buffering = false;
             uint16_t filltime = millis() - m_t0;
             if(audio_info) audio_info("stream ready");
-            AUDIO_INFO(sprintf(chbuf, "buffer filled in %d ms", filltime);)
+            AUDIO_INFO(sprintf(chbuf, "buffer filled in %d ms (%u bytes)", filltime, InBuff.bufferFilled());)
         }
-        if(!f_stream) return;
     }
+    if(!f_stream) return;
 
     // if we have a webfile, read the file header first - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     if(m_f_webfile && m_controlCounter != 100 && !m_f_m3u8data){ // m3u8call, audiochunk has no header
@@ -3290,7 +3502,17 @@ void Audio::processWebStream() {
     if(!f_stream) return; // 1. guard
     bool a = InBuff.bufferFilled() >= maxFrameSize;
     bool b = (m_audioDataSize  > 0) && (m_audioDataSize <= audioDataCount + maxFrameSize);
-    if(!a && !b) return; // 2. guard   fill < frame && last frame(s)
+    if(!a && !b) { // 2. guard   fill < frame && last frame(s)
+        if(!m_f_webfile && !m_f_m3u8data){ // live stream ran dry: rebuffer, more deeply with every underrun
+            f_stream = false;
+            m_f_buffering = true;
+            m_underruns++;
+            m_t0 = millis();
+            m_startFill = streamFillBytes(constrain(2000 + 4 * m_jitterMs + 1000 * min(m_underruns, (uint32_t)4), 2000, 15000));
+            AUDIO_INFO(sprintf(chbuf, "buffer underrun #%u, rebuffering %u bytes", m_underruns, m_startFill);)
+        }
+        return;
+    }
 
     size_t data2decode = InBuff.bufferFilled();
 
@@ -3343,6 +3565,144 @@ void Audio::processWebStream() {
     return;
 }
 //---------------------------------------------------------------------------------------------------------------------
+void Audio::updateStreamHealth(int32_t availableBytes) {
+    // arrival rate and jitter of a webstream, measured in windows of one second
+    uint32_t now = millis();
+    if(availableBytes > 0 && m_datamode == AUDIO_DATA) {
+        uint32_t gap = now - m_lastArrival;
+        if(gap > m_winMaxGap) m_winMaxGap = gap;
+        m_lastArrival = now;
+        m_reconnectFails = 0;
+    }
+    if(now - m_winStart < 1000) return;
+
+    uint32_t bps = (uint64_t)m_winBytes * 8000 / (now - m_winStart);
+    m_arrivalBps = m_arrivalBps ? (3 * m_arrivalBps + bps) / 4 : bps;
+    if(m_winMaxGap > m_jitterMs) m_jitterMs = (m_jitterMs + 3 * m_winMaxGap) / 4;   // fast attack
+    else                         m_jitterMs = (7 * m_jitterMs + m_winMaxGap) / 8;   // slow release
+    m_winStart = now;
+    m_winBytes = 0;
+    m_winMaxGap = 0;
+
+    if(m_f_buffering) { // the bitrate is known now (icy-br or first frames), adapt the threshold
+        uint32_t ms = m_underruns ? constrain(2000 + 4 * m_jitterMs + 1000 * min(m_underruns, (uint32_t)4), 2000, 15000)
+                                  : constrain(500 + 2 * m_jitterMs, 500, 8000);
+        m_startFill = streamFillBytes(ms);
+    }
+}
+//---------------------------------------------------------------------------------------------------------------------
+uint32_t Audio::streamFillBytes(uint32_t ms) {
+    // playing time -> bytes in InBuff, at most 3/4 of the buffer so that the network can always be read
+    uint32_t bps  = getBitRate();
+    if(!bps) bps  = 128000;                                  // unknown yet, most stations
+    uint32_t size = InBuff.bufferFilled() + InBuff.freeSpace();
+    uint32_t fill = (uint64_t)bps / 8 * ms / 1000;
+    return constrain(fill, (uint32_t)InBuff.getMaxBlockSize(), size / 4 * 3);
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::softReconnect() {
+    // Reopen the connection of a live stream without setDefaults(): InBuff and the decoder are kept and the tail
+    // in the buffer is played while the server answers. Icecast/Shoutcast start with a burst of already sent
+    // audio, resyncStream() skips it up to the last bytes received before the stall.
+    char host[strlen(m_lastHost) + 1];
+    strcpy(host, m_lastHost);
+    if(!strlen(host)) return false;
+
+    _client->stop();
+    m_f_chunked = false;
+    m_chunkcount = 0;
+    m_f_ctseen = false;
+    m_metaint = 0;
+    m_f_swm = true;
+    m_f_resync = false;
+    m_f_reconnect = true;
+    m_reconnects++;
+    m_lastArrival = millis();                                // next attempt after m_streamStallMs
+
+    if(connecttohost(host)) return true;
+
+    m_reconnectFails++;
+    m_f_reconnect = false;
+    strcpy(m_lastHost, host);                                // cleared by connecttohost() on failure
+    m_datamode = AUDIO_DATA;                                 // keep playing the tail, retry later
+    m_lastArrival = millis();
+    AUDIO_INFO(sprintf(chbuf, "reconnect failed (%u), %u bytes left", m_reconnectFails, InBuff.bufferFilled());)
+    return false;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::storeStreamTail(const uint8_t* buff, int32_t len) {
+    // remember the last m_tailSigLen bytes written into InBuff
+    if(len <= 0) return;
+    if(len >= m_tailSigLen) {
+        memcpy(m_tailSig, buff + len - m_tailSigLen, m_tailSigLen);
+        m_tailLen = m_tailSigLen;
+        return;
+    }
+    uint8_t keep = min((int32_t)m_tailLen, (int32_t)m_tailSigLen - len);
+    memmove(m_tailSig, m_tailSig + m_tailLen - keep, keep);
+    memcpy(m_tailSig + keep, buff, len);
+    m_tailLen = keep + len;
+}
+//---------------------------------------------------------------------------------------------------------------------
+int32_t Audio::resyncStream(uint8_t* buff, int32_t len) {
+    // search m_tailSig in m_resyncCarry + buff, returns the number of new bytes moved to the begin of buff
+    const uint8_t c = m_resyncCarryLen;
+    const int32_t n = c + len;
+    if(!m_resyncScanned && !c) m_resyncStart = millis();
+    for(int32_t i = 0; i + m_tailSigLen <= n; i++) {
+        uint8_t k = 0;
+        while(k < m_tailSigLen) {
+            int32_t j = i + k;
+            if(((j < c) ? m_resyncCarry[j] : buff[j - c]) != m_tailSig[k]) break;
+            k++;
+        }
+        if(k < m_tailSigLen) continue;
+        int32_t skip = i + m_tailSigLen - c;                 // >= 1, the carry is shorter than the signature
+        m_f_resync = false;
+        m_resyncs++;
+        AUDIO_INFO(sprintf(chbuf, "stream resynced, %u bytes already played skipped", m_resyncScanned + skip);)
+        memmove(buff, buff + skip, len - skip);
+        return len - skip;
+    }
+    m_resyncScanned += len;
+
+    // the signature can begin in the last bytes
+    uint8_t keep = min(n, (int32_t)m_tailSigLen - 1);
+    uint8_t tmp[m_tailSigLen];
+    for(uint8_t k = 0; k < keep; k++) {
+        int32_t j = n - keep + k;
+        tmp[k] = (j < c) ? m_resyncCarry[j] : buff[j - c];
+    }
+    memcpy(m_resyncCarry, tmp, keep);
+    m_resyncCarryLen = keep;
+
+    // not in the burst (long stall, transcoding server) or the tail is almost played: join at the live edge.
+    // Rebuffering after an underrun nothing is playing: search for a second, the burst comes at line speed
+    bool giveUp = m_f_buffering ? (millis() - m_resyncStart > 1000)
+                                : (InBuff.bufferFilled() < 4 * InBuff.getMaxBlockSize());
+    if(m_resyncScanned > 131072 || giveUp) {
+        m_f_resync = false;
+        AUDIO_INFO(sprintf(chbuf, "stream not resynced after %u bytes, joining live", m_resyncScanned);)
+        return len;
+    }
+    return 0;
+}
+//---------------------------------------------------------------------------------------------------------------------
+Audio::streamHealth_t Audio::getStreamHealth() {
+    streamHealth_t sh;
+    sh.fill       = InBuff.bufferFilled();
+    sh.size       = InBuff.bufferFilled() + InBuff.freeSpace();
+    sh.arrivalBps = m_arrivalBps;
+    sh.codecBps   = getBitRate();
+    sh.jitterMs   = m_jitterMs;
+    sh.startFill  = m_startFill;
+    sh.underruns  = m_underruns;
+    sh.reconnects = m_reconnects;
+    sh.resyncs    = m_resyncs;
+    sh.buffering  = m_f_webstream && m_f_buffering;
+    return sh;
+}
+//---------------------------------------------------------------------------------------------------------------------
 void Audio::processAudioHeaderData() {
 
     int av = 0;
@@ -3374,13 +3734,25 @@ void Audio::processAudioHeaderData() {
     if(!pos && m_f_ctseen){  // audio header complete?
         m_datamode = AUDIO_DATA;                         // Expecting data now
         if(m_f_Log) { AUDIO_INFO(sprintf(chbuf, "Switch to DATA, metaint is %d", m_metaint);) }
+        bool f_reconnect = m_f_reconnect;
+        if(m_f_reconnect){                               // soft reconnect, continue where the stall began
+            m_f_reconnect = false;
+            m_f_continue = true;                         // metacount = m_metaint
+            readMetadata(0, true);
+            m_f_resync = (m_tailLen == m_tailSigLen);
+            m_resyncScanned = 0;
+            m_resyncCarryLen = 0;
+            m_lastArrival = millis();
+        }
         memcpy(chbuf, m_lastHost, strlen(m_lastHost)+1);
 //        uint idx = indexOf(chbuf, "?", 0);
 //        if(idx > 0) chbuf[idx] = 0;
         if(audio_lasthost) audio_lasthost(chbuf);
-        if(!f_icyname){if(audio_showstation) audio_showstation("");}
-        if(!f_icydescription){if(audio_icydescription) audio_icydescription("");}
-        if(!f_icyurl){if(audio_icyurl) audio_icyurl("");}
+        if(!f_reconnect){                                // same station: keep what the first headers showed
+            if(!f_icyname){if(audio_showstation) audio_showstation("");}
+            if(!f_icydescription){if(audio_icydescription) audio_icydescription("");}
+            if(!f_icyurl){if(audio_icyurl) audio_icyurl("");}
+        }
         f_icyname = false;
         f_icydescription = false;
         f_icyurl = false;
@@ -3428,7 +3800,8 @@ void Audio::processAudioHeaderData() {
     }
 
     if(indexOf(hl, "content-type:", 0) >= 0) {
-        if(parseContentType(hl)) m_f_ctseen = true;
+        if(m_f_reconnect && m_codec != CODEC_NONE) m_f_ctseen = true;  // same station, the decoder is running
+        else if(parseContentType(hl)) m_f_ctseen = true;
     }
     else if(startsWith(hl, "location:")) {
         int pos = indexOf(hl, "http", 0);
@@ -3905,11 +4278,26 @@ int Audio::sendBytes(uint8_t* data, size_t len) {
         }
     }
     compute_audioCurrentTime(bytesDecoded);
+    if(m_skipLeft || m_totalSamples) trimSamples();
+
+    bool f_out = (m_validSamples > 0);
+    if(f_out && m_f_gapMeasure) { // first samples after a gapless switch
+        m_f_gapMeasure = false;
+        m_switchMicros = micros() - m_lastOutTime;
+        // i2s_write() blocks while the DMA is full, so after the last write of the old file
+        // (dma_buf_count - 1) * dma_buf_len samples were still queued: only the excess is silence.
+        // The DMA drains at the I2S clock, which is m_outputRate and not the source rate when resampling
+        uint32_t queued  = (m_i2s_config.dma_buf_count - 1) * m_i2s_config.dma_buf_len;
+        uint32_t elapsed = (uint64_t)m_switchMicros * m_i2sSampleRate / 1000000;
+        m_gapSamples = (elapsed > queued) ? elapsed - queued : 0;
+        AUDIO_INFO(sprintf(chbuf, "gapless switch: %u us, gap %u samples", m_switchMicros, m_gapSamples);)
+    }
 
     if(audio_process_extern){
         bool continueI2S = false;
         audio_process_extern(m_outBuff, m_validSamples, &continueI2S);
         if(!continueI2S){
+            if(f_out) m_lastOutTime = micros();
             return bytesDecoded;
         }
     }
@@ -3917,9 +4305,31 @@ int Audio::sendBytes(uint8_t* data, size_t len) {
     while(m_validSamples) {
         playChunk();
     }
+    if(f_out) m_lastOutTime = micros();
     return bytesDecoded;
 }
 //---------------------------------------------------------------------------------------------------------------------
+void Audio::trimSamples() {
+    // gapless: drop the encoder/decoder delay at the start and everything after the last valid sample
+    if(getBitsPerSample() != 16) return;
+    uint8_t ch = getChannels();
+    if(m_skipLeft) {
+        uint32_t n = m_validSamples;
+        if(n > m_skipLeft) n = m_skipLeft;
+        m_skipLeft -= n;
+        m_validSamples -= n;
+        if(m_validSamples) memmove(m_outBuff, m_outBuff + n * ch, m_validSamples * ch * sizeof(int16_t));
+    }
+    if(m_totalSamples) {
+        uint32_t left = (m_totalSamples > m_trackSamples) ? m_totalSamples - m_trackSamples : 0;
+        if((uint32_t)m_validSamples >= left) {
+            m_validSamples = left;
+            m_f_trackDone = true;
+        }
+        m_trackSamples += m_validSamples;
+    }
+}
+//---------------------------------------------------------------------------------------------------------------------
 void Audio::compute_audioCurrentTime(int bd) {
     static uint16_t loop_counter = 0;
     static int old_bitrate = 0;
@@ -4150,15 +4560,41 @@ bool Audio::audioFileSeek(const float speed) {
     if((speed > 1.5f) || (speed < 0.25f)) return false;
 
     uint32_t srate = getSampleRate() * speed;
+    if(m_outputRate) { // same clock, only the conversion ratio changes (as in setSampleRate())
+        if(srate == m_outputRate) {
+            m_f_resample = false;
+            return true;
+        }
+        if(m_src.setRates(srate, m_outputRate)) {
+            m_f_resample = true;
+            return true;
+        }
+        log_e("no resampler for %u Hz, I2S follows the source", srate);
+    }
     i2s_set_sample_rates((i2s_port_t)m_i2s_num, srate);
+    m_i2sSampleRate = srate;
+    m_eq.setSampleRate(srate);
+    m_f_resample = false;
     return true;
 }
 //---------------------------------------------------------------------------------------------------------------------
 bool Audio::setSampleRate(uint32_t sampRate) {
     if(!sampRate) sampRate = 16000; // fuse, if there is no value -> set default #209
-    i2s_set_sample_rates((i2s_port_t)m_i2s_num, sampRate);
+    uint32_t i2sRate = sampRate;
+    m_f_resample = false;
+    if(m_outputRate && sampRate != m_outputRate) {
+        if(m_src.setRates(sampRate, m_outputRate)) { // I2S keeps m_outputRate, playBlock() converts
+            i2sRate = m_outputRate;
+            m_f_resample = true;
+        }
+        else log_e("no resampler for %u Hz, I2S follows the source", sampRate);
+    }
+    if(i2sRate != m_i2sSampleRate) { // reclocking restarts the DMA, avoid it between files (gapless)
+        i2s_set_sample_rates((i2s_port_t)m_i2s_num, i2sRate);
+        m_i2sSampleRate = i2sRate;
+    }
     m_sampleRate = sampRate;
-    IIR_calculateCoefficients(m_gain0, m_gain1, m_gain2); // must be recalculated after each samplerate change
+    m_eq.setSampleRate(i2sRate); // coefficients are recalculated by the next block
     return true;
 }
 uint32_t Audio::getSampleRate(){
@@ -4225,64 +4661,152 @@ void Audio::setI2SCommFMT_LSB(bool commFMT) {
     log_i("commFMT = %i", m_i2s_config.communication_format);
     i2s_driver_uninstall((i2s_port_t)m_i2s_num);
     i2s_driver_install  ((i2s_port_t)m_i2s_num, &m_i2s_config, 0, NULL);
+    m_i2sSampleRate = m_i2s_config.sample_rate;
 }
 //---------------------------------------------------------------------------------------------------------------------
-bool Audio::playSample(int16_t sample[2]) {
+bool Audio::playBlock(uint16_t frames) {
+    // m_i2sBlock holds frames at the source rate
+    if(!m_f_resample) return writeBlock(m_i2sBlock, frames);
 
-    if (getBitsPerSample() == 8) { // Upsample from unsigned 8 bits to signed 16 bits
-        sample[LEFTCHANNEL]  = ((sample[LEFTCHANNEL]  & 0xff) -128) << 8;
-        sample[RIGHTCHANNEL] = ((sample[RIGHTCHANNEL] & 0xff) -128) << 8;
+    uint16_t done = 0;
+    while(done < frames) { // one input block gives 0...RS_MAX_RATIO output blocks
+        uint16_t used = 0;
+        uint16_t n = m_src.process(m_i2sBlock + 2 * done, frames - done, &used, m_srcBlock, EQ_BLOCK);
+        done += used;
+        if(n && !writeBlock(m_srcBlock, n)) return false;
     }
+    return true;
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::writeBlock(int16_t* buff, uint16_t frames) {
 
-    sample[LEFTCHANNEL]  = sample[LEFTCHANNEL]  >> 1; // half Vin so we can boost up to 6dB in filters
-    sample[RIGHTCHANNEL] = sample[RIGHTCHANNEL] >> 1;
-
-    // Filterchain, can commented out if not used
-    sample = IIR_filterChain0(sample);
-    sample = IIR_filterChain1(sample);
-    sample = IIR_filterChain2(sample);
-    //-------------------------------------------
+    if(!flushI2S()) return false; // I2S still stuck, this block is lost
 
-    uint32_t s32 = Gain(sample); // vosample2lume;
+    m_eq.process(buff, frames); // tone, loudness, volume/balance, dither
 
-    if(m_f_internalDAC) {
-        s32 += 0x80008000;
+    uint32_t* s32 = (uint32_t*)buff; // same memory: L in the upper half, R in the lower one
+    for(uint16_t i = 0; i < frames; i++) {
+        uint32_t v = ((uint16_t)buff[2 * i] << 16) | (uint16_t)buff[2 * i + 1];
+        if(m_f_internalDAC) v += 0x80008000;
+        s32[i] = v;
     }
 
-    esp_err_t err = i2s_write((i2s_port_t) m_i2s_num, (const char*) &s32, sizeof(uint32_t), &m_i2s_bytesWritten, 1000);
-    if(err != ESP_OK) {
-        log_e("ESP32 Errorcode %i", err);
+    size_t len  = frames * sizeof(uint32_t);
+    size_t done = writeI2S((const uint8_t*)s32, len);
+    if(done < len) { // the DMA took nothing for the whole timeout: keep the rest, the next block goes after it
+        memcpy(m_i2sPending, (const uint8_t*)s32 + done, len - done);
+        m_i2sPendPos = 0;
+        m_i2sPendLen = len - done;
         return false;
     }
-    if(m_i2s_bytesWritten < 4) {
-        log_e("Can't stuff any more in I2S..."); // increase waitingtime or outputbuffer
+    return true;
+}
+//---------------------------------------------------------------------------------------------------------------------
+size_t Audio::writeI2S(const uint8_t* data, size_t len) {
+    // i2s_write() returns short when the DMA stayed full for the whole timeout, the rest is written again
+    // as long as the DMA takes something. Returns the bytes written
+    size_t done = 0;
+    while(done < len) {
+        size_t bw = 0;
+        esp_err_t err = i2s_write((i2s_port_t) m_i2s_num, (const char*) data + done, len - done, &bw, 1000);
+        if(err != ESP_OK) {
+            log_e("ESP32 Errorcode %i", err);
+            break;
+        }
+        if(!bw) {
+            log_e("Can't stuff any more in I2S..."); // increase waitingtime or outputbuffer
+            break;
+        }
+        done += bw;
+    }
+    m_i2s_bytesWritten = done;
+    return done;
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::flushI2S() {
+    // the rest of a block writeBlock() couldn't send, false while some of it is still left
+    if(!m_i2sPendLen) return true;
+    size_t n = writeI2S((const uint8_t*)m_i2sPending + m_i2sPendPos, m_i2sPendLen);
+    m_i2sPendPos += n;
+    m_i2sPendLen -= n;
+    return !m_i2sPendLen;
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::setOutputRate(uint32_t rate, uint8_t quality) {
+    // rate != 0: the I2S clock stays at rate and every source is converted into it (no reclocking, no pops
+    // between web radio, files and writePCM()), quality RS_FAST, RS_BALANCED, RS_BEST
+    // rate == 0: former behaviour, the clock follows the source
+    // Also restores the clock after someone else used the driver (e.g. arcade sound)
+
+    m_src.setQuality(quality);
+    m_outputRate = rate;
+    uint32_t i2sRate = rate ? rate : m_sampleRate;
+    i2s_set_sample_rates((i2s_port_t)m_i2s_num, i2sRate);
+    m_i2sSampleRate = i2sRate;
+    setSampleRate(m_sampleRate); // conversion for the current source
+    m_src.reset();
+}
+//---------------------------------------------------------------------------------------------------------------------
+bool Audio::writePCM(const int16_t* buff, uint16_t frames, uint32_t sampleRate, uint8_t channels) {
+    // PCM produced outside the decoders (synthesized clicks, an emulator's sound...), same path as the
+    // decoders: resampler, EQ/volume, I2S at m_outputRate. Blocks until written.
+    // Shares the resampler with the decoders, so only while no file or stream is playing.
+    // No caller in the sketch yet: ArcadeAudio still reclocks the driver to 24 kHz by itself
+
+    if(!m_outputRate) {
+        log_e("writePCM() needs setOutputRate()");
         return false;
     }
+    if(channels < 1 || channels > 2) return false;
+    bool resample = (sampleRate != m_outputRate);
+    if(resample && !m_src.setRates(sampleRate, m_outputRate)) return false;
+    m_f_resample = resample;
+    if(m_i2sSampleRate != m_outputRate) { // the last source had no resampler
+        i2s_set_sample_rates((i2s_port_t)m_i2s_num, m_outputRate);
+        m_i2sSampleRate = m_outputRate;
+        m_eq.setSampleRate(m_outputRate);
+    }
+
+    while(frames) {
+        if(!flushI2S()) return false;
+        uint16_t n = (frames < EQ_BLOCK) ? frames : EQ_BLOCK;
+        for(uint16_t i = 0; i < n; i++) {
+            if(channels == 1) m_i2sBlock[2 * i] = m_i2sBlock[2 * i + 1] = buff[i];
+            else {
+                m_i2sBlock[2 * i]     = buff[2 * i];
+                m_i2sBlock[2 * i + 1] = buff[2 * i + 1];
+            }
+        }
+        if(!playBlock(n)) return false;
+        buff += n * channels;
+        frames -= n;
+    }
     return true;
 }
 //---------------------------------------------------------------------------------------------------------------------
 void Audio::setTone(int8_t gainLowPass, int8_t gainBandPass, int8_t gainHighPass){
     // see https://www.earlevel.com/main/2013/10/13/biquad-calculator-v2/
-    // values can be between -40 ... +6 (dB)
-
-    m_gain0 = gainLowPass;
-    m_gain1 = gainBandPass;
-    m_gain2 = gainHighPass;
-
-    IIR_calculateCoefficients(m_gain0, m_gain1, m_gain2);
-
-    /*
-        This will cause a clicking sound when adjusting the EQ.
-        Because when the EQ is adjusted, the IIR filter will be cleared and played,
-        mixed in the audio data frame, and a click-like sound will be produced.
-    */
-    /*
-    int16_t tmp[2]; tmp[0] = 0; tmp[1]= 0;
-
-    IIR_filterChain0(tmp, true ); // flush the filter
-    IIR_filterChain1(tmp, true ); // flush the filter
-    IIR_filterChain2(tmp, true ); // flush the filter
-    */
+    // values can be between -40 ... +6 (dB), EQ bands 0...2
+
+    m_gain0 = constrain(gainLowPass,  -40, 6);
+    m_gain1 = constrain(gainBandPass, -40, 6);
+    m_gain2 = constrain(gainHighPass, -40, 6);
+
+    m_eq.setBand(0, EQ_LOWSHELF,   500, m_gain0);
+    m_eq.setBand(1, EQ_PEAK,      3000, m_gain1, 2.5);
+    m_eq.setBand(2, EQ_HIGHSHELF, 6000, m_gain2);
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::setEQBand(uint8_t band, uint8_t type, uint16_t freq, int8_t gain, float q){
+    // band 0...4 (0...2 are also set by setTone()), type EQ_OFF, EQ_LOWSHELF, EQ_PEAK, EQ_HIGHSHELF,
+    // EQ_LOWPASS, EQ_HIGHPASS, gain -40 ... +12 dB (shelves and peak), q (peak, low/high pass)
+    // boosts beyond 6dB lower the overall level instead of clipping
+    m_eq.setBand(band, type, freq, gain, q);
+}
+//---------------------------------------------------------------------------------------------------------------------
+void Audio::setLoudness(uint8_t level){
+    // listening level 0...100%: below 100 bass (100Hz) and treble (10kHz) are lifted, +1dB / +0.5dB every 10%
+    m_eq.setLoudness(level);
 }
 //---------------------------------------------------------------------------------------------------------------------
 void Audio::forceMono(bool m) { // #100 mono option
@@ -4293,11 +4817,13 @@ void Audio::setBalance(int8_t bal){ // bal -16...16
     if(bal < -16) bal = -16;
     if(bal >  16) bal =  16;
     m_balance = bal;
+    updateGain();
 }
 //---------------------------------------------------------------------------------------------------------------------
 void Audio::setVolume(uint8_t vol) { // vol 22 steps, 0...21
     if(vol > 21) vol = 21;
     m_vol = volumetable[vol];
+    updateGain();
 }
 //---------------------------------------------------------------------------------------------------------------------
 uint8_t Audio::getVolume() {
@@ -4312,8 +4838,8 @@ uint8_t Audio::getI2sPort() {
     return m_i2s_num;
 }
 //---------------------------------------------------------------------------------------------------------------------
-int32_t Audio::Gain(int16_t s[2]) {
-    int32_t v[2];
+void Audio::updateGain() {
+    // volume and balance -> AudioEQ, applied in the same multiply as the EQ headroom
     float step = (float)m_vol /64;
     uint8_t l = 0, r = 0;
 
@@ -4325,11 +4851,7 @@ int32_t Audio::Gain(int16_t s[2]) {
         step = step * m_balance * 4;
         r = (uint8_t)(step);
     }
-
-    v[LEFTCHANNEL] = (s[LEFTCHANNEL]  * (m_vol - l)) >> 6;
-    v[RIGHTCHANNEL]= (s[RIGHTCHANNEL] * (m_vol - r)) >> 6;
-
-    return (v[LEFTCHANNEL] << 16) | (v[RIGHTCHANNEL] & 0xffff);
+    m_eq.setGain(m_vol - l, m_vol - r);
 }
 //---------------------------------------------------------------------------------------------------------------------
 uint32_t Audio::inBufferFilled() {
@@ -4341,243 +4863,3 @@ uint32_t Audio::inBufferFree() {
     // current audio input buffer free space in bytes
     return InBuff.freeSpace();
 }
-//---------------------------------------------------------------------------------------------------------------------
-//            ***     D i g i t a l   b i q u a d r a t i c     f i l t e r     ***
-//---------------------------------------------------------------------------------------------------------------------
-void Audio::IIR_calculateCoefficients(int8_t G0, int8_t G1, int8_t G2){  // Infinite Impulse Response (IIR) filters
-
-    // G1 - gain low shelf   set between -40 ... +6 dB
-    // G2 - gain peakEQ      set between -40 ... +6 dB
-    // G3 - gain high shelf  set between -40 ... +6 dB
-    // https://www.earlevel.com/main/2012/11/26/biquad-c-source-code/
-
-    if(getSampleRate() < 1000) return;  // fuse
-
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-
-    if(G0 < -40) G0 = -40;      // -40dB -> Vin*0.01
-    if(G0 > 6) G0 = 6;          // +6dB -> Vin*2
-    if(G1 < -40) G1 = -40;
-    if(G1 > 6) G1 = 6;
-    if(G2 < -40) G2 = -40;
-    if(G2 > 6) G2 = 6;
-
-    const float FcLS   =  500;  // Frequency LowShelf[Hz]
-    const float FcPKEQ = 3000;  // Frequency PeakEQ[Hz]
-    const float FcHS   = 6000;  // Frequency HighShelf[Hz]
-
-    float K, norm, Q, Fc, V ;
-
-    // LOWSHELF
-    Fc = (float)FcLS / (float)getSampleRate(); // Cutoff frequency
-    K = tanf((float)PI * Fc);
-    V = powf(10, fabs(G0) / 20.0);
-
-    if (G0 >= 0) {  // boost
-        norm = 1 / (1 + sqrtf(2) * K + K * K);
-        m_filter[LOWSHELF].a0 = (1 + sqrtf(2*V) * K + V * K * K) * norm;
-        m_filter[LOWSHELF].a1 = 2 * (V * K * K - 1) * norm;
-        m_filter[LOWSHELF].a2 = (1 - sqrtf(2*V) * K + V * K * K) * norm;
-        m_filter[LOWSHELF].b1 = 2 * (K * K - 1) * norm;
-        m_filter[LOWSHELF].b2 = (1 - sqrtf(2) * K + K * K) * norm;
-    }
-    else {          // cut
-        norm = 1 / (1 + sqrtf(2*V) * K + V * K * K);
-        m_filter[LOWSHELF].a0 = (1 + sqrtf(2) * K + K * K) * norm;
-        m_filter[LOWSHELF].a1 = 2 * (K * K - 1) * norm;
-        m_filter[LOWSHELF].a2 = (1 - sqrtf(2) * K + K * K) * norm;
-        m_filter[LOWSHELF].b1 = 2 * (V * K * K - 1) * norm;
-        m_filter[LOWSHELF].b2 = (1 - sqrtf(2*V) * K + V * K * K) * norm;
-    }
-
-    // PEAK EQ
-    Fc = (float)FcPKEQ / (float)getSampleRate(); // Cutoff frequency
-    K = tanf((float)PI * Fc);
-    V = powf(10, fabs(G1) / 20.0);
-    Q = 2.5; // Quality factor
-    if (G1 >= 0) { // boost
-        norm = 1 / (1 + 1/Q * K + K * K);
-        m_filter[PEAKEQ].a0 = (1 + V/Q * K + K * K) * norm;
-        m_filter[PEAKEQ].a1 = 2 * (K * K - 1) * norm;
-        m_filter[PEAKEQ].a2 = (1 - V/Q * K + K * K) * norm;
-        m_filter[PEAKEQ].b1 = m_filter[PEAKEQ].a1;
-        m_filter[PEAKEQ].b2 = (1 - 1/Q * K + K * K) * norm;
-    }
-    else {    // cut
-        norm = 1 / (1 + V/Q * K + K * K);
-        m_filter[PEAKEQ].a0 = (1 + 1/Q * K + K * K) * norm;
-        m_filter[PEAKEQ].a1 = 2 * (K * K - 1) * norm;
-        m_filter[PEAKEQ].a2 = (1 - 1/Q * K + K * K) * norm;
-        m_filter[PEAKEQ].b1 = m_filter[PEAKEQ].a1;
-        m_filter[PEAKEQ].b2 = (1 - V/Q * K + K * K) * norm;
-    }
-
-    // HIGHSHELF
-    Fc = (float)FcHS / (float)getSampleRate(); // Cutoff frequency
-    K = tanf((float)PI * Fc);
-    V = powf(10, fabs(G2) / 20.0);
-    if (G2 >= 0) {  // boost
-        norm = 1 / (1 + sqrtf(2) * K + K * K);
-        m_filter[HIFGSHELF].a0 = (V + sqrtf(2*V) * K + K * K) * norm;
-        m_filter[HIFGSHELF].a1 = 2 * (K * K - V) * norm;
-        m_filter[HIFGSHELF].a2 = (V - sqrtf(2*V) * K + K * K) * norm;
-        m_filter[HIFGSHELF].b1 = 2 * (K * K - 1) * norm;
-        m_filter[HIFGSHELF].b2 = (1 - sqrtf(2) * K + K * K) * norm;
-    }
-    else {
-        norm = 1 / (V + sqrtf(2*V) * K + K * K);
-        m_filter[HIFGSHELF].a0 = (1 + sqrtf(2) * K + K * K) * norm;
-        m_filter[HIFGSHELF].a1 = 2 * (K * K - 1) * norm;
-        m_filter[HIFGSHELF].a2 = (1 - sqrtf(2) * K + K * K) * norm;
-        m_filter[HIFGSHELF].b1 = 2 * (K * K - V) * norm;
-        m_filter[HIFGSHELF].b2 = (V - sqrtf(2*V) * K + K * K) * norm;
-    }
-
-//    log_i("LS a0=%f, a1=%f, a2=%f, b1=%f, b2=%f", m_filter[0].a0, m_filter[0].a1, m_filter[0].a2,
-//                                                  m_filter[0].b1, m_filter[0].b2);
-//    log_i("EQ a0=%f, a1=%f, a2=%f, b1=%f, b2=%f", m_filter[1].a0, m_filter[1].a1, m_filter[1].a2,
-//                                                  m_filter[1].b1, m_filter[1].b2);
-//    log_i("HS a0=%f, a1=%f, a2=%f, b1=%f, b2=%f", m_filter[2].a0, m_filter[2].a1, m_filter[2].a2,
-//                                                  m_filter[2].b1, m_filter[2].b2);
-}
-//---------------------------------------------------------------------------------------------------------------------
-int16_t* Audio::IIR_filterChain0(int16_t iir_in[2], bool clear){  // Infinite Impulse Response (IIR) filters
-
-    uint8_t z1 = 0, z2 = 1;
-    enum: uint8_t {in = 0, out = 1};
-    float inSample[2];
-    float outSample[2];
-    static int16_t iir_out[2];
-
-    if(clear){
-        memset(m_filterBuff, 0, sizeof(m_filterBuff));            // zero IIR filterbuffer
-        iir_out[0] = 0;
-        iir_out[1] = 0;
-        iir_in[0]  = 0;
-        iir_in[1]  = 0;
-    }
-
-    inSample[LEFTCHANNEL]  = (float)(iir_in[LEFTCHANNEL]);
-    inSample[RIGHTCHANNEL] = (float)(iir_in[RIGHTCHANNEL]);
-
-    outSample[LEFTCHANNEL] =   m_filter[0].a0  * inSample[LEFTCHANNEL]
-                             + m_filter[0].a1  * m_filterBuff[0][z1][in] [LEFTCHANNEL]
-                             + m_filter[0].a2  * m_filterBuff[0][z2][in] [LEFTCHANNEL]
-                             - m_filter[0].b1  * m_filterBuff[0][z1][out][LEFTCHANNEL]
-                             - m_filter[0].b2  * m_filterBuff[0][z2][out][LEFTCHANNEL];
-
-    m_filterBuff[0][z2][in] [LEFTCHANNEL]  = m_filterBuff[0][z1][in][LEFTCHANNEL];
-    m_filterBuff[0][z1][in] [LEFTCHANNEL]  = inSample[LEFTCHANNEL];
-    m_filterBuff[0][z2][out][LEFTCHANNEL]  = m_filterBuff[0][z1][out][LEFTCHANNEL];
-    m_filterBuff[0][z1][out][LEFTCHANNEL]  = outSample[LEFTCHANNEL];
-    iir_out[LEFTCHANNEL] = (int16_t)outSample[LEFTCHANNEL];
-
-
-    outSample[RIGHTCHANNEL] =  m_filter[0].a0 * inSample[RIGHTCHANNEL]
-                             + m_filter[0].a1 * m_filterBuff[0][z1][in] [RIGHTCHANNEL]
-                             + m_filter[0].a2 * m_filterBuff[0][z2][in] [RIGHTCHANNEL]
-                             - m_filter[0].b1 * m_filterBuff[0][z1][out][RIGHTCHANNEL]
-                             - m_filter[0].b2 * m_filterBuff[0][z2][out][RIGHTCHANNEL];
-
-    m_filterBuff[0][z2][in] [RIGHTCHANNEL] = m_filterBuff[0][z1][in][RIGHTCHANNEL];
-    m_filterBuff[0][z1][in] [RIGHTCHANNEL] = inSample[RIGHTCHANNEL];
-    m_filterBuff[0][z2][out][RIGHTCHANNEL] = m_filterBuff[0][z1][out][RIGHTCHANNEL];
-    m_filterBuff[0][z1][out][RIGHTCHANNEL] = outSample[RIGHTCHANNEL];
-    iir_out[RIGHTCHANNEL] = (int16_t) outSample[RIGHTCHANNEL];
-
-    return iir_out;
-}
-//---------------------------------------------------------------------------------------------------------------------
-int16_t* Audio::IIR_filterChain1(int16_t iir_in[2], bool clear){  // Infinite Impulse Response (IIR) filters
-
-    uint8_t z1 = 0, z2 = 1;
-    enum: uint8_t {in = 0, out = 1};
-    float inSample[2];
-    float outSample[2];
-    static int16_t iir_out[2];
-
-    if(clear){
-        memset(m_filterBuff, 0, sizeof(m_filterBuff));            // zero IIR filterbuffer
-        iir_out[0] = 0;
-        iir_out[1] = 0;
-        iir_in[0]  = 0;
-        iir_in[1]  = 0;
-    }
-
-    inSample[LEFTCHANNEL]  = (float)(iir_in[LEFTCHANNEL]);
-    inSample[RIGHTCHANNEL] = (float)(iir_in[RIGHTCHANNEL]);
-
-    outSample[LEFTCHANNEL] =   m_filter[1].a0  * inSample[LEFTCHANNEL]
-                             + m_filter[1].a1  * m_filterBuff[1][z1][in] [LEFTCHANNEL]
-                             + m_filter[1].a2  * m_filterBuff[1][z2][in] [LEFTCHANNEL]
-                             - m_filter[1].b1  * m_filterBuff[1][z1][out][LEFTCHANNEL]
-                             - m_filter[1].b2  * m_filterBuff[1][z2][out][LEFTCHANNEL];
-
-    m_filterBuff[1][z2][in] [LEFTCHANNEL]  = m_filterBuff[1][z1][in][LEFTCHANNEL];
-    m_filterBuff[1][z1][in] [LEFTCHANNEL]  = inSample[LEFTCHANNEL];
-    m_filterBuff[1][z2][out][LEFTCHANNEL]  = m_filterBuff[1][z1][out][LEFTCHANNEL];
-    m_filterBuff[1][z1][out][LEFTCHANNEL]  = outSample[LEFTCHANNEL];
-    iir_out[LEFTCHANNEL] = (int16_t)outSample[LEFTCHANNEL];
-
-
-    outSample[RIGHTCHANNEL] =  m_filter[1].a0 * inSample[RIGHTCHANNEL]
-                             + m_filter[1].a1 * m_filterBuff[1][z1][in] [RIGHTCHANNEL]
-                             + m_filter[1].a2 * m_filterBuff[1][z2][in] [RIGHTCHANNEL]
-                             - m_filter[1].b1 * m_filterBuff[1][z1][out][RIGHTCHANNEL]
-                             - m_filter[1].b2 * m_filterBuff[1][z2][out][RIGHTCHANNEL];
-
-    m_filterBuff[1][z2][in] [RIGHTCHANNEL] = m_filterBuff[1][z1][in][RIGHTCHANNEL];
-    m_filterBuff[1][z1][in] [RIGHTCHANNEL] = inSample[RIGHTCHANNEL];
-    m_filterBuff[1][z2][out][RIGHTCHANNEL] = m_filterBuff[1][z1][out][RIGHTCHANNEL];
-    m_filterBuff[1][z1][out][RIGHTCHANNEL] = outSample[RIGHTCHANNEL];
-    iir_out[RIGHTCHANNEL] = (int16_t) outSample[RIGHTCHANNEL];
-
-    return iir_out;
-}
-//---------------------------------------------------------------------------------------------------------------------
-int16_t* Audio::IIR_filterChain2(int16_t iir_in[2], bool clear){  // Infinite Impulse Response (IIR) filters
-
-    uint8_t z1 = 0, z2 = 1;
-    enum: uint8_t {in = 0, out = 1};
-    float inSample[2];
-    float outSample[2];
-    static int16_t iir_out[2];
-
-    if(clear){
-        memset(m_filterBuff, 0, sizeof(m_filterBuff));            // zero IIR filterbuffer
-        iir_out[0] = 0;
-        iir_out[1] = 0;
-        iir_in[0]  = 0;
-        iir_in[1]  = 0;
-    }
-
-    inSample[LEFTCHANNEL]  = (float)(iir_in[LEFTCHANNEL]);
-    inSample[RIGHTCHANNEL] = (float)(iir_in[RIGHTCHANNEL]);
-
-    outSample[LEFTCHANNEL] =   m_filter[2].a0  * inSample[LEFTCHANNEL]
-                             + m_filter[2].a1  * m_filterBuff[2][z1][in] [LEFTCHANNEL]
-                             + m_filter[2].a2  * m_filterBuff[2][z2][in] [LEFTCHANNEL]
-                             - m_filter[2].b1  * m_filterBuff[2][z1][out][LEFTCHANNEL]
-                             - m_filter[2].b2  * m_filterBuff[2][z2][out][LEFTCHANNEL];
-
-    m_filterBuff[2][z2][in] [LEFTCHANNEL]  = m_filterBuff[2][z1][in][LEFTCHANNEL];
-    m_filterBuff[2][z1][in] [LEFTCHANNEL]  = inSample[LEFTCHANNEL];
-    m_filterBuff[2][z2][out][LEFTCHANNEL]  = m_filterBuff[2][z1][out][LEFTCHANNEL];
-    m_filterBuff[2][z1][out][LEFTCHANNEL]  = outSample[LEFTCHANNEL];
-    iir_out[LEFTCHANNEL] = (int16_t)outSample[LEFTCHANNEL];
-
-
-    outSample[RIGHTCHANNEL] =  m_filter[2].a0 * inSample[RIGHTCHANNEL]
-                             + m_filter[2].a1 * m_filterBuff[2][z1][in] [RIGHTCHANNEL]
-                             + m_filter[2].a2 * m_filterBuff[2][z2][in] [RIGHTCHANNEL]
-                             - m_filter[2].b1 * m_filterBuff[2][z1][out][RIGHTCHANNEL]
-                             - m_filter[2].b2 * m_filterBuff[2][z2][out][RIGHTCHANNEL];
-
-    m_filterBuff[2][z2][in] [RIGHTCHANNEL] = m_filterBuff[2][z1][in][RIGHTCHANNEL];
-    m_filterBuff[2][z1][in] [RIGHTCHANNEL] = inSample[RIGHTCHANNEL];
-    m_filterBuff[2][z2][out][RIGHTCHANNEL] = m_filterBuff[2][z1][out][RIGHTCHANNEL];
-    m_filterBuff[2][z1][out][RIGHTCHANNEL] = outSample[RIGHTCHANNEL];
-    iir_out[RIGHTCHANNEL] = (int16_t) outSample[RIGHTCHANNEL];
-
-    return iir_out;
-}
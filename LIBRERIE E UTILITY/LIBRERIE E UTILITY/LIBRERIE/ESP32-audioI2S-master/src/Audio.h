@@ -19,6 +19,8 @@
 #include <WiFiClientSecure.h>
 
 #include <driver/i2s.h>
+#include "eq/audio_eq.h"
+#include "resample/audio_resample.h"
 
 #ifdef SDFATFS_USED
 #include <SdFat.h>  // https://github.com/greiman/SdFat
@@ -80,6 +82,7 @@ extern __attribute__((weak)) void audio_lasthost(const char*);
 extern __attribute__((weak)) void audio_eof_speech(const char*);
 extern __attribute__((weak)) void audio_eof_stream(const char*); // The webstream comes to an end
 extern __attribute__((weak)) void audio_process_extern(int16_t* buff, uint16_t len, bool *continueI2S); // record audiodata or send via BT
+extern __attribute__((weak)) void audio_next_mp3(const char*); // queued file has taken over (gapless), no eof_mp3
 
 //----------------------------------------------------------------------------------------------------------------------
 
@@ -161,8 +164,16 @@ public:
     bool connecttohost(const char* host, const char* user = "", const char* pwd = "");
     bool connecttospeech(const char* speech, const char* lang);
     bool connecttomarytts(const char* speech, const char* lang, const char* voice);
-    bool connecttoFS(fs::FS &fs, const char* path, uint32_t resumeFilePos = 0);
+    bool connecttoFS(fs::FS &fs, const char* path, uint32_t resumeFilePos = 0,
+                     uint32_t skipSamples = 0, uint32_t totalSamples = 0);
     bool connecttoSD(const char* path, uint32_t resumeFilePos = 0);
+    bool queueFS(fs::FS &fs, const char* path, uint32_t startPos = 0,
+                 uint32_t skipSamples = 0, uint32_t totalSamples = 0); // gapless, mp3 and wav only
+    void clearQueue();
+    bool isQueued() {return m_f_queueReq || (m_f_queued && !m_f_queueClear);}
+    uint32_t getGapSamples() {return m_gapSamples;}     // silence at the last gapless switch (estimated)
+    uint32_t getSwitchTime() {return m_switchMicros;}   // last output of old file -> first output of new one
+    uint32_t getSwitchCount() {return m_switchCount;}   // queued files that took over; unchanged = the queue failed
     bool setFileLoop(bool input);//TEST loop
     void setConnectionTimeout(uint16_t timeout_ms, uint16_t timeout_ms_ssl);
     bool setAudioPlayPosition(uint16_t sec);
@@ -195,12 +206,31 @@ public:
     uint32_t inBufferFilled(); // returns the number of stored bytes in the inputbuffer
     uint32_t inBufferFree();   // returns the number of free bytes in the inputbuffer
     void setTone(int8_t gainLowPass, int8_t gainBandPass, int8_t gainHighPass);
+    void setEQBand(uint8_t band, uint8_t type, uint16_t freq, int8_t gain, float q = 0.707f); // band 0...4, EQ_*
+    void setLoudness(uint8_t level); // listening level 0...100%, 100 = no loudness contour
+    void setOutputRate(uint32_t rate, uint8_t quality = RS_BALANCED); // fixed I2S clock, 0 = follow the source
+    uint32_t getOutputRate() {return m_outputRate;}
+    bool writePCM(const int16_t* buff, uint16_t frames, uint32_t sampleRate, uint8_t channels = 2); // not while playing
     void setI2SCommFMT_LSB(bool commFMT);
     int getCodec() {return m_codec;}
     const char *getCodecname() {return codecname[m_codec];}
     enum : int { CODEC_NONE, CODEC_WAV, CODEC_MP3, CODEC_AAC, CODEC_M4A, CODEC_FLAC, CODEC_OGG,
                  CODEC_OGG_FLAC, CODEC_OGG_OPUS};
 
+    typedef struct _streamHealth{
+        uint32_t fill;          // bytes in InBuff
+        uint32_t size;          // InBuff size
+        uint32_t arrivalBps;    // measured network rate (audio data only), bit/s
+        uint32_t codecBps;      // bitrate of the stream, bit/s
+        uint32_t jitterMs;      // longest gap between two arrivals (smoothed)
+        uint32_t startFill;     // bytes needed before playback starts / resumes
+        uint32_t underruns;     // InBuff ran empty while playing
+        uint32_t reconnects;    // soft reconnects after a stall or a closed connection
+        uint32_t resyncs;       // reconnects continued at the last byte received
+        bool     buffering;     // prebuffering or rebuffering, no output
+    } streamHealth_t;
+    streamHealth_t getStreamHealth();
+
 private:
 
     #ifndef ESP_ARDUINO_VERSION_VAL
@@ -215,7 +245,16 @@ private:
     void setDefaults(); // free buffers and set defaults
     void initInBuff();
     void processLocalFile();
+    void processQueue();
+    void prefetchNext();
+    bool switchToNext();
+    void trimSamples();
     void processWebStream();
+    void updateStreamHealth(int32_t availableBytes);
+    uint32_t streamFillBytes(uint32_t ms);
+    bool softReconnect();
+    int32_t resyncStream(uint8_t* buff, int32_t len);
+    void storeStreamTail(const uint8_t* buff, int32_t len);
     void processPlayListData();
     void processM3U8entries(uint8_t nrOfEntries = 0, uint32_t seqNr = 0, uint8_t pos = 0, uint16_t targetDuration = 0);
     bool STfromEXTINF(char* str);
@@ -236,9 +275,12 @@ private:
     bool setChannels(int channels);
     bool setBitrate(int br);
     bool playChunk();
-    bool playSample(int16_t sample[2]) ;
+    bool playBlock(uint16_t frames);
+    bool writeBlock(int16_t* buff, uint16_t frames);
+    size_t writeI2S(const uint8_t* data, size_t len);
+    bool flushI2S();
     void playI2Sremains();
-    int32_t Gain(int16_t s[2]);
+    void updateGain();
     bool fill_InputBuf();
     void showstreamtitle(const char* ml);
     bool parseContentType(const char* ct);
@@ -247,13 +289,9 @@ private:
     esp_err_t I2Sstart(uint8_t i2s_num);
     esp_err_t I2Sstop(uint8_t i2s_num);
     void urlencode(char* buff, uint16_t buffLen, bool spacesOnly = false);
-    int16_t* IIR_filterChain0(int16_t iir_in[2], bool clear = false);
-    int16_t* IIR_filterChain1(int16_t* iir_in, bool clear = false);
-    int16_t* IIR_filterChain2(int16_t* iir_in, bool clear = false);
     inline void setDatamode(uint8_t dm){m_datamode=dm;}
     inline uint8_t getDatamode(){return m_datamode;}
     inline uint32_t streamavail(){ return _client ? _client->available() : 0;}
-    void IIR_calculateCoefficients(int8_t G1, int8_t G2, int8_t G3);
 
     // implement several function with respect to the index of string
     void trim(char *s) {
@@ -392,20 +430,21 @@ private:
                  M4A_ILST = 7, M4A_MP4A = 8, M4A_AMRDY = 99, M4A_OKAY = 100};
     enum : int { OGG_BEGIN = 0, OGG_MAGIC = 1, OGG_HEADER = 2, OGG_FIRST = 3, OGG_AMRDY = 99, OGG_OKAY = 100};
     typedef enum { LEFTCHANNEL=0, RIGHTCHANNEL=1 } SampleIndex;
-    typedef enum { LOWSHELF = 0, PEAKEQ = 1, HIFGSHELF =2 } FilterType;
 
     const uint8_t volumetable[22]={   0,  1,  2,  3,  4 , 6 , 8, 10, 12, 14, 17,
                                      20, 23, 27, 30 ,34, 38, 43 ,48, 52, 58, 64}; //22 elements
 
-    typedef struct _filter{
-        float a0;
-        float a1;
-        float a2;
-        float b1;
-        float b2;
-    } filter_t;
+    typedef struct _queue{
+        fs::FS*  fs;
+        char     path[256];
+        uint32_t startPos;      // first frame, the header is not parsed (mp3 only)
+        uint32_t skipSamples;   // encoder delay + decoder delay
+        uint32_t totalSamples;  // valid samples, 0: play up to eof
+        uint8_t  codec;
+    } queue_t;
 
     File              audiofile;    // @suppress("Abstract class cannot be instantiated")
+    File              nextfile;     // @suppress("Abstract class cannot be instantiated")
     WiFiClient        client;       // @suppress("Abstract class cannot be instantiated")
     WiFiClientSecure  clientsecure; // @suppress("Abstract class cannot be instantiated")
     WiFiClient*       _client = nullptr;
@@ -416,12 +455,15 @@ private:
     const size_t    m_frameSizeMP3  = 1600;
     const size_t    m_frameSizeAAC  = 1600;
     const size_t    m_frameSizeFLAC = 4096 * 4;
+    const size_t    m_prefetchSize  = 65536;        // first bytes of the queued file (PSRAM)
+    const size_t    m_prefetchChunk = 4096;         // read per loop() while the current file plays out
 
     char            chbuf[512 + 128];               // must be greater than m_lastHost #254
     char            m_lastHost[512];                // Store the last URL to a webstream
     char*           m_playlistBuff = NULL;          // stores playlistdata
     const uint16_t  m_plsBuffEntryLen = 256;        // length of each entry in playlistBuff
-    filter_t        m_filter[3];                    // digital filters
+    AudioEQ         m_eq;                           // tone, loudness, volume (see eq/audio_eq.h)
+    AudioResampler  m_src;                          // source rate -> m_outputRate (see resample/audio_resample.h)
     int             m_LFcount = 0;                  // Detection of end of header
     uint32_t        m_sampleRate=16000;
     uint32_t        m_bitRate=0;                    // current bitrate given fom decoder
@@ -439,6 +481,11 @@ private:
     uint8_t         m_codec = CODEC_NONE;           //
     uint8_t         m_filterType[2];                // lowpass, highpass
     int16_t         m_outBuff[2048*2];              // Interleaved L/R
+    alignas(4) int16_t m_i2sBlock[EQ_BLOCK*2];      // playChunk() -> AudioEQ -> i2s_write(), L/R, then packed 32 bit
+    alignas(4) int16_t m_srcBlock[EQ_BLOCK*2];      // m_i2sBlock resampled to m_outputRate
+    uint32_t        m_i2sPending[EQ_BLOCK];         // packed frames i2s_write() didn't take, sent before anything else
+    uint16_t        m_i2sPendPos = 0;               // in bytes
+    uint16_t        m_i2sPendLen = 0;               // in bytes
     int16_t         m_validSamples = 0;
     int16_t         m_curSample = 0;
     uint16_t        m_datamode = 0;                 // Statemaschine
@@ -485,13 +532,57 @@ private:
     float           m_audioCurrentTime = 0;
     uint32_t        m_audioDataStart = 0;           // in bytes
     size_t          m_audioDataSize = 0;            //
-    float           m_filterBuff[3][2][2][2];       // IIR filters memory for Audio DSP
-    size_t          m_i2s_bytesWritten = 0;         // set in i2s_write() but not used
+    size_t          m_i2s_bytesWritten = 0;         // by the last writeI2S()
     size_t          m_file_size = 0;                // size of the file
     uint16_t        m_filterFrequency[2];
     int8_t          m_gain0 = 0;                    // cut or boost filters (EQ)
     int8_t          m_gain1 = 0;
     int8_t          m_gain2 = 0;
+    uint32_t        m_i2sSampleRate = 16000;        // clock actually set in the I2S driver
+    uint32_t        m_outputRate = 0;               // fixed I2S clock (setOutputRate()), 0: follows the source
+    bool            m_f_resample = false;           // m_i2sBlock goes through m_src
+    queue_t         m_queueReq;                     // written by queueFS(), taken over by loop()
+    queue_t         m_queueNext;                    // owned by the audio task
+    portMUX_TYPE    m_queueMux = portMUX_INITIALIZER_UNLOCKED;
+    volatile bool   m_f_queueReq = false;           // new entry in m_queueReq
+    volatile bool   m_f_queueClear = false;         // drop the queued file
+    bool            m_f_queued = false;             // m_queueNext is valid
+    bool            m_f_nextOpen = false;           // nextfile opened, prefetch running
+    bool            m_f_trackDone = false;          // m_totalSamples reached, the rest is padding
+    bool            m_f_gapMeasure = false;         // first output after a switch not yet seen
+    uint8_t*        m_prefetchBuff = NULL;
+    size_t          m_prefetchLen = 0;
+    uint32_t        m_trackStartPos = 0;            // first frame of the current file (loop)
+    uint32_t        m_skipSamples = 0;              // samples to drop at the start (gapless)
+    uint32_t        m_skipLeft = 0;
+    uint32_t        m_totalSamples = 0;             // samples to play, 0 = up to eof
+    uint32_t        m_trackSamples = 0;             // samples played so far
+    uint32_t        m_lastOutTime = 0;              // micros() of the last i2s output
+    uint32_t        m_switchMicros = 0;
+    uint32_t        m_switchCount = 0;
+    uint32_t        m_gapSamples = 0;
+    static const uint16_t m_streamStallMs = 3000;   // no data for so long -> soft reconnect
+    static const uint8_t  m_tailSigLen = 32;        // last bytes received, searched again after a reconnect
+    bool            m_f_reconnect = false;          // connecttohost() without setDefaults(), InBuff is kept
+    bool            m_f_resync = false;             // looking for m_tailSig in the new connection
+    bool            m_f_buffering = true;
+    uint8_t         m_tailSig[m_tailSigLen];
+    uint8_t         m_tailLen = 0;
+    uint8_t         m_resyncCarry[m_tailSigLen];    // end of the previous read, a match can span two reads
+    uint8_t         m_resyncCarryLen = 0;
+    uint8_t         m_reconnectFails = 0;
+    uint32_t        m_resyncScanned = 0;
+    uint32_t        m_resyncStart = 0;              // millis() of the first byte after the reconnect
+    uint32_t        m_lastArrival = 0;              // millis() of the last read with data
+    uint32_t        m_winStart = 0;                 // 1s measuring window
+    uint32_t        m_winBytes = 0;
+    uint32_t        m_winMaxGap = 0;
+    uint32_t        m_arrivalBps = 0;
+    uint32_t        m_jitterMs = 0;
+    uint32_t        m_startFill = 0;
+    uint32_t        m_underruns = 0;
+    uint32_t        m_reconnects = 0;
+    uint32_t        m_resyncs = 0;
 };
 
 //----------------------------------------------------------------------------------------------------------------------
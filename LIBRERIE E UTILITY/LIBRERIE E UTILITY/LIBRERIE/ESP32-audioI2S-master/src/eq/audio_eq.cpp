@@ -0,0 +1,302 @@
+/*
+ * audio_eq.cpp
+ *
+ * Block equalizer, replaces the float IIR_filterChain0/1/2 and Gain() of Audio.cpp
+ * see audio_eq.h
+ *
+ */
+#include "audio_eq.h"
+#include <math.h>
+
+#define EQ_OUT_SCALE    (1.0f / 128)        // volume 0...64, 0.5: -6dB reserve
+#define EQ_DITHER_SCALE (1.0f / 65536)      // 16 bit random difference -> +-1 LSB
+
+//----------------------------------------------------------------------------------------------------------------------
+AudioEQ::AudioEQ(){
+    for(uint8_t i = 0; i < EQ_STAGES; i++){
+        m_band[i].type = EQ_OFF;
+        m_band[i].freq = 1000;
+        m_band[i].gain = 0;
+        m_band[i].q    = 0.707f;
+    }
+    m_gain[0] = m_gain[1] = 64 * EQ_OUT_SCALE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void AudioEQ::setBand(uint8_t band, uint8_t type, uint16_t freq, int8_t gain, float q){
+    // gain -40 ... +12 dB
+    if(band >= EQ_BANDS) return;
+    if(type > EQ_HIGHPASS) type = EQ_OFF;
+    if(gain < -40) gain = -40;
+    if(gain >  12) gain =  12;
+    if(q < 0.1f) q = 0.1f;
+    if(q > 20.0f) q = 20.0f;
+    m_band[band].type = type;
+    m_band[band].freq = freq;
+    m_band[band].gain = gain;
+    m_band[band].q    = q;
+    m_f_update = true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void AudioEQ::setLoudness(uint8_t level){
+    // Equal loudness (Fletcher-Munson): the ear loses bass and, less, treble when the level drops.
+    // 100% is flat, below +1dB bass every 10%, treble half of it.
+    if(level > 100) level = 100;
+    if(level == m_loudness) return;
+    m_loudness = level;
+    m_f_update = true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void AudioEQ::setSampleRate(uint32_t sampleRate){
+    if(sampleRate < 1000 || sampleRate == m_sampleRate) return;
+    m_sampleRate = sampleRate;
+    m_f_update = true;
+    m_f_reset  = true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void AudioEQ::setGain(uint8_t left, uint8_t right){
+    if(left  > 64) left  = 64;
+    if(right > 64) right = 64;
+    if(left == m_vol[0] && right == m_vol[1]) return;
+    m_vol[0] = left;
+    m_vol[1] = right;
+    m_f_update = true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void AudioEQ::reset(){
+    m_f_reset = true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool AudioEQ::design(const band_t& b, coeff_t& c){
+    // https://www.earlevel.com/main/2012/11/26/biquad-c-source-code/
+    // shelves with the fixed Q of the former IIR_calculateCoefficients(), false: stage not needed
+
+    if(b.type == EQ_OFF) return false;
+    if(b.gain == 0 && (b.type == EQ_LOWSHELF || b.type == EQ_PEAK || b.type == EQ_HIGHSHELF)) return false;
+
+    float fc = (float)b.freq / (float)m_sampleRate;
+    if(fc <= 0.0f) return false;
+    if(fc > 0.45f) {
+        if(b.type != EQ_HIGHSHELF && b.type != EQ_PEAK) return false;
+        fc = 0.45f;
+    }
+    float K  = tanf((float)PI * fc);
+    float V  = powf(10, fabsf((float)b.gain) / 20.0f);
+    float Q  = b.q;
+    float s2 = sqrtf(2), s2V = sqrtf(2 * V);
+    float norm;
+
+    switch(b.type){
+        case EQ_LOWSHELF:
+            if(b.gain > 0) {
+                norm = 1 / (1 + s2 * K + K * K);
+                c.a0 = (1 + s2V * K + V * K * K) * norm;
+                c.a1 = 2 * (V * K * K - 1) * norm;
+                c.a2 = (1 - s2V * K + V * K * K) * norm;
+                c.b1 = 2 * (K * K - 1) * norm;
+                c.b2 = (1 - s2 * K + K * K) * norm;
+            }
+            else {
+                norm = 1 / (1 + s2V * K + V * K * K);
+                c.a0 = (1 + s2 * K + K * K) * norm;
+                c.a1 = 2 * (K * K - 1) * norm;
+                c.a2 = (1 - s2 * K + K * K) * norm;
+                c.b1 = 2 * (V * K * K - 1) * norm;
+                c.b2 = (1 - s2V * K + V * K * K) * norm;
+            }
+            break;
+        case EQ_PEAK:
+            if(b.gain > 0) {
+                norm = 1 / (1 + 1/Q * K + K * K);
+                c.a0 = (1 + V/Q * K + K * K) * norm;
+                c.a1 = 2 * (K * K - 1) * norm;
+                c.a2 = (1 - V/Q * K + K * K) * norm;
+                c.b1 = c.a1;
+                c.b2 = (1 - 1/Q * K + K * K) * norm;
+            }
+            else {
+                norm = 1 / (1 + V/Q * K + K * K);
+                c.a0 = (1 + 1/Q * K + K * K) * norm;
+                c.a1 = 2 * (K * K - 1) * norm;
+                c.a2 = (1 - 1/Q * K + K * K) * norm;
+                c.b1 = c.a1;
+                c.b2 = (1 - V/Q * K + K * K) * norm;
+            }
+            break;
+        case EQ_HIGHSHELF:
+            if(b.gain > 0) {
+                norm = 1 / (1 + s2 * K + K * K);
+                c.a0 = (V + s2V * K + K * K) * norm;
+                c.a1 = 2 * (K * K - V) * norm;
+                c.a2 = (V - s2V * K + K * K) * norm;
+                c.b1 = 2 * (K * K - 1) * norm;
+                c.b2 = (1 - s2 * K + K * K) * norm;
+            }
+            else {
+                norm = 1 / (V + s2V * K + K * K);
+                c.a0 = (1 + s2 * K + K * K) * norm;
+                c.a1 = 2 * (K * K - 1) * norm;
+                c.a2 = (1 - s2 * K + K * K) * norm;
+                c.b1 = 2 * (K * K - V) * norm;
+                c.b2 = (V - s2V * K + K * K) * norm;
+            }
+            break;
+        case EQ_LOWPASS:
+            norm = 1 / (1 + K / Q + K * K);
+            c.a0 = K * K * norm;
+            c.a1 = 2 * c.a0;
+            c.a2 = c.a0;
+            c.b1 = 2 * (K * K - 1) * norm;
+            c.b2 = (1 - K / Q + K * K) * norm;
+            break;
+        case EQ_HIGHPASS:
+            norm = 1 / (1 + K / Q + K * K);
+            c.a0 = norm;
+            c.a1 = -2 * c.a0;
+            c.a2 = c.a0;
+            c.b1 = 2 * (K * K - 1) * norm;
+            c.b2 = (1 - K / Q + K * K) * norm;
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+float AudioEQ::magnitude(const coeff_t* c, uint8_t n, float freq){
+    // |H(e^jw)| of the cascade
+    float w = 2 * (float)PI * freq / (float)m_sampleRate;
+    float c1 = cosf(w), s1 = sinf(w), c2 = cosf(2 * w), s2 = sinf(2 * w);
+    float m = 1;
+    for(uint8_t i = 0; i < n; i++){
+        float nr = c[i].a0 + c[i].a1 * c1 + c[i].a2 * c2, ni = -(c[i].a1 * s1 + c[i].a2 * s2);
+        float dr = 1       + c[i].b1 * c1 + c[i].b2 * c2, di = -(c[i].b1 * s1 + c[i].b2 * s2);
+        m *= sqrtf((nr * nr + ni * ni) / (dr * dr + di * di));
+    }
+    return m;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void AudioEQ::update(){
+    // runs in process(): parameters -> active stages, coefficients, headroom and final gain
+
+    m_f_update = false;     // first: a setter running meanwhile raises it again
+
+    // loudness contour in the two stages after the bands
+    int8_t bass = (100 - m_loudness + 5) / 10;
+    m_band[EQ_BANDS].type     = EQ_LOWSHELF;
+    m_band[EQ_BANDS].freq     = 100;
+    m_band[EQ_BANDS].gain     = bass;
+    m_band[EQ_BANDS + 1].type = EQ_HIGHSHELF;
+    m_band[EQ_BANDS + 1].freq = 10000;
+    m_band[EQ_BANDS + 1].gain = bass / 2;
+
+    coeff_t  fc[EQ_STAGES];
+    uint8_t  n = 0;
+    for(uint8_t i = 0; i < EQ_STAGES; i++){
+        band_t b = m_band[i];
+        if(!design(b, fc[n])) continue;
+        m_coeff[i] = fc[n];
+        m_stage[n++] = i;
+    }
+    m_numStages = n;
+
+    // The output keeps -6dB in reserve for boosts (as the former ">> 1" in playSample()),
+    // if the cascade peaks higher the whole signal is pulled back instead of clipping.
+    float peak = 1;
+    for(float f = 20; f < 0.45f * m_sampleRate; f *= 1.03f){    // ~1/24 octave, only on changes
+        float m = magnitude(fc, n, f);
+        if(m > peak) peak = m;
+    }
+    m_headroom = (peak > 2) ? 2 / peak : 1;
+    m_gain[0] = m_vol[0] * m_headroom * EQ_OUT_SCALE;
+    m_gain[1] = m_vol[1] * m_headroom * EQ_OUT_SCALE;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void AudioEQ::filter(uint16_t frames){
+    // direct form I over the whole block, two stages per pass and left/right in the same loop: four
+    // independent recursions keep the FPU pipeline busy, coefficients and state stay in registers
+    float* l = m_work[0];
+    float* r = m_work[1];
+    uint8_t s = 0;
+    for(; s + 1 < m_numStages; s += 2){
+        const coeff_t c = m_coeff[m_stage[s]], d = m_coeff[m_stage[s + 1]];
+        float* zl = m_z[m_stage[s]][0];
+        float* zr = m_z[m_stage[s]][1];
+        float* wl = m_z[m_stage[s + 1]][0];
+        float* wr = m_z[m_stage[s + 1]][1];
+        float lx1 = zl[0], lx2 = zl[1], ly1 = zl[2], ly2 = zl[3], lu1 = wl[2], lu2 = wl[3];
+        float rx1 = zr[0], rx2 = zr[1], ry1 = zr[2], ry2 = zr[3], ru1 = wr[2], ru2 = wr[3];
+        for(uint16_t i = 0; i < frames; i++){
+            // the first stage output is the second stage input: its x1/x2 are y1/y2 of the first
+            float yl = c.a0 * l[i] + c.a1 * lx1 + c.a2 * lx2 - c.b1 * ly1 - c.b2 * ly2;
+            float yr = c.a0 * r[i] + c.a1 * rx1 + c.a2 * rx2 - c.b1 * ry1 - c.b2 * ry2;
+            float ul = d.a0 * yl + d.a1 * ly1 + d.a2 * ly2 - d.b1 * lu1 - d.b2 * lu2;
+            float ur = d.a0 * yr + d.a1 * ry1 + d.a2 * ry2 - d.b1 * ru1 - d.b2 * ru2;
+            lx2 = lx1; lx1 = l[i]; ly2 = ly1; ly1 = yl; lu2 = lu1; lu1 = ul; l[i] = ul;
+            rx2 = rx1; rx1 = r[i]; ry2 = ry1; ry1 = yr; ru2 = ru1; ru1 = ur; r[i] = ur;
+        }
+        zl[0] = lx1; zl[1] = lx2; zl[2] = ly1; zl[3] = ly2; wl[0] = ly1; wl[1] = ly2; wl[2] = lu1; wl[3] = lu2;
+        zr[0] = rx1; zr[1] = rx2; zr[2] = ry1; zr[3] = ry2; wr[0] = ry1; wr[1] = ry2; wr[2] = ru1; wr[3] = ru2;
+    }
+    if(s < m_numStages){
+        const coeff_t c = m_coeff[m_stage[s]];
+        float* zl = m_z[m_stage[s]][0];
+        float* zr = m_z[m_stage[s]][1];
+        float lx1 = zl[0], lx2 = zl[1], ly1 = zl[2], ly2 = zl[3];
+        float rx1 = zr[0], rx2 = zr[1], ry1 = zr[2], ry2 = zr[3];
+        for(uint16_t i = 0; i < frames; i++){
+            float yl = c.a0 * l[i] + c.a1 * lx1 + c.a2 * lx2 - c.b1 * ly1 - c.b2 * ly2;
+            float yr = c.a0 * r[i] + c.a1 * rx1 + c.a2 * rx2 - c.b1 * ry1 - c.b2 * ry2;
+            lx2 = lx1; lx1 = l[i]; ly2 = ly1; ly1 = yl; l[i] = yl;
+            rx2 = rx1; rx1 = r[i]; ry2 = ry1; ry1 = yr; r[i] = yr;
+        }
+        zl[0] = lx1; zl[1] = lx2; zl[2] = ly1; zl[3] = ly2;
+        zr[0] = rx1; zr[1] = rx2; zr[2] = ry1; zr[3] = ry2;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+void AudioEQ::process(int16_t* buff, uint16_t frames){
+
+    if(m_f_update) update();
+    if(m_f_reset) {
+        m_f_reset = false;
+        memset(m_z, 0, sizeof(m_z));
+    }
+
+    while(frames) {
+        uint16_t n = (frames < EQ_BLOCK) ? frames : EQ_BLOCK;
+        for(uint16_t i = 0; i < n; i++){
+            m_work[0][i] = buff[2 * i];
+            m_work[1][i] = buff[2 * i + 1];
+        }
+        if(m_numStages) filter(n);
+        // volume, balance and headroom in one multiply, TPDF dither (+-1 LSB) as the difference of two successive
+        // draws (one LCG step per sample, high bits only), digital silence and a muted channel (volume 0,
+        // balance all the way) stay silent
+        for(uint8_t ch = 0; ch < 2; ch++){
+            const float g = m_gain[ch];
+            const float* w = m_work[ch];
+            int16_t* out = buff + ch;
+            if(g == 0.0f) {
+                for(uint16_t i = 0; i < n; i++) out[2 * i] = 0;
+                continue;
+            }
+            uint32_t seed = m_seed;
+            int32_t  prev = m_rnd[ch];
+            for(uint16_t i = 0; i < n; i++){
+                float v = w[i];
+                if(v == 0.0f) { out[2 * i] = 0; continue; }
+                seed = seed * 1664525 + 1013904223;
+                int32_t r = (int32_t)(seed >> 16);
+                float o = v * g + (r - prev) * EQ_DITHER_SCALE;
+                prev = r;
+                if(o >  32767.0f) o =  32767.0f;
+                if(o < -32768.0f) o = -32768.0f;
+                out[2 * i] = (int32_t)(o + 32768.5f) - 32768;     // round, the offset keeps it positive
+            }
+            m_seed = seed;
+            m_rnd[ch] = prev;
+        }
+        buff   += 2 * n;
+        frames -= n;
+    }
+}
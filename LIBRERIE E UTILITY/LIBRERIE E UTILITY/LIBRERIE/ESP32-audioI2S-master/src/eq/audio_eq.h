@@ -0,0 +1,75 @@
+/*
+ * audio_eq.h
+ *
+ * Block equalizer for the I2S output path
+ *
+ *  - up to EQ_BANDS parametric biquads (shelves, peak, low/high pass)
+ *  - loudness contour (bass and treble shelves) following the listening level
+ *  - volume/balance gain with TPDF dither down to 16 bit
+ *
+ * Coefficients are designed (earlevel.com biquad formulas) only when a parameter changes.
+ * The signal runs in float through the single precision FPU of the S3 (no 64 bit multiplies),
+ * direct form I over blocks of EQ_BLOCK frames, two stages and both channels per pass.
+ * The 24 bit mantissa keeps the rounding noise of low shelves well below the 16 bit dither.
+ * Setters may be called from any task: they only store parameters and raise m_f_update,
+ * the coefficients are rebuilt by process() in the audio task.
+ *
+ */
+#pragma once
+#pragma GCC optimize ("Ofast")
+
+#include "Arduino.h"
+
+#define EQ_BANDS      5                 // parametric bands, setTone() uses 0...2
+#define EQ_STAGES     (EQ_BANDS + 2)    // + loudness low and high shelf
+#define EQ_BLOCK      128               // frames per filter pass
+
+enum : uint8_t {EQ_OFF = 0, EQ_LOWSHELF = 1, EQ_PEAK = 2, EQ_HIGHSHELF = 3, EQ_LOWPASS = 4, EQ_HIGHPASS = 5};
+
+class AudioEQ {
+
+public:
+    AudioEQ();
+    void     setBand(uint8_t band, uint8_t type, uint16_t freq, int8_t gain, float q = 0.707f);
+    void     setLoudness(uint8_t level);            // listening level 0...100%, 100: flat
+    void     setSampleRate(uint32_t sampleRate);
+    void     setGain(uint8_t left, uint8_t right);  // 0...64, as Audio::m_vol minus balance
+    void     reset();                               // clear the filter memory (next process())
+    void     process(int16_t* buff, uint16_t frames); // interleaved L/R, in place
+    uint8_t  getStages()   {return m_numStages;}    // biquads actually running
+    float    getHeadroom() {return m_headroom;}
+
+private:
+    typedef struct _band{
+        uint8_t  type;
+        uint16_t freq;
+        int8_t   gain;      // dB
+        float    q;
+    } band_t;
+
+    typedef struct _coeff{
+        float    a0, a1, a2;    // zeros
+        float    b1, b2;        // poles
+    } coeff_t;
+
+    void     update();
+    bool     design(const band_t& b, coeff_t& c);
+    float    magnitude(const coeff_t* c, uint8_t n, float freq);
+    void     filter(uint16_t frames);
+
+    band_t        m_band[EQ_STAGES];
+    coeff_t       m_coeff[EQ_STAGES];
+    float         m_z[EQ_STAGES][2][4];     // x1, x2, y1, y2 per channel
+    float         m_work[2][EQ_BLOCK];
+    uint8_t       m_stage[EQ_STAGES];       // active stages in processing order
+    uint8_t       m_numStages = 0;
+    uint32_t      m_sampleRate = 44100;
+    uint8_t       m_loudness = 100;
+    uint8_t       m_vol[2] = {64, 64};
+    float         m_gain[2];                // volume / 64 * headroom * 0.5
+    float         m_headroom = 1;
+    uint32_t      m_seed = 22222;
+    int32_t       m_rnd[2] = {0, 0};       // last dither draw per channel
+    volatile bool m_f_update = true;
+    volatile bool m_f_reset = true;
+};
@@ -0,0 +1,196 @@
+/*
+ * audio_resample.cpp
+ *
+ * Fixed-point polyphase sample rate converter, see audio_resample.h
+ *
+ */
+#include "audio_resample.h"
+#include <math.h>
+
+#define RS_PHASE_BITS   8               // log2(RS_MAX_PHASES), interpolated mode
+
+static const struct {
+    uint8_t taps;                       // per phase, upsampling
+    float   beta;                       // Kaiser window, stopband about 8.7 * beta dB ... limited by the taps
+    float   cutoff;                     // -6dB point, part of the lower Nyquist frequency
+} rsPreset[3] = {
+    {16,  6.0f, 0.88f},                 // RS_FAST      ~ 70dB image rejection, flat to 0.3 * the lower rate
+    {32,  8.0f, 0.96f},                 // RS_BALANCED  ~ 82dB at 0.4 * the lower rate, 87dB at 1 kHz
+    {64, 10.0f, 0.96f},                 // RS_BEST      16 bit limited (~ 92dB), flat to 0.4 * the lower rate
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+static float besselI0(float x){
+    // power series, converges for the beta range used here in < 25 terms
+    float sum = 1, term = 1, q = x * x / 4;
+    for(uint8_t k = 1; k < 50; k++){
+        term *= q / (k * k);
+        sum += term;
+        if(term < sum * 1e-9f) break;
+    }
+    return sum;
+}
+//----------------------------------------------------------------------------------------------------------------------
+static uint32_t gcd(uint32_t a, uint32_t b){
+    while(b){uint32_t t = a % b; a = b; b = t;}
+    return a;
+}
+//----------------------------------------------------------------------------------------------------------------------
+AudioResampler::AudioResampler(){
+    reset();
+}
+AudioResampler::~AudioResampler(){
+    if(m_coef) free(m_coef);
+}
+//----------------------------------------------------------------------------------------------------------------------
+void AudioResampler::setQuality(uint8_t quality){
+    if(quality > RS_BEST) quality = RS_BEST;
+    m_quality = quality;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void AudioResampler::reset(){
+    // silence under the first half of the kernel: output frame 0 is centered on input frame 0
+    uint16_t pre = m_taps ? m_taps / 2 - 1 : 0;
+    memset(m_hist, 0, pre * 2 * sizeof(int16_t));
+    m_histLen = pre;
+    m_pos = 0;
+    m_phase = 0;
+}
+//----------------------------------------------------------------------------------------------------------------------
+bool AudioResampler::setRates(uint32_t inRate, uint32_t outRate){
+    if(!inRate || !outRate || inRate > outRate * RS_MAX_RATIO) return false;
+    if(inRate == m_inRate && outRate == m_outRate && m_quality == m_designQuality && m_coef) return true;
+
+    uint32_t g = gcd(inRate, outRate);
+    uint32_t L = outRate / g;           // output phases per input period
+    uint32_t M = inRate / g;
+    m_f_exact = (L <= RS_MAX_PHASES);
+    if(m_f_exact){
+        m_phases   = L;
+        m_stepInt  = M / L;
+        m_stepFrac = M % L;
+    }
+    else{
+        m_phases   = RS_MAX_PHASES;
+        m_stepInt  = inRate / outRate;
+        m_stepFrac = ((uint64_t)(inRate % outRate) << 32) / outRate;
+    }
+    float ratio = (inRate > outRate) ? (float)inRate / outRate : 1.0f;
+    uint16_t taps = (uint16_t)ceilf(rsPreset[m_quality].taps * ratio);
+    taps = (taps + 1) & ~1;
+    m_taps = (taps > RS_MAX_TAPS) ? RS_MAX_TAPS : taps;
+
+    size_t size = (size_t)(m_phases + 1) * m_taps * sizeof(int32_t);
+    if(size > m_coefSize){
+        if(m_coef) free(m_coef);
+        // exact ratios have few phases and stay in internal RAM, the 256 interpolated phases (33 KB and more)
+        // go to PSRAM first, where there is one, and leave the internal heap to WiFi/TLS
+        if(m_f_exact) m_coef = (int32_t*)heap_caps_malloc_prefer(size, 2, MALLOC_CAP_DEFAULT|MALLOC_CAP_INTERNAL, MALLOC_CAP_DEFAULT|MALLOC_CAP_SPIRAM);
+        else          m_coef = (int32_t*)heap_caps_malloc_prefer(size, 2, MALLOC_CAP_DEFAULT|MALLOC_CAP_SPIRAM, MALLOC_CAP_DEFAULT|MALLOC_CAP_INTERNAL);
+        m_coefSize = m_coef ? size : 0;
+        if(!m_coef){
+            log_e("resampler: no memory for %u bytes", size);
+            m_inRate = m_outRate = 0;
+            return false;
+        }
+    }
+    m_inRate = inRate;
+    m_outRate = outRate;
+    m_designQuality = m_quality;
+    design();
+    reset();
+    return true;
+}
+//----------------------------------------------------------------------------------------------------------------------
+void AudioResampler::design(){
+    // row p, tap k: h = 2fc * sinc(2fc * u) * kaiser(u / (taps / 2)), u = taps/2 - 1 + p/phases - k
+    // fc in cycles per input frame: input Nyquist when upsampling, output Nyquist when downsampling
+    float fc   = rsPreset[m_designQuality].cutoff * ((m_inRate > m_outRate) ? 0.5f * m_outRate / m_inRate : 0.5f);
+    float beta = rsPreset[m_designQuality].beta;
+    float half = m_taps / 2;
+    float i0b  = besselI0(beta);
+    float one  = 1L << RS_COEF_Q;
+    float h[RS_MAX_TAPS];
+
+    for(uint16_t p = 0; p <= m_phases; p++){
+        float sum = 0;
+        for(uint8_t k = 0; k < m_taps; k++){
+            float u = half - 1 + (float)p / m_phases - k, x = u / half;
+            float w = (fabsf(x) <= 1) ? besselI0(beta * sqrtf(1 - x * x)) / i0b : 0;
+            float s = (fabsf(u) < 1e-6f) ? 1 : sinf(PI * 2 * fc * u) / (PI * 2 * fc * u);
+            h[k] = s * w;
+            sum += h[k];
+        }
+        // unity DC gain per row, rounding residue into the largest tap
+        int32_t* row = m_coef + p * m_taps;
+        int64_t total = 0;
+        uint8_t big = 0;
+        for(uint8_t k = 0; k < m_taps; k++){
+            row[k] = lrintf(h[k] / sum * one);
+            total += row[k];
+            if(abs(row[k]) > abs(row[big])) big = k;
+        }
+        row[big] += (int64_t)one - total;
+    }
+}
+//----------------------------------------------------------------------------------------------------------------------
+uint16_t AudioResampler::process(const int16_t* in, uint16_t inFrames, uint16_t* used, int16_t* out, uint16_t outMax){
+    // in: inFrames L/R frames at getInRate(), out: up to outMax frames at getOutRate()
+    // stops when out is full or the input is used up, the rest of the kernel stays in m_hist
+    uint16_t produced = 0, taken = 0;
+
+    while(produced < outMax){
+        if(m_pos + m_taps > m_histLen){                    // kernel runs past the history: refill
+            if(taken == inFrames) break;
+            uint16_t drop = (m_pos < m_histLen) ? m_pos : m_histLen;
+            if(drop){
+                memmove(m_hist, m_hist + 2 * drop, (m_histLen - drop) * 2 * sizeof(int16_t));
+                m_histLen -= drop;
+                m_pos -= drop;
+            }
+            uint16_t n = RS_MAX_TAPS + RS_IN_BLOCK - m_histLen;
+            if(n > inFrames - taken) n = inFrames - taken;
+            memcpy(m_hist + 2 * m_histLen, in + 2 * taken, n * 2 * sizeof(int16_t));
+            m_histLen += n;
+            taken += n;
+            continue;
+        }
+
+        const int32_t* h;
+        if(m_f_exact){
+            h = m_coef + m_phase * m_taps;
+        }
+        else{                                               // between two of the RS_MAX_PHASES rows
+            const int32_t* r0 = m_coef + (m_phase >> (32 - RS_PHASE_BITS)) * m_taps;
+            const int32_t* r1 = r0 + m_taps;
+            int32_t f = (m_phase >> (32 - RS_PHASE_BITS - 16)) & 0xFFFF;
+            for(uint8_t k = 0; k < m_taps; k++) m_row[k] = r0[k] + (int32_t)(((int64_t)(r1[k] - r0[k]) * f + 0x8000) >> 16);
+            h = m_row;
+        }
+
+        const int16_t* x = m_hist + 2 * m_pos;
+        int64_t accL = 1LL << (RS_COEF_Q - 1), accR = accL;
+        for(uint8_t k = 0; k < m_taps; k++){
+            accL += (int64_t)h[k] * x[2 * k];
+            accR += (int64_t)h[k] * x[2 * k + 1];
+        }
+        accL >>= RS_COEF_Q;
+        accR >>= RS_COEF_Q;
+        out[2 * produced]     = (accL > 32767) ? 32767 : (accL < -32768) ? -32768 : (int16_t)accL;
+        out[2 * produced + 1] = (accR > 32767) ? 32767 : (accR < -32768) ? -32768 : (int16_t)accR;
+        produced++;
+
+        m_pos += m_stepInt;
+        if(m_f_exact){
+            m_phase += m_stepFrac;
+            if(m_phase >= m_phases){m_phase -= m_phases; m_pos++;}
+        }
+        else{
+            uint32_t old = m_phase;
+            m_phase += m_stepFrac;
+            if(m_phase < old) m_pos++;
+        }
+    }
+    *used = taken;
+    return produced;
+}
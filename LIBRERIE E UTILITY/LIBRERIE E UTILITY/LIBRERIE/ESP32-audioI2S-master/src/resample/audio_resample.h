@@ -0,0 +1,66 @@
+/*
+ * audio_resample.h
+ *
+ * Fixed-point polyphase sample rate converter for the I2S output path
+ *
+ * With Audio::setOutputRate() the I2S clock stays at one rate and every source (decoders,
+ * writePCM()) is converted into it, no driver reclocking between sources.
+ *
+ *  - Kaiser windowed sinc, RS_FAST/RS_BALANCED/RS_BEST trade taps for CPU
+ *  - rates with a small ratio (out/in reduced to <= RS_MAX_PHASES phases, e.g. 44100 -> 48000 = 160/147)
+ *    use one exact phase per output sample, other ratios interpolate between RS_MAX_PHASES phases
+ *  - Q1.30 coefficients, every phase normalized to unity DC gain,
+ *    64 bit accumulation: no overflow whatever the input, coefficient noise far below 16 bit
+ *  - downsampling moves the cutoff to the output Nyquist and widens the kernel (up to RS_MAX_TAPS)
+ *
+ * The table is built in setRates() only when the rates or the preset change.
+ *
+ */
+#pragma once
+#pragma GCC optimize ("Ofast")
+
+#include "Arduino.h"
+
+#define RS_MAX_TAPS     64              // taps per phase
+#define RS_MAX_PHASES   256             // exact ratios up to this many phases, else interpolated
+#define RS_IN_BLOCK     128             // input frames buffered per refill
+#define RS_MAX_RATIO    16              // in/out, e.g. 96000 -> 8000 is still possible
+#define RS_COEF_Q       30              // coefficients Q1.30
+
+enum : uint8_t {RS_FAST = 0, RS_BALANCED = 1, RS_BEST = 2};
+
+class AudioResampler {
+
+public:
+    AudioResampler();
+    ~AudioResampler();
+    bool     setRates(uint32_t inRate, uint32_t outRate);   // false: ratio not supported or no memory
+    void     setQuality(uint8_t quality);                    // takes effect with the next setRates()
+    void     reset();                                        // clear the history (new source)
+    uint16_t process(const int16_t* in, uint16_t inFrames, uint16_t* used, int16_t* out, uint16_t outMax);
+    uint32_t getInRate()  {return m_inRate;}
+    uint32_t getOutRate() {return m_outRate;}
+    uint8_t  getTaps()    {return m_taps;}
+    uint16_t getPhases()  {return m_phases;}
+    bool     isExact()    {return m_f_exact;}
+
+private:
+    void     design();
+
+    int32_t*  m_coef = NULL;            // (m_phases + 1) rows of m_taps, Q1.30
+    size_t    m_coefSize = 0;
+    int16_t   m_hist[(RS_MAX_TAPS + RS_IN_BLOCK) * 2];      // input history L/R
+    int32_t   m_row[RS_MAX_TAPS];       // interpolated phase
+    uint16_t  m_histLen = 0;            // frames in m_hist
+    uint16_t  m_pos = 0;                // first frame under the kernel for the next output
+    uint32_t  m_phase = 0;              // exact: 0...m_phases-1, else Q32 fraction
+    uint32_t  m_stepInt = 0;            // input frames per output frame, integer part
+    uint32_t  m_stepFrac = 0;           // exact: phases to add, else Q32 fraction
+    uint32_t  m_inRate = 0;
+    uint32_t  m_outRate = 0;
+    uint16_t  m_phases = 0;
+    uint8_t   m_taps = 0;
+    uint8_t   m_quality = RS_BALANCED;
+    uint8_t   m_designQuality = 0xFF;
+    bool      m_f_exact = true;
+};
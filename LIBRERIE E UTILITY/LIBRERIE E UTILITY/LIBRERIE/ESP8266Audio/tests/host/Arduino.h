@@ -1,4 +1,4 @@
-#ifdef ARDUINO
+#if defined(ARDUINO) && !defined(MINIARD)
 #error This file is only used for host builds
 #endif
 
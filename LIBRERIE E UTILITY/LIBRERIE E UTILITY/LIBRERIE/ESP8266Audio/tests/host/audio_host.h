@@ -0,0 +1,261 @@
+// Host build glue for the ESP32-audioI2S Audio class (Audio.cpp) in gapless.cpp, force-included after
+// Arduino.h and bench_host.h. The arduino-esp32/ESP-IDF headers Audio.h includes resolve to esp32_include/,
+// which all forward here.
+// - clock: hostMicros, advanced by the I2S writes (the DMA drains in real time) and by delay()/vTaskDelay()
+// - I2S: every frame written is appended to hostI2sOut (interleaved L/R); hostI2sMaxBytes makes i2s_write()
+//   accept less than asked, like a full DMA after the timeout
+// - fs::FS: files of the host file system below hostFsRoot, File shares one handle between copies
+// - WiFiClient: the test queues the server bytes (hostSend) from hostOnConnect/hostOnPoll
+
+#ifndef AUDIO_HOST_H
+#define AUDIO_HOST_H
+
+#include <ctype.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+// State the test shares with Audio.cpp: weak definitions, one instance however many units include this
+#define HOST_SHARED __attribute__((weak))
+
+// ===== Arduino =====
+HOST_SHARED uint64_t hostMicros = 0;
+static inline uint32_t millis() { return (uint32_t)(hostMicros / 1000); }
+static inline uint32_t micros() { return (uint32_t)hostMicros; }
+static inline void delay(uint32_t ms) { hostMicros += (uint64_t)ms * 1000; }
+#ifndef constrain
+#define constrain(x, lo, hi) ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+#endif
+typedef bool boolean;
+using std::min;
+using std::max;
+static inline int toLowerCase(int c) { return tolower(c); }
+static inline char *itoa(int v, char *buf, int base) {
+    snprintf(buf, 12, base == 16 ? "%x" : "%d", v);
+    return buf;
+}
+#define ARDUHAL_LOG_LEVEL        1
+#define ARDUHAL_LOG_LEVEL_DEBUG  4
+
+struct EspClass {
+    uint32_t getFreeHeap() { return 200000; }
+    uint32_t getFreePsram() { return 4000000; }
+};
+static EspClass ESP __attribute__((unused));
+
+static inline bool psramInit() { return HOST_PSRAM; }
+static inline void *ps_calloc(size_t n, size_t size) { return calloc(n, size); }
+
+// ===== FreeRTOS =====
+#define portTICK_PERIOD_MS 1
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(mux) do { (void)(mux); } while(0)
+#define portEXIT_CRITICAL(mux) do { (void)(mux); } while(0)
+static inline void vTaskDelay(uint32_t ticks) { delay(ticks); }
+
+// ===== ESP-IDF I2S =====
+typedef int esp_err_t;
+#define ESP_OK              0
+#define ESP_FAIL            -1
+#define ESP_ERR_INVALID_ARG 0x102
+#define ESP_INTR_FLAG_LEVEL1 (1 << 1)
+#define I2S_PIN_NO_CHANGE   (-1)
+
+typedef enum { I2S_NUM_0, I2S_NUM_1, I2S_NUM_MAX } i2s_port_t;
+typedef enum { I2S_BITS_PER_SAMPLE_16BIT = 16, I2S_BITS_PER_SAMPLE_32BIT = 32 } i2s_bits_per_sample_t;
+typedef enum { I2S_CHANNEL_FMT_RIGHT_LEFT, I2S_CHANNEL_FMT_ONLY_LEFT } i2s_channel_fmt_t;
+typedef enum {
+    I2S_COMM_FORMAT_STAND_I2S = 0x01, I2S_COMM_FORMAT_STAND_MSB = 0x03,
+    I2S_COMM_FORMAT_I2S = 0x01, I2S_COMM_FORMAT_I2S_MSB = 0x01, I2S_COMM_FORMAT_I2S_LSB = 0x02
+} i2s_comm_format_t;
+typedef enum { I2S_MODE_MASTER = 1, I2S_MODE_TX = 4, I2S_MODE_DAC_BUILT_IN = 16 } i2s_mode_t;
+typedef enum { I2S_DAC_CHANNEL_DISABLE, I2S_DAC_CHANNEL_RIGHT_EN, I2S_DAC_CHANNEL_LEFT_EN, I2S_DAC_CHANNEL_BOTH_EN } i2s_dac_mode_t;
+
+typedef struct {
+    i2s_mode_t mode;
+    uint32_t sample_rate;
+    i2s_bits_per_sample_t bits_per_sample;
+    i2s_channel_fmt_t channel_format;
+    i2s_comm_format_t communication_format;
+    int intr_alloc_flags;
+    int dma_buf_count;
+    int dma_buf_len;
+    bool use_apll;
+    bool tx_desc_auto_clear;
+    int fixed_mclk;
+} i2s_config_t;
+
+typedef struct {
+    int mck_io_num;
+    int bck_io_num;
+    int ws_io_num;
+    int data_out_num;
+    int data_in_num;
+} i2s_pin_config_t;
+
+HOST_SHARED uint32_t hostI2sRate = 0;
+HOST_SHARED uint32_t hostI2sRateChanges = 0;    // i2s_set_sample_rates() with a new rate (DMA restart)
+HOST_SHARED uint32_t hostI2sZeroCalls = 0;      // i2s_zero_dma_buffer(): silence queued
+HOST_SHARED size_t   hostI2sMaxBytes = 0;       // 0 = every write completes
+inline std::vector<int16_t> &hostI2sOutRef() { static std::vector<int16_t> out; return out; }
+#define hostI2sOut hostI2sOutRef()
+
+static inline esp_err_t i2s_driver_install(i2s_port_t, const i2s_config_t *cfg, int, void *) { hostI2sRate = cfg->sample_rate; return ESP_OK; }
+static inline esp_err_t i2s_driver_uninstall(i2s_port_t) { return ESP_OK; }
+static inline esp_err_t i2s_set_pin(i2s_port_t, const i2s_pin_config_t *) { return ESP_OK; }
+static inline esp_err_t i2s_set_dac_mode(i2s_dac_mode_t) { return ESP_OK; }
+static inline esp_err_t i2s_start(i2s_port_t) { return ESP_OK; }
+static inline esp_err_t i2s_stop(i2s_port_t) { return ESP_OK; }
+static inline esp_err_t i2s_zero_dma_buffer(i2s_port_t) { hostI2sZeroCalls++; return ESP_OK; }
+static inline esp_err_t i2s_set_sample_rates(i2s_port_t, uint32_t rate) {
+    if (rate != hostI2sRate) hostI2sRateChanges++;
+    hostI2sRate = rate;
+    return ESP_OK;
+}
+// 32 bit per frame, left channel in the upper half (Audio::writeBlock())
+static inline esp_err_t i2s_write(i2s_port_t, const void *src, size_t size, size_t *written, uint32_t) {
+    if (hostI2sMaxBytes && size > hostI2sMaxBytes) size = hostI2sMaxBytes;
+    size &= ~(size_t)3;
+    const uint32_t *f = (const uint32_t *)src;
+    for (size_t i = 0; i < size / 4; i++) {
+        hostI2sOut.push_back((int16_t)(f[i] >> 16));
+        hostI2sOut.push_back((int16_t)(f[i] & 0xFFFF));
+    }
+    if (hostI2sRate) hostMicros += (uint64_t)(size / 4) * 1000000 / hostI2sRate;
+    *written = size;
+    return ESP_OK;
+}
+
+// ===== libb64 =====
+typedef struct { int step; } base64_encodestate;
+static inline int base64_encode_expected_len(int n) { return (n + 2) / 3 * 4; }
+static inline void base64_init_encodestate(base64_encodestate *s) { s->step = 0; }
+// Blocco unico (Audio codifica user:pwd in una chiamata)
+static inline int base64_encode_block(const char *in, int len, char *out, base64_encodestate *) {
+    static const char t[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    int o = 0;
+    for (int i = 0; i < len; i += 3) {
+        uint32_t v = (uint8_t)in[i] << 16 | (i + 1 < len ? (uint8_t)in[i + 1] << 8 : 0) | (i + 2 < len ? (uint8_t)in[i + 2] : 0);
+        out[o++] = t[v >> 18];
+        out[o++] = t[(v >> 12) & 63];
+        out[o++] = i + 1 < len ? t[(v >> 6) & 63] : '=';
+        out[o++] = i + 2 < len ? t[v & 63] : '=';
+    }
+    return o;
+}
+static inline int base64_encode_blockend(char *, base64_encodestate *) { return 0; }
+
+// ===== FS =====
+HOST_SHARED const char *hostFsRoot = ".";
+
+namespace fs {
+
+class File {
+public:
+    File() {}
+    File(FILE *f, const char *path) : _h(std::make_shared<Handle>()) {
+        _h->f = f;
+        _h->path = path;
+        fseek(f, 0, SEEK_END);
+        _h->size = ftell(f);
+        fseek(f, 0, SEEK_SET);
+    }
+    explicit operator bool() const { return _h && _h->f; }
+    size_t size() const { return *this ? _h->size : 0; }
+    size_t position() const { return *this ? ftell(_h->f) : 0; }
+    int available() const { return *this ? (int)(size() - position()) : 0; }
+    bool seek(uint32_t pos) { return *this && pos <= size() && fseek(_h->f, pos, SEEK_SET) == 0; }
+    int read() { return *this ? fgetc(_h->f) : -1; }
+    int read(uint8_t *buf, size_t len) { return *this ? (int)fread(buf, 1, len, _h->f) : -1; }
+    const char *name() const {
+        if (!_h) return "";
+        size_t s = _h->path.rfind('/');
+        return _h->path.c_str() + (s == std::string::npos ? 0 : s + 1);
+    }
+    const char *path() const { return _h ? _h->path.c_str() : ""; }
+    void close() {
+        if (_h && _h->f) { fclose(_h->f); _h->f = nullptr; }
+        _h.reset();
+    }
+
+private:
+    struct Handle {
+        FILE *f = nullptr;
+        std::string path;
+        size_t size = 0;
+        ~Handle() { if (f) fclose(f); }
+    };
+    std::shared_ptr<Handle> _h;
+};
+
+class FS {
+public:
+    File open(const char *path, const char * = "r") {
+        FILE *f = fopen((std::string(hostFsRoot) + path).c_str(), "rb");
+        return f ? File(f, path) : File();
+    }
+    bool exists(const char *path) {
+        FILE *f = fopen((std::string(hostFsRoot) + path).c_str(), "rb");
+        if (f) fclose(f);
+        return f != nullptr;
+    }
+};
+
+} // namespace fs
+
+using fs::FS;
+using fs::File;
+static fs::FS SD __attribute__((unused)), SD_MMC __attribute__((unused)), SPIFFS __attribute__((unused)), FFat __attribute__((unused));
+
+// ===== WiFi =====
+class WiFiClient;
+HOST_SHARED bool (*hostOnConnect)(WiFiClient *c, const char *host, uint16_t port) = nullptr;   // false = refused
+HOST_SHARED void (*hostOnPoll)(WiFiClient *c) = nullptr;       // before available()/read(): the test delivers bytes
+
+class WiFiClient {
+public:
+    std::vector<uint8_t> hostRx;
+    size_t hostRxPos = 0;
+    bool hostOpen = false;              // the server has not closed the connection
+    std::string hostRequest;            // everything print()ed since connect()
+    uint32_t hostConnects = 0;
+
+    virtual ~WiFiClient() {}
+    void hostSend(const void *data, size_t n) { hostRx.insert(hostRx.end(), (const uint8_t *)data, (const uint8_t *)data + n); }
+    void hostSend(const char *s) { hostSend(s, strlen(s)); }
+
+    int connect(const char *host, uint16_t port, int32_t = 0) {
+        stop();
+        hostConnects++;
+        hostOpen = hostOnConnect ? hostOnConnect(this, host, port) : false;
+        return hostOpen;
+    }
+    uint8_t connected() { poll(); return hostOpen || hostRxPos < hostRx.size(); }
+    int available() { poll(); return (int)(hostRx.size() - hostRxPos); }
+    int read() { poll(); return hostRxPos < hostRx.size() ? hostRx[hostRxPos++] : -1; }
+    int read(uint8_t *buf, size_t len) {
+        poll();
+        size_t n = std::min(len, hostRx.size() - hostRxPos);
+        memcpy(buf, hostRx.data() + hostRxPos, n);
+        hostRxPos += n;
+        return (int)n;
+    }
+    size_t print(const char *s) { hostRequest += s; return strlen(s); }
+    void setNoDelay(bool) {}
+    void flush() {}
+    void stop() { hostOpen = false; hostRx.clear(); hostRxPos = 0; hostRequest.clear(); }
+
+private:
+    void poll() { if (hostOnPoll && hostOpen) hostOnPoll(this); }
+};
+
+class WiFiClientSecure : public WiFiClient {
+public:
+    void setInsecure() {}
+};
+
+#endif
@@ -0,0 +1,779 @@
+// Host decoder benchmark and conformance check
+//
+// Decodes a fixed corpus through every bundled decoder of both audio stacks:
+//   ESP8266Audio   libmad, helix-mp3, helix-aac, libflac, libopus (AudioGenerator* on a memory source)
+//   ESP32-audioI2S mp3_decoder, aac_decoder, flac_decoder (raw API, driven like Audio::sendBytes())
+// and reports per decoder/file: decode time per frame, x realtime, a machine independent figure
+// ("norm", time per frame divided by a fixed calibration loop), peak heap, peak stack and the PCM
+// error against a reference.
+//
+// Reference: ref/<file>.wav, 16 bit PCM from an independent decoder (ffmpeg: "ffmpeg -i pno-cs.mp3
+// ref/pno-cs.mp3.wav"), committed for the default corpus. Files without one are compared against the first
+// decoder of the codec (libmad, helix-aac, libflac, libopus); -w and -c refuse that, a decoder can't be its
+// own reference. Outputs are aligned by cross correlation before the comparison (decoders differ in delay).
+// The thresholds record the word size of the build (heap and stack differ): -c refuses a file written by the
+// other one. bench_thresholds.txt is for the default (native, 64 bit) build.
+//
+//   make bench                   (make bench BENCH_ARCH=-m32 for a 32 bit build, with its own thresholds)
+//   ./bench                      table for the default corpus
+//   ./bench -w bench_thresholds.txt     write the regression thresholds from this run
+//   ./bench -c bench_thresholds.txt     compare, exit code 1 on a regression
+//   ./bench [-r runs] [-csv] [files...]
+
+#include <Arduino.h>
+#include <ctype.h>
+#include <math.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include <new>
+#include <vector>
+#include <string>
+#include "AudioFileSourcePROGMEM.h"
+#include "AudioFileSourceID3.h"
+#include "AudioGeneratorMP3.h"
+#include "AudioGeneratorMP3a.h"
+#include "AudioGeneratorAAC.h"
+#include "AudioGeneratorFLAC.h"
+#include "AudioGeneratorOpus.h"
+#include "AudioOutput.h"
+
+// ESP32-audioI2S decoders, C++ linkage like in Audio.cpp
+bool MP3Decoder_AllocateBuffers(void);
+void MP3Decoder_FreeBuffers();
+int  MP3Decode(unsigned char *inbuf, int *bytesLeft, short *outbuf, int useSize);
+int  MP3FindSyncWord(unsigned char *buf, int nBytes);
+int  MP3GetChannels();
+int  MP3GetSampRate();
+int  MP3GetOutputSamps();
+bool AACDecoder_AllocateBuffers(void);
+void AACDecoder_FreeBuffers(void);
+int  AACFindSyncWord(uint8_t *buf, int nBytes);
+int  AACDecode(uint8_t *inbuf, int *bytesLeft, short *outbuf);
+int  AACGetChannels();
+int  AACGetSampRate();
+int  AACGetOutputSamps();
+bool     FLACDecoder_AllocateBuffers(void);
+void     FLACDecoder_FreeBuffers();
+void     FLACSetRawBlockParams(uint8_t Chans, uint32_t SampRate, uint8_t BPS, uint32_t tsis, uint32_t AuDaLength);
+void     FLACDecoderReset();
+int      FLACFindSyncWord(unsigned char *buf, int nBytes);
+int8_t   FLACDecode(uint8_t *inbuf, int *bytesLeft, short *outbuf);
+uint16_t FLACGetOutputSamps();
+
+static const char *defaultCorpus[] = {
+    "../../examples/PlayMP3FromSPIFFS/data/pno-cs.mp3",
+    "../../examples/PlayAACFromPROGMEM/homer.aac",
+    "gs-16b-2c-44100hz.flac",
+    "../../examples/PlayOpusFromSPIFFS/data/gs-16b-2c-44100hz.opus",
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+// Heap accounting: malloc & co. are wrapped at link time (-Wl,--wrap=...), new/delete go through them
+
+extern "C" {
+void *__real_malloc(size_t size);
+void  __real_free(void *ptr);
+void *__real_calloc(size_t n, size_t size);
+void *__real_realloc(void *ptr, size_t size);
+}
+
+static size_t heapCur = 0;
+static size_t heapPeak = 0;
+
+static void heapAdd(void *p) { if (p) { heapCur += malloc_usable_size(p); if (heapCur > heapPeak) heapPeak = heapCur; } }
+static void heapSub(void *p) { if (p) heapCur -= malloc_usable_size(p); }
+
+extern "C" {
+void *__wrap_malloc(size_t size) { void *p = __real_malloc(size); heapAdd(p); return p; }
+void  __wrap_free(void *ptr) { heapSub(ptr); __real_free(ptr); }
+void *__wrap_calloc(size_t n, size_t size) { void *p = __real_calloc(n, size); heapAdd(p); return p; }
+void *__wrap_realloc(void *ptr, size_t size)
+{
+    heapSub(ptr);
+    void *p = __real_realloc(ptr, size);
+    heapAdd(p ? p : ptr);  // on failure the old block is still allocated
+    return p;
+}
+}
+
+void *operator new(size_t size) { void *p = malloc(size); if (!p) throw std::bad_alloc(); return p; }
+void *operator new[](size_t size) { return operator new(size); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+// The collected PCM must not show up in the decoder's heap figure
+template <class T> struct RawAlloc {
+    typedef T value_type;
+    RawAlloc() {}
+    template <class U> RawAlloc(const RawAlloc<U> &) {}
+    T *allocate(size_t n) { T *p = (T *)__real_malloc(n * sizeof(T)); if (!p) throw std::bad_alloc(); return p; }
+    void deallocate(T *p, size_t) { __real_free(p); }
+    bool operator==(const RawAlloc &) const { return true; }
+    bool operator!=(const RawAlloc &) const { return false; }
+};
+typedef std::vector<int16_t, RawAlloc<int16_t> > PcmBuf;
+
+//----------------------------------------------------------------------------------------------------------------------
+
+enum { CODEC_MP3, CODEC_AAC, CODEC_FLAC, CODEC_OPUS };
+
+struct Corpus {
+    std::string name;                 // file name without path
+    std::vector<uint8_t> data;
+    int      codec;
+    uint32_t audioStart;              // after ID3v2 / FLAC metadata
+    uint32_t frameLen;                // samples per channel and frame, for the time per frame
+    uint8_t  flacChannels, flacBits;  // STREAMINFO
+    uint32_t flacRate, flacTotal;
+};
+
+struct Pcm {
+    PcmBuf   s;                       // always stereo interleaved
+    uint32_t rate = 0;
+};
+
+struct Run {
+    Pcm      pcm;
+    double   us = 0;                  // decode time (thread cpu time)
+    bool     ok = false;
+};
+
+static double nowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void appendPcm(Pcm &pcm, const int16_t *s, int n, int ch)
+{
+    // n interleaved samples with ch channels -> stereo
+    if (ch <= 0) return;
+    for (int i = 0; i + ch <= n; i += ch) {
+        pcm.s.push_back(s[i]);
+        pcm.s.push_back(ch > 1 ? s[i + 1] : s[i]);
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// ESP8266Audio: generators on a memory source, the output collects the samples
+
+class AudioOutputPcm : public AudioOutput
+{
+  public:
+    AudioOutputPcm(Pcm *p) { pcm = p; hertz = 0; bps = 16; channels = 2; gainF2P6 = 64; }
+    virtual bool SetRate(int hz) override { hertz = hz; pcm->rate = hz; return true; }
+    virtual bool begin() override { return true; }
+    virtual bool ConsumeSample(int16_t sample[2]) override
+    {
+        int16_t s[2] = { sample[0], sample[1] };
+        MakeSampleStereo16(s);
+        pcm->s.push_back(s[0]);
+        pcm->s.push_back(s[1]);
+        return true;
+    }
+    virtual bool stop() override { return true; }
+  private:
+    Pcm *pcm;
+};
+
+static void runGenerator(AudioGenerator *gen, AudioFileSource *src, Run &r)
+{
+    AudioOutputPcm *out = new AudioOutputPcm(&r.pcm);
+    double t0 = nowUs();
+    r.ok = gen->begin(src, out);
+    while (r.ok && gen->isRunning() && gen->loop()) { /* decode */ }
+    gen->stop();
+    r.us = nowUs() - t0;
+    delete out;
+}
+
+static void decLibmad(const Corpus &c, Run &r)
+{
+    AudioFileSourcePROGMEM *mem = new AudioFileSourcePROGMEM(c.data.data(), c.data.size());
+    AudioFileSourceID3 *id3 = new AudioFileSourceID3(mem);
+    AudioGeneratorMP3 *gen = new AudioGeneratorMP3();
+    runGenerator(gen, id3, r);
+    delete gen; delete id3; delete mem;
+}
+
+static void decHelixMp3(const Corpus &c, Run &r)
+{
+    AudioFileSourcePROGMEM *mem = new AudioFileSourcePROGMEM(c.data.data(), c.data.size());
+    AudioFileSourceID3 *id3 = new AudioFileSourceID3(mem);
+    AudioGeneratorMP3a *gen = new AudioGeneratorMP3a();
+    runGenerator(gen, id3, r);
+    delete gen; delete id3; delete mem;
+}
+
+static void decHelixAac(const Corpus &c, Run &r)
+{
+    AudioFileSourcePROGMEM *mem = new AudioFileSourcePROGMEM(c.data.data(), c.data.size());
+    AudioGeneratorAAC *gen = new AudioGeneratorAAC();
+    runGenerator(gen, mem, r);
+    delete gen; delete mem;
+}
+
+static void decLibflac(const Corpus &c, Run &r)
+{
+    AudioFileSourcePROGMEM *mem = new AudioFileSourcePROGMEM(c.data.data(), c.data.size());
+    AudioGeneratorFLAC *gen = new AudioGeneratorFLAC();
+    runGenerator(gen, mem, r);
+    delete gen; delete mem;
+}
+
+static void decLibopus(const Corpus &c, Run &r)
+{
+    AudioFileSourcePROGMEM *mem = new AudioFileSourcePROGMEM(c.data.data(), c.data.size());
+    AudioGeneratorOpus *gen = new AudioGeneratorOpus();
+    runGenerator(gen, mem, r);
+    delete gen; delete mem;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// ESP32-audioI2S: sync once, then decode frame by frame, errors skip 2 bytes and resync (Audio::sendBytes()).
+// Each call sees at most one InBuff block (m_frameSizeMP3/AAC/FLAC in Audio.h), the FLAC bit reader
+// counts the available bytes in an int16_t.
+
+static void decEsp32Mp3(const Corpus &c, Run &r)
+{
+    static short out[1152 * 2];
+    uint8_t *p = (uint8_t *)c.data.data() + c.audioStart;
+    int left = c.data.size() - c.audioStart;
+    bool sync = false;
+
+    double t0 = nowUs();
+    r.ok = MP3Decoder_AllocateBuffers();
+    while (r.ok && left > 4) {
+        if (!sync) {
+            int off = MP3FindSyncWord(p, left);
+            if (off < 0) break;
+            p += off; left -= off;
+            sync = true;
+        }
+        int avail = std::min(left, 1600), rest = avail;
+        int ret = MP3Decode(p, &rest, out, 0);
+        int used = avail - rest;
+        if (ret == 0 && used == 0) { used = 1; sync = false; }    // framesize 0
+        else if (ret < 0) {
+            if (ret != -2) sync = false;                          // ERR_MP3_MAINDATA_UNDERFLOW: keep going
+            if (!used) used = 2;
+        }
+        else {
+            if (!r.pcm.rate) r.pcm.rate = MP3GetSampRate();
+            appendPcm(r.pcm, out, MP3GetOutputSamps(), MP3GetChannels());
+        }
+        p += used; left -= used;
+    }
+    MP3Decoder_FreeBuffers();
+    r.us = nowUs() - t0;
+}
+
+static void decEsp32Aac(const Corpus &c, Run &r)
+{
+    static short out[2048 * 2];
+    uint8_t *p = (uint8_t *)c.data.data() + c.audioStart;
+    int left = c.data.size() - c.audioStart;
+    bool sync = false;
+
+    double t0 = nowUs();
+    r.ok = AACDecoder_AllocateBuffers();
+    while (r.ok && left > 7) {
+        if (!sync) {
+            int off = AACFindSyncWord(p, left);
+            if (off < 0) break;
+            p += off; left -= off;
+            sync = true;
+        }
+        int avail = std::min(left, 1600), rest = avail;
+        int ret = AACDecode(p, &rest, out);
+        int used = avail - rest;
+        if (ret == 0 && used == 0) { used = 1; sync = false; }
+        else if (ret < 0) { sync = false; if (!used) used = 2; }
+        else {
+            if (!r.pcm.rate) r.pcm.rate = AACGetSampRate();
+            appendPcm(r.pcm, out, AACGetOutputSamps(), AACGetChannels());
+        }
+        p += used; left -= used;
+    }
+    AACDecoder_FreeBuffers();
+    r.us = nowUs() - t0;
+}
+
+static void decEsp32Flac(const Corpus &c, Run &r)
+{
+    static short out[2048 * 2];
+    uint8_t *p = (uint8_t *)c.data.data() + c.audioStart;
+    int left = c.data.size() - c.audioStart;
+    bool sync = false;
+
+    double t0 = nowUs();
+    r.ok = FLACDecoder_AllocateBuffers();
+    if (r.ok) FLACSetRawBlockParams(c.flacChannels, c.flacRate, c.flacBits, c.flacTotal, left);
+    r.pcm.rate = c.flacRate;
+    while (r.ok && left > 2) {
+        if (!sync) {
+            int off = FLACFindSyncWord(p, left);
+            if (off < 0) break;
+            p += off; left -= off;
+            sync = true;
+        }
+        int avail = std::min(left, 4096 * 4), rest = avail;
+        int ret = FLACDecode(p, &rest, out);
+        int used = avail - rest;
+        appendPcm(r.pcm, out, FLACGetOutputSamps(), c.flacChannels);
+        if (ret < 0) { sync = false; FLACDecoderReset(); if (!used) used = 2; }
+        p += used; left -= used;
+    }
+    FLACDecoder_FreeBuffers();
+    r.us = nowUs() - t0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Decoder {
+    const char *name;
+    int         codec;
+    void      (*fn)(const Corpus &, Run &);
+};
+
+// the first decoder of a codec is the fallback reference
+static const Decoder decoders[] = {
+    { "libmad",          CODEC_MP3,  decLibmad   },
+    { "helix-mp3",       CODEC_MP3,  decHelixMp3 },
+    { "esp32-mp3",       CODEC_MP3,  decEsp32Mp3 },
+    { "helix-aac",       CODEC_AAC,  decHelixAac },
+    { "esp32-aac",       CODEC_AAC,  decEsp32Aac },
+    { "libflac",         CODEC_FLAC, decLibflac  },
+    { "esp32-flac",      CODEC_FLAC, decEsp32Flac},
+    { "libopus",         CODEC_OPUS, decLibopus  },
+};
+
+// Each decode runs on its own thread with a painted stack, like uxTaskGetStackHighWaterMark()
+static const size_t benchStackSize = 1024 * 1024;
+static const uint8_t stackPaint = 0xA5;
+
+struct Job {
+    void      (*fn)(const Corpus &, Run &);
+    const Corpus *c;
+    Run       *r;
+};
+
+static void *jobThread(void *arg)
+{
+    Job *j = (Job *)arg;
+    if (j->fn) j->fn(*j->c, *j->r);
+    return NULL;
+}
+
+static void runJob(const Job &job, size_t *heap, size_t *stack)
+{
+    uint8_t *st = (uint8_t *)__real_malloc(benchStackSize);
+    memset(st, stackPaint, benchStackSize);
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, st, benchStackSize);
+
+    size_t base = heapCur;
+    heapPeak = heapCur;
+    pthread_t th;
+    Job j = job;
+    pthread_create(&th, &attr, jobThread, &j);
+    pthread_join(th, NULL);
+    pthread_attr_destroy(&attr);
+
+    size_t untouched = 0;
+    while (untouched < benchStackSize && st[untouched] == stackPaint) untouched++;
+    __real_free(st);
+    *heap = heapPeak - base;
+    *stack = benchStackSize - untouched;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static bool loadFile(const char *path, std::vector<uint8_t> &data)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    data.resize(len > 0 ? len : 0);
+    bool ok = len > 0 && fread(data.data(), 1, len, f) == (size_t)len;
+    fclose(f);
+    return ok;
+}
+
+static bool endsWith(const std::string &s, const char *e)
+{
+    size_t n = strlen(e);
+    return s.size() >= n && strcasecmp(s.c_str() + s.size() - n, e) == 0;
+}
+
+static bool openCorpus(const char *path, Corpus &c)
+{
+    const char *slash = strrchr(path, '/');
+    c.name = slash ? slash + 1 : path;
+    if (!loadFile(path, c.data)) { fprintf(stderr, "can't read %s\n", path); return false; }
+    const uint8_t *d = c.data.data();
+    size_t len = c.data.size();
+    c.audioStart = 0;
+
+    if (endsWith(c.name, ".mp3")) {
+        c.codec = CODEC_MP3;
+        if (len > 10 && !memcmp(d, "ID3", 3)) {
+            c.audioStart = 10 + ((d[6] & 0x7f) << 21 | (d[7] & 0x7f) << 14 | (d[8] & 0x7f) << 7 | (d[9] & 0x7f));
+        }
+        size_t i = c.audioStart;
+        while (i + 1 < len && !(d[i] == 0xff && (d[i + 1] & 0xe0) == 0xe0)) i++;
+        c.frameLen = (i + 1 < len && ((d[i + 1] >> 3) & 3) == 3) ? 1152 : 576;   // MPEG1 : MPEG2/2.5
+    }
+    else if (endsWith(c.name, ".aac")) {
+        c.codec = CODEC_AAC;
+        c.frameLen = 1024;              // corrected for SBR in the report (output rate vs ADTS rate)
+    }
+    else if (endsWith(c.name, ".flac")) {
+        c.codec = CODEC_FLAC;
+        if (len < 42 || memcmp(d, "fLaC", 4)) { fprintf(stderr, "%s: no fLaC marker\n", path); return false; }
+        size_t pos = 4;
+        bool last = false;
+        while (!last && pos + 4 <= len) {
+            last = d[pos] & 0x80;
+            uint8_t type = d[pos] & 0x7f;
+            uint32_t blen = d[pos + 1] << 16 | d[pos + 2] << 8 | d[pos + 3];
+            const uint8_t *b = d + pos + 4;
+            if (type == 0 && blen >= 18) {      // STREAMINFO
+                c.frameLen     = b[2] << 8 | b[3];
+                c.flacRate     = b[10] << 12 | b[11] << 4 | b[12] >> 4;
+                c.flacChannels = ((b[12] >> 1) & 7) + 1;
+                c.flacBits     = ((b[12] & 1) << 4 | b[13] >> 4) + 1;
+                c.flacTotal    = (uint32_t)b[14] << 24 | b[15] << 16 | b[16] << 8 | b[17];
+            }
+            pos += 4 + blen;
+        }
+        c.audioStart = pos;
+    }
+    else if (endsWith(c.name, ".opus")) {
+        c.codec = CODEC_OPUS;
+        c.frameLen = 960;               // 20 ms at 48 kHz
+    }
+    else {
+        fprintf(stderr, "%s: unknown codec\n", path);
+        return false;
+    }
+    return true;
+}
+
+static bool loadWav(const char *path, Pcm &pcm)
+{
+    std::vector<uint8_t> d;
+    if (!loadFile(path, d) || d.size() < 44 || memcmp(d.data(), "RIFF", 4) || memcmp(d.data() + 8, "WAVE", 4)) return false;
+    size_t pos = 12;
+    int ch = 0, bits = 0;
+    while (pos + 8 <= d.size()) {
+        uint32_t clen = d[pos + 4] | d[pos + 5] << 8 | d[pos + 6] << 16 | (uint32_t)d[pos + 7] << 24;
+        const uint8_t *b = d.data() + pos + 8;
+        if (!memcmp(d.data() + pos, "fmt ", 4)) {
+            ch = b[2] | b[3] << 8;
+            pcm.rate = b[4] | b[5] << 8 | b[6] << 16 | (uint32_t)b[7] << 24;
+            bits = b[14] | b[15] << 8;
+        }
+        if (!memcmp(d.data() + pos, "data", 4)) {
+            if (bits != 16 || !ch) return false;
+            clen = std::min<size_t>(clen, d.size() - pos - 8);
+            appendPcm(pcm, (const int16_t *)b, clen / 2, ch);
+            return true;
+        }
+        pos += 8 + clen + (clen & 1);
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Comparison
+
+struct Error {
+    int    lag = 0;           // sample frames, test = ref shifted by lag
+    double rms = 0;           // LSB
+    int    max = 0;           // LSB
+    double snr = 0;           // dB, 999 = identical
+    long   lenDiff = 0;       // sample frames
+};
+
+static int findLag(const PcmBuf &ref, const PcmBuf &test, int maxLag)
+{
+    // correlate mono sums over a window that starts at the loudest stretch of the first seconds
+    long nr = ref.size() / 2, nt = test.size() / 2;
+    long win = 8192, start = 0;
+    double best = -1;
+    for (long s = maxLag; s + win < nr && s < 10 * 44100; s += 2048) {
+        double e = 0;
+        for (long i = s; i < s + 2048; i++) e += fabs((double)ref[2 * i] + ref[2 * i + 1]);
+        if (e > best) { best = e; start = s; }
+    }
+    if (start + win > nr) win = nr - start;
+    int lag = 0;
+    double bestCorr = -1e300;
+    for (int l = -maxLag; l <= maxLag; l++) {
+        if (start + l < 0 || start + l + win > nt) continue;
+        double acc = 0;
+        for (long i = start; i < start + win; i += 2) {
+            double a = (double)ref[2 * i] + ref[2 * i + 1];
+            double b = (double)test[2 * (i + l)] + test[2 * (i + l) + 1];
+            acc += a * b;
+        }
+        if (acc > bestCorr) { bestCorr = acc; lag = l; }
+    }
+    return lag;
+}
+
+static Error compare(const Pcm &ref, const Pcm &test)
+{
+    Error e;
+    long nr = ref.s.size() / 2, nt = test.s.size() / 2;
+    e.lenDiff = nt - nr;
+    if (!nr || !nt || ref.rate != test.rate) { e.snr = -1; e.rms = -1; return e; }
+    e.lag = findLag(ref.s, test.s, 2 * 1152);
+    double sig = 0, err = 0;
+    long n = 0;
+    for (long i = std::max(0L, (long)-e.lag); i < nr && i + e.lag < nt; i++) {
+        for (int ch = 0; ch < 2; ch++) {
+            int a = ref.s[2 * i + ch];
+            int d = test.s[2 * (i + e.lag) + ch] - a;
+            sig += (double)a * a;
+            err += (double)d * d;
+            if (abs(d) > e.max) e.max = abs(d);
+            n++;
+        }
+    }
+    e.rms = n ? sqrt(err / n) : 0;
+    e.snr = err > 0 ? 10 * log10(sig / err) : 999;
+    return e;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Calibration: a fixed integer/MAC workload, "norm" = us per frame / calibration us * 1000.
+// It runs again next to every decode, so clock changes of the host cancel out.
+
+static double calibrate(int rounds)
+{
+    double best = 1e300;
+    for (int k = 0; k < rounds; k++) {
+        double t0 = nowUs();
+        uint32_t x = 2463534242u;
+        int64_t acc = 0;
+        for (int i = 0; i < (1 << 22); i++) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            acc += (int64_t)(int16_t)x * (int16_t)(x >> 16);
+        }
+        double t = nowUs() - t0;
+        if (acc == 42) printf(" ");   // keep the loop
+        if (t < best) best = t;
+    }
+    return best;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Result {
+    std::string decoder, corpus, ref;
+    double  frames = 0, usPerFrame = 0, xrt = 0, norm = 0;
+    size_t  heap = 0, stack = 0;
+    Error   err;
+    bool    ok = false;
+    bool    refFile = false;  // compared against ref/<corpus>.wav, not another decoder
+};
+
+struct Threshold {
+    std::string decoder, corpus;
+    double norm;
+    size_t heap, stack;
+    double rms;
+};
+
+// Decoders chat on stdout (host Print::printf_P), the report gets the original stdout, the chatter goes to stderr
+static FILE *report = stdout;
+
+static std::vector<Threshold> readThresholds(const char *path, int *bits)
+{
+    std::vector<Threshold> t;
+    *bits = 0;
+    FILE *f = fopen(path, "r");
+    if (!f) return t;
+    char line[256], dec[64], cor[128];
+    while (fgets(line, sizeof(line), f)) {
+        Threshold th;
+        unsigned long heap, stack;
+        const char *b = strstr(line, " bit build");
+        if (line[0] == '#' && b && !*bits) {
+            while (b > line && isdigit((unsigned char)b[-1])) b--;
+            *bits = atoi(b);
+        }
+        if (line[0] == '#') continue;
+        if (sscanf(line, "%63s %127s %lf %lu %lu %lf", dec, cor, &th.norm, &heap, &stack, &th.rms) != 6) continue;
+        th.decoder = dec; th.corpus = cor; th.heap = heap; th.stack = stack;
+        t.push_back(th);
+    }
+    fclose(f);
+    return t;
+}
+
+static bool writeThresholds(const char *path, const std::vector<Result> &res, double calib)
+{
+    for (size_t i = 0; i < res.size(); i++) {
+        if (res[i].ok && !res[i].refFile) {
+            fprintf(stderr, "%s %s: ref/%s.wav missing, no thresholds written\n", res[i].decoder.c_str(), res[i].corpus.c_str(),
+                    res[i].corpus.c_str());
+            return false;
+        }
+    }
+    FILE *f = fopen(path, "w");
+    if (!f) return false;
+    fprintf(f, "# bench regression thresholds, written by ./bench -w (%d bit build, calibration loop %.0f us)\n", (int)sizeof(void *) * 8, calib);
+    fprintf(f, "# norm +50%%, heap +5%%, stack +10%%, rms error x1.1 +0.5 LSB over the measured values\n");
+    fprintf(f, "# decoder      corpus                          norm     heap    stack      rms\n");
+    for (size_t i = 0; i < res.size(); i++) {
+        const Result &r = res[i];
+        if (!r.ok) continue;
+        fprintf(f, "%-14s %-28s %8.2f %8lu %8lu %8.2f\n", r.decoder.c_str(), r.corpus.c_str(), r.norm * 1.5,
+                (unsigned long)(r.heap * 105 / 100), (unsigned long)(r.stack * 110 / 100),
+                (r.err.rms > 0 ? r.err.rms : 0) * 1.1 + 0.5);
+    }
+    fclose(f);
+    return true;
+}
+
+static int checkThresholds(const char *path, const std::vector<Result> &res)
+{
+    int bits;
+    std::vector<Threshold> t = readThresholds(path, &bits);
+    if (t.empty()) { fprintf(stderr, "no thresholds in %s\n", path); return 1; }
+    if (bits != (int)sizeof(void *) * 8) {
+        fprintf(stderr, "%s is for a %d bit build, this one is %d bit: build with the matching BENCH_ARCH or write new thresholds with -w\n",
+                path, bits, (int)sizeof(void *) * 8);
+        return 1;
+    }
+    int fails = 0;
+    for (size_t i = 0; i < res.size(); i++) {
+        const Result &r = res[i];
+        if (r.ok && !r.refFile) { fprintf(report, "NO REFERENCE %s %s: ref/%s.wav missing\n", r.decoder.c_str(), r.corpus.c_str(), r.corpus.c_str()); fails++; }
+        for (size_t k = 0; k < t.size(); k++) {
+            const Threshold &th = t[k];
+            if (th.decoder != r.decoder || th.corpus != r.corpus) continue;
+            if (!r.ok)              { fprintf(report, "REGRESSION %s %s: decode failed\n", r.decoder.c_str(), r.corpus.c_str()); fails++; }
+            if (r.norm > th.norm)   { fprintf(report, "REGRESSION %s %s: norm %.2f > %.2f\n", r.decoder.c_str(), r.corpus.c_str(), r.norm, th.norm); fails++; }
+            if (r.heap > th.heap)   { fprintf(report, "REGRESSION %s %s: heap %lu > %lu\n", r.decoder.c_str(), r.corpus.c_str(), (unsigned long)r.heap, (unsigned long)th.heap); fails++; }
+            if (r.stack > th.stack) { fprintf(report, "REGRESSION %s %s: stack %lu > %lu\n", r.decoder.c_str(), r.corpus.c_str(), (unsigned long)r.stack, (unsigned long)th.stack); fails++; }
+            if (r.err.rms > th.rms) { fprintf(report, "REGRESSION %s %s: rms error %.2f > %.2f\n", r.decoder.c_str(), r.corpus.c_str(), r.err.rms, th.rms); fails++; }
+        }
+    }
+    fprintf(report, "%s: %d regression(s)\n", path, fails);
+    return fails ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    int runs = 3;
+    bool csv = false;
+    const char *writePath = NULL, *checkPath = NULL;
+    std::vector<const char *> files;
+    for (int i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-r") && i + 1 < argc) runs = atoi(argv[++i]);
+        else if (!strcmp(argv[i], "-w") && i + 1 < argc) writePath = argv[++i];
+        else if (!strcmp(argv[i], "-c") && i + 1 < argc) checkPath = argv[++i];
+        else if (!strcmp(argv[i], "-csv")) csv = true;
+        else files.push_back(argv[i]);
+    }
+    if (files.empty()) files.assign(defaultCorpus, defaultCorpus + sizeof(defaultCorpus) / sizeof(defaultCorpus[0]));
+    if (runs < 1) runs = 1;
+
+    report = fdopen(dup(1), "w");
+    dup2(2, 1);
+
+    double calib = calibrate(5);
+    size_t baseHeap, baseStack;
+    runJob(Job{ NULL, NULL, NULL }, &baseHeap, &baseStack);   // thread overhead, subtracted below
+
+    std::vector<Result> results;
+    for (size_t f = 0; f < files.size(); f++) {
+        Corpus c;
+        if (!openCorpus(files[f], c)) continue;
+
+        Pcm ref;
+        std::string refName = "ref/" + c.name + ".wav";
+        bool haveRef = loadWav(refName.c_str(), ref);
+        const bool refFile = haveRef;
+
+        for (size_t d = 0; d < sizeof(decoders) / sizeof(decoders[0]); d++) {
+            if (decoders[d].codec != c.codec) continue;
+            Result res;
+            res.decoder = decoders[d].name;
+            res.corpus = c.name;
+            Run best;
+            best.us = 1e300;
+            double ratio = 1e300;
+            for (int k = 0; k < runs; k++) {
+                Run r;
+                size_t heap, stack;
+                double cal = calibrate(2);
+                runJob(Job{ decoders[d].fn, &c, &r }, &heap, &stack);
+                if (!k) { res.heap = heap; res.stack = stack > baseStack ? stack - baseStack : 0; }
+                res.ok = r.ok && r.pcm.s.size();
+                if (!res.ok) break;
+                ratio = std::min(ratio, r.us / cal);
+                if (r.us < best.us) { best.us = r.us; best.pcm.rate = r.pcm.rate; best.pcm.s.swap(r.pcm.s); }
+            }
+            if (res.ok) {
+                double samples = best.pcm.s.size() / 2;
+                uint32_t frameLen = c.frameLen;
+                if (c.codec == CODEC_AAC) {   // HE-AAC: SBR doubles the output rate
+                    static const uint32_t adtsRate[] = { 96000, 88200, 64000, 48000, 44100, 32000, 24000, 22050, 16000, 12000, 11025, 8000, 7350, 0, 0, 0 };
+                    const uint8_t *a = c.data.data() + c.audioStart;
+                    if (c.data.size() > c.audioStart + 3 && best.pcm.rate >= 2 * adtsRate[(a[2] >> 2) & 15]) frameLen *= 2;
+                }
+                res.frames = frameLen ? samples / frameLen : 0;
+                res.usPerFrame = res.frames ? best.us / res.frames : 0;
+                res.xrt = best.us ? samples / best.pcm.rate * 1e6 / best.us : 0;
+                res.norm = res.frames ? ratio / res.frames * 1000 : 0;
+                if (!haveRef) {   // first decoder of the codec is the reference
+                    ref.rate = best.pcm.rate;
+                    ref.s = best.pcm.s;
+                    haveRef = true;
+                    refName = decoders[d].name;
+                }
+                res.ref = refName;
+                res.refFile = refFile;
+                res.err = compare(ref, best.pcm);
+            }
+            results.push_back(res);
+        }
+    }
+
+    if (csv) fprintf(report, "decoder,corpus,frames,us_per_frame,x_realtime,norm,heap,stack,lag,rms,max,snr_db,len_diff,ref\n");
+    else {
+        fprintf(report, "calibration loop: %.0f us\n", calib);
+        fprintf(report, "%-12s %-28s %7s %9s %7s %8s %8s %7s %5s %7s %6s %7s %6s  %s\n", "decoder", "corpus", "frames", "us/frame",
+               "xRT", "norm", "heap", "stack", "lag", "rms", "max", "SNR dB", "dlen", "ref");
+    }
+    for (size_t i = 0; i < results.size(); i++) {
+        const Result &r = results[i];
+        if (!r.ok) { fprintf(report, csv ? "%s,%s,FAILED\n" : "%-12s %-28s FAILED\n", r.decoder.c_str(), r.corpus.c_str()); continue; }
+        fprintf(report, csv ? "%s,%s,%.0f,%.2f,%.1f,%.2f,%lu,%lu,%d,%.2f,%d,%.1f,%ld,%s\n"
+                   : "%-12s %-28s %7.0f %9.2f %7.1f %8.2f %8lu %7lu %5d %7.2f %6d %7.1f %6ld  %s\n",
+               r.decoder.c_str(), r.corpus.c_str(), r.frames, r.usPerFrame, r.xrt, r.norm,
+               (unsigned long)r.heap, (unsigned long)r.stack, r.err.lag, r.err.rms, r.err.max, r.err.snr,
+               r.err.lenDiff, r.ref.c_str());
+    }
+
+    int ret = 0;
+    if (writePath) {
+        if (writeThresholds(writePath, results, calib)) fprintf(report, "thresholds written to %s\n", writePath);
+        else { fprintf(stderr, "can't write %s\n", writePath); ret = 1; }
+    }
+    if (checkPath) ret |= checkThresholds(checkPath, results);
+    return ret;
+}
@@ -0,0 +1,39 @@
+// Host build glue for bench.cpp, eq.cpp, resample.cpp and gapless.cpp, force-included after Arduino.h.
+// - ARDUINO selects the portable C path of libhelix-mp3/-aac (assembly.h has no x86 branch for mp3)
+// - the few ESP-IDF/arduino-esp32 calls used by the ESP32-audioI2S decoders, AudioEQ and AudioResampler
+
+#ifndef BENCH_HOST_H
+#define BENCH_HOST_H
+
+#ifndef ARDUINO
+#define ARDUINO 10819
+#endif
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+#include <algorithm>     // arduino-esp32 Arduino.h pulls it in
+
+#define MALLOC_CAP_DEFAULT  (1 << 12)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+static inline void *heap_caps_malloc_prefer(size_t size, size_t num, ...) { (void)num; return malloc(size); }
+#ifndef HOST_PSRAM
+#define HOST_PSRAM 0     // 1: the PSRAM paths (InBuff, gapless prefetch) in gapless.cpp
+#endif
+static inline bool psramFound() { return HOST_PSRAM; }
+static inline void *ps_malloc(size_t size) { return malloc(size); }
+
+#define log_e(...) do {} while(0)
+#define log_w(...) do {} while(0)
+#define log_i(...) do {} while(0)
+#define log_d(...) do {} while(0)
+#define log_v(...) do {} while(0)
+#endif
+
+#endif
@@ -0,0 +1,368 @@
+// Host check of the ESP32-audioI2S block equalizer (src/eq/audio_eq.cpp)
+//
+//  - frequency response: sine sweeps through AudioEQ against the biquads designed in double,
+//    for setTone() presets, 5 parametric bands, low/high pass and the loudness contour, 44.1/48 kHz
+//  - the former float path of Audio::playSample() (IIR_filterChain0/1/2 + Gain(), kept below as reference)
+//    must have the same response shape
+//  - digital silence and a muted channel stay silent, dither has no DC, noise floor of a low shelf
+//  - per block cost of both paths (128 frames stereo), the block path with the same 3 biquads no slower
+//
+//   make eq && ./eq          exit code 1 if a check fails
+
+#include <Arduino.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include "eq/audio_eq.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%s ", ok ? "  ok  " : "FAILED");
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+    if (!ok) failures++;
+}
+
+static double nowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Reference design in double (same formulas as AudioEQ::design(), independent of its float path)
+
+struct Band { uint8_t type; double freq, gain, q; };
+struct Biquad { double a0, a1, a2, b1, b2; };
+
+static bool designRef(const Band &b, double fs, Biquad &c)
+{
+    if (b.type == EQ_OFF) return false;
+    if (b.gain == 0 && (b.type == EQ_LOWSHELF || b.type == EQ_PEAK || b.type == EQ_HIGHSHELF)) return false;
+    double fc = std::min(b.freq / fs, 0.45);
+    double K = tan(M_PI * fc), V = pow(10, fabs(b.gain) / 20), Q = b.q, s2 = sqrt(2), s2V = sqrt(2 * V), n;
+    bool boost = b.gain > 0;
+    switch (b.type) {
+    case EQ_LOWSHELF:
+        if (boost) { n = 1 / (1 + s2 * K + K * K); c = { (1 + s2V * K + V * K * K) * n, 2 * (V * K * K - 1) * n, (1 - s2V * K + V * K * K) * n, 2 * (K * K - 1) * n, (1 - s2 * K + K * K) * n }; }
+        else       { n = 1 / (1 + s2V * K + V * K * K); c = { (1 + s2 * K + K * K) * n, 2 * (K * K - 1) * n, (1 - s2 * K + K * K) * n, 2 * (V * K * K - 1) * n, (1 - s2V * K + V * K * K) * n }; }
+        return true;
+    case EQ_PEAK:
+        if (boost) { n = 1 / (1 + K / Q + K * K); c = { (1 + V / Q * K + K * K) * n, 2 * (K * K - 1) * n, (1 - V / Q * K + K * K) * n, 2 * (K * K - 1) * n, (1 - K / Q + K * K) * n }; }
+        else       { n = 1 / (1 + V / Q * K + K * K); c = { (1 + K / Q + K * K) * n, 2 * (K * K - 1) * n, (1 - K / Q + K * K) * n, 2 * (K * K - 1) * n, (1 - V / Q * K + K * K) * n }; }
+        return true;
+    case EQ_HIGHSHELF:
+        if (boost) { n = 1 / (1 + s2 * K + K * K); c = { (V + s2V * K + K * K) * n, 2 * (K * K - V) * n, (V - s2V * K + K * K) * n, 2 * (K * K - 1) * n, (1 - s2 * K + K * K) * n }; }
+        else       { n = 1 / (V + s2V * K + K * K); c = { (1 + s2 * K + K * K) * n, 2 * (K * K - 1) * n, (1 - s2 * K + K * K) * n, 2 * (K * K - V) * n, (V - s2V * K + K * K) * n }; }
+        return true;
+    case EQ_LOWPASS:
+        n = 1 / (1 + K / Q + K * K); c = { K * K * n, 2 * K * K * n, K * K * n, 2 * (K * K - 1) * n, (1 - K / Q + K * K) * n };
+        return true;
+    case EQ_HIGHPASS:
+        n = 1 / (1 + K / Q + K * K); c = { n, -2 * n, n, 2 * (K * K - 1) * n, (1 - K / Q + K * K) * n };
+        return true;
+    }
+    return false;
+}
+
+static double magRef(const std::vector<Biquad> &cs, double fs, double f)
+{
+    double w = 2 * M_PI * f / fs, m = 1;
+    for (size_t i = 0; i < cs.size(); i++) {
+        const Biquad &c = cs[i];
+        double nr = c.a0 + c.a1 * cos(w) + c.a2 * cos(2 * w), ni = -(c.a1 * sin(w) + c.a2 * sin(2 * w));
+        double dr = 1 + c.b1 * cos(w) + c.b2 * cos(2 * w), di = -(c.b1 * sin(w) + c.b2 * sin(2 * w));
+        m *= sqrt((nr * nr + ni * ni) / (dr * dr + di * di));
+    }
+    return m;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Former float path of Audio.cpp: IIR_calculateCoefficients(), IIR_filterChain0/1/2 (one loop), Gain()
+
+class LegacyTone
+{
+  public:
+    void setup(double fs, int g0, int g1, int g2, uint8_t vol)
+    {
+        Band b[3] = { { EQ_LOWSHELF, 500, (double)g0, 0.707 }, { EQ_PEAK, 3000, (double)g1, 2.5 }, { EQ_HIGHSHELF, 6000, (double)g2, 0.707 } };
+        for (int i = 0; i < 3; i++) {
+            Biquad c = { 1, 0, 0, 0, 0 };
+            designRef(b[i], fs, c);
+            f[i][0] = c.a0; f[i][1] = c.a1; f[i][2] = c.a2; f[i][3] = c.b1; f[i][4] = c.b2;
+        }
+        memset(buf, 0, sizeof(buf));
+        m_vol = vol;
+    }
+    uint32_t play(int16_t sample[2])
+    {
+        int16_t s[2] = { (int16_t)(sample[0] >> 1), (int16_t)(sample[1] >> 1) };
+        for (int k = 0; k < 3; k++) {
+            for (int ch = 0; ch < 2; ch++) {
+                float in = s[ch];
+                float out = f[k][0] * in + f[k][1] * buf[k][0][0][ch] + f[k][2] * buf[k][1][0][ch]
+                          - f[k][3] * buf[k][0][1][ch] - f[k][4] * buf[k][1][1][ch];
+                buf[k][1][0][ch] = buf[k][0][0][ch];
+                buf[k][0][0][ch] = in;
+                buf[k][1][1][ch] = buf[k][0][1][ch];
+                buf[k][0][1][ch] = out;
+                s[ch] = (int16_t)out;
+            }
+        }
+        int32_t l = (s[0] * m_vol) >> 6, r = (s[1] * m_vol) >> 6;
+        return (l << 16) | (r & 0xffff);
+    }
+  private:
+    float   f[3][5];
+    float   buf[3][2][2][2];
+    uint8_t m_vol;
+};
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static const int   amp = 8000;                    // input sine, about -12 dBFS
+static const int   settle = 16384, measure = 16384;
+
+// Amplitude of the f component in a stereo int16 buffer (left channel), by a DFT over whole samples
+static double toneAmp(const std::vector<int16_t> &s, double fs, double f, int start, int len)
+{
+    double re = 0, im = 0;
+    for (int i = 0; i < len; i++) {
+        double w = 2 * M_PI * f * (start + i) / fs;
+        re += s[2 * (start + i)] * cos(w);
+        im += s[2 * (start + i)] * sin(w);
+    }
+    return 2 * sqrt(re * re + im * im) / len;
+}
+
+static std::vector<int16_t> sine(double fs, double f, int frames, int a)
+{
+    std::vector<int16_t> s(2 * frames);
+    for (int i = 0; i < frames; i++) s[2 * i] = s[2 * i + 1] = (int16_t)lrint(a * sin(2 * M_PI * f * i / fs));
+    return s;
+}
+
+static double measureEq(AudioEQ &eq, double fs, double f)
+{
+    std::vector<int16_t> s = sine(fs, f, settle + measure, amp);
+    eq.reset();
+    for (int i = 0; i < settle + measure; i += EQ_BLOCK) eq.process(&s[2 * i], std::min(EQ_BLOCK, settle + measure - i));
+    return toneAmp(s, fs, f, settle, measure);
+}
+
+static double measureLegacy(LegacyTone &lt, double fs, double f)
+{
+    std::vector<int16_t> s = sine(fs, f, settle + measure, amp);
+    for (int i = 0; i < settle + measure; i++) {
+        uint32_t v = lt.play(&s[2 * i]);
+        s[2 * i] = (int16_t)(v >> 16);
+        s[2 * i + 1] = (int16_t)(v & 0xffff);
+    }
+    return toneAmp(s, fs, f, settle, measure);
+}
+
+// Test frequency moved onto a DFT bin of the measure window, no leakage of the tone into itself
+static double onBin(double f, double fs) { return round(f * measure / fs) * fs / measure; }
+
+static const double testFreq[] = { 31, 63, 100, 125, 250, 500, 1000, 2000, 3000, 4000, 6000, 8000, 10000, 12500, 16000, 19000 };
+
+// Sweep AudioEQ against the double design, including the automatic headroom (cascade peak > 6dB)
+static void responseTest(const char *name, const Band *bands, int nb, int loudness, double fs)
+{
+    AudioEQ eq;
+    eq.setSampleRate((uint32_t)fs);
+    eq.setGain(64, 64);
+    std::vector<Biquad> cs;
+    for (int i = 0; i < nb; i++) {
+        eq.setBand(i, bands[i].type, (uint16_t)bands[i].freq, (int8_t)bands[i].gain, (float)bands[i].q);
+        Biquad c;
+        if (designRef(bands[i], fs, c)) cs.push_back(c);
+    }
+    eq.setLoudness(loudness);
+    if (loudness < 100) {
+        int bass = (100 - loudness + 5) / 10;
+        Band lb[2] = { { EQ_LOWSHELF, 100, (double)bass, 0.707 }, { EQ_HIGHSHELF, 10000, (double)(bass / 2), 0.707 } };
+        for (int i = 0; i < 2; i++) { Biquad c; if (designRef(lb[i], fs, c)) cs.push_back(c); }
+    }
+    double peak = 1;
+    for (double f = 20; f < 0.45 * fs; f *= 1.01) peak = std::max(peak, magRef(cs, fs, f));
+    double headroom = peak > 2 ? 2 / peak : 1;
+
+    double worst = 0;
+    for (size_t k = 0; k < sizeof(testFreq) / sizeof(testFreq[0]); k++) {
+        double f = onBin(testFreq[k], fs);
+        if (f > 0.45 * fs) continue;
+        double expect = amp / 2.0 * headroom * magRef(cs, fs, f);
+        if (expect < 4) continue;                   // below -78 dBFS: dither noise, not response
+        double got = measureEq(eq, fs, f);
+        double err = 20 * log10(got / expect);
+        if (fabs(err) > fabs(worst)) worst = err;
+    }
+    check(fabs(worst) < 0.05 && fabs(eq.getHeadroom() - headroom) < 0.01,
+          "%-26s %5.1f kHz  %d stages  headroom %5.2f dB  max error %+6.3f dB", name, fs / 1000, eq.getStages(),
+          20 * log10(eq.getHeadroom()), worst);
+}
+
+// setTone() presets: AudioEQ vs the former float path, same shape (the float path clips instead of the headroom)
+static void legacyTest(int g0, int g1, int g2, double fs)
+{
+    AudioEQ eq;
+    eq.setSampleRate((uint32_t)fs);
+    eq.setGain(64, 64);
+    eq.setBand(0, EQ_LOWSHELF, 500, g0);
+    eq.setBand(1, EQ_PEAK, 3000, g1, 2.5);
+    eq.setBand(2, EQ_HIGHSHELF, 6000, g2);
+    LegacyTone lt;
+    lt.setup(fs, g0, g1, g2, 64);
+    double worst = 0, hr = 20 * log10(eq.getHeadroom());
+    for (size_t k = 0; k < sizeof(testFreq) / sizeof(testFreq[0]); k++) {
+        double f = onBin(testFreq[k], fs);
+        if (f > 0.45 * fs) continue;
+        double a = measureLegacy(lt, fs, f), b = measureEq(eq, fs, f);
+        if (a < 8) continue;
+        double d = 20 * log10(b / a) - hr;
+        if (fabs(d) > fabs(worst)) worst = d;
+    }
+    check(fabs(worst) < 0.1, "setTone(%3d,%3d,%3d) vs float path %5.1f kHz  max difference %+6.3f dB", g0, g1, g2, fs / 1000, worst);
+}
+
+static void noiseTest()
+{
+    AudioEQ eq;
+    eq.setSampleRate(48000);
+    eq.setGain(64, 64);
+    eq.setBand(0, EQ_LOWSHELF, 500, 6);
+    eq.setLoudness(30);
+
+    std::vector<int16_t> s(2 * 48000, 0);
+    for (size_t i = 0; i < s.size() / 2; i += EQ_BLOCK) eq.process(&s[2 * i], EQ_BLOCK);
+    bool silent = true;
+    for (size_t i = 0; i < s.size(); i++) if (s[i]) silent = false;
+    check(silent, "digital silence stays silent");
+
+    // volume 0 on one side (balance all the way): that channel silent, no dither noise, the other one plays
+    s = sine(48000, 1000, 48000, 10000);
+    eq.setGain(0, 64);
+    for (size_t i = 0; i < s.size() / 2; i += EQ_BLOCK) eq.process(&s[2 * i], EQ_BLOCK);
+    bool mutedL = true, playsR = false;
+    for (size_t i = 0; i < s.size() / 2; i++) {
+        if (s[2 * i]) mutedL = false;
+        if (s[2 * i + 1]) playsR = true;
+    }
+    check(mutedL && playsR, "muted channel stays silent (no dither)");
+    eq.setGain(64, 64);
+
+    // -60 dBFS sine at 1 kHz, residual after removing the tone = dither + filter noise
+    const double f = 1000, fs = 48000;
+    int n = 48000;
+    s = sine(fs, f, n, 33);
+    eq.reset();
+    for (int i = 0; i < n; i += EQ_BLOCK) eq.process(&s[2 * i], EQ_BLOCK);
+    double re = 0, im = 0, mean = 0;
+    int start = 8192, len = n - start;
+    for (int i = start; i < n; i++) {
+        re += s[2 * i] * cos(2 * M_PI * f * i / fs);
+        im += s[2 * i] * sin(2 * M_PI * f * i / fs);
+        mean += s[2 * i];
+    }
+    re *= 2.0 / len; im *= 2.0 / len; mean /= len;
+    double err = 0;
+    for (int i = start; i < n; i++) {
+        double r = s[2 * i] - mean - re * cos(2 * M_PI * f * i / fs) - im * sin(2 * M_PI * f * i / fs);
+        err += r * r;
+    }
+    double rms = sqrt(err / len);
+    check(fabs(mean) < 0.02, "dither DC %+.4f LSB (< 0.02)", mean);
+    check(rms > 0.3 && rms < 0.8, "noise floor %.2f LSB rms (%.1f dBFS), TPDF alone 0.41", rms, 20 * log10(rms / 32768));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void costTest(double fs)
+{
+    const int frames = (int)fs, block = EQ_BLOCK;
+    std::vector<int16_t> in(2 * frames), s;
+    uint32_t x = 12345;
+    for (size_t i = 0; i < in.size(); i++) { x ^= x << 13; x ^= x >> 17; x ^= x << 5; in[i] = (int16_t)(x >> 18) - 8192; }
+    volatile uint32_t sink = 0;
+
+    // both paths in the same round, best of 9: the host clock of a shared machine is noisy
+    double legacy = 1e300, block3 = 1e300, block7 = 1e300;
+    for (int r = 0; r < 9; r++) {
+        LegacyTone lt;
+        lt.setup(fs, 4, -6, 3, 48);
+        s = in;
+        double t0 = nowUs();
+        for (int i = 0; i < frames; i++) sink += lt.play(&s[2 * i]);
+        legacy = std::min(legacy, nowUs() - t0);
+
+        AudioEQ eq;
+        eq.setSampleRate((uint32_t)fs);
+        eq.setGain(48, 48);
+        eq.setBand(0, EQ_LOWSHELF, 500, 4);
+        eq.setBand(1, EQ_PEAK, 3000, -6, 2.5);
+        eq.setBand(2, EQ_HIGHSHELF, 6000, 3);
+        s = in;
+        eq.process(&s[0], block);                  // coefficients, outside the timing
+        t0 = nowUs();
+        for (int i = 0; i < frames; i += block) eq.process(&s[2 * i], std::min(block, frames - i));
+        block3 = std::min(block3, nowUs() - t0);
+
+        eq.setBand(3, EQ_PEAK, 120, 3, 1.0);
+        eq.setBand(4, EQ_HIGHPASS, 40, 0, 0.707);
+        eq.setLoudness(30);
+        s = in;
+        eq.process(&s[0], block);
+        t0 = nowUs();
+        for (int i = 0; i < frames; i += block) eq.process(&s[2 * i], std::min(block, frames - i));
+        block7 = std::min(block7, nowUs() - t0);
+        sink += s[0];
+    }
+    double blocks = (double)frames / block;
+    printf("  cost %4.1f kHz stereo, per %d frame block: per sample 3 biquads + gain %6.2f us | block 7 biquads %6.2f us\n",
+           fs / 1000, block, legacy / blocks, block7 / blocks);
+    check(block3 < legacy * 1.05, "block 3 biquads + dither %6.2f us, not slower than the former float path (%+.0f%%)",
+          block3 / blocks, 100 * (block3 / legacy - 1));
+}
+
+int main()
+{
+    static const Band tone1[] = { { EQ_LOWSHELF, 500, 6, 0.707 }, { EQ_PEAK, 3000, -10, 2.5 }, { EQ_HIGHSHELF, 6000, 4, 0.707 } };
+    static const Band tone2[] = { { EQ_LOWSHELF, 500, -40, 0.707 }, { EQ_PEAK, 3000, 6, 2.5 }, { EQ_HIGHSHELF, 6000, -20, 0.707 } };
+    static const Band para5[] = { { EQ_LOWSHELF, 80, 8, 0.707 }, { EQ_PEAK, 250, -6, 1.4 }, { EQ_PEAK, 1000, 3, 0.7 },
+                                  { EQ_PEAK, 4000, -4, 4.0 }, { EQ_HIGHSHELF, 12000, 12, 0.707 } };
+    static const Band passes[] = { { EQ_HIGHPASS, 60, 0, 0.707 }, { EQ_LOWPASS, 9000, 0, 0.9 } };
+    static const double rates[] = { 44100, 48000 };
+
+    printf("frequency response (AudioEQ vs double design)\n");
+    for (int r = 0; r < 2; r++) {
+        double fs = rates[r];
+        responseTest("flat", NULL, 0, 100, fs);
+        responseTest("setTone(6,-10,4)", tone1, 3, 100, fs);
+        responseTest("setTone(-40,6,-20)", tone2, 3, 100, fs);
+        responseTest("5 bands, +8/+12 dB", para5, 5, 100, fs);
+        responseTest("high/low pass", passes, 2, 100, fs);
+        responseTest("loudness 30%", NULL, 0, 30, fs);
+        responseTest("loudness 0% + 5 bands", para5, 5, 0, fs);
+    }
+    printf("former float path\n");
+    for (int r = 0; r < 2; r++) {
+        legacyTest(6, -10, 4, rates[r]);
+        legacyTest(-12, 6, -20, rates[r]);
+        legacyTest(3, 3, 3, rates[r]);
+    }
+    printf("noise\n");
+    noiseTest();
+    printf("cost\n");
+    costTest(44100);
+    costTest(48000);
+
+    printf("%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,2 @@
+// Host build: arduino-esp32 <SD_MMC.h>, see audio_host.h
+#include "../audio_host.h"
@@ -0,0 +1,2 @@
+// Host build: arduino-esp32 <WiFiClientSecure.h>, see audio_host.h
+#include "../audio_host.h"
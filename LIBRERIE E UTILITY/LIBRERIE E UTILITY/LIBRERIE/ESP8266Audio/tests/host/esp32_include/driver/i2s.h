@@ -0,0 +1,2 @@
+// Host build: ESP-IDF <driver/i2s.h>, see audio_host.h
+#include "../../audio_host.h"
@@ -0,0 +1,154 @@
+// Host check of gapless playback in the ESP32-audioI2S Audio class (Audio.cpp: queueFS(), switchToNext(),
+// trimSamples()) with the bundled mp3 decoder, files read from additional_info/Testfiles and the examples
+//
+//  - trim: a file played with skip/total gives exactly the samples [skip, skip + total) of the untrimmed decode
+//  - gapless: A then B queued: the decoder output is trim(A) followed by trim(B) sample for sample, the I2S got
+//    every frame of A before the first one of B and nothing in between (gap 0 samples: no silence, no DMA
+//    clear), the I2S reclocked only for B's rate, audio_next_mp3() once, audio_eof_mp3() only at the end of B
+//  - short I2S writes (full DMA): the rest of the block is written again, the I2S gets every frame
+//  - a queued file that can't be opened: getSwitchCount() unchanged, A ends with a normal eof
+//  - getGapSamples(): a 250 ms stall at the switch, counted at the I2S clock (48 kHz output, A resampled from 44.1 kHz);
+//    the ID3 parser doesn't sleep while the old file's DMA tail drains
+//
+//   make gapless && ./gapless          exit code 1 if a check fails
+
+#include <Arduino.h>
+#include <vector>
+#include <string>
+#include "Audio.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%s ", ok ? "  ok  " : "FAILED");
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+    if (!ok) failures++;
+}
+
+static const char *FILE_A = "/ESP32-audioI2S-master/additional_info/Testfiles/wobble.mp3";
+static const char *FILE_B = "/ESP8266Audio/examples/PlayMP3FromSPIFFS/data/pno-cs.mp3";
+
+static Audio *audio;
+
+// Uscita dei decoder dopo la rifilatura (prima di EQ e dither), e I2S
+static std::vector<int16_t> pcm;
+static uint8_t pcmChannels = 0;
+static uint32_t nextCalls = 0, eofCalls = 0;
+static size_t pcmAtSwitch = 0, i2sAtSwitch = 0, zeroAtSwitch = 0;
+static uint32_t stallAtSwitchMs = 0;
+
+void audio_process_extern(int16_t *buff, uint16_t len, bool *continueI2S)
+{
+    pcmChannels = audio->getChannels();
+    pcm.insert(pcm.end(), buff, buff + len * pcmChannels);
+    *continueI2S = true;
+}
+
+void audio_next_mp3(const char *)
+{
+    nextCalls++;
+    pcmAtSwitch = pcm.size();
+    i2sAtSwitch = hostI2sOut.size();
+    zeroAtSwitch = hostI2sZeroCalls;
+    delay(stallAtSwitchMs);             // Lettura lenta della SD nel passaggio
+}
+
+void audio_eof_mp3(const char *) { eofCalls++; }
+
+static void play(const char *path, uint32_t skip = 0, uint32_t total = 0, const char *queued = nullptr,
+                 uint32_t qSkip = 0, uint32_t qTotal = 0)
+{
+    pcm.clear();
+    nextCalls = eofCalls = 0;
+    if (!audio->connecttoFS(SD, path, 0, skip, total)) {
+        check(false, "connecttoFS(%s)", path);
+        return;
+    }
+    hostI2sOut.clear();                 // setDefaults() ha svuotato il DMA del brano precedente
+    if (queued) audio->queueFS(SD, queued, 0, qSkip, qTotal);
+    for (long guard = 0; audio->isRunning() && guard < 10000000; guard++) audio->loop();
+}
+
+static size_t frames(size_t samples) { return pcmChannels ? samples / pcmChannels : 0; }
+
+static bool same(const int16_t *a, const int16_t *b, size_t n) { return memcmp(a, b, n * sizeof(int16_t)) == 0; }
+
+int main()
+{
+    hostFsRoot = "../../..";
+    audio = new Audio();
+
+    play(FILE_A);
+    std::vector<int16_t> refA = pcm;
+    uint8_t chA = pcmChannels;
+    uint32_t rateA = audio->getSampleRate();
+    play(FILE_B);
+    std::vector<int16_t> refB = pcm;
+    uint8_t chB = pcmChannels;
+    uint32_t rateB = audio->getSampleRate();
+    check(refA.size() > 44100 && refB.size() > 44100 && eofCalls == 1,
+          "reference decodes: A %u frames %u Hz %u ch, B %u frames %u Hz %u ch", (unsigned)(refA.size() / chA), rateA, chA,
+          (unsigned)(refB.size() / chB), rateB, chB);
+
+    // Rifilatura LAME: ritardo encoder + decoder all'inizio, riempimento alla fine
+    const uint32_t skipA = 576 + 529, totalA = refA.size() / chA - skipA - 1000;
+    const uint32_t skipB = 1105, totalB = refB.size() / chB - skipB - 700;
+    play(FILE_A, skipA, totalA);
+    check(pcm.size() == totalA * chA && same(pcm.data(), refA.data() + skipA * chA, pcm.size()),
+          "trim: skip %u total %u -> %u frames, identical to the untrimmed decode", skipA, totalA, (unsigned)(pcm.size() / chA));
+    std::vector<int16_t> i2sA = hostI2sOut;
+
+    // DMA pieno: i2s_write() accetta 50 frame per chiamata (un blocco EQ_BLOCK e' 128), il resto va riscritto, non perso.
+    // Il dither dell'EQ cambia a ogni esecuzione: stesso numero di frame, campioni entro +-2 LSB
+    hostI2sMaxBytes = 200;
+    play(FILE_A, skipA, totalA);
+    hostI2sMaxBytes = 0;
+    size_t worst = hostI2sOut.size() == i2sA.size() ? 0 : 65535;
+    for (size_t i = 0; !worst && i < i2sA.size(); i++) worst = std::max(worst, (size_t)abs(hostI2sOut[i] - i2sA[i]));
+    check(worst <= 2, "short writes: %u I2S frames (%u with whole writes), max difference %u LSB",
+          (unsigned)(hostI2sOut.size() / 2), (unsigned)(i2sA.size() / 2), (unsigned)worst);
+
+    // A e poi B in coda
+    uint32_t switches = audio->getSwitchCount(), rateChanges = hostI2sRateChanges;
+    play(FILE_A, skipA, totalA, FILE_B, skipB, totalB);
+    bool sameA = pcmAtSwitch == totalA * chA && same(pcm.data(), refA.data() + skipA * chA, pcmAtSwitch);
+    bool sameB = pcm.size() - pcmAtSwitch == totalB * chB && same(pcm.data() + pcmAtSwitch, refB.data() + skipB * chB, totalB * chB);
+    check(sameA && sameB, "gapless: output is trim(A) + trim(B) sample for sample (%u + %u frames)",
+          (unsigned)frames(pcmAtSwitch), (unsigned)frames(pcm.size() - pcmAtSwitch));
+    check(nextCalls == 1 && eofCalls == 1 && audio->getSwitchCount() == switches + 1,
+          "gapless: audio_next_mp3 %u, audio_eof_mp3 %u (end of B only)", nextCalls, eofCalls);
+    // I2S: al passaggio tutto A e' gia' scritto, poi B e infine il DMA svuotato a fine file (dma_buf_len frame)
+    size_t i2sFrames = hostI2sOut.size() / 2;
+    check(i2sAtSwitch / 2 == totalA && i2sFrames == (size_t)totalA + totalB + 1024 && zeroAtSwitch == hostI2sZeroCalls - 1,
+          "gapless: I2S %u frames at the switch, %u in all, gap %u samples", (unsigned)(i2sAtSwitch / 2), (unsigned)i2sFrames,
+          (unsigned)(i2sFrames - 1024 - totalA - totalB));
+    // A 44.1 kHz, B 48 kHz: senza setOutputRate() l'I2S cambia clock una volta sola, per B
+    check(hostI2sRateChanges - rateChanges == (rateA != rateB ? 1u : 0u), "gapless: I2S reclocked %u time(s) for %u -> %u Hz",
+          hostI2sRateChanges - rateChanges, rateA, rateB);
+
+    // File in coda che non si apre: nessun passaggio, fine normale di A
+    switches = audio->getSwitchCount();
+    play(FILE_A, skipA, totalA, "/nonexistent.mp3");
+    check(audio->getSwitchCount() == switches && nextCalls == 0 && eofCalls == 1 && pcm.size() == totalA * chA,
+          "missing queued file: no switch, A played to its normal eof");
+
+    // Stallo di 250 ms al passaggio con l'I2S a 48 kHz: la coda DMA (7 x 1024 frame) copre i primi 149 ms
+    audio->setOutputRate(48000);
+    stallAtSwitchMs = 250;
+    rateChanges = hostI2sRateChanges;
+    play(FILE_A, skipA, totalA, FILE_B, skipB, totalB);
+    uint32_t expect = 250 * 48000 / 1000 - 7 * 1024;
+    check(hostI2sRate == 48000 && hostI2sRateChanges == rateChanges, "fixed output rate: I2S at %u Hz, %u reclocking(s)",
+          hostI2sRate, hostI2sRateChanges - rateChanges);
+    check(audio->getGapSamples() == expect, "gap at the I2S clock: %u samples after a 250 ms stall (expected %u)",
+          audio->getGapSamples(), expect);
+
+    delete audio;
+    printf("%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,2 @@
+// Host stub: the PROGMEM/pgm_read_* emulation lives in Arduino.h
+#include "Arduino.h"
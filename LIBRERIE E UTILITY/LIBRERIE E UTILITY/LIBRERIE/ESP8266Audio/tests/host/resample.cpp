@@ -0,0 +1,260 @@
+// Host check of the ESP32-audioI2S polyphase resampler (src/resample/audio_resample.cpp)
+//
+//  - THD+N: a sine converted from every source rate (arcade, announcements, web radio, 96k streams)
+//    to 44.1/48 kHz, against the ideal sine at the output rate (least squares fit, residual = THD+N),
+//    next to a linear interpolator as used before for rate matching
+//  - passband flatness up to 0.3/0.4 * the lower rate (preset), image/alias level of a tone at the top of the band
+//  - feeding in odd block sizes gives the same output as one large block
+//  - throughput per preset, as output frames per CPU second and share of one host core at the output rate
+//
+//   make resample && ./resample          exit code 1 if a check fails
+
+#include <Arduino.h>
+#include <math.h>
+#include <time.h>
+#include <vector>
+#include "resample/audio_resample.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%s ", ok ? "  ok  " : "FAILED");
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+    if (!ok) failures++;
+}
+
+static double nowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static const char *presetName[] = { "fast", "balanced", "best" };
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static std::vector<int16_t> sine(double fs, double f, int frames, double amp)
+{
+    std::vector<int16_t> s(2 * frames);
+    for (int i = 0; i < frames; i++) s[2 * i] = s[2 * i + 1] = (int16_t)lrint(amp * sin(2 * M_PI * f * i / fs));
+    return s;
+}
+
+// Whole signal through the resampler in blocks of `block` input frames (EQ_BLOCK in Audio::playBlock())
+static std::vector<int16_t> convert(AudioResampler &rs, const std::vector<int16_t> &in, int block)
+{
+    std::vector<int16_t> out;
+    int16_t buf[128 * 2];
+    size_t frames = in.size() / 2, done = 0;
+    while (done < frames) {
+        uint16_t n = (uint16_t)std::min((size_t)block, frames - done), pos = 0;
+        while (pos < n) {
+            uint16_t used = 0;
+            uint16_t k = rs.process(&in[2 * (done + pos)], n - pos, &used, buf, 128);
+            out.insert(out.end(), buf, buf + 2 * k);
+            pos += used;
+        }
+        done += n;
+    }
+    for (;;) {                                          // what the history still gives
+        uint16_t used = 0, k = rs.process(NULL, 0, &used, buf, 128);
+        if (!k) break;
+        out.insert(out.end(), buf, buf + 2 * k);
+    }
+    return out;
+}
+
+// Former rate matching: linear interpolation with a Q32 position
+static std::vector<int16_t> linear(const std::vector<int16_t> &in, double inRate, double outRate)
+{
+    std::vector<int16_t> out;
+    uint64_t step = (uint64_t)(inRate / outRate * 4294967296.0), pos = 0;
+    size_t frames = in.size() / 2;
+    while ((pos >> 32) + 1 < frames) {
+        size_t i = pos >> 32;
+        int32_t f = (uint32_t)pos >> 17;
+        for (int ch = 0; ch < 2; ch++) out.push_back((int16_t)(in[2 * i + ch] + (((in[2 * i + 2 + ch] - in[2 * i + ch]) * f) >> 15)));
+        pos += step;
+    }
+    return out;
+}
+
+// Fit a*sin + b*cos + c at f over the middle of the left channel, returns tone amplitude, residual rms in *res
+static double fitTone(const std::vector<int16_t> &s, double fs, double f, double *res)
+{
+    size_t n = s.size() / 2, start = n / 8, len = n - 2 * start;
+    // normal equations of a 3 parameter least squares fit
+    double A[3][3] = {{0}}, B[3] = {0};
+    for (size_t i = start; i < start + len; i++) {
+        double v[3] = { sin(2 * M_PI * f * i / fs), cos(2 * M_PI * f * i / fs), 1 };
+        for (int r = 0; r < 3; r++) {
+            for (int c = 0; c < 3; c++) A[r][c] += v[r] * v[c];
+            B[r] += v[r] * s[2 * i];
+        }
+    }
+    for (int k = 0; k < 3; k++) {                       // Gauss, the matrix is well conditioned
+        for (int r = k + 1; r < 3; r++) {
+            double m = A[r][k] / A[k][k];
+            for (int c = k; c < 3; c++) A[r][c] -= m * A[k][c];
+            B[r] -= m * B[k];
+        }
+    }
+    double x[3];
+    for (int r = 2; r >= 0; r--) {
+        x[r] = B[r];
+        for (int c = r + 1; c < 3; c++) x[r] -= A[r][c] * x[c];
+        x[r] /= A[r][r];
+    }
+    double err = 0;
+    for (size_t i = start; i < start + len; i++) {
+        double d = s[2 * i] - x[0] * sin(2 * M_PI * f * i / fs) - x[1] * cos(2 * M_PI * f * i / fs) - x[2];
+        err += d * d;
+    }
+    *res = sqrt(err / len);
+    return sqrt(x[0] * x[0] + x[1] * x[1]);
+}
+
+static double thdn(const std::vector<int16_t> &s, double fs, double f)
+{
+    double res, a = fitTone(s, fs, f, &res);
+    return 20 * log10(res / (a / sqrt(2)));
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static const uint32_t inRates[] = { 8000, 11025, 16000, 22050, 24000, 32000, 44100, 48000, 88200, 96000 };
+static const uint32_t outRates[] = { 44100, 48000 };
+static const double   limit1k[] = { -70, -87, -91.5 };  // THD+N of 1 kHz at -3 dBFS, 16 bit output floor is about -95 dB
+
+static void qualityTest()
+{
+    const double amp = 32767 * 0.7079;                   // -3 dBFS
+    printf("THD+N of 1 kHz -3 dBFS, dB (linear interpolation | fast | balanced | best)\n");
+    for (size_t o = 0; o < sizeof(outRates) / sizeof(outRates[0]); o++) {
+        for (size_t r = 0; r < sizeof(inRates) / sizeof(inRates[0]); r++) {
+            uint32_t in = inRates[r], out = outRates[o];
+            if (in == out) continue;
+            std::vector<int16_t> src = sine(in, 1000, in, amp);
+            double lin = thdn(linear(src, in, out), out, 1000), q[3];
+            uint8_t taps[3];
+            bool exact = true;
+            for (int p = RS_FAST; p <= RS_BEST; p++) {
+                AudioResampler rs;
+                rs.setQuality(p);
+                rs.setRates(in, out);
+                q[p] = thdn(convert(rs, src, 128), out, 1000);
+                taps[p] = rs.getTaps();
+                exact = rs.isExact();
+            }
+            bool ok = q[0] <= limit1k[0] && q[1] <= limit1k[1] && q[2] <= limit1k[2];
+            check(ok, "%5u -> %5u  %-6s %6.1f | %6.1f | %6.1f | %6.1f   taps %u/%u/%u", in, out, exact ? "exact" : "interp",
+                  lin, q[0], q[1], q[2], taps[0], taps[1], taps[2]);
+        }
+    }
+}
+
+// Flatness up to the top of the passband and image/alias rejection (THD+N of a tone there)
+static void bandTest()
+{
+    static const double band[] = { 0.3, 0.4, 0.4 };      // top of the passband, part of min(in, out)
+    static const double flat[] = { 0.01, 0.01, 0.03 };   // dB, best 96k -> 48k: kernel capped at RS_MAX_TAPS
+    static const double high[] = { -70, -82, -90 };       // THD+N at the top of the band, -6 dBFS: 16 bit floor -92 dB
+    static const uint32_t pairs[][2] = { { 24000, 48000 }, { 44100, 48000 }, { 22050, 44100 }, { 11025, 48000 }, { 48000, 44100 }, { 96000, 48000 } };
+    const double amp = 32767 * 0.5;
+    printf("passband and images\n");
+    for (int p = RS_FAST; p <= RS_BEST; p++) {
+        for (size_t k = 0; k < sizeof(pairs) / sizeof(pairs[0]); k++) {
+            uint32_t in = pairs[k][0], out = pairs[k][1];
+            double top = band[p] * std::min(in, out), worst = 0;
+            for (double f = 100; f <= top + 1; f += (top - 100) / 10) {
+                AudioResampler rs;
+                rs.setQuality(p);
+                rs.setRates(in, out);
+                double res, a = fitTone(convert(rs, sine(in, f, in / 2, amp), 128), out, f, &res);
+                double d = 20 * log10(a / amp);
+                if (fabs(d) > fabs(worst)) worst = d;
+            }
+            AudioResampler rs;
+            rs.setQuality(p);
+            rs.setRates(in, out);
+            double t = thdn(convert(rs, sine(in, top, in / 2, amp), 128), out, top);
+            check(fabs(worst) <= flat[p] && t <= high[p], "%-8s %5u -> %5u  ripple to %5.0f Hz %+6.3f dB   THD+N at %5.0f Hz %6.1f dB",
+                  presetName[p], in, out, top, worst, top, t);
+        }
+    }
+}
+
+static void blockTest()
+{
+    static const uint32_t pairs[][2] = { { 24000, 44100 }, { 11025, 48000 }, { 96000, 44100 }, { 44100, 48000 } };
+    bool same = true;
+    for (size_t k = 0; k < sizeof(pairs) / sizeof(pairs[0]); k++) {
+        std::vector<int16_t> src(2 * 20000);
+        uint32_t x = 777;
+        for (size_t i = 0; i < src.size(); i++) { x ^= x << 13; x ^= x >> 17; x ^= x << 5; src[i] = (int16_t)(x >> 16); }
+        AudioResampler a, b;
+        a.setQuality(RS_BALANCED); a.setRates(pairs[k][0], pairs[k][1]);
+        b.setQuality(RS_BALANCED); b.setRates(pairs[k][0], pairs[k][1]);
+        std::vector<int16_t> one = convert(a, src, 128), odd;
+        // odd input blocks, small output buffer, then the history
+        size_t done = 0;
+        int16_t buf[7 * 2];
+        for (int i = 0; done < src.size() / 2; i++) {
+            uint16_t n = (uint16_t)std::min((size_t)(1 + (i * 37) % 101), src.size() / 2 - done), pos = 0;
+            while (pos < n) {
+                uint16_t used = 0, m = b.process(&src[2 * (done + pos)], n - pos, &used, buf, 7);
+                odd.insert(odd.end(), buf, buf + 2 * m);
+                pos += used;
+            }
+            done += n;
+        }
+        for (uint16_t used, m; (m = b.process(NULL, 0, &used, buf, 7)); ) odd.insert(odd.end(), buf, buf + 2 * m);
+        if (odd != one) same = false;
+    }
+    check(same, "odd block sizes give the same output as 128 frame blocks");
+}
+
+static void speedTest()
+{
+    static const uint32_t pairs[][2] = { { 24000, 48000 }, { 44100, 48000 }, { 22050, 44100 }, { 16000, 44100 }, { 96000, 48000 } };
+    printf("throughput, output frames per CPU second (stereo), share of one host core at the output rate\n");
+    for (size_t k = 0; k < sizeof(pairs) / sizeof(pairs[0]); k++) {
+        uint32_t in = pairs[k][0], out = pairs[k][1];
+        std::vector<int16_t> src = sine(in, 997, in * 2, 20000);
+        printf("  %5u -> %5u ", in, out);
+        for (int p = RS_FAST; p <= RS_BEST; p++) {
+            AudioResampler rs;
+            rs.setQuality(p);
+            rs.setRates(in, out);
+            double best = 1e300;
+            size_t frames = 0;
+            for (int r = 0; r < 5; r++) {
+                rs.reset();
+                double t0 = nowUs();
+                frames = convert(rs, src, 128).size() / 2;
+                best = std::min(best, nowUs() - t0);
+            }
+            double fps = frames / best * 1e6;
+            printf(" | %-8s %6.1f M/s %5.2f%%", presetName[p], fps / 1e6, 100.0 * out / fps);
+        }
+        double t0 = nowUs();
+        size_t frames = linear(src, in, out).size() / 2;
+        printf(" | linear %6.1f M/s\n", frames / (nowUs() - t0));
+    }
+}
+
+int main()
+{
+    qualityTest();
+    bandTest();
+    blockTest();
+    speedTest();
+    printf("%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
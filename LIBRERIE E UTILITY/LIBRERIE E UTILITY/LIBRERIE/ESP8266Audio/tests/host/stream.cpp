@@ -0,0 +1,225 @@
+// Host check of the live stream handling in the ESP32-audioI2S Audio class (Audio.cpp: processWebStream(),
+// softReconnect(), storeStreamTail(), resyncStream(), streamFillBytes()) against a scripted Icecast server:
+// the mp3 frames of a file are sent in real time (hostMicros), every connection starts with a burst of the
+// last bytes already sent, and the network freezes, closes or refuses connections on cue
+//
+//  - threshold: the start fill is 500 ms + 2 x jitter at the stream bitrate, after an underrun
+//    2 s + 4 x jitter + 1 s per underrun
+//  - stall: no data for 3 s -> soft reconnect, the burst is skipped up to the last bytes received: the decoder
+//    output is the untrimmed decode of the file sample for sample, nothing repeated, nothing lost
+//  - closed connection: the same without waiting for the stall timeout
+//  - refused reconnects: retried every 3 s, the station name is not blanked, resynced in a bigger burst
+//    (after the underrun, with nothing left to play, the whole burst is searched)
+//  - no burst (the tail is not sent again): joins at the live edge a second after the first bytes, no resync
+//    counted, and plays on
+//
+//   make stream && ./stream          exit code 1 if a check fails
+
+#include <Arduino.h>
+#include <vector>
+#include <string>
+#include "Audio.h"
+
+static int failures = 0;
+
+static void check(bool ok, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%s ", ok ? "  ok  " : "FAILED");
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+    if (!ok) failures++;
+}
+
+static const char *FILE_MP3 = "/ESP8266Audio/examples/PlayMP3FromSPIFFS/data/pno-cs.mp3";   // 128 kbit/s CBR
+
+static Audio *audio;
+
+static std::vector<int16_t> pcm;
+static uint32_t blankStation = 0;
+static std::string station;
+
+void audio_process_extern(int16_t *buff, uint16_t len, bool *continueI2S)
+{
+    pcm.insert(pcm.end(), buff, buff + len * audio->getChannels());
+    *continueI2S = true;
+}
+
+void audio_showstation(const char *s)
+{
+    if (!*s) blankStation++;
+    else station = s;
+}
+
+// ===== Server =====
+// La sorgente "dal vivo" avanza con l'orologio: al tempo t sono stati prodotti rate * t byte del file
+static std::vector<uint8_t> frames;        // file senza il tag ID3
+static const uint32_t RATE = 16;           // byte/ms a 128 kbit/s
+static uint64_t liveStart = 0;
+static size_t burst = 65536;               // byte gia' inviati ripetuti all'inizio di ogni connessione
+static uint64_t freezeFrom = 0, freezeTo = 0;   // rete ferma (ms dall'inizio), la sorgente continua
+static uint64_t closeAt = 0;               // il server chiude la connessione (una volta)
+static uint32_t refuse = 0;                // connessioni rifiutate dopo la prima
+static size_t connPos = 0;                 // prossimo byte del file per questa connessione
+static uint32_t connections = 0;
+
+static uint64_t nowMs() { return (hostMicros - liveStart) / 1000; }
+static size_t livePos() { return std::min((size_t)(nowMs() * RATE), frames.size()); }
+
+static bool serverConnect(WiFiClient *c, const char *, uint16_t)
+{
+    if (connections++ && refuse) {
+        refuse--;
+        return false;
+    }
+    c->hostSend("ICY 200 OK\r\ncontent-type: audio/mpeg\r\nicy-name: Host Radio\r\nicy-br: 128\r\n\r\n");
+    size_t live = livePos();
+    connPos = (connections > 1 && live > burst) ? live - burst : 0;   // il primo ascoltatore dall'inizio
+    return true;
+}
+
+static void serverPoll(WiFiClient *c)
+{
+    uint64_t t = nowMs();
+    if (closeAt && t >= closeAt) {
+        closeAt = 0;
+        c->hostOpen = false;
+        return;
+    }
+    if (t >= freezeFrom && t < freezeTo) return;
+    size_t live = livePos();
+    if (live > connPos) {
+        c->hostSend(frames.data() + connPos, live - connPos);
+        connPos = live;
+    }
+}
+
+// ===== Run =====
+struct Run {
+    uint32_t startFill = 0;                // soglia al primo "stream ready"
+    uint32_t jitterAtStart = 0;
+    bool rebufferOk = true;                // soglia dopo l'underrun coerente con il jitter misurato
+    uint32_t rebufferFill = 0, rebufferJitter = 0;
+};
+
+static Run play(uint64_t seconds)
+{
+    Run r;
+    pcm.clear();
+    blankStation = 0;
+    station.clear();
+    connections = 0;
+    liveStart = hostMicros;
+    audio->connecttohost("http://radio.host/stream");
+    bool wasBuffering = true;
+    while (audio->isRunning() && nowMs() < seconds * 1000) {
+        audio->loop();
+        delay(1);                           // audioTask: vTaskDelay tra le chiamate
+        Audio::streamHealth_t h = audio->getStreamHealth();
+        if (wasBuffering && !h.buffering && !r.startFill && h.underruns == 0) {
+            r.startFill = h.startFill;
+            r.jitterAtStart = h.jitterMs;
+        }
+        if (h.buffering && h.underruns == 1) {
+            uint32_t ms = constrain(2000 + 4 * h.jitterMs + 1000, 2000u, 15000u);
+            uint32_t expect = std::min(RATE * ms, (h.size) / 4 * 3);
+            if (h.startFill != expect) r.rebufferOk = false;
+            r.rebufferFill = h.startFill;
+            r.rebufferJitter = h.jitterMs;
+        }
+        wasBuffering = h.buffering;
+    }
+    audio->stopSong();
+    return r;
+}
+
+// Il flusso parte dal primo frame: l'uscita e' un prefisso dello stream decodificato da file
+static size_t matched(const std::vector<int16_t> &ref)
+{
+    size_t n = std::min(pcm.size(), ref.size());
+    size_t i = 0;
+    while (i < n && pcm[i] == ref[i]) i++;
+    return i;
+}
+
+int main()
+{
+    hostFsRoot = "../../..";
+    audio = new Audio();
+
+    // Decodifica di riferimento dal file, e i frame senza il tag ID3v2 per il server
+    audio->connecttoFS(SD, FILE_MP3);
+    for (long guard = 0; audio->isRunning() && guard < 10000000; guard++) audio->loop();
+    std::vector<int16_t> ref = pcm;
+    FILE *f = fopen((std::string(hostFsRoot) + FILE_MP3).c_str(), "rb");
+    if (!f) { check(false, "open %s", FILE_MP3); return 1; }
+    std::vector<uint8_t> file;
+    uint8_t buf[4096];
+    for (size_t n; (n = fread(buf, 1, sizeof(buf), f)) > 0;) file.insert(file.end(), buf, buf + n);
+    fclose(f);
+    size_t id3 = 10 + ((file[6] & 0x7F) << 21 | (file[7] & 0x7F) << 14 | (file[8] & 0x7F) << 7 | (file[9] & 0x7F));
+    frames.assign(file.begin() + id3, file.end());
+    check(ref.size() > 48000 * 2 * 10, "reference decode: %u frames, stream %u bytes", (unsigned)(ref.size() / 2),
+          (unsigned)frames.size());
+
+    hostOnConnect = serverConnect;
+    hostOnPoll = serverPoll;
+    audio->setConnectionTimeout(500, 2700);
+
+    // Rete regolare: soglia iniziale 500 ms + 2 x jitter, nessuna riconnessione
+    freezeFrom = freezeTo = 0;
+    Run r = play(12);
+    Audio::streamHealth_t h = audio->getStreamHealth();
+    uint32_t expect = RATE * constrain(500 + 2 * r.jitterAtStart, 500u, 8000u);
+    check(r.startFill == expect, "threshold: start fill %u bytes with %u ms jitter (expected %u)", r.startFill, r.jitterAtStart, expect);
+    check(h.reconnects == 0 && h.underruns == 0 && matched(ref) == pcm.size() && pcm.size() > 48000 * 2 * 8,
+          "steady: %u frames played, identical to the file decode, no underrun", (unsigned)(pcm.size() / 2));
+
+    // Rete ferma 5 s a 4 s: underrun, riconnessione dopo 3 s, la raffica viene saltata fino all'ultimo byte ricevuto
+    freezeFrom = 4000; freezeTo = 9000;
+    r = play(20);
+    h = audio->getStreamHealth();
+    check(h.underruns == 1 && r.rebufferOk, "threshold: rebuffer %u bytes with %u ms jitter after the underrun",
+          r.rebufferFill, r.rebufferJitter);
+    check(h.reconnects == 1 && h.resyncs == 1, "stall: %u reconnect(s), %u resync(s)", h.reconnects, h.resyncs);
+    check(matched(ref) == pcm.size() && pcm.size() > 48000 * 2 * 14,
+          "stall: %u frames played, identical to the file decode (nothing repeated or lost)", (unsigned)(pcm.size() / 2));
+
+    // Il server chiude la connessione: riconnessione dopo 0,5 s, senza attendere i 3 s
+    freezeFrom = freezeTo = 0;
+    closeAt = 4000;
+    r = play(12);
+    h = audio->getStreamHealth();
+    check(h.reconnects == 1 && h.resyncs == 1 && matched(ref) == pcm.size() && pcm.size() > 48000 * 2 * 8,
+          "closed: %u reconnect(s), %u resync(s), %u frames identical", h.reconnects, h.resyncs, (unsigned)(pcm.size() / 2));
+
+    // Rete ferma 8 s e due riconnessioni rifiutate (a 3 s l'una dall'altra): il nome della stazione resta,
+    // la terza si aggancia in una raffica piu' lunga
+    freezeFrom = 4000; freezeTo = 12000;
+    refuse = 2;
+    burst = 196608;
+    r = play(22);                          // prima dello stallo a fine file
+    h = audio->getStreamHealth();
+    check(h.reconnects == 3 && h.resyncs == 1 && blankStation == 0 && station == "Host Radio",
+          "refused: %u reconnects, %u resync(s), station \"%s\" blanked %u time(s)", h.reconnects, h.resyncs,
+          station.c_str(), blankStation);
+    check(matched(ref) == pcm.size() && pcm.size() > 48000 * 2 * 12,
+          "refused: %u frames played, identical to the file decode", (unsigned)(pcm.size() / 2));
+    refuse = 0;
+
+    // Nessuna raffica: la coda non si ritrova, si riparte dal punto dal vivo
+    burst = 0;
+    freezeFrom = 4000; freezeTo = 9000;
+    r = play(20);
+    h = audio->getStreamHealth();
+    size_t before = matched(ref);
+    check(h.reconnects == 1 && h.resyncs == 0 && pcm.size() > before + 48000 * 2 * 3,
+          "no burst: joined live after %u identical frames, %u frames in all", (unsigned)(before / 2),
+          (unsigned)(pcm.size() / 2));
+
+    delete audio;
+    printf("%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
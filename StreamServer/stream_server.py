@@ -398,6 +398,7 @@ class StreamState:
         self.audio_output = "browser"  # "browser" o "esp32c3" - scelta esclusiva
         self.video_looped = False  # Flag che indica se il video e' appena ricominciato (per sync audio C3)
         self.c3_volume = 80  # Volume ESP32-C3 (0-100)
+        self.pcm_audio_start_ms = 0  # Tempo del video all'inizio dell'estrazione PCM (timestamp blocchi)
         self.c3_volume_changed = False  # Flag per segnalare cambio volume a ESP32-S3
         self.c3_audio_delay = 0.0  # Delay audio C3 in secondi (-5 a +5, negativo=audio in ritardo)
         # WebTV
@@ -660,12 +661,20 @@ def stream_thread():
 
     print("[STREAM] Thread terminato")
 
+def mjpeg_part(frame, timestamp_ms):
+    """Parte multipart MJPEG; X-Timestamp (ms del video) serve al lip-sync dell'audio Bluetooth"""
+    return (b'--frame\r\n'
+            b'Content-Type: image/jpeg\r\n'
+            b'X-Timestamp: ' + str(timestamp_ms).encode() + b'\r\n'
+            b'Content-Length: ' + str(len(frame)).encode() + b'\r\n\r\n' + frame + b'\r\n')
+
 def generate_mjpeg():
     """Generator per MJPEG stream - ottimizzato per TV live"""
     state.clients += 1
     print(f"[STREAM] Nuovo client connesso (totale: {state.clients})")
 
     last_sent_frame = None
+    last_sent_ts = 0
     pause_send_interval = 0.5
     last_buffer_id = None
     frame_interval = 1.0 / 25  # Target 25 FPS
@@ -676,9 +685,7 @@ def generate_mjpeg():
             # Quando in pausa
             if state.audio_muted and not state.tv_streaming:
                 if last_sent_frame:
-                    yield (b'--frame\r\n'
-                           b'Content-Type: image/jpeg\r\n'
-                           b'Content-Length: ' + str(len(last_sent_frame)).encode() + b'\r\n\r\n' + last_sent_frame + b'\r\n')
+                    yield mjpeg_part(last_sent_frame, last_sent_ts)
                 time.sleep(pause_send_interval)
                 continue
 
@@ -687,6 +694,7 @@ def generate_mjpeg():
             current_buffer_id = None
             with state.buffer_lock:
                 current_buffer_id = state.active_buffer
+                frame_ts = int(state.frame_count * 1000 / state.fps) if state.fps > 0 else 0
                 if current_buffer_id == 'a' and state.frame_buffer_a is not None:
                     frame = state.frame_buffer_a
                 elif current_buffer_id == 'b' and state.frame_buffer_b is not None:
@@ -701,18 +709,16 @@ def generate_mjpeg():
                     if current_buffer_id != last_buffer_id or (now - last_frame_time) > frame_interval:
                         last_buffer_id = current_buffer_id
                         last_sent_frame = frame
+                        last_sent_ts = frame_ts
                         last_frame_time = now
-                        yield (b'--frame\r\n'
-                               b'Content-Type: image/jpeg\r\n'
-                               b'Content-Length: ' + str(len(frame)).encode() + b'\r\n\r\n' + frame + b'\r\n')
+                        yield mjpeg_part(frame, frame_ts)
                 else:
                     # Video: invia solo frame nuovi
                     if current_buffer_id != last_buffer_id:
                         last_buffer_id = current_buffer_id
                         last_sent_frame = frame
-                        yield (b'--frame\r\n'
-                               b'Content-Type: image/jpeg\r\n'
-                               b'Content-Length: ' + str(len(frame)).encode() + b'\r\n\r\n' + frame + b'\r\n')
+                        last_sent_ts = frame_ts
+                        yield mjpeg_part(frame, frame_ts)
 
             time.sleep(0.008)  # ~120 check/secondo
     finally:
@@ -2500,8 +2506,11 @@ def start_audio_pcm_extraction(seek_time=None):
     cmd = [FFMPEG_PATH, '-y']
 
     # Aggiungi seek PRIMA dell'input per sincronizzazione
+    # Il timestamp dei blocchi PCM parte dal punto di seek (tempo del video, come X-Timestamp)
+    state.pcm_audio_start_ms = 0
     if seek_time and seek_time > 0.5:
         cmd.extend(['-ss', f'{seek_time:.2f}'])
+        state.pcm_audio_start_ms = int(round(seek_time, 2) * 1000)
         print(f"[AUDIO-PCM] Sincronizzazione a {seek_time:.2f} secondi")
 
     cmd.extend([
@@ -2585,13 +2594,14 @@ def generate_audio_pcm_stream():
 
                 chunk = state.pcm_audio_process.stdout.read(chunk_size)
                 if chunk:
-                    # Calcola timestamp corrente in ms
-                    current_timestamp = int((bytes_sent / target_bytes_per_second) * 1000)
+                    # Calcola timestamp corrente in ms (tempo del video)
+                    current_timestamp = state.pcm_audio_start_ms + int((bytes_sent / target_bytes_per_second) * 1000)
 
-                    # Invia header con timestamp (4 bytes) + dati audio
-                    # Formato: [TIMESTAMP_MS (4 bytes big-endian)] [PCM_DATA]
-                    timestamp_header = current_timestamp.to_bytes(4, 'big')
-                    yield timestamp_header + chunk
+                    # Invia header con timestamp e lunghezza + dati audio
+                    # Formato: [TIMESTAMP_MS (4 bytes big-endian)] [LUNGHEZZA (4 bytes big-endian)] [PCM_DATA]
+                    # La lunghezza permette al client di ritrovare l'header successivo anche dopo un blocco corto
+                    header = current_timestamp.to_bytes(4, 'big') + len(chunk).to_bytes(4, 'big')
+                    yield header + chunk
 
                     bytes_sent += len(chunk)
 
@@ -2640,7 +2650,7 @@ def audio_pcm():
             'Content-Type': 'audio/x-raw;rate=44100;channels=2;format=S16LE',
             'Cache-Control': 'no-cache, no-store',
             'Connection': 'close',
-            'X-Audio-Sync': 'timestamp-header',  # Indica che ogni chunk ha header timestamp
+            'X-Audio-Sync': 'timestamp-length-header',  # Ogni chunk ha header timestamp + lunghezza
         }
     )
 
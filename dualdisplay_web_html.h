@@ -392,6 +392,14 @@ const char DUALDISPLAY_HTML[] PROGMEM = R"rawliteral(
             <span class="s-label">Risoluzione virtuale</span>
             <span class="s-value accent" id="virtualRes">480 x 480</span>
           </div>
+          <div class="stat-row">
+            <span class="s-label">Offset orologio</span>
+            <span class="s-value" id="clockOffset">-</span>
+          </div>
+          <div class="stat-row">
+            <span class="s-label">Skew pannelli</span>
+            <span class="s-value accent" id="panelSkew">-</span>
+          </div>
         </div>
       </div>
     </div>
@@ -570,6 +578,11 @@ const char DUALDISPLAY_HTML[] PROGMEM = R"rawliteral(
       document.getElementById('peerOnline').textContent=onPeers+' / '+totalPeers;
       document.getElementById('virtualRes').textContent=S.virtualW+' x '+S.virtualH;
       document.getElementById('frameCount').textContent=S.frameCounter.toLocaleString('it-IT');
+      const ck=S.clock;
+      if(ck){
+        document.getElementById('clockOffset').textContent=S.role===2?(ck.synced?(ck.offsetUs/1000).toFixed(2)+' ms (rtt '+(ck.rttUs/1000).toFixed(1)+', jitter '+(ck.jitterUs/1000).toFixed(2)+')':'in aggancio...'):'riferimento';
+        document.getElementById('panelSkew').textContent=S.role===1?(ck.skewUs/1000).toFixed(2)+' ms (anticipo '+(ck.leadUs/1000).toFixed(1)+')':(ck.presentErrUs/1000).toFixed(2)+' ms';
+      }
 
       // Advanced dropdowns (only if not focused)
       const sl=document.getElementById('selLayout');
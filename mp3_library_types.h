@@ -0,0 +1,68 @@
+#ifndef MP3_LIBRARY_TYPES_H
+#define MP3_LIBRARY_TYPES_H
+
+#include <Arduino.h>
+
+// ================== DEFINIZIONI TIPI PER LA LIBRERIA MP3 (31_MP3_LIBRARY.ino) ==================
+// Il record dell'indice sta in un header perche' e' usato nelle firme delle funzioni della
+// libreria e del lettore, e i prototipi generati dall'IDE finiscono in cima allo sketch.
+// Il layout e' anche il formato del file su SD: cambiarlo richiede MP3_INDEX_VERSION + 1.
+
+#define MP3_FOLDER "/MP3"           // Cartella sulla SD dove cercare i file
+
+enum AudioFileType {
+  AUDIO_TYPE_MP3,
+  AUDIO_TYPE_WAV
+};
+
+#define MP3_INDEX_MAGIC       0x5833504DUL   // "MP3X" little-endian
+#define MP3_INDEX_VERSION     2
+
+#define MP3_INDEX_NAME_LEN    96   // Nome file in /MP3 (chiave insieme a size e mtime)
+#define MP3_INDEX_TITLE_LEN   48   // UTF-8, da ID3v2/ID3v1/LIST INFO o dal nome file
+#define MP3_INDEX_ARTIST_LEN  32
+
+// Flag del record
+#define MP3_IDX_ID3V2     0x01   // Tag ID3v2 in testa (audioStart lo salta)
+#define MP3_IDX_ID3V1     0x02   // Tag ID3v1/APE in coda (audioEnd li esclude)
+#define MP3_IDX_XING      0x04   // Header Xing/Info: durata esatta dal numero di frame
+#define MP3_IDX_VBRI      0x08   // Header VBRI (Fraunhofer): durata esatta
+#define MP3_IDX_VBR       0x10   // Bitrate variabile (bitrateKbps = media)
+#define MP3_IDX_LAME      0x20   // Tag LAME: encDelay/encPadding validi
+#define MP3_IDX_BAD       0x80   // Nessun frame/chunk audio riconosciuto
+
+struct MP3IndexEntry {
+  char     name[MP3_INDEX_NAME_LEN];
+  char     title[MP3_INDEX_TITLE_LEN];
+  char     artist[MP3_INDEX_ARTIST_LEN];
+  uint32_t size;           // Byte del file
+  uint32_t mtime;          // Ultima modifica (FAT, risoluzione 2 s)
+  uint32_t durationMs;
+  uint32_t audioStart;     // Primo byte del primo frame MP3 / dei dati PCM WAV
+  uint32_t audioEnd;       // Fine dei dati audio (esclusi tag in coda)
+  uint32_t sampleRate;
+  uint32_t samples;        // Campioni validi per canale (Xing - ritardo/riempimento LAME, WAV), 0 = ignoto
+  uint16_t bitrateKbps;
+  uint16_t encDelay;       // Campioni di ritardo dell'encoder (tag LAME)
+  uint16_t encPadding;     // Campioni di riempimento finale (tag LAME)
+  uint8_t  type;           // AUDIO_TYPE_MP3 / AUDIO_TYPE_WAV
+  uint8_t  channels;
+  uint8_t  flags;          // MP3_IDX_*
+  uint8_t  reserved[3];
+};
+
+// Intestazione del file indice: seguono count record MP3IndexEntry ordinati per nome
+struct MP3IndexHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t entrySize;
+  uint32_t count;
+  uint32_t totalSeconds;   // Durata complessiva della libreria
+  uint64_t totalBytes;     // Byte audio complessivi
+  uint32_t reserved[2];
+};
+
+static_assert(sizeof(MP3IndexEntry) == 216, "MP3IndexEntry: formato file indice cambiato");
+static_assert(sizeof(MP3IndexHeader) == 32, "MP3IndexHeader: formato file indice cambiato");
+
+#endif // MP3_LIBRARY_TYPES_H
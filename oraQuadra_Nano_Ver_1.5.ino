@@ -129,9 +129,6 @@
 #include <ESPAsyncWebServer.h>   // Libreria per web server asincrono ad alte prestazioni.
 #include <AsyncTCP.h>            // Libreria per comunicazioni TCP asincrone (richiesta da ESPAsyncWebServer).
 #include <Update.h>              // Libreria per aggiornamento OTA firmware e LittleFS via web
-#ifdef EFFECT_LED_RGB
-#include <Adafruit_NeoPixel.h>   // Libreria per LED RGB WS2812
-#endif
 #include "home_web_html.h"       // HTML per homepage con link a tutte le pagine
 
 /////////////////TEST NUOVO I2S AUDIO////////////////////////////////////////////////////
@@ -225,8 +222,16 @@ public:
   }
 
   void flush() override {}
+
+  uint16_t* getBuffer() const { return buffer; }   // Accesso diretto ai pixel (rasterizzatore lancette)
 };
 
+#include "particle_types.h"      // Definizioni struct per il motore particelle (0_PARTICLES.ino)
+
+#ifdef EFFECT_MP3_PLAYER
+#include "mp3_library_types.h"   // Record dell'indice libreria MP3 (31_MP3_LIBRARY.ino)
+#endif
+
 #ifdef EFFECT_BTTF
 #include "bttf_types.h"          // Definizioni struct per modalità BTTF (Back to the Future)
 #endif
@@ -238,6 +243,7 @@ public:
 #define I2C_SDA_PIN 19   // Definisce il pin 19 dell'ESP32 come il pin SDA (Serial Data) per la comunicazione I2C.
 #define I2C_SCL_PIN 45   // Definisce il pin 45 dell'ESP32 come il pin SCL (Serial Clock) per la comunicazione I2C.
 #define TOUCH_INT -1     // Definisce il pin per l'interrupt del touch screen. Un valore di -1 indica che questa funzionalità potrebbe non essere utilizzata o gestita in modo diverso (polling).
+#define TOUCH_INT_EDGE FALLING  // Fronte dell'INT GT911 (dipende dal config del pannello: Module_Switch1 bit 0-1). Con TOUCH_INT = -1 il task di input fa polling.
 #define TOUCH_RST -1     // Definisce il pin per il reset del touch screen. Un valore di -1 indica che il reset potrebbe non essere controllato via software.
 #define MAX_PATH_MEMORY 256  // Definisce la dimensione massima dell'array utilizzato per memorizzare il percorso del "serpente" di LED.
 
@@ -255,6 +261,10 @@ public:
 #define I2S_BCLK      1
 #define I2S_LRC       2
 #endif
+// Clock I2S fisso: web radio, MP3, annunci, click touch e arcade vengono convertiti a questa frequenza
+// (niente riprogrammazione del driver tra una sorgente e l'altra). 44.1kHz: la maggior parte di radio e MP3 passa diretta.
+#define AUDIO_OUTPUT_RATE     44100
+#define AUDIO_OUTPUT_QUALITY  RS_BALANCED  // RS_FAST (meno CPU), RS_BALANCED, RS_BEST
 
 // Configurazione annunci orari automatici (per audio WiFi esterno ESP32C3)
 #define ANNOUNCE_START_HOUR 8   // Ora di inizio annunci automatici (dalle 8:00)
@@ -346,6 +356,7 @@ public:
 #define EEPROM_CONFIGURED_MARKER 0x55 // Un valore specifico (byte) scritto in una posizione della EEPROM per indicare se la configurazione iniziale è già stata eseguita.
 #define EEPROM_VERSION_ADDR 500       // Indirizzo per versione layout EEPROM
 #define EEPROM_VERSION_VALUE 0x02     // Versione 2: nuova disposizione indirizzi (cambiare questo valore per forzare reset)
+#define EEPROM_SCHEMA_REV_ADDR 501    // Revisione tabella impostazioni (0_SETTINGS_STORE.ino)
 #define EEPROM_PRESET_ADDR 1      // Indirizzo di memoria nella EEPROM dove è memorizzato il preset di configurazione corrente.
 #define EEPROM_BLINK_ADDR 2       // Indirizzo di memoria nella EEPROM dove è memorato lo stato di lampeggio (probabilmente per qualche indicatore).
 #define EEPROM_MODE_ADDR 3        // Indirizzo di memoria nella EEPROM dove è memorata la modalità di visualizzazione corrente.
@@ -598,18 +609,6 @@ struct MinuteWords {
   const uint8_t* ones; // Puntatore a un array di byte per l'unità dei minuti.
 };
 
-// Struttura per un singolo fuoco d'artificio (effetto Capodanno)
-struct Firework {
-  int16_t x, y;                         // Posizione centro esplosione
-  float radius;                         // Raggio corrente dell'esplosione
-  float maxRadius;                      // Raggio massimo dell'esplosione
-  float speed;                          // Velocità di espansione
-  uint16_t color;                       // Colore RGB565
-  bool active;                          // Se il fuoco è attivo
-  uint32_t startTime;                   // Tempo di inizio esplosione
-  uint8_t sparkles;                     // Numero di scintille
-};
-
 // Struttura per configurazione campo data (usata da EFFECT_CLOCK in 3_EFFETTI.ino)
 struct DateField {
   bool enabled;      // Campo abilitato/disabilitato
@@ -626,12 +625,35 @@ void testSpeakerSafely();
 void checkButtons();
 void playTouchSound();
 
+// Funzioni definite in 1_TOUCH_INPUT.ino (task GT911, gesture, coda eventi)
+struct TouchEvent;
+void touchInputBegin();
+void touchRead();
+bool touchPollEvent(TouchEvent &ev);
+bool touchInputActive();
+void touchEventUnhandled();
+String getTouchStatsJson();
+
 // Funzioni definite in 2_CHANGE_MODE.ino
 void cleanupPreviousMode(DisplayMode previousMode);  // Cleanup risorse modalità precedente
 void forceDisplayUpdate();
 void applyPreset(uint8_t preset);
 void handleModeChange();
 bool isValidMode(DisplayMode mode);
+DisplayMode pickRandomEnabledMode(DisplayMode current);
+
+// Funzioni definite in 2_MODE_LIFECYCLE.ino
+#define MODE_LIFE_PRELOAD_LEAD_MS 5000  // Anticipo della preparazione nel cambio modo random
+void modeLifecycleBegin();
+void modePrepare(uint8_t mode);
+void modeActivate(uint8_t mode);
+uint8_t modeLifecycleClaim(uint8_t mode);
+void modeSuspend(uint8_t mode);
+void modeRelease(uint8_t mode);
+void modeSwitchBegin(uint8_t fromMode);
+void modeLifecycleInvalidate(uint8_t mode);
+void modeLifecycleInvalidateAll();
+String getModeLifecycleJson();
 
 // Funzioni definite in 3_EFFETTI.ino
 bool updateIntro();
@@ -720,6 +742,9 @@ void setup_led_rgb();
 void updateLedRgb();
 void saveLedRgbSettings();
 void getLedColorForMode(DisplayMode mode, uint8_t &r, uint8_t &g, uint8_t &b);
+void ledRgbAnnounceFrame();
+void ledRgbClear();
+String getLedRgbEngineJson();
 void setup_ledrgb_webserver(AsyncWebServer* server);
 extern bool    ledRgbEnabled;
 extern uint8_t ledRgbBrightness;
@@ -728,6 +753,7 @@ extern uint8_t ledRgbOverrideR;
 extern uint8_t ledRgbOverrideG;
 extern uint8_t ledRgbOverrideB;
 extern uint8_t ledAudioReactive;
+extern uint8_t ledRgbEffect;
 #endif
 
 // Arcade Bubble: quando attivo, il loop principale salta tutti i servizi non essenziali
@@ -761,6 +787,7 @@ void newsPrevCategory();
 void newsNextSource();
 int  newsGetTappedTab(int tx, int ty);
 bool newsIsSourcePillTapped(int tx, int ty);
+void handleNewsTouchEvent(const TouchEvent &ev);
 void setup_news_webserver(AsyncWebServer* server);
 extern bool   newsInitialized;
 extern int    newsArticleCount;
@@ -778,6 +805,7 @@ extern const char* newsSourceFlags[];
 void initPong();
 void updatePong();
 void handlePongTouch(int x, int y);
+void handlePongTouchEvent(const TouchEvent &ev);
 void handlePongRemoteTouch(int vy);
 void handlePongSpeedChange();
 extern bool pongInitialized;
@@ -796,6 +824,7 @@ void setup_pong_webserver(AsyncWebServer* server);
 void initBreakout();
 void updateBreakout();
 void handleBreakoutTouch(int x, int y);
+void handleBreakoutTouchEvent(const TouchEvent &ev);
 void handleBreakoutRemoteTouch(int vx, int vy);
 void handleBreakoutSpeedChange();
 extern bool breakoutInitialized;
@@ -843,6 +872,7 @@ void handleArcadeMenuTouch(int x, int y);
 void handleArcadeGameTouch(int x, int y);
 void arcadeUpdateTouchInput(int x, int y);
 void arcadeClearTouchInput();
+void handleArcadeTouchEvent(const TouchEvent &ev);
 void setup_arcade_webserver(AsyncWebServer* server);
 extern bool arcadeInitialized;
 extern int8_t arcadeSelectedGame;
@@ -858,6 +888,143 @@ uint8_t bleGamepadGetButtons();
 bool bleGamepadIsConnected();
 #endif
 
+// Funzioni definite in 0_SETTINGS_STORE.ino (schema impostazioni + commit EEPROM differiti)
+bool settingsCommit();
+bool settingsFlush();
+void settingsStoreBegin();
+void settingsStoreLoop();
+int32_t settingsLoad(uint16_t addr);
+void settingsApplyDefaults(uint8_t fromRev);
+void settingsMigrate();
+String getSettingsStoreJson();
+
+// Funzioni definite in 0_BACKLIGHT.ino (filtro luce, isteresi, gamma, rampe con fade LEDC)
+#define BL_SRC_LOCAL   0   // Sensore luce radar LD2410 locale
+#define BL_SRC_REMOTE  1   // Luce ambiente dal radar server
+#define BL_RAMP_WAKE_MS     400   // Risveglio per presenza
+#define BL_RAMP_SETTINGS_MS 300   // Valore cambiato da web
+#define BL_RAMP_SCHEDULE_MS 3000  // Passaggio giorno/notte
+void backlightBegin();
+void backlightFeedLight(uint8_t src, uint8_t raw);
+void backlightSet(uint8_t duty, uint16_t rampMs);
+void backlightFadeWait(uint8_t duty, uint16_t rampMs);
+void backlightRequestUpdate(uint16_t rampMs);
+void backlightUpdate();
+String getBacklightJson();
+
+// Funzioni definite in 15_RADAR_UART.ino (task UART LD2410, parser frame, snapshot presenza)
+struct RadarSnapshot;
+void radarUartBegin();
+bool radarGetSnapshot(RadarSnapshot &snap);
+String getRadarUartJson();
+
+// Funzioni definite in 0_I2C_BUS.ino (task proprietario del bus Wire, coda a priorita')
+// Indice dispositivo = priorita' (0 = massima)
+#define I2C_DEV_TOUCH   0   // GT911
+#define I2C_DEV_AUDIO   1   // Slave audio ESP32C3
+#define I2C_DEV_MAG     2   // QMC5883P
+#define I2C_DEV_BME280  3   // BME280 (poll pianificati)
+#define I2C_DEV_COUNT   4
+void i2cBusBegin();
+bool i2cBusRun(uint8_t dev, bool (*fn)(void *), void *arg);
+bool i2cBusProbe(uint8_t dev, uint8_t address);
+void i2cBmeAttach(uint8_t address);
+bool i2cBmeSampleNow();
+bool i2cBmeGet(float &temperature, float &humidity, float &pressure);
+String getI2cBusJson();
+
+// Funzioni definite in 0_BOOT.ino (passi di avvio con dipendenze + timeline)
+// Bit di dipendenza: segnalati a fine passo (terminato, non necessariamente riuscito)
+#define BOOT_DEP_DISPLAY   (1 << 0)   // Pannello inizializzato, gfx utilizzabile
+#define BOOT_DEP_I2C       (1 << 1)   // Bus Wire avviato (touch GT911)
+#define BOOT_DEP_SD        (1 << 2)   // Setup SD terminato (presente o no)
+#define BOOT_DEP_WIFI      (1 << 3)   // Setup WiFi terminato (connesso o no)
+#define BOOT_DEP_NTP       (1 << 4)   // Primo tentativo NTP terminato
+#define BOOT_DEP_RADAR     (1 << 5)   // Probe radar LD2410 terminato
+#define BOOT_DEP_SENSORS   (1 << 6)   // BME280 + magnetometro terminati
+#define BOOT_DEP_AUDIO_I2C (1 << 7)   // Ping ESP32C3 audio terminato
+#define BOOT_INLINE        -1         // Passo eseguito nel task di setup (unico che disegna)
+#define BOOT_JOIN_TIMEOUT_MS 20000    // Attesa massima dei task ancora attivi a fine setup
+
+struct BootStep {
+  const char *name;
+  uint16_t    needs;      // Bit BOOT_DEP_* da attendere prima di partire
+  uint16_t    provides;   // Bit segnalati a fine passo
+  int8_t      core;       // BOOT_INLINE oppure 0/1
+  bool      (*fn)();      // Ritorna l'esito (solo diagnostico)
+};
+bool bootWaitUntil(bool (*ready)(), uint32_t timeoutMs, uint32_t pollMs);
+bool bootQuiet();
+void bootSequencerBegin();
+void bootSignal(uint16_t bits);
+bool bootWait(uint16_t bits, uint32_t timeoutMs);
+void bootRun(const BootStep &step);
+void bootMark(const char *name, uint32_t startMs, bool ok);
+void bootClockRestore();
+bool bootSkipSplash();
+bool bootClockAvailable();
+void bootRenderEarlyClock();
+void bootClockSave();
+void bootClockLoop();
+void bootFinish();
+String getBootJson();
+
+// Funzioni definite in 0_FRAME_GOVERNOR.ino (attesa del loop su scene statiche)
+void frameGovBegin();
+void frameGovAttachWebServer(AsyncWebServer* server);
+void frameGovWakeAt(uint32_t atMs);
+void frameGovWakeIn(uint32_t delayMs);
+void frameGovAnimate();
+void frameGovAnimateUntil(uint32_t untilMs);
+void frameGovServiceAt(uint32_t atMs);
+void frameGovKick();
+void frameGovIdle();
+
+// Funzioni definite in 0_HAND_RASTER.ino (lancette antialias in virgola fissa)
+void handRasterSetClip(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+void handRasterClearClip();
+void clockHandBounds(int centerX, int centerY, float angle, int length, int thickness, uint8_t style,
+                     int16_t* x0, int16_t* y0, int16_t* x1, int16_t* y1);
+void drawClockHandAA(uint16_t* fb, int16_t fbW, int16_t fbH, int centerX, int centerY,
+                     float angle, int length, uint16_t color, int thickness, uint8_t style);
+
+// Funzioni definite in 0_PARTICLES.ino (motore particelle SoA in virgola fissa)
+void particleSeed(uint32_t seed);
+void particleDirQ15(float degrees, int32_t* dx, int32_t* dy);
+bool particleSystemAlloc(ParticleSystem* ps, uint16_t capacity);
+void particleSystemFree(ParticleSystem* ps);
+int particleSpawn(ParticleSystem* ps, int32_t x, int32_t y, int32_t vx, int32_t vy,
+                  uint16_t life, uint16_t color, uint8_t sprite);
+void particleKill(ParticleSystem* ps, uint16_t i);
+void particleIntegrateDefault(ParticleSystem* ps);
+void particleStep(ParticleSystem* ps, uint32_t now);
+bool particleCanvasBegin(ParticleCanvas* c, uint16_t* fb, const uint16_t* layer,
+                         int16_t w, int16_t h, uint16_t rectCap);
+void particleCanvasEnd(ParticleCanvas* c);
+void particleCanvasInvalidate(ParticleCanvas* c);
+void particleCanvasRestore(ParticleCanvas* c);
+void particleCanvasMark(ParticleCanvas* c, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+void particleCanvasRefresh(ParticleCanvas* c, int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+void particleCanvasBlit(ParticleCanvas* c);
+void particleRender(ParticleSystem* ps, ParticleCanvas* c);
+
+// Funzioni definite in 0_SKIN_CACHE.ino (skin decodificate in PSRAM, dissolvenza tra skin)
+void skinCacheBegin();
+bool skinCacheFetch(const char* path, uint16_t* dst);
+void skinCacheStore(const char* path, const uint16_t* pixels, uint32_t decodeMs);
+void skinCacheInvalidate(const char* path);
+bool skinFadeBegin(const uint16_t* currentFrame);
+bool skinFadeActive();
+void skinFadeCancel();
+void skinFadeApply(uint16_t* frame);
+void skinFadeNoteSwitch(uint32_t requestMs);
+String getSkinCacheJson();
+String getFrameGovJson();
+
+// Connessione WiFi anticipata (0_SETUP.ino)
+bool wifiLoadCredentials(char *ssid, char *pass);
+void wifiBeginEarly();
+
 // Funzioni definite in 44_DUAL_DISPLAY.ino e 45_WEBSERVER_DUAL_DISPLAY.ino
 #ifdef EFFECT_DUAL_DISPLAY
 void initDualDisplay();
@@ -897,6 +1064,7 @@ bool isDualSlave();
 bool isModeDualEnabled(uint8_t mode);
 int getActivePeerCount();
 void dualGfxBypass(bool bypass);
+bool dualPresentHold();
 void resetModeInitFlags();
 void initDualGfxProxy();
 void sendConfigPushToAllPeers();
@@ -937,6 +1105,11 @@ void setup_scrolltext_webserver(AsyncWebServer* server);
 extern bool scrollTextInitialized;
 #endif
 
+// Funzioni definite in 28_CHRISTMAS.ino (EFFECT_CHRISTMAS)
+#ifdef EFFECT_CHRISTMAS
+void releaseChristmasBuffers();
+#endif
+
 // Funzioni definite in 43_WEBSERVER_OTA.ino (OTA Update via browser)
 void setup_ota_webserver(AsyncWebServer* server);
 
@@ -965,12 +1138,14 @@ extern bool flipClockInitialized;
 #endif
 #ifdef EFFECT_BTTF
 extern bool bttfInitialized;
+extern bool bttfBackgroundLoaded;
 #endif
 #ifdef EFFECT_WEATHER_STATION
 extern bool weatherStationInitialized;
 #endif
 #ifdef EFFECT_FLUX_CAPACITOR
 extern bool fluxCapacitorInitialized;
+extern bool fluxBackgroundLoaded;
 #endif
 #ifdef EFFECT_CALENDAR
 extern bool calendarStationInitialized;
@@ -992,6 +1167,20 @@ bool handleMP3PlayerTouch(int16_t x, int16_t y);
 extern bool mp3PlayerInitialized;
 #endif
 
+#ifdef EFFECT_MP3_PLAYER
+// Funzioni definite in 31_MP3_LIBRARY.ino (indice persistente dei brani su SD, task di scansione)
+void mp3LibraryBegin();
+void mp3LibraryRequestScan();
+int mp3LibraryCount();
+uint32_t mp3LibraryGeneration();
+bool mp3LibraryScanning();
+uint16_t mp3LibraryScanProgress();
+bool mp3LibraryGet(int index, MP3IndexEntry* out);
+int mp3LibraryFind(const char* name);
+uint64_t mp3LibraryTotalBytes();
+String getMP3LibraryStatsJSON();
+#endif
+
 #ifdef EFFECT_WEB_RADIO
 void initWebRadioUI();
 void updateWebRadioUI();
@@ -1186,6 +1375,55 @@ Arduino_GFX *gfx = realGfx; // Puntatore attivo: punta a realGfx (standalone) o
 
 // Touch
 TAMC_GT911 ts = TAMC_GT911(I2C_SDA_PIN, I2C_SCL_PIN, TOUCH_INT, TOUCH_RST, max(TOUCH_MAP_X1, TOUCH_MAP_X2), max(TOUCH_MAP_Y1, TOUCH_MAP_Y2)); // Creazione di un oggetto della classe `TAMC_GT911` per interagire con il touch screen tramite I2C. I valori `max` sono usati per assicurare che l'intervallo di mappatura sia corretto.
+
+// ===== Touch: campione e eventi prodotti dal task di input (1_TOUCH_INPUT.ino) =====
+// Il GT911 viene letto SOLO da touchInputTask. Il loop chiama touchRead(), che copia
+// l'ultimo campione in touchState (stessi campi di ts: isTouched, touches, points).
+#define TOUCH_MAX_POINTS 5
+struct TouchState {
+  bool     isTouched;
+  uint8_t  touches;
+  TP_Point points[TOUCH_MAX_POINTS];  // Coordinate grezze del controller (come ts.points)
+  uint32_t sampleUs;                  // Istante (esp_timer) in cui il dato era disponibile
+};
+TouchState touchState;
+
+enum TouchEventType : uint8_t {
+  TOUCH_EV_TAP = 0,
+  TOUCH_EV_DOUBLE_TAP,    // Emesso dopo il TAP del secondo tocco
+  TOUCH_EV_LONG_PRESS,
+  TOUCH_EV_SWIPE,         // Al rilascio, dopo DRAG_START/MOVE (campo dir)
+  TOUCH_EV_DRAG_START,
+  TOUCH_EV_DRAG_MOVE,
+  TOUCH_EV_DRAG_END,
+  TOUCH_EV_CORNERS_START, // 4 angoli premuti insieme
+  TOUCH_EV_CORNERS_LOST,  // Angoli rilasciati prima di CORNERS_HOLD
+  TOUCH_EV_CORNERS_HOLD,  // 4 angoli tenuti per 5 secondi
+  TOUCH_EV_PRESS,         // Primo contatto (prima di qualsiasi gesture)
+  TOUCH_EV_RELEASE        // Tutte le dita sollevate (dopo TAP/SWIPE/DRAG_END)
+};
+
+enum TouchSwipeDir : uint8_t {
+  TOUCH_SWIPE_NONE = 0,
+  TOUCH_SWIPE_LEFT,
+  TOUCH_SWIPE_RIGHT,
+  TOUCH_SWIPE_UP,
+  TOUCH_SWIPE_DOWN
+};
+
+struct TouchEvent {
+  uint8_t  type;        // TouchEventType
+  uint8_t  dir;         // TouchSwipeDir (solo SWIPE)
+  int16_t  x, y;        // Coordinate schermo 0-479 del punto corrente
+  int16_t  dx, dy;      // Spostamento dall'inizio del tocco
+  uint32_t durationMs;  // Durata del tocco al momento dell'evento
+  uint32_t sampleUs;    // Campione che ha generato l'evento (latenza touch -> evento)
+};
+
+// Gestore eventi della modalita' attiva (nullptr = nessuno): assegnato da checkButtons()
+// con touchModeHandlerFor(currentMode) prima di ogni evento
+typedef void (*TouchModeHandler)(const TouchEvent &ev);
+TouchModeHandler touchModeHandler = nullptr;
 int touch_last_x = 0, touch_last_y = 0; // Variabili globali per memorizzare le coordinate dell'ultimo tocco rilevato.
 
 // Networking
@@ -1363,9 +1601,28 @@ uint8_t lastRadarLightLevel = 0;         // Ultimo valore luce letto dal radar (
 uint8_t lastAppliedBrightness = 255;     // Ultima luminosità applicata (per web)
 uint32_t lastPresenceTime = 0;           // Timestamp dell'ultima presenza rilevata
 uint32_t lastRadarRead = 0;              // Timestamp dell'ultima lettura del radar
-const uint32_t RADAR_READ_INTERVAL = 200; // Intervallo lettura radar in ms (200ms = 5Hz per risposta rapida al rilevamento presenza)
+const uint32_t RADAR_READ_INTERVAL = 100; // Intervallo lettura snapshot radar in ms (copia in memoria, nessun accesso UART)
 const uint32_t PRESENCE_TIMEOUT = 30000;  // Timeout presenza in ms (30 secondi)
 
+// Snapshot pubblicato dal task UART del radar (15_RADAR_UART.ino) a ogni frame valido
+#define RADAR_GATES 9                    // Gate 0-8 (0.75m ciascuno)
+struct RadarSnapshot {
+  bool     link;                         // Frame validi ricevuti negli ultimi RADAR_LINK_TIMEOUT_MS
+  bool     engineering;                  // Ultimo frame in engineering mode (energie per gate + luce)
+  bool     moving;                       // Target in movimento
+  bool     stationary;                   // Target fermo
+  uint16_t movingDistCm;
+  uint8_t  movingEnergy;
+  uint16_t stationaryDistCm;
+  uint8_t  stationaryEnergy;
+  uint16_t detectDistCm;
+  uint8_t  light;                        // Sensore luce (0-255), solo engineering mode
+  uint8_t  gateMoving[RADAR_GATES];      // Energia movimento per gate
+  uint8_t  gateStill[RADAR_GATES];       // Energia statica per gate
+  uint32_t frameMs;                      // millis() dell'ultimo frame valido
+  uint32_t presenceMs;                   // millis() dell'ultimo frame con presenza
+};
+
 
 // Controllo luminosità basato su PRESENZA + ORA
 // brightnessDay e brightnessNight sono già definite sopra (#define)
@@ -1434,6 +1691,7 @@ bool alarmLastDepartedEnabled = false;
 JPEGDEC jpeg;                    // Oggetto per decodificare immagini JPEG.
 bool analogClockInitNeeded = true; // Flag per inizializzazione.
 bool clockImageLoaded = false;   // Flag per indicare se l'immagine di sfondo è stata caricata.
+bool analogClockFrameOnScreen = false; // Il frameBuffer è a schermo (base per la dissolvenza al cambio skin).
 bool showClockDate = true;       // Flag per mostrare/nascondere la data (salvato in EEPROM).
 float lastSecondAngle = 0;       // Angolo precedente della lancetta dei secondi.
 float lastMinuteAngle = 0;       // Angolo precedente della lancetta dei minuti.
@@ -1514,6 +1772,7 @@ DateField clockYearField = {true, 195, 400, WHITE, 2};       // Anno (es: "2025"
 
 // Nome file skin attiva (caricato da EEPROM)
 char clockActiveSkin[32] = "orologio.jpg";  // Default
+char clockLoadedSkin[32] = "";                // Skin attualmente decodificata in clockBackgroundBuffer
 #endif
 
 #ifdef EFFECT_BTTF
@@ -1619,6 +1878,37 @@ char clockActiveSkin[32] = "orologio.jpg";  // Default
 #define EEPROM_LEDRING_VALID_MARKER      0xAB // Marker per indicare che le impostazioni LED Ring sono valide
 #endif
 
+// Indirizzi EEPROM LED RGB WS2812 (900-907, 952) - 37_LED_RGB.ino
+// NOTA: 700-704 sono usati da enabledModesMask e rainbowMode, 908-951 da Dual Display, ScrollText e Arcade
+#define EEPROM_LED_RGB_ENABLED    900
+#define EEPROM_LED_RGB_BRIGHTNESS 901
+#define EEPROM_LED_RGB_OVERRIDE   902
+#define EEPROM_LED_RGB_R          903
+#define EEPROM_LED_RGB_G          904
+#define EEPROM_LED_RGB_B          905
+#define EEPROM_LED_RGB_MARKER     906
+#define EEPROM_LED_RGB_VALID      0xAC  // Cambiato per forzare reset default
+#define EEPROM_LED_RGB_AUDIOREACT 907
+#define EEPROM_LED_RGB_EFFECT     952
+
+// Indirizzi EEPROM dual display (908-932) - 44_DUAL_DISPLAY.ino
+#define EEPROM_DUAL_ENABLED       908
+#define EEPROM_DUAL_PANEL_X       909
+#define EEPROM_DUAL_PANEL_Y       910
+#define EEPROM_DUAL_GRID_W        911
+#define EEPROM_DUAL_GRID_H        912
+#define EEPROM_DUAL_ROLE          913
+#define EEPROM_DUAL_PEER1_MAC     914  // 6 bytes (914-919)
+#define EEPROM_DUAL_PEER2_MAC     920  // 6 bytes (920-925)
+#define EEPROM_DUAL_PEER3_MAC     926  // 6 bytes (926-931)
+#define EEPROM_DUAL_MARKER        932
+#define EEPROM_DUAL_MARKER_VALUE  0xDD
+
+// ===== EEPROM per-mode dual display mask (943-948) =====
+#define EEPROM_DUAL_MODES_MASK_ADDR   943  // 5 bytes (943-947) = 40 bit per i modi 0-39
+#define EEPROM_DUAL_MODES_MARKER_ADDR 948  // Marker 0xDE
+#define EEPROM_DUAL_MODES_MARKER_VALUE 0xDE
+
 #ifdef EFFECT_FLIP_CLOCK
 // Variabile per l'orologio flip clock
 bool flipClockInitialized = false; // Variabile globale per indicare se il flip clock è stato inizializzato.
@@ -2127,6 +2417,10 @@ void setup_bt_audio_webserver(AsyncWebServer* server);
 bool initBtAudio();
 void updateBtAudioReceive();
 void cleanupBtAudio();
+bool connectBtAudioHttp(const String& baseUrl);
+void disconnectBtAudioHttp();
+void setBtVideoTimestamp(unsigned long timestamp);
+void setBtAudioTimestamp(unsigned long timestamp);
 #endif
 
 // Forward declarations Radar Remote Webserver
@@ -2234,6 +2528,7 @@ void drawAlarmIndicator() {
 //////////////TEST NUOVO I2S AUDIO//////////////////////////////////////////
 void audio_info(const char *info){
     Serial.print("info        "); Serial.println(info);
+    frameGovKick();   // Cambio stato stream/decoder: aggiorna subito la UI
 }
 ///////////////////////////////////////////////////////////////////////////
 // ================== SETUP PRINCIPALE ==================
@@ -2263,7 +2558,12 @@ void setup() {
   }
 
   Serial.begin(115200);
-  delay(1000);
+  // Attende la seriale USB (al massimo 1s) invece di un'attesa fissa
+  bootWaitUntil([]() { return (bool)Serial; }, 1000, 10);
+  bootSequencerBegin();  // Passi di avvio con dipendenze + timeline (0_BOOT.ino)
+  frameGovBegin();       // Attesa del loop su scene statiche (0_FRAME_GOVERNOR.ino)
+  skinCacheBegin();      // Cache skin decodificate (0_SKIN_CACHE.ino)
+  modeLifecycleBegin();  // Preparazione asset delle modalità in background (2_MODE_LIFECYCLE.ino)
 
   // Silenzia i log interni ESP-IDF (WiFi, TLS, I2C, HTTP...)
   // che altrimenti riempiono la seriale di caratteri "strani"
@@ -2294,10 +2594,23 @@ Serial.println("LittleFS inizializzato correttamente.");
     Serial.println("PSRAM: Non disponibile");
   }
 
-  // SETUP COMPONENTI IN SEQUENZA
-  setup_eeprom();  // Inizializza e carica le impostazioni dalla EEPROM.
-  setup_display(); // Inizializza il display.
-  setup_touch();   // Inizializza il touch screen.
+  // SETUP COMPONENTI: ogni passo dichiara le dipendenze (BOOT_DEP_*), i passi che non
+  // disegnano girano come task sul core 0 mentre il setup prosegue (0_BOOT.ino)
+  static const BootStep stepEeprom = { "eeprom", 0, 0, BOOT_INLINE,
+    []() { setup_eeprom(); return true; } };   // Inizializza e carica le impostazioni dalla EEPROM.
+  bootRun(stepEeprom);
+
+  wifiBeginEarly();    // Associazione WiFi in background durante display, SD e sensori
+  bootClockRestore();  // Ora da RTC interno / ultima ora salvata per il primo frame
+
+  static const BootStep stepDisplay = { "display", 0, BOOT_DEP_DISPLAY, BOOT_INLINE,
+    []() { setup_display(); return true; } };  // Inizializza il display.
+  bootRun(stepDisplay);
+  bootRenderEarlyClock();  // Orologio visibile subito, senza attendere WiFi/NTP
+
+  static const BootStep stepTouch = { "touch", BOOT_DEP_DISPLAY, BOOT_DEP_I2C, BOOT_INLINE,
+    []() { setup_touch(); return true; } };    // Inizializza il touch screen (e il bus I2C).
+  bootRun(stepTouch);
 
    // VERIFICA SE I 4 ANGOLI SONO PREMUTI ALL'AVVIO (per triggerare un reset delle impostazioni WiFi)
   int cornerCheckAttempts = 0;
@@ -2320,16 +2633,67 @@ Serial.println("LittleFS inizializzato correttamente.");
     delay(50); // Piccola pausa tra i controlli
   }
 
+  // Radar LD2410 (UART1) e sensori I2C non usano il display: task sul core 0
+  static const BootStep stepRadar = { "radar", 0, BOOT_DEP_RADAR, 0,
+    []() { setup_radar(); return radarAvailable; } };
+  bootRun(stepRadar);
+
+  // BME280 + magnetometro QMC5883P (I2C condiviso con touch GT911)
+  // NOTA: È un QMC5883P (non QMC5883L!), indirizzo 0x0C, libreria Adafruit_QMC5883P
+  static const BootStep stepSensors = { "bme280+mag", BOOT_DEP_I2C, BOOT_DEP_SENSORS, 0,
+    []() { setup_bme280(); setup_magnetometer(); return bme280Available; } };
+  bootRun(stepSensors);
+
+  // Audio I2C con ESP32C3 esterno: il volume iniziale dipende dall'ora (dopo NTP),
+  // accesso al bus dopo i sensori
+  static const BootStep stepAudioI2c = { "audio-i2c", BOOT_DEP_I2C | BOOT_DEP_SENSORS | BOOT_DEP_NTP,
+    BOOT_DEP_AUDIO_I2C, 0, []() { setup_audio_i2c(); return audioSlaveConnected; } };
+  bootRun(stepAudioI2c);
+
+  // Inizializza SD Card mentre il WiFi si associa (disegna sul display: resta nel task di setup).
+  // Il pin 41 condiviso riguardava l'audio WiFi esterno: i pin I2S vengono configurati
+  // comunque dopo (WEB RADIO INIT).
+  static const BootStep stepSd = { "sd", BOOT_DEP_DISPLAY, BOOT_DEP_SD, BOOT_INLINE,
+    []() { setup_sd(); return SD.cardType() != CARD_NONE; } };
+  bootRun(stepSd);
+
+  #ifdef EFFECT_BTTF
+  // Carica configurazione allarmi BTTF dalla SD all'avvio
+  extern bool loadBTTFConfigFromSD();
+  if (loadBTTFConfigFromSD()) {
+    Serial.println("[BTTF] Configurazione allarmi caricata da SD all'avvio");
+  } else {
+    Serial.println("[BTTF] Nessuna configurazione allarmi trovata, uso valori predefiniti");
+  }
+  #endif
+
   // Setup WiFi e servizi correlati (solo se necessario)
-  setup_wifi();
+  static const BootStep stepWifi = { "wifi", BOOT_DEP_DISPLAY, BOOT_DEP_WIFI, BOOT_INLINE,
+    []() { setup_wifi(); return WiFi.status() == WL_CONNECTED; } };
+  bootRun(stepWifi);
 
   if (WiFi.status() == WL_CONNECTED) {
+    // Sincronizzazione NTP (fino a 15s su reti lente) in parallelo ai web server
+    static const BootStep stepNtp = { "ntp", BOOT_DEP_WIFI, BOOT_DEP_NTP, 0, []() {
+      setup_NTP();   // Inizializza la sincronizzazione dell'ora tramite NTP.
+      // Inizializza i flag dell'annuncio orario con l'ora attuale al boot
+      lastAudioAnnounceHour = myTZ.hour();
+      lastMinuteChecked = myTZ.minute();
+      #ifdef AUDIO
+      setup_audio(); // Inizializza il sistema audio (solo se la macro AUDIO è definita).
+      #endif
+      return ntpSynced;
+    } };
+    bootRun(stepNtp);
+
+    uint32_t servicesStart = millis();
     setup_OTA();   // Inizializza l'aggiornamento Over-The-Air.
     setup_alexa(); // Inizializza l'integrazione con Alexa (server sulla porta 80).
 
     // Crea web server separato per configurazione (porta 8080)
     // Sempre disponibile per pagina impostazioni generali
     clockWebServer = new AsyncWebServer(8080);
+    frameGovAttachWebServer(clockWebServer);  // Ogni richiesta sveglia subito il loop
 
     // Homepage con link a tutte le pagine (sempre disponibile)
     clockWebServer->on("/", HTTP_GET, [](AsyncWebServerRequest *request) {
@@ -2462,48 +2826,20 @@ Serial.println("LittleFS inizializzato correttamente.");
     #ifdef EFFECT_DUAL_DISPLAY
     initDualDisplay();
     #endif
+    bootMark("servizi+web", servicesStart, true);
 
-    setup_NTP();   // Inizializza la sincronizzazione dell'ora tramite NTP.
-    // Inizializza i flag dell'annuncio orario con l'ora attuale al boot
-    lastAudioAnnounceHour = myTZ.hour();
-    lastMinuteChecked = myTZ.minute();
-    #ifdef AUDIO
-    setup_audio(); // Inizializza il sistema audio (solo se la macro AUDIO è definita).
-    #endif
-
-      
   } else {
-    Serial.println("WiFi non connesso, utilizzo ora predefinita");
-    currentHour = 12;
-    currentMinute = 0;
-    currentSecond = 0;
-  }
-
-  // Inizializza SD Card (dopo setup audio per evitare conflitti su PIN 41)
-  setup_sd();
-
-  #ifdef EFFECT_BTTF
-  // Carica configurazione allarmi BTTF dalla SD all'avvio
-  extern bool loadBTTFConfigFromSD();
-  if (loadBTTFConfigFromSD()) {
-    Serial.println("[BTTF] Configurazione allarmi caricata da SD all'avvio");
-  } else {
-    Serial.println("[BTTF] Nessuna configurazione allarmi trovata, uso valori predefiniti");
+    // Ora predefinita solo se bootClockRestore() non ha gia' un'ora (RTC o ultima salvata)
+    if (!bootClockAvailable()) {
+      Serial.println("WiFi non connesso, utilizzo ora predefinita");
+      currentHour = 12;
+      currentMinute = 0;
+      currentSecond = 0;
+    } else {
+      Serial.println("WiFi non connesso, mantengo l'ora ripristinata all'avvio");
+    }
+    bootSignal(BOOT_DEP_NTP);  // Nessun NTP: sblocca chi dipende dall'ora
   }
-  #endif
-
-  // Inizializza radar LD2410 (compatibile con audio WiFi esterno - nessun conflitto pin)
-  setup_radar();
-
-  // Inizializza sensore BME280 per temperatura/umidità/pressione interna (I2C)
-  setup_bme280();
-
-  // Inizializza audio I2C con ESP32C3 esterno (I2C condiviso con GT911 touchscreen)
-  setup_audio_i2c();
-
-  // Inizializza magnetometro QMC5883P (I2C condiviso con touch GT911)
-  // NOTA: È un QMC5883P (non QMC5883L!), indirizzo 0x0C, libreria Adafruit_QMC5883P
-  setup_magnetometer();
 
   #ifdef EFFECT_LED_RGB
   setup_led_rgb();
@@ -2521,15 +2857,21 @@ Serial.println("LittleFS inizializzato correttamente.");
   Serial.printf("[SETUP] Impostazioni caricate: Mode=%d, Preset=%d, Color=R%d G%d B%d\n",
                 currentMode, currentPreset, currentColor.r, currentColor.g, currentColor.b);
 
-  // Inizializza modulo meteo OpenWeatherMap (dopo WiFi)
+  // Inizializza modulo meteo OpenWeatherMap (dopo WiFi e primo sync NTP)
   if (WiFi.status() == WL_CONNECTED) {
+    bootWait(BOOT_DEP_NTP, BOOT_JOIN_TIMEOUT_MS);
     initWeather();
   }
 
+  // Attende i passi ancora in corso sul core 0 (il radar usa i pin 1/2 come l'I2S
+  // configurato qui sotto) e stampa la timeline di avvio
+  bootFinish();
+
 
 ///////////////////////////////////WEB RADIO INIT///////////////////////////////////////////////
     // Inizializza audio I2S per web radio
     audio.setPinout(I2S_BCLK, I2S_LRC, I2S_DOUT);
+    audio.setOutputRate(AUDIO_OUTPUT_RATE, AUDIO_OUTPUT_QUALITY);
     audio.setVolume(21); // default 0...21
     Serial.println("[WEBRADIO] Audio I2S configurato");
     // Carica lista stazioni radio da SD card
@@ -2560,17 +2902,20 @@ Serial.println("LittleFS inizializzato correttamente.");
   // Usa dayStartHour/Minute e nightStartHour/Minute configurabili da web
   bool isNightTime = checkIsNightTime(currentHour, currentMinute);
   if (isNightTime) {
-    ledcWrite(PWM_CHANNEL, brightnessNight);
-    lastAppliedBrightness = brightnessNight;  // SYNC per loop
+    backlightSet(brightnessNight, 0);
     Serial.printf("Luminosità NOTTE: %d (ora: %02d:%02d, notte dalle %02d:%02d)\n", brightnessNight, currentHour, currentMinute, nightStartHour, nightStartMinute);
   } else {
-    ledcWrite(PWM_CHANNEL, brightnessDay);
-    lastAppliedBrightness = brightnessDay;    // SYNC per loop
+    backlightSet(brightnessDay, 0);
     Serial.printf("Luminosità GIORNO: %d (ora: %02d:%02d, giorno dalle %02d:%02d)\n", brightnessDay, currentHour, currentMinute, dayStartHour, dayStartMinute);
   }
   Serial.println("Display: ACCESO");
   Serial.println("========================================\n");
 
+  // L'orologio anticipato usa il layout di MODE_FAST: per le altre modalità il loop
+  // si aspetta lo schermo nero, come dopo setup_wifi()/setup_sd()
+  if (bootEarlyClockShown && currentMode != MODE_FAST) {
+    gfx->fillScreen(BLACK);
+  }
 }
 
 // ================== IMPLEMENTAZIONI WEB RADIO ==================
@@ -2608,7 +2953,7 @@ void saveWebRadioSettings() {
   EEPROM.write(EEPROM_WEBRADIO_ENABLED_ADDR, webRadioEnabled ? 1 : 0);
   EEPROM.write(EEPROM_WEBRADIO_VOLUME_ADDR, webRadioVolume);
   EEPROM.write(EEPROM_WEBRADIO_STATION_ADDR, (uint8_t)webRadioCurrentIndex);
-  EEPROM.commit();
+  settingsCommit();
   Serial.printf("[WEBRADIO] Salvato: enabled=%d, volume=%d, station=%d\n",
                 webRadioEnabled, webRadioVolume, webRadioCurrentIndex);
 }
@@ -2616,7 +2961,7 @@ void saveWebRadioSettings() {
 // Salva volume annunci orari in EEPROM
 void saveAnnounceVolume() {
   EEPROM.write(EEPROM_ANNOUNCE_VOLUME_ADDR, announceVolume);
-  EEPROM.commit();
+  settingsCommit();
   Serial.printf("[ANNOUNCE] Volume salvato: %d\n", announceVolume);
 }
 
@@ -2768,27 +3113,28 @@ void setup_NTP() {
 
     Serial.printf("Impostazione ora: %02d:%02d:%02d\n",
                   currentHour, currentMinute, currentSecond);
+    bootClockSave();  // RTC interno + NVS per l'orologio anticipato al prossimo boot
   } else {
     ntpSynced = false;
     Serial.println("Sincronizzazione NTP non riuscita, utilizzo ora predefinita");
     Serial.println("Il sistema ritenterà la sincronizzazione automaticamente");
-    // Imposta un'ora predefinita in caso di fallimento della sincronizzazione
-    currentHour = 12;
-    currentMinute = 0;
-    currentSecond = 0;
+    // Ora predefinita solo se bootClockRestore() non ha gia' un'ora (RTC o ultima salvata)
+    if (!bootClockAvailable()) {
+      currentHour = 12;
+      currentMinute = 0;
+      currentSecond = 0;
+    }
   }
 
   // IMPORTANTE: Forza luminosità iniziale basata su giorno/notte
   // Questo assicura che il display sia sempre acceso dopo il boot
   // anche se il radar non è disponibile
+  // Gira nel task NTP (core 0): il PWM viene aggiornato dal loop tramite il controller
   Serial.println("Impostazione luminosità dopo NTP...");
+  backlightRequestUpdate(0);
   if (checkIsNightTime(currentHour, currentMinute)) {
-    ledcWrite(PWM_CHANNEL, brightnessNight);
-    lastAppliedBrightness = brightnessNight;  // SYNC per loop
     Serial.printf("Luminosità NOTTE applicata: %d (ora: %02d:%02d, notte dalle %02d:%02d)\n", brightnessNight, currentHour, currentMinute, nightStartHour, nightStartMinute);
   } else {
-    ledcWrite(PWM_CHANNEL, brightnessDay);
-    lastAppliedBrightness = brightnessDay;    // SYNC per loop
     Serial.printf("Luminosità GIORNO applicata: %d (ora: %02d:%02d, giorno dalle %02d:%02d)\n", brightnessDay, currentHour, currentMinute, dayStartHour, dayStartMinute);
   }
 }
@@ -2814,15 +3160,10 @@ void retryNTPSync() {
     currentMinute = myTZ.minute();
     currentSecond = myTZ.second();
     Serial.println("NTP risincronizzato! Ora: " + myTZ.dateTime("H:i:s"));
+    bootClockSave();
 
-    // Aggiorna luminosità in base all'ora corretta
-    if (checkIsNightTime(currentHour, currentMinute)) {
-      ledcWrite(PWM_CHANNEL, brightnessNight);
-      lastAppliedBrightness = brightnessNight;
-    } else {
-      ledcWrite(PWM_CHANNEL, brightnessDay);
-      lastAppliedBrightness = brightnessDay;
-    }
+    // Aggiorna luminosità in base all'ora corretta (rampa giorno/notte)
+    backlightRequestUpdate(BL_RAMP_SCHEDULE_MS);
   } else {
     Serial.println("Risincronizzazione NTP fallita, riprovo tra 30s");
   }
@@ -2861,8 +3202,8 @@ void readBME280Temperature() {
     if (humidityIndoor > 100.0) humidityIndoor = 100.0;
 
     // Pressione dal BME280 locale se disponibile (non sovrascrive temp/hum)
-    if (bme280Available) {
-      float p = bme.readPressure() / 100.0F;
+    float t, h, p;
+    if (bme280Available && i2cBmeGet(t, h, p)) {
       if (p >= 300.0 && p <= 1100.0) pressureIndoor = p;
       else pressureIndoor = 0.0;
     } else {
@@ -2874,10 +3215,10 @@ void readBME280Temperature() {
   }
 
   // PRIORITÀ 2: Fallback al BME280 locale (se radar non disponibile)
-  if (bme280Available) {
-    float rawTemp = bme.readTemperature();
-    float rawHum = bme.readHumidity();
-    pressureIndoor = bme.readPressure() / 100.0F;
+  // Ultima misura forced-mode pubblicata dall'arbitro I2C (nessun accesso al bus qui)
+  float rawTemp, rawHum, rawPress;
+  if (bme280Available && i2cBmeGet(rawTemp, rawHum, rawPress)) {
+    pressureIndoor = rawPress;
 
     // Validazione
     if (rawTemp < -40.0 || rawTemp > 85.0) {
@@ -2928,12 +3269,17 @@ void loop() {
   // Variabili static per controllo luminosità radar (fuori dai blocchi condizionali)
   //#ifndef AUDIO
   static uint32_t lastLightRead = 0;
-  static uint32_t lastBrightnessUpdate = 0;
   static uint32_t lastBrightnessDebug = 0;
   //#endif
 
   uint32_t currentMillis = millis();  // Ottiene il tempo attuale in millisecondi dall'avvio.
 
+  // Commit EEPROM differiti (0_SETTINGS_STORE.ino): un solo salvataggio in flash per raffica di modifiche
+  settingsStoreLoop();
+
+  // Salvataggio periodico dell'ora sincronizzata per l'orologio anticipato al boot (0_BOOT.ino)
+  bootClockLoop();
+
   // ========== ARCADE BUBBLE: FAST PATH ==========
   // Quando l'arcade e' attivo, salta TUTTO tranne touch + render.
   // Spostato QUI in cima al loop per massima velocita' (niente OTA/Alexa/radar overhead).
@@ -2951,7 +3297,7 @@ void loop() {
     // Orologio base (per status bar, 1 volta/sec)
     static uint32_t lastUpdate_arc = 0;
     if (currentMillis - lastUpdate_arc > 1000) {
-      if (WiFi.status() == WL_CONNECTED) {
+      if (WiFi.status() == WL_CONNECTED && timeStatus() != timeNotSet) {
         currentHour = myTZ.hour();
         currentMinute = myTZ.minute();
         currentSecond = myTZ.second();
@@ -3048,6 +3394,8 @@ void loop() {
     checkButtons();
     lastButtonCheck = currentMillis;
   }
+  // Dito appoggiato o eventi in coda: il loop non deve attendere oltre il prossimo check
+  if (touchInputActive()) frameGovServiceAt(lastButtonCheck + 51);
 
   // Se mode selector overlay attivo, blocca TUTTO il resto del loop (come capodannoActive)
   if (modeSelectorActive) {
@@ -3091,31 +3439,30 @@ void loop() {
   #endif
   ) {
     uint32_t randomIntervalMs = (uint32_t)randomModeInterval * 60000UL;  // Converti minuti in millisecondi
+    static int16_t randomPreparedMode = -1;  // Prossima modalità già scelta e in preparazione
+
+    // Qualche secondo prima del cambio sceglie la prossima modalità e ne prepara gli asset
+    // in background: allo scadere il cambio trova sfondi e buffer già pronti
+    if (randomPreparedMode < 0 && currentMillis - lastRandomModeChange + MODE_LIFE_PRELOAD_LEAD_MS >= randomIntervalMs) {
+      DisplayMode nextMode = pickRandomEnabledMode(currentMode);
+      if (nextMode != currentMode) {
+        randomPreparedMode = (int16_t)nextMode;
+        modePrepare((uint8_t)nextMode);
+        Serial.printf("[RANDOM MODE] Prossima modalità %d in preparazione\n", (int)nextMode);
+      }
+    }
+
     if (currentMillis - lastRandomModeChange >= randomIntervalMs) {
       lastRandomModeChange = currentMillis;
 
-      // Trova una modalità random tra quelle abilitate
-      DisplayMode newMode = getNextEnabledMode(currentMode);
-
-      // Se ci sono più modalità abilitate, scegli random
-      // Conta quante modalità sono abilitate
-      uint8_t enabledCount = 0;
-      for (int i = 0; i < NUM_MODES; i++) {
-        if (isModeEnabled(i)) enabledCount++;
-      }
-
-      if (enabledCount > 1) {
-        // Scegli una modalità random diversa da quella corrente
-        uint8_t attempts = 0;
-        do {
-          uint8_t randomIndex = random(NUM_MODES);
-          if (isModeEnabled(randomIndex) && randomIndex != (int)currentMode) {
-            newMode = (DisplayMode)randomIndex;
-            break;
-          }
-          attempts++;
-        } while (attempts < 50);  // Max 50 tentativi per evitare loop infinito
+      // Usa la modalità preparata se è ancora abilitata, altrimenti ne sceglie un'altra
+      DisplayMode newMode;
+      if (randomPreparedMode >= 0 && randomPreparedMode != (int16_t)currentMode && isModeEnabled((uint8_t)randomPreparedMode)) {
+        newMode = (DisplayMode)randomPreparedMode;
+      } else {
+        newMode = pickRandomEnabledMode(currentMode);
       }
+      randomPreparedMode = -1;
 
       // Cambia modalità
       if (newMode != currentMode) {
@@ -3132,8 +3479,8 @@ void loop() {
         //EEPROM.write(EEPROM_MODE_ADDR, (uint8_t)newMode);
         //EEPROM.commit();
 
-        // Forza reinizializzazione completa della nuova modalità
-        forceDisplayUpdate();
+        // Forza reinizializzazione completa della nuova modalità (asset già preparati)
+        modeActivate((uint8_t)newMode);
 
         lastHour = 255;
         lastMinute = 255;
@@ -3149,14 +3496,14 @@ void loop() {
   // ========== GESTIONE RADAR LD2410 PER RILEVAMENTO PRESENZA ==========
   //#ifndef AUDIO
 
+  if (radarAvailable) frameGovServiceAt(lastRadarRead + RADAR_READ_INTERVAL + 1);
   if (radarAvailable && currentMillis - lastRadarRead > RADAR_READ_INTERVAL) {
     lastRadarRead = currentMillis;
 
-    // SEMPRE leggi i dati dal radar (MyLD2410)
-    MyLD2410::Response response = radar.check();
-
-    // Verifica se il radar è connesso (in basic o enhanced mode)
-    if (radar.inBasicMode() || radar.inEnhancedMode()) {
+    // Snapshot pubblicato dal task UART (15_RADAR_UART.ino): parsing e riconnessione
+    // avvengono sul core 0, qui solo una copia in memoria
+    RadarSnapshot radarSnapshot;
+    if (radarGetSnapshot(radarSnapshot) && radarSnapshot.link) {
       // Rileva prima connessione riuscita
       if (!radarConnectedOnce) {
         radarConnectedOnce = true;
@@ -3164,16 +3511,22 @@ void loop() {
       }
 
       // SEMPRE aggiorna il livello luce per la pagina web
-      lastRadarLightLevel = radar.getLightLevel();
+      lastRadarLightLevel = radarSnapshot.light;
+      // Un campione per frame nuovo al filtro del controller luminosità
+      static uint32_t lastLightFrameMs = 0;
+      if (radarSnapshot.engineering && radarSnapshot.frameMs != lastLightFrameMs) {
+        lastLightFrameMs = radarSnapshot.frameMs;
+        backlightFeedLight(BL_SRC_LOCAL, radarSnapshot.light);
+      }
 
       // Verifica se è stata rilevata presenza
       // LOGICA: Rileva SEMPRE sia movimento che target statici
-      bool movementDetected = radar.movingTargetDetected();
-      bool stationaryDetected = radar.stationaryTargetDetected();
+      bool movementDetected = radarSnapshot.moving;
+      bool stationaryDetected = radarSnapshot.stationary;
 
       if (movementDetected || stationaryDetected) {
-        // Presenza rilevata! Aggiorna SEMPRE il timestamp
-        lastPresenceTime = currentMillis;
+        // Presenza rilevata! Aggiorna SEMPRE il timestamp (istante del frame)
+        lastPresenceTime = radarSnapshot.presenceMs;
 
         if (!presenceDetected) {
           presenceDetected = true;
@@ -3182,44 +3535,15 @@ void loop() {
           if (radarServerEnabled) {
             // Ignoro - radar remoto abilitato
           } else {
-            // Forza riaccensione immediata del display (solo se radar remoto non abilitato)
-            uint8_t wakeupBrightness;
-            if (radarBrightnessControl) {
-              // Usa sensore luce radar per luminosità con range configurabile (min-max)
-              uint8_t lightLevel = radar.getLightLevel();
-              wakeupBrightness = map(constrain(lightLevel, 0, 255), 0, 255, radarBrightnessMin, radarBrightnessMax);
-            } else {
-              // Usa luminosità manuale giorno/notte
-              wakeupBrightness = checkIsNightTime(currentHour, currentMinute) ? brightnessNight : brightnessDay;
-            }
-            Serial.printf("[RADAR] Presenza rilevata, lum:%d\n", wakeupBrightness);
-            ledcWrite(PWM_CHANNEL, wakeupBrightness);
-            lastAppliedBrightness = wakeupBrightness;
-          }
-        }
-      }
-    } else {
-      // Radar non connesso - tenta riconnessione ogni 10 secondi
-      static uint32_t lastReconnectAttempt = 0;
-      static uint8_t radarReconnectFails = 0;
-      if (currentMillis - lastReconnectAttempt > 10000) {
-        lastReconnectAttempt = currentMillis;
-
-        // Prova a reinizializzare
-        if (radar.begin()) {
-          Serial.println("[RADAR] Riconnesso OK");
-          radarConnectedOnce = false;
-          radarReconnectFails = 0;
-          radar.enhancedMode(true);
-        } else {
-          radarReconnectFails++;
-          // Stampa solo al primo fallimento, poi ogni 6 tentativi (~60 sec)
-          if (radarReconnectFails == 1 || radarReconnectFails % 6 == 0) {
-            Serial.printf("[RADAR] Non connesso (tentativo %d)\n", radarReconnectFails);
+            // Riaccensione con rampa breve (solo se radar remoto non abilitato): il
+            // controller sceglie luce radar o giorno/notte come per il funzionamento normale
+            Serial.println("[RADAR] Presenza rilevata, riaccensione");
+            backlightRequestUpdate(BL_RAMP_WAKE_MS);
           }
         }
       }
     }
+    // Radar non connesso: la riconnessione e' gestita dal task UART (ogni 10 secondi)
 
     // Verifica se è passato il timeout senza presenza
     if (presenceDetected && (currentMillis - lastPresenceTime > PRESENCE_TIMEOUT)) {
@@ -3229,58 +3553,8 @@ void loop() {
   }
 
   // ========== CONTROLLO LUMINOSITÀ (3 MODALITÀ) ==========
-  // PRIORITÀ: 3=REMOTO, 2=LOCALE, 1=MANUALE
-  if (currentMillis - lastBrightnessUpdate > 200) {
-    lastBrightnessUpdate = currentMillis;
-
-#ifdef EFFECT_DUAL_DISPLAY
-    if (isDualSlave()) {
-      // Slave: luminosita' gestita dal master via SyncPacket
-      // MA se il radar server comanda display OFF, rispetta il comando
-      if (radarServerEnabled && !radarRemotePresence) {
-        ledcWrite(PWM_CHANNEL, 0);
-      } else {
-        ledcWrite(PWM_CHANNEL, lastAppliedBrightness);
-      }
-    } else {
-#endif
-    uint8_t targetBrightness;
-    bool remoteRadarActive = useRemoteRadar();
-    bool localRadarActive = radarAvailable && radarBrightnessControl && !remoteRadarActive;
-
-    // MODALITÀ 3: RADAR REMOTO - gestito dagli handler HTTP
-    if (remoteRadarActive) {
-      // Non fare nulla qui - luminosità gestita da handleRadarBrightness()
-      // Debug rimosso per performance
-    }
-    // RADAR REMOTO ABILITATO MA TIMEOUT - rispetta comunque lo stato presenza
-    else if (radarServerEnabled && !radarRemotePresence) {
-      // Radar server abilitato e nessuna presenza - mantieni display spento
-      // Non sovrascrivere con luminosità manuale
-      // Debug rimosso per performance
-    }
-    // MODALITÀ 2: RADAR LOCALE
-    else if (localRadarActive) {
-      bool shouldTurnOff = setupOptions.powerSaveEnabled && !presenceDetected;
-      if (shouldTurnOff) {
-        targetBrightness = 0;
-      } else {
-        targetBrightness = map(constrain(lastRadarLightLevel, 0, 255), 0, 255, radarBrightnessMin, radarBrightnessMax);
-      }
-      ledcWrite(PWM_CHANNEL, targetBrightness);
-      lastAppliedBrightness = targetBrightness;
-    }
-    // MODALITÀ 1: MANUALE
-    else {
-      bool isNightTime = checkIsNightTime(currentHour, currentMinute);
-      targetBrightness = isNightTime ? brightnessNight : brightnessDay;
-      ledcWrite(PWM_CHANNEL, targetBrightness);
-      lastAppliedBrightness = targetBrightness;
-    }
-#ifdef EFFECT_DUAL_DISPLAY
-    }
-#endif
-  }
+  // PRIORITÀ: 3=REMOTO, 2=LOCALE, 1=MANUALE - filtro, isteresi, gamma e rampe in 0_BACKLIGHT.ino
+  backlightUpdate();
   //#endif
 
   // Gestione audio: audio.loop() e' gestito da audioTask su Core 0
@@ -3381,7 +3655,7 @@ if (currentIsNight != lastWasNightTime) {
       Serial.printf("[LOOP] Mode switch sicuro: da %d a FADE\n", currentMode);
       cleanupPreviousMode(currentMode);
       currentMode = MODE_FADE;
-      forceDisplayUpdate();
+      modeActivate((uint8_t)currentMode);
   #ifdef EFFECT_DUAL_DISPLAY
       }
   #endif
@@ -3453,7 +3727,8 @@ if (currentIsNight != lastWasNightTime) {
 #ifdef EFFECT_DUAL_DISPLAY
   if (!isDualSlave()) {
 #endif
-  if (WiFi.status() == WL_CONNECTED && currentMillis - lastUpdate > 1000) {
+  // Senza un sync NTP riuscito ezTime e' a 1970: si prosegue col conteggio manuale
+  if (WiFi.status() == WL_CONNECTED && timeStatus() != timeNotSet && currentMillis - lastUpdate > 1000) {
     currentHour = myTZ.hour();     // Ottiene l'ora dal fuso orario.
     currentMinute = myTZ.minute();   // Ottiene i minuti.
     currentSecond = myTZ.second();   // Ottiene i secondi.
@@ -3473,20 +3748,11 @@ if (currentIsNight != lastWasNightTime) {
       }
     }
 
-    // Regola la luminosità anche in modalità offline (solo se radar remoto NON attivo)
-    #ifdef AUDIO
-    if (!radarServerEnabled || radarRemotePresence) {
-      // Solo se radar server disabilitato o c'è presenza
-      if(checkIsNightTime(currentHour, currentMinute)) {
-        ledcWrite(PWM_CHANNEL, brightnessNight);
-      } else {
-        ledcWrite(PWM_CHANNEL, brightnessDay);
-      }
-    }
-    #endif
+    // Luminosità in modalità offline: gestita da backlightUpdate() come online
 
     lastUpdate = currentMillis;
   }
+  frameGovServiceAt(lastUpdate + 1001);  // Prossimo scatto dei secondi
 #ifdef EFFECT_DUAL_DISPLAY
   }
 #endif
@@ -3501,6 +3767,8 @@ if (currentIsNight != lastWasNightTime) {
       updateCapodanno();
       lastEffectUpdate = currentMillis;
     }
+    frameGovWakeAt(lastEffectUpdate + 31);
+    frameGovIdle();
     return;  // Esce dal loop senza eseguire altro
   }
 
@@ -3526,6 +3794,7 @@ if (currentIsNight != lastWasNightTime) {
   if (colorCycle.isActive) {
 #endif
     updateColorCycling(currentMillis);
+    frameGovAnimate();
   }
 
   // ========== AGGIORNAMENTO DUAL DISPLAY ESP-NOW ==========
@@ -3600,6 +3869,9 @@ if (currentIsNight != lastWasNightTime) {
       #ifdef EFFECT_CALENDAR
           && !calendarAlarmActive
       #endif
+      #ifdef EFFECT_DUAL_DISPLAY
+          && !dualPresentHold()   // Master: ridisegno all'istante presentUs, come gli slave
+      #endif
       ) {
 
       switch (currentMode) {
@@ -3608,6 +3880,7 @@ if (currentIsNight != lastWasNightTime) {
             updateMatrix();       // Aggiorna l'effetto "Matrix".
             lastEffectUpdate = currentMillis;
           }
+          frameGovWakeAt(lastEffectUpdate + 21);
           blinkWord_E();  // Gestisce il lampeggio della lettera 'E' (se abilitato).
           break;
           
@@ -3616,6 +3889,7 @@ if (currentIsNight != lastWasNightTime) {
             updateMatrix2();      // Aggiorna la seconda variante dell'effetto "Matrix".
             lastEffectUpdate = currentMillis;
           }
+          frameGovWakeAt(lastEffectUpdate + 21);
           blinkWord_E();
           break;
           
@@ -3624,6 +3898,7 @@ if (currentIsNight != lastWasNightTime) {
             updateSnake();        // Aggiorna l'effetto "Snake".
             lastEffectUpdate = currentMillis;
           }
+          frameGovWakeAt(lastEffectUpdate + 21);
           blinkWord_E();
           break;
           
@@ -3632,6 +3907,7 @@ if (currentIsNight != lastWasNightTime) {
             updateWaterDrop();    // Aggiorna l'effetto "Goccia d'acqua".
             lastEffectUpdate = currentMillis;
           }
+          frameGovWakeAt(lastEffectUpdate + 21);
           blinkWord_E();
           break;
 
@@ -3640,6 +3916,7 @@ if (currentIsNight != lastWasNightTime) {
             updateMarioMode();    // Aggiorna l'effetto "Mario Bros".
             lastEffectUpdate = currentMillis;
           }
+          frameGovWakeAt(lastEffectUpdate + 21);
           blinkWord_E();
           break;
 
@@ -3648,6 +3925,7 @@ if (currentIsNight != lastWasNightTime) {
             updateTron();         // Aggiorna l'effetto "Tron".
             lastEffectUpdate = currentMillis;
           }
+          frameGovWakeAt(lastEffectUpdate + 21);
           blinkWord_E();
           break;
 
@@ -3657,6 +3935,7 @@ if (currentIsNight != lastWasNightTime) {
             updateGalagaMode();   // Aggiorna l'effetto "Galaga".
             lastEffectUpdate = currentMillis;
           }
+          frameGovWakeAt(lastEffectUpdate + 21);
           blinkWord_E();
           break;
 #endif
@@ -3667,18 +3946,20 @@ if (currentIsNight != lastWasNightTime) {
             updateGalagaMode2();   // Aggiorna l'effetto "Galaga2" (astronave volante).
             lastEffectUpdate = currentMillis;
           }
+          frameGovWakeAt(lastEffectUpdate + 51);
           blinkWord_E();
           break;
 #endif
 
 #ifdef EFFECT_ANALOG_CLOCK
         case MODE_ANALOG_CLOCK: {
-          // Intervallo di aggiornamento: 33ms (~30fps) se smooth seconds attivo, altrimenti 100ms
-          unsigned long analogClockInterval = clockSmoothSeconds ? 33 : 100;
+          // Intervallo di aggiornamento: 33ms (~30fps) se smooth seconds attivo o dissolvenza skin, altrimenti 100ms
+          unsigned long analogClockInterval = (clockSmoothSeconds || skinFadeActive()) ? 33 : 100;
           if (currentMillis - lastEffectUpdate > analogClockInterval) {
             updateAnalogClock();   // Aggiorna l'orologio analogico.
             lastEffectUpdate = currentMillis;
           }
+          frameGovWakeAt(lastEffectUpdate + analogClockInterval + 1);
           // Non c'è blinkWord_E perché l'orologio analogico non mostra le lettere
           break;
         }
@@ -3699,6 +3980,7 @@ if (currentIsNight != lastWasNightTime) {
             updateBTTF();          // Aggiorna quadrante DeLorean Ritorno al Futuro.
             lastEffectUpdate = currentMillis;
           }
+          frameGovWakeAt(lastEffectUpdate + 1001);
           // Non c'è blinkWord_E perché il quadrante BTTF non usa le parole
           break;
 #endif
@@ -3709,6 +3991,7 @@ if (currentIsNight != lastWasNightTime) {
             updateLedRingClock();  // Aggiorna orologio LED Ring.
             lastEffectUpdate = currentMillis;
           }
+          frameGovWakeAt(lastEffectUpdate + 201);
           // Non usa blinkWord_E perché ha il proprio display digitale
           break;
 #endif
@@ -3720,6 +4003,7 @@ if (currentIsNight != lastWasNightTime) {
             initWeatherStation();  // Disegna sfondo, bordi, labels e dati
           }
           updateWeatherStation();  // Aggiorna solo i dati che cambiano
+          frameGovWakeIn(1000);  // Dati e ora cambiano al massimo una volta al secondo
           break;
 #endif
 
@@ -3730,6 +4014,7 @@ if (currentIsNight != lastWasNightTime) {
             initCalendarStation();  // Disegna sfondo, bordi, labels e dati
           }
           updateCalendarStation();  // Aggiorna solo i dati che cambiano
+          frameGovWakeIn(1000);     // Ridisegno solo al cambio secondo (scatto dell'orologio)
           break;
 #endif
 
@@ -3739,6 +4024,7 @@ if (currentIsNight != lastWasNightTime) {
             initYoutubeStation();  // Disegna schermo completo YouTube
           }
           updateYoutubeStation();  // Smart update ogni 5 min
+          frameGovWakeIn(1000);
           break;
 #endif
 
@@ -3748,6 +4034,7 @@ if (currentIsNight != lastWasNightTime) {
             initNewsStation();  // Disegna schermo completo News
           }
           updateNewsStation();  // Smart update ogni 10 min
+          frameGovWakeIn(1000);
           break;
 #endif
 
@@ -3846,6 +4133,9 @@ if (currentIsNight != lastWasNightTime) {
             lastEffectUpdate = currentMillis;           
           }
           blinkWord_E();                    
+          // Sequenza parole in corso: passo successivo; completata: scena ferma fino al secondo successivo
+          if (fadePhase != FADE_DONE) frameGovWakeAt(lastEffectUpdate + 21);
+          else frameGovWakeIn(1000);
           break;
           
         case MODE_SLOW:
@@ -3854,6 +4144,8 @@ if (currentIsNight != lastWasNightTime) {
             lastEffectUpdate = currentMillis;           
           }
           blinkWord_E();                    
+          if (!fadeDone) frameGovWakeAt(lastEffectUpdate + 21);
+          else frameGovWakeIn(1000);
           break;
           
         case MODE_FAST: {
@@ -3874,10 +4166,13 @@ if (currentIsNight != lastWasNightTime) {
           } else {
             blinkWord_E();
           }
+          frameGovWakeIn(1000);   // Cambia solo allo scatto dei secondi (lampeggio E) o del minuto
           break;
         }
       }
       } // Fine if (!gasAlarmActive)
+    } else {
+      frameGovWakeIn(1000);  // Display spento da Alexa: nessun ridisegno, solo servizi
     }
   }
 
@@ -3892,8 +4187,9 @@ if (currentIsNight != lastWasNightTime) {
   updateLedRgb();
   #endif
 
-  // Permette al watchdog timer dell'ESP32 di non resettare il dispositivo
-  yield();
+  // Fine frame: attende la prossima scadenza dichiarata (o un evento) invece di ripartire
+  // subito; senza dichiarazioni equivale a yield() (0_FRAME_GOVERNOR.ino)
+  frameGovIdle();
 }
 
 // GESTIONE LETTERA E con lampeggio basato sui secondi
@@ -3930,19 +4226,19 @@ void blinkWord_E(){
 // Funzione per verificare se tutti e quattro gli angoli del touch screen sono premuti all'avvio
 bool checkCornersAtBoot() {
   // Leggi lo stato del touch screen
-  ts.read();
+  touchRead();
   
   // Se non ci sono almeno 4 tocchi, ritorna falso
-  if (ts.touches < 4) return false;
+  if (touchState.touches < 4) return false;
   
   // Variabili per tenere traccia se ogni angolo è stato toccato
   bool tl = false, tr = false, bl = false, br = false; // Top-Left, Top-Right, Bottom-Left, Bottom-Right
   
   // Controlla tutti i punti di contatto rilevati
-  for (int i = 0; i < ts.touches && i < 10; i++) {
+  for (int i = 0; i < touchState.touches && i < 10; i++) {
     // Mappa le coordinate del touch screen alle coordinate del display (0-479)
-    int x = map(ts.points[i].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
-    int y = map(ts.points[i].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
+    int x = map(touchState.points[i].x, TOUCH_MAP_X1, TOUCH_MAP_X2, 0, 480 - 1);
+    int y = map(touchState.points[i].y, TOUCH_MAP_Y1, TOUCH_MAP_Y2, 0, 480 - 1);
     
     // Verifica se il punto di contatto rientra in una delle zone degli angoli (con un margine di 100 pixel)
     if (x < 100 && y < 100) tl = true;
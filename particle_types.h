@@ -0,0 +1,75 @@
+#ifndef PARTICLE_TYPES_H
+#define PARTICLE_TYPES_H
+
+#include <Arduino.h>
+
+// ================== DEFINIZIONI TIPI PER IL MOTORE PARTICELLE (0_PARTICLES.ino) ==================
+// Le struct stanno in un header perche' i callback degli effetti (14_CAPODANNO, 27_FLUX_CAPACITOR,
+// 28_CHRISTMAS) le usano nella firma e i prototipi generati dall'IDE finiscono in cima allo sketch.
+
+// Posizioni e velocità in virgola fissa Q8 (1 pixel = 256)
+#define PART_SHIFT    8
+#define PART_ONE      (1 << PART_SHIFT)
+#define PART_PX(n)    ((int32_t)(n) * PART_ONE)
+#define PART_INT(q)   ((int16_t)((q) >> PART_SHIFT))
+
+// Sprite del renderer (footprint in pixel attorno alla posizione)
+#define PART_SPRITE_DOT     0   // 1 pixel
+#define PART_SPRITE_SMALL   1   // 3 pixel a L: (x,y) (x+1,y) (x,y+1)
+#define PART_SPRITE_PLUS    2   // Croce di 5 pixel
+#define PART_SPRITE_DISC    3   // Disco raggio 2 (21 pixel)
+#define PART_SPRITE_STREAK  4   // Scia lungo la velocità (ultimi 2 frame), testa più luminosa
+
+// Flag del sistema
+#define PART_FLAG_FADE      0x01  // Il colore sfuma sullo strato di sfondo con la vita residua (aux = vita iniziale)
+#define PART_FLAG_KEYED     0x02  // Disegna solo sui pixel dello strato con colore in [keyLo, keyHi]
+
+struct ParticleSystem;
+
+// Callback per sistema: l'emettitore crea particelle, l'integratore le muove (nullptr = standard)
+typedef void (*ParticleEmitFn)(ParticleSystem* ps, uint32_t now);
+typedef void (*ParticleIntegrateFn)(ParticleSystem* ps);
+
+// Sistema di particelle: storage a strutture di array (un blocco unico in PSRAM)
+struct ParticleSystem {
+  int32_t*  x;          // Posizione Q8
+  int32_t*  y;
+  int32_t*  vx;         // Velocità Q8 in pixel/frame
+  int32_t*  vy;
+  uint16_t* life;       // Frame residui (l'integratore standard elimina a 0)
+  uint16_t* aux;        // Dato libero per effetto (vita iniziale con PART_FLAG_FADE)
+  uint16_t* color;      // RGB565
+  uint8_t*  sprite;     // PART_SPRITE_*
+  uint16_t  capacity;
+  uint16_t  count;      // Particelle vive: sempre compatte in [0, count)
+  int32_t   gravity;    // Q8 pixel/frame² sommata a vy dall'integratore standard
+  uint8_t   flags;      // PART_FLAG_*
+  uint16_t  keyLo;      // Intervallo colore dello strato per PART_FLAG_KEYED
+  uint16_t  keyHi;
+  ParticleEmitFn      emit;
+  ParticleIntegrateFn integrate;
+  void*     block;      // Allocazione unica dello storage
+};
+
+// Destinazione del renderer: frame buffer + strato di sfondo in cache da cui ripristinare
+// i pixel toccati nel frame precedente (rettangoli registrati durante il disegno).
+struct ParticleCanvas {
+  uint16_t*       fb;
+  const uint16_t* layer;        // nullptr = sfondo nero
+  int16_t         w, h;
+  int16_t*        rects;        // Rettangoli (x0,y0,x1,y1 inclusi) disegnati nel frame
+  uint16_t        rectCap;
+  uint16_t        rectCount;
+  uint32_t        rectArea;     // Area totale (per scegliere tra ripristino a rettangoli e copia intera)
+  bool            fullRestore;  // Prossimo ripristino: copia intera dello strato
+  int16_t         dirtyY0;      // Banda di righe da trasferire al display
+  int16_t         dirtyY1;
+  int16_t*        blits;        // Rettangoli da trasferire nel frame (ripristinati, disegnati, aggiornati)
+  uint16_t        blitCap;
+  uint16_t        blitCount;
+  uint16_t        blitRestored; // I primi blitRestored sono i rettangoli ripristinati, nell'ordine di disegno
+  uint32_t        blitCost;     // Costo stimato (pixel scritti + chiamate) per confrontarlo con la banda
+  bool            blitBand;     // Lista piena o copia intera: si trasferisce la banda di righe
+};
+
+#endif // PARTICLE_TYPES_H
@@ -0,0 +1,2 @@
+// Host build: headers of the sketch include <Arduino.h>; the names they need are in sketch_host.h
+#include "sketch_host.h"
@@ -0,0 +1,33 @@
+// Host build: the part of ESP32-A2DP (BluetoothA2DPSource) used by 25_BLUETOOTH_AUDIO.ino. No radio:
+// start() keeps the data callback for the test to call, the connection is reported as made at once.
+
+#ifndef BLUETOOTH_A2DP_SOURCE_HOST_H
+#define BLUETOOTH_A2DP_SOURCE_HOST_H
+
+struct Frame {
+    int16_t channel1;
+    int16_t channel2;
+};
+
+enum esp_a2d_connection_state_t {
+    ESP_A2D_CONNECTION_STATE_DISCONNECTED,
+    ESP_A2D_CONNECTION_STATE_CONNECTING,
+    ESP_A2D_CONNECTION_STATE_CONNECTED,
+    ESP_A2D_CONNECTION_STATE_DISCONNECTING
+};
+
+class BluetoothA2DPSource {
+public:
+    typedef int32_t (*DataCallback)(Frame *, int32_t);
+    typedef void (*StateCallback)(esp_a2d_connection_state_t, void *);
+
+    DataCallback hostData = nullptr;
+
+    void set_auto_reconnect(bool) {}
+    void set_volume(uint8_t) {}
+    void start(const char *, DataCallback cb) { hostData = cb; }
+    void set_on_connection_state_changed(StateCallback cb) { cb(ESP_A2D_CONNECTION_STATE_CONNECTED, nullptr); }
+    void end() { hostData = nullptr; }
+};
+
+#endif
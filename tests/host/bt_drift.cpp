@@ -0,0 +1,164 @@
+// Host simulation of the Bluetooth audio path (25_BLUETOOTH_AUDIO.ino): /audio_pcm records from a server
+// whose clock is off by N ppm -> updateBtAudioReceive() (record parser, SPSC ring, drift PI loop) ->
+// btAudioDataCallback() pulled at exactly 44.1 kHz like the A2DP task.
+//
+//  - records: [timestamp][length][PCM] split across reads of any size, a short record in the middle;
+//    the ring gets exactly the PCM and audioTimestamp is the time of the audio at the head of the ring
+//  - hold: the silence request is consumed from what was read, never below zero
+//  - drift: +-200, -350, +-480 ppm for 600 s with the video timestamps of the frames on screen; the
+//    integral term converges to the offset, no underruns once settled, lip-sync error in the last minute
+//
+//   make bt_drift && ./bt_drift          exit code 1 if a check fails
+
+#include <stdarg.h>
+#include "web_host.h"
+
+#define EFFECT_MJPEG_STREAM
+void setBtVideoTimestamp(unsigned long timestamp);
+void setBtAudioTimestamp(unsigned long timestamp);
+#include "../../25_BLUETOOTH_AUDIO.ino"
+
+#define RECORD_FRAMES   1024            // Blocco di stream_server.py (4096 byte)
+#define LOOP_MS         40              // updateBtAudioReceive() una volta per frame MJPEG
+#define VIDEO_MS        40              // Frame video a 25 fps
+#define SINK_FRAMES     128             // Frame chiesti per callback A2DP
+#define AUDIO_LEAD_MS   100             // Anticipo dell'audio inviato dal server sul video
+#define RUN_S           600
+#define SETTLE_S        120
+
+static int failures = 0;
+
+static void check(bool ok, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%s ", ok ? "  ok  " : "FAILED");
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+    if (!ok) failures++;
+}
+
+static inline uint32_t pcmFrame(uint32_t k) { return (k & 0xFFFF) | ((k * 3u) & 0xFFFF) << 16; }
+
+// Blocco come generate_audio_pcm_stream(): timestamp e lunghezza big-endian, poi il PCM
+static void sendRecord(WiFiClient &c, uint32_t ts, uint32_t firstFrame, uint32_t frames)
+{
+    uint8_t h[8] = { (uint8_t)(ts >> 24), (uint8_t)(ts >> 16), (uint8_t)(ts >> 8), (uint8_t)ts };
+    uint32_t len = frames * 4;
+    h[4] = len >> 24; h[5] = len >> 16; h[6] = len >> 8; h[7] = len;
+    c.hostSend(h, sizeof(h));
+    for (uint32_t k = 0; k < frames; k++) {
+        uint32_t f = pcmFrame(firstFrame + k);
+        c.hostSend(&f, 4);
+    }
+}
+
+static void startStream()
+{
+    btAudioEnabled = false;
+    initBtAudio();
+    startBtAudioStream("host");
+    btAudioClient = WiFiClient();
+    connectBtAudioHttp("http://host:5000");
+    videoTimestamp = 0;
+}
+
+static void recordTest()
+{
+    startStream();
+    const uint32_t sizes[] = { RECORD_FRAMES, RECORD_FRAMES, 250, RECORD_FRAMES, RECORD_FRAMES };
+    uint32_t frame = 0, ts = 5000;
+    for (uint32_t s : sizes) {
+        sendRecord(btAudioClient, ts, frame, s);
+        frame += s;
+        ts += s * 1000 / BT_AUDIO_SAMPLE_RATE;
+    }
+    // Letture di 1..97 byte: intestazioni e frame spezzati ovunque
+    while (btAudioClient.available() > 0) {
+        btAudioClient.hostRxChunk = 1 + random(97);
+        updateBtAudioReceive();
+    }
+
+    uint32_t head = btRingHead.load(), tail = btRingTail.load();
+    bool same = head - tail == frame;
+    for (uint32_t k = 0; same && k < frame; k++) same = btAudioRing[(tail + k) & (BT_AUDIO_RING_FRAMES - 1)] == pcmFrame(k);
+    check(same, "records: %u PCM frames in the ring, no header bytes (got %u)", frame, head - tail);
+    uint32_t lastTs = ts - RECORD_FRAMES * 1000 / BT_AUDIO_SAMPLE_RATE;
+    check(audioTimestamp == lastTs + 1000UL * RECORD_FRAMES / BT_AUDIO_SAMPLE_RATE,
+          "records: audio timestamp at the ring head %lu ms (expected %u)", audioTimestamp,
+          (unsigned)(lastTs + 1000UL * RECORD_FRAMES / BT_AUDIO_SAMPLE_RATE));
+}
+
+static void holdTest()
+{
+    startStream();
+    static Frame out[SINK_FRAMES];
+    btAudioRing[0] = 0x12345678;
+    uint32_t held0 = btHeldFrames;
+    btRingHold.store(300);
+    btAudioDataCallback(out, SINK_FRAMES);
+    check(btRingHold.load() == 300 - SINK_FRAMES && btHeldFrames - held0 == SINK_FRAMES,
+          "hold: one callback takes %d frames of a 300 frame request (left %u)", SINK_FRAMES, btRingHold.load());
+    btRingHold.store(50);               // Nuova richiesta del loop, piu' piccola del blocco
+    btAudioDataCallback(out, SINK_FRAMES);
+    check(btRingHold.load() == 0 && btHeldFrames - held0 == SINK_FRAMES + 50,
+          "hold: a smaller request is consumed to zero, not wrapped (left %u)", btRingHold.load());
+}
+
+// Server con clock sfasato di ppm: tempo del video = tempo reale * (1 + ppm); audio inviato a blocchi
+// AUDIO_LEAD_MS avanti, il frame video a schermo e' quello del tempo corrente
+static void driftRun(double ppm)
+{
+    startStream();
+    uint32_t underruns0 = btUnderruns, resyncs0 = btResyncs;
+    const uint32_t startMs = 1000;      // Il video parte da 1 s (0 = timestamp sconosciuto)
+    double mediaMs = 0, sinkAcc = 0;
+    uint32_t sentFrames = 0, nextVideo = 0, settledUnderruns = 0;
+    int32_t worstLipSync = 0;
+    static Frame out[SINK_FRAMES];
+
+    for (uint32_t t = 1; t <= RUN_S * 1000u; t++) {
+        hostMillis++;
+        mediaMs += 1.0 + ppm * 1e-6;
+
+        while ((sentFrames + RECORD_FRAMES) * 1000.0 / BT_AUDIO_SAMPLE_RATE <= mediaMs + AUDIO_LEAD_MS) {
+            sendRecord(btAudioClient, startMs + (uint32_t)(sentFrames * 1000ULL / BT_AUDIO_SAMPLE_RATE), sentFrames, RECORD_FRAMES);
+            sentFrames += RECORD_FRAMES;
+        }
+        if (mediaMs >= nextVideo) {
+            setBtVideoTimestamp(startMs + nextVideo);
+            nextVideo += VIDEO_MS;
+        }
+        if (t % LOOP_MS == 0) {
+            updateBtAudioReceive();
+            if (t > (RUN_S - 60) * 1000u) worstLipSync = std::max(worstLipSync, (int32_t)abs(btLipSyncMs));
+        }
+
+        sinkAcc += BT_AUDIO_SAMPLE_RATE / 1000.0;
+        if (sinkAcc >= SINK_FRAMES) {
+            sinkAcc -= SINK_FRAMES;
+            uint32_t before = btUnderruns;
+            btAudioDataCallback(out, SINK_FRAMES);
+            if (t > SETTLE_S * 1000u) settledUnderruns += btUnderruns - before;
+        }
+    }
+
+    check(fabs(btDriftPpm - ppm) < 25, "drift %+5.0f ppm: estimate %+6.1f ppm, correction %+6.1f ppm", ppm, btDriftPpm, btCorrectionPpm);
+    check(settledUnderruns == 0, "drift %+5.0f ppm: %u underruns after %d s (%u in all, %u resyncs)", ppm,
+          settledUnderruns, SETTLE_S, btUnderruns - underruns0, btResyncs - resyncs0);
+    check(worstLipSync <= 10, "drift %+5.0f ppm: lip-sync error in the last minute <= %d ms (target %d ms)", ppm,
+          worstLipSync, btTargetFillMs);
+    stopBtAudioStream();
+}
+
+int main()
+{
+    hostMillis = 1;
+    recordTest();
+    holdTest();
+    const double offsets[] = { 200, -200, -350, 480, -480 };
+    for (double ppm : offsets) driftRun(ppm);
+    printf("%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
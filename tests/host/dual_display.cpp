@@ -0,0 +1,562 @@
+// Host simulation of the dual display protocol (44_DUAL_DISPLAY.ino): a master and 3 slaves, each one a
+// full copy of the module in its own namespace (dual_node.h) with its own esp_timer clock, talking over a
+// simulated ESP-NOW channel (one radio, latency, jitter, loss with MAC retries on unicast, reordering).
+// Every packet goes through DualTransport and onDualDataRecv(), the loop is updateDualDisplay().
+//
+//  - discovery: the slaves broadcast PKT_DISCOVERY_REQ, the master assigns (1,0), (0,1), (1,1) in a 2x2 grid
+//  - clock: the ping/pong offset estimate of every slave against the real clock offsets
+//  - sync: every frame applied by a slave (processSyncPacket) equals the master state it was sent with,
+//    settings change mid-run, a mode change cleans up the old mode once; presentation skew between the
+//    4 panels at presentUs against the arrival skew
+//  - touch: forwardTouchToMaster() from each slave lands on the master in virtual coordinates
+//  - loss: 20% loss, losses counted and recovered by keyframes, equal state afterwards
+//  - reorder: late frames dropped as stale, the applied frame counter never goes back
+//  - master reboot: keyframe delivered, keyframe lost, reboot after 5 frames (reorder window), reboot after
+//    5 frames with 4 s of silence (resync after DUAL_RX_RESYNC_MS)
+//
+//   make dual_display && ./dual_display          exit code 1 if a check fails
+
+#include <stdarg.h>
+#include <map>
+#include "web_host.h"
+#include "dual_host.h"
+
+#define NODES        4                  // Master (nodo 0) + 3 slave
+#define TICK_US      100                // Passo del loop di ogni pannello
+#define RADIO_RETRIES 3                 // Ritrasmissioni MAC unicast (ESP-NOW con ACK)
+
+static int failures = 0;
+
+static void check(bool ok, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%s ", ok ? "  ok  " : "FAILED");
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+    if (!ok) failures++;
+}
+
+// Tempo del test in us: millis() di tutti i pannelli, esp_timer con lo scostamento di ognuno
+static uint64_t hostUs = 0;
+
+static void setTime(uint64_t us)
+{
+    hostUs = us;
+    hostMillis = (uint32_t)(us / 1000);
+}
+
+// Stato di un pannello letto dopo un giro del loop
+struct NodeState {
+    // Stato applicato (master: quello inviato)
+    uint8_t mode, hour, minute, second, r, g, b, brightness, preset;
+    bool rainbow;
+    uint8_t brightnessDay, brightnessNight, volumeDay, volumeNight;
+    uint64_t enabledModes;
+    bool ledEnabled, ledOverride;
+    uint8_t ledBrightness, ledR, ledG, ledB, ledAudio;
+    uint8_t snakePath;
+    uint16_t snakeIndex;
+    bool snakeDone;
+    uint16_t snakeSeg[8];
+    int16_t ball[4], paddle;
+    uint16_t score;
+    uint8_t lives, speed;
+    bool over, win;
+    uint8_t bricks[10];
+    uint16_t frameCounter;
+    // Protocollo
+    uint8_t role, panelX, panelY, gridW, gridH, peerCount;
+    bool proxy;
+    uint8_t peerNode[3], peerX[3], peerY[3];     // Nodo (ultimo byte del MAC) e posizione di ogni peer
+    uint32_t rxLost, rxStale, rxResyncs, recoveries;
+    uint16_t clockSamples;
+    int64_t clockOffsetUs;
+    uint32_t cleanups;
+    uint8_t cleanupMode;
+    bool breakoutInitialized;
+    int touches, touchX, touchY;
+};
+
+// Cosa fa il master: modo corrente e luminosita' giorno (blocco impostazioni)
+struct MasterScript {
+    DisplayMode mode;
+    uint8_t brightnessDay;
+};
+
+struct NodeApi {
+    void (*begin)(bool master);
+    void (*recv)(const uint8_t *mac, const uint8_t *data, int len);
+    int32_t (*loop)();
+    void (*animate)(const MasterScript &s);
+    void (*reboot)();
+    void (*snapshot)(NodeState &s);
+    void (*touch)(int x, int y);
+    int64_t *clockOffsetUs;
+};
+
+static esp_err_t netSend(uint8_t src, const uint8_t *mac, const uint8_t *data, size_t len);
+
+#define EFFECT_BREAKOUT
+
+namespace node0 {
+static const uint8_t hostNode = 0;
+#include "dual_node.h"
+#include "../../44_DUAL_DISPLAY.ino"
+#define DUAL_NODE_API
+#include "dual_node.h"
+#undef DUAL_NODE_API
+}
+namespace node1 {
+static const uint8_t hostNode = 1;
+#include "dual_node.h"
+#include "../../44_DUAL_DISPLAY.ino"
+#define DUAL_NODE_API
+#include "dual_node.h"
+#undef DUAL_NODE_API
+}
+namespace node2 {
+static const uint8_t hostNode = 2;
+#include "dual_node.h"
+#include "../../44_DUAL_DISPLAY.ino"
+#define DUAL_NODE_API
+#include "dual_node.h"
+#undef DUAL_NODE_API
+}
+namespace node3 {
+static const uint8_t hostNode = 3;
+#include "dual_node.h"
+#include "../../44_DUAL_DISPLAY.ino"
+#define DUAL_NODE_API
+#include "dual_node.h"
+#undef DUAL_NODE_API
+}
+
+static const NodeApi *node[NODES] = { &node0::hostApi, &node1::hostApi, &node2::hostApi, &node3::hostApi };
+
+// ===== Canale radio =====
+// Un solo canale condiviso: un invio parte quando il precedente e' finito. Unicast: fino a RADIO_RETRIES
+// ritrasmissioni (ognuna costa un altro slot radio); broadcast: una trasmissione, ogni pannello la riceve
+// (o la perde) per conto suo, nessun ACK
+struct NetPacket {
+    uint64_t deliverUs;
+    uint32_t order;                     // Ordine di accodamento, a parita' di istante di consegna
+    uint8_t src, dst, len;
+    uint8_t data[250];
+};
+
+static struct {
+    uint32_t latencyUs, jitterUs;
+    uint8_t lossPct, reorderPct;
+    uint32_t rng;
+    uint64_t radioFreeUs;
+    uint32_t order;
+    bool dropNextSync;                  // Perde il prossimo PKT_FRAME_SYNC (keyframe dopo un riavvio)
+    uint32_t sent, dropped, retries, reordered;
+} chan;
+
+static std::vector<NetPacket> net;
+static bool nodeOff[NODES];
+
+static uint32_t chanRand()
+{
+    chan.rng ^= chan.rng << 13;
+    chan.rng ^= chan.rng >> 17;
+    chan.rng ^= chan.rng << 5;
+    return chan.rng;
+}
+
+static uint32_t airtimeUs(size_t len, bool unicast) { return 192 + (uint32_t)(len + 43) * 8 + (unicast ? 304 : 0); }
+
+static void netEnqueue(uint8_t src, uint8_t dst, const uint8_t *data, size_t len, bool unicast)
+{
+    uint64_t t = std::max(hostUs, chan.radioFreeUs);
+    int attempts = unicast ? 1 + RADIO_RETRIES : 1;
+    bool ok = false;
+    for (int a = 0; a < attempts && !ok; a++) {
+        t += airtimeUs(len, unicast);
+        if (a > 0) chan.retries++;
+        ok = chanRand() % 100 >= chan.lossPct;
+    }
+    chan.radioFreeUs = t;
+    chan.sent++;
+    if (!ok) {
+        chan.dropped++;
+        return;
+    }
+    NetPacket p;
+    p.deliverUs = t + chan.latencyUs + (chan.jitterUs ? chanRand() % chan.jitterUs : 0);
+    if (chan.reorderPct && chanRand() % 100 < chan.reorderPct) {
+        p.deliverUs += (uint64_t)DUAL_SYNC_INTERVAL_MS * 1000 * (1 + chanRand() % 2);
+        chan.reordered++;
+    }
+    p.order = chan.order++;
+    p.src = src;
+    p.dst = dst;
+    p.len = len;
+    memcpy(p.data, data, len);
+    net.push_back(p);
+}
+
+static esp_err_t netSend(uint8_t src, const uint8_t *mac, const uint8_t *data, size_t len)
+{
+    if (len > 250) return ESP_ERR_INVALID_ARG;
+    if (chan.dropNextSync && len > 1 && data[1] == PKT_FRAME_SYNC) {
+        chan.dropNextSync = false;
+        return ESP_OK;
+    }
+    if (mac[0] == 0xFF) {
+        uint64_t radioStart = chan.radioFreeUs;
+        uint64_t radioEnd = radioStart;
+        for (uint8_t n = 0; n < NODES; n++) {
+            if (n == src) continue;
+            chan.radioFreeUs = radioStart;
+            netEnqueue(src, n, data, len, false);
+            radioEnd = chan.radioFreeUs;
+        }
+        chan.radioFreeUs = radioEnd;
+    } else if (mac[5] < NODES) {
+        netEnqueue(src, mac[5], data, len, true);
+    }
+    return ESP_OK;
+}
+
+// ===== Misure =====
+struct FrameTimes {
+    uint64_t arriveUs[NODES];           // Arrivo del PKT_FRAME_SYNC (solo slave)
+    uint64_t presentUs[NODES];
+};
+
+static std::map<uint16_t, FrameTimes> frameTimes;
+static std::map<uint16_t, NodeState> sentState;     // Stato del master per ogni frame inviato
+static bool verifyFrames = false;
+static uint16_t masterFrame = 0;
+static uint32_t mismatches = 0, applied[NODES], regressions = 0;
+static int32_t lastApplied[NODES];
+
+static void resetMeasures()
+{
+    frameTimes.clear();
+    sentState.clear();
+    mismatches = regressions = 0;
+    for (int n = 0; n < NODES; n++) {
+        applied[n] = 0;
+        lastApplied[n] = -1;
+    }
+}
+
+static bool sameState(const NodeState &a, const NodeState &b)
+{
+    if (a.mode != b.mode || a.hour != b.hour || a.minute != b.minute || a.second != b.second) return false;
+    if (a.r != b.r || a.g != b.g || a.b != b.b || a.brightness != b.brightness || a.preset != b.preset) return false;
+    if (a.rainbow != b.rainbow || a.brightnessDay != b.brightnessDay || a.brightnessNight != b.brightnessNight) return false;
+    if (a.volumeDay != b.volumeDay || a.volumeNight != b.volumeNight || a.enabledModes != b.enabledModes) return false;
+    if (a.ledEnabled != b.ledEnabled || a.ledBrightness != b.ledBrightness || a.ledOverride != b.ledOverride) return false;
+    if (a.ledR != b.ledR || a.ledG != b.ledG || a.ledB != b.ledB || a.ledAudio != b.ledAudio) return false;
+    if (a.mode == MODE_SNAKE) {
+        if (a.snakePath != b.snakePath || a.snakeIndex != b.snakeIndex || a.snakeDone != b.snakeDone) return false;
+        if (memcmp(a.snakeSeg, b.snakeSeg, sizeof(a.snakeSeg)) != 0) return false;
+    }
+    if (a.mode == MODE_BREAKOUT) {
+        if (memcmp(a.ball, b.ball, sizeof(a.ball)) != 0 || a.paddle != b.paddle || a.score != b.score) return false;
+        if (a.lives != b.lives || a.speed != b.speed || a.over != b.over || a.win != b.win) return false;
+        if (memcmp(a.bricks, b.bricks, sizeof(a.bricks)) != 0) return false;
+    }
+    return true;
+}
+
+// ===== Simulazione =====
+static MasterScript script = { MODE_SNAKE, 200 };
+
+static void deliver(const NetPacket &p)
+{
+    if (nodeOff[p.dst]) return;
+    if (p.len >= 8 && p.data[0] == DUAL_MAGIC && p.data[1] == PKT_FRAME_SYNC && p.dst != 0) {
+        uint16_t fc = p.data[6] | p.data[7] << 8;
+        FrameTimes &ft = frameTimes[fc];
+        if (!ft.arriveUs[p.dst]) ft.arriveUs[p.dst] = hostUs;
+    }
+    uint8_t mac[6];
+    memcpy(mac, node0::hostMac, 5);
+    mac[5] = p.src;
+    node[p.dst]->recv(mac, p.data, p.len);
+}
+
+static void presented(int n, uint16_t f)
+{
+    FrameTimes &ft = frameTimes[f];
+    if (!ft.presentUs[n]) ft.presentUs[n] = hostUs;
+    applied[n]++;
+    if (lastApplied[n] >= 0 && (int16_t)(f - (uint16_t)lastApplied[n]) < 0) regressions++;
+    lastApplied[n] = f;
+    if (n == 0 || !verifyFrames) return;
+    NodeState s;
+    node[n]->snapshot(s);
+    std::map<uint16_t, NodeState>::iterator it = sentState.find(f);
+    if (it == sentState.end() || !sameState(s, it->second)) mismatches++;
+}
+
+// Avanza di ms millisecondi: consegne all'istante esatto, poi un giro del loop di ogni pannello acceso
+static void run(uint32_t ms)
+{
+    uint64_t end = hostUs + (uint64_t)ms * 1000;
+    while (hostUs < end) {
+        uint64_t tick = hostUs + TICK_US;
+        for (;;) {
+            int best = -1;
+            for (int i = 0; i < (int)net.size(); i++) {
+                if (net[i].deliverUs > tick) continue;
+                if (best < 0 || net[i].deliverUs < net[best].deliverUs ||
+                    (net[i].deliverUs == net[best].deliverUs && net[i].order < net[best].order)) best = i;
+            }
+            if (best < 0) break;
+            NetPacket p = net[best];
+            net.erase(net.begin() + best);
+            setTime(std::max(hostUs, p.deliverUs));
+            deliver(p);
+        }
+        setTime(tick);
+        for (int n = 0; n < NODES; n++) {
+            if (nodeOff[n]) continue;
+            if (n == 0) node[0]->animate(script);
+            int32_t f = node[n]->loop();
+            if (n == 0) {
+                // Stato con cui il master ha appena inviato un frame
+                NodeState s;
+                node[0]->snapshot(s);
+                if (s.frameCounter != masterFrame) sentState[(uint16_t)(s.frameCounter - 1)] = s;
+                masterFrame = s.frameCounter;
+            }
+            if (f >= 0) presented(n, (uint16_t)f);
+        }
+    }
+}
+
+static void snapshots(NodeState s[NODES])
+{
+    for (int n = 0; n < NODES; n++) node[n]->snapshot(s[n]);
+}
+
+// Stato degli slave uguale a quello del master dopo che l'ultimo frame e' stato applicato ovunque
+static bool allEqual(const char *what)
+{
+    run(DUAL_SYNC_INTERVAL_MS / 2);
+    NodeState s[NODES];
+    snapshots(s);
+    bool ok = true;
+    for (int n = 1; n < NODES; n++) {
+        std::map<uint16_t, NodeState>::iterator it = sentState.find((uint16_t)lastApplied[n]);
+        ok = ok && it != sentState.end() && sameState(s[n], it->second) && lastApplied[n] == lastApplied[0];
+    }
+    check(ok, "%s: slaves on frame %d/%d/%d, master on %d, same state", what, lastApplied[1], lastApplied[2],
+          lastApplied[3], lastApplied[0]);
+    return ok;
+}
+
+// Skew (max - min) tra i pannelli per i frame arrivati e presentati da tutti. Oltre SKEW_LATE_US il frame
+// e' arrivato a uno slave dopo presentUs (in coda dietro heartbeat e ping sul canale): applicato all'arrivo
+#define SKEW_LATE_US 1500
+struct Skew { uint32_t frames, late, arriveAvg, arriveMax, presentAvg, presentMax; };
+
+static Skew skew()
+{
+    Skew k = {};
+    uint64_t aSum = 0, pSum = 0;
+    for (std::map<uint16_t, FrameTimes>::iterator it = frameTimes.begin(); it != frameTimes.end(); ++it) {
+        const FrameTimes &ft = it->second;
+        uint64_t aMin = UINT64_MAX, aMax = 0, pMin = UINT64_MAX, pMax = 0;
+        bool all = true;
+        for (int n = 0; n < NODES; n++) {
+            if (!ft.presentUs[n] || (n && !ft.arriveUs[n])) { all = false; break; }
+            pMin = std::min(pMin, ft.presentUs[n]);
+            pMax = std::max(pMax, ft.presentUs[n]);
+            if (!n) continue;
+            aMin = std::min(aMin, ft.arriveUs[n]);
+            aMax = std::max(aMax, ft.arriveUs[n]);
+        }
+        if (!all) continue;
+        k.frames++;
+        if (pMax - pMin > SKEW_LATE_US) k.late++;
+        aSum += aMax - aMin;
+        pSum += pMax - pMin;
+        k.arriveMax = std::max(k.arriveMax, (uint32_t)(aMax - aMin));
+        k.presentMax = std::max(k.presentMax, (uint32_t)(pMax - pMin));
+    }
+    if (k.frames) {
+        k.arriveAvg = aSum / k.frames;
+        k.presentAvg = pSum / k.frames;
+    }
+    return k;
+}
+
+// Master riavviato: fermo per silentMs, poi riparte da seq 0 (keyframe perso se lostKf).
+// Ritorna il primo frame applicato da tutti gli slave dopo il riavvio (-1 se nessuno)
+static int32_t rebootMaster(uint32_t silentMs, bool lostKf, uint32_t runMs)
+{
+    nodeOff[0] = true;
+    run(silentMs);
+    nodeOff[0] = false;
+    node[0]->reboot();
+    resetMeasures();
+    chan.dropNextSync = lostKf;
+    run(runMs);
+    int32_t first = -1;
+    for (std::map<uint16_t, FrameTimes>::iterator it = frameTimes.begin(); it != frameTimes.end() && first < 0; ++it) {
+        bool all = true;
+        for (int n = 1; n < NODES; n++) all = all && it->second.presentUs[n];
+        if (all) first = it->first;
+    }
+    return first;
+}
+
+int main()
+{
+    // Orologi: ogni pannello avviato in un momento diverso
+    static const int64_t offsetUs[NODES] = { 2500000, 731000, 9120000, 15333 };
+    for (int n = 0; n < NODES; n++) *node[n]->clockOffsetUs = offsetUs[n];
+    chan.latencyUs = 1200;
+    chan.jitterUs = 2000;
+    chan.rng = 0x1234567;
+    setTime(1000000);
+    resetMeasures();
+
+    // ===== Discovery =====
+    node[0]->begin(true);
+    for (int n = 1; n < NODES; n++) node[n]->begin(false);
+    run(8000);
+    NodeState s[NODES];
+    snapshots(s);
+    bool pos[2][2] = {};
+    bool ok = s[0].peerCount == 3 && s[0].proxy;
+    for (int n = 1; n < NODES; n++) {
+        ok = ok && s[n].peerCount == 1 && s[n].gridW == 2 && s[n].gridH == 2 && s[n].proxy && !pos[s[n].panelX][s[n].panelY];
+        pos[s[n].panelX][s[n].panelY] = true;
+        for (int i = 0; i < 3; i++)
+            if (s[0].peerNode[i] == n) ok = ok && s[0].peerX[i] == s[n].panelX && s[0].peerY[i] == s[n].panelY;
+    }
+    ok = ok && pos[1][0] && pos[0][1] && pos[1][1];
+    check(ok, "discovery: master with %d peers, slaves at (%d,%d) (%d,%d) (%d,%d) in a %dx%d grid", s[0].peerCount,
+          s[1].panelX, s[1].panelY, s[2].panelX, s[2].panelY, s[3].panelX, s[3].panelY, s[1].gridW, s[1].gridH);
+
+    // ===== Orologi =====
+    run(3000);
+    snapshots(s);
+    int64_t worstErr = 0;
+    ok = true;
+    for (int n = 1; n < NODES; n++) {
+        int64_t err = s[n].clockOffsetUs - (offsetUs[0] - offsetUs[n]);
+        worstErr = std::max(worstErr, err < 0 ? -err : err);
+        ok = ok && s[n].clockSamples >= DUAL_CLOCK_SYNC_SAMPLES;
+    }
+    check(ok && worstErr <= 1000, "clock: offset estimate within %ld us of the real offset (jitter %u us)",
+          (long)worstErr, chan.jitterUs);
+
+    // ===== Sync: ogni frame applicato uguale a quello inviato, impostazioni cambiate a meta' =====
+    resetMeasures();
+    verifyFrames = true;
+    run(10000);
+    script.brightnessDay = 120;
+    run(10000);
+    Skew k = skew();
+    check(mismatches == 0 && applied[1] > 590 && applied[1] == applied[2] && applied[2] == applied[3],
+          "sync: %u/%u/%u frames applied, %u different from the master state", applied[1], applied[2], applied[3],
+          mismatches);
+    check(k.frames > 590 && k.presentAvg <= 500 && k.late <= k.frames / 100 && k.presentAvg * 2 < k.arriveAvg,
+          "sync: skew between the 4 panels at presentUs avg %u us max %u us, %u/%u frames over %u us "
+          "(arrival avg %u us max %u us)", k.presentAvg, k.presentMax, k.late, k.frames, SKEW_LATE_US, k.arriveAvg,
+          k.arriveMax);
+    allEqual("sync");
+
+    // ===== Cambio modo =====
+    snapshots(s);
+    uint32_t cleanups[NODES];
+    for (int n = 1; n < NODES; n++) cleanups[n] = s[n].cleanups;
+    script.mode = MODE_BREAKOUT;
+    run(2000);
+    snapshots(s);
+    ok = mismatches == 0;
+    for (int n = 1; n < NODES; n++)
+        ok = ok && s[n].cleanups == cleanups[n] + 1 && s[n].cleanupMode == MODE_SNAKE && !s[n].breakoutInitialized;
+    check(ok, "mode change: each slave cleaned up the snake once, breakout restarted, %u different frames", mismatches);
+    allEqual("mode change");
+    verifyFrames = false;
+
+    // ===== Touch inoltrato =====
+    ok = true;
+    for (int n = 1; n < NODES; n++) {
+        node[n]->touch(100, 200);
+        run(20);
+        snapshots(s);
+        ok = ok && s[0].touches == n && s[0].touchX == 100 + s[n].panelX * DUAL_PANEL_SIZE &&
+             s[0].touchY == 200 + s[n].panelY * DUAL_PANEL_SIZE;
+    }
+    check(ok, "touch: (100,200) on each slave reached the master at its virtual position, last (%d,%d)",
+          s[0].touchX, s[0].touchY);
+
+    // ===== Perdite =====
+    chan.lossPct = 20;
+    run(10000);
+    chan.lossPct = 0;
+    run(2000);
+    snapshots(s);
+    uint32_t lost = 0, rec = 0;
+    for (int n = 1; n < NODES; n++) {
+        lost += s[n].rxLost;
+        rec += s[n].recoveries;
+    }
+    check(lost > 0 && rec > 0, "loss: %u frames lost at 20%% loss (%u unicast retries), %u recoveries by keyframe",
+          lost, chan.retries, rec);
+    allEqual("loss");
+
+    // ===== Riordino =====
+    uint32_t staleBefore = s[1].rxStale + s[2].rxStale + s[3].rxStale;
+    regressions = 0;
+    chan.reorderPct = 15;
+    run(10000);
+    chan.reorderPct = 0;
+    run(2000);
+    snapshots(s);
+    uint32_t stale = s[1].rxStale + s[2].rxStale + s[3].rxStale - staleBefore;
+    check(stale > 0 && regressions == 0, "reorder: %u late frames dropped as stale (%u delayed), %u frame counter regressions",
+          stale, chan.reordered, regressions);
+    allEqual("reorder");
+
+    // ===== Riavvio del master =====
+    snapshots(s);
+    uint32_t resyncs = s[1].rxResyncs;
+    int32_t first = rebootMaster(1000, false, 1000);
+    snapshots(s);
+    check(first == 0 && s[1].rxResyncs == resyncs + 1, "reboot: first frame applied by all slaves %d, %u resync(s)",
+          first, s[1].rxResyncs - resyncs);
+    allEqual("reboot");
+
+    first = rebootMaster(1000, true, 1000);
+    check(first == 1, "reboot, keyframe lost: first frame applied by all slaves %d", first);
+    allEqual("reboot, keyframe lost");
+
+    // Riavvio dopo 5 frame, keyframe perso: 1..4 stanno nella finestra di riordino (scartati), dal 5 si riparte
+    rebootMaster(1000, false, 5 * DUAL_SYNC_INTERVAL_MS - DUAL_SYNC_INTERVAL_MS / 2);
+    snapshots(s);
+    staleBefore = s[1].rxStale;
+    first = rebootMaster(0, true, 1000);
+    snapshots(s);
+    check(first == 5 && s[1].rxStale == staleBefore + 4, "short uptime, keyframe lost: frames 1-4 stale (%u), first applied %d",
+          s[1].rxStale - staleBefore, first);
+    allEqual("short uptime");
+
+    // Come sopra ma dopo 4 s di silenzio: oltre DUAL_RX_RESYNC_MS il primo frame fa da riferimento
+    rebootMaster(1000, false, 5 * DUAL_SYNC_INTERVAL_MS - DUAL_SYNC_INTERVAL_MS / 2);
+    snapshots(s);
+    staleBefore = s[1].rxStale;
+    resyncs = s[1].rxResyncs;
+    first = rebootMaster(4000, true, 1000);
+    snapshots(s);
+    check(first == 1 && s[1].rxStale == staleBefore && s[1].rxResyncs == resyncs + 1,
+          "silence, keyframe lost: first applied %d after %u resync(s), none stale", first, s[1].rxResyncs - resyncs);
+    allEqual("silence");
+
+    printf("%u packets, %u lost on the air\n", chan.sent, chan.dropped);
+    printf("%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,144 @@
+// Host build glue for 44_DUAL_DISPLAY.ino (dual_display.cpp): the ESP-IDF timer and critical section calls,
+// an Arduino_GFX base class for the DualGFX proxy and the types/constants of the main sketch the module
+// uses. What every panel has on its own (WiFi MAC, EEPROM, clock, the sketch globals) is in dual_node.h.
+// Included after sketch_host.h and web_host.h.
+
+#ifndef DUAL_HOST_H
+#define DUAL_HOST_H
+
+#include "esp_now.h"
+
+// ===== ESP-IDF =====
+// Timer one-shot della presentazione: il test chiama updateDualDisplay() ad ogni passo, il risveglio non serve
+typedef void (*esp_timer_cb_t)(void *arg);
+typedef struct {
+    esp_timer_cb_t callback;
+    void *arg;
+    const char *name;
+} esp_timer_create_args_t;
+struct esp_timer { bool active; };
+typedef esp_timer *esp_timer_handle_t;
+static inline esp_err_t esp_timer_create(const esp_timer_create_args_t *, esp_timer_handle_t *h) { *h = new esp_timer(); return ESP_OK; }
+static inline esp_err_t esp_timer_start_once(esp_timer_handle_t h, uint64_t) { h->active = true; return ESP_OK; }
+static inline esp_err_t esp_timer_stop(esp_timer_handle_t h) { h->active = false; return ESP_OK; }
+static inline bool esp_timer_is_active(esp_timer_handle_t h) { return h->active; }
+
+typedef int portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED 0
+#define portENTER_CRITICAL(m) (void)(m)
+#define portEXIT_CRITICAL(m) (void)(m)
+
+// ===== Arduino_GFX =====
+// Solo la parte che DualGFX ridefinisce: le primitive write* virtuali, fillScreen/fillRect passano da
+// writeFillRectPreclipped come nella libreria, le forme dei v*() non disegnano nulla
+#define GFX_NOT_DEFINED -1
+
+class Arduino_GFX {
+public:
+    Arduino_GFX(int16_t w, int16_t h) : _width(w), _height(h) {}
+    virtual ~Arduino_GFX() {}
+
+    virtual bool begin(int32_t speed = GFX_NOT_DEFINED) { return true; }
+    virtual void startWrite() {}
+    virtual void endWrite() {}
+    virtual void flush(bool force_flush = false) {}
+    virtual void writePixelPreclipped(int16_t x, int16_t y, uint16_t color) {}
+    virtual void writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        for (int16_t i = 0; i < h; i++) writeFastHLine(x, y + i, w, color);
+    }
+    virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+        for (int16_t i = 0; i < w; i++) writePixelPreclipped(x + i, y, color);
+    }
+    virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+        for (int16_t i = 0; i < h; i++) writePixelPreclipped(x, y + i, color);
+    }
+    virtual void writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+        int dx = abs(x1 - x0), dy = -abs(y1 - y0), sx = x0 < x1 ? 1 : -1, sy = y0 < y1 ? 1 : -1, err = dx + dy;
+        for (;;) {
+            writePixelPreclipped(x0, y0, color);
+            if (x0 == x1 && y0 == y1) break;
+            int e2 = 2 * err;
+            if (e2 >= dy) { err += dy; x0 += sx; }
+            if (e2 <= dx) { err += dx; y0 += sy; }
+        }
+    }
+    virtual void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) {}
+    virtual void draw16bitRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[], int16_t w, int16_t h) {}
+
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+        startWrite();
+        writeFillRectPreclipped(x, y, w, h, color);
+        endWrite();
+    }
+    void fillScreen(uint16_t color) { fillRect(0, 0, _width, _height, color); }
+    void drawPixel(int16_t, int16_t, uint16_t) {}
+    void drawFastHLine(int16_t, int16_t, int16_t, uint16_t) {}
+    void drawFastVLine(int16_t, int16_t, int16_t, uint16_t) {}
+    void drawLine(int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+    void drawRect(int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+    void drawRoundRect(int16_t, int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+    void fillRoundRect(int16_t, int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+    void drawCircle(int16_t, int16_t, int16_t, uint16_t) {}
+    void fillCircle(int16_t, int16_t, int16_t, uint16_t) {}
+    void drawTriangle(int16_t, int16_t, int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+    void fillTriangle(int16_t, int16_t, int16_t, int16_t, int16_t, int16_t, uint16_t) {}
+    void setCursor(int16_t, int16_t) {}
+    void setTextColor(uint16_t) {}
+    void print(const char *) {}
+
+protected:
+    int16_t _width, _height;
+};
+
+// Pannello fisico: conta i riempimenti a schermo intero (ridisegni forzati)
+class Arduino_RGB_Display : public Arduino_GFX {
+public:
+    Arduino_RGB_Display() : Arduino_GFX(480, 480) {}
+    uint32_t hostFullFills = 0;
+    void writeFillRectPreclipped(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t) override {
+        if (x == 0 && y == 0 && w >= 480 && h >= 480) hostFullFills++;
+    }
+};
+
+// ===== Sketch principale (oraQuadra_Nano_Ver_1.5.ino) =====
+#define EEPROM_DUAL_ENABLED          908
+#define EEPROM_DUAL_PANEL_X          909
+#define EEPROM_DUAL_PANEL_Y          910
+#define EEPROM_DUAL_GRID_W           911
+#define EEPROM_DUAL_GRID_H           912
+#define EEPROM_DUAL_ROLE             913
+#define EEPROM_DUAL_PEER1_MAC        914
+#define EEPROM_DUAL_PEER2_MAC        920
+#define EEPROM_DUAL_PEER3_MAC        926
+#define EEPROM_DUAL_MARKER           932
+#define EEPROM_DUAL_MARKER_VALUE     0xDD
+#define EEPROM_DUAL_MODES_MASK_ADDR  943
+#define EEPROM_DUAL_MODES_MARKER_ADDR 948
+#define EEPROM_DUAL_MODES_MARKER_VALUE 0xDE
+
+// I modi che il test usa (stessi valori dell'enum DisplayMode)
+enum DisplayMode {
+    MODE_FADE = 0,
+    MODE_SLOW = 1,
+    MODE_FAST = 2,
+    MODE_MATRIX = 3,
+    MODE_MATRIX2 = 4,
+    MODE_SNAKE = 5,
+    MODE_WATER = 6,
+    MODE_BREAKOUT = 30
+};
+
+struct Color {
+    uint8_t r, g, b;
+    Color() : r(255), g(255), b(255) {}
+    Color(uint8_t r_, uint8_t g_, uint8_t b_) : r(r_), g(g_), b(b_) {}
+};
+
+#define SNAKE_MAX_LENGTH 30
+struct SnakeSegment { uint16_t ledIndex; };
+struct Snake {
+    SnakeSegment segments[SNAKE_MAX_LENGTH];
+    uint8_t length;
+};
+
+#endif
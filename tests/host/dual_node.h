@@ -0,0 +1,225 @@
+// One panel of dual_display.cpp: included twice inside the panel's namespace, before 44_DUAL_DISPLAY.ino
+// (what the rest of the sketch gives the module: WiFi MAC, EEPROM, esp_timer clock, the sketch globals the
+// sync reads and writes) and after it with DUAL_NODE_API defined (the NodeApi the test drives the panel with).
+// No include guard on purpose. Needs hostNode, hostUs, netSend, NodeState, NodeApi and MasterScript.
+
+#ifndef DUAL_NODE_API
+
+// ===== Radio e memoria del pannello =====
+static const uint8_t hostMac[6] = { 0x02, 0x00, 0x00, 0x00, 0x00, hostNode };
+
+struct HostWiFi {
+    void macAddress(uint8_t *mac) { memcpy(mac, hostMac, 6); }
+};
+static HostWiFi WiFi;
+
+struct HostEEPROM {
+    uint8_t mem[1024];
+    uint8_t read(int addr) { return mem[addr]; }
+    void write(int addr, uint8_t v) { mem[addr] = v; }
+};
+static HostEEPROM EEPROM;
+
+static inline int32_t settingsLoad(uint16_t addr) { return EEPROM.read(addr); }
+static inline bool settingsCommit() { return true; }
+static inline bool settingsFlush() { return true; }
+
+// esp_timer conta dall'avvio del pannello: ogni pannello ha il suo scostamento dal tempo del test
+int64_t hostClockOffsetUs = 0;
+static inline int64_t esp_timer_get_time() { return (int64_t)hostUs + hostClockOffsetUs; }
+
+static esp_err_t hostSend(const uint8_t *mac, const uint8_t *data, size_t len) { return netSend(hostNode, mac, data, len); }
+
+// ===== Display =====
+static Arduino_RGB_Display hostPanel;
+Arduino_RGB_Display *realGfx = &hostPanel;
+Arduino_GFX *gfx = realGfx;
+
+// ===== Globali dello sketch =====
+DisplayMode currentMode = MODE_FAST;
+uint8_t currentHour = 0, currentMinute = 0, currentSecond = 0;
+Color currentColor = Color(255, 255, 255);
+uint8_t lastAppliedBrightness = 255;
+uint8_t currentPreset = 0;
+bool rainbowModeEnabled = false;
+uint8_t brightnessDay = 250, brightnessNight = 30;
+uint8_t volumeDay = 80, volumeNight = 30;
+uint64_t enabledModesMask = 0xFFFFFFFFFFULL;
+bool    ledRgbEnabled = true;
+uint8_t ledRgbBrightness = 80;
+bool    ledRgbOverride = false;
+uint8_t ledRgbOverrideR = 255, ledRgbOverrideG = 255, ledRgbOverrideB = 255;
+uint8_t ledAudioReactive = 1;
+uint8_t lastHour = 255, lastMinute = 255;
+bool radarServerEnabled = false;
+bool radarRemotePresence = true;
+
+uint8_t snakePathChoice = 0;
+uint16_t snakePathIndex = 0;
+bool snakeIsCompleted = false;
+Snake snake;
+bool snakeInitNeeded = true, waterDropInitNeeded = true, marioInitNeeded = true;
+bool matrixInitialized = false, tronInitialized = false, fadeInitialized = false, slowInitialized = false;
+
+int16_t brkBallX, brkBallY, brkBallVX, brkBallVY, brkPaddleX;
+uint16_t brkScore;
+uint8_t brkLives, brkSpeedLevel;
+bool brkGameOver, brkWin, brkHudDrawn;
+uint8_t brkBricks[10];
+bool breakoutInitialized = true;           // come se il modo fosse gia' stato disegnato
+
+// Chiamate verso il resto dello sketch: registrate per i controlli
+uint32_t hostCleanups = 0;
+DisplayMode hostCleanupMode = MODE_FAST;
+void cleanupPreviousMode(DisplayMode previousMode) { hostCleanups++; hostCleanupMode = previousMode; }
+void frameGovKick() {}
+
+int hostTouches = 0, hostTouchX = -1, hostTouchY = -1;
+void handleBreakoutRemoteTouch(int vx, int vy) { hostTouches++; hostTouchX = vx; hostTouchY = vy; }
+
+#else
+
+DualTransport hostTransport = { "host", hostSend };
+static int32_t hostPendingFrame = -1;     // Master: frame inviato, in attesa di presentUs
+
+static void hostBegin(bool master)
+{
+    dualTransport = &hostTransport;
+    if (master) setupAsMaster(2, 2);
+    else setupAsSlave();
+}
+
+static void hostRecv(const uint8_t *mac, const uint8_t *data, int len) { onDualDataRecv(mac, data, len); }
+
+// Un giro del loop principale. Ritorna il frame presentato in questo giro, -1 se nessuno:
+// il master lo disegna quando dualPresentHold() smette di trattenerlo, lo slave quando
+// updateDualDisplay() applica il sync in attesa
+static int32_t hostLoop()
+{
+    if (panelRole == 1) {
+        uint16_t seq = dualTx.seq;
+        updateDualDisplay();
+        if (dualTx.seq != seq) hostPendingFrame = (uint16_t)(dualFrameCounter - 1);
+        if (hostPendingFrame >= 0 && !dualPresentHold()) {
+            int32_t f = hostPendingFrame;
+            hostPendingFrame = -1;
+            return f;
+        }
+        return -1;
+    }
+    bool pending = newSyncAvailable;
+    updateDualDisplay();
+    return pending && !newSyncAvailable ? lastReceivedSync.frameCounter : -1;
+}
+
+// Master: lo stato che i modi aggiornerebbero, in funzione del tempo
+static void hostAnimate(const MasterScript &s)
+{
+    uint32_t t = millis();
+    currentMode = s.mode;
+    brightnessDay = s.brightnessDay;
+    currentHour = 10;
+    currentMinute = 20 + (t / 60000) % 40;
+    currentSecond = (t / 1000) % 60;
+    currentColor = Color(255, 128, 0);
+    lastAppliedBrightness = 200;
+    currentPreset = 3;
+    snakePathChoice = (t / 20000) % 4;
+    snakePathIndex = (t / 100) % 257;
+    snakeIsCompleted = snakePathIndex == 256;
+    for (int i = 0; i < 8; i++) snake.segments[i].ledIndex = (snakePathIndex + 256 - i * 3) % 256;
+    brkBallX = (t / 7) % 960;
+    brkBallY = (t / 11) % 960;
+    brkBallVX = 3;
+    brkBallVY = -4;
+    brkPaddleX = (t / 13) % 960;
+    brkScore = t / 2000;
+    brkLives = 3;
+    brkSpeedLevel = 1 + (t / 10000) % 3;
+    brkGameOver = brkWin = false;
+    for (int i = 0; i < 10; i++) brkBricks[i] = (uint8_t)(0xFF >> ((t / 2000 + i) % 8));
+}
+
+// Riavvio del master: sequenza, frame counter e esp_timer ripartono da zero
+static void hostReboot()
+{
+    dualTx = { 0, 0, {}, {}, 0, true };
+    dualFrameCounter = 0;
+    dualPresentPending = false;
+    hostPendingFrame = -1;
+    hostClockOffsetUs = -(int64_t)hostUs;
+}
+
+static void hostSnapshot(NodeState &s)
+{
+    s.mode = currentMode;
+    s.hour = currentHour;
+    s.minute = currentMinute;
+    s.second = currentSecond;
+    s.r = currentColor.r;
+    s.g = currentColor.g;
+    s.b = currentColor.b;
+    s.brightness = lastAppliedBrightness;
+    s.preset = currentPreset;
+    s.rainbow = rainbowModeEnabled;
+    s.brightnessDay = brightnessDay;
+    s.brightnessNight = brightnessNight;
+    s.volumeDay = volumeDay;
+    s.volumeNight = volumeNight;
+    s.enabledModes = enabledModesMask;
+    s.ledEnabled = ledRgbEnabled;
+    s.ledBrightness = ledRgbBrightness;
+    s.ledOverride = ledRgbOverride;
+    s.ledR = ledRgbOverrideR;
+    s.ledG = ledRgbOverrideG;
+    s.ledB = ledRgbOverrideB;
+    s.ledAudio = ledAudioReactive;
+    s.snakePath = snakePathChoice;
+    s.snakeIndex = snakePathIndex;
+    s.snakeDone = snakeIsCompleted;
+    for (int i = 0; i < 8; i++) s.snakeSeg[i] = snake.segments[i].ledIndex;
+    s.ball[0] = brkBallX;
+    s.ball[1] = brkBallY;
+    s.ball[2] = brkBallVX;
+    s.ball[3] = brkBallVY;
+    s.paddle = brkPaddleX;
+    s.score = brkScore;
+    s.lives = brkLives;
+    s.speed = brkSpeedLevel;
+    s.over = brkGameOver;
+    s.win = brkWin;
+    memcpy(s.bricks, brkBricks, 10);
+    s.frameCounter = dualFrameCounter;
+
+    s.role = panelRole;
+    s.panelX = panelX;
+    s.panelY = panelY;
+    s.gridW = gridW;
+    s.gridH = gridH;
+    s.peerCount = peerCount;
+    s.proxy = gfx != realGfx;
+    for (int i = 0; i < 3; i++) {
+        s.peerNode[i] = i < peerCount ? peerMACs[i][5] : 0xFF;
+        s.peerX[i] = peerStates[i].peerPanelX;
+        s.peerY[i] = peerStates[i].peerPanelY;
+    }
+    s.rxLost = dualSyncStats.rxLost;
+    s.rxStale = dualSyncStats.rxStale;
+    s.rxResyncs = dualSyncStats.rxResyncs;
+    s.recoveries = dualSyncStats.recoveries;
+    s.clockSamples = dualClock.samples;
+    s.clockOffsetUs = dualClock.offsetUs;
+    s.cleanups = hostCleanups;
+    s.cleanupMode = hostCleanupMode;
+    s.breakoutInitialized = breakoutInitialized;
+    s.touches = hostTouches;
+    s.touchX = hostTouchX;
+    s.touchY = hostTouchY;
+}
+
+static void hostTouch(int x, int y) { forwardTouchToMaster(x, y, 0); }
+
+const NodeApi hostApi = { hostBegin, hostRecv, hostLoop, hostAnimate, hostReboot, hostSnapshot, hostTouch,
+                          &hostClockOffsetUs };
+
+#endif
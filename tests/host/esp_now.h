@@ -0,0 +1,33 @@
+// Host build: <esp_now.h> of 44_DUAL_DISPLAY.ino. Types and calls of the ESP-NOW API; the packets go
+// through the DualTransport the test installs, so the peer table is not modelled (dual_host.h).
+
+#ifndef ESP_NOW_HOST_H
+#define ESP_NOW_HOST_H
+
+typedef int esp_err_t;
+#define ESP_OK                0
+#define ESP_FAIL              -1
+#define ESP_ERR_INVALID_ARG   0x102
+#define ESP_ERR_ESPNOW_EXIST  0x3069
+
+typedef enum { ESP_NOW_SEND_SUCCESS = 0, ESP_NOW_SEND_FAIL } esp_now_send_status_t;
+
+typedef struct {
+    uint8_t peer_addr[6];
+    uint8_t channel;
+    bool encrypt;
+} esp_now_peer_info_t;
+
+typedef void (*esp_now_send_cb_t)(const uint8_t *mac, esp_now_send_status_t status);
+typedef void (*esp_now_recv_cb_t)(const uint8_t *mac, const uint8_t *data, int len);
+
+static inline esp_err_t esp_now_init() { return ESP_OK; }
+static inline esp_err_t esp_now_deinit() { return ESP_OK; }
+static inline esp_err_t esp_now_register_send_cb(esp_now_send_cb_t) { return ESP_OK; }
+static inline esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t) { return ESP_OK; }
+static inline esp_err_t esp_now_add_peer(const esp_now_peer_info_t *) { return ESP_OK; }
+static inline esp_err_t esp_now_del_peer(const uint8_t *) { return ESP_OK; }
+static inline bool esp_now_is_peer_exist(const uint8_t *) { return true; }
+static inline esp_err_t esp_now_send(const uint8_t *, const uint8_t *, size_t) { return ESP_OK; }
+
+#endif
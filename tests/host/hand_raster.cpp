@@ -0,0 +1,247 @@
+// Host check of the antialiased clock hands (0_HAND_RASTER.ino)
+//
+//  - golden image: six 128x128 tiles (round/square/butt ends, thin and thick hands, the three
+//    hands of a clock, a clipped redraw) on a gradient background, drawn into a StubGFX frame
+//    buffer as 3_EFFETTI.ino does, against golden/hands.ppm
+//  - every pixel the raster touches lies inside clockHandBounds() (partial redraw of the analog clock)
+//  - with handRasterSetClip() nothing outside the clip rectangle changes
+//  - a hand at a and at 360 - a are mirror images (sin/cos table symmetry)
+//
+//   make hand_raster && ./hand_raster            exit code 1 if a check fails
+//   ./hand_raster --update                       rewrite the golden image after an intended change
+
+#include <stdarg.h>
+#include <vector>
+#include "../../0_HAND_RASTER.ino"
+
+#define TILE      128
+#define COLS      3
+#define ROWS      2
+#define GOLDEN    "golden/hands.ppm"
+
+static int failures = 0;
+
+static void check(bool ok, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%s ", ok ? "  ok  " : "FAILED");
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+    if (!ok) failures++;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct Hand {
+    float angle;
+    int length, thickness;
+    uint16_t color;
+    uint8_t style;
+};
+
+static uint16_t rgb565(int r, int g, int b)
+{
+    return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3);
+}
+
+// Sfondo a gradiente: la miscelazione dei bordi deve dipendere dal pixel sotto
+static void background(StubGFX &gfx)
+{
+    for (int y = 0; y < gfx.height(); y++)
+        for (int x = 0; x < gfx.width(); x++) gfx.writePixel(x, y, rgb565(x * 2, y * 2, 96));
+}
+
+static void drawHand(StubGFX &gfx, int cx, int cy, const Hand &h)
+{
+    drawClockHandAA(gfx.getBuffer(), gfx.width(), gfx.height(), cx, cy, h.angle, h.length, h.color, h.thickness, h.style);
+}
+
+static void renderTile(StubGFX &gfx, int tile)
+{
+    static const Hand single[] = {
+        {   0.0f, 50, 6, 0xF800, 0 },          // round, ore 12, contorno bianco
+        {  37.5f, 55, 4, 0x001F, 1 },          // square, angolo non multiplo del passo tabella
+        { 123.0f, 45, 8, 0xFFE0, 2 },          // butt, lancetta chiara con contorno nero
+    };
+    static const Hand clock[] = {
+        { 300.0f, 34, 7, 0x0000, 0 },
+        {  72.0f, 52, 4, 0x0000, 0 },
+        { 180.0f, 58, 1, 0xF800, 2 },
+    };
+    background(gfx);
+    handRasterClearClip();
+    switch (tile) {
+        case 0: case 1: case 2:
+            drawHand(gfx, TILE / 2, TILE / 2, single[tile]);
+            break;
+        case 3:                                 // sottile, quasi orizzontale
+            drawHand(gfx, TILE / 2, TILE / 2, { 270.25f, 60, 2, 0x07E0, 0 });
+            break;
+        case 4:
+            for (const Hand &h : clock) drawHand(gfx, TILE / 2, TILE / 2, h);
+            break;
+        case 5:                                 // ridisegno parziale: solo il rettangolo sporco
+            handRasterSetClip(40, 20, 90, 70);
+            drawHand(gfx, TILE / 2, TILE / 2, { 45.0f, 56, 6, 0xF81F, 1 });
+            handRasterClearClip();
+            break;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+static void sheet(std::vector<uint8_t> &rgb)
+{
+    rgb.assign(COLS * TILE * ROWS * TILE * 3, 0);
+    StubGFX gfx(TILE, TILE);
+    for (int t = 0; t < COLS * ROWS; t++) {
+        renderTile(gfx, t);
+        int ox = (t % COLS) * TILE, oy = (t / COLS) * TILE;
+        for (int y = 0; y < TILE; y++) {
+            for (int x = 0; x < TILE; x++) {
+                uint16_t c = gfx.getBuffer()[y * TILE + x];
+                uint8_t *p = &rgb[((oy + y) * COLS * TILE + ox + x) * 3];
+                uint8_t r = (c >> 11) & 0x1F, g = (c >> 5) & 0x3F, b = c & 0x1F;
+                p[0] = (r << 3) | (r >> 2);
+                p[1] = (g << 2) | (g >> 4);
+                p[2] = (b << 3) | (b >> 2);
+            }
+        }
+    }
+}
+
+static bool readPpm(const char *path, std::vector<uint8_t> &rgb, int *w, int *h)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) return false;
+    int maxv = 0;
+    bool ok = fscanf(f, "P6 %d %d %d", w, h, &maxv) == 3 && maxv == 255 && fgetc(f) != EOF;
+    if (ok) {
+        rgb.resize((size_t)*w * *h * 3);
+        ok = fread(rgb.data(), 1, rgb.size(), f) == rgb.size();
+    }
+    fclose(f);
+    return ok;
+}
+
+static bool writePpm(const char *path, const std::vector<uint8_t> &rgb, int w, int h)
+{
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", w, h);
+    bool ok = fwrite(rgb.data(), 1, rgb.size(), f) == rgb.size();
+    fclose(f);
+    return ok;
+}
+
+// Confronto esatto atteso; tollerato 1 LSB a 5/6 bit su pochi pixel: l'angolo passa da float
+// a fase intera (handSinQ15) e x87 a 32 bit puo' arrotondare diversamente da SSE
+static void goldenTest(bool update)
+{
+    std::vector<uint8_t> img, ref;
+    int w = COLS * TILE, h = ROWS * TILE, rw = 0, rh = 0;
+    sheet(img);
+    if (update) {
+        check(writePpm(GOLDEN, img, w, h), "golden image rewritten: %s", GOLDEN);
+        return;
+    }
+    if (!readPpm(GOLDEN, ref, &rw, &rh) || rw != w || rh != h) {
+        check(false, "golden image %s missing or not %dx%d", GOLDEN, w, h);
+        return;
+    }
+    int exact = 0, near = 0, far = 0;
+    for (size_t i = 0; i < img.size(); i += 3) {
+        int d = 0;
+        for (int c = 0; c < 3; c++) d = std::max(d, abs((int)img[i + c] - (int)ref[i + c]));
+        if (d == 0) exact++;
+        else if (d <= 8) near++;
+        else far++;
+    }
+    check(far == 0 && near <= w * h / 1000, "golden %s: %d pixels equal, %d within 1 LSB, %d different", GOLDEN, exact, near, far);
+    if (far || near > w * h / 1000) writePpm("hands_actual.ppm", img, w, h);
+}
+
+// Ogni pixel modificato sta nel rettangolo di clockHandBounds()
+static void boundsTest()
+{
+    StubGFX a(TILE, TILE), b(TILE, TILE);
+    int outside = 0, hands = 0;
+    for (int style = 0; style < 3; style++) {
+        for (float ang = 0; ang < 360; ang += 7.3f) {
+            for (int thick = 1; thick <= 9; thick += 4) {
+                background(a);
+                background(b);
+                Hand h = { ang, 48, thick, 0x7BEF, (uint8_t)style };
+                drawHand(b, TILE / 2, TILE / 2, h);
+                int16_t x0, y0, x1, y1;
+                clockHandBounds(TILE / 2, TILE / 2, ang, h.length, thick, style, &x0, &y0, &x1, &y1);
+                for (int y = 0; y < TILE; y++)
+                    for (int x = 0; x < TILE; x++)
+                        if (a.getBuffer()[y * TILE + x] != b.getBuffer()[y * TILE + x] && (x < x0 || x > x1 || y < y0 || y > y1)) outside++;
+                hands++;
+            }
+        }
+    }
+    check(outside == 0, "%d hands: %d changed pixels outside clockHandBounds()", hands, outside);
+}
+
+// Con il clip attivo i pixel fuori dal rettangolo restano quelli di prima
+static void clipTest()
+{
+    StubGFX a(TILE, TILE), b(TILE, TILE);
+    int outside = 0, inside = 0;
+    const int16_t cx0 = 30, cy0 = 50, cx1 = 80, cy1 = 100;
+    for (float ang = 0; ang < 360; ang += 11.0f) {
+        background(a);
+        background(b);
+        handRasterSetClip(cx0, cy0, cx1, cy1);
+        drawHand(b, TILE / 2, TILE / 2, { ang, 58, 6, 0x07FF, 0 });
+        handRasterClearClip();
+        for (int y = 0; y < TILE; y++) {
+            for (int x = 0; x < TILE; x++) {
+                if (a.getBuffer()[y * TILE + x] == b.getBuffer()[y * TILE + x]) continue;
+                if (x < cx0 || x > cx1 || y < cy0 || y > cy1) outside++;
+                else inside++;
+            }
+        }
+    }
+    check(outside == 0 && inside > 0, "clip: %d pixels drawn inside, %d outside the clip rectangle", inside, outside);
+}
+
+// Lancetta ad a e a 360-a: specchiate rispetto alla verticale per il centro
+static void mirrorTest()
+{
+    StubGFX a(TILE + 1, TILE + 1), b(TILE + 1, TILE + 1);
+    int worst = 0, diff = 0;
+    const int c = TILE / 2;
+    for (float ang = 5; ang < 180; ang += 12.5f) {
+        a.fillScreen(0);
+        b.fillScreen(0);
+        drawHand(a, c, c, { ang, 55, 5, 0xFFFF, 0 });
+        drawHand(b, c, c, { 360.0f - ang, 55, 5, 0xFFFF, 0 });
+        for (int y = 0; y <= TILE; y++) {
+            for (int x = 0; x <= TILE; x++) {
+                int mx = 2 * c - x;
+                if (mx < 0 || mx > TILE) continue;
+                int pa = a.getBuffer()[y * (TILE + 1) + x] & 0x1F, pb = b.getBuffer()[y * (TILE + 1) + mx] & 0x1F;
+                int d = abs(pa - pb);
+                if (d > worst) worst = d;
+                if (d > 1) diff++;
+            }
+        }
+    }
+    check(worst <= 2 && diff < 20, "mirror a / 360-a: worst %d of 31 (blue channel), %d pixels off by more than 1", worst, diff);
+}
+
+int main(int argc, char **argv)
+{
+    bool update = argc > 1 && strcmp(argv[1], "--update") == 0;
+    goldenTest(update);
+    boundsTest();
+    clipTest();
+    mirrorTest();
+    printf("%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
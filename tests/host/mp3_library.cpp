@@ -0,0 +1,463 @@
+// Host checks of the MP3 library parser (31_MP3_LIBRARY.ino) on files built byte by byte in memory
+//
+//  - ID3v2.3 title/artist (ISO-8859-1, UTF-16 with BOM), Xing + LAME: exact sample count and duration,
+//    the info frame is not audio, ID3v1 trimmed from the end
+//  - unsynchronised tags: v2.3 whole tag (frame sizes after resync), v2.4 per frame (flag 0x02, with a
+//    data length indicator) and v2.4 whole tag (flag 0x80 in the header)
+//  - VBRI, ID3v2.2, MPEG2 layer III CBR (576 samples per frame), APE footer, a false sync before the
+//    first frame, a file with no audio
+//  - WAV: fmt, LIST INFO (UTF-8 and ISO-8859-1), data chunk of an interrupted recording (size 0)
+//  - mp3LibraryRebuild() over the same files: sorted index on the SD, second scan reuses every record
+//  - a library of 2,000 files: cold scan (no index), warm load at boot, incremental scan with nothing
+//    changed and with files touched/added/removed. Host CPU time and SD traffic of each: the SD is in
+//    memory, so on the device the reads and bytes are what the times scale with
+//
+//   make mp3_library && ./mp3_library          exit code 1 if a check fails
+
+#include <stdarg.h>
+#include <time.h>
+#include <vector>
+#include "web_host.h"
+#include "sd_host.h"
+#include "../../mp3_library_types.h"
+
+#define EFFECT_MP3_PLAYER
+static void frameGovKick() {}
+String extractTitle(const char *filename) { return String(filename); }
+void mp3LibraryRequestScan();
+#include "../../31_MP3_LIBRARY.ino"
+
+typedef std::vector<uint8_t> Bytes;
+
+static int failures = 0;
+
+static void check(bool ok, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%s ", ok ? "  ok  " : "FAILED");
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+    if (!ok) failures++;
+}
+
+// ===== Costruzione dei file =====
+static void put(Bytes &b, const void *p, size_t n) { b.insert(b.end(), (const uint8_t *)p, (const uint8_t *)p + n); }
+static void put(Bytes &b, const char *s) { put(b, s, strlen(s)); }
+static void put(Bytes &b, const Bytes &o) { b.insert(b.end(), o.begin(), o.end()); }
+static void be32(Bytes &b, uint32_t v) { uint8_t t[4] = { (uint8_t)(v >> 24), (uint8_t)(v >> 16), (uint8_t)(v >> 8), (uint8_t)v }; put(b, t, 4); }
+static void le32(Bytes &b, uint32_t v) { uint8_t t[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) }; put(b, t, 4); }
+static void le16(Bytes &b, uint16_t v) { uint8_t t[2] = { (uint8_t)v, (uint8_t)(v >> 8) }; put(b, t, 2); }
+static void syncsafe(Bytes &b, uint32_t v) { uint8_t t[4] = { (uint8_t)((v >> 21) & 0x7F), (uint8_t)((v >> 14) & 0x7F), (uint8_t)((v >> 7) & 0x7F), (uint8_t)(v & 0x7F) }; put(b, t, 4); }
+
+// Schema di unsincronizzazione: 0x00 dopo ogni 0xFF (superinsieme valido di quello minimo)
+static Bytes unsync(const Bytes &in)
+{
+    Bytes out;
+    for (uint8_t c : in) {
+        out.push_back(c);
+        if (c == 0xFF) out.push_back(0x00);
+    }
+    return out;
+}
+
+// Testo ID3: codifica + byte; UTF-16 con BOM little-endian da una stringa Latin-1
+static Bytes text(uint8_t enc, const char *s)
+{
+    Bytes b(1, enc);
+    if (enc == 1) {
+        b.push_back(0xFF); b.push_back(0xFE);
+        for (const char *p = s; *p; p++) { b.push_back((uint8_t)*p); b.push_back(0); }
+    } else {
+        put(b, s);
+    }
+    return b;
+}
+
+static Bytes frame(uint8_t ver, const char *id, const Bytes &payload, uint8_t fmtFlags = 0, uint32_t rawSize = 0)
+{
+    Bytes b;
+    uint32_t sz = rawSize ? rawSize : payload.size();
+    if (ver == 2) {
+        put(b, id, 3);
+        uint8_t t[3] = { (uint8_t)(sz >> 16), (uint8_t)(sz >> 8), (uint8_t)sz };
+        put(b, t, 3);
+    } else {
+        put(b, id, 4);
+        if (ver == 3) be32(b, sz); else syncsafe(b, sz);
+        b.push_back(0);
+        b.push_back(fmtFlags);
+    }
+    put(b, payload);
+    return b;
+}
+
+static Bytes tag(uint8_t ver, uint8_t flags, const Bytes &body, size_t padding = 64)
+{
+    Bytes b;
+    put(b, "ID3");
+    b.push_back(ver); b.push_back(0); b.push_back(flags);
+    syncsafe(b, body.size() + padding);
+    put(b, body);
+    b.resize(b.size() + padding, 0);
+    return b;
+}
+
+// Frame MPEG audio: intestazione e silenzio (nessun 0xFF dentro: nessun falso sync)
+static Bytes mpegFrame(const uint8_t h[4], size_t len)
+{
+    Bytes b(h, h + 4);
+    b.resize(len, 0);
+    return b;
+}
+
+static const uint8_t MPEG1_128K_STEREO[4] = { 0xFF, 0xFB, 0x90, 0x00 };   // 417 byte, 1152 campioni
+static const uint8_t MPEG2_64K_MONO[4] = { 0xFF, 0xF3, 0x80, 0xC0 };      // 22050 Hz, 208 byte, 576 campioni
+#define MPEG1_LEN 417
+#define MPEG2_LEN 208
+
+static Bytes xingFrame(const char *magic, uint32_t frames, uint16_t delay, uint16_t padding)
+{
+    Bytes b = mpegFrame(MPEG1_128K_STEREO, 36);
+    put(b, magic);
+    be32(b, 0x0F);                      // Frame, byte, TOC, qualita'
+    be32(b, frames);
+    be32(b, frames * MPEG1_LEN);
+    b.resize(b.size() + 100, 0);
+    be32(b, 78);
+    Bytes lame;
+    put(lame, "LAME3.100");
+    lame.resize(21, 0);
+    lame.push_back(delay >> 4);
+    lame.push_back(((delay & 0x0F) << 4) | (padding >> 8));
+    lame.push_back(padding & 0xFF);
+    put(b, lame);
+    b.resize(MPEG1_LEN, 0);
+    return b;
+}
+
+static Bytes vbriFrame(uint32_t frames)
+{
+    Bytes b = mpegFrame(MPEG1_128K_STEREO, 36);
+    put(b, "VBRI");
+    b.resize(36 + 14, 0);
+    be32(b, frames);
+    b.resize(MPEG1_LEN, 0);
+    return b;
+}
+
+static Bytes id3v1(const char *title, const char *artist)
+{
+    Bytes b;
+    put(b, "TAG");
+    Bytes f(30, ' ');
+    memcpy(f.data(), title, strlen(title));
+    put(b, f);
+    memset(f.data(), ' ', 30);
+    memcpy(f.data(), artist, strlen(artist));
+    put(b, f);
+    b.resize(128, 0);
+    return b;
+}
+
+// ===== Analisi =====
+static MP3IndexEntry parse(const char *name, const Bytes &data, uint8_t type = AUDIO_TYPE_MP3)
+{
+    std::string path = std::string(MP3_FOLDER "/") + name;
+    hostFiles[path].data = data;
+    File f = SD.open(path.c_str());
+    MP3IndexEntry e;
+    memset(&e, 0, sizeof(e));
+    strcpy(e.name, name);
+    e.size = data.size();
+    e.type = type;
+    mp3LibParseFile(f, e);
+    return e;
+}
+
+static void xingLameTest()
+{
+    Bytes body;
+    put(body, frame(3, "TIT2", text(0, "Titolo")));
+    put(body, frame(3, "TPE1", text(1, "Artista \xE8")));
+    Bytes file = tag(3, 0, body);
+    uint32_t tagLen = file.size();
+    put(file, xingFrame("Xing", 100, 576, 1000));
+    for (int i = 0; i < 100; i++) put(file, mpegFrame(MPEG1_128K_STEREO, MPEG1_LEN));
+    put(file, id3v1("Altro titolo", "Altro artista"));
+
+    MP3IndexEntry e = parse("xing.mp3", file);
+    uint8_t want = MP3_IDX_ID3V2 | MP3_IDX_ID3V1 | MP3_IDX_XING | MP3_IDX_VBR | MP3_IDX_LAME;
+    check(e.flags == want, "xing: flags 0x%02x (expected 0x%02x)", e.flags, want);
+    check(strcmp(e.title, "Titolo") == 0 && strcmp(e.artist, "Artista \xC3\xA8") == 0,
+          "xing: ID3v2.3 title '%s', UTF-16 artist '%s' win over ID3v1", e.title, e.artist);
+    check(e.audioStart == tagLen + MPEG1_LEN && e.audioEnd == file.size() - 128,
+          "xing: audio %u..%u skips the tag, the info frame and ID3v1", e.audioStart, e.audioEnd);
+    check(e.encDelay == 576 && e.encPadding == 1000 && e.samples == 100 * 1152 - 1576,
+          "xing: LAME delay %u padding %u, %u samples", e.encDelay, e.encPadding, e.samples);
+    check(e.sampleRate == 44100 && e.channels == 2 && e.durationMs == (100 * 1152 - 1576) * 1000 / 44100,
+          "xing: %u Hz, %u ch, %u ms", e.sampleRate, e.channels, e.durationMs);
+}
+
+static void unsyncTest()
+{
+    // v2.3, tutto il tag: dimensioni dei frame dopo la risincronizzazione
+    Bytes body;
+    put(body, frame(3, "TIT2", text(0, "Caf\xFF")));
+    put(body, frame(3, "TPE1", text(1, "B\xE9")));
+    Bytes file = tag(3, 0x80, unsync(body));
+    uint32_t tagLen = file.size();
+    for (int i = 0; i < 20; i++) put(file, mpegFrame(MPEG1_128K_STEREO, MPEG1_LEN));
+    MP3IndexEntry e = parse("unsync23.mp3", file);
+    check(strcmp(e.title, "Caf\xC3\xBF") == 0 && strcmp(e.artist, "B\xC3\xA9") == 0,
+          "unsync v2.3: title '%s', artist '%s'", e.title, e.artist);
+    check(e.audioStart == tagLen && e.durationMs == 20 * MPEG1_LEN * 8 / 128,
+          "unsync v2.3: CBR audio from %u, %u ms", e.audioStart, e.durationMs);
+
+    // v2.4 per frame (0x02) con indicatore di lunghezza (0x01): dimensione come su file
+    Bytes title = unsync(text(1, "\xDCn\xEF"));
+    Bytes payload;
+    syncsafe(payload, text(1, "\xDCn\xEF").size());
+    put(payload, title);
+    body.clear();
+    put(body, frame(4, "TIT2", payload, 0x03));
+    put(body, frame(4, "TPE1", text(0, "Gruppo")));
+    file = tag(4, 0, body);
+    put(file, vbriFrame(50));
+    for (int i = 0; i < 50; i++) put(file, mpegFrame(MPEG1_128K_STEREO, MPEG1_LEN));
+    e = parse("unsync24.mp3", file);
+    check(strcmp(e.title, "\xC3\x9Cn\xC3\xAF") == 0 && strcmp(e.artist, "Gruppo") == 0,
+          "unsync v2.4 frame: title '%s', artist '%s'", e.title, e.artist);
+
+    // v2.4, flag del tag: tutti i frame unsincronizzati
+    body.clear();
+    put(body, frame(4, "TPE1", unsync(text(1, "\xC5sa"))));
+    put(body, frame(4, "TIT2", unsync(text(1, "Fj\xE4ll"))));
+    file = tag(4, 0x80, body);
+    for (int i = 0; i < 5; i++) put(file, mpegFrame(MPEG1_128K_STEREO, MPEG1_LEN));
+    e = parse("unsync24all.mp3", file);
+    check(strcmp(e.title, "Fj\xC3\xA4ll") == 0 && strcmp(e.artist, "\xC3\x85sa") == 0,
+          "unsync v2.4 tag: title '%s', artist '%s'", e.title, e.artist);
+}
+
+static void vbriTest()
+{
+    Bytes file = vbriFrame(50);
+    for (int i = 0; i < 50; i++) put(file, mpegFrame(MPEG1_128K_STEREO, MPEG1_LEN));
+    MP3IndexEntry e = parse("vbri.mp3", file);
+    check(e.flags == (MP3_IDX_VBRI | MP3_IDX_VBR) && e.samples == 50 * 1152 && e.durationMs == 50 * 1152 * 1000 / 44100,
+          "vbri: flags 0x%02x, %u samples, %u ms", e.flags, e.samples, e.durationMs);
+    check(e.audioStart == MPEG1_LEN, "vbri: audio from %u (info frame skipped)", e.audioStart);
+}
+
+static void mpeg2ApeTest()
+{
+    Bytes body;
+    put(body, frame(2, "TT2", text(0, "Vecchio")));
+    put(body, frame(2, "TP1", text(0, "Tag 2.2")));
+    Bytes file = tag(2, 0, body);
+    uint32_t tagLen = file.size();
+    // Falso sync: intestazione valida non seguita da un frame dello stesso flusso
+    file.push_back(0xFF); file.push_back(0xFB); file.push_back(0x90); file.push_back(0x00);
+    file.resize(file.size() + 40, 0x11);
+    uint32_t first = file.size();
+    for (int i = 0; i < 30; i++) put(file, mpegFrame(MPEG2_64K_MONO, MPEG2_LEN));
+    uint32_t end = file.size();
+    Bytes ape;
+    put(ape, "APETAGEX");
+    le32(ape, 2000);
+    le32(ape, 32);                      // Dimensione: solo il footer, nessun elemento
+    le32(ape, 0);
+    le32(ape, 0);
+    ape.resize(32, 0);
+    put(file, ape);
+
+    MP3IndexEntry e = parse("mpeg2.mp3", file);
+    check(strcmp(e.title, "Vecchio") == 0 && strcmp(e.artist, "Tag 2.2") == 0, "v2.2: title '%s', artist '%s'", e.title, e.artist);
+    check(e.audioStart == first && e.audioEnd == end && tagLen < first,
+          "mpeg2: false sync skipped, audio %u..%u (expected %u..%u, APE trimmed)", e.audioStart, e.audioEnd, first, end);
+    check(e.sampleRate == 22050 && e.channels == 1 && e.bitrateKbps == 64 && e.durationMs == (end - first) * 8 / 64,
+          "mpeg2: %u Hz, %u ch, %u kbps, %u ms", e.sampleRate, e.channels, e.bitrateKbps, e.durationMs);
+}
+
+static void badTest()
+{
+    MP3IndexEntry e = parse("rumore.mp3", Bytes(4096, 0));
+    check((e.flags & MP3_IDX_BAD) && strcmp(e.title, "rumore.mp3") == 0,
+          "bad: no frame, flags 0x%02x, title from the file name '%s'", e.flags, e.title);
+}
+
+static void wavTest()
+{
+    Bytes info;
+    put(info, "INFO");
+    put(info, "INAM"); le32(info, 9); put(info, "Canzon\xC3\xA8"); info.push_back(0); info.push_back(0);
+    put(info, "IART"); le32(info, 6); put(info, "Andr\xE9"); info.push_back(0);
+    Bytes file;
+    put(file, "RIFF"); le32(file, 0); put(file, "WAVE");
+    put(file, "fmt "); le32(file, 16);
+    le16(file, 1); le16(file, 2); le32(file, 44100); le32(file, 176400); le16(file, 4); le16(file, 16);
+    put(file, "LIST"); le32(file, info.size()); put(file, info);
+    put(file, "data"); le32(file, 0);   // Registrazione interrotta
+    uint32_t start = file.size();
+    file.resize(start + 176400, 0);
+
+    MP3IndexEntry e = parse("voce.wav", file, AUDIO_TYPE_WAV);
+    check(!(e.flags & MP3_IDX_BAD) && e.audioStart == start && e.audioEnd == file.size(),
+          "wav: data %u..%u, size 0 read as the rest of the file", e.audioStart, e.audioEnd);
+    check(e.sampleRate == 44100 && e.channels == 2 && e.samples == 44100 && e.durationMs == 1000 && e.bitrateKbps == 1411,
+          "wav: %u Hz, %u ch, %u samples, %u ms, %u kbps", e.sampleRate, e.channels, e.samples, e.durationMs, e.bitrateKbps);
+    check(strcmp(e.title, "Canzon\xC3\xA8") == 0 && strcmp(e.artist, "Andr\xC3\xA9") == 0,
+          "wav: LIST INFO UTF-8 title '%s', ISO-8859-1 artist '%s'", e.title, e.artist);
+}
+
+// Scansione completa della cartella con i file delle prove precedenti
+static void rebuildTest()
+{
+    mp3LibraryBegin();
+    mp3LibraryRebuild();
+    int count = mp3LibraryCount();
+    MP3IndexEntry a, b;
+    bool sorted = count > 1;
+    for (int i = 1; sorted && i < count; i++) {
+        sorted = mp3LibraryGet(i - 1, &a) && mp3LibraryGet(i, &b) && strcasecmp(a.name, b.name) < 0;
+    }
+    check(count == 8 && sorted && mp3LibStats.lastParsed == 8, "rebuild: %d records sorted by name, %u parsed", count, mp3LibStats.lastParsed);
+    int i = mp3LibraryFind("xing.mp3");
+    bool got = i >= 0 && mp3LibraryGet(i, &a);
+    check(got && a.samples == 100 * 1152 - 1576, "rebuild: xing.mp3 at %d, %u samples", i, got ? a.samples : 0);
+
+    hostFiles[MP3_FOLDER "/vbri.mp3"].mtime = 1234;
+    mp3LibraryRebuild();
+    check(mp3LibStats.lastReused == 7 && mp3LibStats.lastParsed == 1 && mp3LibraryCount() == 8,
+          "rebuild: second scan reuses %u, parses %u (the touched file)", mp3LibStats.lastReused, mp3LibStats.lastParsed);
+}
+
+// ===== Libreria di 2.000 file =====
+#define LIB_FILES 2000
+
+static double nowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static std::string libPath(int i)
+{
+    char path[64];
+    snprintf(path, sizeof(path), MP3_FOLDER "/Artista %02d - Brano %04d.%s", i % 50, i, i % 10 == 0 ? "wav" : "mp3");
+    return path;
+}
+
+// Brano i: CBR con ID3v2.3, un terzo VBR con Xing/LAME, uno su dieci WAV (un decimo di secondo)
+static void libPutFile(int i, uint32_t mtime)
+{
+    char title[32], artist[32];
+    snprintf(title, sizeof(title), "Brano %04d", i);
+    snprintf(artist, sizeof(artist), "Artista %02d", i % 50);
+    Bytes file;
+    if (i % 10 == 0) {
+        put(file, "RIFF"); le32(file, 36 + 17640); put(file, "WAVE");
+        put(file, "fmt "); le32(file, 16);
+        le16(file, 1); le16(file, 2); le32(file, 44100); le32(file, 176400); le16(file, 4); le16(file, 16);
+        put(file, "data"); le32(file, 17640);
+        file.resize(file.size() + 17640, 0);
+    } else {
+        Bytes body;
+        put(body, frame(3, "TIT2", text(0, title)));
+        put(body, frame(3, "TPE1", text(1, artist)));
+        file = tag(3, 0, body, 512);
+        if (i % 3 == 0) put(file, xingFrame("Xing", 24, 576, 1000));
+        for (int k = 0; k < 24; k++) put(file, mpegFrame(MPEG1_128K_STEREO, MPEG1_LEN));
+    }
+    HostFile &h = hostFiles[libPath(i)];
+    h.data = file;
+    h.mtime = mtime;
+}
+
+struct LibCost {
+    double us;
+    uint32_t reads;
+    double readKB, writeKB;
+};
+
+static LibCost libMeasure(bool (*fn)())
+{
+    hostSdReads = 0;
+    hostSdReadBytes = hostSdWriteBytes = 0;
+    double t0 = nowUs();
+    fn();
+    return { nowUs() - t0, hostSdReads, hostSdReadBytes / 1024.0, hostSdWriteBytes / 1024.0 };
+}
+
+static bool libRebuild() { mp3LibraryRebuild(); return true; }
+
+static void libPrint(const char *what, const LibCost &c)
+{
+    printf("  %-28s %9.0f us  %6u reads  %8.1f KB read  %7.1f KB written\n", what, c.us, c.reads, c.readKB, c.writeKB);
+}
+
+static void libraryScaleTest()
+{
+    for (auto it = hostFiles.begin(); it != hostFiles.end();) {
+        if (it->first.compare(0, strlen(MP3_FOLDER "/"), MP3_FOLDER "/") == 0) it = hostFiles.erase(it);
+        else ++it;
+    }
+    mp3LibOpenIndex();
+    for (int i = 0; i < LIB_FILES; i++) libPutFile(i, 1000 + i);
+    const double indexKB = (sizeof(MP3IndexHeader) + LIB_FILES * sizeof(MP3IndexEntry)) / 1024.0;
+    printf("library of %d files (index %.1f KB): host CPU, SD traffic\n", LIB_FILES, indexKB);
+
+    uint32_t writes = mp3LibStats.writes, bad = mp3LibStats.badFiles;
+    LibCost cold = libMeasure(libRebuild);
+    libPrint("cold scan", cold);
+    check(mp3LibraryCount() == LIB_FILES && mp3LibStats.lastParsed == LIB_FILES && mp3LibStats.badFiles == bad &&
+          mp3LibStats.writes == writes + 1,
+          "cold scan: %d records, %u parsed, index written", mp3LibraryCount(), mp3LibStats.lastParsed);
+
+    LibCost warm = libMeasure(mp3LibOpenIndex);
+    libPrint("warm load (boot)", warm);
+    MP3IndexEntry e;
+    int i = mp3LibraryFind("Artista 07 - Brano 1007.mp3");
+    bool got = i >= 0 && mp3LibraryGet(i, &e);
+    check(mp3LibraryCount() == LIB_FILES && warm.reads == 1 && got && strcmp(e.title, "Brano 1007") == 0,
+          "warm load: %d records from the header alone (%u read), record %d title '%s'",
+          mp3LibraryCount(), warm.reads, i, got ? e.title : "");
+
+    writes = mp3LibStats.writes;
+    LibCost same = libMeasure(libRebuild);
+    libPrint("incremental, no change", same);
+    check(mp3LibStats.lastReused == LIB_FILES && mp3LibStats.lastParsed == 0 && mp3LibStats.writes == writes &&
+          same.readKB <= indexKB + 1 && same.us < cold.us,
+          "incremental, no change: %u reused, %u parsed, %.1f KB read (the index), index not rewritten",
+          mp3LibStats.lastReused, mp3LibStats.lastParsed, same.readKB);
+
+    for (int k = 0; k < 20; k++) libPutFile(k * 97 + 1, 5000 + k);                 // Toccati
+    for (int k = 0; k < 10; k++) libPutFile(LIB_FILES + k, 6000 + k);              // Nuovi
+    for (int k = 0; k < 5; k++) hostFiles.erase(libPath(k * 10 + 5));              // Rimossi
+    LibCost delta = libMeasure(libRebuild);
+    libPrint("incremental, 35 changed", delta);
+    check(mp3LibraryCount() == LIB_FILES + 5 && mp3LibStats.lastParsed == 30 && mp3LibStats.lastReused == LIB_FILES - 25 &&
+          mp3LibStats.lastRemoved == 25 && delta.us < cold.us,
+          "incremental, 20 touched + 10 new + 5 removed: %u parsed, %u reused, %u dropped, %d records",
+          mp3LibStats.lastParsed, mp3LibStats.lastReused, mp3LibStats.lastRemoved, mp3LibraryCount());
+}
+
+int main()
+{
+    mp3LibIoBuf = (uint8_t *)malloc(MP3_LIB_IO_BYTES);
+    xingLameTest();
+    unsyncTest();
+    vbriTest();
+    mpeg2ApeTest();
+    badTest();
+    wavTest();
+    free(mp3LibIoBuf);
+    mp3LibIoBuf = nullptr;
+    rebuildTest();
+    libraryScaleTest();
+    printf("%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,429 @@
+// Host benchmark and checks of the particle engine (0_PARTICLES.ino) on the Christmas snow (28_CHRISTMAS.ino)
+// and the Flux Capacitor particles (27_FLUX_CAPACITOR.ino)
+//
+//  - legacy: the snow of 28_CHRISTMAS.ino before the engine (kept below, legacy*): every flake erased and
+//    redrawn with drawPixel/fillCircle on the display, four point-in-shape tests per flake, ground snow
+//    redrawn every frame
+//  - engine: the snow part of updateChristmas() - restore from the layer, xmasSnowIntegrate, keyed render,
+//    blit of the dirty rects; the same frames with the row band blit (what the engine did before the rects)
+//  - flux: updateFluxCapacitor() in particle mode, on the engine and as before it (the whole background
+//    copied and the whole screen sent every frame)
+//  Everything draws through the same StubGFX display with auto flush (Arduino_RGB_Display: a cache write-back
+//  per pixel write, one per bitmap over the address range it covers). Per frame: host CPU time, pixels written
+//  to the display, write-back calls and the range they cover. The host cannot time the write-backs of the
+//  panel, so the checks are on what they are counted in, and on the CPU time the host does see:
+//  - the rect blit is not slower than the row band it replaces, on the snow and on the Flux
+//  - XMAS_MAX_SNOWFLAKES flakes: fewer display calls than the legacy path, write-back range and CPU time
+//    on par with it
+//  - Flux at FLUX_MAX_PARTICLES per arm: no more CPU or write-back than before the engine
+//  - restore is exact: after particleCanvasRestore() the frame buffer equals the layer
+//  - keyed flakes land only on sky pixels of the layer; after the blit the display equals the frame buffer
+//
+//   make particles && ./particles          exit code 1 if a check fails
+
+#include <stdarg.h>
+#include <time.h>
+#include "../../particle_types.h"
+
+static StubGFX *gfx;
+static uint8_t currentHour = 12, currentMinute = 34, currentSecond = 56;
+
+#include "../../0_HAND_RASTER.ino"
+#include "../../0_PARTICLES.ino"
+
+// Prototipi generati dall'IDE sul dispositivo
+#define EFFECT_CHRISTMAS
+bool allocChristmasBuffers();
+void releaseChristmasBuffers();
+static void xmasPlaceFlake(uint16_t i, int16_t y, int minSpeed, int maxSpeed);
+static void xmasSnowIntegrate(ParticleSystem* ps);
+#include "../../28_CHRISTMAS.ino"
+
+// Resto dello sketch per 27_FLUX_CAPACITOR.ino: EEPROM vuota (impostazioni di default), sfondo gia' in memoria
+#include "web_host.h"
+#include "sd_host.h"
+
+struct HostEEPROM {
+    uint8_t read(int) { return 0xFF; }
+    void write(int, uint8_t) {}
+};
+static HostEEPROM EEPROM;
+static inline bool settingsCommit() { return true; }
+#define EEPROM_FLUX_COLOR_R_ADDR      270
+#define EEPROM_FLUX_COLOR_G_ADDR      271
+#define EEPROM_FLUX_COLOR_B_ADDR      272
+#define EEPROM_FLUX_PARTICLES_ADDR    273
+#define EEPROM_FLUX_ANIM_SPEED_ADDR   274
+#define EEPROM_FLUX_PART_SPEED_ADDR   275
+#define EEPROM_FLUX_VALID_ADDR        276
+#define EEPROM_FLUX_VALID_MARKER      0xFC
+
+#define RGB565_LITTLE_ENDIAN 0
+struct JPEGDRAW {
+    int x, y, iWidth, iHeight;
+    uint16_t *pPixels;
+};
+class JPEGDEC {
+public:
+    int openRAM(uint8_t *, int, int (*)(JPEGDRAW *)) { return 0; }
+    void setPixelType(int) {}
+    int decode(int, int, int) { return 0; }
+    void close() {}
+};
+static JPEGDEC jpeg;
+static inline void *ps_malloc(size_t n) { return malloc(n); }
+
+enum DisplayMode { MODE_FLUX_CAPACITOR = 20 };
+static void modeLifecycleClaim(DisplayMode) {}
+uint16_t *frameBuffer = nullptr;
+bool fluxCapacitorInitialized = false;
+
+#define EFFECT_FLUX_CAPACITOR
+void initFluxArms();
+void initFluxParticles();
+void updateFluxColors();
+static void fluxPlaceHead(uint16_t i, uint8_t arm, int32_t distQ8);
+static void fluxHeadIntegrate(ParticleSystem* ps);
+#include "../../27_FLUX_CAPACITOR.ino"
+
+#define FRAME_MS    40                  // Passo di updateChristmas()
+#define WARMUP      20
+#define FRAMES      300
+#define RUNS        5
+#define TIME_SLACK  1.25                // Margine sui tempi CPU dell'host (rumore della misura)
+
+static int failures = 0;
+
+static void check(bool ok, const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    printf("%s ", ok ? "  ok  " : "FAILED");
+    vprintf(fmt, ap);
+    printf("\n");
+    va_end(ap);
+    if (!ok) failures++;
+}
+
+static double nowUs()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Neve prima del motore particelle (28_CHRISTMAS.ino, 150 fiocchi), stessi disegni sul display
+
+struct LegacyFlake {
+    int16_t x, y;
+    int8_t speedY, driftX;
+    uint8_t size;
+};
+
+static LegacyFlake *legacySnow;
+static int16_t *legacyOldX, *legacyOldY;
+static int legacyCount;
+static uint8_t legacyGround[480];
+
+static bool legacyInsideTree(int x, int y)
+{
+    int treeX = 240, treeTop = 95;
+    for (int layer = 0; layer < 5; layer++) {
+        int layerTop = treeTop + layer * 55, layerBottom = layerTop + 100, bottomWidth = 60 + layer * 40;
+        if (y >= layerTop && y <= layerBottom) {
+            float progress = (float)(y - layerTop) / (layerBottom - layerTop);
+            int widthAtY = (int)(progress * bottomWidth);
+            if (x >= treeX - widthAtY && x <= treeX + widthAtY) return true;
+        }
+    }
+    return y >= 385 && y <= 440 && x >= 220 && x <= 260;
+}
+
+static bool legacyInsideGift(int x, int y)
+{
+    if (x >= 160 && x <= 215 && y >= 410 && y <= 455) return true;
+    if (x >= 270 && x <= 315 && y >= 420 && y <= 455) return true;
+    if (x >= 225 && x <= 260 && y >= 430 && y <= 458) return true;
+    return false;
+}
+
+static bool legacyInsideTimeBox(int x, int y) { return x >= 150 && x <= 330 && y >= 8 && y <= 72; }
+static bool legacyInSnowZone(int x, int y) { return y >= (480 - legacyGround[x]); }
+
+static void legacyDrawFlake(int x, int y, uint8_t size, uint16_t color)
+{
+    if (size == 1) {
+        gfx->drawPixel(x, y, color);
+    } else if (size == 2) {
+        gfx->drawPixel(x, y, color);
+        gfx->drawPixel(x + 1, y, color);
+        gfx->drawPixel(x, y + 1, color);
+    } else {
+        gfx->fillCircle(x, y, 2, color);
+    }
+}
+
+static void legacyFrame(uint32_t now)
+{
+    for (int i = 0; i < legacyCount; i++) {
+        int ox = legacyOldX[i], oy = legacyOldY[i];
+        if (oy >= 0 && oy < 480 && !legacyInsideTree(ox, oy) && !legacyInsideGift(ox, oy) && !legacyInsideTimeBox(ox, oy) && !legacyInSnowZone(ox, oy))
+            legacyDrawFlake(ox, oy, legacySnow[i].size, getXmasSkyColor(oy));
+    }
+    for (int i = 0; i < legacyCount; i++) {
+        LegacyFlake &f = legacySnow[i];
+        legacyOldX[i] = f.x;
+        legacyOldY[i] = f.y;
+        f.y += f.speedY;
+        if ((now / 150 + i) % 3 == 0) f.x += f.driftX;
+        if (f.x < 0) f.x = 479;
+        if (f.x >= 480) f.x = 0;
+        if (f.y >= 480 - legacyGround[f.x]) {
+            if (legacyGround[f.x] < 80) {
+                int xi = f.x;
+                legacyGround[xi]++;
+                if (xi > 0 && legacyGround[xi] > legacyGround[xi - 1] + 3) legacyGround[xi - 1]++;
+                if (xi < 479 && legacyGround[xi] > legacyGround[xi + 1] + 3) legacyGround[xi + 1]++;
+            }
+            f.x = random(0, 480);
+            f.y = random(-30, -5);
+            f.speedY = random(3, 7);
+            f.driftX = random(-1, 2);
+            f.size = random(1, 4);
+            legacyOldX[i] = f.x;
+            legacyOldY[i] = -50;
+        }
+    }
+    for (int i = 0; i < legacyCount; i++) {
+        int x = legacySnow[i].x, y = legacySnow[i].y;
+        if (y >= 0 && y < 480 && !legacyInsideTree(x, y) && !legacyInsideGift(x, y) && !legacyInsideTimeBox(x, y))
+            legacyDrawFlake(x, y, legacySnow[i].size, XMAS_SNOW_WHITE);
+    }
+    for (int x = 0; x < 480; x++) {
+        int h = legacyGround[x];
+        if (h > 0) {
+            gfx->drawPixel(x, 480 - h, XMAS_SNOW_WHITE);
+            if (h > 1) gfx->drawPixel(x, 480 - h + 1, XMAS_GROUND_SNOW);
+        }
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Scena di 28_CHRISTMAS.ino con n fiocchi nel motore (capacita' e rettangoli come XMAS_MAX_SNOWFLAKES = n)
+static void engineSetup(uint16_t n)
+{
+    releaseChristmasBuffers();
+    hostRandState = 12345;
+    if (n > XMAS_MAX_SNOWFLAKES) particleSystemAlloc(&xmasSnow, n);
+    initChristmas();
+    if (n > XMAS_MAX_SNOWFLAKES) particleCanvasBegin(&xmasCanvas, xmasFrame, xmasLayer, 480, 480, n + 64);
+    xmasSnow.count = 0;
+    for (uint16_t i = 0; i < n; i++) {
+        int idx = particleSpawn(&xmasSnow, 0, 0, 0, 0, 0, XMAS_SNOW_WHITE, PART_SPRITE_DOT);
+        xmasPlaceFlake(idx, particleRandRange(0, 479), 2, 5);
+    }
+    drawXmasStaticScene();
+}
+
+static void engineFrame(uint32_t now)
+{
+    particleCanvasRestore(&xmasCanvas);
+    particleStep(&xmasSnow, now);
+    particleRender(&xmasSnow, &xmasCanvas);
+    particleCanvasBlit(&xmasCanvas);
+}
+
+// Stesso frame con la banda di righe al display
+static void engineBandFrame(uint32_t now)
+{
+    xmasCanvas.blitBand = true;
+    engineFrame(now);
+}
+
+// Stessa scena (strato del motore) a schermo, fiocchi e neve al suolo come l'init di allora
+static void legacySetup(uint16_t n)
+{
+    engineSetup(XMAS_MAX_SNOWFLAKES);
+    gfx->draw16bitRGBBitmap(0, 0, xmasLayer, 480, 480);
+    memcpy(legacyGround, xmasGroundSnow, sizeof(legacyGround));
+    free(legacySnow); free(legacyOldX); free(legacyOldY);
+    legacySnow = (LegacyFlake *)calloc(n, sizeof(LegacyFlake));
+    legacyOldX = (int16_t *)calloc(n, sizeof(int16_t));
+    legacyOldY = (int16_t *)calloc(n, sizeof(int16_t));
+    legacyCount = n;
+    for (int i = 0; i < n; i++) {
+        legacySnow[i] = { (int16_t)random(0, 480), (int16_t)random(0, 480), (int8_t)random(2, 6), (int8_t)random(-1, 2), (uint8_t)random(1, 4) };
+        legacyOldX[i] = legacySnow[i].x;
+        legacyOldY[i] = legacySnow[i].y;
+    }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+// Flux Capacitor in modalita' particelle con n teste per braccio, sfondo a gradiente
+static void fluxSetup(uint16_t n)
+{
+    hostRandState = 12345;
+    if (fluxBackgroundBuffer == nullptr) {
+        fluxBackgroundBuffer = (uint16_t *)malloc(FLUX_SCREEN_WIDTH * FLUX_SCREEN_HEIGHT * sizeof(uint16_t));
+        for (int p = 0; p < FLUX_SCREEN_WIDTH * FLUX_SCREEN_HEIGHT; p++) fluxBackgroundBuffer[p] = (uint16_t)(p * 7);
+    }
+    fluxBackgroundLoaded = true;
+    fluxEffectMode = 1;
+    fluxNumParticles = n;
+    fluxCapacitorInitialized = false;
+    initFluxCapacitor();
+}
+
+static void fluxFrame(uint32_t) { updateFluxCapacitor(); }
+
+static void fluxBandFrame(uint32_t)
+{
+    fluxCanvas.blitBand = true;
+    updateFluxCapacitor();
+}
+
+// Come prima del motore: tutto lo sfondo nel frame buffer e tutto lo schermo al display
+static void fluxFullFrame(uint32_t)
+{
+    particleCanvasInvalidate(&fluxCanvas);
+    updateFluxCapacitor();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+
+struct FrameCost {
+    double us;
+    double pixels, flushes, flushKB;
+};
+
+static FrameCost measure(void (*setup)(uint16_t), void (*frame)(uint32_t), uint16_t n, uint32_t stepMs)
+{
+    FrameCost c = { 1e300, 0, 0, 0 };
+    for (int r = 0; r < RUNS; r++) {
+        setup(n);
+        hostMillis = 0;
+        for (int f = 0; f < WARMUP; f++) {
+            hostMillis += stepMs;
+            frame(hostMillis);
+        }
+        gfx->resetCounters();
+        double t0 = nowUs();
+        for (int f = 0; f < FRAMES; f++) {
+            hostMillis += stepMs;
+            frame(hostMillis);
+        }
+        c.us = std::min(c.us, (nowUs() - t0) / FRAMES);
+        c.pixels = (double)gfx->pixelWrites / FRAMES;
+        c.flushes = (double)gfx->flushCalls / FRAMES;
+        c.flushKB = (double)gfx->flushBytes / FRAMES / 1024;
+    }
+    return c;
+}
+
+static void printCost(const char *path, uint16_t n, const char *what, const FrameCost &c)
+{
+    printf("  %-7s %4d %-9s %8.1f us  %8.0f px  %8.0f calls  %7.1f KB\n", path, n, what, c.us, c.pixels, c.flushes, c.flushKB);
+}
+
+// Snow: XMAS_MAX_SNOWFLAKES (the sketch) is checked, 4x and 10x are printed for reference
+static void speedTest()
+{
+    static const uint16_t counts[] = { XMAS_MAX_SNOWFLAKES, 4 * XMAS_MAX_SNOWFLAKES, 10 * XMAS_MAX_SNOWFLAKES };
+    printf("snow per frame: host CPU, pixels written to the display, cache write-backs (calls, range KB)\n");
+    FrameCost old = measure(legacySetup, legacyFrame, XMAS_MAX_SNOWFLAKES, FRAME_MS);
+    printCost("legacy", XMAS_MAX_SNOWFLAKES, "flakes", old);
+    FrameCost eng = {}, band = {};
+    for (int k = 0; k < 3; k++) {
+        FrameCost e = measure(engineSetup, engineFrame, counts[k], FRAME_MS);
+        FrameCost b = measure(engineSetup, engineBandFrame, counts[k], FRAME_MS);
+        printCost("engine", counts[k], "flakes", e);
+        printCost("band", counts[k], "flakes", b);
+        if (k == 0) { eng = e; band = b; }
+    }
+    check(eng.us <= band.us * TIME_SLACK && eng.flushKB <= band.flushKB,
+          "%d flakes: rect blit %.1f us, %.1f KB written back (row band %.1f us, %.1f KB)",
+          XMAS_MAX_SNOWFLAKES, eng.us, eng.flushKB, band.us, band.flushKB);
+    check(eng.flushes < old.flushes && eng.flushKB <= old.flushKB * 1.25 && eng.us <= old.us * TIME_SLACK,
+          "%d flakes: engine %.0f display calls, %.1f KB, %.1f us per frame (legacy %.0f calls, %.1f KB, %.1f us)",
+          XMAS_MAX_SNOWFLAKES, eng.flushes, eng.flushKB, eng.us, old.flushes, old.flushKB, old.us);
+}
+
+// Flux: the default 8 per arm and FLUX_MAX_PARTICLES, against the whole frame of before the engine
+static void fluxSpeedTest()
+{
+    static const uint16_t counts[] = { 8, FLUX_MAX_PARTICLES };
+    const uint32_t step = fluxAnimationSpeed;
+    printf("flux per frame, particle mode: host CPU, pixels written to the display, cache write-backs\n");
+    FrameCost full = measure(fluxSetup, fluxFullFrame, FLUX_MAX_PARTICLES, step);
+    printCost("before", FLUX_MAX_PARTICLES, "per arm", full);
+    FrameCost eng[2];
+    for (int k = 0; k < 2; k++) {
+        eng[k] = measure(fluxSetup, fluxFrame, counts[k], step);
+        FrameCost band = measure(fluxSetup, fluxBandFrame, counts[k], step);
+        printCost("engine", counts[k], "per arm", eng[k]);
+        printCost("band", counts[k], "per arm", band);
+        check(eng[k].us <= band.us * TIME_SLACK && eng[k].flushKB <= band.flushKB,
+              "flux %d per arm: rect blit %.1f us, %.1f KB written back (row band %.1f us, %.1f KB)",
+              counts[k], eng[k].us, eng[k].flushKB, band.us, band.flushKB);
+    }
+    check(eng[1].us <= full.us * TIME_SLACK && eng[1].flushKB <= full.flushKB,
+          "flux %d per arm: engine %.1f us, %.1f KB per frame (before the engine %.1f us, %.1f KB)",
+          FLUX_MAX_PARTICLES, eng[1].us, eng[1].flushKB, full.us, full.flushKB);
+}
+
+// Ripristino esatto, fiocchi solo sul cielo, display == frame buffer dopo il blit
+static void restoreTest()
+{
+    engineSetup(600);
+    hostMillis = 0;
+    int restoreDiff = 0, offSky = 0, screenDiff = 0;
+    const uint32_t area = 480 * 480;
+    for (int f = 0; f < 400; f++) {
+        hostMillis += FRAME_MS;
+        particleCanvasRestore(&xmasCanvas);
+        for (uint32_t p = 0; p < area; p++) restoreDiff += xmasFrame[p] != xmasLayer[p];
+        particleStep(&xmasSnow, hostMillis);
+        particleRender(&xmasSnow, &xmasCanvas);
+        for (uint32_t p = 0; p < area; p++)
+            if (xmasFrame[p] != xmasLayer[p] && (xmasLayer[p] < XMAS_SNOW_KEY_LO || xmasLayer[p] > XMAS_SNOW_KEY_HI)) offSky++;
+        particleCanvasBlit(&xmasCanvas);
+        screenDiff += memcmp(gfx->getBuffer(), xmasFrame, area * sizeof(uint16_t)) != 0;
+    }
+    check(restoreDiff == 0, "400 frames: %d pixels differ from the layer after particleCanvasRestore()", restoreDiff);
+    check(offSky == 0, "keyed flakes: %d pixels drawn outside the sky", offSky);
+    check(screenDiff == 0, "blit: display differs from the frame buffer in %d frames", screenDiff);
+}
+
+// Flux: ripristino esatto dallo sfondo, display == frame buffer dopo il blit
+static void fluxRestoreTest()
+{
+    fluxSetup(FLUX_MAX_PARTICLES);
+    hostMillis = 0;
+    int restoreDiff = 0, screenDiff = 0;
+    const uint32_t area = FLUX_SCREEN_WIDTH * FLUX_SCREEN_HEIGHT;
+    for (int f = 0; f < 400; f++) {
+        hostMillis += fluxAnimationSpeed;
+        updateFluxCapacitor();
+        screenDiff += memcmp(gfx->getBuffer(), frameBuffer, area * sizeof(uint16_t)) != 0;
+        particleCanvasRestore(&fluxCanvas);
+        restoreDiff += memcmp(frameBuffer, fluxBackgroundBuffer, area * sizeof(uint16_t)) != 0;
+    }
+    check(restoreDiff == 0, "flux, 400 frames: frame buffer differs from the background after particleCanvasRestore() in %d frames", restoreDiff);
+    check(screenDiff == 0, "flux blit: display differs from the frame buffer in %d frames", screenDiff);
+}
+
+int main()
+{
+    StubGFX display(480, 480, true);
+    gfx = &display;
+    restoreTest();
+    fluxRestoreTest();
+    speedTest();
+    fluxSpeedTest();
+    releaseChristmasBuffers();
+    printf("%d check(s) failed\n", failures);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,134 @@
+// Host build glue for the sketch modules that index the SD in a background task (mp3_library.cpp, ...):
+// an SD card in memory (hostFiles, path -> bytes) with the File/SD calls of the Arduino SD library, and
+// the FreeRTOS calls those modules make. Tasks are never started: the test calls the task body itself.
+// Included after sketch_host.h.
+
+#ifndef SD_HOST_H
+#define SD_HOST_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <strings.h>
+
+// ===== SD =====
+struct HostFile {
+    std::vector<uint8_t> data;
+    uint32_t mtime = 0;
+};
+static std::map<std::string, HostFile> hostFiles;
+static uint32_t hostSdReads = 0;            // Traffico sulla SD: letture e byte letti/scritti
+static uint64_t hostSdReadBytes = 0, hostSdWriteBytes = 0;
+
+#define FILE_READ  "r"
+#define FILE_WRITE "w"
+enum sdcard_type_t { CARD_NONE, CARD_MMC, CARD_SD, CARD_SDHC };
+
+class File {
+public:
+    File() {}
+    File(const std::string &path, bool dir) : _path(path), _dir(dir), _open(true) {}
+
+    explicit operator bool() const { return _open; }
+    void close() { _open = false; }
+    bool isDirectory() const { return _dir; }
+    const char *name() const { size_t s = _path.rfind('/'); return _path.c_str() + (s == std::string::npos ? 0 : s + 1); }
+    size_t size() const { return _dir ? 0 : hostFiles[_path].data.size(); }
+    time_t getLastWrite() const { return _dir ? 0 : hostFiles[_path].mtime; }
+
+    bool seek(uint32_t pos) {
+        if (!_open || pos > size()) return false;
+        _pos = pos;
+        return true;
+    }
+    size_t read(uint8_t *buf, size_t len) {
+        if (!_open || _dir) return 0;
+        const std::vector<uint8_t> &d = hostFiles[_path].data;
+        if (_pos >= d.size()) return 0;
+        if (len > d.size() - _pos) len = d.size() - _pos;
+        memcpy(buf, d.data() + _pos, len);
+        _pos += len;
+        hostSdReads++;
+        hostSdReadBytes += len;
+        return len;
+    }
+    size_t write(const uint8_t *buf, size_t len) {
+        if (!_open || _dir) return 0;
+        std::vector<uint8_t> &d = hostFiles[_path].data;
+        if (d.size() < _pos + len) d.resize(_pos + len);
+        memcpy(d.data() + _pos, buf, len);
+        _pos += len;
+        hostSdWriteBytes += len;
+        return len;
+    }
+
+    // Voci dirette della cartella, in ordine di nome (la FAT non garantisce un ordine)
+    File openNextFile() {
+        std::string prefix = _path + "/";
+        for (auto it = hostFiles.upper_bound(_last); it != hostFiles.end(); ++it) {
+            if (it->first.compare(0, prefix.size(), prefix) != 0) continue;
+            if (it->first.find('/', prefix.size()) != std::string::npos) continue;
+            _last = it->first;
+            return File(it->first, false);
+        }
+        _last = "\xff";
+        return File();
+    }
+
+private:
+    std::string _path, _last;
+    bool _dir = false, _open = false;
+    size_t _pos = 0;
+};
+
+class HostSD {
+public:
+    sdcard_type_t cardType() { return CARD_SDHC; }
+    bool exists(const char *path) {
+        if (hostFiles.count(path)) return true;
+        std::string prefix = std::string(path) + "/";
+        auto it = hostFiles.lower_bound(prefix);
+        return it != hostFiles.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+    }
+    bool mkdir(const char *) { return true; }
+    File open(const char *path, const char *mode = FILE_READ) {
+        if (strcmp(mode, FILE_WRITE) == 0) {
+            hostFiles[path] = HostFile();
+            return File(path, false);
+        }
+        if (hostFiles.count(path)) return File(path, false);
+        return exists(path) ? File(path, true) : File();
+    }
+    bool remove(const char *path) { return hostFiles.erase(path) > 0; }
+    bool rename(const char *from, const char *to) {
+        auto it = hostFiles.find(from);
+        if (it == hostFiles.end()) return false;
+        hostFiles[to] = it->second;
+        hostFiles.erase(from);
+        return true;
+    }
+};
+static HostSD SD __attribute__((unused));
+
+// ===== FreeRTOS =====
+typedef void *SemaphoreHandle_t;
+typedef void *TaskHandle_t;
+typedef int BaseType_t;
+#define pdPASS          1
+#define pdTRUE          1
+#define portMAX_DELAY   0xFFFFFFFFu
+static int hostMutex;
+static inline SemaphoreHandle_t xSemaphoreCreateMutex() { return &hostMutex; }
+static inline void vSemaphoreDelete(SemaphoreHandle_t) {}
+static inline int xSemaphoreTake(SemaphoreHandle_t, uint32_t) { return pdTRUE; }
+static inline int xSemaphoreGive(SemaphoreHandle_t) { return pdTRUE; }
+static inline BaseType_t xTaskCreatePinnedToCore(void (*)(void *), const char *, uint32_t, void *, int,
+                                                 TaskHandle_t *handle, int) {
+    *handle = &hostMutex;
+    return pdPASS;
+}
+static inline void xTaskNotifyGive(TaskHandle_t) {}
+static inline uint32_t ulTaskNotifyTake(int, uint32_t) { return 0; }
+static inline void vTaskDelay(uint32_t) {}
+
+#endif
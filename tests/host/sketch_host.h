@@ -0,0 +1,212 @@
+// Host build glue for the sketch tests (hand_raster.cpp, particles.cpp, ...), force-included before
+// the .ino under test: the few Arduino/Arduino_GFX/ESP-IDF names those files use, nothing else.
+
+#ifndef SKETCH_HOST_H
+#define SKETCH_HOST_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+// Arduino_GFX colori RGB565
+#define BLACK 0x0000
+#define WHITE 0xFFFF
+
+// ===== Arduino / ESP-IDF =====
+#define MALLOC_CAP_8BIT      (1 << 2)
+#define MALLOC_CAP_SPIRAM    (1 << 10)
+#define MALLOC_CAP_INTERNAL  (1 << 11)
+static inline void *heap_caps_malloc(size_t size, uint32_t) { return malloc(size); }
+static inline void *heap_caps_realloc(void *p, size_t size, uint32_t) { return realloc(p, size); }
+static inline void heap_caps_free(void *p) { free(p); }
+
+// Log dei modi: rumore nei test
+struct HostSerial {
+    void print(const char *) {}
+    void println(const char * = "") {}
+    void printf(const char *, ...) {}
+};
+static HostSerial Serial __attribute__((unused));
+
+// Orologio e casuali deterministici: il test decide quanto tempo passa tra due frame
+static uint32_t hostMillis = 0;
+static inline uint32_t millis() { return hostMillis; }
+static inline uint32_t micros() { return hostMillis * 1000; }
+static uint32_t hostRandState = 12345;
+static inline uint32_t esp_random() { hostRandState = hostRandState * 1664525u + 1013904223u; return hostRandState; }
+static inline long random(long hi) { return hi > 0 ? (long)((esp_random() >> 8) % (uint32_t)hi) : 0; }
+static inline long random(long lo, long hi) { return hi > lo ? lo + random(hi - lo) : lo; }
+
+// Font U8g2 usati dai modi: solo i simboli (il testo non viene disegnato)
+static const uint8_t u8g2_font_logisoso32_tn[1] = { 0 };
+static const uint8_t u8g2_font_helvB14_tr[1] = { 0 };
+
+// ===== Arduino_GFX =====
+// Frame buffer 16 bit con le primitive di Arduino_GFX che i modi usano, stessi algoritmi
+// (drawPixel -> writePixelPreclipped, cerchi e triangoli a linee veloci). Con autoFlush
+// modella Arduino_RGB_Display: ogni scrittura fa un Cache_WriteBack_Addr, contato in
+// flushCalls/flushBytes insieme ai pixel scritti (pixelWrites). Senza: OffscreenGFX.
+class StubGFX {
+public:
+    StubGFX(int16_t w, int16_t h, bool autoFlush = false)
+        : _w(w), _h(h), _buf((uint16_t *)calloc((size_t)w * h, sizeof(uint16_t))), _own(true), _autoFlush(autoFlush) {}
+    StubGFX(uint16_t *buf, int16_t w, int16_t h) : _w(w), _h(h), _buf(buf), _own(false), _autoFlush(false) {}
+    virtual ~StubGFX() { if (_own) free(_buf); }
+
+    uint16_t *getBuffer() { return _buf; }
+    int16_t width() const { return _w; }
+    int16_t height() const { return _h; }
+    void resetCounters() { pixelWrites = flushCalls = flushBytes = 0; }
+
+    uint32_t pixelWrites = 0;
+    uint32_t flushCalls = 0;
+    uint64_t flushBytes = 0;
+
+    virtual void writePixelPreclipped(int16_t x, int16_t y, uint16_t c) {
+        _buf[(int32_t)y * _w + x] = c;
+        pixelWrites++;
+        flush(2);
+    }
+    void writePixel(int16_t x, int16_t y, uint16_t c) { if (x >= 0 && y >= 0 && x < _w && y < _h) writePixelPreclipped(x, y, c); }
+    virtual void drawPixel(int16_t x, int16_t y, uint16_t c) { writePixel(x, y, c); }
+
+    virtual void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t c) {
+        if (x < 0 || x >= _w) return;
+        if (y < 0) { h += y; y = 0; }
+        if (y + h > _h) h = _h - y;
+        for (int16_t i = 0; i < h; i++) {           // RGB display: write-back riga per riga
+            _buf[(int32_t)(y + i) * _w + x] = c;
+            pixelWrites++;
+            flush(2);
+        }
+    }
+    virtual void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t c) {
+        if (y < 0 || y >= _h) return;
+        if (x < 0) { w += x; x = 0; }
+        if (x + w > _w) w = _w - x;
+        if (w <= 0) return;
+        for (int16_t i = 0; i < w; i++) _buf[(int32_t)y * _w + x + i] = c;
+        pixelWrites += w;
+        flush(w * 2);
+    }
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t c) { writeFastVLine(x, y, h, c); }
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t c) { writeFastHLine(x, y, w, c); }
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) { for (int16_t i = 0; i < h; i++) writeFastHLine(x, y + i, w, c); }
+    void fillScreen(uint16_t c) { fillRect(0, 0, _w, _h, c); }
+    void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t c) {
+        writeFastHLine(x, y, w, c); writeFastHLine(x, y + h - 1, w, c);
+        writeFastVLine(x, y, h, c); writeFastVLine(x + w - 1, y, h, c);
+    }
+
+    void drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t c) {
+        bool steep = abs(y1 - y0) > abs(x1 - x0);
+        if (steep) { std::swap(x0, y0); std::swap(x1, y1); }
+        if (x0 > x1) { std::swap(x0, x1); std::swap(y0, y1); }
+        int16_t dx = x1 - x0, dy = abs(y1 - y0), err = dx / 2, ys = y0 < y1 ? 1 : -1;
+        for (; x0 <= x1; x0++) {
+            if (steep) writePixel(y0, x0, c); else writePixel(x0, y0, c);
+            err -= dy;
+            if (err < 0) { y0 += ys; err += dx; }
+        }
+    }
+
+    void drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t c) {
+        int16_t f = 1 - r, ddx = 1, ddy = -2 * r, x = 0, y = r;
+        writePixel(x0, y0 + r, c); writePixel(x0, y0 - r, c);
+        writePixel(x0 + r, y0, c); writePixel(x0 - r, y0, c);
+        while (x < y) {
+            if (f >= 0) { y--; ddy += 2; f += ddy; }
+            x++; ddx += 2; f += ddx;
+            writePixel(x0 + x, y0 + y, c); writePixel(x0 - x, y0 + y, c);
+            writePixel(x0 + x, y0 - y, c); writePixel(x0 - x, y0 - y, c);
+            writePixel(x0 + y, y0 + x, c); writePixel(x0 - y, y0 + x, c);
+            writePixel(x0 + y, y0 - x, c); writePixel(x0 - y, y0 - x, c);
+        }
+    }
+    void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t c) {
+        writeFastVLine(x0, y0 - r, 2 * r + 1, c);
+        fillCircleHelper(x0, y0, r, 3, 0, c);
+    }
+    void fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t c) {
+        int16_t f = 1 - r, ddx = 1, ddy = -2 * r, x = 0, y = r, px = x, py = y;
+        delta++;
+        while (x < y) {
+            if (f >= 0) { y--; ddy += 2; f += ddy; }
+            x++; ddx += 2; f += ddx;
+            if (x < (y + 1)) {
+                if (corners & 1) writeFastVLine(x0 + x, y0 - y, 2 * y + delta, c);
+                if (corners & 2) writeFastVLine(x0 - x, y0 - y, 2 * y + delta, c);
+            }
+            if (y != py) {
+                if (corners & 1) writeFastVLine(x0 + py, y0 - px, 2 * px + delta, c);
+                if (corners & 2) writeFastVLine(x0 - py, y0 - px, 2 * px + delta, c);
+                py = y;
+            }
+            px = x;
+        }
+    }
+    void fillRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t c) {
+        fillRect(x + r, y, w - 2 * r, h, c);
+        fillCircleHelper(x + w - r - 1, y + r, r, 1, h - 2 * r - 1, c);
+        fillCircleHelper(x + r, y + r, r, 2, h - 2 * r - 1, c);
+    }
+    void drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t, uint16_t c) { drawRect(x, y, w, h, c); }
+
+    void fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t c) {
+        if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+        if (y1 > y2) { std::swap(y2, y1); std::swap(x2, x1); }
+        if (y0 > y1) { std::swap(y0, y1); std::swap(x0, x1); }
+        if (y0 == y2) return;
+        for (int16_t y = y0; y <= y2; y++) {
+            int32_t a = x0 + (int32_t)(x2 - x0) * (y - y0) / (y2 - y0);
+            int32_t b = (y < y1 || y1 == y2) ? (y1 == y0 ? x1 : x0 + (int32_t)(x1 - x0) * (y - y0) / (y1 - y0))
+                                             : x1 + (int32_t)(x2 - x1) * (y - y1) / (y2 - y1);
+            if (a > b) std::swap(a, b);
+            writeFastHLine((int16_t)a, y, (int16_t)(b - a + 1), c);
+        }
+    }
+
+    // Come Arduino_RGB_Display::draw16bitRGBBitmap: righe copiate, un write-back per chiamata
+    virtual void draw16bitRGBBitmap(int16_t x, int16_t y, uint16_t *bitmap, int16_t w, int16_t h) {
+        for (int16_t r = 0; r < h; r++) {
+            if (y + r < 0 || y + r >= _h) continue;
+            memcpy(_buf + (int32_t)(y + r) * _w + x, bitmap + (int32_t)r * w, w * sizeof(uint16_t));
+        }
+        pixelWrites += (uint32_t)w * h;
+        flush(((int32_t)_w * (h - 1) + w) * 2);
+    }
+
+    // Testo: posizione e misure finte, nessun pixel (le scene dei modi non sono sotto test)
+    void setFont(const uint8_t *) {}
+    void setTextColor(uint16_t) {}
+    void setCursor(int16_t, int16_t) {}
+    void print(const char *) {}
+    void getTextBounds(const char *s, int16_t x, int16_t y, int16_t *x1, int16_t *y1, uint16_t *w, uint16_t *h) {
+        *x1 = x; *y1 = y - 16; *w = (uint16_t)(strlen(s) * 12); *h = 16;
+    }
+
+protected:
+    void flush(uint32_t bytes) { if (_autoFlush) { flushCalls++; flushBytes += bytes; } }
+
+    int16_t _w, _h;
+    uint16_t *_buf;
+    bool _own, _autoFlush;
+};
+
+// OffscreenGFX del file principale: primitive GFX su un buffer esterno, senza flush
+class OffscreenGFX : public StubGFX {
+public:
+    OffscreenGFX(uint16_t *buf, int16_t w, int16_t h) : StubGFX(buf, w, h) {}
+};
+
+#endif
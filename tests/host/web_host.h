@@ -0,0 +1,118 @@
+// Host build glue for the sketch modules that talk HTTP (bt_drift.cpp, ...): Arduino String, a scripted
+// WiFiClient/HTTPClient (the test queues the bytes the server would send) and an AsyncWebServer that only
+// swallows the handlers. Included after sketch_host.h.
+
+#ifndef WEB_HOST_H
+#define WEB_HOST_H
+
+#include <string>
+#include <vector>
+
+#define PROGMEM
+
+static inline void delay(uint32_t ms) { hostMillis += ms; }
+#ifndef constrain
+#define constrain(x, lo, hi) ((x) < (lo) ? (lo) : ((x) > (hi) ? (hi) : (x)))
+#endif
+
+// ===== Arduino String =====
+class String {
+public:
+    String(const char *s = "") : _s(s ? s : "") {}
+    String(const std::string &s) : _s(s) {}
+    String(char c) : _s(1, c) {}
+    String(int v) : _s(std::to_string(v)) {}
+    String(unsigned int v) : _s(std::to_string(v)) {}
+    String(long v) : _s(std::to_string(v)) {}
+    String(unsigned long v) : _s(std::to_string(v)) {}
+    String(double v, int decimals = 2) {
+        char b[32];
+        snprintf(b, sizeof(b), "%.*f", decimals, v);
+        _s = b;
+    }
+
+    const char *c_str() const { return _s.c_str(); }
+    unsigned int length() const { return (unsigned int)_s.size(); }
+    char operator[](unsigned int i) const { return i < _s.size() ? _s[i] : 0; }
+    int indexOf(const char *s, unsigned int from = 0) const { size_t p = _s.find(s, from); return p == std::string::npos ? -1 : (int)p; }
+    int indexOf(char c, unsigned int from = 0) const { size_t p = _s.find(c, from); return p == std::string::npos ? -1 : (int)p; }
+    int lastIndexOf(char c) const { size_t p = _s.rfind(c); return p == std::string::npos ? -1 : (int)p; }
+    String substring(unsigned int a, unsigned int b) const { return a < b && a < _s.size() ? String(_s.substr(a, b - a)) : String(); }
+    String substring(unsigned int a) const { return a < _s.size() ? String(_s.substr(a)) : String(); }
+    long toInt() const { return atol(_s.c_str()); }
+    bool operator==(const char *s) const { return _s == s; }
+
+    String &operator+=(const String &o) { _s += o._s; return *this; }
+    String &operator+=(const char *s) { _s += s; return *this; }
+    String &operator+=(char c) { _s += c; return *this; }
+    friend String operator+(const String &a, const String &b) { return String(a._s + b._s); }
+    friend String operator+(const String &a, const char *b) { return String(a._s + b); }
+    friend String operator+(const char *a, const String &b) { return String(a + b._s); }
+
+private:
+    std::string _s;
+};
+
+// ===== WiFi / HTTP =====
+// Stream lato client: i byte accodati dal test (hostRx) escono a pezzi di al massimo hostRxChunk byte,
+// come le letture TCP sul dispositivo
+class WiFiClient {
+public:
+    std::vector<uint8_t> hostRx;
+    size_t hostRxPos = 0;
+    int hostRxChunk = 1 << 30;
+    bool hostConnected = true;
+
+    void hostSend(const void *data, size_t n) {
+        if (hostRxPos >= 65536) { hostRx.erase(hostRx.begin(), hostRx.begin() + hostRxPos); hostRxPos = 0; }
+        hostRx.insert(hostRx.end(), (const uint8_t *)data, (const uint8_t *)data + n);
+    }
+    int available() { return (int)(hostRx.size() - hostRxPos); }
+    bool connected() { return hostConnected; }
+    int readBytes(uint8_t *dst, int n) {
+        n = std::min(std::min(n, available()), hostRxChunk);
+        memcpy(dst, hostRx.data() + hostRxPos, n);
+        hostRxPos += n;
+        return n;
+    }
+};
+
+#define HTTP_CODE_OK 200
+static int hostHttpCode = HTTP_CODE_OK;
+
+class HTTPClient {
+public:
+    void begin(WiFiClient &client, const String &) { _client = &client; }
+    void setTimeout(uint16_t) {}
+    int GET() { return hostHttpCode; }
+    WiFiClient *getStreamPtr() { return _client; }
+    void end() {}
+
+private:
+    WiFiClient *_client = nullptr;
+};
+
+// ===== ESPAsyncWebServer =====
+// I gestori web non sono sotto test: registrati e ignorati
+enum WebRequestMethod { HTTP_GET = 1, HTTP_POST = 2 };
+class AsyncWebParameter {
+public:
+    const String &value() const { return _value; }
+private:
+    String _value;
+};
+class AsyncWebServerRequest {
+public:
+    void send(int, const char *, const String &) {}
+    void send_P(int, const char *, const char *) {}
+    bool hasParam(const char *) const { return false; }
+    AsyncWebParameter *getParam(const char *) { return &_param; }
+private:
+    AsyncWebParameter _param;
+};
+class AsyncWebServer {
+public:
+    template <typename... Handlers> void on(const char *, int, Handlers...) {}
+};
+
+#endif